@@ -123,6 +123,17 @@ void PB_eglSwapBuffers(){
 	eglSwapBuffers(egl_disp, egl_surf);
 }
 
+/* the context is current in one thread at a time: release it in one thread before making it current in another */
+void PB_eglMakeCurrent(){
+	if (eglMakeCurrent(egl_disp, egl_surf, egl_surf, egl_ctx) != EGL_TRUE)
+		bbutil_egl_perror("eglMakeCurrent");
+}
+
+void PB_eglReleaseCurrent(){
+	if (eglMakeCurrent(egl_disp, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) != EGL_TRUE)
+		bbutil_egl_perror("eglMakeCurrent");
+}
+
 int
 bbutil_init_egl(screen_context_t ctx) {
     int usage;
@@ -195,6 +195,8 @@ int bbutil_calculate_dpi(screen_context_t ctx);
 int bbutil_rotate_screen_surface(int angle);
 void PB_HandleEvents(void (*keyHandleFunction)(screen_event_t*));
 void PB_eglSwapBuffers();
+void PB_eglMakeCurrent();
+void PB_eglReleaseCurrent();
 
 float UIPixelToViewportX(float x);
 float UIPixelToViewportY(float y);
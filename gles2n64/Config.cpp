@@ -114,6 +114,8 @@ Option configOptions[] =
 //// (part of the Galaxy S Zelda crash-fix
     {"tribuffer opt", &config.tribufferOpt, 1},
 //
+    {"batch triangles", &config.batchTriangles, 0},
+    {"render stats", &config.renderStats, 0},
     {"", NULL, 0},
 
     {"#Hack Settings:", NULL, 0},
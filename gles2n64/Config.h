@@ -61,6 +61,8 @@ struct Config
 //// (part of the Galaxy S Zelda crash-fix
     int     tribufferOpt;
 //
+    int     batchTriangles;
+    int     renderStats;
 
     int     hackBanjoTooie;
     int     hackZelda;
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <time.h>
 #include "gles2N64.h"
 #include "GBI.h"
 #include "RDP.h"
@@ -334,6 +335,14 @@ void GBI_Destroy()
 }
 
 #ifdef PROFILE_GBI
+// most commands take well under a millisecond, so they are timed in microseconds rather than with ticksGetTicks()
+static unsigned int GBI_ProfileMicroseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
 void GBI_ProfileInit()
 {
     GBI_ProfileReset();
@@ -341,14 +350,14 @@ void GBI_ProfileInit()
 
 void GBI_ProfileBegin(u32 cmd)
 {
-    GBI.profileTmp = ticksGetTicks();
+    GBI.profileTmp = GBI_ProfileMicroseconds();
 }
 
 void GBI_ProfileEnd(u32 cmd)
 {
     unsigned int i = 256*GBI.current->type + cmd;
     GBI.profileNum[i]++;
-    GBI.profileTimer[i] += ticksGetTicks() - GBI.profileTmp;
+    GBI.profileTimer[i] += GBI_ProfileMicroseconds() - GBI.profileTmp;
 }
 
 void
@@ -373,7 +382,8 @@ GBI_GetFuncNum(u32 ucode, u32 cmd)
 u32
 GBI_ProfilePrint(FILE *file)
 {
-    int uc, cmd, total=0;
+    int uc, cmd;
+    u32 total=0;
 
     for(uc=0;uc<12;uc++)
     {
@@ -391,7 +401,7 @@ GBI_ProfilePrint(FILE *file)
             unsigned int t = GBI_GetFuncTime(uc, cmd);
             if (t != 0)
             {
-                fprintf(file, "%s x %i = %u ms (%.2f%%)\n", GBI_GetFuncName(uc,cmd), GBI_GetFuncNum(uc, cmd), t, 100.0f * (float)t / total);
+                fprintf(file, "%s x %i = %.3f ms (%.2f%%)\n", GBI_GetFuncName(uc,cmd), GBI_GetFuncNum(uc, cmd), t / 1000.0f, 100.0f * (float)t / total);
             }
         }
     }
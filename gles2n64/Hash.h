@@ -2,7 +2,11 @@
 #define __HASH_H__
 
 #include <stdlib.h>
+#include <string.h>
 
+// Chained hash map of intrusive entries: T must have 'unsigned hashKey' and 'T *hashNext'. Entries with the same key
+// are all kept, find() returns the first one of the bucket and the caller walks hashNext comparing hashKey. The table
+// doubles when it holds more entries than buckets.
 template<typename T>
 class HashMap
 {
@@ -10,6 +14,7 @@ public:
     void init(unsigned power2)
     {
         _mask = (1 << power2) - 1;
+        _count = 0;
         _hashmap = (T**)malloc((_mask+1) * sizeof(T*));
         reset();
     }
@@ -17,16 +22,38 @@ public:
     void destroy()
     {
         free(_hashmap);
+        _hashmap = NULL;
     }
 
     void reset()
     {
         memset(_hashmap, 0, (_mask+1) * sizeof(T*));
+        _count = 0;
     }
 
     void insert(unsigned hash, T* data)
     {
+        if (_count >= _mask + 1)
+            grow();
+
+        data->hashKey = hash;
+        data->hashNext = _hashmap[hash & _mask];
         _hashmap[hash & _mask] = data;
+        _count++;
+    }
+
+    void remove(T* data)
+    {
+        T **entry = &_hashmap[data->hashKey & _mask];
+        while (*entry && *entry != data)
+            entry = &(*entry)->hashNext;
+
+        if (*entry)
+        {
+            *entry = data->hashNext;
+            data->hashNext = NULL;
+            _count--;
+        }
     }
 
     T* find(unsigned hash)
@@ -34,9 +61,36 @@ public:
         return _hashmap[hash & _mask];
     }
 
+    unsigned size() const { return _count; }
+    unsigned buckets() const { return _mask + 1; }
+
 protected:
+    void grow()
+    {
+        unsigned oldSize = _mask + 1;
+        T **oldmap = _hashmap;
+
+        _mask = (oldSize << 1) - 1;
+        _hashmap = (T**)malloc((_mask+1) * sizeof(T*));
+        memset(_hashmap, 0, (_mask+1) * sizeof(T*));
+
+        for (unsigned i = 0; i < oldSize; i++)
+        {
+            T *data = oldmap[i];
+            while (data)
+            {
+                T *next = data->hashNext;
+                data->hashNext = _hashmap[data->hashKey & _mask];
+                _hashmap[data->hashKey & _mask] = data;
+                data = next;
+            }
+        }
+        free(oldmap);
+    }
+
     T **_hashmap;
     unsigned _mask;
+    unsigned _count;
 };
 
 #endif
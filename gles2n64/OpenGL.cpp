@@ -637,6 +637,8 @@ void OGL_SetBlendMode()
 
 void OGL_UpdateStates()
 {
+    OGL.stats.stateUpdates++;
+
     if (gDP.otherMode.cycleType == G_CYC_COPY)
         ShaderCombiner_Set(EncodeCombineMode(0, 0, 0, TEXEL0, 0, 0, 0, TEXEL0, 0, 0, 0, TEXEL0, 0, 0, 0, TEXEL0));
     else if (gDP.otherMode.cycleType == G_CYC_FILL)
@@ -647,6 +649,7 @@ void OGL_UpdateStates()
 #ifdef SHADER_TEST
     ProgramSwaps += scProgramChanged;
 #endif
+    OGL.stats.programChanges += scProgramChanged;
 
     if (gSP.changed & CHANGED_GEOMETRYMODE)
     {
@@ -893,6 +896,9 @@ void OGL_DrawTriangles()
     }
 
     glDrawElements(GL_TRIANGLES, OGL.triangles.num, GL_UNSIGNED_BYTE, OGL.triangles.elements);
+    OGL.stats.drawCalls++;
+    OGL.stats.triangleDraws++;
+    OGL.stats.triangles += OGL.triangles.num / 3;
     OGL.triangles.num = 0;
 
 #ifdef __TRIBUFFER_OPT
@@ -902,6 +908,8 @@ void OGL_DrawTriangles()
 
 void OGL_DrawLine(int v0, int v1, float width )
 {
+    OGL_FlushBatch(true);
+
     if (OGL.renderingToTexture && config.ignoreOffscreenRendering) return;
 
     if ((config.updateMode == SCREEN_UPDATE_AT_1ST_PRIMITIVE) && OGL.screenUpdate)
@@ -932,10 +940,13 @@ void OGL_DrawLine(int v0, int v1, float width )
     elem[1] = v1;
     glLineWidth( width * OGL.scaleX );
     glDrawElements(GL_LINES, 2, GL_UNSIGNED_SHORT, elem);
+    OGL.stats.drawCalls++;
 }
 
 void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
 {
+    OGL_FlushBatch(true);
+
     if (OGL.renderingToTexture && config.ignoreOffscreenRendering) return;
 
     if ((config.updateMode == SCREEN_UPDATE_AT_1ST_PRIMITIVE) && OGL.screenUpdate)
@@ -977,6 +988,7 @@ void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
 
     glVertexAttrib4fv(SC_COLOR, color);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    OGL.stats.drawCalls++;
     glEnable(GL_SCISSOR_TEST);
     OGL_UpdateViewport();
 
@@ -984,6 +996,8 @@ void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
 
 void OGL_DrawTexturedRect( float ulx, float uly, float lrx, float lry, float uls, float ult, float lrs, float lrt, bool flip )
 {
+    OGL_FlushBatch(true);
+
     if (config.hackBanjoTooie)
     {
         if (gDP.textureImage.width == gDP.colorImage.width &&
@@ -1129,11 +1143,14 @@ void OGL_DrawTexturedRect( float ulx, float uly, float lrx, float lry, float uls
     }
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    OGL.stats.drawCalls++;
     OGL_UpdateViewport();
 }
 
 void OGL_ClearDepthBuffer()
 {
+    OGL_FlushBatch(true);
+
     if (OGL.renderingToTexture && config.ignoreOffscreenRendering) return;
 
     if ((config.updateMode == SCREEN_UPDATE_AT_1ST_PRIMITIVE) && OGL.screenUpdate)
@@ -1156,6 +1173,8 @@ void OGL_ClearDepthBuffer()
 
 void OGL_ClearColorBuffer( float *color )
 {
+    OGL_FlushBatch(true);
+
     if (OGL.renderingToTexture && config.ignoreOffscreenRendering) return;
 
     if ((config.updateMode == SCREEN_UPDATE_AT_1ST_PRIMITIVE) && OGL.screenUpdate)
@@ -1231,9 +1250,6 @@ void OGL_SwapBuffers()
 
 #ifdef TEXTURECACHE_TEST
         LOG(LOG_MINIMAL, "texture cache time per frame: %.2f ms\n", (float)TextureCacheTime/ frames);
-        LOG(LOG_MINIMAL, "texture cache per frame: hits=%.2f misses=%.2f\n", (float)cache.hits / frames,
-                (float)cache.misses / frames);
-        cache.hits = cache.misses = 0;
         TextureCacheTime = 0;
 
 #endif
@@ -1250,13 +1266,40 @@ void OGL_SwapBuffers()
     {
         LOG(LOG_MINIMAL, "GBI PROFILE DATA: %i ms \n", profileTicks - profileLastTicks);
         LOG(LOG_MINIMAL, "=========================================================\n");
-        GBI_ProfilePrint(stdout);
+        u32 profileTotal = GBI_ProfilePrint(stdout);
+        LOG(LOG_MINIMAL, "GBI total: %.3f ms\n", profileTotal / 1000.0f);
         LOG(LOG_MINIMAL, "=========================================================\n");
         GBI_ProfileReset();
         profileLastTicks = profileTicks;
     }
 #endif
 
+    OGL.stats.frames++;
+    unsigned statsTicks = ticksGetTicks();
+    if (!config.renderStats || statsTicks >= (OGL.stats.lastTicks + 1000))
+    {
+        if (config.renderStats)
+        {
+            float frames = (float) OGL.stats.frames;
+            LOG(LOG_MINIMAL, "render stats per frame: %.1f draw calls, %.1f triangle draws of %.1f triangles, "
+                    "%.1f state updates, %.1f shader changes\n", OGL.stats.drawCalls / frames,
+                    OGL.stats.triangleDraws / frames,
+                    OGL.stats.triangleDraws ? (float) OGL.stats.triangles / OGL.stats.triangleDraws : 0.0f,
+                    OGL.stats.stateUpdates / frames, OGL.stats.programChanges / frames);
+            LOG(LOG_MINIMAL, "texture cache per frame: %.1f hits, %.1f misses, %.1f lookups of %.2f probes, "
+                    "longest %u; %u textures in %u buckets\n", cache.hits / frames, cache.misses / frames,
+                    cache.lookups / frames, cache.lookups ? (float) cache.probes / cache.lookups : 0.0f,
+                    cache.maxProbes, cache.hash.size(), cache.hash.buckets());
+        }
+
+        OGL.stats.drawCalls = OGL.stats.triangleDraws = OGL.stats.triangles = 0;
+        OGL.stats.stateUpdates = OGL.stats.programChanges = 0;
+        cache.hits = cache.misses = 0;
+        cache.lookups = cache.probes = cache.maxProbes = 0;
+        OGL.stats.frames = 0;
+        OGL.stats.lastTicks = statsTicks;
+    }
+
     // if emulator defined a render callback function, call it before buffer swap
     if (renderCallback)
     {
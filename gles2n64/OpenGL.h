@@ -137,6 +137,17 @@ struct GLInfo
 
     unsigned int    renderState;
 
+    // counted every frame, and logged once a second with "render stats" on
+    struct {
+        int     drawCalls;          // glDrawElements()/glDrawArrays() for triangles, rects and lines
+        int     triangleDraws;
+        int     triangles;
+        int     stateUpdates;       // OGL_UpdateStates() with something to update
+        int     programChanges;
+        int     frames;
+        unsigned lastTicks;
+    } stats;
+
     GLVertex rect[4];
 };
 
@@ -147,6 +158,18 @@ void OGL_Stop();
 
 void OGL_AddTriangle(int v0, int v1, int v2);
 void OGL_DrawTriangles();
+
+// With "batch triangles" on, triangles are kept until the render state they were added with changes, rather than
+// drawn at the end of each run of triangle commands. Whatever changes that state, or draws or loads textures,
+// calls this first; with batching off there are no triangles left by then and it does nothing. It's a macro so that
+// the change isn't worked out when there's nothing to flush.
+#define OGL_FlushBatch(changing) \
+do \
+{ \
+    if ((OGL.triangles.num > 0) && (changing)) \
+        OGL_DrawTriangles(); \
+} while (0)
+
 void OGL_DrawTriangle(SPVertex *vertices, int v0, int v1, int v2);
 void OGL_DrawLine(int v0, int v1, float width);
 void OGL_DrawRect(int ulx, int uly, int lrx, int lry, float *color);
@@ -126,6 +126,9 @@ void RSP_ProcessDList()
 #endif
     }
 
+    // draw whatever the last triangles batched
+    OGL_FlushBatch( true );
+
 #ifdef PRINT_DISPLAYLIST
         if ((RSP.DList%PRINT_DISPLAYLIST_NUM) == 0) LOG(LOG_VERBOSE, "END DISPLAY LIST %i \n", RSP.DList);
 #endif
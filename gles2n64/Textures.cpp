@@ -370,9 +370,9 @@ void TextureCache_Init()
     cache.numCached = 0;
     cache.cachedBytes = 0;
 
-#ifdef __HASHMAP_OPT
+    cache.hits = cache.misses = 0;
+    cache.lookups = cache.probes = cache.maxProbes = 0;
     cache.hash.init(11);
-#endif
 
     if (config.texture.useIA) textureFormat = textureFormatIA;
     else textureFormat = textureFormatRGBA;
@@ -459,11 +459,7 @@ void TextureCache_RemoveBottom()
 {
     CachedTexture *newBottom = cache.bottom->higher;
 
-#ifdef __HASHMAP_OPT
-    CachedTexture* tex= cache.hash.find(cache.bottom->crc);
-    if (tex == cache.bottom)
-        cache.hash.insert(cache.bottom->crc, NULL);
-#endif
+    cache.hash.remove(cache.bottom);
 
     glDeleteTextures( 1, &cache.bottom->glName );
     cache.cachedBytes -= cache.bottom->textureBytes;
@@ -508,11 +504,7 @@ void TextureCache_Remove( CachedTexture *texture )
         texture->lower->higher = texture->higher;
     }
 
-#ifdef __HASHMAP_OPT
-    CachedTexture* tex= cache.hash.find(texture->crc);
-    if (tex == texture);
-        cache.hash.insert(texture->crc, NULL);
-#endif
+    cache.hash.remove(texture);
 
     glDeleteTextures( 1, &texture->glName );
     cache.cachedBytes -= texture->textureBytes;
@@ -537,6 +529,8 @@ CachedTexture *TextureCache_AddTop()
 
     newtop->lower = cache.top;
     newtop->higher = NULL;
+    newtop->hashKey = 0;
+    newtop->hashNext = NULL;
 
     if (cache.top)
         cache.top->higher = newtop;
@@ -580,9 +574,7 @@ void TextureCache_Destroy()
     glDeleteTextures( 32, cache.glNoiseNames );
     glDeleteTextures( 1, &cache.dummy->glName  );
 
-#ifdef __HASHMAP_OPT
     cache.hash.destroy();
-#endif
 
     cache.top = NULL;
     cache.bottom = NULL;
@@ -930,10 +922,6 @@ u32 TextureCache_CalculateCRC( u32 t, u32 width, u32 height )
 void TextureCache_ActivateTexture( u32 t, CachedTexture *texture )
 {
 
-#ifdef __HASHMAP_OPT
-    cache.hash.insert(texture->crc, texture);
-#endif
-
     glActiveTexture( GL_TEXTURE0 + t );
     glBindTexture( GL_TEXTURE_2D, texture->glName );
 
@@ -1005,30 +993,20 @@ void TextureCache_UpdateBackground()
         return;
     }
 
-#ifdef __HASHMAP_OPT
-    CachedTexture *tex = cache.hash.find(crc);
-    if (tex)
-    {
-        if (_background_compare(tex, crc))
-        {
-            TextureCache_ActivateTexture(0, tex);
-            cache.hits++;
-            return;
-        }
-    }
-#endif
-
-    CachedTexture *current = cache.top;
-    while (current)
+    unsigned key = TextureCache_Key( crc, gSP.bgImage.width, gSP.bgImage.height );
+    u32 probes = 0;
+    for (CachedTexture *current = cache.hash.find(key); current; current = current->hashNext)
     {
-        if (_background_compare(current, crc))
+        probes++;
+        if (current->hashKey == key && _background_compare(current, crc))
         {
+            TextureCache_CountLookup(probes);
             TextureCache_ActivateTexture( 0, current );
             cache.hits++;
             return;
         }
-        current = current->lower;
     }
+    TextureCache_CountLookup(probes);
     cache.misses++;
 
     glActiveTexture(GL_TEXTURE0);
@@ -1062,6 +1040,7 @@ void TextureCache_UpdateBackground()
     cache.current[0]->shiftScaleS = 1.0f;
     cache.current[0]->shiftScaleT = 1.0f;
 
+    cache.hash.insert( key, cache.current[0] );
     TextureCache_LoadBackground( cache.current[0] );
     TextureCache_ActivateTexture( 0, cache.current[0] );
 
@@ -1212,32 +1191,21 @@ void TextureCache_Update( u32 t )
         return;
     }
 
-#ifdef __HASHMAP_OPT
-    CachedTexture *tex = cache.hash.find(crc);
-    if (tex)
-    {
-        if (_texture_compare(t, tex, crc, width, height, clampWidth, clampHeight))
-        {
-            TextureCache_ActivateTexture( t, tex);
-            cache.hits++;
-            return;
-        }
-    }
-#endif
-
-    current = cache.top;
-    while (current)
+    unsigned key = TextureCache_Key( crc, width, height );
+    u32 probes = 0;
+    for (current = cache.hash.find(key); current; current = current->hashNext)
     {
-        if  (_texture_compare(t, current, crc, width, height, clampWidth, clampHeight))
+        probes++;
+        if (current->hashKey == key && _texture_compare(t, current, crc, width, height, clampWidth, clampHeight))
         {
+            TextureCache_CountLookup(probes);
             TextureCache_ActivateTexture( t, current );
             cache.hits++;
             return;
         }
-
-        current = current->lower;
     }
 
+    TextureCache_CountLookup(probes);
     cache.misses++;
 
     glActiveTexture( GL_TEXTURE0 + t);
@@ -1318,6 +1286,7 @@ void TextureCache_Update( u32 t )
     else if (gSP.textureTile[t]->shiftt > 0)
         cache.current[t]->shiftScaleT /= (f32)(1 << gSP.textureTile[t]->shiftt);
 
+    cache.hash.insert( key, cache.current[t] );
     TextureCache_Load( cache.current[t] );
     TextureCache_ActivateTexture( t, cache.current[t] );
 
@@ -30,6 +30,9 @@ struct CachedTexture
     CachedTexture   *lower, *higher;
     u32     lastDList;
 
+    unsigned        hashKey;        // see TextureCache_Key()
+    CachedTexture   *hashNext;
+
 };
 
 #define TEXTURECACHE_MAX (8 * 1024 * 1024)
@@ -43,10 +46,13 @@ struct TextureCache
 
     u32             cachedBytes;
     u32             numCached;
+    // always counted, logged and cleared once a second with "render stats" on
     u32             hits, misses;
+    u32             lookups, probes;    // hash lookups, and entries compared by them
+    u32             maxProbes;          // most entries compared by one lookup
     GLuint          glNoiseNames[32];
 
-    HashMap<CachedTexture>  hash;
+    HashMap<CachedTexture>  hash;       // all the cached textures but the dummy, by TextureCache_Key()
 
 };
 
@@ -75,6 +81,19 @@ inline u32 powof( u32 dim )
     return i;
 }
 
+// Hash key of a cached texture: its CRC and N64 size, which are known before looking it up
+inline unsigned TextureCache_Key( u32 crc, u32 width, u32 height )
+{
+    return crc ^ (((width << 16) | height) * 2654435761U);
+}
+
+inline void TextureCache_CountLookup( u32 probes )
+{
+    cache.lookups++;
+    cache.probes += probes;
+    if (probes > cache.maxProbes) cache.maxProbes = probes;
+}
+
 CachedTexture *TextureCache_AddTop();
 void TextureCache_MoveToTop( CachedTexture *newtop );
 void TextureCache_Remove( CachedTexture *texture );
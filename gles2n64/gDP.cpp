@@ -118,8 +118,17 @@ bool _IsRenderTexture()
 
 gDPInfo gDP;
 
+// for OGL_FlushBatch, whether an r, g, b, a colour would change
+static inline bool gDPColorChanged( const f32 *color, u32 r, u32 g, u32 b, u32 a )
+{
+    return (color[0] != r * 0.0039215689f) || (color[1] != g * 0.0039215689f) ||
+        (color[2] != b * 0.0039215689f) || (color[3] != a * 0.0039215689f);
+}
+
 void gDPSetOtherMode( u32 mode0, u32 mode1 )
 {
+    OGL_FlushBatch( (gDP.otherMode.h != mode0) || (gDP.otherMode.l != mode1) );
+
     gDP.otherMode.h = mode0;
     gDP.otherMode.l = mode1;
     gDP.changed |= CHANGED_RENDERMODE | CHANGED_CYCLETYPE | CHANGED_ALPHACOMPARE;
@@ -156,7 +165,11 @@ void gDPSetPrimDepth( u16 z, u16 dz )
     z = z&0x7FFF;
 
     //gDP.primDepth.z = (_FIXED2FLOAT( z, 15 ) - gSP.viewport.vtrans[2]) / gSP.viewport.vscale[2] ;
-    gDP.primDepth.z = (z - gSP.viewport.vtrans[2]) / gSP.viewport.vscale[2] ;
+    f32 primZ = (z - gSP.viewport.vtrans[2]) / gSP.viewport.vscale[2] ;
+
+    OGL_FlushBatch( (gDP.primDepth.z != primZ) || (gDP.primDepth.deltaZ != dz) );
+
+    gDP.primDepth.z = primZ;
     gDP.primDepth.deltaZ = dz;
     gDP.changed |= CHANGED_PRIMITIVEZ;
 
@@ -169,6 +182,8 @@ void gDPSetPrimDepth( u16 z, u16 dz )
 
 void gDPPipelineMode( u32 mode )
 {
+    OGL_FlushBatch( gDP.otherMode.pipelineMode != mode );
+
     gDP.otherMode.pipelineMode = mode;
 
 #ifdef DEBUG
@@ -179,6 +194,8 @@ void gDPPipelineMode( u32 mode )
 
 void gDPSetCycleType( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.cycleType != type );
+
     gDP.otherMode.cycleType = type;
     gDP.changed |= CHANGED_CYCLETYPE;
 
@@ -190,6 +207,8 @@ void gDPSetCycleType( u32 type )
 
 void gDPSetTexturePersp( u32 enable )
 {
+    OGL_FlushBatch( gDP.otherMode.texturePersp != enable );
+
     gDP.otherMode.texturePersp = enable;
 
 #ifdef DEBUG
@@ -200,6 +219,8 @@ void gDPSetTexturePersp( u32 enable )
 
 void gDPSetTextureDetail( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.textureDetail != type );
+
     gDP.otherMode.textureDetail = type;
 
 #ifdef DEBUG
@@ -210,6 +231,8 @@ void gDPSetTextureDetail( u32 type )
 
 void gDPSetTextureLOD( u32 mode )
 {
+    OGL_FlushBatch( gDP.otherMode.textureLOD != mode );
+
     gDP.otherMode.textureLOD = mode;
 
 #ifdef DEBUG
@@ -220,6 +243,8 @@ void gDPSetTextureLOD( u32 mode )
 
 void gDPSetTextureLUT( u32 mode )
 {
+    OGL_FlushBatch( gDP.otherMode.textureLUT != mode );
+
     gDP.otherMode.textureLUT = mode;
 
 #ifdef DEBUG
@@ -230,6 +255,8 @@ void gDPSetTextureLUT( u32 mode )
 
 void gDPSetTextureFilter( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.textureFilter != type );
+
     gDP.otherMode.textureFilter = type;
 
 #ifdef DEBUG
@@ -240,6 +267,8 @@ void gDPSetTextureFilter( u32 type )
 
 void gDPSetTextureConvert( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.textureConvert != type );
+
     gDP.otherMode.textureConvert = type;
 
 #ifdef DEBUG
@@ -250,6 +279,8 @@ void gDPSetTextureConvert( u32 type )
 
 void gDPSetCombineKey( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.combineKey != type );
+
     gDP.otherMode.combineKey = type;
 
 #ifdef DEBUG
@@ -260,6 +291,8 @@ void gDPSetCombineKey( u32 type )
 
 void gDPSetColorDither( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.colorDither != type );
+
     gDP.otherMode.colorDither = type;
 
 #ifdef DEBUG
@@ -270,6 +303,8 @@ void gDPSetColorDither( u32 type )
 
 void gDPSetAlphaDither( u32 type )
 {
+    OGL_FlushBatch( gDP.otherMode.alphaDither != type );
+
     gDP.otherMode.alphaDither = type;
 
 #ifdef DEBUG
@@ -280,6 +315,8 @@ void gDPSetAlphaDither( u32 type )
 
 void gDPSetAlphaCompare( u32 mode )
 {
+    OGL_FlushBatch( gDP.otherMode.alphaCompare != mode );
+
     gDP.otherMode.alphaCompare = mode;
     gDP.changed |= CHANGED_ALPHACOMPARE;
 
@@ -291,6 +328,8 @@ void gDPSetAlphaCompare( u32 mode )
 
 void gDPSetDepthSource( u32 source )
 {
+    OGL_FlushBatch( gDP.otherMode.depthSource != source );
+
     gDP.otherMode.depthSource = source;
     gDP.changed |= CHANGED_DEPTHSOURCE;
 
@@ -302,6 +341,8 @@ void gDPSetDepthSource( u32 source )
 
 void gDPSetRenderMode( u32 mode1, u32 mode2 )
 {
+    OGL_FlushBatch( (gDP.otherMode.l & ~0x00000007) != (mode1 | mode2) );
+
     gDP.otherMode.l &= 0x00000007;
     gDP.otherMode.l |= mode1 | mode2;
     gDP.changed |= CHANGED_RENDERMODE;
@@ -323,6 +364,8 @@ void gDPSetRenderMode( u32 mode1, u32 mode2 )
 
 void gDPSetCombine( s32 muxs0, s32 muxs1 )
 {
+    OGL_FlushBatch( (gDP.combine.muxs0 != (u32)muxs0) || (gDP.combine.muxs1 != (u32)muxs1) );
+
     gDP.combine.muxs0 = muxs0;
     gDP.combine.muxs1 = muxs1;
     gDP.changed |= CHANGED_COMBINE;
@@ -353,14 +396,19 @@ void gDPSetCombine( s32 muxs0, s32 muxs1 )
 
 void gDPSetColorImage( u32 format, u32 size, u32 width, u32 address )
 {
+    u32 addr = RSP_SegmentToPhysical( address );
+
+    OGL_FlushBatch( (config.updateMode == SCREEN_UPDATE_AT_CI_CHANGE) ||
+        (config.updateMode == SCREEN_UPDATE_AT_1ST_CI_CHANGE && OGL.screenUpdate) ||
+        (gDP.colorImage.address != addr) || (gDP.colorImage.format != format) ||
+        (gDP.colorImage.size != size) || (gDP.colorImage.width != width) );
+
     if (config.updateMode == SCREEN_UPDATE_AT_CI_CHANGE)
         OGL_SwapBuffers();
 
     if (config.updateMode == SCREEN_UPDATE_AT_1ST_CI_CHANGE && OGL.screenUpdate)
         OGL_SwapBuffers();
 
-    u32 addr = RSP_SegmentToPhysical( address );
-
     if (gDP.colorImage.address != addr)
     {
         gDP.colorImage.changed = FALSE;
@@ -460,6 +508,9 @@ void gDPSetDepthImage( u32 address )
 //      OGL_ClearDepthBuffer();
 
     u32 addr = RSP_SegmentToPhysical(address);
+
+    OGL_FlushBatch( gDP.depthImageAddress != addr );
+
     DepthBuffer_SetBuffer(addr);
 
     if (depthBuffer.current->cleared)
@@ -474,6 +525,8 @@ void gDPSetDepthImage( u32 address )
 
 void gDPSetEnvColor( u32 r, u32 g, u32 b, u32 a )
 {
+    OGL_FlushBatch( gDPColorChanged( &gDP.envColor.r, r, g, b, a ) );
+
     gDP.envColor.r = r * 0.0039215689f;
     gDP.envColor.g = g * 0.0039215689f;
     gDP.envColor.b = b * 0.0039215689f;
@@ -489,6 +542,8 @@ void gDPSetEnvColor( u32 r, u32 g, u32 b, u32 a )
 
 void gDPSetBlendColor( u32 r, u32 g, u32 b, u32 a )
 {
+    OGL_FlushBatch( gDPColorChanged( &gDP.blendColor.r, r, g, b, a ) );
+
     gDP.blendColor.r = r * 0.0039215689f;
     gDP.blendColor.g = g * 0.0039215689f;
     gDP.blendColor.b = b * 0.0039215689f;
@@ -503,6 +558,8 @@ void gDPSetBlendColor( u32 r, u32 g, u32 b, u32 a )
 
 void gDPSetFogColor( u32 r, u32 g, u32 b, u32 a )
 {
+    OGL_FlushBatch( gDPColorChanged( &gDP.fogColor.r, r, g, b, a ) );
+
     gDP.fogColor.r = r * 0.0039215689f;
     gDP.fogColor.g = g * 0.0039215689f;
     gDP.fogColor.b = b * 0.0039215689f;
@@ -518,6 +575,7 @@ void gDPSetFogColor( u32 r, u32 g, u32 b, u32 a )
 
 void gDPSetFillColor( u32 c )
 {
+    OGL_FlushBatch( gDP.fillColor.i != c );
 
     gDP.fillColor.i = c;
     gDP.fillColor.r = _SHIFTR( c, 11, 5 ) * 0.032258064f;
@@ -535,6 +593,9 @@ void gDPSetFillColor( u32 c )
 
 void gDPSetPrimColor( u32 m, u32 l, u32 r, u32 g, u32 b, u32 a )
 {
+    OGL_FlushBatch( (gDP.primColor.m != m) || (gDP.primColor.l != l * 0.0039215689f) ||
+        gDPColorChanged( &gDP.primColor.r, r, g, b, a ) );
+
     gDP.primColor.m = m;
     gDP.primColor.l = l * 0.0039215689f;
     gDP.primColor.r = r * 0.0039215689f;
@@ -555,6 +616,13 @@ void gDPSetTile( u32 format, u32 size, u32 line, u32 tmem, u32 tile, u32 palette
     if (((size == G_IM_SIZ_4b) || (size == G_IM_SIZ_8b)) && (format == G_IM_FMT_RGBA))
         format = G_IM_FMT_CI;
 
+    OGL_FlushBatch( (gDP.tiles[tile].format != format) || (gDP.tiles[tile].size != size) ||
+        (gDP.tiles[tile].line != line) || (gDP.tiles[tile].tmem != tmem) ||
+        (gDP.tiles[tile].palette != palette) || (gDP.tiles[tile].cmt != cmt) ||
+        (gDP.tiles[tile].cms != cms) || (gDP.tiles[tile].maskt != maskt) ||
+        (gDP.tiles[tile].masks != masks) || (gDP.tiles[tile].shiftt != shiftt) ||
+        (gDP.tiles[tile].shifts != shifts) );
+
     gDP.tiles[tile].format = format;
     gDP.tiles[tile].size = size;
     gDP.tiles[tile].line = line;
@@ -573,6 +641,9 @@ void gDPSetTile( u32 format, u32 size, u32 line, u32 tmem, u32 tile, u32 palette
 
 void gDPSetTileSize( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 {
+    OGL_FlushBatch( (gDP.tiles[tile].fuls != _FIXED2FLOAT( uls, 2 )) || (gDP.tiles[tile].fult != _FIXED2FLOAT( ult, 2 )) ||
+        (gDP.tiles[tile].flrs != _FIXED2FLOAT( lrs, 2 )) || (gDP.tiles[tile].flrt != _FIXED2FLOAT( lrt, 2 )) );
+
     gDP.tiles[tile].uls = _SHIFTR( uls, 2, 10 );
     gDP.tiles[tile].ult = _SHIFTR( ult, 2, 10 );
     gDP.tiles[tile].lrs = _SHIFTR( lrs, 2, 10 );
@@ -597,6 +668,8 @@ void gDPSetTileSize( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 
 void gDPLoadTile( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 {
+    OGL_FlushBatch( true );
+
     void (*Interleave)( void *mem, u32 numDWords );
 
     u32 address, height, bpl, line, y;
@@ -660,6 +733,8 @@ void gDPLoadTile( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 
 void gDPLoadBlock( u32 tile, u32 uls, u32 ult, u32 lrs, u32 dxt )
 {
+    OGL_FlushBatch( true );
+
     gDPSetTileSize( tile, uls, ult, lrs, dxt );
     gDP.loadTile = &gDP.tiles[tile];
 
@@ -726,6 +801,8 @@ void gDPLoadBlock( u32 tile, u32 uls, u32 ult, u32 lrs, u32 dxt )
 
 void gDPLoadTLUT( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 {
+    OGL_FlushBatch( true );
+
     gDPSetTileSize( tile, uls, ult, lrs, lrt );
 
     u16 count = (gDP.tiles[tile].lrs - gDP.tiles[tile].uls + 1) * (gDP.tiles[tile].lrt - gDP.tiles[tile].ult + 1);
@@ -767,6 +844,9 @@ void gDPLoadTLUT( u32 tile, u32 uls, u32 ult, u32 lrs, u32 lrt )
 
 void gDPSetScissor( u32 mode, f32 ulx, f32 uly, f32 lrx, f32 lry )
 {
+    OGL_FlushBatch( (gDP.scissor.mode != mode) || (gDP.scissor.ulx != ulx) || (gDP.scissor.uly != uly) ||
+        (gDP.scissor.lrx != lrx) || (gDP.scissor.lry != lry) );
+
     gDP.scissor.mode = mode;
     gDP.scissor.ulx = ulx;
     gDP.scissor.uly = uly;
@@ -828,6 +908,8 @@ void gDPFillRectangle( s32 ulx, s32 uly, s32 lrx, s32 lry )
 
 void gDPSetConvert( s32 k0, s32 k1, s32 k2, s32 k3, s32 k4, s32 k5 )
 {
+    OGL_FlushBatch( true );
+
     gDP.convert.k0 = k0 * 0.0039215689f;
     gDP.convert.k1 = k1 * 0.0039215689f;
     gDP.convert.k2 = k2 * 0.0039215689f;
@@ -839,6 +921,8 @@ void gDPSetConvert( s32 k0, s32 k1, s32 k2, s32 k3, s32 k4, s32 k5 )
 
 void gDPSetKeyR( u32 cR, u32 sR, u32 wR )
 {
+    OGL_FlushBatch( true );
+
     gDP.key.center.r = cR * 0.0039215689f;;
     gDP.key.scale.r = sR * 0.0039215689f;;
     gDP.key.width.r = wR * 0.0039215689f;;
@@ -846,6 +930,8 @@ void gDPSetKeyR( u32 cR, u32 sR, u32 wR )
 
 void gDPSetKeyGB(u32 cG, u32 sG, u32 wG, u32 cB, u32 sB, u32 wB )
 {
+    OGL_FlushBatch( true );
+
     gDP.key.center.g = cG * 0.0039215689f;;
     gDP.key.scale.g = sG * 0.0039215689f;;
     gDP.key.width.g = wG * 0.0039215689f;;
@@ -856,6 +942,8 @@ void gDPSetKeyGB(u32 cG, u32 sG, u32 wG, u32 cB, u32 sB, u32 wB )
 
 void gDPTextureRectangle( f32 ulx, f32 uly, f32 lrx, f32 lry, s32 tile, f32 s, f32 t, f32 dsdx, f32 dtdy )
 {
+    OGL_FlushBatch( true );
+
     if (gDP.colorImage.address == gDP.depthImageAddress)
     {
         return;
@@ -334,7 +334,7 @@ static void gSPBillboardVertex4_default(u32 v)
     OGL.triangles.vertices[v+3].w += OGL.triangles.vertices[i].w;
 }
 
-void gSPProcessVertex4(u32 v)
+static void gSPProcessVertex4_default(u32 v)
 {
     if (gSP.changed & CHANGED_MATRIX)
         gSPCombineMatrices();
@@ -555,6 +555,8 @@ void gSPProcessVertex( u32 v )
 
 void gSPLoadUcodeEx( u32 uc_start, u32 uc_dstart, u16 uc_dsize )
 {
+    OGL_FlushBatch( true );
+
     RSP.PCi = 0;
     gSP.matrix.modelViewi = 0;
     gSP.changed |= CHANGED_MATRIX;
@@ -671,14 +673,20 @@ void gSPViewport( u32 v )
         return;
     }
 
-    gSP.viewport.vscale[0] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  2], 2 );
-    gSP.viewport.vscale[1] = _FIXED2FLOAT( *(s16*)&RDRAM[address     ], 2 );
-    gSP.viewport.vscale[2] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  6], 10 );// * 0.00097847357f;
-    gSP.viewport.vscale[3] = *(s16*)&RDRAM[address +  4];
-    gSP.viewport.vtrans[0] = _FIXED2FLOAT( *(s16*)&RDRAM[address + 10], 2 );
-    gSP.viewport.vtrans[1] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  8], 2 );
-    gSP.viewport.vtrans[2] = _FIXED2FLOAT( *(s16*)&RDRAM[address + 14], 10 );// * 0.00097847357f;
-    gSP.viewport.vtrans[3] = *(s16*)&RDRAM[address + 12];
+    f32 vscale[4], vtrans[4];
+    vscale[0] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  2], 2 );
+    vscale[1] = _FIXED2FLOAT( *(s16*)&RDRAM[address     ], 2 );
+    vscale[2] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  6], 10 );// * 0.00097847357f;
+    vscale[3] = *(s16*)&RDRAM[address +  4];
+    vtrans[0] = _FIXED2FLOAT( *(s16*)&RDRAM[address + 10], 2 );
+    vtrans[1] = _FIXED2FLOAT( *(s16*)&RDRAM[address +  8], 2 );
+    vtrans[2] = _FIXED2FLOAT( *(s16*)&RDRAM[address + 14], 10 );// * 0.00097847357f;
+    vtrans[3] = *(s16*)&RDRAM[address + 12];
+
+    OGL_FlushBatch( memcmp( gSP.viewport.vscale, vscale, sizeof( vscale ) ) || memcmp( gSP.viewport.vtrans, vtrans, sizeof( vtrans ) ) );
+
+    memcpy( gSP.viewport.vscale, vscale, sizeof( vscale ) );
+    memcpy( gSP.viewport.vtrans, vtrans, sizeof( vtrans ) );
 
     gSP.viewport.x      = gSP.viewport.vtrans[0] - gSP.viewport.vscale[0];
     gSP.viewport.y      = gSP.viewport.vtrans[1] - gSP.viewport.vscale[1];
@@ -1149,6 +1157,8 @@ void gSPInterpolateVertex( SPVertex *dest, f32 percent, SPVertex *first, SPVerte
 
 void gSPDMATriangles( u32 tris, u32 n )
 {
+    OGL_FlushBatch( true );
+
     u32 address = RSP_SegmentToPhysical( tris );
 
     if (address + sizeof( DKRTriangle ) * n > RDRAMSize)
@@ -1330,6 +1340,8 @@ void gSPInsertMatrix( u32 where, u32 num )
 
 void gSPModifyVertex( u32 vtx, u32 where, u32 val )
 {
+    OGL_FlushBatch( true );
+
     s32 v = vtx;
 
 #ifdef __TRIBUFFER_OPT
@@ -1375,6 +1387,8 @@ void gSPLightColor( u32 lightNum, u32 packedColor )
 
 void gSPFogFactor( s16 fm, s16 fo )
 {
+    OGL_FlushBatch( (gSP.fog.multiplier != fm) || (gSP.fog.offset != fo) );
+
     gSP.fog.multiplier = fm;
     gSP.fog.offset = fo;
 
@@ -1387,6 +1401,9 @@ void gSPPerspNormalize( u16 scale )
 
 void gSPTexture( f32 sc, f32 tc, s32 level, s32 tile, s32 on )
 {
+    OGL_FlushBatch( (gSP.texture.scales != ((sc == 0.0f) ? 1.0f : sc)) || (gSP.texture.scalet != ((tc == 0.0f) ? 1.0f : tc)) ||
+        (gSP.texture.level != level) || (gSP.texture.tile != tile) || (gSP.texture.on != on) );
+
     gSP.texture.scales = sc;
     gSP.texture.scalet = tc;
 
@@ -1424,18 +1441,24 @@ void gSPEndDisplayList()
 
 void gSPGeometryMode( u32 clear, u32 set )
 {
+    OGL_FlushBatch( gSP.geometryMode != ((gSP.geometryMode & ~clear) | set) );
+
     gSP.geometryMode = (gSP.geometryMode & ~clear) | set;
     gSP.changed |= CHANGED_GEOMETRYMODE;
 }
 
 void gSPSetGeometryMode( u32 mode )
 {
+    OGL_FlushBatch( gSP.geometryMode != (gSP.geometryMode | mode) );
+
     gSP.geometryMode |= mode;
     gSP.changed |= CHANGED_GEOMETRYMODE;
 }
 
 void gSPClearGeometryMode( u32 mode )
 {
+    OGL_FlushBatch( gSP.geometryMode != (gSP.geometryMode & ~mode) );
+
     gSP.geometryMode &= ~mode;
     gSP.changed |= CHANGED_GEOMETRYMODE;
 }
@@ -1452,6 +1475,7 @@ void gSPLineW3D( s32 v0, s32 v1, s32 wd, s32 flag )
 
 void gSPBgRect1Cyc( u32 bg )
 {
+    OGL_FlushBatch( true );
 
 #if 1
 
@@ -1539,6 +1563,8 @@ void gSPBgRect1Cyc( u32 bg )
 
 void gSPBgRectCopy( u32 bg )
 {
+    OGL_FlushBatch( true );
+
     u32 address = RSP_SegmentToPhysical( bg );
     uObjBg *objBg = (uObjBg*)&RDRAM[address];
 
@@ -1609,6 +1635,8 @@ void gSPObjLoadTxtr( u32 tx )
 
 void gSPObjSprite( u32 sp )
 {
+    OGL_FlushBatch( true );
+
     u32 address = RSP_SegmentToPhysical( sp );
     uObjSprite *objSprite = (uObjSprite*)&RDRAM[address];
 
@@ -1728,6 +1756,7 @@ void (*gSPTransformNormal4)(u32 v, float mtx[4][4]) =
         gSPTransformNormal4_default;
 void (*gSPLightVertex4)(u32 v) = gSPLightVertex4_default;
 void (*gSPBillboardVertex4)(u32 v) = gSPBillboardVertex4_default;
+void (*gSPProcessVertex4)(u32 v) = gSPProcessVertex4_default;
 #endif
 void (*gSPTransformVertex)(float vtx[4], float mtx[4][4]) =
         gSPTransformVertex_default;
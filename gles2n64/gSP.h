@@ -49,32 +49,46 @@
 //        OGL_DrawTriangles(); \
 //    }
 //#endif
+#ifdef __TRIBUFFER_OPT
+#define gSPBatchTriangles() (config.batchTriangles)
+#else
+// without the index map, loading vertices overwrites the ones batched triangles use
+#define gSPBatchTriangles() (0)
+#endif
+
+// with triangle batching, only a full buffer draws the triangles here (see OGL_FlushBatch)
 #define gSPFlushTriangles() \
 if \
 ( \
+    (gSPBatchTriangles()) ? \
     ( \
-         (config.tribufferOpt) && \
-         (OGL.triangles.num > 1000) || \
-         ( \
-             (RSP.nextCmd != G_NOOP) && \
-             (RSP.nextCmd != G_RDPNOOP) && \
-             (RSP.nextCmd != G_MOVEMEM) && \
-             (RSP.nextCmd != G_ENDDL) && \
-             (RSP.nextCmd != G_DL) && \
-             (RSP.nextCmd != G_VTXCOLORBASE) && \
-             (RSP.nextCmd != G_TRI1) && \
-             (RSP.nextCmd != G_TRI2) && \
-             (RSP.nextCmd != G_TRI4) && \
-             (RSP.nextCmd != G_QUAD) && \
-             (RSP.nextCmd != G_VTX) && \
-             (RSP.nextCmd != G_MTX) \
-         ) \
-    ) || \
+        (OGL.triangles.num > 1000) \
+    ) : \
     ( \
-        (RSP.nextCmd != G_TRI1) && \
-        (RSP.nextCmd != G_TRI2) && \
-        (RSP.nextCmd != G_TRI4) && \
-        (RSP.nextCmd != G_QUAD) \
+        ( \
+            (config.tribufferOpt) && \
+            (OGL.triangles.num > 1000) || \
+            ( \
+                (RSP.nextCmd != G_NOOP) && \
+                (RSP.nextCmd != G_RDPNOOP) && \
+                (RSP.nextCmd != G_MOVEMEM) && \
+                (RSP.nextCmd != G_ENDDL) && \
+                (RSP.nextCmd != G_DL) && \
+                (RSP.nextCmd != G_VTXCOLORBASE) && \
+                (RSP.nextCmd != G_TRI1) && \
+                (RSP.nextCmd != G_TRI2) && \
+                (RSP.nextCmd != G_TRI4) && \
+                (RSP.nextCmd != G_QUAD) && \
+                (RSP.nextCmd != G_VTX) && \
+                (RSP.nextCmd != G_MTX) \
+            ) \
+        ) || \
+        ( \
+            (RSP.nextCmd != G_TRI1) && \
+            (RSP.nextCmd != G_TRI2) && \
+            (RSP.nextCmd != G_TRI4) && \
+            (RSP.nextCmd != G_QUAD) \
+        ) \
     ) \
 ) \
 { \
@@ -227,6 +241,7 @@ void gSPObjSubMatrix( u32 mtx );
 void gSPSetDMAOffsets( u32 mtxoffset, u32 vtxoffset );
 void gSPSetVertexColorBase( u32 base );
 void gSPProcessVertex(u32 v);
+void gSPCombineMatrices();
 
 void gSPTriangleUnknown();
 
@@ -251,6 +266,7 @@ extern void (*gSPTransformVertex4)(u32 v, float mtx[4][4]);
 extern void (*gSPTransformNormal4)(u32 v, float mtx[4][4]);
 extern void (*gSPLightVertex4)(u32 v);
 extern void (*gSPBillboardVertex4)(u32 v);
+extern void (*gSPProcessVertex4)(u32 v);
 #endif
 extern void (*gSPTransformVertex)(float vtx[4], float mtx[4][4]);
 extern void (*gSPLightVertex)(u32 v);
@@ -260,5 +276,12 @@ extern void (*gSPBillboardVertex)(u32 v, u32 i);
 void gSPInitNeon();
 #endif
 
+#ifdef __SSE_OPT
+void gSPInitSSE();
+#ifdef VERTEX_TEST
+void gSPVertexTestPrint();
+#endif
+#endif
+
 #endif
 
@@ -1,6 +1,7 @@
 #include "gSP.h"
 #include "OpenGL.h"
 
+#ifdef __NEON_OPT
 #ifdef __VEC4_OPT
 static void gSPTransformVertex4NEON(u32 v, float mtx[4][4])
 {
@@ -561,3 +562,4 @@ void gSPInitNeon()
     gSPLightVertex = gSPLightVertexNEON;
     gSPBillboardVertex = gSPBillboardVertexNEON;
 }
+#endif
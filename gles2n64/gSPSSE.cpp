@@ -0,0 +1,316 @@
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "Common.h"
+#include "gSP.h"
+#include "gDP.h"
+#include "OpenGL.h"
+#include "Config.h"
+
+#ifdef __SSE_OPT
+// Only the functions in this file use SSE2: the rest of the plugin is built for the base instruction set, and
+// PluginStartup installs these when the CPU has SSE2.
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#include <emmintrin.h>
+
+// The x86 counterpart of gSPNeon.cpp. gSPProcessVertex4SSE() does all of gSPProcessVertex4() for its four vertices
+// at once: they are loaded from OGL.triangles.vertices, transposed so that each register holds one field of the four
+// vertices (x0 x1 x2 x3, y0 y1 y2 y3, ...), worked on, and transposed back when they are stored.
+
+#define SPLAT(f)    _mm_set1_ps(f)
+
+// loads a row of four floats from each of the four vertices, starting at field
+#define LOAD4(vtx, field, a, b, c, d) \
+    { \
+        a = _mm_loadu_ps(&(vtx)[0].field); \
+        b = _mm_loadu_ps(&(vtx)[1].field); \
+        c = _mm_loadu_ps(&(vtx)[2].field); \
+        d = _mm_loadu_ps(&(vtx)[3].field); \
+        _MM_TRANSPOSE4_PS(a, b, c, d); \
+    }
+
+#define STORE4(vtx, field, a, b, c, d) \
+    { \
+        __m128 _a = a, _b = b, _c = c, _d = d; \
+        _MM_TRANSPOSE4_PS(_a, _b, _c, _d); \
+        _mm_storeu_ps(&(vtx)[0].field, _a); \
+        _mm_storeu_ps(&(vtx)[1].field, _b); \
+        _mm_storeu_ps(&(vtx)[2].field, _c); \
+        _mm_storeu_ps(&(vtx)[3].field, _d); \
+    }
+
+#ifdef __VEC4_OPT
+// the upper 3x3 of mtx applied to the normals, which are then normalized (left alone where their length is 0)
+static inline void gSPTransformNormal4SSE(__m128 &nx, __m128 &ny, __m128 &nz, float mtx[4][4])
+{
+    __m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, SPLAT(mtx[0][0])), _mm_mul_ps(ny, SPLAT(mtx[1][0]))),
+            _mm_mul_ps(nz, SPLAT(mtx[2][0])));
+    __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, SPLAT(mtx[0][1])), _mm_mul_ps(ny, SPLAT(mtx[1][1]))),
+            _mm_mul_ps(nz, SPLAT(mtx[2][1])));
+    __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, SPLAT(mtx[0][2])), _mm_mul_ps(ny, SPLAT(mtx[1][2]))),
+            _mm_mul_ps(nz, SPLAT(mtx[2][2])));
+
+    __m128 len = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    __m128 nonzero = _mm_cmpneq_ps(len, _mm_setzero_ps());
+    len = _mm_sqrt_ps(len);
+
+    nx = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(x, len)), _mm_andnot_ps(nonzero, x));
+    ny = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(y, len)), _mm_andnot_ps(nonzero, y));
+    nz = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(z, len)), _mm_andnot_ps(nonzero, z));
+}
+
+static void gSPLightVertex4SSE(SPVertex *vtx)
+{
+    __m128 nx, ny, nz, pad;
+    __m128 r, g, b, a;
+
+    LOAD4(vtx, nx, nx, ny, nz, pad);
+    gSPTransformNormal4SSE(nx, ny, nz, gSP.matrix.modelView[gSP.matrix.modelViewi]);
+    STORE4(vtx, nx, nx, ny, nz, pad);
+
+    LOAD4(vtx, r, r, g, b, a);
+    r = SPLAT(gSP.lights[gSP.numLights].r);
+    g = SPLAT(gSP.lights[gSP.numLights].g);
+    b = SPLAT(gSP.lights[gSP.numLights].b);
+
+    for (int i = 0; i < gSP.numLights; i++)
+    {
+        __m128 intensity = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, SPLAT(gSP.lights[i].x)),
+                _mm_mul_ps(ny, SPLAT(gSP.lights[i].y))), _mm_mul_ps(nz, SPLAT(gSP.lights[i].z)));
+        intensity = _mm_max_ps(intensity, _mm_setzero_ps());
+        r = _mm_add_ps(r, _mm_mul_ps(intensity, SPLAT(gSP.lights[i].r)));
+        g = _mm_add_ps(g, _mm_mul_ps(intensity, SPLAT(gSP.lights[i].g)));
+        b = _mm_add_ps(b, _mm_mul_ps(intensity, SPLAT(gSP.lights[i].b)));
+    }
+
+    r = _mm_min_ps(r, SPLAT(1.0f));
+    g = _mm_min_ps(g, SPLAT(1.0f));
+    b = _mm_min_ps(b, SPLAT(1.0f));
+    STORE4(vtx, r, r, g, b, a);
+}
+
+static void gSPProcessVertex4SSE(u32 v)
+{
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    __m128 x, y, z, w;
+
+    if (gSP.changed & CHANGED_MATRIX)
+        gSPCombineMatrices();
+
+    float (*mtx)[4] = gSP.matrix.combined;
+    LOAD4(vtx, x, x, y, z, w);
+    // summed in the same order as the scalar code, so that the results are the same
+    __m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, SPLAT(mtx[0][0])), _mm_mul_ps(y, SPLAT(mtx[1][0]))),
+            _mm_mul_ps(z, SPLAT(mtx[2][0]))), SPLAT(mtx[3][0]));
+    __m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, SPLAT(mtx[0][1])), _mm_mul_ps(y, SPLAT(mtx[1][1]))),
+            _mm_mul_ps(z, SPLAT(mtx[2][1]))), SPLAT(mtx[3][1]));
+    __m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, SPLAT(mtx[0][2])), _mm_mul_ps(y, SPLAT(mtx[1][2]))),
+            _mm_mul_ps(z, SPLAT(mtx[2][2]))), SPLAT(mtx[3][2]));
+    w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, SPLAT(mtx[0][3])), _mm_mul_ps(y, SPLAT(mtx[1][3]))),
+            _mm_mul_ps(z, SPLAT(mtx[2][3]))), SPLAT(mtx[3][3]));
+    x = tx;
+    y = ty;
+    z = tz;
+
+    if (config.screen.flipVertical)
+        y = _mm_xor_ps(y, SPLAT(-0.0f));
+
+    if (gDP.otherMode.depthSource)
+        z = _mm_mul_ps(w, SPLAT(gDP.primDepth.z));
+
+    if (gSP.matrix.billboard)
+    {
+        u32 i = 0;
+#ifdef __TRIBUFFER_OPT
+        i = OGL.triangles.indexmap[0];
+#endif
+        if (i >= v && i < v + 4)
+        {
+            // the billboard vertex is one of these four, so it changes as they are done: leave it to the scalar code
+            STORE4(vtx, x, x, y, z, w);
+            gSPBillboardVertex4(v);
+            LOAD4(vtx, x, x, y, z, w);
+        }
+        else
+        {
+            x = _mm_add_ps(x, SPLAT(OGL.triangles.vertices[i].x));
+            y = _mm_add_ps(y, SPLAT(OGL.triangles.vertices[i].y));
+            z = _mm_add_ps(z, SPLAT(OGL.triangles.vertices[i].z));
+            w = _mm_add_ps(w, SPLAT(OGL.triangles.vertices[i].w));
+        }
+    }
+
+    if (!(gSP.geometryMode & G_ZBUFFER))
+        z = _mm_xor_ps(w, SPLAT(-0.0f));
+
+    STORE4(vtx, x, x, y, z, w);
+
+    if (gSP.geometryMode & G_LIGHTING)
+    {
+        if (config.enableLighting)
+        {
+            gSPLightVertex4SSE(vtx);
+        }
+        else
+        {
+            for (int j = 0; j < 4; j++)
+                vtx[j].r = vtx[j].g = vtx[j].b = 1.0f;
+        }
+
+        if (gSP.geometryMode & G_TEXTURE_GEN)
+        {
+            __m128 nx, ny, nz, pad;
+            LOAD4(vtx, nx, nx, ny, nz, pad);
+            gSPTransformNormal4SSE(nx, ny, nz, gSP.matrix.projection);
+            STORE4(vtx, nx, nx, ny, nz, pad);
+
+            if (gSP.geometryMode & G_TEXTURE_GEN_LINEAR)
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    vtx[j].s = acosf(vtx[j].nx) * 325.94931f;
+                    vtx[j].t = acosf(vtx[j].ny) * 325.94931f;
+                }
+            }
+            else // G_TEXTURE_GEN
+            {
+                for (int j = 0; j < 4; j++)
+                {
+                    vtx[j].s = (vtx[j].nx + 1.0f) * 512.0f;
+                    vtx[j].t = (vtx[j].ny + 1.0f) * 512.0f;
+                }
+            }
+        }
+    }
+
+    if (config.enableClipping)
+    {
+        __m128 negw = _mm_xor_ps(w, SPLAT(-0.0f));
+        __m128i clip;
+        clip = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(x, w)), _mm_set1_epi32(CLIP_POSX));
+        clip = _mm_or_si128(clip, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(x, negw)), _mm_set1_epi32(CLIP_NEGX)));
+        clip = _mm_or_si128(clip, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(y, w)), _mm_set1_epi32(CLIP_POSY)));
+        clip = _mm_or_si128(clip, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(y, negw)), _mm_set1_epi32(CLIP_NEGY)));
+
+        u32 codes[4];
+        _mm_storeu_si128((__m128i *) codes, clip);
+        for (int j = 0; j < 4; j++)
+            vtx[j].clip = codes[j];
+    }
+}
+
+#ifdef VERTEX_TEST
+// Every batch is done by both gSPProcessVertex4SSE() and the code it replaces, from the same input, and the results
+// are compared; the SSE results are the ones kept. Replaying a display list trace with dlreplay gives the timings of
+// both over the trace's gSPVertex() loads.
+static void (*gSPProcessVertex4Ref)(u32 v);
+
+static struct
+{
+    u32     batches, mismatches, clipDiffs;
+    double  sseTime, refTime;
+} vertexTest;
+
+static double gSPVertexTestSeconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static bool gSPVertexTestClose(f32 a, f32 b)
+{
+    if (a != a || b != b)
+        return (a != a) && (b != b);
+    return fabsf(a - b) <= 1e-4f * max(1.0f, fabsf(b));
+}
+
+static void gSPProcessVertex4Test(u32 v)
+{
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    SPVertex in[4], out[4];
+    u32 changed = gSP.changed;
+    double t0, t1, t2;
+
+    memcpy(in, vtx, sizeof(in));
+    t0 = gSPVertexTestSeconds();
+    gSPProcessVertex4SSE(v);
+    t1 = gSPVertexTestSeconds();
+    memcpy(out, vtx, sizeof(out));
+
+    memcpy(vtx, in, sizeof(in));
+    gSP.changed = changed;
+    t2 = gSPVertexTestSeconds();
+    gSPProcessVertex4Ref(v);
+    vertexTest.refTime += gSPVertexTestSeconds() - t2;
+    vertexTest.sseTime += t1 - t0;
+    vertexTest.batches++;
+
+    for (int j = 0; j < 4; j++)
+    {
+        // x, y, z, w, nx, ny, nz, (pad), r, g, b, a, s, t
+        const f32 *sse = &out[j].x, *ref = &vtx[j].x;
+        for (int k = 0; k < 14; k++)
+        {
+            if (k != 7 && !gSPVertexTestClose(sse[k], ref[k]))
+            {
+                if (vertexTest.mismatches++ < 16)
+                    LOG(LOG_WARNING, "vertex test: vertex %i field %i is %f, expected %f\n", v + j, k, sse[k], ref[k]);
+                break;
+            }
+        }
+
+        // a vertex right on a clip plane can land on either side of it
+        if (out[j].clip != vtx[j].clip)
+            vertexTest.clipDiffs++;
+    }
+
+    memcpy(vtx, out, sizeof(out));
+}
+
+void gSPVertexTestPrint()
+{
+    if (vertexTest.batches == 0)
+        return;
+
+    LOG(LOG_MINIMAL, "vertex test: %u batches of 4, %u vertices out of tolerance, %u clip codes differing\n",
+            vertexTest.batches, vertexTest.mismatches, vertexTest.clipDiffs);
+    LOG(LOG_MINIMAL, "vertex test: SSE %.3f ms, scalar %.3f ms (%.2fx)\n", vertexTest.sseTime * 1000.0,
+            vertexTest.refTime * 1000.0, vertexTest.sseTime > 0.0 ? vertexTest.refTime / vertexTest.sseTime : 0.0);
+    memset(&vertexTest, 0, sizeof(vertexTest));
+}
+#endif
+#endif
+
+static void gSPTransformVertexSSE(float vtx[4], float mtx[4][4])
+{
+    __m128 res = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(vtx[0]), _mm_loadu_ps(mtx[0])),
+            _mm_mul_ps(_mm_set1_ps(vtx[1]), _mm_loadu_ps(mtx[1]))), _mm_mul_ps(_mm_set1_ps(vtx[2]), _mm_loadu_ps(mtx[2]))),
+            _mm_loadu_ps(mtx[3]));
+    _mm_storeu_ps(vtx, res);
+}
+
+static void gSPBillboardVertexSSE(u32 v, u32 i)
+{
+    _mm_storeu_ps(&OGL.triangles.vertices[v].x, _mm_add_ps(_mm_loadu_ps(&OGL.triangles.vertices[v].x),
+            _mm_loadu_ps(&OGL.triangles.vertices[i].x)));
+}
+
+void gSPInitSSE()
+{
+#ifdef __VEC4_OPT
+#ifdef VERTEX_TEST
+    gSPProcessVertex4Ref = gSPProcessVertex4;
+    gSPProcessVertex4 = gSPProcessVertex4Test;
+#else
+    gSPProcessVertex4 = gSPProcessVertex4SSE;
+#endif
+#endif
+    gSPTransformVertex = gSPTransformVertexSSE;
+    gSPBillboardVertex = gSPBillboardVertexSSE;
+}
+
+#pragma GCC pop_options
+#endif
@@ -5,12 +5,14 @@
 #include "m64p_types.h"
 #include "m64p_plugin.h"
 
+#include "Common.h"
 #include "gles2N64.h"
 #include "Debug.h"
 #include "OpenGL.h"
 #include "N64.h"
 #include "RSP.h"
 #include "RDP.h"
+#include "GBI.h"
 #include "VI.h"
 #include "Config.h"
 #include "Textures.h"
@@ -50,6 +52,12 @@ EXPORT m64p_error CALL PluginStartup(m64p_dynlib_handle CoreLibHandle,
         gSPInitNeon();
     }
 #endif
+
+#ifdef __SSE_OPT
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+        gSPInitSSE();
+#endif
     return M64ERR_SUCCESS;
 }
 
@@ -171,6 +179,18 @@ EXPORT void CALL ResizeVideoOutput(int Width, int Height)
 
 EXPORT void CALL RomClosed (void)
 {
+#ifdef PROFILE_GBI
+    // what was profiled since the last periodic report, so that a short run (or a dlreplay pass) isn't lost
+    LOG(LOG_MINIMAL, "GBI PROFILE DATA (ROM closed)\n");
+    LOG(LOG_MINIMAL, "=========================================================\n");
+    u32 profileTotal = GBI_ProfilePrint(stdout);
+    LOG(LOG_MINIMAL, "GBI total: %.3f ms\n", profileTotal / 1000.0f);
+    LOG(LOG_MINIMAL, "=========================================================\n");
+    GBI_ProfileReset();
+#endif
+#if defined(__SSE_OPT) && defined(VERTEX_TEST)
+    gSPVertexTestPrint();
+#endif
 }
 
 EXPORT int CALL RomOpen (void)
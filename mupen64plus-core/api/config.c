@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 #define M64P_CORE_PROTOTYPES 1
 #include "m64p_types.h"
@@ -42,8 +43,13 @@
 #define MUPEN64PLUS_CFG_NAME "mupen64plus.cfg"
 
 #define SECTION_MAGIC 0xDBDC0580
+#define VAR_MAGIC     0xDBDC0581
+
+/* number of hash buckets used to index the variables of each section */
+#define SECTION_HASH_SIZE 64
 
 typedef struct _config_var {
+  int                   magic;
   char                 *name;
   m64p_type             type;
   union {
@@ -53,12 +59,14 @@ typedef struct _config_var {
   } val;
   char                 *comment;
   struct _config_var   *next;
+  struct _config_var   *hash_next;
   } config_var;
 
 typedef struct _config_section {
   int                     magic;
   char                   *name;
   struct _config_var     *first_var;
+  struct _config_var     *hash[SECTION_HASH_SIZE];
   struct _config_section *next;
   } config_section;
 
@@ -139,6 +147,7 @@ static config_var *config_var_create(const char *ParamName, const char *ParamHel
 
     memset(var, 0, sizeof(config_var));
 
+    var->magic = VAR_MAGIC;
     var->name = strdup(ParamName);
     if (var->name == NULL)
     {
@@ -163,14 +172,28 @@ static config_var *config_var_create(const char *ParamName, const char *ParamHel
         var->comment = NULL;
 
     var->next = NULL;
+    var->hash_next = NULL;
     return var;
 }
 
+/* parameter names are case-insensitive, so the hash must be too */
+static unsigned int hash_var_name(const char *ParamName)
+{
+    unsigned int hash = 2166136261u;
+    while (*ParamName != 0)
+    {
+        hash ^= (unsigned char) tolower((unsigned char) *ParamName++);
+        hash *= 16777619u;
+    }
+
+    return hash & (SECTION_HASH_SIZE - 1);
+}
+
 static config_var *find_section_var(config_section *section, const char *ParamName)
 {
-    /* walk through the linked list of variables in the section */
+    /* walk through the hash chain of variables which could match this name */
     config_var *curr_var;
-    for (curr_var = section->first_var; curr_var != NULL; curr_var = curr_var->next)
+    for (curr_var = section->hash[hash_var_name(ParamName)]; curr_var != NULL; curr_var = curr_var->hash_next)
     {
         if (osal_insensitive_strcmp(ParamName, curr_var->name) == 0)
             return curr_var;
@@ -180,6 +203,13 @@ static config_var *find_section_var(config_section *section, const char *ParamNa
     return NULL;
 }
 
+static void hash_var_in_section(config_section *section, config_var *var)
+{
+    unsigned int bucket = hash_var_name(var->name);
+    var->hash_next = section->hash[bucket];
+    section->hash[bucket] = var;
+}
+
 static void append_var_to_section(config_section *section, config_var *var)
 {
     config_var *last_var;
@@ -187,6 +217,8 @@ static void append_var_to_section(config_section *section, config_var *var)
     if (section == NULL || var == NULL || section->magic != SECTION_MAGIC)
         return;
 
+    hash_var_in_section(section, var);
+
     if (section->first_var == NULL)
     {
         section->first_var = var;
@@ -202,6 +234,7 @@ static void append_var_to_section(config_section *section, config_var *var)
 
 static void delete_var(config_var *var)
 {
+    var->magic = 0;
     if (var->type == M64TYPE_STRING)
         free(var->val.string);
     free(var->name);
@@ -224,6 +257,7 @@ static void delete_section(config_section *pSection)
         curr_var = next_var;
     }
 
+    pSection->magic = 0;
     free(pSection->name);
     free(pSection);
 }
@@ -262,6 +296,7 @@ static config_section *config_section_create(const char *ParamName)
         return NULL;
     }
     sec->first_var = NULL;
+    memset(sec->hash, 0, sizeof(sec->hash));
     sec->next = NULL;
     return sec;
 }
@@ -326,6 +361,7 @@ static config_section * section_deepcopy(config_section *orig_section)
         else
             last_new_var->next = new_var;
         last_new_var = new_var;
+        hash_var_in_section(new_section, new_var);
         /* advance variable pointer in original section variable list */
         orig_var = orig_var->next;
     }
@@ -414,6 +450,96 @@ static m64p_error write_configlist_file(void)
     return M64ERR_SUCCESS;
 }
 
+static int get_var_int(const config_var *var, const char *caller)
+{
+    /* translate the actual variable type to the requested one */
+    switch(var->type)
+    {
+        case M64TYPE_INT:
+            return var->val.integer;
+        case M64TYPE_FLOAT:
+            return (int) var->val.number;
+        case M64TYPE_BOOL:
+            return (var->val.integer != 0);
+        case M64TYPE_STRING:
+            return atoi(var->val.string);
+        default:
+            DebugMessage(M64MSG_ERROR, "%s(): invalid internal parameter type for '%s'", caller, var->name);
+            return 0;
+    }
+
+    return 0;
+}
+
+static float get_var_float(const config_var *var, const char *caller)
+{
+    /* translate the actual variable type to the requested one */
+    switch(var->type)
+    {
+        case M64TYPE_INT:
+            return (float) var->val.integer;
+        case M64TYPE_FLOAT:
+            return var->val.number;
+        case M64TYPE_BOOL:
+            return (var->val.integer != 0) ? 1.0f : 0.0f;
+        case M64TYPE_STRING:
+            return (float) atof(var->val.string);
+        default:
+            DebugMessage(M64MSG_ERROR, "%s(): invalid internal parameter type for '%s'", caller, var->name);
+            return 0.0;
+    }
+
+    return 0.0;
+}
+
+static int get_var_bool(const config_var *var, const char *caller)
+{
+    /* translate the actual variable type to the requested one */
+    switch(var->type)
+    {
+        case M64TYPE_INT:
+            return (var->val.integer != 0);
+        case M64TYPE_FLOAT:
+            return (var->val.number != 0.0);
+        case M64TYPE_BOOL:
+            return var->val.integer;
+        case M64TYPE_STRING:
+            return (osal_insensitive_strcmp(var->val.string, "true") == 0);
+        default:
+            DebugMessage(M64MSG_ERROR, "%s(): invalid internal parameter type for '%s'", caller, var->name);
+            return 0;
+    }
+
+    return 0;
+}
+
+static const char *get_var_string(const config_var *var, const char *caller)
+{
+    static char outstr[64];  /* warning: not thread safe */
+
+    /* translate the actual variable type to the requested one */
+    switch(var->type)
+    {
+        case M64TYPE_INT:
+            snprintf(outstr, 63, "%i", var->val.integer);
+            outstr[63] = 0;
+            return outstr;
+        case M64TYPE_FLOAT:
+            snprintf(outstr, 63, "%f", var->val.number);
+            outstr[63] = 0;
+            return outstr;
+        case M64TYPE_BOOL:
+            return (var->val.integer ? "True" : "False");
+        case M64TYPE_STRING:
+            return var->val.string;
+        default:
+            DebugMessage(M64MSG_ERROR, "%s(): invalid internal parameter type for '%s'", caller, var->name);
+            return "";
+    }
+
+    return "";
+}
+
 /* ----------------------------------------------------------- */
 /* these functions are only to be used within the Core library */
 /* ----------------------------------------------------------- */
@@ -1227,23 +1353,7 @@ EXPORT int CALL ConfigGetParamInt(m64p_handle ConfigSectionHandle, const char *P
         return 0;
     }
 
-    /* translate the actual variable type to an int */
-    switch(var->type)
-    {
-        case M64TYPE_INT:
-            return var->val.integer;
-        case M64TYPE_FLOAT:
-            return (int) var->val.number;
-        case M64TYPE_BOOL:
-            return (var->val.integer != 0);
-        case M64TYPE_STRING:
-            return atoi(var->val.string);
-        default:
-            DebugMessage(M64MSG_ERROR, "ConfigGetParamInt(): invalid internal parameter type for '%s'", ParamName);
-            return 0;
-    }
-
-    return 0;
+    return get_var_int(var, "ConfigGetParamInt");
 }
 
 EXPORT float CALL ConfigGetParamFloat(m64p_handle ConfigSectionHandle, const char *ParamName)
@@ -1273,23 +1383,7 @@ EXPORT float CALL ConfigGetParamFloat(m64p_handle ConfigSectionHandle, const cha
         return 0.0;
     }
 
-    /* translate the actual variable type to an int */
-    switch(var->type)
-    {
-        case M64TYPE_INT:
-            return (float) var->val.integer;
-        case M64TYPE_FLOAT:
-            return var->val.number;
-        case M64TYPE_BOOL:
-            return (var->val.integer != 0) ? 1.0f : 0.0f;
-        case M64TYPE_STRING:
-            return (float) atof(var->val.string);
-        default:
-            DebugMessage(M64MSG_ERROR, "ConfigGetParamFloat(): invalid internal parameter type for '%s'", ParamName);
-            return 0.0;
-    }
-
-    return 0.0;
+    return get_var_float(var, "ConfigGetParamFloat");
 }
 
 EXPORT int CALL ConfigGetParamBool(m64p_handle ConfigSectionHandle, const char *ParamName)
@@ -1319,28 +1413,11 @@ EXPORT int CALL ConfigGetParamBool(m64p_handle ConfigSectionHandle, const char *
         return 0;
     }
 
-    /* translate the actual variable type to an int */
-    switch(var->type)
-    {
-        case M64TYPE_INT:
-            return (var->val.integer != 0);
-        case M64TYPE_FLOAT:
-            return (var->val.number != 0.0);
-        case M64TYPE_BOOL:
-            return var->val.integer;
-        case M64TYPE_STRING:
-            return (osal_insensitive_strcmp(var->val.string, "true") == 0);
-        default:
-            DebugMessage(M64MSG_ERROR, "ConfigGetParamBool(): invalid internal parameter type for '%s'", ParamName);
-            return 0;
-    }
-
-    return 0;
+    return get_var_bool(var, "ConfigGetParamBool");
 }
 
 EXPORT const char * CALL ConfigGetParamString(m64p_handle ConfigSectionHandle, const char *ParamName)
 {
-    static char outstr[64];  /* warning: not thread safe */
     config_section *section;
     config_var *var;
 
@@ -1366,27 +1443,77 @@ EXPORT const char * CALL ConfigGetParamString(m64p_handle ConfigSectionHandle, c
         return "";
     }
 
-    /* translate the actual variable type to an int */
-    switch(var->type)
+    return get_var_string(var, "ConfigGetParamString");
+}
+
+/* ------------------------------------------------------- */
+/* Parameter handle functions, exported outside of the Core */
+/* ------------------------------------------------------- */
+
+EXPORT m64p_error CALL ConfigGetParamHandle(m64p_handle ConfigSectionHandle, const char *ParamName, m64p_param_handle *ParamHandle)
+{
+    config_section *section;
+    config_var *var;
+
+    /* check input conditions */
+    if (!l_ConfigInit)
+        return M64ERR_NOT_INIT;
+    if (ConfigSectionHandle == NULL || ParamName == NULL || ParamHandle == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    section = (config_section *) ConfigSectionHandle;
+    if (section->magic != SECTION_MAGIC)
+        return M64ERR_INPUT_INVALID;
+
+    /* if this parameter doesn't already exist, return an error */
+    var = find_section_var(section, ParamName);
+    if (var == NULL)
+        return M64ERR_INPUT_NOT_FOUND;
+
+    *ParamHandle = (m64p_param_handle) var;
+    return M64ERR_SUCCESS;
+}
+
+static config_var *get_handle_var(m64p_param_handle ParamHandle, const char *caller)
+{
+    config_var *var = (config_var *) ParamHandle;
+
+    if (!l_ConfigInit || var == NULL)
     {
-        case M64TYPE_INT:
-            snprintf(outstr, 63, "%i", var->val.integer);
-            outstr[63] = 0;
-            return outstr;
-        case M64TYPE_FLOAT:
-            snprintf(outstr, 63, "%f", var->val.number);
-            outstr[63] = 0;
-            return outstr;
-        case M64TYPE_BOOL:
-            return (var->val.integer ? "True" : "False");
-        case M64TYPE_STRING:
-            return var->val.string;
-        default:
-            DebugMessage(M64MSG_ERROR, "ConfigGetParamString(): invalid internal parameter type for '%s'", ParamName);
-            return "";
+        DebugMessage(M64MSG_ERROR, "%s(): Input assertion!", caller);
+        return NULL;
+    }
+    if (var->magic != VAR_MAGIC)
+    {
+        DebugMessage(M64MSG_ERROR, "%s(): ParamHandle invalid!", caller);
+        return NULL;
     }
 
-  return "";
+    return var;
+}
+
+EXPORT int CALL ConfigGetHandleInt(m64p_param_handle ParamHandle)
+{
+    config_var *var = get_handle_var(ParamHandle, "ConfigGetHandleInt");
+    return (var != NULL) ? get_var_int(var, "ConfigGetHandleInt") : 0;
+}
+
+EXPORT float CALL ConfigGetHandleFloat(m64p_param_handle ParamHandle)
+{
+    config_var *var = get_handle_var(ParamHandle, "ConfigGetHandleFloat");
+    return (var != NULL) ? get_var_float(var, "ConfigGetHandleFloat") : 0.0f;
+}
+
+EXPORT int CALL ConfigGetHandleBool(m64p_param_handle ParamHandle)
+{
+    config_var *var = get_handle_var(ParamHandle, "ConfigGetHandleBool");
+    return (var != NULL) ? get_var_bool(var, "ConfigGetHandleBool") : 0;
+}
+
+EXPORT const char * CALL ConfigGetHandleString(m64p_param_handle ParamHandle)
+{
+    config_var *var = get_handle_var(ParamHandle, "ConfigGetHandleString");
+    return (var != NULL) ? get_var_string(var, "ConfigGetHandleString") : "";
 }
 
 /* ------------------------------------------------------ */
@@ -47,6 +47,10 @@
 #include "main/workqueue.h"
 #include "osd/screenshot.h"
 #include "plugin/plugin.h"
+#include "r4300/r4300.h"
+#if defined(NEW_DYNAREC) && defined(PROFILE_R4300)
+#include "r4300/new_dynarec/new_dynarec.h"
+#endif
 
 /* some local state variables */
 static int l_CoreInit = 0;
@@ -76,7 +80,7 @@ EXPORT m64p_error CALL CoreStartup(int APIVersion, const char *ConfigPath, const
     plugin_connect(M64PLUGIN_GFX, NULL);
     plugin_connect(M64PLUGIN_AUDIO, NULL);
     plugin_connect(M64PLUGIN_INPUT, NULL);
-    plugin_connect(M64PLUGIN_CORE, NULL);
+    plugin_connect(M64PLUGIN_RSP, NULL);
 
     savestates_init();
 
@@ -267,6 +271,9 @@ EXPORT m64p_error CALL CoreDoCommand(m64p_command Command, int ParamInt, void *P
         case M64CMD_SET_FRAME_CALLBACK:
             g_FrameCallback = (m64p_frame_callback) ParamPtr;
             return M64ERR_SUCCESS;
+        case M64CMD_SET_VI_CALLBACK:
+            g_ViCallback = (m64p_frame_callback) ParamPtr;
+            return M64ERR_SUCCESS;
         case M64CMD_TAKE_NEXT_SCREENSHOT:
             if (!g_EmulatorRunning)
                 return M64ERR_INVALID_STATE;
@@ -291,6 +298,15 @@ EXPORT m64p_error CALL CoreDoCommand(m64p_command Command, int ParamInt, void *P
                 return M64ERR_INVALID_STATE;
             main_advance_one();
             return M64ERR_SUCCESS;
+        case M64CMD_PROFILE_REPORT:
+#if defined(NEW_DYNAREC) && defined(PROFILE_R4300)
+            if (!g_EmulatorRunning || r4300emu != CORE_DYNAREC)
+                return M64ERR_INVALID_STATE;
+            new_dynarec_profile_report((const char *) ParamPtr);
+            return M64ERR_SUCCESS;
+#else
+            return M64ERR_UNSUPPORTED;
+#endif
         default:
             return M64ERR_INPUT_INVALID;
     }
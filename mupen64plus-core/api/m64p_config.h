@@ -188,6 +188,36 @@ EXPORT int          CALL ConfigGetParamBool(m64p_handle, const char *);
 EXPORT const char * CALL ConfigGetParamString(m64p_handle, const char *);
 #endif
 
+/* ConfigGetParamHandle()
+ *
+ * This function looks up one of the emulator's parameters in the given section
+ * and returns a handle to it. The handle may then be passed to the
+ * ConfigGetHandle***() functions to read the parameter without searching for
+ * it by name again. A parameter handle remains valid for as long as the section
+ * handle it was obtained from.
+ */
+typedef m64p_error (*ptr_ConfigGetParamHandle)(m64p_handle, const char *, m64p_param_handle *);
+#if defined(M64P_CORE_PROTOTYPES)
+EXPORT m64p_error CALL ConfigGetParamHandle(m64p_handle, const char *, m64p_param_handle *);
+#endif
+
+/* ConfigGetHandle***()
+ *
+ * These functions retrieve the value of a parameter through a handle given by
+ * ConfigGetParamHandle(), converting it to the requested type in the same way
+ * as the ConfigGetParam***() functions.
+ */
+typedef int          (*ptr_ConfigGetHandleInt)(m64p_param_handle);
+typedef float        (*ptr_ConfigGetHandleFloat)(m64p_param_handle);
+typedef int          (*ptr_ConfigGetHandleBool)(m64p_param_handle);
+typedef const char * (*ptr_ConfigGetHandleString)(m64p_param_handle);
+#if defined(M64P_CORE_PROTOTYPES)
+EXPORT int          CALL ConfigGetHandleInt(m64p_param_handle);
+EXPORT float        CALL ConfigGetHandleFloat(m64p_param_handle);
+EXPORT int          CALL ConfigGetHandleBool(m64p_param_handle);
+EXPORT const char * CALL ConfigGetHandleString(m64p_param_handle);
+#endif
+
 /* ConfigGetSharedDataFilepath()
  *
  * This function is provided to allow a plugin to retrieve a full pathname to a
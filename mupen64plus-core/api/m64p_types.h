@@ -50,6 +50,7 @@
 /* ----------------------------------------- */
 
 typedef void * m64p_handle;
+typedef void * m64p_param_handle;
 
 typedef void (*m64p_frame_callback)(unsigned int FrameIndex);
 typedef void (*m64p_input_callback)(void);
@@ -131,7 +132,17 @@ typedef enum {
   M64CORE_AUDIO_MUTE,
   M64CORE_INPUT_GAMESHARK,
   M64CORE_STATE_LOADCOMPLETE,
-  M64CORE_STATE_SAVECOMPLETE
+  M64CORE_STATE_SAVECOMPLETE,
+  M64CORE_FRAME_TIME_MIN,
+  M64CORE_FRAME_TIME_AVG,
+  M64CORE_FRAME_TIME_P99,
+  M64CORE_EMU_BUSY_TIME,
+  M64CORE_ROM_DMA_TIME_AVG,
+  M64CORE_ROM_DMA_TIME_MAX,
+  M64CORE_ROM_CHUNK_MISSES,
+  M64CORE_RUNAHEAD_FRAMES,
+  M64CORE_RUNAHEAD_SAVE_TIME,
+  M64CORE_RUNAHEAD_LOAD_TIME
 } m64p_core_param;
 
 typedef enum {
@@ -155,7 +166,9 @@ typedef enum {
   M64CMD_CORE_STATE_SET,
   M64CMD_READ_SCREEN,
   M64CMD_RESET,
-  M64CMD_ADVANCE_FRAME
+  M64CMD_ADVANCE_FRAME,
+  M64CMD_PROFILE_REPORT,
+  M64CMD_SET_VI_CALLBACK
 } m64p_command;
 
 typedef struct {
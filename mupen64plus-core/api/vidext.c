@@ -93,6 +93,18 @@ int VidExt_VideoRunning(void)
     return l_VideoOutputActive;
 }
 
+/* hands the GL context to the calling thread (bCurrent = 1) or takes it from it, for the video thread */
+void VidExt_GL_MakeCurrent(int bCurrent)
+{
+#ifdef __QNXNTO__
+    if (bCurrent)
+        PB_eglMakeCurrent();
+    else
+        PB_eglReleaseCurrent();
+#endif
+    /* with SDL the context belongs to the thread which set the video mode, which is the video thread when there is one */
+}
+
 /* video extension functions to be called by the video plugin */
 EXPORT m64p_error CALL VidExt_Init(void)
 {
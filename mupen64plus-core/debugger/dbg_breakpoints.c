@@ -19,6 +19,9 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <SDL.h>
 #include <SDL_thread.h>
 
@@ -33,6 +36,128 @@
 int g_NumBreakpoints=0;
 breakpoint g_Breakpoints[BREAKPOINTS_MAX_NUMBER];
 
+// Lookup index over the enabled exec/read/write breakpoints, rebuilt on the
+// next lookup after g_Breakpoints changes. A bitmap with one bit per 4KB page
+// rejects most addresses outright; the rest go to the ranges sorted by start
+// address, where maxend (the largest end of that range and all before it)
+// stops the backwards walk as soon as no earlier range can overlap.
+#define BPT_KINDS 3
+
+typedef struct {
+    uint32 start;
+    uint32 end;
+    uint32 maxend;
+    int bpt;
+} bpt_range;
+
+static uint32 bpt_pages[BPT_KINDS][0x100000 / 32];
+static bpt_range bpt_ranges[BPT_KINDS][BREAKPOINTS_MAX_NUMBER * 2];
+static int bpt_num_ranges[BPT_KINDS];
+static volatile int bpt_index_dirty = 1;
+
+static const uint32 bpt_kind_flags[BPT_KINDS] = {
+    BPT_FLAG_ENABLED | BPT_FLAG_EXEC,
+    BPT_FLAG_ENABLED | BPT_FLAG_READ,
+    BPT_FLAG_ENABLED | BPT_FLAG_WRITE
+};
+
+static void index_range(int kind, int bpt, uint32 start, uint32 end)
+{
+    bpt_range *range = &bpt_ranges[kind][bpt_num_ranges[kind]++];
+    uint32 page;
+
+    range->start = start;
+    range->end = end;
+    range->bpt = bpt;
+
+    for (page = start >> 12; page <= (end >> 12); page++)
+        bpt_pages[kind][page >> 5] |= 1u << (page & 31);
+}
+
+static int compare_ranges(const void *a, const void *b)
+{
+    const bpt_range *ra = (const bpt_range *) a;
+    const bpt_range *rb = (const bpt_range *) b;
+
+    if (ra->start != rb->start)
+        return ra->start < rb->start ? -1 : 1;
+    return ra->bpt - rb->bpt;
+}
+
+static void rebuild_breakpoint_index(void)
+{
+    int kind, i;
+
+    bpt_index_dirty = 0;
+    memset(bpt_pages, 0, sizeof(bpt_pages));
+
+    for (kind = 0; kind < BPT_KINDS; kind++)
+    {
+        uint32 maxend = 0;
+
+        bpt_num_ranges[kind] = 0;
+        for (i = 0; i < g_NumBreakpoints; i++)
+        {
+            if ((g_Breakpoints[i].flags & bpt_kind_flags[kind]) != bpt_kind_flags[kind])
+                continue;
+            if (g_Breakpoints[i].endaddr < g_Breakpoints[i].address)
+            {
+                // wraps around the top of the address space
+                index_range(kind, i, g_Breakpoints[i].address, 0xFFFFFFFF);
+                index_range(kind, i, 0, g_Breakpoints[i].endaddr);
+            }
+            else
+                index_range(kind, i, g_Breakpoints[i].address, g_Breakpoints[i].endaddr);
+        }
+
+        qsort(bpt_ranges[kind], bpt_num_ranges[kind], sizeof(bpt_range), compare_ranges);
+        for (i = 0; i < bpt_num_ranges[kind]; i++)
+        {
+            if (bpt_ranges[kind][i].end > maxend)
+                maxend = bpt_ranges[kind][i].end;
+            bpt_ranges[kind][i].maxend = maxend;
+        }
+    }
+}
+
+static int lookup_indexed_breakpoint(int kind, uint32 address, uint32 endaddr)
+{
+    const bpt_range *ranges = bpt_ranges[kind];
+    uint32 page;
+    int lo = 0, hi = bpt_num_ranges[kind];
+    int i, found = -1;
+
+    // a 64KB memory table page is the widest range checked on a hot path
+    if ((endaddr >> 12) - (address >> 12) < 16)
+    {
+        for (page = address >> 12; page <= (endaddr >> 12); page++)
+            if (bpt_pages[kind][page >> 5] & (1u << (page & 31)))
+                break;
+        if (page > (endaddr >> 12))
+            return -1;
+    }
+
+    // find the first range starting after endaddr
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (ranges[mid].start <= endaddr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // every range before it starts at or below endaddr, so it overlaps
+    // exactly when it ends at or above address
+    for (i = lo - 1; i >= 0 && ranges[i].maxend >= address; i--)
+    {
+        if (ranges[i].end >= address && (found == -1 || ranges[i].bpt < found))
+            found = ranges[i].bpt;
+    }
+
+    return found;
+}
+
 
 int add_breakpoint( uint32 address )
 {
@@ -46,6 +171,7 @@ int add_breakpoint( uint32 address )
 
     enable_breakpoint(g_NumBreakpoints);
 
+    bpt_index_dirty = 1;
     return g_NumBreakpoints++;
 }
 
@@ -63,7 +189,8 @@ int add_breakpoint_struct(breakpoint* newbp)
         BPT_CLEAR_FLAG(g_Breakpoints[g_NumBreakpoints], BPT_FLAG_ENABLED);
         enable_breakpoint( g_NumBreakpoints );
     }
-    
+
+    bpt_index_dirty = 1;
     return g_NumBreakpoints++;
 }
 
@@ -85,6 +212,7 @@ void enable_breakpoint( int bpt)
     }
     
     BPT_SET_FLAG(g_Breakpoints[bpt], BPT_FLAG_ENABLED);
+    bpt_index_dirty = 1;
 }
 
 void disable_breakpoint( int bpt )
@@ -93,6 +221,7 @@ void disable_breakpoint( int bpt )
     uint64 bptAddr;
 
     BPT_CLEAR_FLAG(g_Breakpoints[bpt], BPT_FLAG_ENABLED);
+    bpt_index_dirty = 1;
 
     if(BPT_CHECK_FLAG((*curBpt), BPT_FLAG_READ)) {
         for(bptAddr = curBpt->address; bptAddr <= ((unsigned long)(curBpt->endaddr | 0xFFFF)); bptAddr+=0x10000)
@@ -120,6 +249,7 @@ void remove_breakpoint_by_num( int bpt )
         g_Breakpoints[curBpt-1]=g_Breakpoints[curBpt];
     
     g_NumBreakpoints--;
+    bpt_index_dirty = 1;
 }
 
 void remove_breakpoint_by_address( uint32 address )
@@ -140,6 +270,7 @@ void replace_breakpoint_num( int bpt, breakpoint* copyofnew )
         disable_breakpoint( bpt );
 
     memcpy(&(g_Breakpoints[bpt]), copyofnew, sizeof(breakpoint));
+    bpt_index_dirty = 1;
 
     if(BPT_CHECK_FLAG(g_Breakpoints[bpt], BPT_FLAG_ENABLED))
     {
@@ -152,7 +283,19 @@ int lookup_breakpoint( uint32 address, uint32 size, uint32 flags)
 {
     int i;
     uint64 endaddr = ((uint64)address) + ((uint64)size) - 1;
-    
+
+    for (i = 0; i < BPT_KINDS; i++)
+    {
+        if (flags == bpt_kind_flags[i])
+        {
+            if (bpt_index_dirty)
+                rebuild_breakpoint_index();
+            if (endaddr > 0xFFFFFFFF)
+                endaddr = 0xFFFFFFFF;
+            return lookup_indexed_breakpoint(i, address, (uint32) endaddr);
+        }
+    }
+
     for( i=0; i < g_NumBreakpoints; i++)
     {
         if((g_Breakpoints[i].flags & flags) == flags)
@@ -176,7 +319,10 @@ int lookup_breakpoint( uint32 address, uint32 size, uint32 flags)
 
 int check_breakpoints( uint32 address )
 {
-    return lookup_breakpoint( address, 1, BPT_FLAG_ENABLED | BPT_FLAG_EXEC );
+    // called for every instruction, so skip straight to the exec index
+    if (bpt_index_dirty)
+        rebuild_breakpoint_index();
+    return lookup_indexed_breakpoint(0, address, address);
 }
 
 
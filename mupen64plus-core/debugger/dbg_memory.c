@@ -32,6 +32,7 @@
 #include "r4300/r4300.h"
 #include "r4300/ops.h"
 #include "main/rom.h"
+#include "main/romchunks.h"
  
 /* Following are the breakpoint functions for memory access calls.  See debugger/memory.h
  * These macros generate the memory breakpoint function calls.*/
@@ -321,8 +322,8 @@ uint32 read_memory_32(uint32 addr){
   switch(get_memory_type(addr))
     {
     case M64P_MEM_NOMEM:
-      if(tlb_LUT_r[addr>>12])
-        return read_memory_32((tlb_LUT_r[addr>>12]&0xFFFFF000)|(addr&0xFFF));
+      if(tlb_lookup(addr>>12, 0))
+        return read_memory_32((tlb_lookup(addr>>12, 0)&0xFFFFF000)|(addr&0xFFF));
       return M64P_MEM_INVALID;
     case M64P_MEM_RDRAM:
       return *((uint32 *)(rdramb + (addr & 0xFFFFFF)));
@@ -334,7 +335,7 @@ uint32 read_memory_32(uint32 addr){
       else
         return M64P_MEM_INVALID;
     case M64P_MEM_ROM:
-      return *((uint32 *)(rom + (addr & 0x03FFFFFF)));
+      return *((uint32 *)rom_at(addr & 0x03FFFFFF));
     case M64P_MEM_RDRAMREG:
       if (addrlow < 0x28)
         return *(readrdramreg[addrlow&0xfffc]);
@@ -455,7 +456,7 @@ uint32 get_memory_flags(uint32 addr)
   switch(type)
   {
     case M64P_MEM_NOMEM:
-      if(tlb_LUT_r[addr>>12])
+      if(tlb_lookup(addr>>12, 0))
         flags = M64P_MEM_FLAG_READABLE | M64P_MEM_FLAG_WRITABLE_EMUONLY;
       break;
     case M64P_MEM_NOTHING:
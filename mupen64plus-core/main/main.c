@@ -43,8 +43,12 @@
 
 #include "main.h"
 #include "eventloop.h"
+#include "movie.h"
 #include "rom.h"
+#include "romchunks.h"
+#include "runahead.h"
 #include "savestates.h"
+#include "ticks.h"
 #include "util.h"
 
 #include "memory/memory.h"
@@ -53,6 +57,8 @@
 #include "osd/osd.h"
 #include "osd/screenshot.h"
 #include "plugin/plugin.h"
+#include "plugin/dlist_capture.h"
+#include "plugin/video_thread.h"
 #include "r4300/r4300.h"
 #include "r4300/interupt.h"
 #include "r4300/reset.h"
@@ -73,16 +79,30 @@
 m64p_handle g_CoreConfig = NULL;
 
 m64p_frame_callback g_FrameCallback = NULL;
+m64p_frame_callback g_ViCallback = NULL;
 
 int         g_MemHasBeenBSwapped = 0;   // store byte-swapped flag so we don't swap twice when re-playing game
 int         g_EmulatorRunning = 0;      // need separate boolean to tell if emulator is running, since --nogui doesn't use a thread
 
 /** static (local) variables **/
 static int   l_CurrentFrame = 0;         // frame counter
+static unsigned int l_CurrentVI = 0;     // vertical interrupt counter, for g_ViCallback
 static int   l_TakeScreenshot = 0;       // Tell OSD Rendering callback to take a screenshot just before drawing the OSD
 static int   l_SpeedFactor = 100;        // percentage of nominal game speed at which emulator is running
 static int   l_FrameAdvance = 0;         // variable to check if we pause on next frame
 static int   l_MainSpeedLimit = 1;       // insert delay during vi_interrupt to keep speed at real-time
+static m64p_param_handle l_OSDParam = NULL; // "OnScreenDisplay" parameter, checked by the per-frame render callback
+
+/* frame pacer state and frame-time statistics, see new_vi() */
+#define FRAME_STATS_WINDOW  128         // number of frames over which the statistics are computed
+#define PACER_SPIN_NS       1500000ULL  // final part of the wait which is spent yielding instead of sleeping
+#define PACER_MAX_LAG       4           // frames of lag after which the pacer drops the schedule
+static unsigned long long l_PacerDeadline = 0;  // monotonic time at which the current frame should end
+static unsigned long long l_LastFrameEnd = 0;   // monotonic time at which the previous new_vi() returned
+static unsigned int l_FrameTimes[FRAME_STATS_WINDOW];  // microseconds between consecutive frames
+static unsigned int l_BusyTimes[FRAME_STATS_WINDOW];   // microseconds spent emulating in each frame
+static int l_FrameStatsCount = 0;
+static int l_FrameStatsPos = 0;
 
 static osd_message_t *l_msgVol = NULL;
 static osd_message_t *l_msgFF = NULL;
@@ -196,6 +216,14 @@ int main_set_core_defaults(void)
     ConfigSetDefaultString(g_CoreConfig, "SharedDataPath", "", "Path to a directory to search when looking for shared data files");
     ConfigSetDefaultBool(g_CoreConfig, "DelaySI", 1, "Delay interrupt after DMA SI read/write");
     ConfigSetDefaultInt(g_CoreConfig, "CountPerOp", 0, "Force number of cycles per emulated instruction");
+    ConfigSetDefaultString(g_CoreConfig, "DListCapture", "", "File to record the display lists sent to the video plugin in, for replaying them without the game. If this is blank, nothing is recorded");
+    ConfigSetDefaultBool(g_CoreConfig, "VideoThread", 0, "Run the video plugin on a thread of its own, so that emulation doesn't wait for each display list to be drawn. Takes effect when the video plugin is attached");
+    ConfigSetDefaultInt(g_CoreConfig, "RomCacheSize", 8, "Memory in MB for the decompressed parts of a chunked compressed ROM (.n64c)");
+    ConfigSetDefaultBool(g_CoreConfig, "RomReadAhead", 1, "Decompress the next part of a chunked compressed ROM on a second thread while a game streams data from it");
+    ConfigSetDefaultInt(g_CoreConfig, "RunAhead", 0, "Frames (0-4) to emulate ahead of the shown one and roll back each frame, to cut input latency. Each frame costs that many more frames of emulation");
+    ConfigSetDefaultString(g_CoreConfig, "MovieRecord", "", "File to record the controller input of the game in, for playing it back with MoviePlay. If this is blank, nothing is recorded");
+    ConfigSetDefaultString(g_CoreConfig, "MoviePlay", "", "Input movie to play back instead of reading the controllers; emulation stops at its end. Takes precedence over MovieRecord");
+    ConfigSetDefaultString(g_CoreConfig, "MovieStartState", "", "Savestate to start a recorded input movie from, which is kept in the movie. If this is blank, the movie starts at power-on");
 
     /* handle upgrades */
     if (bUpgrade)
@@ -407,6 +435,55 @@ void main_state_save(int format, const char *filename)
         savestates_set_job(savestates_job_save, (savestates_type)format, filename);
 }
 
+static int compare_uint(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *) a, y = *(const unsigned int *) b;
+    return (x > y) - (x < y);
+}
+
+static m64p_error frame_stats_query(m64p_core_param param, int *rval)
+{
+    unsigned int sorted[FRAME_STATS_WINDOW];
+    unsigned long long sum = 0;
+    int i, count = l_FrameStatsCount;
+
+    if (count == 0)
+    {
+        *rval = 0;
+        return M64ERR_SUCCESS;
+    }
+
+    if (param == M64CORE_EMU_BUSY_TIME)
+    {
+        for (i = 0; i < count; i++)
+            sum += l_BusyTimes[i];
+        *rval = (int) (sum / count);
+        return M64ERR_SUCCESS;
+    }
+
+    memcpy(sorted, l_FrameTimes, count * sizeof(unsigned int));
+    qsort(sorted, count, sizeof(unsigned int), compare_uint);
+    for (i = 0; i < count; i++)
+        sum += sorted[i];
+
+    switch (param)
+    {
+        case M64CORE_FRAME_TIME_MIN:
+            *rval = (int) sorted[0];
+            break;
+        case M64CORE_FRAME_TIME_AVG:
+            *rval = (int) (sum / count);
+            break;
+        case M64CORE_FRAME_TIME_P99:
+            *rval = (int) sorted[(count * 99 - 1) / 100];
+            break;
+        default:
+            return M64ERR_INPUT_INVALID;
+    }
+
+    return M64ERR_SUCCESS;
+}
+
 m64p_error main_core_state_query(m64p_core_param param, int *rval)
 {
     switch (param)
@@ -457,6 +534,27 @@ m64p_error main_core_state_query(m64p_core_param param, int *rval)
         case M64CORE_INPUT_GAMESHARK:
             *rval = event_gameshark_active();
             break;
+        case M64CORE_FRAME_TIME_MIN:
+        case M64CORE_FRAME_TIME_AVG:
+        case M64CORE_FRAME_TIME_P99:
+        case M64CORE_EMU_BUSY_TIME:
+            if (!g_EmulatorRunning)
+                return M64ERR_INVALID_STATE;
+            return frame_stats_query(param, rval);
+        case M64CORE_ROM_DMA_TIME_AVG:
+        case M64CORE_ROM_DMA_TIME_MAX:
+        case M64CORE_ROM_CHUNK_MISSES:
+            if (rom == NULL)
+                return M64ERR_INVALID_STATE;
+            return romchunks_stats_query(param, rval);
+        case M64CORE_RUNAHEAD_FRAMES:
+            *rval = runahead_get_frames();
+            break;
+        case M64CORE_RUNAHEAD_SAVE_TIME:
+        case M64CORE_RUNAHEAD_LOAD_TIME:
+            if (!g_EmulatorRunning)
+                return M64ERR_INVALID_STATE;
+            return runahead_stats_query(param, rval);
         // these are only used for callbacks; they cannot be queried or set
         case M64CORE_STATE_LOADCOMPLETE:
         case M64CORE_STATE_SAVECOMPLETE:
@@ -552,6 +650,19 @@ m64p_error main_core_state_set(m64p_core_param param, int val)
                 return M64ERR_INVALID_STATE;
             event_set_gameshark(val);
             return M64ERR_SUCCESS;
+        case M64CORE_RUNAHEAD_FRAMES:
+            if (val < 0)
+                return M64ERR_INPUT_INVALID;
+            runahead_set_frames(val);
+            return M64ERR_SUCCESS;
+        // these are statistics; they can only be queried
+        case M64CORE_FRAME_TIME_MIN:
+        case M64CORE_FRAME_TIME_AVG:
+        case M64CORE_FRAME_TIME_P99:
+        case M64CORE_EMU_BUSY_TIME:
+        case M64CORE_RUNAHEAD_SAVE_TIME:
+        case M64CORE_RUNAHEAD_LOAD_TIME:
+            return M64ERR_INPUT_INVALID;
         // these are only used for callbacks; they cannot be queried or set
         case M64CORE_STATE_LOADCOMPLETE:
         case M64CORE_STATE_SAVECOMPLETE:
@@ -637,7 +748,7 @@ m64p_error main_reset(int do_hard_reset)
 
 static void video_plugin_render_callback(int bScreenRedrawn)
 {
-    int bOSD = ConfigGetParamBool(g_CoreConfig, "OnScreenDisplay");
+    int bOSD = ConfigGetHandleBool(l_OSDParam);
 
     // if the flag is set to take a screenshot, then grab it now
     if (l_TakeScreenshot != 0)
@@ -675,52 +786,45 @@ void new_frame(void)
 
 void new_vi(void)
 {
-    int Dif;
-    unsigned int CurrentFPSTime;
-    static unsigned int LastFPSTime = 0;
-    static unsigned int CounterTime = 0;
-    static unsigned int CalculatedTime ;
-    static int VI_Counter = 0;
+    unsigned long long FramePeriod = (unsigned long long) (1000000000.0 / ROM_PARAMS.vilimit * 100.0 / l_SpeedFactor);
+    unsigned long long Start, End;
 
-    double VILimitMilliseconds = 1000.0 / ROM_PARAMS.vilimit;
-    double AdjustedLimit = VILimitMilliseconds * 100.0 / l_SpeedFactor;  // adjust for selected emulator speed
-    int time;
+    movie_vi();
+    if (g_ViCallback != NULL)
+        (*g_ViCallback)(l_CurrentVI);
+    l_CurrentVI++;
 
     start_section(IDLE_SECTION);
-    VI_Counter++;
 
 #ifdef DBG
     if(g_DebuggerActive) DebuggerCallback(DEBUG_UI_VI, 0);
 #endif
 
-    if(LastFPSTime == 0)
+    Start = ticksGetNanoseconds();
+    if (l_LastFrameEnd == 0)
     {
-        LastFPSTime = CounterTime = SDL_GetTicks();
+        l_LastFrameEnd = l_PacerDeadline = Start;
+        end_section(IDLE_SECTION);
         return;
     }
-    CurrentFPSTime = SDL_GetTicks();
-    
-    Dif = CurrentFPSTime - LastFPSTime;
-    
-    if (Dif < AdjustedLimit) 
-    {
-        CalculatedTime = (unsigned int) (CounterTime + AdjustedLimit * VI_Counter);
-        time = (int)(CalculatedTime - CurrentFPSTime);
-        if (time > 0 && l_MainSpeedLimit)
-        {
-            DebugMessage(M64MSG_VERBOSE, "    new_vi(): Waiting %ims", time);
-            SDL_Delay(time);
-        }
-        CurrentFPSTime = CurrentFPSTime + time;
-    }
 
-    if (CurrentFPSTime - CounterTime >= 1000.0 ) 
-    {
-        CounterTime = SDL_GetTicks();
-        VI_Counter = 0 ;
-    }
-    
-    LastFPSTime = CurrentFPSTime ;
+    /* frames are scheduled on an absolute timeline so that rounding errors in the
+     * wait can't accumulate; if we fall too far behind (pause, fast-forward, slow
+     * frames) the schedule is restarted from now instead of rushing to catch up */
+    l_PacerDeadline += FramePeriod;
+    if (!l_MainSpeedLimit || Start > l_PacerDeadline + PACER_MAX_LAG * FramePeriod)
+        l_PacerDeadline = Start;
+    else if (l_PacerDeadline > Start)
+        ticksWaitUntil(l_PacerDeadline, PACER_SPIN_NS);
+
+    End = ticksGetNanoseconds();
+    l_FrameTimes[l_FrameStatsPos] = (unsigned int) ((End - l_LastFrameEnd) / 1000);
+    l_BusyTimes[l_FrameStatsPos] = (unsigned int) ((Start - l_LastFrameEnd) / 1000);
+    l_FrameStatsPos = (l_FrameStatsPos + 1) % FRAME_STATS_WINDOW;
+    if (l_FrameStatsCount < FRAME_STATS_WINDOW)
+        l_FrameStatsCount++;
+    l_LastFrameEnd = End;
+
     end_section(IDLE_SECTION);
 }
 
@@ -740,6 +844,11 @@ m64p_error main_run(void)
     count_per_op = ConfigGetParamInt(g_CoreConfig, "CountPerOp");
     if (count_per_op <= 0)
         count_per_op = ROM_PARAMS.countperop;
+    l_LastFrameEnd = 0;
+    l_CurrentVI = 0;
+    l_FrameStatsCount = l_FrameStatsPos = 0;
+    runahead_init();
+    ConfigGetParamHandle(g_CoreConfig, "OnScreenDisplay", &l_OSDParam);
 
     // initialize memory, and do byte-swapping if it's not been done yet
     if (g_MemHasBeenBSwapped == 0)
@@ -753,19 +862,27 @@ m64p_error main_run(void)
     }
 
     // Attach rom to plugins
+    video_thread_start();
     if (!gfx.romOpen())
     {
-        free_memory(); return M64ERR_PLUGIN_FAIL;
+        video_thread_stop(); free_memory(); return M64ERR_PLUGIN_FAIL;
     }
     if (!audio.romOpen())
     {
-        gfx.romClosed(); free_memory(); return M64ERR_PLUGIN_FAIL;
+        gfx.romClosed(); video_thread_stop(); free_memory(); return M64ERR_PLUGIN_FAIL;
     }
     if (!input.romOpen())
     {
-        audio.romClosed(); gfx.romClosed(); free_memory(); return M64ERR_PLUGIN_FAIL;
+        audio.romClosed(); gfx.romClosed(); video_thread_stop(); free_memory(); return M64ERR_PLUGIN_FAIL;
     }
 
+    /* record what the video plugin is given from now on, if asked to */
+    if (ConfigGetParamString(g_CoreConfig, "DListCapture")[0] != '\0')
+        dlist_capture_start(ConfigGetParamString(g_CoreConfig, "DListCapture"));
+
+    /* record or play back the controller input, if asked to */
+    movie_start();
+
     /* set up the SDL key repeat and event filter to catch keyboard/joystick commands for the core */
     event_initialize();
 
@@ -820,6 +937,10 @@ m64p_error main_run(void)
     input.romClosed();
     audio.romClosed();
     gfx.romClosed();
+    video_thread_stop();
+    dlist_capture_stop();
+    movie_stop();
+    runahead_deinit();
     free_memory();
 
     // clean up
@@ -32,6 +32,7 @@ extern int g_MemHasBeenBSwapped;
 extern int g_EmulatorRunning;
 
 extern m64p_frame_callback g_FrameCallback;
+extern m64p_frame_callback g_ViCallback;
 
 extern int delay_si;
 
@@ -0,0 +1,548 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - movie.c                                                 *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+#include "api/config.h"
+#include "api/m64p_config.h"
+
+#include "main.h"
+#include "movie.h"
+#include "rom.h"
+#include "savestates.h"
+#include "ticks.h"
+#include "util.h"
+
+#include "memory/memory.h"
+#include "plugin/plugin.h"
+#include "r4300/r4300.h"
+
+#define CHECKSUM_SLICE 0x10000      // bytes of RDRAM added to the checksum each frame
+
+enum { MOVIE_OFF, MOVIE_RECORDING, MOVIE_PLAYING };
+
+static int l_Mode = MOVIE_OFF;
+static int l_Armed = 0;             // waiting for the movie's savestate to be loaded
+static char *l_Filename = NULL;
+static char *l_StateFile = NULL;    // the savestate of a movie being played, for savestates_load()
+
+static unsigned char *l_Data = NULL;    // the whole movie, as it is in the file once unpacked
+static unsigned int l_Size, l_Capacity;
+static unsigned int l_Pos;              // playback: next event to read
+static unsigned int l_LastVI;           // recording: end of the last complete frame
+
+static unsigned int l_Frames;
+static unsigned int l_Checksum;
+static unsigned int l_LastKeys[4];
+static unsigned long long l_StartTime;
+
+static CONTROL l_SavedControls[4];
+static int l_ControlsSaved = 0;
+
+/* The checksum follows the GPRs at every frame and RDRAM a slice at a time,
+ * which is enough to catch a run going its own way without slowing it. */
+static unsigned int frame_checksum(unsigned int sum, unsigned int frame)
+{
+    const unsigned char *ram = (const unsigned char *) rdram;
+    unsigned int slice = frame % (0x800000 / CHECKSUM_SLICE);
+
+    sum = (unsigned int) adler32(sum, (const Bytef *) reg, sizeof(reg));
+    return (unsigned int) adler32(sum, ram + slice * CHECKSUM_SLICE, CHECKSUM_SLICE);
+}
+
+static void reset_timeline(void)
+{
+    l_Frames = 0;
+    l_Checksum = (unsigned int) adler32(0, Z_NULL, 0);
+    memset(l_LastKeys, 0, sizeof(l_LastKeys));
+    l_StartTime = ticksGetNanoseconds();
+}
+
+/*********************************************************************************************************
+* recording
+*/
+
+static void put_bytes(const void *data, unsigned int size)
+{
+    if (l_Size + size > l_Capacity)
+    {
+        unsigned int capacity = l_Capacity ? l_Capacity : 0x10000;
+        unsigned char *grown;
+
+        while (l_Size + size > capacity)
+            capacity *= 2;
+        grown = (unsigned char *) realloc(l_Data, capacity);
+        if (grown == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "out of memory for the input movie; recording stopped");
+            l_Mode = MOVIE_OFF;
+            return;
+        }
+        l_Data = grown;
+        l_Capacity = capacity;
+    }
+    memcpy(l_Data + l_Size, data, size);
+    l_Size += size;
+}
+
+static void put_byte(unsigned char value)
+{
+    put_bytes(&value, 1);
+}
+
+static void put_uint(unsigned int value)
+{
+    put_bytes(&value, sizeof(value));
+}
+
+static int record_start(const char *filename)
+{
+    const char *state = ConfigGetParamString(g_CoreConfig, "MovieStartState");
+    movie_header header;
+    gzFile file;
+    int i;
+
+    /* fail now rather than when the recording is over */
+    file = gzopen(filename, "wb");
+    if (file == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "couldn't open input movie '%s' for writing", filename);
+        return 0;
+    }
+    gzclose(file);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MOVIE_MAGIC, sizeof(MOVIE_MAGIC));
+    header.version = MOVIE_VERSION;
+    memcpy(header.rom_md5, ROM_SETTINGS.MD5, sizeof(header.rom_md5));
+    header.r4300emu = r4300emu;
+    header.count_per_op = count_per_op;
+    for (i = 0; i < 4; i++)
+    {
+        header.controls[i][0] = (unsigned char) Controls[i].Present;
+        header.controls[i][1] = (unsigned char) Controls[i].RawData;
+        header.controls[i][2] = (unsigned char) Controls[i].Plugin;
+    }
+    put_bytes(&header, sizeof(header));
+
+    if (state[0] != '\0')
+    {
+        FILE *f = fopen(state, "rb");
+        long size;
+        unsigned char *data;
+
+        if (f == NULL || fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) <= 0 || fseek(f, 0, SEEK_SET) != 0)
+        {
+            DebugMessage(M64MSG_ERROR, "couldn't read savestate '%s' to start the input movie from", state);
+            if (f != NULL)
+                fclose(f);
+            remove(filename);
+            return 0;
+        }
+        data = (unsigned char *) malloc(size);
+        if (data == NULL || fread(data, 1, size, f) != (size_t) size)
+        {
+            DebugMessage(M64MSG_ERROR, "couldn't read savestate '%s' to start the input movie from", state);
+            free(data);
+            fclose(f);
+            remove(filename);
+            return 0;
+        }
+        fclose(f);
+        ((movie_header *) l_Data)->state_size = (unsigned int) size;
+        put_bytes(data, (unsigned int) size);
+        free(data);
+
+        savestates_set_job(savestates_job_load, savestates_type_unknown, state);
+        l_Armed = 1;
+    }
+
+    l_Mode = MOVIE_RECORDING;
+    l_Filename = strdup(filename);
+    l_LastVI = l_Size;
+    reset_timeline();
+    DebugMessage(M64MSG_INFO, "recording input movie '%s'%s", filename, l_Armed ? " from a savestate" : "");
+    return 1;
+}
+
+static void record_finish(void)
+{
+    gzFile file;
+
+    /* the polls of the frame which was cut short are dropped */
+    l_Size = l_LastVI;
+    put_byte(MOVIE_END);
+    put_uint(l_Frames);
+    put_uint(l_Checksum);
+    if (l_Mode != MOVIE_RECORDING)
+        return;
+
+    file = gzopen(l_Filename, "wb");
+    if (file == NULL || gzwrite(file, l_Data, l_Size) != (int) l_Size)
+    {
+        DebugMessage(M64MSG_ERROR, "couldn't write input movie '%s'", l_Filename);
+        if (file != NULL)
+            gzclose(file);
+        return;
+    }
+    gzclose(file);
+    DebugMessage(M64MSG_STATUS, "recorded %u frames of input in '%s', checksum %08x", l_Frames, l_Filename, l_Checksum);
+}
+
+/*********************************************************************************************************
+* playback
+*/
+
+static int get_byte(void)
+{
+    if (l_Pos >= l_Size)
+        return -1;
+    return l_Data[l_Pos++];
+}
+
+static int get_uint(unsigned int *value)
+{
+    if (l_Size - l_Pos < sizeof(*value))
+        return 0;
+    memcpy(value, l_Data + l_Pos, sizeof(*value));
+    l_Pos += sizeof(*value);
+    return 1;
+}
+
+static void playback_end(void)
+{
+    l_Mode = MOVIE_OFF;
+    main_stop();
+}
+
+static void desync(void)
+{
+    DebugMessage(M64MSG_ERROR, "input movie '%s' desynced at frame %u: the game didn't poll the controllers as it did when it was recorded",
+                 l_Filename, l_Frames);
+    playback_end();
+}
+
+static int playback_start(const char *filename)
+{
+    movie_header *header;
+    gzFile file;
+    int i, count;
+
+    file = gzopen(filename, "rb");
+    if (file == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "couldn't open input movie '%s'", filename);
+        return 0;
+    }
+    l_Size = 0;
+    do
+    {
+        if (l_Capacity - l_Size < 0x10000)
+        {
+            unsigned char *grown = (unsigned char *) realloc(l_Data, l_Capacity + 0x40000);
+            if (grown == NULL)
+                break;
+            l_Data = grown;
+            l_Capacity += 0x40000;
+        }
+        count = gzread(file, l_Data + l_Size, l_Capacity - l_Size);
+        if (count > 0)
+            l_Size += count;
+    } while (count > 0);
+    gzclose(file);
+
+    header = (movie_header *) l_Data;
+    if (count < 0 || l_Size < sizeof(movie_header) || memcmp(header->magic, MOVIE_MAGIC, sizeof(MOVIE_MAGIC)) != 0 ||
+        header->version != MOVIE_VERSION || l_Size - sizeof(movie_header) < header->state_size)
+    {
+        DebugMessage(M64MSG_ERROR, "'%s' isn't an input movie this core can play", filename);
+        return 0;
+    }
+    if (memcmp(header->rom_md5, ROM_SETTINGS.MD5, sizeof(header->rom_md5)) != 0)
+    {
+        DebugMessage(M64MSG_ERROR, "input movie '%s' was recorded with another ROM", filename);
+        return 0;
+    }
+    if (header->r4300emu != r4300emu || header->count_per_op != count_per_op)
+        DebugMessage(M64MSG_WARNING, "input movie '%s' was recorded with other R4300Emulator or CountPerOp settings; it may desync", filename);
+
+    /* the game sees the controllers it saw when the movie was recorded */
+    memcpy(l_SavedControls, Controls, sizeof(l_SavedControls));
+    l_ControlsSaved = 1;
+    for (i = 0; i < 4; i++)
+    {
+        Controls[i].Present = header->controls[i][0];
+        Controls[i].RawData = header->controls[i][1];
+        Controls[i].Plugin = header->controls[i][2];
+    }
+
+    l_Pos = sizeof(movie_header);
+    if (header->state_size > 0)
+    {
+        l_StateFile = combinepath(ConfigGetUserCachePath(), "movie.st");
+        if (l_StateFile == NULL ||
+            write_to_file(l_StateFile, l_Data + l_Pos, header->state_size) != file_ok)
+        {
+            DebugMessage(M64MSG_ERROR, "couldn't write the savestate of input movie '%s'", filename);
+            return 0;
+        }
+        l_Pos += header->state_size;
+        savestates_set_job(savestates_job_load, savestates_type_unknown, l_StateFile);
+        l_Armed = 1;
+    }
+
+    l_Mode = MOVIE_PLAYING;
+    l_Filename = strdup(filename);
+    reset_timeline();
+    DebugMessage(M64MSG_INFO, "playing input movie '%s'%s", filename, l_Armed ? " from a savestate" : "");
+    return 1;
+}
+
+static void playback_finish(void)
+{
+    unsigned int frames, checksum;
+    double seconds = (ticksGetNanoseconds() - l_StartTime) / 1000000000.0;
+
+    if (get_byte() != MOVIE_END || !get_uint(&frames) || !get_uint(&checksum) || frames != l_Frames)
+    {
+        DebugMessage(M64MSG_WARNING, "input movie '%s' ends without a checksum after %u frames", l_Filename, l_Frames);
+    }
+    else if (checksum == l_Checksum)
+    {
+        DebugMessage(M64MSG_STATUS, "played %u frames of input movie '%s' in %.2f s (%.1f fps), checksum %08x matches the recording",
+                     l_Frames, l_Filename, seconds, seconds > 0 ? l_Frames / seconds : 0.0, l_Checksum);
+    }
+    else
+    {
+        DebugMessage(M64MSG_ERROR, "played %u frames of input movie '%s' in %.2f s, checksum %08x differs from the recording (%08x)",
+                     l_Frames, l_Filename, seconds, l_Checksum, checksum);
+    }
+    playback_end();
+}
+
+/*********************************************************************************************************
+* interface
+*/
+
+void movie_start(void)
+{
+    const char *play = ConfigGetParamString(g_CoreConfig, "MoviePlay");
+    const char *record = ConfigGetParamString(g_CoreConfig, "MovieRecord");
+    int started = 1;
+
+    movie_stop();
+    if (play[0] != '\0')
+        started = playback_start(play);
+    else if (record[0] != '\0')
+        started = record_start(record);
+    if (!started)
+        movie_stop();
+}
+
+void movie_stop(void)
+{
+    if (l_Mode == MOVIE_RECORDING)
+        record_finish();
+    else if (l_Mode == MOVIE_PLAYING)
+        DebugMessage(M64MSG_WARNING, "input movie '%s' stopped at frame %u before its end", l_Filename, l_Frames);
+
+    if (l_ControlsSaved)
+    {
+        memcpy(Controls, l_SavedControls, sizeof(l_SavedControls));
+        l_ControlsSaved = 0;
+    }
+    if (l_StateFile != NULL)
+    {
+        remove(l_StateFile);
+        free(l_StateFile);
+        l_StateFile = NULL;
+    }
+    free(l_Filename);
+    l_Filename = NULL;
+    free(l_Data);
+    l_Data = NULL;
+    l_Size = l_Capacity = 0;
+    l_Mode = MOVIE_OFF;
+    l_Armed = 0;
+}
+
+int movie_active(void)
+{
+    return l_Mode != MOVIE_OFF;
+}
+
+void movie_vi(void)
+{
+    unsigned int checksum;
+    int code;
+
+    if (l_Mode == MOVIE_OFF || l_Armed)
+        return;
+
+    l_Frames++;
+    l_Checksum = frame_checksum(l_Checksum, l_Frames);
+
+    if (l_Mode == MOVIE_RECORDING)
+    {
+        put_byte(MOVIE_VI);
+        if (l_Frames % MOVIE_CHECK_FRAMES == 0)
+        {
+            put_byte(MOVIE_CHECK);
+            put_uint(l_Checksum);
+        }
+        l_LastVI = l_Size;
+        return;
+    }
+
+    if (get_byte() != MOVIE_VI)
+    {
+        desync();
+        return;
+    }
+    code = l_Pos < l_Size ? l_Data[l_Pos] : MOVIE_END;
+    if (code == MOVIE_CHECK)
+    {
+        l_Pos++;
+        if (!get_uint(&checksum) || checksum != l_Checksum)
+        {
+            DebugMessage(M64MSG_ERROR, "input movie '%s' went its own way between frames %u and %u",
+                         l_Filename, l_Frames - MOVIE_CHECK_FRAMES, l_Frames);
+            playback_end();
+            return;
+        }
+        code = l_Pos < l_Size ? l_Data[l_Pos] : MOVIE_END;
+    }
+    if (code == MOVIE_END)
+        playback_finish();
+}
+
+void movie_state_loaded(int success)
+{
+    if (l_Mode == MOVIE_OFF)
+        return;
+
+    if (!l_Armed)
+    {
+        DebugMessage(M64MSG_WARNING, "a savestate was loaded; input movie '%s' is stopped", l_Filename);
+        movie_stop();
+        return;
+    }
+
+    l_Armed = 0;
+    if (!success)
+    {
+        DebugMessage(M64MSG_ERROR, "couldn't load the savestate of input movie '%s'", l_Filename);
+        if (l_Mode == MOVIE_PLAYING)
+            main_stop();
+        else
+            remove(l_Filename);     // only opened to check that it could be written
+        l_Mode = MOVIE_OFF;
+        movie_stop();
+        return;
+    }
+    reset_timeline();
+}
+
+void movie_get_keys(int Control, BUTTONS *Keys)
+{
+    unsigned int value;
+    int code;
+
+    if (l_Mode == MOVIE_PLAYING && !l_Armed)
+    {
+        code = get_byte();
+        if (code == (MOVIE_KEYS | Control) && get_uint(&value))
+            l_LastKeys[Control] = value;
+        else if (code != (MOVIE_KEYS_SAME | Control))
+            desync();
+        Keys->Value = l_LastKeys[Control];
+        return;
+    }
+
+    input.getKeys(Control, Keys);
+    if (l_Mode == MOVIE_RECORDING && !l_Armed)
+    {
+        if (Keys->Value == l_LastKeys[Control])
+            put_byte((unsigned char) (MOVIE_KEYS_SAME | Control));
+        else
+        {
+            put_byte((unsigned char) (MOVIE_KEYS | Control));
+            put_uint(Keys->Value);
+            l_LastKeys[Control] = Keys->Value;
+        }
+    }
+}
+
+/* the result of a raw command is its rx length byte, which the plugin can
+ * flag, and its rx data */
+static void raw_poll(int code, ptr_ReadController call, int Control, unsigned char *Command)
+{
+    unsigned char *rx;
+    unsigned int length;
+
+    /* the end of a poll round, which only the plugin cares about */
+    if (Control < 0)
+    {
+        if (l_Mode != MOVIE_PLAYING || l_Armed)
+            call(Control, Command);
+        return;
+    }
+
+    rx = Command + 2 + Command[0];
+    length = 1 + (Command[1] & 0x3F);
+
+    if (l_Mode == MOVIE_PLAYING && !l_Armed)
+    {
+        if (get_byte() != (code | Control) || get_byte() != (int) length || l_Size - l_Pos < length)
+        {
+            desync();
+            return;
+        }
+        Command[1] = l_Data[l_Pos];
+        memcpy(rx, l_Data + l_Pos + 1, length - 1);
+        l_Pos += length;
+        return;
+    }
+
+    call(Control, Command);
+    if (l_Mode == MOVIE_RECORDING && !l_Armed)
+    {
+        put_byte((unsigned char) (code | Control));
+        put_byte((unsigned char) length);
+        put_byte(Command[1]);
+        put_bytes(rx, length - 1);
+    }
+}
+
+void movie_read_controller(int Control, unsigned char *Command)
+{
+    raw_poll(MOVIE_RAW_READ, input.readController, Control, Command);
+}
+
+void movie_controller_command(int Control, unsigned char *Command)
+{
+    raw_poll(MOVIE_RAW_COMMAND, input.controllerCommand, Control, Command);
+}
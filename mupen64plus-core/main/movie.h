@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - movie.h                                                 *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Input movies
+ *
+ * When the core parameter MovieRecord names a file, the result of every
+ * controller poll the game makes through the PIF is recorded in it, frame
+ * by frame. With MoviePlay the polls are answered from the file instead of
+ * the input plugin, so the game gets exactly the same input again and the
+ * run can be repeated as a benchmark. Playback stops the emulator at the
+ * end of the movie and reports whether the machine ended up the same as
+ * in the recording.
+ *
+ * A movie starts at power-on, or from the savestate named by
+ * MovieStartState, which is kept in the movie. Save files, the RTC and
+ * anything the video plugin writes to RDRAM from a thread of its own are
+ * not part of the movie. They have to be the same for the run to repeat.
+ *
+ * File layout (gzip, host byte order):
+ *   movie_header
+ *   the savestate, 'state_size' bytes
+ *   events, each a one-byte code, the low two bits of the poll codes being
+ *   the controller:
+ *     MOVIE_KEYS         getKeys() result, 4 bytes
+ *     MOVIE_KEYS_SAME    getKeys() result unchanged since the last one
+ *     MOVIE_RAW_READ     readController() result: 1 byte n, then n bytes
+ *                        (the command's rx length byte and its rx data)
+ *     MOVIE_RAW_COMMAND  controllerCommand() result, same as MOVIE_RAW_READ
+ *     MOVIE_VI           end of a frame
+ *     MOVIE_CHECK        checksum of the machine at the last MOVIE_VI, 4 bytes
+ *     MOVIE_END          frame count and checksum at the end, 4 bytes each
+ */
+
+#ifndef __MOVIE_H__
+#define __MOVIE_H__
+
+#include "api/m64p_plugin.h"
+
+#define MOVIE_MAGIC        "M64PMOV"
+#define MOVIE_VERSION      1
+#define MOVIE_CHECK_FRAMES 600      // frames between MOVIE_CHECK events
+
+enum movie_event
+{
+    MOVIE_KEYS        = 0x00,
+    MOVIE_KEYS_SAME   = 0x04,
+    MOVIE_RAW_READ    = 0x08,
+    MOVIE_RAW_COMMAND = 0x0C,
+    MOVIE_VI          = 0x10,
+    MOVIE_CHECK,
+    MOVIE_END
+};
+
+typedef struct
+{
+    char          magic[8];
+    unsigned int  version;
+    char          rom_md5[32];
+    unsigned int  r4300emu;
+    unsigned int  count_per_op;
+    unsigned char controls[4][4];   // Present, RawData, Plugin, 0
+    unsigned int  state_size;
+} movie_header;
+
+void movie_start(void);
+void movie_stop(void);
+int movie_active(void);
+
+void movie_vi(void);
+void movie_state_loaded(int success);
+
+/* called by the PIF instead of the input plugin's functions */
+void movie_get_keys(int Control, BUTTONS *Keys);
+void movie_read_controller(int Control, unsigned char *Command);
+void movie_controller_command(int Control, unsigned char *Command);
+
+#endif /* __MOVIE_H__ */
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <zlib.h>
 
 #define M64P_CORE_PROTOTYPES 1
 #include "api/m64p_types.h"
@@ -33,8 +34,10 @@
 
 #include "md5.h"
 #include "rom.h"
+#include "romchunks.h"
 #include "main.h"
 #include "util.h"
+#include "zip/unzip.h"
 
 #include "memory/memory.h"
 #include "r4300/r4300.h"
@@ -80,6 +83,168 @@ static int is_valid_rom(const unsigned char *buffer)
         return 0;
 }
 
+/* Memory-backed file functions for minizip, so that a zipped ROM can be
+ * opened straight from the buffer the frontend passed in. */
+typedef struct
+{
+    const unsigned char *data;
+    unsigned long size;
+    unsigned long pos;
+} zip_memory;
+
+static voidpf ZCALLBACK zip_memory_open(voidpf opaque, const char *filename, int mode)
+{
+    ((zip_memory *) opaque)->pos = 0;
+    return opaque;
+}
+
+static uLong ZCALLBACK zip_memory_read(voidpf opaque, voidpf stream, void *buf, uLong size)
+{
+    zip_memory *zm = (zip_memory *) stream;
+    if (size > zm->size - zm->pos)
+        size = zm->size - zm->pos;
+    memcpy(buf, zm->data + zm->pos, size);
+    zm->pos += size;
+    return size;
+}
+
+static uLong ZCALLBACK zip_memory_write(voidpf opaque, voidpf stream, const void *buf, uLong size)
+{
+    return 0;
+}
+
+static long ZCALLBACK zip_memory_tell(voidpf opaque, voidpf stream)
+{
+    return (long) ((zip_memory *) stream)->pos;
+}
+
+static long ZCALLBACK zip_memory_seek(voidpf opaque, voidpf stream, uLong offset, int origin)
+{
+    zip_memory *zm = (zip_memory *) stream;
+    unsigned long base;
+
+    switch (origin)
+    {
+        case ZLIB_FILEFUNC_SEEK_SET: base = 0; break;
+        case ZLIB_FILEFUNC_SEEK_CUR: base = zm->pos; break;
+        case ZLIB_FILEFUNC_SEEK_END: base = zm->size; break;
+        default: return -1;
+    }
+    if (base + offset > zm->size)
+        return -1;
+    zm->pos = base + offset;
+    return 0;
+}
+
+static int ZCALLBACK zip_memory_close(voidpf opaque, voidpf stream)
+{
+    return 0;
+}
+
+static int ZCALLBACK zip_memory_error(voidpf opaque, voidpf stream)
+{
+    return 0;
+}
+
+/* Unpacks the first ROM image found in a .zip archive. */
+static unsigned char *unpack_zip(const unsigned char *image, unsigned int size, unsigned int *unpacked_size)
+{
+    zip_memory zm;
+    zlib_filefunc_def funcs;
+    unzFile zip;
+    unz_file_info info;
+    char name[256];
+    unsigned char *data = NULL;
+
+    zm.data = image;
+    zm.size = size;
+    zm.pos = 0;
+    funcs.zopen_file = zip_memory_open;
+    funcs.zread_file = zip_memory_read;
+    funcs.zwrite_file = zip_memory_write;
+    funcs.ztell_file = zip_memory_tell;
+    funcs.zseek_file = zip_memory_seek;
+    funcs.zclose_file = zip_memory_close;
+    funcs.zerror_file = zip_memory_error;
+    funcs.opaque = &zm;
+
+    zip = unzOpen2("rom.zip", &funcs);
+    if (zip == NULL)
+        return NULL;
+
+    if (unzGoToFirstFile(zip) == UNZ_OK) do
+    {
+        unsigned char magic[8];
+
+        if (unzGetCurrentFileInfo(zip, &info, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK ||
+            info.uncompressed_size < 0x1000 || unzOpenCurrentFile(zip) != UNZ_OK)
+            continue;
+        if (unzReadCurrentFile(zip, magic, 8) == 8 &&
+            (is_valid_rom(magic) || memcmp(magic, ROMCHUNKS_MAGIC, 8) == 0))
+        {
+            data = (unsigned char *) malloc(info.uncompressed_size);
+            if (data != NULL)
+            {
+                memcpy(data, magic, 8);
+                if (unzReadCurrentFile(zip, data + 8, info.uncompressed_size - 8) != (int) info.uncompressed_size - 8)
+                {
+                    free(data);
+                    data = NULL;
+                }
+            }
+        }
+        unzCloseCurrentFile(zip);
+        if (data != NULL)
+        {
+            DebugMessage(M64MSG_INFO, "Using '%s' from the zip archive", name);
+            *unpacked_size = info.uncompressed_size;
+            break;
+        }
+    } while (unzGoToNextFile(zip) == UNZ_OK);
+
+    unzClose(zip);
+    return data;
+}
+
+/* Unpacks a .gz file; its last four bytes hold the uncompressed size. */
+static unsigned char *unpack_gzip(const unsigned char *image, unsigned int size, unsigned int *unpacked_size)
+{
+    z_stream stream;
+    unsigned int length;
+    unsigned char *data;
+    int ret;
+
+    length = image[size - 4] | (image[size - 3] << 8) | (image[size - 2] << 16) | ((unsigned int) image[size - 1] << 24);
+    if (length < 0x1000 || length > 0x8000000)
+        return NULL;
+    data = (unsigned char *) malloc(length);
+    if (data == NULL)
+        return NULL;
+
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        free(data);
+        return NULL;
+    }
+    stream.next_in = (Bytef *) image;
+    stream.avail_in = size;
+    stream.next_out = data;
+    stream.avail_out = length;
+    ret = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    /* like in a .zip, only a ROM image is taken, so that open_rom() isn't handed another archive */
+    if (ret != Z_STREAM_END || stream.total_out != length ||
+        (!is_valid_rom(data) && memcmp(data, ROMCHUNKS_MAGIC, 8) != 0))
+    {
+        free(data);
+        return NULL;
+    }
+
+    *unpacked_size = length;
+    return data;
+}
+
 /* If rom is a .v64 or .n64 image, byteswap or wordswap loadlength amount of
  * rom data to native .z64 before forwarding. Makes sure that data extraction
  * and MD5ing routines always deal with a .z64 image.
@@ -133,7 +298,25 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
         DebugMessage(M64MSG_ERROR, "open_rom(): previous ROM image was not freed");
         return M64ERR_INTERNAL;
     }
-    if (romimage == NULL || !is_valid_rom(romimage))
+    if (romimage != NULL && size > 18 &&
+        ((romimage[0] == 'P' && romimage[1] == 'K' && romimage[2] == 3 && romimage[3] == 4) ||
+         (romimage[0] == 0x1f && romimage[1] == 0x8b)))
+    {
+        unsigned int unpacked_size = 0;
+        unsigned char *unpacked = (romimage[0] == 'P') ?
+            unpack_zip(romimage, size, &unpacked_size) : unpack_gzip(romimage, size, &unpacked_size);
+        m64p_error rval;
+
+        if (unpacked == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "open_rom(): no ROM image could be unpacked from the archive");
+            return M64ERR_INPUT_INVALID;
+        }
+        rval = open_rom(unpacked, unpacked_size);
+        free(unpacked);
+        return rval;
+    }
+    if (romimage == NULL || (!is_valid_rom(romimage) && !romchunks_is_image(romimage, size)))
     {
         DebugMessage(M64MSG_ERROR, "open_rom(): not a valid ROM image");
         return M64ERR_INPUT_INVALID;
@@ -141,20 +324,42 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
 
     /* Clear Byte-swapped flag, since ROM is now deleted. */
     g_MemHasBeenBSwapped = 0;
-    /* allocate new buffer for ROM and copy into this buffer */
-    rom_size = size;
-    rom = (unsigned char *) malloc(size);
-    if (rom == NULL)
-        return M64ERR_NO_MEMORY;
-    memcpy(rom, romimage, size);
-    swap_rom(rom, &imagetype, rom_size);
+    romchunks_reset_stats();
+    if (romchunks_is_image(romimage, size))
+    {
+        /* keep the chunks compressed, only the first one is inflated */
+        unsigned int romsize;
+        m64p_error rval = romchunks_open(romimage, size, &rom, &rom_resident_size, &romsize, digest);
+        if (rval != M64ERR_SUCCESS)
+            return rval;
+        rom_size = romsize;
+        imagetype = Z64IMAGE;
+        if (!is_valid_rom(rom))
+        {
+            DebugMessage(M64MSG_ERROR, "open_rom(): compressed image doesn't hold a .z64 ROM");
+            close_rom();
+            return M64ERR_INPUT_INVALID;
+        }
+    }
+    else
+    {
+        /* allocate new buffer for ROM and copy into this buffer */
+        rom_size = size;
+        rom_resident_size = size;
+        rom = (unsigned char *) malloc(size);
+        if (rom == NULL)
+            return M64ERR_NO_MEMORY;
+        memcpy(rom, romimage, size);
+        swap_rom(rom, &imagetype, rom_size);
+
+        /* Calculate MD5 hash  */
+        md5_init(&state);
+        md5_append(&state, (const md5_byte_t*)rom, rom_size);
+        md5_finish(&state, digest);
+    }
 
     memcpy(&ROM_HEADER, rom, sizeof(m64p_rom_header));
 
-    /* Calculate MD5 hash  */
-    md5_init(&state);
-    md5_append(&state, (const md5_byte_t*)rom, rom_size);
-    md5_finish(&state, digest);
     for ( i = 0; i < 16; ++i )
         sprintf(buffer+i*2, "%02X", digest[i]);
     buffer[32] = '\0';
@@ -218,6 +423,20 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
     if(strcmp(ROM_PARAMS.headername, "GOLDENEYE") == 0)
        isGoldeneyeRom = 1;
 
+    /* the GoldenEye hack maps the ROM straight into the recompiler's memory map */
+    if (isGoldeneyeRom && rom_resident_size < (unsigned int) rom_size)
+    {
+        unsigned char *flat = romchunks_flatten();
+        if (flat == NULL)
+        {
+            close_rom();
+            return M64ERR_NO_MEMORY;
+        }
+        free(rom);
+        rom = flat;
+        rom_resident_size = rom_size;
+    }
+
     return M64ERR_SUCCESS;
 }
 
@@ -228,6 +447,8 @@ m64p_error close_rom(void)
 
     free(rom);
     rom = NULL;
+    romchunks_close();
+    rom_resident_size = 0;
 
     /* Clear Byte-swapped flag, since ROM is now deleted. */
     g_MemHasBeenBSwapped = 0;
@@ -0,0 +1,560 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romchunks.c                                             *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+#include "api/config.h"
+#include "api/m64p_config.h"
+
+#include "main.h"
+#include "romchunks.h"
+
+#include "memory/memory.h"
+
+typedef struct
+{
+    int chunk;
+    unsigned int stamp;
+    unsigned char *data;
+} chunk_slot;
+
+unsigned int rom_resident_size = 0;
+
+/* the container, copied since the frontend frees its buffer after ROM_OPEN */
+static unsigned char *l_Image = NULL;
+static unsigned int l_ChunkSize;
+static unsigned int l_RomSize;
+static unsigned int l_NumChunks;
+static unsigned int *l_Offsets;
+static int l_Swapped = 0;
+
+/* LRU cache of inflated chunks; l_ChunkSlot maps a chunk to its slot or -1 */
+static chunk_slot *l_Slots = NULL;
+static int l_NumSlots;
+static int *l_ChunkSlot = NULL;
+static unsigned int l_Clock;
+static unsigned int l_LastChunk;
+static unsigned char *l_LastData;
+
+/* two ROM pages copied out of the cache for instruction fetch */
+static unsigned char *l_ExecWindow = NULL;
+static unsigned int l_ExecPage;
+
+/* read-ahead: the thread inflates l_AheadChunk into l_AheadData while a
+ * game streams data in sequential DMAs; a miss on that chunk takes the
+ * buffer over instead of inflating it again */
+enum { AHEAD_IDLE, AHEAD_BUSY, AHEAD_READY };
+static int l_ReadAhead = 0;
+static SDL_Thread *l_Thread = NULL;
+static SDL_mutex *l_Lock = NULL;
+static SDL_cond *l_Wake = NULL;
+static SDL_cond *l_Ready = NULL;
+static int l_AheadState = AHEAD_IDLE;
+static int l_AheadQuit = 0;
+static unsigned int l_AheadChunk;
+static unsigned char *l_AheadData = NULL;
+static unsigned int l_LastDmaEnd = 0;
+
+static unsigned char l_Zero[16];
+
+/* statistics for M64CORE_ROM_* */
+static unsigned int l_DmaCount;
+static unsigned long long l_DmaTime;
+static unsigned long long l_DmaMax;
+static unsigned int l_Misses;
+
+static unsigned int get32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+
+static unsigned int chunk_length(unsigned int chunk)
+{
+    unsigned int start = chunk * l_ChunkSize;
+    return (l_RomSize - start < l_ChunkSize) ? l_RomSize - start : l_ChunkSize;
+}
+
+static int inflate_chunk(unsigned int chunk, unsigned char *dst, int swap)
+{
+    unsigned int length = chunk_length(chunk);
+    unsigned int stored = l_Offsets[chunk + 1] - l_Offsets[chunk];
+    const unsigned char *src = l_Image + l_Offsets[chunk];
+
+    if (stored == length)
+        memcpy(dst, src, length);
+    else
+    {
+        uLongf outlen = length;
+        if (uncompress(dst, &outlen, src, stored) != Z_OK || outlen != length)
+        {
+            DebugMessage(M64MSG_ERROR, "Corrupt compressed ROM chunk %u", chunk);
+            memset(dst, 0, length);
+            return 0;
+        }
+    }
+
+    if (swap)
+    {
+        unsigned int *words = (unsigned int *) dst, i;
+        for (i = 0; i < length / 4; i++)
+            words[i] = sl(words[i]);
+    }
+    return 1;
+}
+
+static int read_ahead_thread(void *unused)
+{
+    SDL_LockMutex(l_Lock);
+    while (!l_AheadQuit)
+    {
+        unsigned int chunk;
+        int swap;
+
+        if (l_AheadState != AHEAD_BUSY)
+        {
+            SDL_CondWait(l_Wake, l_Lock);
+            continue;
+        }
+        chunk = l_AheadChunk;
+        swap = l_Swapped;
+        SDL_UnlockMutex(l_Lock);
+
+        inflate_chunk(chunk, l_AheadData, swap);
+
+        SDL_LockMutex(l_Lock);
+        l_AheadState = AHEAD_READY;
+        SDL_CondSignal(l_Ready);
+    }
+    SDL_UnlockMutex(l_Lock);
+    return 0;
+}
+
+static void read_ahead_start(void)
+{
+    l_AheadData = (unsigned char *) malloc(l_ChunkSize);
+    l_Lock = SDL_CreateMutex();
+    l_Wake = SDL_CreateCond();
+    l_Ready = SDL_CreateCond();
+    l_AheadState = AHEAD_IDLE;
+    l_AheadQuit = 0;
+    if (l_AheadData != NULL && l_Lock != NULL && l_Wake != NULL && l_Ready != NULL)
+        l_Thread = SDL_CreateThread(read_ahead_thread, NULL);
+    if (l_Thread == NULL)
+    {
+        DebugMessage(M64MSG_WARNING, "Couldn't start the ROM read-ahead thread");
+        l_ReadAhead = 0;
+    }
+}
+
+/* Waits for a read-ahead in progress; returns with the lock held */
+static void read_ahead_wait(void)
+{
+    SDL_LockMutex(l_Lock);
+    while (l_AheadState == AHEAD_BUSY)
+        SDL_CondWait(l_Ready, l_Lock);
+}
+
+static void read_ahead_stop(void)
+{
+    if (l_Thread != NULL)
+    {
+        SDL_LockMutex(l_Lock);
+        l_AheadQuit = 1;
+        SDL_CondSignal(l_Wake);
+        SDL_UnlockMutex(l_Lock);
+        SDL_WaitThread(l_Thread, NULL);
+        l_Thread = NULL;
+    }
+    if (l_Ready != NULL) SDL_DestroyCond(l_Ready);
+    if (l_Wake != NULL) SDL_DestroyCond(l_Wake);
+    if (l_Lock != NULL) SDL_DestroyMutex(l_Lock);
+    l_Ready = l_Wake = NULL;
+    l_Lock = NULL;
+    free(l_AheadData);
+    l_AheadData = NULL;
+}
+
+static void flush_cache(void)
+{
+    int i;
+
+    for (i = 0; i < l_NumSlots; i++)
+    {
+        if (l_Slots[i].chunk >= 0)
+            l_ChunkSlot[l_Slots[i].chunk] = -1;
+        l_Slots[i].chunk = -1;
+        l_Slots[i].stamp = 0;
+    }
+    l_LastChunk = 0;
+    l_LastData = NULL;
+    l_ExecPage = 0xFFFFFFFF;
+}
+
+int romchunks_is_image(const unsigned char *image, unsigned int size)
+{
+    return size >= ROMCHUNKS_HEADER && memcmp(image, ROMCHUNKS_MAGIC, 8) == 0;
+}
+
+m64p_error romchunks_open(const unsigned char *image, unsigned int size,
+                          unsigned char **head, unsigned int *head_size,
+                          unsigned int *romsize, md5_byte_t *md5)
+{
+    unsigned int i;
+    unsigned long long slots;
+    int budget;
+
+    if (get32(image + 8) != ROMCHUNKS_VERSION)
+    {
+        DebugMessage(M64MSG_ERROR, "Unsupported compressed ROM version %u", get32(image + 8));
+        return M64ERR_INCOMPATIBLE;
+    }
+
+    l_ChunkSize = get32(image + 12);
+    l_RomSize = get32(image + 16);
+    l_NumChunks = get32(image + 20);
+    if (l_ChunkSize == 0 || (l_ChunkSize & 0xFFF) != 0 || l_RomSize < 0x1000 || l_RomSize > 0x4000000 ||
+        l_NumChunks != (l_RomSize + l_ChunkSize - 1) / l_ChunkSize ||
+        size < ROMCHUNKS_HEADER + (l_NumChunks + 1) * 4)
+    {
+        DebugMessage(M64MSG_ERROR, "Invalid compressed ROM header");
+        return M64ERR_INPUT_INVALID;
+    }
+
+    l_Offsets = (unsigned int *) malloc((l_NumChunks + 1) * sizeof(unsigned int));
+    l_Image = (unsigned char *) malloc(size);
+    l_ChunkSlot = (int *) malloc(l_NumChunks * sizeof(int));
+    *head = (unsigned char *) malloc(chunk_length(0));
+    if (l_Offsets == NULL || l_Image == NULL || l_ChunkSlot == NULL || *head == NULL)
+    {
+        free(*head);
+        *head = NULL;
+        romchunks_close();
+        return M64ERR_NO_MEMORY;
+    }
+    memcpy(l_Image, image, size);
+
+    for (i = 0; i <= l_NumChunks; i++)
+    {
+        l_Offsets[i] = get32(image + ROMCHUNKS_HEADER + i * 4);
+        if (l_Offsets[i] > size || (i > 0 && l_Offsets[i] < l_Offsets[i - 1]))
+        {
+            DebugMessage(M64MSG_ERROR, "Invalid compressed ROM chunk index");
+            free(*head);
+            *head = NULL;
+            romchunks_close();
+            return M64ERR_INPUT_INVALID;
+        }
+        if (i < l_NumChunks)
+            l_ChunkSlot[i] = -1;
+    }
+
+    l_Swapped = 0;
+    if (!inflate_chunk(0, *head, 0))
+    {
+        free(*head);
+        *head = NULL;
+        romchunks_close();
+        return M64ERR_INPUT_INVALID;
+    }
+    *head_size = chunk_length(0);
+    *romsize = l_RomSize;
+    memcpy(md5, image + 24, 16);
+
+    /* The first chunk lives in 'rom', so the cache only needs the rest */
+    budget = ConfigGetParamInt(g_CoreConfig, "RomCacheSize");
+    slots = (budget > 0) ? ((unsigned long long) budget << 20) / l_ChunkSize : 0;
+    l_NumSlots = (int) (slots < l_NumChunks ? slots : l_NumChunks);
+    if (l_NumSlots < 2)
+        l_NumSlots = 2;
+    if (l_NumSlots > (int) l_NumChunks - 1)
+        l_NumSlots = l_NumChunks > 2 ? l_NumChunks - 1 : 2;
+
+    l_Slots = (chunk_slot *) malloc(l_NumSlots * sizeof(chunk_slot));
+    l_ExecWindow = (unsigned char *) malloc(0x2000);
+    if (l_Slots == NULL || l_ExecWindow == NULL)
+    {
+        free(*head);
+        *head = NULL;
+        romchunks_close();
+        return M64ERR_NO_MEMORY;
+    }
+    for (i = 0; i < (unsigned int) l_NumSlots; i++)
+    {
+        l_Slots[i].chunk = -1;
+        l_Slots[i].stamp = 0;
+        l_Slots[i].data = NULL;
+    }
+    flush_cache();
+    l_Clock = 0;
+    l_LastDmaEnd = 0;
+
+    l_ReadAhead = ConfigGetParamBool(g_CoreConfig, "RomReadAhead");
+    if (l_ReadAhead)
+        read_ahead_start();
+
+    DebugMessage(M64MSG_INFO, "Compressed ROM: %u chunks of %u KB, %u KB in memory, %d KB cache",
+                 l_NumChunks, l_ChunkSize >> 10, size >> 10, (l_NumSlots * l_ChunkSize) >> 10);
+    return M64ERR_SUCCESS;
+}
+
+/* Inflates the whole ROM into one buffer and drops the container, for the
+ * code that has to address the ROM directly (see isGoldeneyeRom). */
+unsigned char *romchunks_flatten(void)
+{
+    unsigned char *flat;
+    unsigned int i;
+
+    if (l_Image == NULL)
+        return NULL;
+
+    flat = (unsigned char *) malloc(l_RomSize);
+    if (flat == NULL)
+        return NULL;
+    for (i = 0; i < l_NumChunks; i++)
+        inflate_chunk(i, flat + i * l_ChunkSize, l_Swapped);
+
+    romchunks_close();
+    return flat;
+}
+
+void romchunks_close(void)
+{
+    int i;
+
+    read_ahead_stop();
+    l_ReadAhead = 0;
+
+    if (l_Slots != NULL)
+    {
+        for (i = 0; i < l_NumSlots; i++)
+            free(l_Slots[i].data);
+        free(l_Slots);
+        l_Slots = NULL;
+    }
+    l_NumSlots = 0;
+    free(l_ChunkSlot);
+    l_ChunkSlot = NULL;
+    free(l_Offsets);
+    l_Offsets = NULL;
+    free(l_Image);
+    l_Image = NULL;
+    free(l_ExecWindow);
+    l_ExecWindow = NULL;
+    l_LastData = NULL;
+    l_Swapped = 0;
+}
+
+/* init_memory() swapped the resident part of the ROM to host word order;
+ * chunks inflated from now on get the same treatment */
+void romchunks_byteswap(void)
+{
+    if (l_Image == NULL)
+        return;
+
+    if (l_Thread != NULL)
+    {
+        read_ahead_wait();
+        l_AheadState = AHEAD_IDLE;
+        l_Swapped = 1;
+        SDL_UnlockMutex(l_Lock);
+    }
+    else
+        l_Swapped = 1;
+    flush_cache();
+}
+
+static unsigned char *load_chunk(unsigned int chunk)
+{
+    chunk_slot *slot;
+    int i, victim = 0;
+
+    if (l_ChunkSlot[chunk] >= 0)
+    {
+        slot = &l_Slots[l_ChunkSlot[chunk]];
+        slot->stamp = ++l_Clock;
+        return slot->data;
+    }
+
+    for (i = 1; i < l_NumSlots; i++)
+        if (l_Slots[i].stamp < l_Slots[victim].stamp)
+            victim = i;
+    slot = &l_Slots[victim];
+    if (slot->chunk >= 0)
+        l_ChunkSlot[slot->chunk] = -1;
+    slot->chunk = -1;
+
+    if (slot->data == NULL)
+    {
+        slot->data = (unsigned char *) malloc(l_ChunkSize);
+        if (slot->data == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "Couldn't allocate ROM cache chunk");
+            return NULL;
+        }
+    }
+
+    if (l_Thread != NULL)
+    {
+        SDL_LockMutex(l_Lock);
+        if (l_AheadState != AHEAD_IDLE && l_AheadChunk == chunk)
+        {
+            unsigned char *data;
+
+            while (l_AheadState == AHEAD_BUSY)
+                SDL_CondWait(l_Ready, l_Lock);
+            data = l_AheadData;
+            l_AheadData = slot->data;
+            slot->data = data;
+            l_AheadState = AHEAD_IDLE;
+            SDL_UnlockMutex(l_Lock);
+            goto loaded;
+        }
+        SDL_UnlockMutex(l_Lock);
+    }
+
+    l_Misses++;
+    inflate_chunk(chunk, slot->data, l_Swapped);
+
+loaded:
+    slot->chunk = chunk;
+    slot->stamp = ++l_Clock;
+    l_ChunkSlot[chunk] = victim;
+    return slot->data;
+}
+
+unsigned char *romchunks_span(unsigned int offset, unsigned int *end)
+{
+    unsigned int chunk;
+
+    if (l_Image == NULL || offset >= l_RomSize)
+    {
+        /* a flat ROM read past its end, or an offset no cartridge has */
+        if (end != NULL)
+            *end = (offset & ~3) + 4;
+        return l_Zero + (offset & 3);
+    }
+
+    chunk = offset / l_ChunkSize;
+    if (chunk != l_LastChunk || l_LastData == NULL)
+    {
+        unsigned char *data = load_chunk(chunk);
+        if (data == NULL)
+        {
+            if (end != NULL)
+                *end = (offset & ~3) + 4;
+            return l_Zero + (offset & 3);
+        }
+        l_LastChunk = chunk;
+        l_LastData = data;
+    }
+
+    if (end != NULL)
+        *end = chunk * l_ChunkSize + chunk_length(chunk);
+    return l_LastData + (offset - chunk * l_ChunkSize);
+}
+
+unsigned char *romchunks_exec(unsigned int offset)
+{
+    unsigned int page = offset & ~0xFFF;
+    unsigned int pos;
+
+    if (l_Image == NULL)
+        return rom + offset;
+
+    if (page != l_ExecPage)
+    {
+        for (pos = page; pos < page + 0x2000; )
+        {
+            unsigned int end;
+            unsigned char *src = rom_span(pos, &end);
+            if (end > page + 0x2000)
+                end = page + 0x2000;
+            memcpy(l_ExecWindow + (pos - page), src, end - pos);
+            pos = end;
+        }
+        l_ExecPage = page;
+    }
+    return l_ExecWindow + (offset - page);
+}
+
+/* Called after each PI DMA from the cartridge ROM with the time it took.
+ * A DMA that starts where the previous one ended is taken as streaming,
+ * and the chunk following it is inflated ahead on the read-ahead thread. */
+void romchunks_dma(unsigned int offset, unsigned int length, unsigned long long nanoseconds)
+{
+    unsigned int next;
+
+    l_DmaCount++;
+    l_DmaTime += nanoseconds;
+    if (nanoseconds > l_DmaMax)
+        l_DmaMax = nanoseconds;
+
+    if (l_Thread != NULL && offset == l_LastDmaEnd)
+    {
+        next = (offset + length) / l_ChunkSize + 1;
+        if (next < l_NumChunks && l_ChunkSlot[next] < 0)
+        {
+            SDL_LockMutex(l_Lock);
+            if (l_AheadState != AHEAD_BUSY && !(l_AheadState == AHEAD_READY && l_AheadChunk == next))
+            {
+                l_AheadChunk = next;
+                l_AheadState = AHEAD_BUSY;
+                SDL_CondSignal(l_Wake);
+            }
+            SDL_UnlockMutex(l_Lock);
+        }
+    }
+    l_LastDmaEnd = offset + length;
+}
+
+void romchunks_reset_stats(void)
+{
+    l_DmaCount = 0;
+    l_DmaTime = 0;
+    l_DmaMax = 0;
+    l_Misses = 0;
+}
+
+m64p_error romchunks_stats_query(m64p_core_param param, int *rval)
+{
+    switch (param)
+    {
+        case M64CORE_ROM_DMA_TIME_AVG:
+            *rval = l_DmaCount ? (int) (l_DmaTime / l_DmaCount) : 0;
+            break;
+        case M64CORE_ROM_DMA_TIME_MAX:
+            *rval = (int) l_DmaMax;
+            break;
+        case M64CORE_ROM_CHUNK_MISSES:
+            *rval = (int) l_Misses;
+            break;
+        default:
+            return M64ERR_INPUT_INVALID;
+    }
+    return M64ERR_SUCCESS;
+}
@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romchunks.h                                             *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Chunked compressed ROM images.
+ *
+ * The container holds a .z64 ROM cut into fixed-size chunks, each compressed
+ * on its own with zlib, so any part of the ROM can be read without inflating
+ * what comes before it. All numbers are little-endian 32-bit:
+ *
+ *   0   "M64PCROM"
+ *   8   version (ROMCHUNKS_VERSION)
+ *   12  chunk size in bytes (a multiple of 4 KB)
+ *   16  ROM size in bytes
+ *   20  number of chunks
+ *   24  MD5 of the .z64 ROM (16 bytes)
+ *   40  file offset of each chunk, plus one for the end of the last chunk
+ *
+ * A chunk whose stored size equals its uncompressed size is kept raw.
+ *
+ * Only the first chunk stays in 'rom'; rom_resident_size says how much of
+ * the ROM that is (all of it for a flat image). Everything past it goes
+ * through an LRU cache of inflated chunks. Use rom_at()/rom_span() instead
+ * of indexing 'rom' for any offset that can lie beyond the ROM header. */
+
+#ifndef __ROMCHUNKS_H__
+#define __ROMCHUNKS_H__
+
+#include "api/m64p_types.h"
+#include "osal/preproc.h"
+#include "md5.h"
+#include "rom.h"
+
+#define ROMCHUNKS_MAGIC    "M64PCROM"
+#define ROMCHUNKS_VERSION  1
+#define ROMCHUNKS_HEADER   40
+
+extern unsigned int rom_resident_size;
+
+int romchunks_is_image(const unsigned char *image, unsigned int size);
+m64p_error romchunks_open(const unsigned char *image, unsigned int size,
+                          unsigned char **head, unsigned int *head_size,
+                          unsigned int *romsize, md5_byte_t *md5);
+unsigned char *romchunks_flatten(void);
+void romchunks_close(void);
+void romchunks_byteswap(void);
+
+unsigned char *romchunks_span(unsigned int offset, unsigned int *end);
+unsigned char *romchunks_exec(unsigned int offset);
+void romchunks_dma(unsigned int offset, unsigned int length, unsigned long long nanoseconds);
+
+void romchunks_reset_stats(void);
+m64p_error romchunks_stats_query(m64p_core_param param, int *rval);
+
+/* True when the ROM is a chunked image with part of it outside 'rom'. */
+static osal_inline int rom_is_chunked(void)
+{
+    return rom_resident_size < (unsigned int) rom_size;
+}
+
+/* Pointer to the ROM byte at 'offset', good until the next call into the
+ * cache. Words never straddle chunks, so a 32-bit read through it is safe. */
+static osal_inline unsigned char *rom_at(unsigned int offset)
+{
+    if (offset < rom_resident_size)
+        return rom + offset;
+    return romchunks_span(offset, NULL);
+}
+
+/* Like rom_at(), and also sets *end to the first offset that is not
+ * covered by the returned pointer. */
+static osal_inline unsigned char *rom_span(unsigned int offset, unsigned int *end)
+{
+    if (offset < rom_resident_size)
+    {
+        *end = rom_resident_size;
+        return rom + offset;
+    }
+    return romchunks_span(offset, end);
+}
+
+/* Instruction fetch from ROM: the pointer stays valid for the rest of the
+ * 4 KB page and the page after it, as the recompilers read whole pages. */
+static osal_inline unsigned int *rom_exec(unsigned int offset)
+{
+    if ((offset & ~0xFFF) + 0x2000 <= rom_resident_size)
+        return (unsigned int *) (rom + offset);
+    return (unsigned int *) romchunks_exec(offset);
+}
+
+#endif /* __ROMCHUNKS_H__ */
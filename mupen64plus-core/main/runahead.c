@@ -0,0 +1,169 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - runahead.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+#include "api/config.h"
+#include "api/m64p_config.h"
+
+#include "main.h"
+#include "movie.h"
+#include "runahead.h"
+#include "snapshot.h"
+#include "ticks.h"
+
+#include "plugin/dlist_capture.h"
+#include "plugin/video_thread.h"
+#include "r4300/interupt.h"
+
+#define RUNAHEAD_MAX_FRAMES   4
+#define RUNAHEAD_STATS_WINDOW 64    // number of frames over which the costs are averaged
+
+static int l_Frames = 0;            // frames to run ahead of the real timeline
+static int l_AheadLeft = 0;         // frames still to run before the snapshot is loaded back
+static core_snapshot *l_Snapshot = NULL;
+
+static unsigned int l_SaveTimes[RUNAHEAD_STATS_WINDOW];  // microseconds per snapshot
+static unsigned int l_LoadTimes[RUNAHEAD_STATS_WINDOW];  // microseconds per restore
+static int l_SaveCount = 0, l_SavePos = 0;
+static int l_LoadCount = 0, l_LoadPos = 0;
+
+static void record_time(unsigned int *times, int *count, int *pos, unsigned long long start)
+{
+    times[*pos] = (unsigned int) ((ticksGetNanoseconds() - start) / 1000);
+    *pos = (*pos + 1) % RUNAHEAD_STATS_WINDOW;
+    if (*count < RUNAHEAD_STATS_WINDOW)
+        (*count)++;
+}
+
+static unsigned int average_time(const unsigned int *times, int count)
+{
+    unsigned long long sum = 0;
+    int i;
+
+    if (count == 0)
+        return 0;
+    for (i = 0; i < count; i++)
+        sum += times[i];
+    return (unsigned int) (sum / count);
+}
+
+void runahead_init(void)
+{
+    runahead_set_frames(ConfigGetParamInt(g_CoreConfig, "RunAhead"));
+    l_AheadLeft = 0;
+    l_SaveCount = l_SavePos = 0;
+    l_LoadCount = l_LoadPos = 0;
+}
+
+void runahead_deinit(void)
+{
+    l_AheadLeft = 0;
+    snapshot_free(l_Snapshot);
+    l_Snapshot = NULL;
+}
+
+void runahead_set_frames(int frames)
+{
+    if (frames < 0)
+        frames = 0;
+    else if (frames > RUNAHEAD_MAX_FRAMES)
+        frames = RUNAHEAD_MAX_FRAMES;
+    l_Frames = frames;
+}
+
+int runahead_get_frames(void)
+{
+    return l_Frames;
+}
+
+int runahead_vi(void)
+{
+    unsigned long long start;
+
+    if (l_AheadLeft > 0)
+    {
+        if (--l_AheadLeft > 0)
+            return 0;
+
+        /* this is the frame to show; then back to the real timeline, where
+         * the VI which was snapshotted gets processed again, silently */
+        dlist_capture_UpdateScreen();
+        video_thread_sync();
+        start = ticksGetNanoseconds();
+        snapshot_load(l_Snapshot);
+        record_time(l_LoadTimes, &l_LoadCount, &l_LoadPos, start);
+        return 0;
+    }
+
+    /* a movie has to see the polls of the real timeline only */
+    if (l_Frames == 0 || interupt_unsafe_state || movie_active())
+        return RUNAHEAD_PRESENT | RUNAHEAD_REAL;
+
+    /* allocated once, when run-ahead is first used */
+    if (l_Snapshot == NULL)
+    {
+        l_Snapshot = snapshot_alloc();
+        if (l_Snapshot == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "couldn't allocate memory for run-ahead; disabling it");
+            l_Frames = 0;
+            return RUNAHEAD_PRESENT | RUNAHEAD_REAL;
+        }
+    }
+
+    video_thread_sync();
+    start = ticksGetNanoseconds();
+    if (!snapshot_save(l_Snapshot))
+        return RUNAHEAD_PRESENT | RUNAHEAD_REAL;
+    record_time(l_SaveTimes, &l_SaveCount, &l_SavePos, start);
+
+    l_AheadLeft = l_Frames;
+    return RUNAHEAD_REAL;
+}
+
+void runahead_reset(void)
+{
+    l_AheadLeft = 0;
+}
+
+int runahead_speculating(void)
+{
+    return l_AheadLeft > 0;
+}
+
+m64p_error runahead_stats_query(m64p_core_param param, int *rval)
+{
+    switch (param)
+    {
+        case M64CORE_RUNAHEAD_SAVE_TIME:
+            *rval = (int) average_time(l_SaveTimes, l_SaveCount);
+            break;
+        case M64CORE_RUNAHEAD_LOAD_TIME:
+            *rval = (int) average_time(l_LoadTimes, l_LoadCount);
+            break;
+        default:
+            return M64ERR_INPUT_INVALID;
+    }
+    return M64ERR_SUCCESS;
+}
@@ -0,0 +1,53 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - runahead.h                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Run-ahead: input latency reduction by emulating ahead of the real timeline.
+ *
+ * At each VI of the real timeline the machine is snapshotted, then run for
+ * RunAhead more frames with the new input, with nothing shown and audio
+ * muted. The last of those frames is shown, and the snapshot is loaded
+ * back so the real timeline goes on from where it stopped. A game which
+ * reacts to input on the next frame thus shows that reaction right away.
+ *
+ * Only the real frames poll input, are paced and reach the frontend's VI
+ * callback; the frames run ahead reuse the input of the last real one.
+ * Run-ahead is off while an input movie is recorded or played (movie.h). */
+
+#ifndef __RUNAHEAD_H__
+#define __RUNAHEAD_H__
+
+#include "api/m64p_types.h"
+
+/* what gen_interupt() does at a VI, as told by runahead_vi() */
+#define RUNAHEAD_PRESENT  1   // give the frame to the video plugin
+#define RUNAHEAD_REAL     2   // poll input, pace the frame and call the frontend
+
+void runahead_init(void);
+void runahead_deinit(void);
+void runahead_set_frames(int frames);
+int runahead_get_frames(void);
+
+int runahead_vi(void);
+void runahead_reset(void);
+int runahead_speculating(void);
+
+m64p_error runahead_stats_query(m64p_core_param param, int *rval);
+
+#endif /* __RUNAHEAD_H__ */
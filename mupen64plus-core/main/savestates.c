@@ -57,7 +57,9 @@
 #endif
 
 static const char* savestate_magic = "M64+SAVE";
-static const int savestate_latest_version = 0x00010000;  /* 1.0 */
+static const int savestate_latest_version = 0x00010100;  /* 1.1 */
+/* 1.0 states also carry the full 4 MB tlb_LUT_r and tlb_LUT_w tables. */
+static const int savestate_lut_version = 0x00010000;  /* 1.0 */
 static const unsigned char pj64_magic[4] = { 0xC8, 0xA6, 0xD8, 0x23 };
 
 static savestates_job job = savestates_job_nothing;
@@ -227,7 +229,7 @@ static int savestates_load_m64p(char *filepath)
     version = (version << 8) | *curr++;
     version = (version << 8) | *curr++;
     version = (version << 8) | *curr++;
-    if(version != 0x00010000)
+    if(version != savestate_latest_version && version != savestate_lut_version)
     {
         main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "State version (%08x) isn't compatible. Please update Mupen64Plus.", version);
         gzclose(f);
@@ -245,7 +247,9 @@ static int savestates_load_m64p(char *filepath)
     curr += 32;
 
     /* Read the rest of the savestate */
-    savestateSize = 16788244;
+    savestateSize = 8399636;
+    if (version == savestate_lut_version)
+        savestateSize += 0x800000;
     savestateData = curr = (unsigned char *)malloc(savestateSize);
     if (savestateData == NULL)
     {
@@ -387,8 +391,9 @@ static int savestates_load_m64p(char *filepath)
     flashram_info.erase_offset = GETDATA(curr, unsigned int);
     flashram_info.write_pointer = GETDATA(curr, unsigned int);
 
-    COPYARRAY(tlb_LUT_r, curr, unsigned int, 0x100000);
-    COPYARRAY(tlb_LUT_w, curr, unsigned int, 0x100000);
+    // The TLB lookup is rebuilt from tlb_e below
+    if (version == savestate_lut_version)
+        curr += 0x800000;
 
     llbit = GETDATA(curr, unsigned int);
     COPYARRAY(reg, curr, long long int, 32);
@@ -429,6 +434,10 @@ static int savestates_load_m64p(char *filepath)
         tlb_e[i].phys_odd = GETDATA(curr, unsigned int);
     }
 
+    tlb_clear();
+    for (i = 0; i < 32; i++)
+        tlb_map(&tlb_e[i]);
+
 #ifdef NEW_DYNAREC
     if (r4300emu == CORE_DYNAREC) {
         pcaddr = GETDATA(curr, unsigned int);
@@ -679,8 +688,7 @@ static int savestates_load_pj64(char *filepath, void *handle,
     si_register.si_stat = GETDATA(curr, unsigned int);
 
     // tlb
-    memset(tlb_LUT_r, 0, 0x400000);
-    memset(tlb_LUT_w, 0, 0x400000);
+    tlb_clear();
     for (i=0; i < 32; i++)
     {
         unsigned int MyPageMask, MyEntryHi, MyEntryLo0, MyEntryLo1;
@@ -1003,7 +1011,7 @@ static int savestates_save_m64p(char *filepath)
     queuelength = save_eventqueue_infos(queue);
 
     // Allocate memory for the save state data
-    save->size = 16788288 + queuelength;
+    save->size = 8399680 + queuelength;
     save->data = curr = malloc(save->size);
     if (save->data == NULL)
     {
@@ -1175,9 +1183,6 @@ static int savestates_save_m64p(char *filepath)
     PUTDATA(curr, unsigned int, flashram_info.erase_offset);
     PUTDATA(curr, unsigned int, flashram_info.write_pointer);
 
-    PUTARRAY(tlb_LUT_r, curr, unsigned int, 0x100000);
-    PUTARRAY(tlb_LUT_w, curr, unsigned int, 0x100000);
-
     PUTDATA(curr, unsigned int, llbit);
     PUTARRAY(reg, curr, long long int, 32);
     PUTARRAY(reg_cop0, curr, unsigned int, 32);
@@ -0,0 +1,229 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - snapshot.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+#include "memory/memory.h"
+#include "memory/flashram.h"
+#include "memory/tlb.h"
+#include "r4300/r4300.h"
+#include "r4300/macros.h"
+#include "r4300/interupt.h"
+#include "r4300/new_dynarec/new_dynarec.h"
+
+#define RDRAM_PAGES (0x800000 / 0x1000)
+
+struct _core_snapshot
+{
+    unsigned int rdram[0x800000/4];
+    unsigned int sp_mem[0x2000/4];
+    unsigned int pif_ram[0x40/4];
+
+    RDRAM_register rdram_register;
+    mips_register MI_register;
+    PI_register pi_register;
+    SP_register sp_register;
+    RSP_register rsp_register;
+    SI_register si_register;
+    VI_register vi_register;
+    RI_register ri_register;
+    AI_register ai_register;
+    DPC_register dpc_register;
+    DPS_register dps_register;
+    Flashram_info flashram_info;
+
+    long long int reg[32];
+    long long int hi, lo;
+    long long int reg_cop1_fgr_64[32];
+    unsigned int reg_cop0[32];
+    int FCR0, FCR31;
+    int rounding_mode;
+    int llbit;
+    tlb tlb_e[32];
+    unsigned int pc;
+
+    interupt_snapshot interupt;
+};
+
+core_snapshot *snapshot_alloc(void)
+{
+    return (core_snapshot *) malloc(sizeof(core_snapshot));
+}
+
+void snapshot_free(core_snapshot *snapshot)
+{
+    free(snapshot);
+}
+
+int snapshot_save(core_snapshot *snapshot)
+{
+    save_interupt_snapshot(&snapshot->interupt);
+    if (snapshot->interupt.num_events < 0)
+        return 0;
+
+    memcpy(snapshot->rdram, rdram, sizeof(snapshot->rdram));
+    memcpy(snapshot->sp_mem, SP_DMEM, sizeof(snapshot->sp_mem));
+    memcpy(snapshot->pif_ram, PIF_RAM, sizeof(snapshot->pif_ram));
+
+    snapshot->rdram_register = rdram_register;
+    snapshot->MI_register = MI_register;
+    snapshot->pi_register = pi_register;
+    snapshot->sp_register = sp_register;
+    snapshot->rsp_register = rsp_register;
+    snapshot->si_register = si_register;
+    snapshot->vi_register = vi_register;
+    snapshot->ri_register = ri_register;
+    snapshot->ai_register = ai_register;
+    snapshot->dpc_register = dpc_register;
+    snapshot->dps_register = dps_register;
+    snapshot->flashram_info = flashram_info;
+
+    /* the FPRs are copied as they are laid out for the current Status, and
+     * set_fpr_pointers() gets the same layout back on load */
+    memcpy(snapshot->reg, reg, sizeof(snapshot->reg));
+    snapshot->hi = hi;
+    snapshot->lo = lo;
+    memcpy(snapshot->reg_cop1_fgr_64, reg_cop1_fgr_64, sizeof(snapshot->reg_cop1_fgr_64));
+    memcpy(snapshot->reg_cop0, reg_cop0, sizeof(snapshot->reg_cop0));
+    snapshot->FCR0 = FCR0;
+    snapshot->FCR31 = FCR31;
+    snapshot->rounding_mode = rounding_mode;
+    snapshot->llbit = llbit;
+    memcpy(snapshot->tlb_e, tlb_e, sizeof(snapshot->tlb_e));
+
+#ifdef NEW_DYNAREC
+    if (r4300emu == CORE_DYNAREC)
+        snapshot->pc = pcaddr;
+    else
+        snapshot->pc = PC->addr;
+#else
+    snapshot->pc = PC->addr;
+#endif
+    return 1;
+}
+
+void snapshot_load(const core_snapshot *snapshot)
+{
+    unsigned int vi_status, vi_width, ai_dacrate;
+    int tlb_changed, page, i;
+
+    /* Only the RDRAM pages which differ are copied back, and only the code
+     * compiled from them is thrown away, rather than all of it as a
+     * savestate load does */
+    for (page = 0; page < RDRAM_PAGES; page++)
+    {
+        unsigned int *dst = rdram + page * (0x1000/4);
+        const unsigned int *src = snapshot->rdram + page * (0x1000/4);
+
+        if (memcmp(dst, src, 0x1000) == 0)
+            continue;
+        memcpy(dst, src, 0x1000);
+
+#ifdef NEW_DYNAREC
+        if (r4300emu == CORE_DYNAREC)
+        {
+            invalidate_block(0x80000 + page);
+            continue;
+        }
+#endif
+        if (r4300emu != CORE_PURE_INTERPRETER)
+        {
+            invalid_code[0x80000 + page] = 1;
+            invalid_code[0xa0000 + page] = 1;
+        }
+    }
+    memcpy(SP_DMEM, snapshot->sp_mem, sizeof(snapshot->sp_mem));
+    memcpy(PIF_RAM, snapshot->pif_ram, sizeof(snapshot->pif_ram));
+
+    rdram_register = snapshot->rdram_register;
+    MI_register = snapshot->MI_register;
+    pi_register = snapshot->pi_register;
+    sp_register = snapshot->sp_register;
+    rsp_register = snapshot->rsp_register;
+    si_register = snapshot->si_register;
+    ri_register = snapshot->ri_register;
+    dpc_register = snapshot->dpc_register;
+    dps_register = snapshot->dps_register;
+    flashram_info = snapshot->flashram_info;
+
+    /* the plugins are only told about the registers they watch if those changed */
+    vi_status = vi_register.vi_status;
+    vi_width = vi_register.vi_width;
+    ai_dacrate = ai_register.ai_dacrate;
+    vi_register = snapshot->vi_register;
+    ai_register = snapshot->ai_register;
+    if (vi_register.vi_status != vi_status)
+        update_vi_status(vi_register.vi_status);
+    if (vi_register.vi_width != vi_width)
+        update_vi_width(vi_register.vi_width);
+    if (ai_register.ai_dacrate != ai_dacrate)
+        update_ai_dacrate(ai_register.ai_dacrate);
+
+    memcpy(reg, snapshot->reg, sizeof(reg));
+    hi = snapshot->hi;
+    lo = snapshot->lo;
+    memcpy(reg_cop0, snapshot->reg_cop0, sizeof(reg_cop0));
+    memcpy(reg_cop1_fgr_64, snapshot->reg_cop1_fgr_64, sizeof(reg_cop1_fgr_64));
+    set_fpr_pointers(Status);  // Status is reg_cop0[12]
+    FCR0 = snapshot->FCR0;
+    FCR31 = snapshot->FCR31;
+    rounding_mode = snapshot->rounding_mode;
+    llbit = snapshot->llbit;
+
+    tlb_changed = memcmp(tlb_e, snapshot->tlb_e, sizeof(tlb_e)) != 0;
+    if (tlb_changed)
+    {
+        memcpy(tlb_e, snapshot->tlb_e, sizeof(tlb_e));
+        tlb_clear();
+        for (i = 0; i < 32; i++)
+            tlb_map(&tlb_e[i]);
+    }
+
+#ifdef NEW_DYNAREC
+    if (r4300emu == CORE_DYNAREC) {
+        if (tlb_changed)
+            invalidate_all_pages();
+        pcaddr = snapshot->pc;
+        pending_exception = 1;
+    } else {
+        if (tlb_changed && r4300emu != CORE_PURE_INTERPRETER)
+            memset(invalid_code, 1, 0x100000);
+        generic_jump_to(snapshot->pc);
+    }
+#else
+    if (tlb_changed && r4300emu != CORE_PURE_INTERPRETER)
+        memset(invalid_code, 1, 0x100000);
+    generic_jump_to(snapshot->pc);
+#endif
+
+    load_interupt_snapshot(&snapshot->interupt);
+
+#ifdef NEW_DYNAREC
+    if (r4300emu == CORE_DYNAREC)
+        last_addr = pcaddr;
+    else
+        last_addr = PC->addr;
+#else
+    last_addr = PC->addr;
+#endif
+}
@@ -0,0 +1,46 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - snapshot.h                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* In-memory snapshots of the emulated machine.
+ *
+ * A snapshot holds what a savestate holds, as raw copies of the core's own
+ * variables: no header, no byte swapping, no compression and no allocation
+ * once the snapshot exists. It is meant for taking and restoring the state
+ * every frame (see runahead.c); savestates.c stays the way to put a state in
+ * a file.
+ *
+ * Like a savestate, a snapshot must be taken and loaded from gen_interupt(),
+ * where the R4300 is between instructions, and with the video thread synced.
+ * It doesn't cover the plugins or the save memories (EEPROM, SRAM, FlashRAM
+ * and controller paks), which live in their files. */
+
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+typedef struct _core_snapshot core_snapshot;
+
+core_snapshot *snapshot_alloc(void);
+void snapshot_free(core_snapshot *snapshot);
+
+/* returns 0 if the machine can't be captured right now */
+int snapshot_save(core_snapshot *snapshot);
+void snapshot_load(const core_snapshot *snapshot);
+
+#endif /* __SNAPSHOT_H__ */
@@ -1,4 +1,5 @@
 #include <time.h>
+#include <sched.h>
 
 static struct timespec startTicks;
 
@@ -14,3 +15,30 @@ unsigned int ticksGetTicks()
 	return (now.tv_sec - startTicks.tv_sec) * 1000 +
 			(now.tv_nsec - startTicks.tv_nsec) / 1000000;
 }
+
+unsigned long long ticksGetNanoseconds()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/* Sleep until the monotonic clock reaches 'deadline'. The scheduler is only
+ * trusted for the bulk of the wait; the last 'spin' nanoseconds are covered
+ * by yielding in a loop so that oversleeping can't make us miss the deadline. */
+void ticksWaitUntil(unsigned long long deadline, unsigned long long spin)
+{
+	unsigned long long now = ticksGetNanoseconds();
+
+	if (deadline > now + spin)
+	{
+		struct timespec req;
+		unsigned long long sleep = deadline - now - spin;
+		req.tv_sec = sleep / 1000000000ULL;
+		req.tv_nsec = sleep % 1000000000ULL;
+		nanosleep(&req, NULL);
+	}
+
+	while (ticksGetNanoseconds() < deadline)
+		sched_yield();
+}
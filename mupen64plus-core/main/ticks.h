@@ -7,6 +7,8 @@ extern "C" {
 
 void ticksInitialize();
 unsigned int ticksGetTicks();
+unsigned long long ticksGetNanoseconds();
+void ticksWaitUntil(unsigned long long deadline, unsigned long long spin);
 
 #ifdef __cplusplus
 }
@@ -25,7 +25,7 @@
 #include "list.h"
 #include "osal/preproc.h"
 
-struct work_struct *work;
+struct work_struct;
 typedef void (*work_func_t)(struct work_struct *work);
 struct work_struct {
     work_func_t func;
@@ -42,7 +42,9 @@
 #include "api/callbacks.h"
 #include "main/main.h"
 #include "main/rom.h"
+#include "main/romchunks.h"
 #include "main/util.h"
+#include "main/ticks.h"
 
 static unsigned char sram[0x8000];
 int delay_si = 0;
@@ -136,6 +138,10 @@ void dma_pi_write(void)
 {
     unsigned int longueur;
     int i;
+    unsigned int cart, span_start = 0, span_end = 0;
+    unsigned char *span = NULL;
+    unsigned long long dma_start = 0;
+    int chunked;
 
     if (pi_register.pi_cart_addr_reg < 0x10000000)
     {
@@ -202,14 +208,24 @@ void dma_pi_write(void)
         return;
     }
 
+    cart = (pi_register.pi_cart_addr_reg-0x10000000)&0x3FFFFFF;
+    chunked = rom_is_chunked();
+    if (chunked)
+        dma_start = ticksGetNanoseconds();
+
     if (r4300emu != CORE_PURE_INTERPRETER)
     {
         for (i=0; i<(int)longueur; i++)
         {
             unsigned long rdram_address1 = pi_register.pi_dram_addr_reg+i+0x80000000;
             unsigned long rdram_address2 = pi_register.pi_dram_addr_reg+i+0xa0000000;
+            if (cart+i >= span_end)
+            {
+                span_start = (cart+i) & ~3;
+                span = rom_span(span_start, &span_end);
+            }
             ((unsigned char*)rdram)[(pi_register.pi_dram_addr_reg+i)^S8]=
-                rom[(((pi_register.pi_cart_addr_reg-0x10000000)&0x3FFFFFF)+i)^S8];
+                span[((cart+i)^S8) - span_start];
 
             if (!invalid_code[rdram_address1>>12])
             {
@@ -238,11 +254,19 @@ void dma_pi_write(void)
     {
         for (i=0; i<(int)longueur; i++)
         {
+            if (cart+i >= span_end)
+            {
+                span_start = (cart+i) & ~3;
+                span = rom_span(span_start, &span_end);
+            }
             ((unsigned char*)rdram)[(pi_register.pi_dram_addr_reg+i)^S8]=
-                rom[(((pi_register.pi_cart_addr_reg-0x10000000)&0x3FFFFFF)+i)^S8];
+                span[((cart+i)^S8) - span_start];
         }
     }
 
+    if (chunked)
+        romchunks_dma(cart, longueur, ticksGetNanoseconds() - dma_start);
+
     // Set the RDRAM memory size when copying main ROM code
     // (This is just a convenient way to run this code once at the beginning)
     if (pi_register.pi_cart_addr_reg == 0x10001000)
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 #include <errno.h>
 
@@ -45,8 +46,11 @@
 #include "api/callbacks.h"
 #include "main/main.h"
 #include "main/rom.h"
+#include "main/romchunks.h"
+#include "main/runahead.h"
 #include "osal/preproc.h"
 #include "plugin/plugin.h"
+#include "plugin/video_thread.h"
 #include "r4300/new_dynarec/new_dynarec.h"
 
 #ifdef DBG
@@ -130,9 +134,17 @@ unsigned int *readdps[0x10000];
 
 // the frameBufferInfos
 static FrameBufferInfo frameBufferInfos[6];
-static char framebufferRead[0x800];
+static FrameBufferInfo lastFrameBufferInfos[6];
 static int firstFrameBufferSetting;
 
+// per 4KB page of rdram: is it covered by a frame buffer ?
+#define FB_PAGE_HOOKED  0x01 // page overlaps at least one frame buffer
+#define FB_PAGE_PARTIAL 0x02 // a frame buffer begins or ends inside the page
+#define FB_PAGE_READ    0x04 // next cpu read of the page must be reported
+static unsigned char framebufferPage[0x800];
+// per 64KB page: are the FB handlers currently installed in the mem tables ?
+static unsigned char framebufferHooked[0x80];
+
 // uncomment to output count of calls to write_rdram():
 //#define COUNT_WRITE_RDRAM_CALLS 1
 
@@ -148,7 +160,8 @@ int init_memory(int DoByteSwap)
     {
         //swap rom
         unsigned int *roml = (unsigned int *) rom;
-        for (i=0; i<(rom_size/4); i++) roml[i] = sl(roml[i]);
+        for (i=0; i<(int)(rom_resident_size/4); i++) roml[i] = sl(roml[i]);
+        romchunks_byteswap();
     }
 
     //init hash tables
@@ -984,6 +997,9 @@ int init_memory(int DoByteSwap)
     init_flashram();
 
     frameBufferInfos[0].addr = 0;
+    memset(lastFrameBufferInfos, 0, sizeof(lastFrameBufferInfos));
+    memset(framebufferPage, 0, sizeof(framebufferPage));
+    memset(framebufferHooked, 0, sizeof(framebufferHooked));
     fast_memory = 1;
     firstFrameBufferSetting = 1;
 
@@ -1155,6 +1171,125 @@ void make_w_sp_status_reg(void)
         sp_register.w_sp_status_reg |= 0x1000000;
 }
 
+static void set_rdram_fb_handlers(int j, int hook)
+{
+#ifdef DBG
+    int rbreak8 = lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
+                                    BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1;
+    int rbreaka = lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
+                                    BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1;
+    int wbreak8 = lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
+                                    BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1;
+    int wbreaka = lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
+                                    BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1;
+#define SET_FB_HANDLERS(table, base, brk, plain, fb) \
+    table[base+j] = hook ? (brk ? fb##_break : fb) : (brk ? plain##_break : plain)
+#else
+#define SET_FB_HANDLERS(table, base, brk, plain, fb) \
+    table[base+j] = hook ? fb : plain
+#endif
+
+    SET_FB_HANDLERS(readmem,   0x8000, rbreak8, read_rdram,   read_rdramFB);
+    SET_FB_HANDLERS(readmemb,  0x8000, rbreak8, read_rdramb,  read_rdramFBb);
+    SET_FB_HANDLERS(readmemh,  0x8000, rbreak8, read_rdramh,  read_rdramFBh);
+    SET_FB_HANDLERS(readmemd,  0x8000, rbreak8, read_rdramd,  read_rdramFBd);
+    SET_FB_HANDLERS(readmem,   0xa000, rbreaka, read_rdram,   read_rdramFB);
+    SET_FB_HANDLERS(readmemb,  0xa000, rbreaka, read_rdramb,  read_rdramFBb);
+    SET_FB_HANDLERS(readmemh,  0xa000, rbreaka, read_rdramh,  read_rdramFBh);
+    SET_FB_HANDLERS(readmemd,  0xa000, rbreaka, read_rdramd,  read_rdramFBd);
+    SET_FB_HANDLERS(writemem,  0x8000, wbreak8, write_rdram,  write_rdramFB);
+    SET_FB_HANDLERS(writememb, 0x8000, wbreak8, write_rdramb, write_rdramFBb);
+    SET_FB_HANDLERS(writememh, 0x8000, wbreak8, write_rdramh, write_rdramFBh);
+    SET_FB_HANDLERS(writememd, 0x8000, wbreak8, write_rdramd, write_rdramFBd);
+    SET_FB_HANDLERS(writemem,  0xa000, wbreaka, write_rdram,  write_rdramFB);
+    SET_FB_HANDLERS(writememb, 0xa000, wbreaka, write_rdramb, write_rdramFBb);
+    SET_FB_HANDLERS(writememh, 0xa000, wbreaka, write_rdramh, write_rdramFBh);
+    SET_FB_HANDLERS(writememd, 0xa000, wbreaka, write_rdramd, write_rdramFBd);
+#undef SET_FB_HANDLERS
+}
+
+// called after each graphic task with the frame buffers reported by the
+// video plugin. The page map and the mem tables are only rebuilt when the
+// frame buffers actually moved; otherwise the read flags are just re-armed.
+static void update_frame_buffer_pages(void)
+{
+    unsigned char hooked[0x80];
+    int i, j;
+
+    if (memcmp(frameBufferInfos, lastFrameBufferInfos, sizeof(frameBufferInfos)) != 0)
+    {
+        memcpy(lastFrameBufferInfos, frameBufferInfos, sizeof(frameBufferInfos));
+        memset(framebufferPage, 0, sizeof(framebufferPage));
+        memset(hooked, 0, sizeof(hooked));
+
+        for (i=0; i<6 && frameBufferInfos[0].addr; i++)
+        {
+            unsigned int start, end;
+            if (!frameBufferInfos[i].addr) continue;
+            start = frameBufferInfos[i].addr & 0x7FFFFF;
+            end = start + frameBufferInfos[i].width*
+                          frameBufferInfos[i].height*
+                          frameBufferInfos[i].size - 1;
+            if (end > 0x7FFFFF) end = 0x7FFFFF;
+            if (end < start) continue;
+
+            for (j=start>>12; j<=(int)(end>>12); j++)
+                framebufferPage[j] |= FB_PAGE_HOOKED;
+            if (start & 0xFFF) framebufferPage[start>>12] |= FB_PAGE_PARTIAL;
+            if ((end & 0xFFF) != 0xFFF) framebufferPage[end>>12] |= FB_PAGE_PARTIAL;
+            for (j=start>>16; j<=(int)(end>>16); j++)
+                hooked[j] = 1;
+
+            if (firstFrameBufferSetting)
+            {
+                firstFrameBufferSetting = 0;
+                fast_memory = 0;
+                for (j=0; j<0x100000; j++)
+                    invalid_code[j] = 1;
+            }
+        }
+
+        // only touch the mem tables for the 64KB pages whose state changed
+        for (j=0; j<0x80; j++)
+        {
+            if (hooked[j] != framebufferHooked[j])
+            {
+                set_rdram_fb_handlers(j, hooked[j]);
+                framebufferHooked[j] = hooked[j];
+            }
+        }
+    }
+
+    for (j=0; j<0x800; j++)
+        if (framebufferPage[j] & FB_PAGE_HOOKED)
+            framebufferPage[j] |= FB_PAGE_READ;
+}
+
+static int frame_buffer_access(unsigned int addr)
+{
+    int i;
+    unsigned char flags = framebufferPage[(addr & 0x7FFFFF) >> 12];
+
+    if (!(flags & FB_PAGE_PARTIAL))
+        return flags & FB_PAGE_HOOKED;
+
+    // boundary page: fall back to the exact ranges
+    addr &= 0x7FFFFF;
+    for (i=0; i<6; i++)
+    {
+        if (frameBufferInfos[i].addr)
+        {
+            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
+            unsigned int end = start + frameBufferInfos[i].width*
+                               frameBufferInfos[i].height*
+                               frameBufferInfos[i].size - 1;
+            if (addr >= start && addr <= end)
+                return 1;
+        }
+    }
+    return 0;
+}
+
 static void do_SP_Task(void)
 {
     int save_pc = rsp_register.rsp_pc & ~0xFFF;
@@ -1166,100 +1301,6 @@ static void do_SP_Task(void)
             // the task will be done when DP is unfreezed (see update_DPC)
             return;
         }
-        
-        // unprotecting old frame buffers
-        if (gfx.fBGetFrameBufferInfo && gfx.fBRead && gfx.fBWrite &&
-                frameBufferInfos[0].addr)
-        {
-            int i;
-            for (i=0; i<6; i++)
-            {
-                if (frameBufferInfos[i].addr)
-                {
-                    int j;
-                    int start = frameBufferInfos[i].addr & 0x7FFFFF;
-                    int end = start + frameBufferInfos[i].width*
-                              frameBufferInfos[i].height*
-                              frameBufferInfos[i].size - 1;
-                    start = start >> 16;
-                    end = end >> 16;
-
-                    for (j=start; j<=end; j++)
-                    {
-#ifdef DBG
-                        if (lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1)
-                        {
-                            readmem[0x8000+j] = read_rdram_break;
-                            readmemb[0x8000+j] = read_rdramb_break;
-                            readmemh[0x8000+j] = read_rdramh_break;
-                            readmemd[0xa000+j] = read_rdramd_break;
-                        }
-                        else
-                        {
-#endif
-                            readmem[0x8000+j] = read_rdram;
-                            readmemb[0x8000+j] = read_rdramb;
-                            readmemh[0x8000+j] = read_rdramh;
-                            readmemd[0xa000+j] = read_rdramd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1)
-                        {
-                            readmem[0xa000+j] = read_rdram_break;
-                            readmemb[0xa000+j] = read_rdramb_break;
-                            readmemh[0xa000+j] = read_rdramh_break;
-                            readmemd[0x8000+j] = read_rdramd_break;
-                        }
-                        else
-                        {
-#endif
-                            readmem[0xa000+j] = read_rdram;
-                            readmemb[0xa000+j] = read_rdramb;
-                            readmemh[0xa000+j] = read_rdramh;
-                            readmemd[0x8000+j] = read_rdramd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1)
-                        {
-                            writemem[0x8000+j] = write_rdram_break;
-                            writememb[0x8000+j] = write_rdramb_break;
-                            writememh[0x8000+j] = write_rdramh_break;
-                            writememd[0x8000+j] = write_rdramd_break;
-                        }
-                        else
-                        {
-#endif
-                            writemem[0x8000+j] = write_rdram;
-                            writememb[0x8000+j] = write_rdramb;
-                            writememh[0x8000+j] = write_rdramh;
-                            writememd[0x8000+j] = write_rdramd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1)
-                        {
-                            writemem[0xa000+j] = write_rdram_break;
-                            writememb[0xa000+j] = write_rdramb_break;
-                            writememh[0xa000+j] = write_rdramh_break;
-                            writememd[0xa000+j] = write_rdramd_break;
-                        }
-                        else
-                        {
-#endif
-                            writemem[0xa000+j] = write_rdram;
-                            writememb[0xa000+j] = write_rdramb;
-                            writememh[0xa000+j] = write_rdramh;
-                            writememd[0xa000+j] = write_rdramd;
-#ifdef DBG
-                        }
-#endif
-                    }
-                }
-            }
-        }
 
         //gfx.processDList();
         rsp_register.rsp_pc &= 0xFFF;
@@ -1272,121 +1313,16 @@ static void do_SP_Task(void)
         update_count();
         if (MI_register.mi_intr_reg & 0x1)
             add_interupt_event(SP_INT, 1000);
-        if (MI_register.mi_intr_reg & 0x20)
+        if (video_thread_dlist_queued() || (MI_register.mi_intr_reg & 0x20))
             add_interupt_event(DP_INT, 1000);
         MI_register.mi_intr_reg &= ~0x21;
         sp_register.sp_status_reg &= ~0x303;
 
         // protecting new frame buffers
         if (gfx.fBGetFrameBufferInfo && gfx.fBRead && gfx.fBWrite)
-            gfx.fBGetFrameBufferInfo(frameBufferInfos);
-        if (gfx.fBGetFrameBufferInfo && gfx.fBRead && gfx.fBWrite
-                && frameBufferInfos[0].addr)
         {
-            int i;
-            for (i=0; i<6; i++)
-            {
-                if (frameBufferInfos[i].addr)
-                {
-                    int j;
-                    int start = frameBufferInfos[i].addr & 0x7FFFFF;
-                    int end = start + frameBufferInfos[i].width*
-                              frameBufferInfos[i].height*
-                              frameBufferInfos[i].size - 1;
-                    int start1 = start;
-                    int end1 = end;
-                    start >>= 16;
-                    end >>= 16;
-                    for (j=start; j<=end; j++)
-                    {
-#ifdef DBG
-                        if (lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1)
-                        {
-                            readmem[0x8000+j] = read_rdramFB_break;
-                            readmemb[0x8000+j] = read_rdramFBb_break;
-                            readmemh[0x8000+j] = read_rdramFBh_break;
-                            readmemd[0xa000+j] = read_rdramFBd_break;
-                        }
-                        else
-                        {
-#endif
-                            readmem[0x8000+j] = read_rdramFB;
-                            readmemb[0x8000+j] = read_rdramFBb;
-                            readmemh[0x8000+j] = read_rdramFBh;
-                            readmemd[0xa000+j] = read_rdramFBd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_READ ) != -1)
-                        {
-                            readmem[0xa000+j] = read_rdramFB_break;
-                            readmemb[0xa000+j] = read_rdramFBb_break;
-                            readmemh[0xa000+j] = read_rdramFBh_break;
-                            readmemd[0x8000+j] = read_rdramFBd_break;
-                        }
-                        else
-                        {
-#endif
-                            readmem[0xa000+j] = read_rdramFB;
-                            readmemb[0xa000+j] = read_rdramFBb;
-                            readmemh[0xa000+j] = read_rdramFBh;
-                            readmemd[0x8000+j] = read_rdramFBd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0x80000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1)
-                        {
-                            writemem[0x8000+j] = write_rdramFB_break;
-                            writememb[0x8000+j] = write_rdramFBb_break;
-                            writememh[0x8000+j] = write_rdramFBh_break;
-                            writememd[0x8000+j] = write_rdramFBd_break;
-                        }
-                        else
-                        {
-#endif
-                            writemem[0x8000+j] = write_rdramFB;
-                            writememb[0x8000+j] = write_rdramFBb;
-                            writememh[0x8000+j] = write_rdramFBh;
-                            writememd[0x8000+j] = write_rdramFBd;
-#ifdef DBG
-                        }
-                        if (lookup_breakpoint(0xa0000000 + j * 0x10000, 0x10000,
-                                              BPT_FLAG_ENABLED |  BPT_FLAG_WRITE ) != -1)
-                        {
-                            writemem[0xa000+j] = write_rdramFB_break;
-                            writememb[0xa000+j] = write_rdramFBb_break;
-                            writememh[0xa000+j] = write_rdramFBh_break;
-                            writememd[0xa000+j] = write_rdramFBd_break;
-                        }
-                        else
-                        {
-#endif
-                            writemem[0xa000+j] = write_rdramFB;
-                            writememb[0xa000+j] = write_rdramFBb;
-                            writememh[0xa000+j] = write_rdramFBh;
-                            writememd[0xa000+j] = write_rdramFBd;
-#ifdef DBG
-                        }
-#endif
-                    }
-                    start <<= 4;
-                    end <<= 4;
-                    for (j=start; j<=end; j++)
-                    {
-                        if (j>=start1 && j<=end1) framebufferRead[j]=1;
-                        else framebufferRead[j] = 0;
-                    }
-
-                    if (firstFrameBufferSetting)
-                    {
-                        firstFrameBufferSetting = 0;
-                        fast_memory = 0;
-                        for (j=0; j<0x100000; j++)
-                            invalid_code[j] = 1;
-                    }
-                }
-            }
+            gfx.fBGetFrameBufferInfo(frameBufferInfos);
+            update_frame_buffer_pages();
         }
     }
     else if (SP_DMEM[0xFC0/4] == 2)
@@ -1674,88 +1610,44 @@ void read_rdramd(void)
 
 void read_rdramFB(void)
 {
-    int i;
-    for (i=0; i<6; i++)
+    unsigned char *page = &framebufferPage[(address & 0x7FFFFF)>>12];
+    if ((*page & FB_PAGE_READ) && frame_buffer_access(address))
     {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end &&
-                    framebufferRead[(address & 0x7FFFFF)>>12])
-            {
-                gfx.fBRead(address);
-                framebufferRead[(address & 0x7FFFFF)>>12] = 0;
-            }
-        }
+        gfx.fBRead(address);
+        *page &= ~FB_PAGE_READ;
     }
     read_rdram();
 }
 
 void read_rdramFBb(void)
 {
-    int i;
-    for (i=0; i<6; i++)
+    unsigned char *page = &framebufferPage[(address & 0x7FFFFF)>>12];
+    if ((*page & FB_PAGE_READ) && frame_buffer_access(address))
     {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end &&
-                    framebufferRead[(address & 0x7FFFFF)>>12])
-            {
-                gfx.fBRead(address);
-                framebufferRead[(address & 0x7FFFFF)>>12] = 0;
-            }
-        }
+        gfx.fBRead(address);
+        *page &= ~FB_PAGE_READ;
     }
     read_rdramb();
 }
 
 void read_rdramFBh(void)
 {
-    int i;
-    for (i=0; i<6; i++)
+    unsigned char *page = &framebufferPage[(address & 0x7FFFFF)>>12];
+    if ((*page & FB_PAGE_READ) && frame_buffer_access(address))
     {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end &&
-                    framebufferRead[(address & 0x7FFFFF)>>12])
-            {
-                gfx.fBRead(address);
-                framebufferRead[(address & 0x7FFFFF)>>12] = 0;
-            }
-        }
+        gfx.fBRead(address);
+        *page &= ~FB_PAGE_READ;
     }
     read_rdramh();
 }
 
 void read_rdramFBd(void)
 {
-    int i;
-    for (i=0; i<6; i++)
+    unsigned char *page = &framebufferPage[(address & 0x7FFFFF)>>12];
+    if ((*page & FB_PAGE_READ) && frame_buffer_access(address))
     {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end &&
-                    framebufferRead[(address & 0x7FFFFF)>>12])
-            {
-                gfx.fBRead(address);
-                framebufferRead[(address & 0x7FFFFF)>>12] = 0;
-            }
-        }
+        gfx.fBRead(address);
+        *page &= ~FB_PAGE_READ;
     }
     read_rdramd();
 }
@@ -1787,73 +1679,29 @@ void write_rdramd(void)
 
 void write_rdramFB(void)
 {
-    int i;
-    for (i=0; i<6; i++)
-    {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end)
-                gfx.fBWrite(address, 4);
-        }
-    }
+    if (frame_buffer_access(address))
+        gfx.fBWrite(address, 4);
     write_rdram();
 }
 
 void write_rdramFBb(void)
 {
-    int i;
-    for (i=0; i<6; i++)
-    {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end)
-                gfx.fBWrite(address^S8, 1);
-        }
-    }
+    if (frame_buffer_access(address))
+        gfx.fBWrite(address^S8, 1);
     write_rdramb();
 }
 
 void write_rdramFBh(void)
 {
-    int i;
-    for (i=0; i<6; i++)
-    {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end)
-                gfx.fBWrite(address^S16, 2);
-        }
-    }
+    if (frame_buffer_access(address))
+        gfx.fBWrite(address^S16, 2);
     write_rdramh();
 }
 
 void write_rdramFBd(void)
 {
-    int i;
-    for (i=0; i<6; i++)
-    {
-        if (frameBufferInfos[i].addr)
-        {
-            unsigned int start = frameBufferInfos[i].addr & 0x7FFFFF;
-            unsigned int end = start + frameBufferInfos[i].width*
-                               frameBufferInfos[i].height*
-                               frameBufferInfos[i].size - 1;
-            if ((address & 0x7FFFFF) >= start && (address & 0x7FFFFF) <= end)
-                gfx.fBWrite(address, 8);
-        }
-    }
+    if (frame_buffer_access(address))
+        gfx.fBWrite(address, 8);
     write_rdramd();
 }
 
@@ -2226,6 +2074,8 @@ void write_rspd(void)
 
 void read_dp(void)
 {
+    if (*address_low == 0xc) // DPC_STATUS: the game may be waiting for the display list to be done
+        video_thread_sync();
     *rdword = *(readdp[*address_low]);
 }
 
@@ -2851,7 +2701,8 @@ void write_ai(void)
     {
     case 0x4:
         ai_register.ai_len = word;
-        audio.aiLenChanged();
+        if (!runahead_speculating())  // frames run ahead are not heard
+            audio.aiLenChanged();
 
         freq = ROM_PARAMS.aidacrate / (ai_register.ai_dacrate+1);
         if (freq)
@@ -2909,7 +2760,8 @@ void write_aib(void)
         *((unsigned char*)&temp
           + ((*address_low&3)^S8) ) = cpu_byte;
         ai_register.ai_len = temp;
-        audio.aiLenChanged();
+        if (!runahead_speculating())
+            audio.aiLenChanged();
 
         delay = (unsigned int) (((unsigned long long)ai_register.ai_len*(ai_register.ai_dacrate+1)*
                                     vi_register.vi_delay*ROM_PARAMS.vilimit)/ROM_PARAMS.aidacrate);
@@ -2969,7 +2821,8 @@ void write_aih(void)
         *((unsigned short*)((unsigned char*)&temp
                             + ((*address_low&3)^S16) )) = hword;
         ai_register.ai_len = temp;
-        audio.aiLenChanged();
+        if (!runahead_speculating())
+            audio.aiLenChanged();
 
         delay = (unsigned int) (((unsigned long long)ai_register.ai_len*(ai_register.ai_dacrate+1)*
                                     vi_register.vi_delay*ROM_PARAMS.vilimit)/ROM_PARAMS.aidacrate);
@@ -3020,7 +2873,8 @@ void write_aid(void)
     case 0x0:
         ai_register.ai_dram_addr = (unsigned int) (dword >> 32);
         ai_register.ai_len = (unsigned int) (dword & 0xFFFFFFFF);
-        audio.aiLenChanged();
+        if (!runahead_speculating())
+            audio.aiLenChanged();
 
         delay = (unsigned int) (((unsigned long long)ai_register.ai_len*(ai_register.ai_dacrate+1)*
                                     vi_register.vi_delay*ROM_PARAMS.vilimit)/ROM_PARAMS.aidacrate);
@@ -3533,23 +3387,23 @@ void read_rom(void)
         lastwrite = 0;
     }
     else
-        *rdword = *((unsigned int *)(rom + (address & 0x03FFFFFF)));
+        *rdword = *((unsigned int *)rom_at(address & 0x03FFFFFF));
 }
 
 void read_romb(void)
 {
-    *rdword = *(rom + ((address^S8) & 0x03FFFFFF));
+    *rdword = *rom_at((address^S8) & 0x03FFFFFF);
 }
 
 void read_romh(void)
 {
-    *rdword = *((unsigned short *)(rom + ((address^S16) & 0x03FFFFFF)));
+    *rdword = *((unsigned short *)rom_at((address^S16) & 0x03FFFFFF));
 }
 
 void read_romd(void)
 {
-    *rdword = ((unsigned long long)(*((unsigned int *)(rom+(address&0x03FFFFFF))))<<32)|
-              *((unsigned int *)(rom + ((address+4)&0x03FFFFFF)));
+    *rdword = ((unsigned long long)(*((unsigned int *)rom_at(address&0x03FFFFFF))))<<32;
+    *rdword |= *((unsigned int *)rom_at((address+4)&0x03FFFFFF));
 }
 
 void write_rom(void)
@@ -3707,7 +3561,7 @@ unsigned int *fast_mem_access(unsigned int address)
         address = virtual_to_physical_address(address, 2);
 
     if ((address & 0x1FFFFFFF) >= 0x10000000)
-        return (unsigned int *)rom + ((address & 0x1FFFFFFF) - 0x10000000)/4;
+        return rom_exec(((address & 0x1FFFFFFF) - 0x10000000) & ~3);
     else if ((address & 0x1FFFFFFF) < 0x800000)
         return (unsigned int *)rdram + (address & 0x1FFFFFFF)/4;
     else if (address >= 0xa4000000 && address <= 0xa4001000)
@@ -35,6 +35,7 @@
 #include "api/callbacks.h"
 #include "api/debugger.h"
 #include "main/main.h"
+#include "main/movie.h"
 #include "main/rom.h"
 #include "main/util.h"
 #include "plugin/plugin.h"
@@ -306,7 +307,7 @@ static void internal_ReadController(int Control, unsigned char *Command)
         if (Controls[Control].Present)
         {
             BUTTONS Keys;
-            input.getKeys(Control, &Keys);
+            movie_get_keys(Control, &Keys);
             *((unsigned int *)(Command + 3)) = Keys.Value;
 #ifdef COMPARE_CORE
             CoreCompareDataSync(4, Command+3);
@@ -321,7 +322,7 @@ static void internal_ReadController(int Control, unsigned char *Command)
         {
             if (Controls[Control].Plugin == PLUGIN_RAW)
                 if (input.readController)
-                    input.readController(Control, Command);
+                    movie_read_controller(Control, Command);
         }
         break;
     case 3: // write controller pack
@@ -332,7 +333,7 @@ static void internal_ReadController(int Control, unsigned char *Command)
         {
             if (Controls[Control].Plugin == PLUGIN_RAW)
                 if (input.readController)
-                    input.readController(Control, Command);
+                    movie_read_controller(Control, Command);
         }
         break;
     }
@@ -413,7 +414,7 @@ static void internal_ControllerCommand(int Control, unsigned char *Command)
                 DebugMessage(M64MSG_INFO, "internal_ControllerCommand() Channel %i Command 2 controllerCommand (in Input plugin)", Control);
 #endif
                 if (input.controllerCommand)
-                    input.controllerCommand(Control, Command);
+                    movie_controller_command(Control, Command);
                 break;
             default:
 #ifdef DEBUG_PIF
@@ -457,7 +458,7 @@ static void internal_ControllerCommand(int Control, unsigned char *Command)
                 DebugMessage(M64MSG_INFO, "internal_ControllerCommand() Channel %i Command 3 controllerCommand (in Input plugin)", Control);
 #endif
                 if (input.controllerCommand)
-                    input.controllerCommand(Control, Command);
+                    movie_controller_command(Control, Command);
                 break;
             default:
 #ifdef DEBUG_PIF
@@ -530,7 +531,7 @@ void update_pif_write(void)
                 {
                     if (Controls[channel].Present &&
                             Controls[channel].RawData)
-                        input.controllerCommand(channel, &PIF_RAMb[i]);
+                        movie_controller_command(channel, &PIF_RAMb[i]);
                     else
                         internal_ControllerCommand(channel, &PIF_RAMb[i]);
                 }
@@ -547,7 +548,7 @@ void update_pif_write(void)
         i++;
     }
     //PIF_RAMb[0x3F] = 0;
-    input.controllerCommand(-1, NULL);
+    movie_controller_command(-1, NULL);
 }
 
 void update_pif_read(void)
@@ -577,7 +578,7 @@ void update_pif_read(void)
                 {
                     if (Controls[channel].Present &&
                             Controls[channel].RawData)
-                        input.readController(channel, &PIF_RAMb[i]);
+                        movie_read_controller(channel, &PIF_RAMb[i]);
                     else
                         internal_ReadController(channel, &PIF_RAMb[i]);
                 }
@@ -589,6 +590,6 @@ void update_pif_read(void)
         }
         i++;
     }
-    input.readController(-1, NULL);
+    movie_read_controller(-1, NULL);
 }
 
@@ -19,9 +19,11 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "api/m64p_types.h"
+#include "api/callbacks.h"
 
 #include "memory.h"
 
@@ -30,47 +32,150 @@
 #include "r4300/macros.h"
 #include "main/rom.h"
 
+#ifdef NEW_DYNAREC
+/* new_dynarec indexes these from its linkage code and generated blocks,
+   so it keeps the flat tables. */
 unsigned int tlb_LUT_r[0x100000];
 unsigned int tlb_LUT_w[0x100000];
+#else
+/* Two-level lookup: each leaf covers 4 MB of virtual space and is only
+   allocated once a TLB entry maps a page inside it. */
+typedef struct _tlb_leaf
+{
+    unsigned int r[0x400];
+    unsigned int w[0x400];
+} tlb_leaf;
 
-void tlb_unmap(tlb *entry)
+static tlb_leaf *tlb_dir[0x400];
+#endif
+
+/* Direct-mapped cache of recent translations for virtual_to_physical_address.
+   Both r and w are cached so a lookup never has to walk the table twice. */
+#define TLB_CACHE_SIZE 64
+
+static struct
+{
+    unsigned int page;
+    unsigned int r;
+    unsigned int w;
+} tlb_cache[TLB_CACHE_SIZE];
+
+static void tlb_cache_flush(void)
+{
+    int i;
+    for (i = 0; i < TLB_CACHE_SIZE; i++)
+        tlb_cache[i].page = 0xFFFFFFFF;
+}
+
+static unsigned int *tlb_slot(unsigned int page, int w, int alloc)
+{
+#ifdef NEW_DYNAREC
+    (void)alloc;
+    return w ? &tlb_LUT_w[page] : &tlb_LUT_r[page];
+#else
+    tlb_leaf *leaf = tlb_dir[page >> 10];
+
+    if (leaf == NULL)
+    {
+        if (!alloc)
+            return NULL;
+        leaf = (tlb_leaf *) calloc(1, sizeof(tlb_leaf));
+        if (leaf == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "Couldn't allocate TLB lookup table for %08x", page << 12);
+            return NULL;
+        }
+        tlb_dir[page >> 10] = leaf;
+    }
+    return w ? &leaf->w[page & 0x3FF] : &leaf->r[page & 0x3FF];
+#endif
+}
+
+static void tlb_clear_range(unsigned int start, unsigned int end, int w)
+{
+    unsigned int page;
+
+    if (start >= end)
+        return;
+    for (page = start >> 12; page <= (end >> 12); page++)
+    {
+        unsigned int *slot = tlb_slot(page, w, 0);
+        if (slot != NULL)
+            *slot = 0;
+    }
+}
+
+static void tlb_fill_range(unsigned int start, unsigned int end, unsigned int phys, int w)
+{
+    unsigned int page;
+
+    for (page = start >> 12; page <= (end >> 12); page++)
+    {
+        unsigned int *slot = tlb_slot(page, w, 1);
+        if (slot != NULL)
+            *slot = 0x80000000 | (phys + ((page << 12) - start) + 0xFFF);
+    }
+}
+
+unsigned int tlb_lookup(unsigned int page, int w)
+{
+#ifdef NEW_DYNAREC
+    return w ? tlb_LUT_w[page] : tlb_LUT_r[page];
+#else
+    const tlb_leaf *leaf = tlb_dir[page >> 10];
+
+    if (leaf == NULL)
+        return 0;
+    return w ? leaf->w[page & 0x3FF] : leaf->r[page & 0x3FF];
+#endif
+}
+
+void tlb_clear(void)
 {
-    unsigned int i;
+#ifdef NEW_DYNAREC
+    memset(tlb_LUT_r, 0, sizeof(tlb_LUT_r));
+    memset(tlb_LUT_w, 0, sizeof(tlb_LUT_w));
+#else
+    int i;
+    for (i = 0; i < 0x400; i++)
+    {
+        free(tlb_dir[i]);
+        tlb_dir[i] = NULL;
+    }
+#endif
+    tlb_cache_flush();
+}
 
+void tlb_unmap(tlb *entry)
+{
     if (entry->v_even)
     {
-        for (i=entry->start_even; i<entry->end_even; i += 0x1000)
-            tlb_LUT_r[i>>12] = 0;
+        tlb_clear_range(entry->start_even, entry->end_even, 0);
         if (entry->d_even)
-            for (i=entry->start_even; i<entry->end_even; i += 0x1000)
-                tlb_LUT_w[i>>12] = 0;
+            tlb_clear_range(entry->start_even, entry->end_even, 1);
     }
 
     if (entry->v_odd)
     {
-        for (i=entry->start_odd; i<entry->end_odd; i += 0x1000)
-            tlb_LUT_r[i>>12] = 0;
+        tlb_clear_range(entry->start_odd, entry->end_odd, 0);
         if (entry->d_odd)
-            for (i=entry->start_odd; i<entry->end_odd; i += 0x1000)
-                tlb_LUT_w[i>>12] = 0;
+            tlb_clear_range(entry->start_odd, entry->end_odd, 1);
     }
+
+    tlb_cache_flush();
 }
 
 void tlb_map(tlb *entry)
 {
-    unsigned int i;
-
     if (entry->v_even)
     {
         if (entry->start_even < entry->end_even &&
             !(entry->start_even >= 0x80000000 && entry->end_even < 0xC0000000) &&
             entry->phys_even < 0x20000000)
         {
-            for (i=entry->start_even;i<entry->end_even;i+=0x1000)
-                tlb_LUT_r[i>>12] = 0x80000000 | (entry->phys_even + (i - entry->start_even) + 0xFFF);
+            tlb_fill_range(entry->start_even, entry->end_even, entry->phys_even, 0);
             if (entry->d_even)
-                for (i=entry->start_even;i<entry->end_even;i+=0x1000)
-                    tlb_LUT_w[i>>12] = 0x80000000 | (entry->phys_even + (i - entry->start_even) + 0xFFF);
+                tlb_fill_range(entry->start_even, entry->end_even, entry->phys_even, 1);
         }
     }
 
@@ -80,17 +185,19 @@ void tlb_map(tlb *entry)
             !(entry->start_odd >= 0x80000000 && entry->end_odd < 0xC0000000) &&
             entry->phys_odd < 0x20000000)
         {
-            for (i=entry->start_odd;i<entry->end_odd;i+=0x1000)
-                tlb_LUT_r[i>>12] = 0x80000000 | (entry->phys_odd + (i - entry->start_odd) + 0xFFF);
+            tlb_fill_range(entry->start_odd, entry->end_odd, entry->phys_odd, 0);
             if (entry->d_odd)
-                for (i=entry->start_odd;i<entry->end_odd;i+=0x1000)
-                    tlb_LUT_w[i>>12] = 0x80000000 | (entry->phys_odd + (i - entry->start_odd) + 0xFFF);
+                tlb_fill_range(entry->start_odd, entry->end_odd, entry->phys_odd, 1);
         }
     }
+
+    tlb_cache_flush();
 }
 
 unsigned int virtual_to_physical_address(unsigned int addresse, int w)
 {
+    unsigned int page, line, lut;
+
     if (addresse >= 0x7f000000 && addresse < 0x80000000 && isGoldeneyeRom)
     {
         /**************************************************
@@ -117,16 +224,17 @@ unsigned int virtual_to_physical_address(unsigned int addresse, int w)
             break;
         }
     }
-    if (w == 1)
-    {
-        if (tlb_LUT_w[addresse>>12])
-            return (tlb_LUT_w[addresse>>12]&0xFFFFF000)|(addresse&0xFFF);
-    }
-    else
+    page = addresse >> 12;
+    line = page & (TLB_CACHE_SIZE - 1);
+    if (tlb_cache[line].page != page)
     {
-        if (tlb_LUT_r[addresse>>12])
-            return (tlb_LUT_r[addresse>>12]&0xFFFFF000)|(addresse&0xFFF);
+        tlb_cache[line].page = page;
+        tlb_cache[line].r = tlb_lookup(page, 0);
+        tlb_cache[line].w = tlb_lookup(page, 1);
     }
+    lut = (w == 1) ? tlb_cache[line].w : tlb_cache[line].r;
+    if (lut)
+        return (lut&0xFFFFF000)|(addresse&0xFFF);
     //printf("tlb exception !!! @ %x, %x, add:%x\n", addresse, w, PC->addr);
     //getchar();
     TLB_refill_exception(addresse,w);
@@ -47,8 +47,15 @@ typedef struct _tlb
    unsigned int phys_odd;
 } tlb;
 
+#ifdef NEW_DYNAREC
 extern unsigned int tlb_LUT_r[0x100000];
 extern unsigned int tlb_LUT_w[0x100000];
+#endif
+
+/* Returns the lookup word for a 4 KB virtual page: 0 when unmapped, else
+   0x80000000 | (physical address of the page's last byte). */
+unsigned int tlb_lookup(unsigned int page, int w);
+void tlb_clear(void);
 void tlb_unmap(tlb *entry);
 void tlb_map(tlb *entry);
 unsigned int virtual_to_physical_address(unsigned int addresse, int w);
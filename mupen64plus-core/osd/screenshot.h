@@ -19,13 +19,30 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include "osal/preproc.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* screenshot.cpp is built along with the OSD */
+#ifdef M64P_OSD
+
 void ScreenshotRomOpen(void);
 void TakeScreenshot(int iFrameNumber);
 
+#else
+
+static osal_inline void ScreenshotRomOpen(void)
+{
+}
+
+static osal_inline void TakeScreenshot(int iFrameNumber)
+{
+}
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dlist_capture.c                                         *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dlist_capture.h"
+#include "plugin.h"
+
+#include "api/callbacks.h"
+#include "main/rom.h"
+#include "memory/memory.h"
+
+#define RDRAM_SIZE      0x800000
+#define RDRAM_PAGES     (RDRAM_SIZE / DLTRACE_PAGE_SIZE)
+
+static FILE *l_CaptureFile = NULL;
+static unsigned char *l_Shadow = NULL;          /* RDRAM as it is in the trace so far */
+static unsigned int l_ShadowVI[DLTRACE_VI_REGS];
+static unsigned char l_ChangedPages[RDRAM_PAGES / 8];
+static unsigned int l_NumDLists;
+static unsigned int l_NumPages;
+
+static void get_vi_registers(unsigned int *regs)
+{
+    /* in the order of GFX_INFO */
+    regs[0] = vi_register.vi_status;
+    regs[1] = vi_register.vi_origin;
+    regs[2] = vi_register.vi_width;
+    regs[3] = vi_register.vi_v_intr;
+    regs[4] = vi_register.vi_current;
+    regs[5] = vi_register.vi_burst;
+    regs[6] = vi_register.vi_v_sync;
+    regs[7] = vi_register.vi_h_sync;
+    regs[8] = vi_register.vi_leap;
+    regs[9] = vi_register.vi_h_start;
+    regs[10] = vi_register.vi_v_start;
+    regs[11] = vi_register.vi_v_burst;
+    regs[12] = vi_register.vi_x_scale;
+    regs[13] = vi_register.vi_y_scale;
+}
+
+static int write_record(unsigned int type, const void *data, unsigned int size)
+{
+    dltrace_record record;
+    record.type = type;
+    record.size = size;
+    if (fwrite(&record, sizeof(record), 1, l_CaptureFile) != 1)
+        return 0;
+    return size == 0 || fwrite(data, size, 1, l_CaptureFile) == 1;
+}
+
+/* writes the RDRAM pages which changed since the last record (by the CPU or by the plugin) and the VI registers if
+ * they changed */
+static int write_state(void)
+{
+    const unsigned char *ram = (const unsigned char *) rdram;
+    unsigned int regs[DLTRACE_VI_REGS];
+    unsigned int page, count = 0;
+
+    memset(l_ChangedPages, 0, sizeof(l_ChangedPages));
+    for (page = 0; page < RDRAM_PAGES; page++)
+    {
+        if (memcmp(ram + page * DLTRACE_PAGE_SIZE, l_Shadow + page * DLTRACE_PAGE_SIZE, DLTRACE_PAGE_SIZE) != 0)
+        {
+            l_ChangedPages[page >> 3] |= 1 << (page & 7);
+            count++;
+        }
+    }
+
+    if (count > 0)
+    {
+        dltrace_record record;
+        record.type = DLTRACE_PAGES;
+        record.size = count * (sizeof(unsigned int) + DLTRACE_PAGE_SIZE);
+        if (fwrite(&record, sizeof(record), 1, l_CaptureFile) != 1)
+            return 0;
+
+        for (page = 0; page < RDRAM_PAGES; page++)
+        {
+            if (!(l_ChangedPages[page >> 3] & (1 << (page & 7))))
+                continue;
+            memcpy(l_Shadow + page * DLTRACE_PAGE_SIZE, ram + page * DLTRACE_PAGE_SIZE, DLTRACE_PAGE_SIZE);
+            if (fwrite(&page, sizeof(page), 1, l_CaptureFile) != 1 ||
+                fwrite(l_Shadow + page * DLTRACE_PAGE_SIZE, DLTRACE_PAGE_SIZE, 1, l_CaptureFile) != 1)
+                return 0;
+        }
+        l_NumPages += count;
+    }
+
+    get_vi_registers(regs);
+    if (memcmp(regs, l_ShadowVI, sizeof(regs)) != 0)
+    {
+        memcpy(l_ShadowVI, regs, sizeof(regs));
+        if (!write_record(DLTRACE_VI, regs, sizeof(regs)))
+            return 0;
+    }
+
+    return 1;
+}
+
+static void capture_failed(void)
+{
+    DebugMessage(M64MSG_ERROR, "couldn't write display list trace, capture stopped");
+    dlist_capture_stop();
+}
+
+int dlist_capture_start(const char *filename)
+{
+    dltrace_header header;
+
+    dlist_capture_stop();
+
+    l_CaptureFile = fopen(filename, "wb");
+    if (l_CaptureFile == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "couldn't open display list trace file '%s' for writing", filename);
+        return 0;
+    }
+
+    /* the shadow starts out zeroed, so the first record only has the pages which aren't */
+    l_Shadow = (unsigned char *) calloc(1, RDRAM_SIZE);
+    if (l_Shadow == NULL)
+    {
+        fclose(l_CaptureFile);
+        l_CaptureFile = NULL;
+        return 0;
+    }
+    memset(l_ShadowVI, 0, sizeof(l_ShadowVI));
+    l_NumDLists = 0;
+    l_NumPages = 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DLTRACE_MAGIC, sizeof(header.magic));
+    header.version = DLTRACE_VERSION;
+    header.rdram_size = RDRAM_SIZE;
+    memcpy(header.rom_header, rom, sizeof(header.rom_header));
+    if (fwrite(&header, sizeof(header), 1, l_CaptureFile) != 1)
+    {
+        capture_failed();
+        return 0;
+    }
+
+    DebugMessage(M64MSG_INFO, "capturing display lists to '%s'", filename);
+    return 1;
+}
+
+void dlist_capture_stop(void)
+{
+    if (l_CaptureFile != NULL)
+    {
+        fclose(l_CaptureFile);
+        DebugMessage(M64MSG_INFO, "display list capture: %u display lists, %u RDRAM pages", l_NumDLists, l_NumPages);
+    }
+    free(l_Shadow);
+    l_CaptureFile = NULL;
+    l_Shadow = NULL;
+}
+
+void dlist_capture_ProcessDList(void)
+{
+    if (l_CaptureFile != NULL)
+    {
+        if (write_state() &&
+            write_record(DLTRACE_DLIST, (unsigned char *) SP_DMEM + DLTRACE_TASK_OFFSET, DLTRACE_TASK_SIZE))
+            l_NumDLists++;
+        else
+            capture_failed();
+    }
+
+    gfx.processDList();
+}
+
+void dlist_capture_UpdateScreen(void)
+{
+    if (l_CaptureFile != NULL)
+    {
+        if (!write_state() || !write_record(DLTRACE_UPDATE_SCREEN, NULL, 0))
+            capture_failed();
+    }
+
+    gfx.updateScreen();
+}
+
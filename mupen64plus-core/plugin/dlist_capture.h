@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dlist_capture.h                                         *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#if !defined(DLIST_CAPTURE_H)
+#define DLIST_CAPTURE_H
+
+/* Display list trace
+ *
+ * When the core parameter DListCapture names a file, everything the video plugin gets from the core while a game runs
+ * is recorded in it, so that the plugin can be run again on the same input without the game (see tools/dlreplay.c).
+ *
+ * File layout (host byte order, RDRAM and DMEM as the core holds them in memory):
+ *   dltrace_header
+ *   records, each a dltrace_record followed by 'size' bytes:
+ *     DLTRACE_PAGES          RDRAM pages changed since the previous record: (uint32 page number, page data) pairs.
+ *                            The first one holds every page of RDRAM which isn't zero.
+ *     DLTRACE_VI             the 14 VI registers the plugin sees, in GFX_INFO order, whenever they changed
+ *     DLTRACE_DLIST          a ProcessDList() call: the OSTask header at DMEM 0x0FC0 (64 bytes)
+ *     DLTRACE_UPDATE_SCREEN  an UpdateScreen() call, no data
+ */
+
+#define DLTRACE_MAGIC           "M64PDLT"
+#define DLTRACE_VERSION         1
+#define DLTRACE_PAGE_SIZE       4096
+#define DLTRACE_TASK_OFFSET     0x0FC0
+#define DLTRACE_TASK_SIZE       64
+#define DLTRACE_VI_REGS         14
+
+enum dltrace_record_type
+{
+    DLTRACE_PAGES = 1,
+    DLTRACE_VI,
+    DLTRACE_DLIST,
+    DLTRACE_UPDATE_SCREEN
+};
+
+typedef struct
+{
+    char          magic[8];
+    unsigned int  version;
+    unsigned int  rdram_size;
+    unsigned char rom_header[64];
+} dltrace_header;
+
+typedef struct
+{
+    unsigned int  type;
+    unsigned int  size;
+} dltrace_record;
+
+extern int  dlist_capture_start(const char *filename);
+extern void dlist_capture_stop(void);
+
+/* called instead of the video plugin's functions: they record the call when a capture is running and pass it on */
+extern void dlist_capture_ProcessDList(void);
+extern void dlist_capture_UpdateScreen(void);
+
+#endif /* DLIST_CAPTURE_H */
+
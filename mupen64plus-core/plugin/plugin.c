@@ -39,6 +39,8 @@
 #include "dummy_video.h"
 #include "dummy_input.h"
 #include "dummy_rsp.h"
+#include "dlist_capture.h"
+#include "video_thread.h"
 
 CONTROL Controls[4];
 
@@ -253,6 +255,7 @@ static m64p_error plugin_start_gfx(void)
     gfx_info.VI_X_SCALE_REG = &(vi_register.vi_x_scale);
     gfx_info.VI_Y_SCALE_REG = &(vi_register.vi_y_scale);
     gfx_info.CheckInterrupts = EmptyFunc;
+    video_thread_gfx_info(&gfx_info);
 
     /* call the audio plugin */
     if (!gfx.initiateGFX(gfx_info))
@@ -450,6 +453,17 @@ static m64p_error plugin_connect_rsp(m64p_dynlib_handle plugin_handle)
     return M64ERR_SUCCESS;
 }
 
+/* through gfx, which is changed while the video thread runs */
+static void rsp_ProcessRdpList(void)
+{
+    gfx.processRDPList();
+}
+
+static void rsp_ShowCFB(void)
+{
+    gfx.showCFB();
+}
+
 static m64p_error plugin_start_rsp(void)
 {
     /* fill in the RSP_INFO data structure */
@@ -475,10 +489,10 @@ static m64p_error plugin_start_rsp(void)
     rsp_info.DPC_PIPEBUSY_REG = &dpc_register.dpc_pipebusy;
     rsp_info.DPC_TMEM_REG = &dpc_register.dpc_tmem;
     rsp_info.CheckInterrupts = EmptyFunc;
-    rsp_info.ProcessDlistList = gfx.processDList;
+    rsp_info.ProcessDlistList = dlist_capture_ProcessDList;
     rsp_info.ProcessAlistList = audio.processAList;
-    rsp_info.ProcessRdpList = gfx.processRDPList;
-    rsp_info.ShowCFB = gfx.showCFB;
+    rsp_info.ProcessRdpList = rsp_ProcessRdpList;
+    rsp_info.ShowCFB = rsp_ShowCFB;
 
     /* call the RSP plugin  */
     rsp.initiateRSP(rsp_info, NULL);
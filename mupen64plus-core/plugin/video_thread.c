@@ -0,0 +1,595 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - video_thread.c                                          *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <string.h>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+#include "api/m64p_config.h"
+#include "api/vidext.h"
+
+#include "video_thread.h"
+#include "plugin.h"
+
+#include "main/main.h"
+#include "memory/memory.h"
+
+#define QUEUE_SIZE      16      /* a game sends a few display lists per frame */
+#define DMEM_SIZE       0x1000
+#define VI_REGS         14
+#define DPC_REGS        8
+
+enum video_job_type
+{
+    JOB_DLIST,
+    JOB_UPDATE_SCREEN,
+    JOB_VI_STATUS,
+    JOB_VI_WIDTH,
+    JOB_FB_WRITE,
+    JOB_CALL,
+    JOB_QUIT
+};
+
+typedef struct
+{
+    enum video_job_type type;
+    unsigned int        vi[VI_REGS];
+    unsigned int        dpc[DPC_REGS];
+    unsigned int        addr, size;             /* JOB_FB_WRITE */
+    void              (*func)(void *);          /* JOB_CALL */
+    void               *data;
+    unsigned char       dmem[DMEM_SIZE];        /* JOB_DLIST */
+} video_job;
+
+/* what the plugin sees through GFX_INFO when it runs on the video thread */
+static unsigned char l_DMEM[DMEM_SIZE];
+static unsigned int l_VI[VI_REGS];
+static unsigned int l_DPC[DPC_REGS];
+static unsigned int l_MI_INTR;
+
+static int l_Attached = 0;              /* the plugin was given the copies above */
+static int l_Running = 0;
+static gfx_plugin_functions l_Plugin;   /* the plugin's functions, gfx holds the ones which go through the thread */
+
+static SDL_Thread *l_Thread = NULL;
+static Uint32 l_ThreadID;
+static SDL_mutex *l_Lock = NULL;
+static SDL_cond *l_WorkAvail = NULL;
+static SDL_cond *l_WorkDone = NULL;
+
+/* jobs are numbered as they are queued; l_Queue[n % QUEUE_SIZE] is job n and jobs l_Done to l_Queued - 1 are waiting */
+static video_job l_Queue[QUEUE_SIZE];
+static unsigned int l_Queued, l_Done;
+static unsigned int l_LastScreenUpdate;
+
+/* display lists queued, their DP_INT events which have been raised, and the display lists done by the video thread */
+static unsigned int l_DListsQueued, l_DListsRaised;     /* only used by the core */
+static int l_DListQueuedSinceTask;                      /* only used by the core */
+static unsigned int l_DListsDone;
+
+/* frame buffers reported by the plugin after its last display list, handed to the core without waiting */
+static FrameBufferInfo l_FrameBufferInfos[6];
+
+static void get_vi_registers(unsigned int *regs)
+{
+    /* in the order of GFX_INFO */
+    regs[0] = vi_register.vi_status;
+    regs[1] = vi_register.vi_origin;
+    regs[2] = vi_register.vi_width;
+    regs[3] = vi_register.vi_v_intr;
+    regs[4] = vi_register.vi_current;
+    regs[5] = vi_register.vi_burst;
+    regs[6] = vi_register.vi_v_sync;
+    regs[7] = vi_register.vi_h_sync;
+    regs[8] = vi_register.vi_leap;
+    regs[9] = vi_register.vi_h_start;
+    regs[10] = vi_register.vi_v_start;
+    regs[11] = vi_register.vi_v_burst;
+    regs[12] = vi_register.vi_x_scale;
+    regs[13] = vi_register.vi_y_scale;
+}
+
+static void get_dpc_registers(unsigned int *regs)
+{
+    regs[0] = dpc_register.dpc_start;
+    regs[1] = dpc_register.dpc_end;
+    regs[2] = dpc_register.dpc_current;
+    regs[3] = dpc_register.dpc_status;
+    regs[4] = dpc_register.dpc_clock;
+    regs[5] = dpc_register.dpc_bufbusy;
+    regs[6] = dpc_register.dpc_pipebusy;
+    regs[7] = dpc_register.dpc_tmem;
+}
+
+static void set_dpc_registers(const unsigned int *regs)
+{
+    dpc_register.dpc_start = regs[0];
+    dpc_register.dpc_end = regs[1];
+    dpc_register.dpc_current = regs[2];
+    dpc_register.dpc_status = regs[3];
+    dpc_register.dpc_clock = regs[4];
+    dpc_register.dpc_bufbusy = regs[5];
+    dpc_register.dpc_pipebusy = regs[6];
+    dpc_register.dpc_tmem = regs[7];
+}
+
+static int on_video_thread(void)
+{
+    return SDL_ThreadID() == l_ThreadID;
+}
+
+/* waits for a free slot and returns it locked, with the registers as they are now */
+static video_job *begin_job(enum video_job_type type)
+{
+    video_job *job;
+
+    SDL_LockMutex(l_Lock);
+    while (l_Queued - l_Done >= QUEUE_SIZE)
+        SDL_CondWait(l_WorkDone, l_Lock);
+
+    job = &l_Queue[l_Queued % QUEUE_SIZE];
+    job->type = type;
+    get_vi_registers(job->vi);
+    get_dpc_registers(job->dpc);
+    return job;
+}
+
+static unsigned int end_job(void)
+{
+    unsigned int id = l_Queued++;
+    SDL_CondSignal(l_WorkAvail);
+    SDL_UnlockMutex(l_Lock);
+    return id;
+}
+
+static void wait_job(unsigned int id)
+{
+    SDL_LockMutex(l_Lock);
+    while ((int) (l_Done - id) <= 0)
+        SDL_CondWait(l_WorkDone, l_Lock);
+    SDL_UnlockMutex(l_Lock);
+}
+
+static void run_job(video_job *job)
+{
+    memcpy(l_VI, job->vi, sizeof(l_VI));
+    memcpy(l_DPC, job->dpc, sizeof(l_DPC));
+
+    switch (job->type)
+    {
+        case JOB_DLIST:
+        {
+            FrameBufferInfo infos[6];
+            int fbinfos = l_Plugin.fBGetFrameBufferInfo && l_Plugin.fBRead && l_Plugin.fBWrite;
+
+            memcpy(l_DMEM, job->dmem, sizeof(l_DMEM));
+            l_Plugin.processDList();
+            if (fbinfos)
+            {
+                memset(infos, 0, sizeof(infos));
+                l_Plugin.fBGetFrameBufferInfo(infos);
+            }
+
+            SDL_LockMutex(l_Lock);
+            if (fbinfos)
+                memcpy(l_FrameBufferInfos, infos, sizeof(infos));
+            l_DListsDone++;
+            SDL_UnlockMutex(l_Lock);
+            break;
+        }
+        case JOB_UPDATE_SCREEN:
+            l_Plugin.updateScreen();
+            break;
+        case JOB_VI_STATUS:
+            l_Plugin.viStatusChanged();
+            break;
+        case JOB_VI_WIDTH:
+            l_Plugin.viWidthChanged();
+            break;
+        case JOB_FB_WRITE:
+            l_Plugin.fBWrite(job->addr, job->size);
+            break;
+        case JOB_CALL:
+            job->func(job->data);
+            break;
+        case JOB_QUIT:
+            break;
+    }
+}
+
+static int video_thread_main(void *unused)
+{
+    int quit = 0;
+
+    VidExt_GL_MakeCurrent(1);
+
+    while (!quit)
+    {
+        video_job *job;
+
+        SDL_LockMutex(l_Lock);
+        while (l_Done == l_Queued)
+            SDL_CondWait(l_WorkAvail, l_Lock);
+        job = &l_Queue[l_Done % QUEUE_SIZE];
+        SDL_UnlockMutex(l_Lock);
+
+        /* the slot stays ours until l_Done moves past it */
+        quit = (job->type == JOB_QUIT);
+        run_job(job);
+
+        SDL_LockMutex(l_Lock);
+        l_Done++;
+        SDL_CondBroadcast(l_WorkDone);
+        SDL_UnlockMutex(l_Lock);
+    }
+
+    VidExt_GL_MakeCurrent(0);
+    return 0;
+}
+
+void video_thread_call(void (*func)(void *), void *data)
+{
+    video_job *job;
+
+    if (!l_Running || on_video_thread())
+    {
+        func(data);
+        return;
+    }
+
+    job = begin_job(JOB_CALL);
+    job->func = func;
+    job->data = data;
+    wait_job(end_job());
+}
+
+int video_thread_dlist_queued(void)
+{
+    int queued = l_DListQueuedSinceTask;
+    l_DListQueuedSinceTask = 0;
+    return queued;
+}
+
+int video_thread_dp_interrupt(void)
+{
+    unsigned int done;
+
+    /* the events are raised in the order of the display lists; one which isn't for a display list of the video
+     * thread, like one loaded from a savestate, is raised right away */
+    if (!l_Running || l_DListsRaised == l_DListsQueued)
+        return 1;
+
+    SDL_LockMutex(l_Lock);
+    done = l_DListsDone;
+    SDL_UnlockMutex(l_Lock);
+    if (done == l_DListsRaised)
+        return 0;
+
+    l_DListsRaised++;
+    return 1;
+}
+
+void video_thread_sync(void)
+{
+    unsigned int last;
+
+    if (!l_Running || on_video_thread())
+        return;
+
+    SDL_LockMutex(l_Lock);
+    last = l_Queued - 1;
+    SDL_UnlockMutex(l_Lock);
+    wait_job(last);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* the plugin functions as the core sees them while the thread runs */
+
+static void vt_ProcessDList(void)
+{
+    video_job *job = begin_job(JOB_DLIST);
+    memcpy(job->dmem, SP_DMEM, DMEM_SIZE);
+    end_job();
+
+    /* the DP interrupt is raised when the video thread gets to the full sync, see video_thread_dp_interrupt() */
+    l_DListsQueued++;
+    l_DListQueuedSinceTask = 1;
+}
+
+static void vt_UpdateScreen(void)
+{
+    /* no more than one frame in flight */
+    wait_job(l_LastScreenUpdate);
+
+    begin_job(JOB_UPDATE_SCREEN);
+    l_LastScreenUpdate = end_job();
+}
+
+static void vt_ViStatusChanged(void)
+{
+    begin_job(JOB_VI_STATUS);
+    end_job();
+}
+
+static void vt_ViWidthChanged(void)
+{
+    begin_job(JOB_VI_WIDTH);
+    end_job();
+}
+
+static void vt_FBWrite(unsigned int addr, unsigned int size)
+{
+    video_job *job = begin_job(JOB_FB_WRITE);
+    job->addr = addr;
+    job->size = size;
+    end_job();
+}
+
+static void vt_FBGetFrameBufferInfo(void *p)
+{
+    SDL_LockMutex(l_Lock);
+    memcpy(p, l_FrameBufferInfos, sizeof(l_FrameBufferInfos));
+    SDL_UnlockMutex(l_Lock);
+}
+
+/* the rest wait for the video thread */
+
+static void call_FBRead(void *data)
+{
+    l_Plugin.fBRead(*((unsigned int *) data));
+}
+
+static void vt_FBRead(unsigned int addr)
+{
+    video_thread_call(call_FBRead, &addr);
+}
+
+typedef struct
+{
+    void *dest;
+    int  *width;
+    int  *height;
+    int   front;
+} read_screen_args;
+
+static void call_ReadScreen(void *data)
+{
+    read_screen_args *args = (read_screen_args *) data;
+    l_Plugin.readScreen(args->dest, args->width, args->height, args->front);
+}
+
+static void vt_ReadScreen(void *dest, int *width, int *height, int front)
+{
+    read_screen_args args;
+    args.dest = dest;
+    args.width = width;
+    args.height = height;
+    args.front = front;
+    video_thread_call(call_ReadScreen, &args);
+}
+
+static void call_ProcessRDPList(void *data)
+{
+    l_Plugin.processRDPList();
+    memcpy(data, l_DPC, sizeof(l_DPC));
+}
+
+static void vt_ProcessRDPList(void)
+{
+    unsigned int dpc[DPC_REGS];
+    video_thread_call(call_ProcessRDPList, dpc);
+    set_dpc_registers(dpc);
+}
+
+static void call_void(void *data)
+{
+    (*((void (**)(void)) data))();
+}
+
+static void vt_ChangeWindow(void)
+{
+    video_thread_call(call_void, &l_Plugin.changeWindow);
+}
+
+static void vt_ShowCFB(void)
+{
+    video_thread_call(call_void, &l_Plugin.showCFB);
+}
+
+static void vt_RomClosed(void)
+{
+    video_thread_call(call_void, &l_Plugin.romClosed);
+}
+
+static void call_RomOpen(void *data)
+{
+    *((int *) data) = l_Plugin.romOpen();
+}
+
+static int vt_RomOpen(void)
+{
+    int result;
+    video_thread_call(call_RomOpen, &result);
+    return result;
+}
+
+static void call_MoveScreen(void *data)
+{
+    l_Plugin.moveScreen(((int *) data)[0], ((int *) data)[1]);
+}
+
+static void vt_MoveScreen(int x, int y)
+{
+    int args[2];
+    args[0] = x;
+    args[1] = y;
+    video_thread_call(call_MoveScreen, args);
+}
+
+static void call_ResizeVideoOutput(void *data)
+{
+    l_Plugin.resizeVideoOutput(((int *) data)[0], ((int *) data)[1]);
+}
+
+static void vt_ResizeVideoOutput(int width, int height)
+{
+    int args[2];
+    args[0] = width;
+    args[1] = height;
+    video_thread_call(call_ResizeVideoOutput, args);
+}
+
+static void call_SetRenderingCallback(void *data)
+{
+    l_Plugin.setRenderingCallback(*((void (**)(int)) data));
+}
+
+static void vt_SetRenderingCallback(void (*callback)(int))
+{
+    video_thread_call(call_SetRenderingCallback, &callback);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+void video_thread_gfx_info(GFX_INFO *gfx_info)
+{
+    l_Attached = ConfigGetParamBool(g_CoreConfig, "VideoThread");
+    if (!l_Attached)
+        return;
+
+    gfx_info->DMEM = l_DMEM;
+    gfx_info->MI_INTR_REG = &l_MI_INTR;
+    gfx_info->DPC_START_REG = &l_DPC[0];
+    gfx_info->DPC_END_REG = &l_DPC[1];
+    gfx_info->DPC_CURRENT_REG = &l_DPC[2];
+    gfx_info->DPC_STATUS_REG = &l_DPC[3];
+    gfx_info->DPC_CLOCK_REG = &l_DPC[4];
+    gfx_info->DPC_BUFBUSY_REG = &l_DPC[5];
+    gfx_info->DPC_PIPEBUSY_REG = &l_DPC[6];
+    gfx_info->DPC_TMEM_REG = &l_DPC[7];
+    gfx_info->VI_STATUS_REG = &l_VI[0];
+    gfx_info->VI_ORIGIN_REG = &l_VI[1];
+    gfx_info->VI_WIDTH_REG = &l_VI[2];
+    gfx_info->VI_INTR_REG = &l_VI[3];
+    gfx_info->VI_V_CURRENT_LINE_REG = &l_VI[4];
+    gfx_info->VI_TIMING_REG = &l_VI[5];
+    gfx_info->VI_V_SYNC_REG = &l_VI[6];
+    gfx_info->VI_H_SYNC_REG = &l_VI[7];
+    gfx_info->VI_LEAP_REG = &l_VI[8];
+    gfx_info->VI_H_START_REG = &l_VI[9];
+    gfx_info->VI_V_START_REG = &l_VI[10];
+    gfx_info->VI_V_BURST_REG = &l_VI[11];
+    gfx_info->VI_X_SCALE_REG = &l_VI[12];
+    gfx_info->VI_Y_SCALE_REG = &l_VI[13];
+}
+
+int video_thread_start(void)
+{
+    if (!l_Attached || l_Running)
+        return 0;
+
+    l_Lock = SDL_CreateMutex();
+    l_WorkAvail = SDL_CreateCond();
+    l_WorkDone = SDL_CreateCond();
+    if (l_Lock == NULL || l_WorkAvail == NULL || l_WorkDone == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "Could not create video thread synchronization");
+        video_thread_stop();
+        return 0;
+    }
+
+    l_Queued = l_Done = 0;
+    l_LastScreenUpdate = (unsigned int) -1;
+    l_DListsQueued = l_DListsRaised = l_DListsDone = 0;
+    l_DListQueuedSinceTask = 0;
+    memset(l_FrameBufferInfos, 0, sizeof(l_FrameBufferInfos));
+
+    /* the video thread takes the GL context for as long as it runs */
+    VidExt_GL_MakeCurrent(0);
+#if SDL_VERSION_ATLEAST(2,0,0)
+    l_Thread = SDL_CreateThread(video_thread_main, "m64pvideo", NULL);
+#else
+    l_Thread = SDL_CreateThread(video_thread_main, NULL);
+#endif
+    if (l_Thread == NULL)
+    {
+        DebugMessage(M64MSG_ERROR, "Could not create video thread");
+        VidExt_GL_MakeCurrent(1);
+        video_thread_stop();
+        return 0;
+    }
+    l_ThreadID = SDL_GetThreadID(l_Thread);
+
+    l_Plugin = gfx;
+    gfx.changeWindow = vt_ChangeWindow;
+    gfx.moveScreen = vt_MoveScreen;
+    gfx.processDList = vt_ProcessDList;
+    gfx.processRDPList = vt_ProcessRDPList;
+    gfx.romClosed = vt_RomClosed;
+    gfx.romOpen = vt_RomOpen;
+    gfx.showCFB = vt_ShowCFB;
+    gfx.updateScreen = vt_UpdateScreen;
+    gfx.viStatusChanged = vt_ViStatusChanged;
+    gfx.viWidthChanged = vt_ViWidthChanged;
+    gfx.readScreen = vt_ReadScreen;
+    gfx.setRenderingCallback = vt_SetRenderingCallback;
+    gfx.resizeVideoOutput = vt_ResizeVideoOutput;
+    if (l_Plugin.fBRead)
+        gfx.fBRead = vt_FBRead;
+    if (l_Plugin.fBWrite)
+        gfx.fBWrite = vt_FBWrite;
+    if (l_Plugin.fBGetFrameBufferInfo)
+        gfx.fBGetFrameBufferInfo = vt_FBGetFrameBufferInfo;
+
+    l_Running = 1;
+    DebugMessage(M64MSG_INFO, "Video plugin running on its own thread");
+    return 1;
+}
+
+void video_thread_stop(void)
+{
+    if (l_Running)
+    {
+        int status;
+
+        begin_job(JOB_QUIT);
+        end_job();
+        SDL_WaitThread(l_Thread, &status);
+        l_Thread = NULL;
+        l_Running = 0;
+
+        gfx = l_Plugin;
+        VidExt_GL_MakeCurrent(1);
+    }
+
+    if (l_WorkDone != NULL)
+        SDL_DestroyCond(l_WorkDone);
+    if (l_WorkAvail != NULL)
+        SDL_DestroyCond(l_WorkAvail);
+    if (l_Lock != NULL)
+        SDL_DestroyMutex(l_Lock);
+    l_WorkDone = l_WorkAvail = NULL;
+    l_Lock = NULL;
+}
+
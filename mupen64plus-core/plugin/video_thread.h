@@ -0,0 +1,63 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - video_thread.h                                          *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#if !defined(VIDEO_THREAD_H)
+#define VIDEO_THREAD_H
+
+#include "api/m64p_plugin.h"
+
+/* Video thread
+ *
+ * When the core parameter VideoThread is set, every call into the video plugin is made from a thread of its own, which
+ * also holds the GL context. Display lists, screen updates and VI changes are queued and the emulation carries on;
+ * the other calls wait for the video thread to get to them. The emulation also waits for the video thread:
+ *   - when the CPU reads a frame buffer (FBRead) or the screen is read (ReadScreen2)
+ *   - when the CPU reads DPC_STATUS
+ *   - at each VI, until the previous screen update is done, so the video thread is at most a frame behind
+ *
+ * The plugin gets its own copies of DMEM, the VI and DPC registers and MI_INTR, taken when the call is queued.
+ * RDRAM isn't copied: the game keeps what the RDP is working on untouched until it's told the RDP is done, as it has
+ * to on the real hardware, and the video thread is never more than a frame behind. So the DP interrupt of a display
+ * list is only raised once the video thread is done with it: the DP_INT event of the task is put off until then.
+ */
+
+/* fills in the GFX_INFO register pointers with the video thread's copies if VideoThread is set (when the plugin is
+ * attached); the thread can only be used if this was done */
+extern void video_thread_gfx_info(GFX_INFO *gfx_info);
+
+/* start and stop the thread around a game, with the video plugin's RomOpen() and RomClosed() */
+extern int  video_thread_start(void);
+extern void video_thread_stop(void);
+
+/* after an RSP task: whether it queued a display list, whose DP_INT event is to be added */
+extern int  video_thread_dlist_queued(void);
+
+/* for a DP_INT event: whether the DP interrupt can be raised, or the event has to be put off because its display list
+ * is still running on the video thread */
+extern int  video_thread_dp_interrupt(void);
+
+/* waits until the video thread has done everything queued */
+extern void video_thread_sync(void);
+
+/* runs func(data) on the video thread and waits for it, or runs it right away when there is no video thread */
+extern void video_thread_call(void (*func)(void *), void *data);
+
+#endif /* VIDEO_THREAD_H */
+
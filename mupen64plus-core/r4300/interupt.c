@@ -31,10 +31,14 @@
 #include "memory/memory.h"
 #include "main/rom.h"
 #include "main/main.h"
+#include "main/movie.h"
+#include "main/runahead.h"
 #include "main/savestates.h"
 #include "main/cheat.h"
 #include "osd/osd.h"
 #include "plugin/plugin.h"
+#include "plugin/dlist_capture.h"
+#include "plugin/video_thread.h"
 
 #include "interupt.h"
 #include "r4300.h"
@@ -44,7 +48,9 @@
 #include "new_dynarec/new_dynarec.h"
 
 #include "SDL.h"
+#ifdef __QNXNTO__
 #include "../bbutil/bbutil.h"
+#endif
 
 #ifdef WITH_LIRC
 #include "main/lirc.h"
@@ -65,12 +71,42 @@ typedef struct _interupt_queue
 
 static interupt_queue *q = NULL;
 
+/* The queue only ever holds a handful of events, so its nodes come from a
+ * fixed pool instead of malloc; the in-memory snapshots count on restoring
+ * the queue without allocating. The pool falls back on malloc if it runs out. */
+static interupt_queue queue_pool[INTERUPT_QUEUE_MAX];
+static interupt_queue *queue_free = NULL;
+static int queue_pool_used = 0;
+
+static interupt_queue *alloc_node(void)
+{
+    interupt_queue *node = queue_free;
+    if (node != NULL)
+        queue_free = node->next;
+    else if (queue_pool_used < INTERUPT_QUEUE_MAX)
+        node = &queue_pool[queue_pool_used++];
+    else
+        node = (interupt_queue *) malloc(sizeof(interupt_queue));
+    return node;
+}
+
+static void free_node(interupt_queue *node)
+{
+    if (node >= queue_pool && node < queue_pool + INTERUPT_QUEUE_MAX)
+    {
+        node->next = queue_free;
+        queue_free = node;
+    }
+    else
+        free(node);
+}
+
 static void clear_queue(void)
 {
     while(q != NULL)
     {
         interupt_queue *aux = q->next;
-        free(q);
+        free_node(q);
         q = aux;
     }
 }
@@ -140,7 +176,7 @@ void add_interupt_event(int type, unsigned int delay)
    
     if (q == NULL)
     {
-        q = (interupt_queue *) malloc(sizeof(interupt_queue));
+        q = alloc_node();
         q->next = NULL;
         q->count = count;
         q->type = type;
@@ -151,7 +187,7 @@ void add_interupt_event(int type, unsigned int delay)
    
     if(before_event(count, q->count, q->type) && !special)
     {
-        q = (interupt_queue *) malloc(sizeof(interupt_queue));
+        q = alloc_node();
         q->next = aux;
         q->count = count;
         q->type = type;
@@ -165,7 +201,7 @@ void add_interupt_event(int type, unsigned int delay)
    
     if (aux->next == NULL)
     {
-        aux->next = (interupt_queue *) malloc(sizeof(interupt_queue));
+        aux->next = alloc_node();
         aux = aux->next;
         aux->next = NULL;
         aux->count = count;
@@ -178,7 +214,7 @@ void add_interupt_event(int type, unsigned int delay)
             while(aux->next != NULL && aux->next->count == count)
                 aux = aux->next;
         aux2 = aux->next;
-        aux->next = (interupt_queue *) malloc(sizeof(interupt_queue));
+        aux->next = alloc_node();
         aux = aux->next;
         aux->next = aux2;
         aux->count = count;
@@ -195,7 +231,7 @@ static void remove_interupt_event(void)
 {
     interupt_queue *aux = q->next;
     if(q->type == SPECIAL_INT) SPECIAL_done = 1;
-    free(q);
+    free_node(q);
     q = aux;
     if (q != NULL && (q->count > Count || (Count - q->count) < 0x80000000))
         next_interupt = q->count;
@@ -229,7 +265,7 @@ void remove_event(int type)
     if (q->type == type)
     {
         aux = aux->next;
-        free(q);
+        free_node(q);
         q = aux;
         return;
     }
@@ -238,7 +274,7 @@ void remove_event(int type)
     if (aux->next != NULL) // it's a type int
     {
         interupt_queue *aux2 = aux->next->next;
-        free(aux->next);
+        free_node(aux->next);
         aux->next = aux2;
     }
 }
@@ -291,6 +327,47 @@ void load_eventqueue_infos(char *buf)
     }
 }
 
+void save_interupt_snapshot(interupt_snapshot *snapshot)
+{
+    interupt_queue *aux;
+    int n = 0;
+
+    for (aux = q; aux != NULL && n < INTERUPT_QUEUE_MAX; aux = aux->next, n++)
+    {
+        snapshot->type[n] = aux->type;
+        snapshot->count[n] = aux->count;
+    }
+    snapshot->num_events = (aux == NULL) ? n : -1;
+    snapshot->next_interupt = next_interupt;
+    snapshot->next_vi = next_vi;
+    snapshot->vi_field = vi_field;
+    snapshot->vi_counter = vi_counter;
+    snapshot->special_done = SPECIAL_done;
+}
+
+/* Unlike load_eventqueue_infos(), the events are put back as they were, in
+ * the same order, without sorting them again against the current Count */
+void load_interupt_snapshot(const interupt_snapshot *snapshot)
+{
+    interupt_queue **tail = &q;
+    int i;
+
+    clear_queue();
+    for (i = 0; i < snapshot->num_events; i++)
+    {
+        *tail = alloc_node();
+        (*tail)->type = snapshot->type[i];
+        (*tail)->count = snapshot->count[i];
+        tail = &(*tail)->next;
+    }
+    *tail = NULL;
+    next_interupt = snapshot->next_interupt;
+    next_vi = snapshot->next_vi;
+    vi_field = snapshot->vi_field;
+    vi_counter = snapshot->vi_counter;
+    SPECIAL_done = snapshot->special_done;
+}
+
 void init_interupt(void)
 {
     SPECIAL_done = 1;
@@ -313,14 +390,14 @@ void check_interupt(void)
     {
         if(q == NULL)
         {
-            q = (interupt_queue *) malloc(sizeof(interupt_queue));
+            q = alloc_node();
             q->next = NULL;
             q->count = Count;
             q->type = CHECK_INT;
         }
         else
         {
-            interupt_queue* aux = (interupt_queue *) malloc(sizeof(interupt_queue));
+            interupt_queue* aux = alloc_node();
             aux->next = q;
             aux->count = Count;
             aux->type = CHECK_INT;
@@ -330,8 +407,16 @@ void check_interupt(void)
     }
 }
 
+static void draw_paused(void *unused)
+{
+    osd_render();  // draw Paused message in case gfx.updateScreen didn't do it
+    VidExt_GL_SwapBuffers();
+}
+
 void gen_interupt(void)
 {
+    int vi_output;
+
     if (stop == 1)
     {
         vi_counter = 0; // debug
@@ -342,7 +427,9 @@ void gen_interupt(void)
     {
         if (savestates_get_job() == savestates_job_load)
         {
-            savestates_load();
+            video_thread_sync();
+            movie_state_loaded(savestates_load());
+            runahead_reset();
             return;
         }
 
@@ -350,6 +437,7 @@ void gen_interupt(void)
         {
             reset_hard();
             reset_hard_job = 0;
+            runahead_reset();
             return;
         }
     }
@@ -378,6 +466,7 @@ void gen_interupt(void)
             return;
             break;
         case VI_INT:
+            vi_output = runahead_vi();
             if(vi_counter < 60)
             {
                 if (vi_counter == 0)
@@ -388,38 +477,41 @@ void gen_interupt(void)
             {
                 cheat_apply_cheats(ENTRY_VI);
             }
-            gfx.updateScreen();
+            if (vi_output & RUNAHEAD_PRESENT)
+                dlist_capture_UpdateScreen();
+            if (vi_output & RUNAHEAD_REAL)
+            {
 #ifdef WITH_LIRC
-            lircCheckInput();
+                lircCheckInput();
 #endif
 #ifdef __QNXNTO__
-			PB_HandleEvents((void*)input.keyUpDown);
+				PB_HandleEvents((void*)input.keyUpDown);
 #else
-            SDL_PumpEvents();
+                SDL_PumpEvents();
 #endif
 
-            refresh_stat();
+                refresh_stat();
 
-            // if paused, poll for input events
-            if(rompause)
-            {
-                osd_render();  // draw Paused message in case gfx.updateScreen didn't do it
-                VidExt_GL_SwapBuffers();
-                while(rompause)
+                // if paused, poll for input events
+                if(rompause)
                 {
-                    SDL_Delay(10);
+                    video_thread_call(draw_paused, NULL);
+                    while(rompause)
+                    {
+                        SDL_Delay(10);
 #ifdef __QNXNTO__
-					PB_HandleEvents((void*)input.keyUpDown);
+						PB_HandleEvents((void*)input.keyUpDown);
 #else
-                    SDL_PumpEvents();
+                        SDL_PumpEvents();
 #endif
 #ifdef WITH_LIRC
-                    lircCheckInput();
+                        lircCheckInput();
 #endif //WITH_LIRC
+                    }
                 }
-            }
 
-            new_vi();
+                new_vi();
+            }
             if (vi_register.vi_v_sync == 0) vi_register.vi_delay = 500000;
             else vi_register.vi_delay = ((vi_register.vi_v_sync + 1)*1500);
             next_vi += vi_register.vi_delay;
@@ -537,6 +629,12 @@ void gen_interupt(void)
     
         case DP_INT:
             remove_interupt_event();
+            if (!video_thread_dp_interrupt())
+            {
+                // the display list is still running on the video thread
+                add_interupt_event(DP_INT, 1000);
+                return;
+            }
             dpc_register.dpc_status &= ~2;
             dpc_register.dpc_status |= 0x81;
             MI_register.mi_intr_reg |= 0x20;
@@ -616,8 +714,9 @@ void gen_interupt(void)
 
     if (!interupt_unsafe_state)
     {
-        if (savestates_get_job() == savestates_job_save)
+        if (savestates_get_job() == savestates_job_save && !runahead_speculating())
         {
+            video_thread_sync();
             savestates_save();
             return;
         }
@@ -19,6 +19,9 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#ifndef INTERUPT_H
+#define INTERUPT_H
+
 void compare_interupt(void);
 void gen_dp(void);
 void init_interupt(void);
@@ -43,6 +46,25 @@ int get_next_event_type(void);
 int save_eventqueue_infos(char *buf);
 void load_eventqueue_infos(char *buf);
 
+// the interrupt state kept in an in-memory snapshot (main/snapshot.c);
+// num_events is -1 if the queue was too long to be saved
+#define INTERUPT_QUEUE_MAX 32
+
+typedef struct _interupt_snapshot
+{
+    int num_events;
+    int type[INTERUPT_QUEUE_MAX];
+    unsigned int count[INTERUPT_QUEUE_MAX];
+    unsigned int next_interupt;
+    unsigned int next_vi;
+    int vi_field;
+    int vi_counter;
+    int special_done;
+} interupt_snapshot;
+
+void save_interupt_snapshot(interupt_snapshot *snapshot);
+void load_interupt_snapshot(const interupt_snapshot *snapshot);
+
 #define VI_INT      0x001
 #define COMPARE_INT 0x002
 #define CHECK_INT   0x004
@@ -55,3 +77,4 @@ void load_eventqueue_infos(char *buf);
 #define HW2_INT     0x200
 #define NMI_INT     0x400
 
+#endif /* INTERUPT_H */
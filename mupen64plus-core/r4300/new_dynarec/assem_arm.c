@@ -1769,6 +1769,22 @@ static void emit_jmpreg(u_int r)
   output_w32(0xe1a00000|rd_rn_rm(15,0,r));
 }
 */
+// Increment a counter in memory.  No host register is known to be free
+// here, so r0/r1 are saved on the stack.  ADD without S leaves the flags.
+static void emit_incmem(int addr)
+{
+  assem_debug("push {r0,r1}");
+  output_w32(0xe92d0003);
+  emit_movimm(addr,0);
+  assem_debug("ldr r1,[r0]");
+  output_w32(0xe5900000|rd_rn_rm(1,0,0));
+  assem_debug("add r1,r1,#1");
+  output_w32(0xe2800001|rd_rn_rm(1,1,0));
+  assem_debug("str r1,[r0]");
+  output_w32(0xe5800000|rd_rn_rm(1,0,0));
+  assem_debug("pop {r0,r1}");
+  output_w32(0xe8bd0003);
+}
 static void emit_readword_indexed(int offset, int rs, int rt)
 {
   assert(offset>-4096&&offset<4096);
@@ -35,6 +35,10 @@
 
 #include "../../memory/memory.h"
 #include "../../main/rom.h"
+#ifdef PROFILE_R4300
+#include <unistd.h>
+#include "../../debugger/dbg_decoder.h"
+#endif
 
 #include <sys/mman.h>
 #ifdef __QNXNTO__
@@ -49,6 +53,10 @@
 #error Unsupported dynarec architecture
 #endif
 
+#if defined(PROFILE_R4300) && NEW_DYNAREC != NEW_DYNAREC_ARM
+#error The block profile needs emit_incmem(), which only the ARM backend has
+#endif
+
 #ifdef __QNX__
 #undef __clear_cache
 #define __clear_cache(start,end) msync(start, (size_t)((void*)end - (void*)start), MS_SYNC | MS_CACHE_ONLY | MS_INVALIDATE_ICACHE);
@@ -142,6 +150,21 @@ u_int hash_table[65536][4]  __attribute__((aligned(16)));
 static char shadow[2097152]  __attribute__((aligned(16)));
 static void *copy;
 static int expirep;
+#ifdef PROFILE_R4300
+struct block_profile
+{
+  u_int vaddr;
+  u_int host_addr;
+  u_int host_len;
+  u_int slen;
+  u_int *source;
+  u_int count;
+};
+#define MAX_PROFILED_BLOCKS 65536
+static struct block_profile block_profile[MAX_PROFILED_BLOCKS];
+static int profiled_blocks;
+static FILE *perf_map;
+#endif
 u_int using_tlb;
 static u_int stop_after_jal;
 extern u_char restore_candidate[512];
@@ -7551,6 +7574,138 @@ static void disassemble_inst(int i)
 }
 #endif
 
+#ifdef PROFILE_R4300
+/* Block profiling
+ *
+ * Every compiled block gets a line in /tmp/perf-<pid>.map so that perf can
+ * attribute samples in the translation cache to guest code, and a counter
+ * which is incremented each time the block is entered at its first
+ * instruction.  new_dynarec_profile_report() writes the hottest blocks with
+ * their MIPS disassembly.  It is built for the ARM backend only, the one
+ * the Makefile builds new_dynarec with.
+ */
+
+static void profile_block(u_int beginning)
+{
+  if(perf_map) {
+    fprintf(perf_map,"%x %x mips_%08x\n",beginning,(u_int)out-beginning,start);
+    fflush(perf_map);
+  }
+  if(profiled_blocks<MAX_PROFILED_BLOCKS) {
+    struct block_profile *p=&block_profile[profiled_blocks++];
+    p->vaddr=start;
+    p->host_addr=beginning;
+    p->host_len=(u_int)out-beginning;
+    p->slen=slen;
+    p->source=(u_int *)malloc(slen*4);
+    if(p->source) memcpy(p->source,source,slen*4);
+  }
+}
+
+static int profile_cmp_vaddr(const void *a,const void *b)
+{
+  const struct block_profile *pa=(const struct block_profile *)a;
+  const struct block_profile *pb=(const struct block_profile *)b;
+  if(pa->vaddr!=pb->vaddr) return pa->vaddr<pb->vaddr?-1:1;
+  return 0;
+}
+
+static int profile_cmp_count(const void *a,const void *b)
+{
+  const struct block_profile *pa=(const struct block_profile *)a;
+  const struct block_profile *pb=(const struct block_profile *)b;
+  if(pa->count!=pb->count) return pa->count>pb->count?-1:1;
+  return 0;
+}
+
+#define PROFILE_REPORT_BLOCKS 100
+#define PROFILE_REPORT_INSNS 64
+
+void new_dynarec_profile_report(const char *filename)
+{
+  struct block_profile *sorted;
+  uint64_t total=0;
+  int count=profiled_blocks;
+  int merged=0;
+  int i,j;
+  FILE *f;
+
+  if(filename==NULL) filename="dynarec_profile.txt";
+  if(count==0) return;
+  sorted=(struct block_profile *)malloc(count*sizeof(struct block_profile));
+  if(sorted==NULL) return;
+  memcpy(sorted,block_profile,count*sizeof(struct block_profile));
+
+  // A block which was recompiled (after invalidation or expiry) has
+  // several entries, add them up under the most recent translation.
+  qsort(sorted,count,sizeof(struct block_profile),profile_cmp_vaddr);
+  for(i=0;i<count;i++) {
+    if(merged>0&&sorted[merged-1].vaddr==sorted[i].vaddr) {
+      u_int sum=sorted[merged-1].count+sorted[i].count;
+      sorted[merged-1]=sorted[i];
+      sorted[merged-1].count=sum;
+    }
+    else sorted[merged++]=sorted[i];
+    total+=sorted[i].count;
+  }
+  qsort(sorted,merged,sizeof(struct block_profile),profile_cmp_count);
+
+  f=fopen(filename,"w");
+  if(f==NULL) {
+    DebugMessage(M64MSG_ERROR, "Couldn't open dynarec profile '%s' for writing", filename);
+    free(sorted);
+    return;
+  }
+  fprintf(f,"%d translations of %d blocks, %llu block entries\n\n",count,merged,(unsigned long long)total);
+  for(i=0;i<merged&&i<PROFILE_REPORT_BLOCKS;i++) {
+    struct block_profile *p=&sorted[i];
+    if(p->count==0) break;
+    fprintf(f,"#%d %08x: %u entries (%.2f%%), %d instructions, host %08x-%08x\n",
+            i+1,p->vaddr,p->count,total?p->count*100.0/total:0.0,p->slen,p->host_addr,p->host_addr+p->host_len);
+    if(p->source==NULL) continue;
+    for(j=0;j<(int)p->slen&&j<PROFILE_REPORT_INSNS;j++) {
+      char op[64];
+      char args[128];
+      r4300_decode_op(p->source[j],op,args,p->vaddr+j*4);
+      fprintf(f,"  %08x: %08x  %-8s %s\n",p->vaddr+j*4,p->source[j],op,args);
+    }
+    if(j<(int)p->slen) fprintf(f,"  ...\n");
+    fprintf(f,"\n");
+  }
+  fclose(f);
+  free(sorted);
+  DebugMessage(M64MSG_INFO, "Wrote dynarec profile of %d blocks to %s", merged, filename);
+}
+
+static void profile_init(void)
+{
+  char filename[64];
+  int i;
+  for(i=0;i<profiled_blocks;i++)
+    free(block_profile[i].source);
+  memset(block_profile,0,sizeof(block_profile));
+  profiled_blocks=0;
+  sprintf(filename,"/tmp/perf-%d.map",(int)getpid());
+  perf_map=fopen(filename,"w");
+  if(perf_map==NULL) DebugMessage(M64MSG_WARNING, "Couldn't open %s", filename);
+}
+
+static void profile_cleanup(void)
+{
+  int i;
+  new_dynarec_profile_report(NULL);
+  for(i=0;i<profiled_blocks;i++) {
+    free(block_profile[i].source);
+    block_profile[i].source=NULL;
+  }
+  profiled_blocks=0;
+  if(perf_map) {
+    fclose(perf_map);
+    perf_map=NULL;
+  }
+}
+#endif
+
 void new_dynarec_init()
 {
   DebugMessage(M64MSG_INFO, "Init new dynarec");
@@ -7624,11 +7779,17 @@ void new_dynarec_init()
   }
   tlb_hacks();
   arch_init();
+#ifdef PROFILE_R4300
+  profile_init();
+#endif
 }
 
 void new_dynarec_cleanup()
 {
   int n;
+#ifdef PROFILE_R4300
+  profile_cleanup();
+#endif
   if (munmap (base_addr, 1<<TARGET_SIZE_2) < 0) {DebugMessage(M64MSG_ERROR, "munmap() failed");}
   for(n=0;n<4096;n++) ll_clear(jump_in+n);
   for(n=0;n<4096;n++) ll_clear(jump_out+n);
@@ -10595,6 +10756,11 @@ int new_recompile_block(int addr)
       // branch target entry point
       instr_addr[i]=(u_int)out;
       assem_debug("<->");
+      #ifdef PROFILE_R4300
+      // Count entries to the block, including loops back to its start
+      if(i==0&&profiled_blocks<MAX_PROFILED_BLOCKS)
+        emit_incmem((int)&block_profile[profiled_blocks].count);
+      #endif
       // load regs
       if(regs[i].regmap_entry[HOST_CCREG]==CCREG&&regs[i].regmap[HOST_CCREG]!=CCREG)
         wb_register(CCREG,regs[i].regmap_entry,regs[i].wasdirty,regs[i].was32);
@@ -10847,6 +11013,9 @@ int new_recompile_block(int addr)
   //DebugMessage(M64MSG_VERBOSE, "shadow buffer: %x-%x",(int)copy,(int)copy+slen*4);
   memcpy(copy,source,slen*4);
   copy+=slen*4;
+  #ifdef PROFILE_R4300
+  profile_block(beginning);
+  #endif
 
   #if NEW_DYNAREC == NEW_DYNAREC_ARM
   __clear_cache((void *)beginning,out);
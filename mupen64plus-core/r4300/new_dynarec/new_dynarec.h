@@ -34,5 +34,8 @@ void invalidate_block(unsigned int block);
 void new_dynarec_init(void);
 void new_dyna_start(void);
 void new_dynarec_cleanup(void);
+#ifdef PROFILE_R4300
+void new_dynarec_profile_report(const char *filename);
+#endif
 
 #endif /* NEW_DYNAREC_H */
@@ -388,6 +388,9 @@ static void prefetch(void)
    unsigned int *mem = fast_mem_access(interp_PC.addr);
    if (mem != NULL)
    {
+#ifdef COMPARE_CORE
+      op = mem[0];   /* for CoreCompareCallback() */
+#endif
       prefetch_opcode(mem[0], mem[1]);
    }
    else
@@ -774,11 +774,7 @@ void r4300_reset_hard(void)
         tlb_e[i].end_odd=0;
         tlb_e[i].phys_odd=0;
     }
-    for (i=0; i<0x100000; i++)
-    {
-        tlb_LUT_r[i] = 0;
-        tlb_LUT_w[i] = 0;
-    }
+    tlb_clear();
     llbit=0;
     hi=0;
     lo=0;
@@ -970,7 +966,7 @@ static void dynarec_setup_code(void)
 
 void r4300_execute(void)
 {
-#if defined(COUNT_INSTR) || (defined(DYNAREC) && defined(PROFILE_R4300))
+#if defined(COUNT_INSTR) || (defined(DYNAREC) && defined(PROFILE_R4300) && !defined(NEW_DYNAREC))
     unsigned int i;
 #endif
 
@@ -1011,7 +1007,7 @@ void r4300_execute(void)
         dyna_start(dynarec_setup_code);
         PC++;
 #endif
-#if defined(PROFILE_R4300)
+#if defined(PROFILE_R4300) && !defined(NEW_DYNAREC)
         pfProfile = fopen("instructionaddrs.dat", "ab");
         for (i=0; i<0x100000; i++)
             if (invalid_code[i] == 0 && blocks[i] != NULL && blocks[i]->code != NULL && blocks[i]->block != NULL)
@@ -59,16 +59,7 @@
 #define DH 6
 #define BH 7
 
-typedef struct _reg_cache_struct
-{
-   int need_map;
-   void *needed_registers[8];
-   unsigned char jump_wrapper[84];
-   int need_cop1_check;
-} reg_cache_struct;
-
 extern int branch_taken;
-extern int dynarec_stack_initialized;
 
 void jump_start_rel8(void);
 void jump_end_rel8(void);
@@ -193,6 +193,19 @@ void reload_registers(void)
   }
 }
 
+static int stack_saved_count(void)
+{
+  int i, count = 0;
+
+  for (i=0; i<8; i++)
+    if (last_access[i])
+      count++;
+
+  return count;
+}
+
+/* the generated code runs with rsp 16-byte aligned, so an odd number of pushes is padded to keep it aligned
+ * for the C function called between these two */
 void stack_save_registers(void)
 {
   int i;
@@ -204,12 +217,16 @@ void stack_save_registers(void)
       push_reg64(i);
     }
   }
+  if (stack_saved_count() & 1)
+    sub_reg64_imm32(RSP, 8);
 }
 
 void stack_load_registers(void)
 {
   int i;
 
+  if (stack_saved_count() & 1)
+    add_reg64_imm32(RSP, 8);
   for (i=7; i>=0; i--)
   {
     if (last_access[i])
@@ -296,7 +313,7 @@ int allocate_register_32(unsigned int *addr)
           last++;
         }
         last_access[i] = dst;
-        is64bits[i] = 0;
+        /* a 32-bit read leaves a 64-bit value as it is: it still has to be written back whole */
         return i;
       }
     }
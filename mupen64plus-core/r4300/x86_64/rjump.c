@@ -30,8 +30,6 @@
 #include "r4300/ops.h"
 #include "r4300/recomph.h"
 
-extern int dynarec_stack_initialized;  /* in gr4300.c */
-
 void dyna_jump(void)
 {
     if (stop == 1)
@@ -46,8 +44,11 @@ void dyna_jump(void)
         *return_address = (unsigned long) (actual->code + PC->local_addr);
 }
 
-static long save_rsp = 0;
-static long save_rip = 0;
+long save_rsp = 0;
+long save_rip = 0;
+
+/* that's where the dynarec will restart when going back from a C function */
+unsigned long *return_address;
 
 void dyna_start(void (*code)(void))
 {
@@ -76,6 +77,11 @@ void dyna_start(void (*code)(void))
          "1:                    \n"
          " pop  %%rax           \n"
          " mov  %%rax, _save_rip(%%rip) \n"
+         " sub  $0x10, %%rsp    \n"
+         " and  $-16, %%rsp     \n"  /* ensure that stack is 16-byte aligned */
+         " mov  %%rsp, %%rax    \n"
+         " sub  $8, %%rax       \n"
+         " mov  %%rax, _return_address(%%rip) \n"
          " call *%%rbx          \n"
          "2:                    \n"
          " mov  _save_rsp(%%rip), %%rsp \n"
@@ -105,6 +111,11 @@ void dyna_start(void (*code)(void))
          "1:                    \n"
          " pop  %%rax           \n"
          " mov  %%rax, save_rip(%%rip) \n"
+         " sub  $0x10, %%rsp    \n"
+         " and  $-16, %%rsp     \n"  /* ensure that stack is 16-byte aligned */
+         " mov  %%rsp, %%rax    \n"
+         " sub  $8, %%rax       \n"
+         " mov  %%rax, return_address(%%rip) \n"
          " call *%%rbx          \n"
          "2:                    \n"
          " mov  save_rsp(%%rip), %%rsp \n"
@@ -135,6 +146,11 @@ void dyna_start(void (*code)(void))
        "1:                    \n"
        " pop  %%rax           \n"
        " mov  %%rax, save_rip \n"
+       " sub  $0x10, %%rsp    \n"
+       " and  $-16, %%rsp     \n"  /* ensure that stack is 16-byte aligned */
+       " mov  %%rsp, %%rax    \n"
+       " sub  $8, %%rax       \n"
+       " mov  %%rax, return_address \n"
        " call *%%rbx          \n"
        "2:                    \n"
        " mov  save_rsp, %%rsp \n"
@@ -151,9 +167,6 @@ void dyna_start(void (*code)(void))
   #endif
 #endif
 
-    /* clear flag; stack is back to normal */
-    dynarec_stack_initialized = 0;
-
     /* clear the registers so we don't return here a second time; that would be a bug */
     save_rsp=0;
     save_rip=0;
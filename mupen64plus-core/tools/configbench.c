@@ -0,0 +1,250 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - configbench.c                                           *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* configbench - times configuration parameter lookups in the core library
+ *
+ * Usage: configbench [options] <core library>
+ *
+ * Starts the core with an empty configuration of its own, fills one section with a number of integer and string
+ * parameters, and reads them back in a scrambled order three ways: ConfigGetParamInt() by name, which hashes the name
+ * and searches the section, ConfigGetParamHandle() followed by ConfigGetHandleInt(), which is what a caller pays
+ * the first time, and ConfigGetHandleInt() / ConfigGetHandleString() with handles looked up beforehand, which is what
+ * the plugins do on their hot paths. It prints nanoseconds per read for each section size.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <ftw.h>
+
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_config.h"
+#include "api/m64p_frontend.h"
+#include "main/version.h"
+
+static ptr_ConfigOpenSection      fConfigOpenSection;
+static ptr_ConfigSetDefaultInt    fConfigSetDefaultInt;
+static ptr_ConfigSetDefaultString fConfigSetDefaultString;
+static ptr_ConfigGetParamInt      fConfigGetParamInt;
+static ptr_ConfigGetParamString   fConfigGetParamString;
+static ptr_ConfigGetParamHandle   fConfigGetParamHandle;
+static ptr_ConfigGetHandleInt     fConfigGetHandleInt;
+static ptr_ConfigGetHandleString  fConfigGetHandleString;
+
+static volatile long l_Sink; /* keeps the reads from being optimized away */
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void debug_callback(void *context, int level, const char *message)
+{
+    if (level <= M64MSG_ERROR)
+        fprintf(stderr, "%s: %s\n", (const char *) context, message);
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf)
+{
+    return remove(path);
+}
+
+static int bench_section(int numparams, unsigned int reads)
+{
+    char sectionname[32];
+    char (*names)[32];
+    m64p_handle section;
+    m64p_param_handle *handles;
+    int *order;
+    unsigned int i;
+    double start, byname, gethandle, byhandle, strbyname, strbyhandle;
+    long sum = 0;
+
+    names = malloc(numparams * sizeof(*names));
+    handles = (m64p_param_handle *) malloc(numparams * sizeof(m64p_param_handle));
+    order = (int *) malloc(numparams * sizeof(int));
+    if (names == NULL || handles == NULL || order == NULL)
+        return 0;
+
+    sprintf(sectionname, "Bench%d", numparams);
+    if ((*fConfigOpenSection)(sectionname, &section) != M64ERR_SUCCESS)
+        return 0;
+    for (i = 0; i < (unsigned int) numparams; i++)
+    {
+        /* names like the plugins', sharing long prefixes */
+        sprintf(names[i], "%sParameter%d", (i & 1) ? "Texture" : "Frame", i);
+        if ((i & 3) == 3)
+            (*fConfigSetDefaultString)(section, names[i], "string value", "A string parameter");
+        else
+            (*fConfigSetDefaultInt)(section, names[i], (int) i, "An integer parameter");
+        if ((*fConfigGetParamHandle)(section, names[i], &handles[i]) != M64ERR_SUCCESS)
+            return 0;
+        order[i] = i;
+    }
+    /* read them in a fixed scrambled order, so that the lookups don't follow the section list */
+    srand(numparams);
+    for (i = numparams - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1), t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    start = now();
+    for (i = 0; i < reads; i++)
+        sum += (*fConfigGetParamInt)(section, names[order[i % numparams]]);
+    byname = now() - start;
+
+    start = now();
+    for (i = 0; i < reads; i++)
+    {
+        m64p_param_handle handle;
+        (*fConfigGetParamHandle)(section, names[order[i % numparams]], &handle);
+        sum += (*fConfigGetHandleInt)(handle);
+    }
+    gethandle = now() - start;
+
+    start = now();
+    for (i = 0; i < reads; i++)
+        sum += (*fConfigGetHandleInt)(handles[order[i % numparams]]);
+    byhandle = now() - start;
+
+    start = now();
+    for (i = 0; i < reads; i++)
+        sum += (*fConfigGetParamString)(section, names[order[i % numparams]])[0];
+    strbyname = now() - start;
+
+    start = now();
+    for (i = 0; i < reads; i++)
+        sum += (*fConfigGetHandleString)(handles[order[i % numparams]])[0];
+    strbyhandle = now() - start;
+
+    l_Sink = sum;
+    printf("%8d %12.1f %12.1f %12.1f %12.1f %12.1f\n", numparams, byname * 1e9 / reads, gethandle * 1e9 / reads,
+           byhandle * 1e9 / reads, strbyname * 1e9 / reads, strbyhandle * 1e9 / reads);
+
+    free(names);
+    free(handles);
+    free(order);
+    return 1;
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options] <core library>\n", program);
+    printf("  --reads N              reads per measurement (default 1000000)\n");
+    printf("  --params N             section size, may be given more than once (default 8, 32, 128 and 512)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *corename = NULL;
+    unsigned int reads = 1000000;
+    int sizes[16], numsizes = 0, arg, i, status = 0;
+    void *lib;
+    ptr_CoreStartup fCoreStartup;
+    ptr_CoreShutdown fCoreShutdown;
+    char configdir[] = "/tmp/configbench.XXXXXX";
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--reads") == 0 && arg + 1 < argc)
+            reads = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--params") == 0 && arg + 1 < argc && numsizes < 16)
+            sizes[numsizes++] = atoi(argv[++arg]);
+        else if (corename == NULL)
+            corename = argv[arg];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    for (i = 0; i < numsizes; i++)
+        if (sizes[i] < 1 || sizes[i] > 100000)
+            corename = NULL;
+    if (corename == NULL || reads == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if (numsizes == 0)
+    {
+        sizes[numsizes++] = 8;
+        sizes[numsizes++] = 32;
+        sizes[numsizes++] = 128;
+        sizes[numsizes++] = 512;
+    }
+
+    lib = dlopen(corename, RTLD_NOW | RTLD_LOCAL);
+    if (lib == NULL)
+    {
+        fprintf(stderr, "Error: can't load '%s': %s\n", corename, dlerror());
+        return 2;
+    }
+    fCoreStartup = (ptr_CoreStartup) dlsym(lib, "CoreStartup");
+    fCoreShutdown = (ptr_CoreShutdown) dlsym(lib, "CoreShutdown");
+    fConfigOpenSection = (ptr_ConfigOpenSection) dlsym(lib, "ConfigOpenSection");
+    fConfigSetDefaultInt = (ptr_ConfigSetDefaultInt) dlsym(lib, "ConfigSetDefaultInt");
+    fConfigSetDefaultString = (ptr_ConfigSetDefaultString) dlsym(lib, "ConfigSetDefaultString");
+    fConfigGetParamInt = (ptr_ConfigGetParamInt) dlsym(lib, "ConfigGetParamInt");
+    fConfigGetParamString = (ptr_ConfigGetParamString) dlsym(lib, "ConfigGetParamString");
+    fConfigGetParamHandle = (ptr_ConfigGetParamHandle) dlsym(lib, "ConfigGetParamHandle");
+    fConfigGetHandleInt = (ptr_ConfigGetHandleInt) dlsym(lib, "ConfigGetHandleInt");
+    fConfigGetHandleString = (ptr_ConfigGetHandleString) dlsym(lib, "ConfigGetHandleString");
+    if (fCoreStartup == NULL || fCoreShutdown == NULL || fConfigOpenSection == NULL || fConfigSetDefaultInt == NULL ||
+        fConfigSetDefaultString == NULL || fConfigGetParamInt == NULL || fConfigGetParamString == NULL ||
+        fConfigGetParamHandle == NULL || fConfigGetHandleInt == NULL || fConfigGetHandleString == NULL)
+    {
+        fprintf(stderr, "Error: '%s' is not a Mupen64Plus core library with parameter handles\n", corename);
+        dlclose(lib);
+        return 2;
+    }
+
+    /* a configuration of our own, so that the user's doesn't change the numbers */
+    if (mkdtemp(configdir) == NULL ||
+        (*fCoreStartup)(FRONTEND_API_VERSION, configdir, NULL, "Core", debug_callback, NULL, NULL) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "Error: core startup failed\n");
+        dlclose(lib);
+        return 2;
+    }
+
+    printf("ns per read %27s %12s %12s %12s\n", "int", "", "string", "");
+    printf("%8s %12s %12s %12s %12s %12s\n", "params", "by name", "get handle", "by handle", "by name", "by handle");
+    for (i = 0; i < numsizes && status == 0; i++)
+        if (!bench_section(sizes[i], reads))
+        {
+            fprintf(stderr, "Error: can't create a section with %d parameters\n", sizes[i]);
+            status = 2;
+        }
+
+    (*fCoreShutdown)();
+    dlclose(lib);
+    nftw(configdir, remove_entry, 8, FTW_DEPTH | FTW_PHYS);
+    return status;
+}
@@ -0,0 +1,189 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dlcheck.c                                               *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* dlcheck - records a display list trace of a made-up game, for the capture and replay round trip check
+ *
+ * Usage: dlcheck [frames] <trace file> <log file>
+ *
+ * Runs plugin/dlist_capture.c the way the core does, on RDRAM, DMEM and VI registers of its own: every frame the
+ * "game" writes RDRAM, changes some VI registers and sends a display list, then the screen is updated. The video
+ * plugin behind the capture is a function here which writes to the log what it gets, like tools/dlcheckplugin.c does
+ * when dlreplay plays the trace back, and then draws into RDRAM, which the capture has to pick up. "make dlcheck" runs
+ * both and compares the two logs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+#include "main/rom.h"
+#include "memory/memory.h"
+#include "plugin/plugin.h"
+#include "plugin/dlist_capture.h"
+
+/* the core state plugin/dlist_capture.c reads */
+ALIGN(16, unsigned int rdram[0x800000/4]);
+unsigned int SP_DMEM[0x1000/4*2];
+VI_register vi_register;
+unsigned char *rom;
+gfx_plugin_functions gfx;
+
+static unsigned char l_RomHeader[64];
+static FILE *l_Log = NULL;
+static unsigned int l_LoggedVI[2];      /* VI_STATUS and VI_WIDTH the plugin was told about */
+static unsigned int l_FrameBuffer;
+
+void DebugMessage(int level, const char *message, ...)
+{
+    va_list args;
+    if (level > M64MSG_WARNING)
+        return;
+    va_start(args, message);
+    vfprintf(stderr, message, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+/* the same as in tools/dlcheckplugin.c */
+static unsigned long long hash_words(const unsigned int *words, unsigned int count, unsigned long long hash)
+{
+    unsigned int i;
+    for (i = 0; i < count; i++)
+        hash = (hash ^ words[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+static void log_call(const char *name)
+{
+    unsigned int regs[14];
+
+    /* dlreplay calls ViStatusChanged() and ViWidthChanged() before the call the registers were recorded with */
+    if (vi_register.vi_status != l_LoggedVI[0])
+        fprintf(l_Log, "ViStatusChanged %08x\n", vi_register.vi_status);
+    if (vi_register.vi_width != l_LoggedVI[1])
+        fprintf(l_Log, "ViWidthChanged %08x\n", vi_register.vi_width);
+    l_LoggedVI[0] = vi_register.vi_status;
+    l_LoggedVI[1] = vi_register.vi_width;
+
+    regs[0] = vi_register.vi_status;
+    regs[1] = vi_register.vi_origin;
+    regs[2] = vi_register.vi_width;
+    regs[3] = vi_register.vi_v_intr;
+    regs[4] = vi_register.vi_current;
+    regs[5] = vi_register.vi_burst;
+    regs[6] = vi_register.vi_v_sync;
+    regs[7] = vi_register.vi_h_sync;
+    regs[8] = vi_register.vi_leap;
+    regs[9] = vi_register.vi_h_start;
+    regs[10] = vi_register.vi_v_start;
+    regs[11] = vi_register.vi_v_burst;
+    regs[12] = vi_register.vi_x_scale;
+    regs[13] = vi_register.vi_y_scale;
+    fprintf(l_Log, "%s rdram %016llx task %016llx vi %016llx\n", name,
+            hash_words(rdram, sizeof(rdram) / 4, 0xCBF29CE484222325ULL),
+            hash_words(SP_DMEM + DLTRACE_TASK_OFFSET / 4, DLTRACE_TASK_SIZE / 4, 0xCBF29CE484222325ULL),
+            hash_words(regs, 14, 0xCBF29CE484222325ULL));
+}
+
+static void check_ProcessDList(void)
+{
+    unsigned int i;
+
+    log_call("ProcessDList");
+
+    /* the plugin renders to RDRAM */
+    for (i = 0; i < 320 * 4; i++)
+        rdram[(l_FrameBuffer >> 2) + i] = (i << 16) ^ l_FrameBuffer ^ (unsigned int) rand();
+}
+
+static void check_UpdateScreen(void)
+{
+    log_call("UpdateScreen");
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 3 ? atoi(argv[1]) : 120;
+    const char *tracename = argv[argc - 2], *logname = argv[argc - 1];
+    int frame, i;
+
+    if (argc < 3 || argc > 4 || frames <= 0)
+    {
+        fprintf(stderr, "Usage: dlcheck [frames] <trace file> <log file>\n");
+        return 1;
+    }
+    l_Log = fopen(logname, "w");
+    if (l_Log == NULL)
+    {
+        fprintf(stderr, "Error: can't write '%s'\n", logname);
+        return 1;
+    }
+    srand(1);
+
+    memcpy(l_RomHeader, "\x80\x37\x12\x40" "DLCHECK", 11);
+    rom = l_RomHeader;
+    gfx.processDList = check_ProcessDList;
+    gfx.updateScreen = check_UpdateScreen;
+
+    /* a game loaded in RDRAM, then a blank first frame */
+    for (i = 0; i < 0x100000 / 4; i++)
+        rdram[0x100000 / 4 + i] = (unsigned int) rand();
+    if (!dlist_capture_start(tracename))
+        return 1;
+    dlist_capture_UpdateScreen();
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        /* the game writes a few scattered words and a block, sometimes the same values again */
+        for (i = 0; i < 64; i++)
+        {
+            unsigned int word = (unsigned int) rand() % (sizeof(rdram) / 4);
+            rdram[word] = (frame % 7 == 0) ? rdram[word] : (unsigned int) rand();
+        }
+        memset((unsigned char *) rdram + 0x200000 + (frame % 16) * 0x2000, frame, 0x1800);
+
+        /* double buffering, and modes switched now and then */
+        l_FrameBuffer = (frame & 1) ? 0x380000 : 0x3C0000;
+        vi_register.vi_origin = l_FrameBuffer;
+        vi_register.vi_current = frame;
+        if (frame % 40 == 0)
+        {
+            vi_register.vi_status = 0x3000 | (frame / 40 + 2);
+            vi_register.vi_width = frame % 80 == 0 ? 320 : 640;
+            vi_register.vi_x_scale = vi_register.vi_width * 2;
+            vi_register.vi_y_scale = 0x400 + frame;
+        }
+
+        /* the OSTask header of the display list, with the rest of DMEM the plugin doesn't read */
+        for (i = 0; i < 0x1000 / 4; i++)
+            SP_DMEM[i] = (unsigned int) rand();
+        dlist_capture_ProcessDList();
+        if (frame % 5 == 4)
+            dlist_capture_ProcessDList();   /* a second list in the same frame */
+        dlist_capture_UpdateScreen();
+    }
+
+    dlist_capture_stop();
+    fclose(l_Log);
+    return 0;
+}
@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dlcheckplugin.c                                         *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* dlcheckplugin - a video plugin which logs what it gets, for the capture and replay round trip check
+ *
+ * Usage: dlreplay --set DLCheck[Log]=<log file> dlcheckplugin.so <trace file>
+ *
+ * It draws nothing. Each ProcessDList() and UpdateScreen() call is written to the log with hashes of RDRAM, of the
+ * OSTask header in DMEM and of the VI registers, and so are the ViStatusChanged() and ViWidthChanged() calls, in the
+ * format of tools/dlcheck.c, which logs the calls the same way when it records the trace.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <dlfcn.h>
+
+#define M64P_PLUGIN_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_plugin.h"
+#include "api/m64p_config.h"
+#include "plugin/dlist_capture.h"
+
+static GFX_INFO l_GfxInfo;
+static FILE *l_Log = NULL;
+static ptr_ConfigOpenSection   fConfigOpenSection;
+static ptr_ConfigGetParamString fConfigGetParamString;
+
+/* the same as in tools/dlcheck.c */
+static unsigned long long hash_words(const unsigned int *words, unsigned int count, unsigned long long hash)
+{
+    unsigned int i;
+    for (i = 0; i < count; i++)
+        hash = (hash ^ words[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+static void log_call(const char *name)
+{
+    unsigned int regs[14];
+
+    if (l_Log == NULL)
+        return;
+
+    regs[0] = *l_GfxInfo.VI_STATUS_REG;
+    regs[1] = *l_GfxInfo.VI_ORIGIN_REG;
+    regs[2] = *l_GfxInfo.VI_WIDTH_REG;
+    regs[3] = *l_GfxInfo.VI_INTR_REG;
+    regs[4] = *l_GfxInfo.VI_V_CURRENT_LINE_REG;
+    regs[5] = *l_GfxInfo.VI_TIMING_REG;
+    regs[6] = *l_GfxInfo.VI_V_SYNC_REG;
+    regs[7] = *l_GfxInfo.VI_H_SYNC_REG;
+    regs[8] = *l_GfxInfo.VI_LEAP_REG;
+    regs[9] = *l_GfxInfo.VI_H_START_REG;
+    regs[10] = *l_GfxInfo.VI_V_START_REG;
+    regs[11] = *l_GfxInfo.VI_V_BURST_REG;
+    regs[12] = *l_GfxInfo.VI_X_SCALE_REG;
+    regs[13] = *l_GfxInfo.VI_Y_SCALE_REG;
+    fprintf(l_Log, "%s rdram %016llx task %016llx vi %016llx\n", name,
+            hash_words((const unsigned int *) l_GfxInfo.RDRAM, 0x800000 / 4, 0xCBF29CE484222325ULL),
+            hash_words((const unsigned int *) (l_GfxInfo.DMEM + DLTRACE_TASK_OFFSET), DLTRACE_TASK_SIZE / 4,
+                       0xCBF29CE484222325ULL),
+            hash_words(regs, 14, 0xCBF29CE484222325ULL));
+}
+
+EXPORT m64p_error CALL PluginStartup(m64p_dynlib_handle CoreLibHandle, void *Context,
+                                     void (*DebugCallback)(void *, int, const char *))
+{
+    fConfigOpenSection = (ptr_ConfigOpenSection) dlsym(CoreLibHandle, "ConfigOpenSection");
+    fConfigGetParamString = (ptr_ConfigGetParamString) dlsym(CoreLibHandle, "ConfigGetParamString");
+    if (fConfigOpenSection == NULL || fConfigGetParamString == NULL)
+        return M64ERR_INCOMPATIBLE;
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL PluginShutdown(void)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL PluginGetVersion(m64p_plugin_type *PluginType, int *PluginVersion, int *APIVersion,
+                                        const char **PluginNamePtr, int *Capabilities)
+{
+    if (PluginType != NULL)
+        *PluginType = M64PLUGIN_GFX;
+    if (PluginVersion != NULL)
+        *PluginVersion = 0x010000;
+    if (APIVersion != NULL)
+        *APIVersion = 0x020200;
+    if (PluginNamePtr != NULL)
+        *PluginNamePtr = "Display list check";
+    if (Capabilities != NULL)
+        *Capabilities = 0;
+    return M64ERR_SUCCESS;
+}
+
+EXPORT int CALL InitiateGFX(GFX_INFO Gfx_Info)
+{
+    l_GfxInfo = Gfx_Info;
+    return 1;
+}
+
+EXPORT int CALL RomOpen(void)
+{
+    m64p_handle section;
+    const char *logname;
+
+    if (fConfigOpenSection("DLCheck", &section) != M64ERR_SUCCESS ||
+        (logname = fConfigGetParamString(section, "Log")) == NULL || logname[0] == '\0')
+        return 0;
+    l_Log = fopen(logname, "w");
+    return l_Log != NULL;
+}
+
+EXPORT void CALL RomClosed(void)
+{
+    if (l_Log != NULL)
+        fclose(l_Log);
+    l_Log = NULL;
+}
+
+EXPORT void CALL ProcessDList(void)
+{
+    log_call("ProcessDList");
+}
+
+EXPORT void CALL UpdateScreen(void)
+{
+    log_call("UpdateScreen");
+}
+
+EXPORT void CALL ViStatusChanged(void)
+{
+    if (l_Log != NULL)
+        fprintf(l_Log, "ViStatusChanged %08x\n", *l_GfxInfo.VI_STATUS_REG);
+}
+
+EXPORT void CALL ViWidthChanged(void)
+{
+    if (l_Log != NULL)
+        fprintf(l_Log, "ViWidthChanged %08x\n", *l_GfxInfo.VI_WIDTH_REG);
+}
+
+EXPORT void CALL ChangeWindow(void) {}
+EXPORT void CALL MoveScreen(int x, int y) {}
+EXPORT void CALL ProcessRDPList(void) {}
+EXPORT void CALL ShowCFB(void) {}
+EXPORT void CALL ReadScreen2(void *dest, int *width, int *height, int front) {}
+EXPORT void CALL SetRenderingCallback(void (*callback)(int)) {}
+EXPORT void CALL ResizeVideoOutput(int width, int height) {}
@@ -0,0 +1,733 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dlreplay.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* dlreplay - runs a video plugin on a display list trace, without the emulator and without drawing
+ *
+ * Usage: dlreplay [options] <video plugin> <trace file>
+ *
+ * The trace is recorded by the core when its DListCapture parameter is set (see plugin/dlist_capture.h). dlreplay
+ * plays the part of the core for the plugin: it answers the plugin's Config and VidExt calls itself (parameters only
+ * live in memory and start at their defaults), and the GL functions are taken by nullgl.c, so what's measured is the
+ * CPU side of the plugin: display list parsing, vertex processing, combiners and texture decoding/caching.
+ *
+ * The time spent in each ProcessDList() and UpdateScreen() call is reported at the end. A breakdown per GBI command is
+ * printed by the plugin itself when it is built with its profiler on (gles2n64: PROFILE_GBI, Rice: make PROFILE=1).
+ *
+ * The trace holds RDRAM as the core keeps it in memory, so it has to be replayed on a machine of the same byte order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <dlfcn.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_plugin.h"
+#include "api/m64p_config.h"
+#include "api/m64p_vidext.h"
+#include "main/version.h"
+#include "plugin/dlist_capture.h"
+
+#ifdef __cplusplus
+extern "C"
+#endif
+void *nullgl_GetProcAddress(const char *name);
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* Config: sections and parameters kept as strings, nothing is read from or written to disk */
+
+typedef struct config_param
+{
+    char                *name;
+    char                *value;
+    m64p_type            type;
+    struct config_param *next;
+} config_param;
+
+typedef struct config_section
+{
+    char                  *name;
+    config_param          *params;
+    struct config_section *next;
+} config_section;
+
+static config_section *l_Sections = NULL;
+static const char *l_DataPath = ".";
+static char l_FilePath[1024];
+static int l_Verbose = 0;
+
+static char *copy_string(const char *str)
+{
+    char *copy = (char *) malloc(strlen(str) + 1);
+    strcpy(copy, str);
+    return copy;
+}
+
+static config_section *find_section(const char *name, int create)
+{
+    config_section *section;
+
+    for (section = l_Sections; section != NULL; section = section->next)
+        if (strcasecmp(section->name, name) == 0)
+            return section;
+
+    if (!create)
+        return NULL;
+
+    section = (config_section *) calloc(1, sizeof(config_section));
+    section->name = copy_string(name);
+    section->next = l_Sections;
+    l_Sections = section;
+    return section;
+}
+
+static config_param *find_param(config_section *section, const char *name)
+{
+    config_param *param;
+
+    for (param = section->params; param != NULL; param = param->next)
+        if (strcasecmp(param->name, name) == 0)
+            return param;
+
+    return NULL;
+}
+
+static void set_param(config_section *section, const char *name, m64p_type type, const char *value)
+{
+    config_param *param = find_param(section, name);
+
+    if (param == NULL)
+    {
+        param = (config_param *) calloc(1, sizeof(config_param));
+        param->name = copy_string(name);
+        param->next = section->params;
+        section->params = param;
+    }
+    else
+        free(param->value);
+
+    param->type = type;
+    param->value = copy_string(value);
+}
+
+static void free_config(void)
+{
+    while (l_Sections != NULL)
+    {
+        config_section *section = l_Sections;
+        l_Sections = section->next;
+        while (section->params != NULL)
+        {
+            config_param *param = section->params;
+            section->params = param->next;
+            free(param->name);
+            free(param->value);
+            free(param);
+        }
+        free(section->name);
+        free(section);
+    }
+}
+
+EXPORT m64p_error CALL ConfigOpenSection(const char *SectionName, m64p_handle *ConfigSectionHandle)
+{
+    if (SectionName == NULL || ConfigSectionHandle == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    *ConfigSectionHandle = find_section(SectionName, 1);
+    return M64ERR_SUCCESS;
+}
+
+static void value_to_string(m64p_type ParamType, const void *ParamValue, char *buffer, int size)
+{
+    switch (ParamType)
+    {
+        case M64TYPE_INT:    snprintf(buffer, size, "%i", *((const int *) ParamValue)); break;
+        case M64TYPE_FLOAT:  snprintf(buffer, size, "%f", *((const float *) ParamValue)); break;
+        case M64TYPE_BOOL:   snprintf(buffer, size, "%s", *((const int *) ParamValue) ? "True" : "False"); break;
+        case M64TYPE_STRING: snprintf(buffer, size, "%s", (const char *) ParamValue); break;
+    }
+}
+
+EXPORT m64p_error CALL ConfigSetParameter(m64p_handle ConfigSectionHandle, const char *ParamName, m64p_type ParamType, const void *ParamValue)
+{
+    char buffer[256];
+
+    if (ConfigSectionHandle == NULL || ParamName == NULL || ParamValue == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    value_to_string(ParamType, ParamValue, buffer, sizeof(buffer));
+    set_param((config_section *) ConfigSectionHandle, ParamName, ParamType, buffer);
+    return M64ERR_SUCCESS;
+}
+
+static int string_to_bool(const char *value)
+{
+    return strcasecmp(value, "true") == 0 || strcasecmp(value, "yes") == 0 || atoi(value) != 0;
+}
+
+EXPORT m64p_error CALL ConfigGetParameter(m64p_handle ConfigSectionHandle, const char *ParamName, m64p_type ParamType, void *ParamValue, int MaxSize)
+{
+    config_param *param;
+
+    if (ConfigSectionHandle == NULL || ParamName == NULL || ParamValue == NULL || MaxSize < 1)
+        return M64ERR_INPUT_ASSERT;
+
+    param = find_param((config_section *) ConfigSectionHandle, ParamName);
+    if (param == NULL)
+        return M64ERR_INPUT_NOT_FOUND;
+
+    switch (ParamType)
+    {
+        case M64TYPE_INT:
+            if (MaxSize < (int) sizeof(int)) return M64ERR_INPUT_INVALID;
+            *((int *) ParamValue) = atoi(param->value);
+            break;
+        case M64TYPE_FLOAT:
+            if (MaxSize < (int) sizeof(float)) return M64ERR_INPUT_INVALID;
+            *((float *) ParamValue) = (float) atof(param->value);
+            break;
+        case M64TYPE_BOOL:
+            if (MaxSize < (int) sizeof(int)) return M64ERR_INPUT_INVALID;
+            *((int *) ParamValue) = string_to_bool(param->value);
+            break;
+        case M64TYPE_STRING:
+            strncpy((char *) ParamValue, param->value, MaxSize);
+            ((char *) ParamValue)[MaxSize - 1] = 0;
+            break;
+    }
+
+    return M64ERR_SUCCESS;
+}
+
+/* a default never replaces a value given on the command line */
+static m64p_error set_default(m64p_handle ConfigSectionHandle, const char *ParamName, m64p_type ParamType, const void *ParamValue)
+{
+    if (ConfigSectionHandle == NULL || ParamName == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    if (find_param((config_section *) ConfigSectionHandle, ParamName) == NULL)
+        return ConfigSetParameter(ConfigSectionHandle, ParamName, ParamType, ParamValue);
+
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultInt(m64p_handle ConfigSectionHandle, const char *ParamName, int ParamValue, const char *ParamHelp)
+{
+    return set_default(ConfigSectionHandle, ParamName, M64TYPE_INT, &ParamValue);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultFloat(m64p_handle ConfigSectionHandle, const char *ParamName, float ParamValue, const char *ParamHelp)
+{
+    return set_default(ConfigSectionHandle, ParamName, M64TYPE_FLOAT, &ParamValue);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultBool(m64p_handle ConfigSectionHandle, const char *ParamName, int ParamValue, const char *ParamHelp)
+{
+    return set_default(ConfigSectionHandle, ParamName, M64TYPE_BOOL, &ParamValue);
+}
+
+EXPORT m64p_error CALL ConfigSetDefaultString(m64p_handle ConfigSectionHandle, const char *ParamName, const char *ParamValue, const char *ParamHelp)
+{
+    if (ParamValue == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    return set_default(ConfigSectionHandle, ParamName, M64TYPE_STRING, ParamValue);
+}
+
+static const char *get_value(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    config_param *param;
+
+    if (ConfigSectionHandle == NULL || ParamName == NULL)
+        return NULL;
+
+    param = find_param((config_section *) ConfigSectionHandle, ParamName);
+    return param != NULL ? param->value : NULL;
+}
+
+EXPORT int CALL ConfigGetParamInt(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    const char *value = get_value(ConfigSectionHandle, ParamName);
+    return value != NULL ? atoi(value) : 0;
+}
+
+EXPORT float CALL ConfigGetParamFloat(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    const char *value = get_value(ConfigSectionHandle, ParamName);
+    return value != NULL ? (float) atof(value) : 0.0f;
+}
+
+EXPORT int CALL ConfigGetParamBool(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    const char *value = get_value(ConfigSectionHandle, ParamName);
+    return value != NULL ? string_to_bool(value) : 0;
+}
+
+EXPORT const char * CALL ConfigGetParamString(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    const char *value = get_value(ConfigSectionHandle, ParamName);
+    return value != NULL ? value : "";
+}
+
+EXPORT const char * CALL ConfigGetSharedDataFilepath(const char *filename)
+{
+    FILE *f;
+
+    if (filename == NULL)
+        return NULL;
+
+    snprintf(l_FilePath, sizeof(l_FilePath), "%s/%s", l_DataPath, filename);
+    f = fopen(l_FilePath, "rb");
+    if (f == NULL)
+        return NULL;
+    fclose(f);
+    return l_FilePath;
+}
+
+EXPORT const char * CALL ConfigGetUserConfigPath(void)
+{
+    return l_DataPath;
+}
+
+EXPORT const char * CALL ConfigGetUserDataPath(void)
+{
+    return l_DataPath;
+}
+
+EXPORT const char * CALL ConfigGetUserCachePath(void)
+{
+    return l_DataPath;
+}
+
+EXPORT m64p_error CALL CoreGetAPIVersions(int *ConfigVersion, int *DebugVersion, int *VidextVersion, int *ExtraVersion)
+{
+    if (ConfigVersion != NULL)
+        *ConfigVersion = CONFIG_API_VERSION;
+    if (DebugVersion != NULL)
+        *DebugVersion = DEBUG_API_VERSION;
+    if (VidextVersion != NULL)
+        *VidextVersion = VIDEXT_API_VERSION;
+    if (ExtraVersion != NULL)
+        *ExtraVersion = 0;
+
+    return M64ERR_SUCCESS;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* VidExt: there is no window, every call succeeds */
+
+EXPORT m64p_error CALL VidExt_Init(void)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_Quit(void)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ListFullscreenModes(m64p_2d_size *SizeArray, int *NumSizes)
+{
+    if (SizeArray == NULL || NumSizes == NULL || *NumSizes < 1)
+        return M64ERR_INPUT_ASSERT;
+
+    SizeArray[0].uiWidth = 640;
+    SizeArray[0].uiHeight = 480;
+    *NumSizes = 1;
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_SetVideoMode(int Width, int Height, int BitsPerPixel, m64p_video_mode ScreenMode, m64p_video_flags Flags)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ResizeWindow(int Width, int Height)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_SetCaption(const char *Title)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_ToggleFullScreen(void)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT void * CALL VidExt_GL_GetProcAddress(const char *Proc)
+{
+    return Proc != NULL ? nullgl_GetProcAddress(Proc) : NULL;
+}
+
+EXPORT m64p_error CALL VidExt_GL_SetAttribute(m64p_GLattr Attr, int Value)
+{
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_GL_GetAttribute(m64p_GLattr Attr, int *pValue)
+{
+    if (pValue == NULL)
+        return M64ERR_INPUT_ASSERT;
+
+    *pValue = (Attr == M64P_GL_DOUBLEBUFFER) ? 1 : 0;
+    return M64ERR_SUCCESS;
+}
+
+EXPORT m64p_error CALL VidExt_GL_SwapBuffers(void)
+{
+    return M64ERR_SUCCESS;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* replay */
+
+static unsigned int l_MI_INTR_REG;
+static unsigned int l_DPC_REGS[8];
+static unsigned int l_VI_REGS[DLTRACE_VI_REGS];
+
+static void CheckInterrupts(void)
+{
+}
+
+static void DebugCallback(void *Context, int level, const char *message)
+{
+    if (level <= M64MSG_WARNING || l_Verbose)
+        fprintf(stderr, "%s: %s\n", (const char *) Context, message);
+}
+
+static double elapsed_ms(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+static int compare_times(const void *a, const void *b)
+{
+    double ta = *((const double *) a), tb = *((const double *) b);
+    return (ta > tb) - (ta < tb);
+}
+
+typedef struct
+{
+    double      *times;
+    unsigned int count;
+    unsigned int capacity;
+    double       total;
+} timing;
+
+static void add_time(timing *t, double ms)
+{
+    if (t->count == t->capacity)
+    {
+        t->capacity = t->capacity ? t->capacity * 2 : 1024;
+        t->times = (double *) realloc(t->times, t->capacity * sizeof(double));
+    }
+    t->times[t->count++] = ms;
+    t->total += ms;
+}
+
+static void print_times(const char *name, timing *t)
+{
+    if (t->count == 0)
+    {
+        printf("%-13s        0 calls\n", name);
+        return;
+    }
+
+    qsort(t->times, t->count, sizeof(double), compare_times);
+    printf("%-13s %8u calls  total %10.2f ms  avg %8.3f  min %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f ms\n",
+           name, t->count, t->total, t->total / t->count, t->times[0], t->times[t->count / 2],
+           t->times[(t->count * 95) / 100], t->times[t->count - 1]);
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options] <video plugin> <trace file>\n", program);
+    printf("  --loops N              replay the trace N times (default 1)\n");
+    printf("  --data <dir>           folder of the plugin's data files (default .)\n");
+    printf("  --set Section[Param]=Value\n");
+    printf("                         set a config parameter before the plugin starts\n");
+    printf("  --verbose              show all messages from the plugin\n");
+}
+
+static int parse_set(const char *arg)
+{
+    char section[256], param[256];
+    const char *open = strchr(arg, '['), *close = strchr(arg, ']');
+
+    if (open == NULL || close == NULL || close < open || close[1] != '=' ||
+        open - arg >= (int) sizeof(section) || close - open - 1 >= (int) sizeof(param))
+        return 0;
+
+    memcpy(section, arg, open - arg);
+    section[open - arg] = 0;
+    memcpy(param, open + 1, close - open - 1);
+    param[close - open - 1] = 0;
+    set_param(find_section(section, 1), param, M64TYPE_STRING, close + 2);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pluginname = NULL, *tracename = NULL;
+    int loops = 1, loop, arg;
+    void *plugin;
+    ptr_PluginStartup fPluginStartup;
+    ptr_PluginShutdown fPluginShutdown;
+    ptr_InitiateGFX fInitiateGFX;
+    ptr_RomOpen fRomOpen;
+    ptr_RomClosed fRomClosed;
+    ptr_ProcessDList fProcessDList;
+    ptr_UpdateScreen fUpdateScreen;
+    ptr_ViStatusChanged fViStatusChanged;
+    ptr_ViWidthChanged fViWidthChanged;
+    FILE *trace;
+    dltrace_header header;
+    dltrace_record record;
+    long records_start;
+    unsigned char *rdram, *dmem, *imem, *rom_header;
+    GFX_INFO gfx_info;
+    timing dlist_times, screen_times;
+    struct timespec start, end;
+    int errors = 0;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--loops") == 0 && arg + 1 < argc)
+            loops = atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--data") == 0 && arg + 1 < argc)
+            l_DataPath = argv[++arg];
+        else if (strcmp(argv[arg], "--set") == 0 && arg + 1 < argc)
+        {
+            if (!parse_set(argv[++arg]))
+            {
+                fprintf(stderr, "Error: invalid parameter setting '%s'\n", argv[arg]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[arg], "--verbose") == 0)
+            l_Verbose = 1;
+        else if (pluginname == NULL)
+            pluginname = argv[arg];
+        else if (tracename == NULL)
+            tracename = argv[arg];
+        else
+            break;
+    }
+    if (pluginname == NULL || tracename == NULL || arg < argc || loops < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* read the trace header */
+    trace = fopen(tracename, "rb");
+    if (trace == NULL)
+    {
+        fprintf(stderr, "Error: can't open '%s'\n", tracename);
+        return 1;
+    }
+    if (fread(&header, sizeof(header), 1, trace) != 1 || memcmp(header.magic, DLTRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DLTRACE_VERSION || header.rdram_size == 0 || header.rdram_size % DLTRACE_PAGE_SIZE != 0)
+    {
+        fprintf(stderr, "Error: '%s' is not a display list trace\n", tracename);
+        fclose(trace);
+        return 1;
+    }
+    records_start = ftell(trace);
+
+    /* load the plugin, the functions it looks up in the core are found in this program */
+    plugin = dlopen(pluginname, RTLD_NOW);
+    if (plugin == NULL)
+    {
+        fprintf(stderr, "Error: can't load '%s': %s\n", pluginname, dlerror());
+        fclose(trace);
+        return 1;
+    }
+    fPluginStartup = (ptr_PluginStartup) dlsym(plugin, "PluginStartup");
+    fPluginShutdown = (ptr_PluginShutdown) dlsym(plugin, "PluginShutdown");
+    fInitiateGFX = (ptr_InitiateGFX) dlsym(plugin, "InitiateGFX");
+    fRomOpen = (ptr_RomOpen) dlsym(plugin, "RomOpen");
+    fRomClosed = (ptr_RomClosed) dlsym(plugin, "RomClosed");
+    fProcessDList = (ptr_ProcessDList) dlsym(plugin, "ProcessDList");
+    fUpdateScreen = (ptr_UpdateScreen) dlsym(plugin, "UpdateScreen");
+    fViStatusChanged = (ptr_ViStatusChanged) dlsym(plugin, "ViStatusChanged");
+    fViWidthChanged = (ptr_ViWidthChanged) dlsym(plugin, "ViWidthChanged");
+    if (fPluginStartup == NULL || fPluginShutdown == NULL || fInitiateGFX == NULL || fRomOpen == NULL ||
+        fRomClosed == NULL || fProcessDList == NULL || fUpdateScreen == NULL || fViStatusChanged == NULL ||
+        fViWidthChanged == NULL)
+    {
+        fprintf(stderr, "Error: '%s' is not a video plugin\n", pluginname);
+        dlclose(plugin);
+        fclose(trace);
+        return 1;
+    }
+
+    rdram = (unsigned char *) calloc(1, header.rdram_size);
+    dmem = (unsigned char *) calloc(1, 0x1000);
+    imem = (unsigned char *) calloc(1, 0x1000);
+    rom_header = (unsigned char *) calloc(1, 0x1000);
+    memcpy(rom_header, header.rom_header, sizeof(header.rom_header));
+
+    memset(&gfx_info, 0, sizeof(gfx_info));
+    gfx_info.HEADER = rom_header;
+    gfx_info.RDRAM = rdram;
+    gfx_info.DMEM = dmem;
+    gfx_info.IMEM = imem;
+    gfx_info.MI_INTR_REG = &l_MI_INTR_REG;
+    gfx_info.DPC_START_REG = &l_DPC_REGS[0];
+    gfx_info.DPC_END_REG = &l_DPC_REGS[1];
+    gfx_info.DPC_CURRENT_REG = &l_DPC_REGS[2];
+    gfx_info.DPC_STATUS_REG = &l_DPC_REGS[3];
+    gfx_info.DPC_CLOCK_REG = &l_DPC_REGS[4];
+    gfx_info.DPC_BUFBUSY_REG = &l_DPC_REGS[5];
+    gfx_info.DPC_PIPEBUSY_REG = &l_DPC_REGS[6];
+    gfx_info.DPC_TMEM_REG = &l_DPC_REGS[7];
+    gfx_info.VI_STATUS_REG = &l_VI_REGS[0];
+    gfx_info.VI_ORIGIN_REG = &l_VI_REGS[1];
+    gfx_info.VI_WIDTH_REG = &l_VI_REGS[2];
+    gfx_info.VI_INTR_REG = &l_VI_REGS[3];
+    gfx_info.VI_V_CURRENT_LINE_REG = &l_VI_REGS[4];
+    gfx_info.VI_TIMING_REG = &l_VI_REGS[5];
+    gfx_info.VI_V_SYNC_REG = &l_VI_REGS[6];
+    gfx_info.VI_H_SYNC_REG = &l_VI_REGS[7];
+    gfx_info.VI_LEAP_REG = &l_VI_REGS[8];
+    gfx_info.VI_H_START_REG = &l_VI_REGS[9];
+    gfx_info.VI_V_START_REG = &l_VI_REGS[10];
+    gfx_info.VI_V_BURST_REG = &l_VI_REGS[11];
+    gfx_info.VI_X_SCALE_REG = &l_VI_REGS[12];
+    gfx_info.VI_Y_SCALE_REG = &l_VI_REGS[13];
+    gfx_info.CheckInterrupts = CheckInterrupts;
+
+    if (fPluginStartup(dlopen(NULL, RTLD_NOW), (void *) "Video", DebugCallback) != M64ERR_SUCCESS ||
+        !fInitiateGFX(gfx_info) || !fRomOpen())
+    {
+        fprintf(stderr, "Error: the video plugin couldn't be started\n");
+        fPluginShutdown();
+        dlclose(plugin);
+        fclose(trace);
+        return 1;
+    }
+
+    memset(&dlist_times, 0, sizeof(dlist_times));
+    memset(&screen_times, 0, sizeof(screen_times));
+
+    for (loop = 0; loop < loops && !errors; loop++)
+    {
+        /* every pass starts from the same state the capture did */
+        memset(rdram, 0, header.rdram_size);
+        fseek(trace, records_start, SEEK_SET);
+
+        while (!errors && fread(&record, sizeof(record), 1, trace) == 1)
+        {
+            switch (record.type)
+            {
+                case DLTRACE_PAGES:
+                {
+                    unsigned int page, n;
+                    for (n = 0; n < record.size / (sizeof(page) + DLTRACE_PAGE_SIZE); n++)
+                    {
+                        if (fread(&page, sizeof(page), 1, trace) != 1 ||
+                            page >= header.rdram_size / DLTRACE_PAGE_SIZE ||
+                            fread(rdram + page * DLTRACE_PAGE_SIZE, DLTRACE_PAGE_SIZE, 1, trace) != 1)
+                        {
+                            errors++;
+                            break;
+                        }
+                    }
+                    break;
+                }
+                case DLTRACE_VI:
+                {
+                    unsigned int regs[DLTRACE_VI_REGS];
+                    int status_changed, width_changed;
+                    if (record.size != sizeof(regs) || fread(regs, sizeof(regs), 1, trace) != 1)
+                    {
+                        errors++;
+                        break;
+                    }
+                    status_changed = regs[0] != l_VI_REGS[0];
+                    width_changed = regs[2] != l_VI_REGS[2];
+                    memcpy(l_VI_REGS, regs, sizeof(regs));
+                    if (status_changed)
+                        fViStatusChanged();
+                    if (width_changed)
+                        fViWidthChanged();
+                    break;
+                }
+                case DLTRACE_DLIST:
+                    if (record.size != DLTRACE_TASK_SIZE ||
+                        fread(dmem + DLTRACE_TASK_OFFSET, DLTRACE_TASK_SIZE, 1, trace) != 1)
+                    {
+                        errors++;
+                        break;
+                    }
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    fProcessDList();
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                    add_time(&dlist_times, elapsed_ms(&start, &end));
+                    break;
+                case DLTRACE_UPDATE_SCREEN:
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                    fUpdateScreen();
+                    clock_gettime(CLOCK_MONOTONIC, &end);
+                    add_time(&screen_times, elapsed_ms(&start, &end));
+                    break;
+                default:
+                    /* unknown records are skipped */
+                    fseek(trace, record.size, SEEK_CUR);
+                    break;
+            }
+        }
+    }
+
+    if (errors)
+        fprintf(stderr, "Error: '%s' is truncated or damaged\n", tracename);
+
+    /* the plugin's own profile, if it has one, is printed when the ROM is closed */
+    fRomClosed();
+    fPluginShutdown();
+
+    printf("%s: %i pass(es) of '%s'\n", pluginname, loop, tracename);
+    print_times("ProcessDList", &dlist_times);
+    print_times("UpdateScreen", &screen_times);
+    printf("%-13s %8u frames  total %10.2f ms  %.1f frames/s\n", "All", screen_times.count,
+           dlist_times.total + screen_times.total,
+           screen_times.count ? screen_times.count * 1000.0 / (dlist_times.total + screen_times.total) : 0.0);
+
+    free(dlist_times.times);
+    free(screen_times.times);
+    free(rdram);
+    free(dmem);
+    free(imem);
+    free(rom_header);
+    free_config();
+    dlclose(plugin);
+    fclose(trace);
+    return errors ? 1 : 0;
+}
+
@@ -0,0 +1,811 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - dyncompare.c                                            *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* dyncompare - runs a ROM under two R4300 emulators in lockstep and finds where they part
+ *
+ * Usage: dyncompare [options] <core library> <rom file>
+ *
+ * Two instances of the core are loaded in the process (from two copies of the library, so that each has its own
+ * globals), one with R4300Emulator set to the reference emulator (the pure interpreter by default) and one with the
+ * emulator under test (the dynamic recompiler by default). They run on a thread each, headless with the dummy
+ * plugins and without the speed limiter, from the ROM's boot or from the same save state (--state).
+ *
+ * The two threads meet at every vertical interrupt, where PC, the GPRs, HI/LO, COP0 (Count included), the FPRs and
+ * RDRAM (64KB page by page) are compared. When they differ, both cores are loaded again and run to the last VI which
+ * matched, and from there they are stepped one instruction at a time through the core comparison callbacks
+ * (DebugSetCoreCompare()) until the first instruction after which the registers, or the memory it stored to, differ.
+ * The instruction callbacks are only made by a core built with DBG_COMPARE=1; with another build the difference is
+ * narrowed down to a VI, which is said up front.
+ *
+ * The dynamic recompiler doesn't call back for every instruction, so while stepping the reference core may run a few
+ * instructions alone to get to the test core's PC. Each of these catch-ups is printed, since a difference in those
+ * instructions only shows once the states are compared again; when the reference core doesn't get there, the PCs are
+ * reported as a difference.
+ *
+ * The exit status is 0 when the states matched for the requested number of VIs, 1 on a difference, 2 on an error,
+ * so the tool can be run by a script on a set of ROMs.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <ftw.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_config.h"
+#include "api/m64p_debugger.h"
+#include "api/m64p_frontend.h"
+#include "main/version.h"
+
+#define RDRAM_SIZE      0x800000
+#define RDRAM_PAGE_SIZE 0x10000
+#define RDRAM_PAGES     (RDRAM_SIZE / RDRAM_PAGE_SIZE)
+
+/* one instance of the core, running one R4300 emulator */
+typedef struct
+{
+    char                    name[32];
+    int                     emulator;
+    void                   *lib;
+    ptr_CoreShutdown        CoreShutdown;
+    ptr_CoreDoCommand       CoreDoCommand;
+    ptr_DebugSetCoreCompare DebugSetCoreCompare;
+    ptr_DebugGetCPUDataPtr  DebugGetCPUDataPtr;
+    pthread_t               thread;
+    /* the machine state */
+    long long              *reg, *hi, *lo, *fgr;
+    unsigned int           *cop0;
+    unsigned char          *rdram;
+    /* where the core is, set before each meeting */
+    unsigned int            vi;
+    unsigned int            pc;
+    unsigned int            op;
+} core_instance;
+
+static const char *l_GprNames[32] = {
+    "r0", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+    "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "t8", "t9", "k0", "k1", "gp", "sp", "s8", "ra"
+};
+
+static const char *l_Cop0Names[32] = {
+    "Index", "Random", "EntryLo0", "EntryLo1", "Context", "PageMask", "Wired", "7", "BadVAddr", "Count",
+    "EntryHi", "Compare", "Status", "Cause", "EPC", "PRId", "Config", "LLAddr", "WatchLo", "WatchHi", "XContext",
+    "21", "22", "23", "24", "25", "26", "27", "TagLo", "TagHi", "ErrorEPC", "31"
+};
+
+/* options */
+static const char *l_CoreName = NULL;
+static const char *l_RomName = NULL;
+static const char *l_StateName = NULL;
+static const char *l_DataPath = NULL;
+static char      **l_Settings = NULL;
+static int         l_NumSettings = 0;
+static int         l_Verbose = 0;
+
+/* the library copies and the cores' configuration go in a directory of our own */
+static char l_TempDir[] = "/tmp/dyncompare.XXXXXX";
+
+static core_instance  l_Ref, l_Test;
+static unsigned char *l_Rom = NULL;
+static long           l_RomSize = 0;
+
+/* the current run: the states are compared at each VI from l_FirstVI to l_LastVI, and when l_Stepping is set the
+ * cores are stepped one instruction at a time after VI l_StepVI (-1: from the start) */
+static unsigned int   l_FirstVI;
+static unsigned int   l_LastVI;
+static int            l_Stepping;
+static int            l_StepVI;
+static volatile int   l_Stopping;
+static int            l_DiffVI;         /* first VI which differed in the first run, -1 if none */
+static unsigned int   l_Steps;          /* instructions stepped by the reference core so far */
+static unsigned int   l_PrevPC, l_PrevOp;
+
+/* the dynamic recompiler doesn't call back for the first instruction it runs in a new block, nor when it jumps into
+ * an instruction past the point where the registers are flushed: then the reference core runs on alone, up to
+ * MAX_CATCH_UP instructions, until it gets to the test core's PC */
+#define MAX_CATCH_UP 4
+static int            l_CatchUp;        /* instructions run by the reference core alone */
+static int            l_RefOnly;        /* the test core waits while the reference core runs the next instruction */
+static unsigned int   l_CatchUps;       /* instructions run by the reference core alone in this run */
+
+/* RDRAM offsets of the doublewords written since the last comparison; l_StoreAnywhere if one was outside of
+ * KSEG0/KSEG1 RDRAM */
+static unsigned int   l_Stores[MAX_CATCH_UP + 1];
+static int            l_NumStores;
+static int            l_StoreAnywhere;
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* meeting point of the two emulation threads */
+
+static volatile int l_Arrived = 0;
+static volatile int l_Generation = 0;
+static volatile int l_CoreGone = 0;     /* a core has returned from M64CMD_EXECUTE */
+
+/* waits for the other thread; returns 0 if it has stopped running */
+static int rendezvous(void)
+{
+    int generation = l_Generation;
+
+    if (__sync_add_and_fetch(&l_Arrived, 1) == 2)
+    {
+        l_Arrived = 0;
+        __sync_synchronize();
+        l_Generation = generation + 1;
+        return 1;
+    }
+
+    while (l_Generation == generation)
+    {
+        if (l_CoreGone)
+            return 0;
+        sched_yield();
+    }
+    __sync_synchronize();
+    return 1;
+}
+
+/* data which doesn't come from the CPU (CoreCompareDataSync()) is handed from the reference core to the test core */
+static pthread_mutex_t l_SyncLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  l_SyncCond = PTHREAD_COND_INITIALIZER;
+static unsigned char   l_SyncData[4096];
+static int             l_SyncHead = 0, l_SyncTail = 0;
+
+static void ref_data_sync(int length, void *value)
+{
+    int i;
+
+    pthread_mutex_lock(&l_SyncLock);
+    for (i = 0; i < length; i++)
+        l_SyncData[(l_SyncHead + i) % sizeof(l_SyncData)] = ((unsigned char *) value)[i];
+    l_SyncHead += length;
+    pthread_cond_broadcast(&l_SyncCond);
+    pthread_mutex_unlock(&l_SyncLock);
+}
+
+static void test_data_sync(int length, void *value)
+{
+    int i;
+
+    pthread_mutex_lock(&l_SyncLock);
+    while (l_SyncHead - l_SyncTail < length && !l_CoreGone)
+        pthread_cond_wait(&l_SyncCond, &l_SyncLock);
+    if (l_SyncHead - l_SyncTail >= length)
+    {
+        for (i = 0; i < length; i++)
+            ((unsigned char *) value)[i] = l_SyncData[(l_SyncTail + i) % sizeof(l_SyncData)];
+        l_SyncTail += length;
+    }
+    pthread_mutex_unlock(&l_SyncLock);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* comparison, made on the reference core's thread while the test core waits */
+
+/* returns the number of differences in the CPU, and prints them if print is set */
+static int compare_cpu(int print)
+{
+    int diffs = 0, i;
+
+    if (l_Ref.pc != l_Test.pc)
+    {
+        if (print)
+            printf("  PC        %08x          %08x\n", l_Ref.pc, l_Test.pc);
+        diffs++;
+    }
+    for (i = 0; i < 32; i++)
+        if (l_Ref.reg[i] != l_Test.reg[i])
+        {
+            if (print)
+                printf("  %-9s %016llx  %016llx\n", l_GprNames[i], (unsigned long long) l_Ref.reg[i],
+                       (unsigned long long) l_Test.reg[i]);
+            diffs++;
+        }
+    if (*l_Ref.hi != *l_Test.hi)
+    {
+        if (print)
+            printf("  hi        %016llx  %016llx\n", (unsigned long long) *l_Ref.hi, (unsigned long long) *l_Test.hi);
+        diffs++;
+    }
+    if (*l_Ref.lo != *l_Test.lo)
+    {
+        if (print)
+            printf("  lo        %016llx  %016llx\n", (unsigned long long) *l_Ref.lo, (unsigned long long) *l_Test.lo);
+        diffs++;
+    }
+    for (i = 0; i < 32; i++)
+        if (l_Ref.cop0[i] != l_Test.cop0[i])
+        {
+            if (print)
+                printf("  %-9s %08x          %08x\n", l_Cop0Names[i], l_Ref.cop0[i], l_Test.cop0[i]);
+            diffs++;
+        }
+    for (i = 0; i < 32; i++)
+        if (l_Ref.fgr[i] != l_Test.fgr[i])
+        {
+            if (print)
+                printf("  f%-8i %016llx  %016llx\n", i, (unsigned long long) l_Ref.fgr[i],
+                       (unsigned long long) l_Test.fgr[i]);
+            diffs++;
+        }
+
+    return diffs;
+}
+
+/* same for the RDRAM pages; both cores are in this process, so the pages are compared rather than hashed */
+static int compare_rdram(int print)
+{
+    int diffs = 0, i;
+
+    for (i = 0; i < RDRAM_PAGES; i++)
+        if (memcmp(l_Ref.rdram + i * RDRAM_PAGE_SIZE, l_Test.rdram + i * RDRAM_PAGE_SIZE, RDRAM_PAGE_SIZE) != 0)
+        {
+            if (print)
+                printf("  RDRAM %06x-%06x differs\n", i * RDRAM_PAGE_SIZE, (i + 1) * RDRAM_PAGE_SIZE - 1);
+            diffs++;
+        }
+
+    return diffs;
+}
+
+static void print_header(void)
+{
+    printf("  %-9s %-16s  %-16s\n", "", l_Ref.name, l_Test.name);
+}
+
+static void compare_at_vi(void)
+{
+    if (l_Ref.vi < l_FirstVI)
+        return;
+
+    if (l_Stepping && l_Steps > 0)
+    {
+        /* the instruction callbacks are compared instead, and they matched up to here */
+        if (l_Ref.vi >= l_LastVI)
+        {
+            printf("The CPUs matched for the %u instructions up to VI %u: what differs was written by DMA or the RSP\n",
+                   l_Steps, l_Ref.vi);
+            l_Stopping = 1;
+        }
+        return;
+    }
+
+    if (compare_cpu(0) == 0 && compare_rdram(0) == 0)
+    {
+        if (l_Ref.vi >= l_LastVI)
+            l_Stopping = 1;
+        return;
+    }
+
+    if (!l_Stepping)
+    {
+        printf("VI %u: %s and %s differ\n", l_Ref.vi, l_Ref.name, l_Test.name);
+        print_header();
+        compare_cpu(1);
+        compare_rdram(1);
+        l_DiffVI = (int) l_Ref.vi;
+    }
+    else
+        printf("No instruction callbacks from the core: it has to be built with DBG_COMPARE=1 to find the instruction\n");
+    l_Stopping = 1;
+}
+
+static int is_store(unsigned int op)
+{
+    switch (op >> 26)
+    {
+        case 0x28: case 0x29: case 0x2A: case 0x2B:     /* SB SH SWL SW */
+        case 0x2C: case 0x2D: case 0x2E:                /* SDL SDR SWR */
+        case 0x38: case 0x39: case 0x3C: case 0x3D:     /* SC SWC1 SCD SDC1 */
+        case 0x3F:                                      /* SD */
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* the reference core is about to run its instruction: note where it stores to */
+static void note_store(void)
+{
+    unsigned int addr;
+
+    if (!is_store(l_Ref.op))
+        return;
+
+    addr = (unsigned int) (l_Ref.reg[(l_Ref.op >> 21) & 0x1F] + (short) (l_Ref.op & 0xFFFF));
+    if ((addr & 0xC0000000) == 0x80000000 && (addr & 0x1FFFFFFF) < RDRAM_SIZE)
+        l_Stores[l_NumStores++] = addr & 0x1FFFFFF8;
+    else
+        l_StoreAnywhere = 1;
+}
+
+static int compare_stores(void)
+{
+    int diffs = 0, i;
+
+    if (l_StoreAnywhere)
+        return compare_rdram(0);
+    for (i = 0; i < l_NumStores; i++)
+        diffs += memcmp(l_Ref.rdram + l_Stores[i], l_Test.rdram + l_Stores[i], 8) != 0;
+    return diffs;
+}
+
+static void print_instruction(void)
+{
+    if (l_StepVI < 0)
+        printf("Instruction %u from the start", l_Steps);
+    else
+        printf("Instruction %u after VI %i", l_Steps, l_StepVI);
+}
+
+static void compare_at_instruction(void)
+{
+    int diffs;
+
+    l_RefOnly = 0;
+    if (l_Ref.pc != l_Test.pc && l_CatchUp < MAX_CATCH_UP)
+    {
+        print_instruction();
+        printf(": %s runs %08x: %08x alone, %s is at %08x\n", l_Ref.name, l_Ref.pc, l_Ref.op, l_Test.name, l_Test.pc);
+        l_RefOnly = 1;
+        l_CatchUp++;
+        l_CatchUps++;
+        note_store();
+        l_Steps++;
+        return;
+    }
+
+    /* in memory, only what was stored to since the last time is compared */
+    diffs = compare_cpu(0);
+    if (diffs == 0)
+        diffs = compare_stores();
+
+    if (diffs != 0 && l_Steps > 0)
+    {
+        print_instruction();
+        printf(": %s and %s differ after %08x: %08x\n", l_Ref.name, l_Test.name, l_PrevPC, l_PrevOp);
+        if (l_CatchUp > 0)
+            printf("  or after one of the %i instructions %s ran alone before it\n", l_CatchUp, l_Ref.name);
+        if (l_Ref.pc != l_Test.pc)
+            printf("  %s didn't get to the PC of %s in %i instructions\n", l_Ref.name, l_Test.name, MAX_CATCH_UP);
+        print_header();
+        compare_cpu(1);
+        if (l_NumStores > 0 || l_StoreAnywhere)
+            compare_rdram(1);
+        l_Stopping = 1;
+        return;
+    }
+
+    l_CatchUp = 0;
+    l_NumStores = 0;
+    l_StoreAnywhere = 0;
+    note_store();
+    l_PrevPC = l_Ref.pc;
+    l_PrevOp = l_Ref.op;
+    l_Steps++;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* callbacks from the cores, on their emulation threads */
+
+static void ref_core_compare(unsigned int op);
+static void test_core_compare(unsigned int op);
+
+static void start_stepping(core_instance *core)
+{
+    if (core == &l_Ref)
+        core->DebugSetCoreCompare(ref_core_compare, ref_data_sync);
+    else
+        core->DebugSetCoreCompare(test_core_compare, test_data_sync);
+}
+
+static void vi_checkpoint(core_instance *core, unsigned int vi)
+{
+    core->vi = vi;
+    core->pc = *(unsigned int *) core->DebugGetCPUDataPtr(M64P_CPU_PC);
+
+    /* the save state is loaded at the next interrupt, before VI 1 */
+    if (vi == 0 && l_StateName != NULL)
+        core->CoreDoCommand(M64CMD_STATE_LOAD, 0, (void *) l_StateName);
+
+    /* once the cores are stepped, they only meet at the instructions, and the reference core watches for the VI */
+    if (l_Stepping && l_Steps > 0)
+    {
+        if (core == &l_Ref && !l_Stopping)
+            compare_at_vi();
+    }
+    else if (!l_Stopping && rendezvous())
+    {
+        if (core == &l_Ref)
+            compare_at_vi();
+        if (rendezvous() && !l_Stopping && l_Stepping && l_StepVI >= 0 && vi == (unsigned int) l_StepVI)
+            start_stepping(core);
+    }
+
+    if (l_Stopping || l_CoreGone)
+        core->CoreDoCommand(M64CMD_STOP, 0, NULL);
+}
+
+static void instruction_checkpoint(core_instance *core, unsigned int op)
+{
+    core->op = op;
+    core->pc = *(unsigned int *) core->DebugGetCPUDataPtr(M64P_CPU_PC);
+
+    /* the test core meets the reference core again if it has to catch up */
+    while (!l_Stopping && rendezvous())
+    {
+        if (core == &l_Ref)
+            compare_at_instruction();
+        if (!rendezvous() || core == &l_Ref || !l_RefOnly)
+            break;
+    }
+
+    if (l_Stopping || l_CoreGone)
+        core->CoreDoCommand(M64CMD_STOP, 0, NULL);
+}
+
+static void ref_vi_callback(unsigned int vi)   { vi_checkpoint(&l_Ref, vi); }
+static void test_vi_callback(unsigned int vi)  { vi_checkpoint(&l_Test, vi); }
+static void ref_core_compare(unsigned int op)  { instruction_checkpoint(&l_Ref, op); }
+static void test_core_compare(unsigned int op) { instruction_checkpoint(&l_Test, op); }
+
+static void debug_callback(void *context, int level, const char *message)
+{
+    if (l_Verbose || level <= M64MSG_ERROR)
+        fprintf(stderr, "%s: %s\n", (const char *) context, message);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* core instances */
+
+static int copy_file(const char *from, const char *to)
+{
+    char buffer[65536];
+    size_t n;
+    FILE *in = fopen(from, "rb"), *out = fopen(to, "wb");
+    int ok = (in != NULL && out != NULL);
+
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        ok = (fwrite(buffer, 1, n, out) == n);
+    if (in != NULL)
+        fclose(in);
+    if (out != NULL && fclose(out) != 0)
+        ok = 0;
+    return ok;
+}
+
+/* loads a new instance of the core and opens the ROM in it */
+static int core_load(core_instance *core, int run)
+{
+    char path[64];
+    ptr_CoreStartup fCoreStartup;
+    ptr_ConfigOpenSection fConfigOpenSection;
+    ptr_ConfigSetParameter fConfigSetParameter;
+    ptr_DebugMemGetPointer fDebugMemGetPointer;
+    m64p_handle section;
+    int zero = 0, i;
+
+    /* the dynamic loader only loads a library once per path, so each instance gets a copy of its own */
+    sprintf(path, "%s/%s-%i.so", l_TempDir, core == &l_Ref ? "ref" : "test", run);
+    if (!copy_file(l_CoreName, path))
+    {
+        fprintf(stderr, "%s: can't copy '%s'\n", core->name, l_CoreName);
+        return 0;
+    }
+    core->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (core->lib == NULL)
+    {
+        fprintf(stderr, "%s: can't load '%s': %s\n", core->name, l_CoreName, dlerror());
+        return 0;
+    }
+    fCoreStartup = (ptr_CoreStartup) dlsym(core->lib, "CoreStartup");
+    fConfigOpenSection = (ptr_ConfigOpenSection) dlsym(core->lib, "ConfigOpenSection");
+    fConfigSetParameter = (ptr_ConfigSetParameter) dlsym(core->lib, "ConfigSetParameter");
+    fDebugMemGetPointer = (ptr_DebugMemGetPointer) dlsym(core->lib, "DebugMemGetPointer");
+    core->CoreShutdown = (ptr_CoreShutdown) dlsym(core->lib, "CoreShutdown");
+    core->CoreDoCommand = (ptr_CoreDoCommand) dlsym(core->lib, "CoreDoCommand");
+    core->DebugSetCoreCompare = (ptr_DebugSetCoreCompare) dlsym(core->lib, "DebugSetCoreCompare");
+    core->DebugGetCPUDataPtr = (ptr_DebugGetCPUDataPtr) dlsym(core->lib, "DebugGetCPUDataPtr");
+    if (fCoreStartup == NULL || fConfigOpenSection == NULL || fConfigSetParameter == NULL ||
+        fDebugMemGetPointer == NULL || core->CoreShutdown == NULL || core->CoreDoCommand == NULL ||
+        core->DebugSetCoreCompare == NULL || core->DebugGetCPUDataPtr == NULL)
+    {
+        fprintf(stderr, "%s: '%s' is not a Mupen64Plus core library\n", core->name, l_CoreName);
+        return 0;
+    }
+
+    if ((*fCoreStartup)(FRONTEND_API_VERSION, l_TempDir, l_DataPath, core->name, debug_callback, NULL, NULL) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "%s: core startup failed\n", core->name);
+        return 0;
+    }
+
+    /* the other settings first, so that --set can't change the emulator */
+    for (i = 0; i < l_NumSettings; i++)
+    {
+        char sectionname[64], param[64];
+        const char *open = strchr(l_Settings[i], '['), *close = strchr(l_Settings[i], ']');
+
+        memcpy(sectionname, l_Settings[i], open - l_Settings[i]);
+        sectionname[open - l_Settings[i]] = 0;
+        memcpy(param, open + 1, close - open - 1);
+        param[close - open - 1] = 0;
+        if ((*fConfigOpenSection)(sectionname, &section) != M64ERR_SUCCESS ||
+            (*fConfigSetParameter)(section, param, M64TYPE_STRING, close + 2) != M64ERR_SUCCESS)
+        {
+            fprintf(stderr, "%s: can't set '%s'\n", core->name, l_Settings[i]);
+            return 0;
+        }
+    }
+    if ((*fConfigOpenSection)("Core", &section) != M64ERR_SUCCESS ||
+        (*fConfigSetParameter)(section, "R4300Emulator", M64TYPE_INT, &core->emulator) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "%s: can't set the R4300 emulator\n", core->name);
+        return 0;
+    }
+
+    if (core->CoreDoCommand(M64CMD_ROM_OPEN, (int) l_RomSize, l_Rom) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "%s: the core couldn't open '%s'\n", core->name, l_RomName);
+        return 0;
+    }
+    core->CoreDoCommand(M64CMD_CORE_STATE_SET, M64CORE_SPEED_LIMITER, &zero);
+    core->CoreDoCommand(M64CMD_SET_VI_CALLBACK, 0, core == &l_Ref ? ref_vi_callback : test_vi_callback);
+
+    core->reg = (long long *) core->DebugGetCPUDataPtr(M64P_CPU_REG_REG);
+    core->hi = (long long *) core->DebugGetCPUDataPtr(M64P_CPU_REG_HI);
+    core->lo = (long long *) core->DebugGetCPUDataPtr(M64P_CPU_REG_LO);
+    core->cop0 = (unsigned int *) core->DebugGetCPUDataPtr(M64P_CPU_REG_COP0);
+    core->fgr = (long long *) core->DebugGetCPUDataPtr(M64P_CPU_REG_COP1_FGR_64);
+    core->rdram = (unsigned char *) (*fDebugMemGetPointer)(M64P_DBG_PTR_RDRAM);
+    return 1;
+}
+
+static void core_unload(core_instance *core)
+{
+    if (core->lib == NULL)
+        return;
+    if (core->CoreDoCommand != NULL)
+        core->CoreDoCommand(M64CMD_ROM_CLOSE, 0, NULL);
+    if (core->CoreShutdown != NULL)
+        core->CoreShutdown();
+    dlclose(core->lib);
+    core->lib = NULL;
+}
+
+static void *core_thread(void *arg)
+{
+    core_instance *core = (core_instance *) arg;
+
+    core->CoreDoCommand(M64CMD_EXECUTE, 0, NULL);
+
+    /* don't leave the other core waiting */
+    l_CoreGone = 1;
+    pthread_mutex_lock(&l_SyncLock);
+    pthread_cond_broadcast(&l_SyncCond);
+    pthread_mutex_unlock(&l_SyncLock);
+    return NULL;
+}
+
+/* runs both cores from the start until they stop; returns 0 if they couldn't be started */
+static int run(int number, unsigned int lastvi, int stepping, int stepvi)
+{
+    int ok;
+
+    l_FirstVI = (l_StateName != NULL) ? 1 : 0;
+    l_LastVI = lastvi;
+    l_Stepping = stepping;
+    l_StepVI = stepvi;
+    l_Stopping = 0;
+    l_Steps = 0;
+    l_CatchUp = 0;
+    l_CatchUps = 0;
+    l_NumStores = 0;
+    l_StoreAnywhere = 0;
+    l_Arrived = 0;
+    l_CoreGone = 0;
+    l_SyncHead = l_SyncTail = 0;
+
+    ok = core_load(&l_Ref, number) && core_load(&l_Test, number);
+    if (ok && l_Stepping && l_StepVI < 0)
+    {
+        start_stepping(&l_Ref);
+        start_stepping(&l_Test);
+    }
+    if (ok)
+    {
+        pthread_create(&l_Ref.thread, NULL, core_thread, &l_Ref);
+        pthread_create(&l_Test.thread, NULL, core_thread, &l_Test);
+        pthread_join(l_Ref.thread, NULL);
+        pthread_join(l_Test.thread, NULL);
+    }
+
+    core_unload(&l_Ref);
+    core_unload(&l_Test);
+    return ok;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+/* whether the core makes the instruction callbacks */
+static int core_can_step(void)
+{
+    void *lib = dlopen(l_CoreName, RTLD_NOW | RTLD_LOCAL);
+    ptr_PluginGetVersion fPluginGetVersion;
+    int caps = 0;
+
+    if (lib == NULL)
+        return 0;
+    fPluginGetVersion = (ptr_PluginGetVersion) dlsym(lib, "PluginGetVersion");
+    if (fPluginGetVersion != NULL)
+        (*fPluginGetVersion)(NULL, NULL, NULL, NULL, &caps);
+    dlclose(lib);
+    return (caps & M64CAPS_CORE_COMPARE) != 0;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf)
+{
+    return remove(path);
+}
+
+static int read_rom(void)
+{
+    FILE *romfile = fopen(l_RomName, "rb");
+
+    if (romfile == NULL)
+    {
+        fprintf(stderr, "Error: can't open '%s'\n", l_RomName);
+        return 0;
+    }
+    fseek(romfile, 0L, SEEK_END);
+    l_RomSize = ftell(romfile);
+    fseek(romfile, 0L, SEEK_SET);
+    l_Rom = (unsigned char *) malloc(l_RomSize);
+    if (l_Rom == NULL || fread(l_Rom, 1, l_RomSize, romfile) != (size_t) l_RomSize)
+    {
+        fprintf(stderr, "Error: can't read '%s'\n", l_RomName);
+        fclose(romfile);
+        return 0;
+    }
+    fclose(romfile);
+    return 1;
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options] <core library> <rom file>\n", program);
+    printf("  --vis N                compare the first N vertical interrupts (default 300)\n");
+    printf("  --reference N          R4300Emulator setting of the reference core (default 0, pure interpreter)\n");
+    printf("  --test N               R4300Emulator setting of the core under test (default 2, dynamic recompiler)\n");
+    printf("  --state FILE           start both cores from this save state instead of the ROM's boot\n");
+    printf("  --no-bisect            stop at the first VI which differs\n");
+    printf("  --data DIR             directory with mupen64plus.ini, for the ROM settings\n");
+    printf("  --set Section[Param]=V set a core configuration parameter in both cores\n");
+    printf("  --verbose              show the cores' messages\n");
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int vis = 300;
+    int bisect = 1, arg, status = 0;
+
+    l_Ref.emulator = 0;
+    l_Test.emulator = 2;
+    l_Settings = (char **) malloc(argc * sizeof(char *));
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--vis") == 0 && arg + 1 < argc)
+            vis = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--reference") == 0 && arg + 1 < argc)
+            l_Ref.emulator = atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--test") == 0 && arg + 1 < argc)
+            l_Test.emulator = atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--state") == 0 && arg + 1 < argc)
+            l_StateName = argv[++arg];
+        else if (strcmp(argv[arg], "--no-bisect") == 0)
+            bisect = 0;
+        else if (strcmp(argv[arg], "--data") == 0 && arg + 1 < argc)
+            l_DataPath = argv[++arg];
+        else if (strcmp(argv[arg], "--set") == 0 && arg + 1 < argc)
+        {
+            const char *open = strchr(argv[++arg], '['), *close = strchr(argv[arg], ']');
+            if (open == NULL || close == NULL || close < open || close[1] != '=' || open - argv[arg] >= 64 ||
+                close - open - 1 >= 64)
+            {
+                fprintf(stderr, "Error: invalid parameter setting '%s'\n", argv[arg]);
+                return 2;
+            }
+            l_Settings[l_NumSettings++] = argv[arg];
+        }
+        else if (strcmp(argv[arg], "--verbose") == 0)
+            l_Verbose = 1;
+        else if (l_CoreName == NULL)
+            l_CoreName = argv[arg];
+        else if (l_RomName == NULL)
+            l_RomName = argv[arg];
+        else
+            break;
+    }
+    if (l_CoreName == NULL || l_RomName == NULL || arg < argc || vis == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    sprintf(l_Ref.name, "R4300Emulator=%i", l_Ref.emulator);
+    sprintf(l_Test.name, "R4300Emulator=%i", l_Test.emulator);
+
+    if (!read_rom())
+        return 2;
+    if (bisect && !core_can_step())
+    {
+        printf("The core isn't built with DBG_COMPARE=1: a difference is only narrowed down to a VI\n");
+        bisect = 0;
+    }
+    /* the cores would carry on from the ROM's boot if they couldn't load it */
+    if (l_StateName != NULL)
+    {
+        FILE *statefile = fopen(l_StateName, "rb");
+        if (statefile == NULL)
+        {
+            fprintf(stderr, "Error: can't open '%s'\n", l_StateName);
+            return 2;
+        }
+        fclose(statefile);
+    }
+    if (mkdtemp(l_TempDir) == NULL)
+    {
+        fprintf(stderr, "Error: can't create a temporary directory\n");
+        return 2;
+    }
+
+    /* first at VI granularity... */
+    l_DiffVI = -1;
+    if (!run(1, (l_StateName != NULL ? 1 : 0) + vis - 1, 0, 0))
+        status = 2;
+    else if (l_DiffVI >= 0)
+    {
+        status = 1;
+        /* ...then again up to the last VI which matched, and one instruction at a time from there */
+        if (bisect)
+        {
+            printf("Stepping from %s\n", l_DiffVI > 0 ? "the previous VI" : "the start");
+            if (!run(2, (unsigned int) l_DiffVI, 1, l_DiffVI - 1))
+                status = 2;
+            if (l_CatchUps > 0)
+                printf("Instructions %s ran alone to catch up: %u\n", l_Ref.name, l_CatchUps);
+        }
+    }
+    else if (!l_Stopping)
+    {
+        printf("A core stopped before VI %u\n", l_LastVI);
+        status = 2;
+    }
+
+    nftw(l_TempDir, remove_entry, 8, FTW_DEPTH | FTW_PHYS);
+
+    if (status == 0)
+        printf("%u VIs compared, no differences\n", vis);
+    return status;
+}
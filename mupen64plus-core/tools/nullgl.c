@@ -0,0 +1,281 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - nullgl.c                                                *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Null GL backend for dlreplay
+ *
+ * dlreplay is linked with its symbols exported, so these definitions take the place of the GL library (and of the
+ * EGL swap from bbutil) for the video plugin it loads: the plugin runs all its CPU side work, and nothing is drawn.
+ * Most entry points do nothing and don't look at their arguments. The ones which hand something back (object names,
+ * queries, shader status) answer like a working GLES 2.0 driver would, so that the plugins take their usual paths.
+ *
+ * The list covers the GL functions used by gles2n64 and by Rice Video; a function missing from it resolves to the real
+ * GL library and will likely crash without a context.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "api/m64p_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GL_VENDOR                               0x1F00
+#define GL_RENDERER                             0x1F01
+#define GL_VERSION                              0x1F02
+#define GL_EXTENSIONS                           0x1F03
+#define GL_SHADING_LANGUAGE_VERSION             0x8B8C
+#define GL_VIEWPORT                             0x0BA2
+#define GL_MAX_TEXTURE_SIZE                     0x0D33
+#define GL_MAX_TEXTURE_UNITS                    0x84E2
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT       0x84FF
+#define GL_MAX_TEXTURE_IMAGE_UNITS              0x8872
+#define GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS     0x8B4D
+#define GL_COMPILE_STATUS                       0x8B81
+#define GL_LINK_STATUS                          0x8B82
+#define GL_VALIDATE_STATUS                      0x8B83
+#define GL_FRAMEBUFFER_COMPLETE                 0x8CD5
+
+static unsigned int l_NextName = 1;
+
+/* entry points with nothing to hand back */
+#define NULLGL_NOOPS \
+    X(glActiveTexture) X(glAlphaFunc) X(glAttachShader) X(glBegin) X(glBindAttribLocation) X(glBindFramebuffer) \
+    X(glBindRenderbuffer) X(glBindTexture) X(glBlendFunc) X(glClear) X(glClearColor) X(glClearDepth) \
+    X(glClearDepthf) X(glColor4f) X(glColor4fv) X(glColor4ub) X(glColorPointer) X(glCompileShader) X(glCullFace) \
+    X(glDeleteFramebuffers) X(glDeleteProgram) X(glDeleteRenderbuffers) X(glDeleteShader) X(glDeleteTextures) \
+    X(glDepthFunc) X(glDepthMask) X(glDepthRange) X(glDepthRangef) X(glDisable) X(glDisableClientState) \
+    X(glDisableVertexAttribArray) X(glDrawArrays) X(glDrawElements) X(glEnable) X(glEnableClientState) \
+    X(glEnableVertexAttribArray) X(glEnd) X(glFinish) X(glFlush) X(glFogf) X(glFogfv) X(glFogi) \
+    X(glFramebufferRenderbuffer) X(glFramebufferTexture2D) X(glFrontFace) X(glGenerateMipmap) X(glHint) \
+    X(glLineWidth) X(glLinkProgram) X(glLoadIdentity) X(glMatrixMode) X(glOrtho) X(glPixelStorei) \
+    X(glPolygonMode) X(glPolygonOffset) X(glReadBuffer) X(glReadPixels) X(glRenderbufferStorage) X(glScissor) \
+    X(glShadeModel) X(glShaderSource) X(glTexCoord2f) X(glTexCoordPointer) X(glTexEnvfv) X(glTexEnvi) \
+    X(glTexImage2D) X(glTexParameteri) X(glTexSubImage2D) X(glUniform1f) X(glUniform1i) X(glUniform2f) \
+    X(glUniform4f) X(glUniform4fv) X(glUseProgram) X(glValidateProgram) X(glVertex3f) X(glVertex4f) \
+    X(glVertexAttrib4f) X(glVertexAttrib4fv) X(glVertexAttribPointer) X(glVertexPointer) X(glViewport) \
+    X(PB_eglSwapBuffers)
+
+#define X(name) EXPORT void CALL name(void) { }
+NULLGL_NOOPS
+#undef X
+
+/* stands in for anything asked for by name which isn't in the table below */
+static void nullgl_Stub(void)
+{
+}
+
+EXPORT unsigned int CALL glGetError(void)
+{
+    return 0;
+}
+
+EXPORT const unsigned char * CALL glGetString(unsigned int name)
+{
+    switch (name)
+    {
+        case GL_VENDOR:                     return (const unsigned char *) "Mupen64Plus";
+        case GL_RENDERER:                   return (const unsigned char *) "Null GL";
+        case GL_VERSION:                    return (const unsigned char *) "OpenGL ES 2.0 Null GL";
+        case GL_SHADING_LANGUAGE_VERSION:   return (const unsigned char *) "OpenGL ES GLSL ES 1.00";
+        case GL_EXTENSIONS:                 return (const unsigned char *) "GL_OES_depth24 GL_OES_rgb8_rgba8 GL_EXT_texture_filter_anisotropic";
+        default:                            return (const unsigned char *) "";
+    }
+}
+
+EXPORT void CALL glGetIntegerv(unsigned int pname, int *params)
+{
+    switch (pname)
+    {
+        case GL_VIEWPORT:
+            params[0] = 0;
+            params[1] = 0;
+            params[2] = 640;
+            params[3] = 480;
+            break;
+        case GL_MAX_TEXTURE_SIZE:
+            params[0] = 2048;
+            break;
+        case GL_MAX_TEXTURE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+            params[0] = 8;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+EXPORT void CALL glGetFloatv(unsigned int pname, float *params)
+{
+    params[0] = (pname == GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT) ? 1.0f : 0.0f;
+}
+
+EXPORT void CALL glGetPointerv(unsigned int pname, void **params)
+{
+    params[0] = NULL;
+}
+
+EXPORT void CALL glGetTexParameteriv(unsigned int target, unsigned int pname, int *params)
+{
+    params[0] = 0;
+}
+
+EXPORT unsigned char CALL glIsEnabled(unsigned int cap)
+{
+    return 0;
+}
+
+static void gen_names(int n, unsigned int *names)
+{
+    int i;
+    for (i = 0; i < n; i++)
+        names[i] = l_NextName++;
+}
+
+EXPORT void CALL glGenTextures(int n, unsigned int *textures)
+{
+    gen_names(n, textures);
+}
+
+EXPORT void CALL glGenFramebuffers(int n, unsigned int *framebuffers)
+{
+    gen_names(n, framebuffers);
+}
+
+EXPORT void CALL glGenRenderbuffers(int n, unsigned int *renderbuffers)
+{
+    gen_names(n, renderbuffers);
+}
+
+EXPORT void CALL glGenBuffers(int n, unsigned int *buffers)
+{
+    gen_names(n, buffers);
+}
+
+EXPORT unsigned int CALL glCreateShader(unsigned int type)
+{
+    return l_NextName++;
+}
+
+EXPORT unsigned int CALL glCreateProgram(void)
+{
+    return l_NextName++;
+}
+
+EXPORT int CALL glGetUniformLocation(unsigned int program, const char *name)
+{
+    return (int) (l_NextName++ & 0xFFFF);
+}
+
+EXPORT int CALL glGetAttribLocation(unsigned int program, const char *name)
+{
+    return 0;
+}
+
+EXPORT unsigned int CALL glCheckFramebufferStatus(unsigned int target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+/* shaders always compile and link, with an empty log */
+EXPORT void CALL glGetShaderiv(unsigned int shader, unsigned int pname, int *params)
+{
+    params[0] = (pname == GL_COMPILE_STATUS) ? 1 : 0;
+}
+
+EXPORT void CALL glGetProgramiv(unsigned int program, unsigned int pname, int *params)
+{
+    params[0] = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? 1 : 0;
+}
+
+static void empty_log(int bufSize, int *length, char *infoLog)
+{
+    if (length != NULL)
+        *length = 0;
+    if (bufSize > 0 && infoLog != NULL)
+        infoLog[0] = '\0';
+}
+
+EXPORT void CALL glGetShaderInfoLog(unsigned int shader, int bufSize, int *length, char *infoLog)
+{
+    empty_log(bufSize, length, infoLog);
+}
+
+EXPORT void CALL glGetProgramInfoLog(unsigned int program, int bufSize, int *length, char *infoLog)
+{
+    empty_log(bufSize, length, infoLog);
+}
+
+/* for VidExt_GL_GetProcAddress() */
+static const struct
+{
+    const char *name;
+    void       (*func)(void);
+} l_NullGLFunctions[] = {
+#define X(name) { #name, (void (*)(void)) name },
+    NULLGL_NOOPS
+#undef X
+    { "glGetError", (void (*)(void)) glGetError },
+    { "glGetString", (void (*)(void)) glGetString },
+    { "glGetIntegerv", (void (*)(void)) glGetIntegerv },
+    { "glGetFloatv", (void (*)(void)) glGetFloatv },
+    { "glGetPointerv", (void (*)(void)) glGetPointerv },
+    { "glGetTexParameteriv", (void (*)(void)) glGetTexParameteriv },
+    { "glIsEnabled", (void (*)(void)) glIsEnabled },
+    { "glGenTextures", (void (*)(void)) glGenTextures },
+    { "glGenFramebuffers", (void (*)(void)) glGenFramebuffers },
+    { "glGenRenderbuffers", (void (*)(void)) glGenRenderbuffers },
+    { "glGenBuffers", (void (*)(void)) glGenBuffers },
+    { "glCreateShader", (void (*)(void)) glCreateShader },
+    { "glCreateProgram", (void (*)(void)) glCreateProgram },
+    { "glGetUniformLocation", (void (*)(void)) glGetUniformLocation },
+    { "glGetAttribLocation", (void (*)(void)) glGetAttribLocation },
+    { "glCheckFramebufferStatus", (void (*)(void)) glCheckFramebufferStatus },
+    { "glGetShaderiv", (void (*)(void)) glGetShaderiv },
+    { "glGetProgramiv", (void (*)(void)) glGetProgramiv },
+    { "glGetShaderInfoLog", (void (*)(void)) glGetShaderInfoLog },
+    { "glGetProgramInfoLog", (void (*)(void)) glGetProgramInfoLog },
+};
+
+void *nullgl_GetProcAddress(const char *name)
+{
+    size_t i, len = strlen(name);
+
+    /* extension entry points are served by the core function of the same name */
+    if (len > 3 && (strcmp(name + len - 3, "ARB") == 0 || strcmp(name + len - 3, "EXT") == 0 ||
+                    strcmp(name + len - 3, "OES") == 0))
+        len -= 3;
+
+    for (i = 0; i < sizeof(l_NullGLFunctions) / sizeof(l_NullGLFunctions[0]); i++)
+    {
+        if (strncmp(l_NullGLFunctions[i].name, name, len) == 0 && l_NullGLFunctions[i].name[len] == '\0')
+            return (void *) l_NullGLFunctions[i].func;
+    }
+
+    return (void *) nullgl_Stub;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
@@ -0,0 +1,367 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - pacerbench.c                                            *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* pacerbench - measures how evenly the core paces frames under load
+ *
+ * Usage: pacerbench [options] <core library> [<rom file>]
+ *
+ * Runs the ROM headless with the dummy plugins and the speed limiter on, for a number of vertical interrupts. The VI
+ * callback, which the core calls just before new_vi() waits for the frame's deadline, takes a time stamp and then
+ * spins for a random time in the given range to stand in for a slow frame; every so often it adds a longer spike.
+ * At the end it prints percentiles of the time between VIs, how far each VI was from its ideal place on the
+ * timeline, and the core's own frame time statistics (M64CORE_FRAME_TIME_*).
+ *
+ * Without a ROM file it runs a built-in one which only idles in a loop, so the VIs come from the core alone and
+ * nearly all of each frame is the injected load. The exit status is 1 when the p99 VI interval is more than the
+ * --max-jitter limit over the period of the ROM's video standard, so 'make check' can run it; 2 is an error.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <ftw.h>
+
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_config.h"
+#include "api/m64p_frontend.h"
+#include "main/version.h"
+
+static int  l_Verbose = 0;
+
+static ptr_CoreDoCommand l_CoreDoCommand = NULL;
+static unsigned int      l_StopVI;
+static unsigned int      l_SkipVIs;
+static double           *l_VITimes;
+static double            l_LoadMin, l_LoadMax;
+static unsigned int      l_SpikeEvery;
+static double            l_Spike;
+static int               l_CoreFrameMin, l_CoreFrameAvg, l_CoreFrameP99, l_CoreBusy;
+static double            l_MaxJitter;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void debug_callback(void *context, int level, const char *message)
+{
+    if (l_Verbose || level <= M64MSG_ERROR)
+        fprintf(stderr, "%s: %s\n", (const char *) context, message);
+}
+
+static void vi_callback(unsigned int vi)
+{
+    double start = now(), load;
+
+    if (vi < l_StopVI)
+        l_VITimes[vi] = start;
+    else
+    {
+        /* the core only answers these while the emulator runs */
+        l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_FRAME_TIME_MIN, &l_CoreFrameMin);
+        l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_FRAME_TIME_AVG, &l_CoreFrameAvg);
+        l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_FRAME_TIME_P99, &l_CoreFrameP99);
+        l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_EMU_BUSY_TIME, &l_CoreBusy);
+        l_CoreDoCommand(M64CMD_STOP, 0, NULL);
+        return;
+    }
+
+    /* emulating the frame took this much longer */
+    load = l_LoadMin + (l_LoadMax - l_LoadMin) * (rand() / (RAND_MAX + 1.0));
+    if (l_SpikeEvery != 0 && vi % l_SpikeEvery == l_SpikeEvery - 1)
+        load += l_Spike;
+    while (now() - start < load)
+        ;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return x < y ? -1 : x > y;
+}
+
+static double percentile(const double *sorted, int count, double p)
+{
+    int i = (int) (p / 100.0 * (count - 1) + 0.5);
+    return sorted[i];
+}
+
+/* A NTSC ROM which jumps to itself forever: boot copies it to 0xA4000040 and runs it from there. */
+static unsigned char *test_rom(long *size)
+{
+    static const unsigned char header[] = { 0x80, 0x37, 0x12, 0x40, 0, 0, 0, 0, 0x80, 0, 0x04, 0 };
+    static const unsigned char code[] = { 0x10, 0x00, 0xFF, 0xFF, 0, 0, 0, 0 };  /* b . ; nop */
+    unsigned char *rom;
+
+    *size = 0x100000;
+    rom = (unsigned char *) calloc(*size, 1);
+    if (rom == NULL)
+        return NULL;
+    memcpy(rom, header, sizeof(header));
+    memcpy(rom + 0x20, "PACERBENCH", 10);
+    rom[0x3E] = 'E';
+    memcpy(rom + 0x40, code, sizeof(code));
+    return rom;
+}
+
+/* The frame period the core paces the ROM at, from the country code as in main/rom.c. */
+static double rom_period(void)
+{
+    m64p_rom_header header;
+
+    if (l_CoreDoCommand(M64CMD_ROM_GET_HEADER, sizeof(header), &header) == M64ERR_SUCCESS)
+    {
+        switch (header.Country_code & 0xFF)
+        {
+            case 0x44: case 0x46: case 0x49: case 0x50:
+            case 0x53: case 0x55: case 0x58: case 0x59:
+                return 1.0 / 50;
+        }
+    }
+    return 1.0 / 60;
+}
+
+static void print_stats(const char *name, double *values, int count)
+{
+    qsort(values, count, sizeof(double), compare_double);
+    printf("%-18s %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f\n", name, values[0] * 1e3, percentile(values, count, 50) * 1e3,
+           percentile(values, count, 90) * 1e3, percentile(values, count, 99) * 1e3,
+           percentile(values, count, 99.9) * 1e3, values[count - 1] * 1e3);
+}
+
+static unsigned char *read_rom(const char *romname, long *romsize)
+{
+    unsigned char *romdata;
+    FILE *file;
+
+    file = fopen(romname, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error: can't open '%s'\n", romname);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    *romsize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    romdata = (unsigned char *) malloc(*romsize);
+    if (romdata == NULL || fread(romdata, 1, *romsize, file) != (size_t) *romsize)
+    {
+        fprintf(stderr, "Error: can't read '%s'\n", romname);
+        free(romdata);
+        romdata = NULL;
+    }
+    fclose(file);
+    return romdata;
+}
+
+/* Returns 0 when the pacing is within the limit, 1 when it isn't and 2 on an error. */
+static int run(const char *romname)
+{
+    unsigned char *romdata;
+    long romsize;
+    double *intervals, *errors, period, target, jitter;
+    int count, i, late = 0;
+
+    if (romname == NULL)
+    {
+        romname = "the test ROM";
+        romdata = test_rom(&romsize);
+    }
+    else
+        romdata = read_rom(romname, &romsize);
+    if (romdata == NULL)
+        return 2;
+
+    if (l_CoreDoCommand(M64CMD_ROM_OPEN, (int) romsize, romdata) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "Error: the core couldn't open '%s'\n", romname);
+        free(romdata);
+        return 2;
+    }
+    free(romdata);
+    target = rom_period();
+
+    memset(l_VITimes, 0, l_StopVI * sizeof(double));
+    l_CoreDoCommand(M64CMD_SET_VI_CALLBACK, 0, vi_callback);
+    l_CoreDoCommand(M64CMD_EXECUTE, 0, NULL);
+    l_CoreDoCommand(M64CMD_SET_VI_CALLBACK, 0, NULL);
+    l_CoreDoCommand(M64CMD_ROM_CLOSE, 0, NULL);
+
+    /* the first VIs are spent booting and settling the schedule */
+    count = l_StopVI - l_SkipVIs - 1;
+    if (l_VITimes[l_StopVI - 1] == 0 || count < 2)
+    {
+        fprintf(stderr, "Error: '%s' stopped before VI %u\n", romname, l_StopVI);
+        return 2;
+    }
+    intervals = (double *) malloc(count * sizeof(double));
+    errors = (double *) malloc((count + 1) * sizeof(double));
+    for (i = 0; i < count; i++)
+        intervals[i] = l_VITimes[l_SkipVIs + i + 1] - l_VITimes[l_SkipVIs + i];
+    /* the ideal timeline is a straight line through the VIs, its slope is the average period */
+    period = (l_VITimes[l_StopVI - 1] - l_VITimes[l_SkipVIs]) / count;
+    for (i = 0; i <= count; i++)
+    {
+        errors[i] = l_VITimes[l_SkipVIs + i] - (l_VITimes[l_SkipVIs] + i * period);
+        if (i > 0 && intervals[i - 1] > period * 1.5)
+            late++;
+    }
+    /* only the spread matters, not where the line starts */
+    qsort(errors, count + 1, sizeof(double), compare_double);
+    for (i = count; i >= 0; i--)
+        errors[i] -= errors[0];
+
+    printf("%d VIs, average period %.3f ms, %d intervals longer than 1.5 periods\n", count, period * 1e3, late);
+    printf("%-18s %8s %8s %8s %8s %8s %8s\n", "ms", "min", "p50", "p90", "p99", "p99.9", "max");
+    print_stats("VI interval", intervals, count);
+    /* print_stats() sorted them */
+    jitter = percentile(intervals, count, 99) - target;
+    print_stats("timeline offset", errors, count + 1);
+    printf("core, last frames: min %.3f ms, average %.3f ms, p99 %.3f ms, busy %.3f ms\n", l_CoreFrameMin / 1e3,
+           l_CoreFrameAvg / 1e3, l_CoreFrameP99 / 1e3, l_CoreBusy / 1e3);
+    printf("p99 VI interval is %.3f ms over the %.3f ms period, the limit is %.3f ms: %s\n", jitter * 1e3, target * 1e3,
+           l_MaxJitter * 1e3, jitter <= l_MaxJitter ? "ok" : "FAILED");
+
+    free(intervals);
+    free(errors);
+    return jitter <= l_MaxJitter ? 0 : 1;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf)
+{
+    return remove(path);
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options] <core library> [<rom file>]\n", program);
+    printf("  --vis N                run the ROM for N vertical interrupts (default 1200)\n");
+    printf("  --skip N               leave the first N VIs out of the statistics (default 60)\n");
+    printf("  --load MIN-MAX         extra time per VI in ms, uniformly random (default 0-8)\n");
+    printf("  --spike N:MS           add MS ms to every Nth VI (default none)\n");
+    printf("  --max-jitter US        fail when the p99 VI interval is more than US us over the period (default 1000)\n");
+    printf("  --data DIR             directory with mupen64plus.ini, for the ROM settings\n");
+    printf("  --verbose              show the core's messages\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *corename = NULL, *romname = NULL, *datapath = NULL;
+    unsigned int vis = 1200, skip = 60;
+    double loadmin = 0, loadmax = 8, spike = 0, maxjitter = 1000;
+    int spikeevery = 0, arg, status;
+    void *lib;
+    ptr_CoreStartup fCoreStartup;
+    ptr_CoreShutdown fCoreShutdown;
+    char configdir[] = "/tmp/pacerbench.XXXXXX";
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--vis") == 0 && arg + 1 < argc)
+            vis = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--skip") == 0 && arg + 1 < argc)
+            skip = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--load") == 0 && arg + 1 < argc)
+        {
+            if (sscanf(argv[++arg], "%lf-%lf", &loadmin, &loadmax) != 2 || loadmin < 0 || loadmax < loadmin)
+            {
+                fprintf(stderr, "Error: invalid load '%s'\n", argv[arg]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[arg], "--spike") == 0 && arg + 1 < argc)
+        {
+            if (sscanf(argv[++arg], "%d:%lf", &spikeevery, &spike) != 2 || spikeevery < 1 || spike < 0)
+            {
+                fprintf(stderr, "Error: invalid spike '%s'\n", argv[arg]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[arg], "--max-jitter") == 0 && arg + 1 < argc)
+            maxjitter = atof(argv[++arg]);
+        else if (strcmp(argv[arg], "--data") == 0 && arg + 1 < argc)
+            datapath = argv[++arg];
+        else if (strcmp(argv[arg], "--verbose") == 0)
+            l_Verbose = 1;
+        else if (corename == NULL)
+            corename = argv[arg];
+        else if (romname == NULL)
+            romname = argv[arg];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (corename == NULL || vis < skip + 3)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    lib = dlopen(corename, RTLD_NOW | RTLD_LOCAL);
+    if (lib == NULL)
+    {
+        fprintf(stderr, "Error: can't load '%s': %s\n", corename, dlerror());
+        return 2;
+    }
+    fCoreStartup = (ptr_CoreStartup) dlsym(lib, "CoreStartup");
+    fCoreShutdown = (ptr_CoreShutdown) dlsym(lib, "CoreShutdown");
+    l_CoreDoCommand = (ptr_CoreDoCommand) dlsym(lib, "CoreDoCommand");
+    if (fCoreStartup == NULL || fCoreShutdown == NULL || l_CoreDoCommand == NULL)
+    {
+        fprintf(stderr, "Error: '%s' is not a Mupen64Plus core library\n", corename);
+        dlclose(lib);
+        return 2;
+    }
+
+    /* a configuration of our own, so that the user's doesn't change the numbers */
+    if (mkdtemp(configdir) == NULL ||
+        (*fCoreStartup)(FRONTEND_API_VERSION, configdir, datapath, "Core", debug_callback, NULL, NULL) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "Error: core startup failed\n");
+        dlclose(lib);
+        return 2;
+    }
+
+    l_StopVI = vis;
+    l_SkipVIs = skip;
+    l_LoadMin = loadmin / 1e3;
+    l_LoadMax = loadmax / 1e3;
+    l_SpikeEvery = spikeevery;
+    l_Spike = spike / 1e3;
+    l_MaxJitter = maxjitter / 1e6;
+    l_VITimes = (double *) malloc(vis * sizeof(double));
+    srand(1);
+    status = l_VITimes != NULL ? run(romname) : 2;
+
+    free(l_VITimes);
+    (*fCoreShutdown)();
+    dlclose(lib);
+    nftw(configdir, remove_entry, 8, FTW_DEPTH | FTW_PHYS);
+    return status;
+}
@@ -0,0 +1,430 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romchunk.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* romchunk - makes chunked compressed ROM images and measures what they cost
+ *
+ * Usage: romchunk pack [options] <rom file> <output file>
+ *        romchunk bench [options] <core library> <rom file>...
+ *
+ * 'pack' converts a .z64, .v64 or .n64 ROM to the chunked container described in main/romchunks.h: the ROM is put
+ * in .z64 byte order, cut into chunks, and each chunk is compressed with zlib on its own (or stored raw when that
+ * doesn't make it smaller). The core opens the result like any other ROM.
+ *
+ * 'bench' opens each ROM in turn in the core, headless with the dummy plugins and without the speed limiter, and
+ * runs it for a number of vertical interrupts. It prints the time the core took to open the ROM, the time to the
+ * first VI (the boot), the time for the whole run, and the core's statistics for the PI DMAs from the cartridge: the
+ * average and longest DMA, and how many chunks had to be inflated while the game waited. The core only keeps these
+ * for a packed image. Give it the flat ROM and its packed image to see what the compression costs.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <ftw.h>
+#include <zlib.h>
+
+#include "api/m64p_types.h"
+#include "api/m64p_common.h"
+#include "api/m64p_config.h"
+#include "api/m64p_frontend.h"
+#include "main/md5.h"
+#include "main/romchunks.h"
+#include "main/version.h"
+
+static int  l_Verbose = 0;
+
+static ptr_CoreDoCommand l_CoreDoCommand = NULL;
+static unsigned int      l_StopVI;
+static double            l_StartTime;
+static double            l_FirstVITime;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void put32(unsigned char *p, unsigned int value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = value >> 24;
+}
+
+static unsigned char *read_file(const char *name, long *size)
+{
+    FILE *file = fopen(name, "rb");
+    unsigned char *data;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Error: can't open '%s'\n", name);
+        return NULL;
+    }
+    fseek(file, 0L, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+    data = (unsigned char *) malloc(*size > 0 ? *size : 1);
+    if (data == NULL || fread(data, 1, *size, file) != (size_t) *size)
+    {
+        fprintf(stderr, "Error: can't read '%s'\n", name);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* pack */
+
+/* puts the ROM in .z64 byte order; returns 0 if it isn't a ROM */
+static int to_z64(unsigned char *rom, long size)
+{
+    unsigned char temp;
+    long i;
+
+    if (rom[0] == 0x80 && rom[1] == 0x37 && rom[2] == 0x12 && rom[3] == 0x40)
+        return 1;
+    if (rom[0] == 0x37 && rom[1] == 0x80 && rom[2] == 0x40 && rom[3] == 0x12)
+    {
+        for (i = 0; i + 1 < size; i += 2)
+        {
+            temp = rom[i]; rom[i] = rom[i + 1]; rom[i + 1] = temp;
+        }
+        return 1;
+    }
+    if (rom[0] == 0x40 && rom[1] == 0x12 && rom[2] == 0x37 && rom[3] == 0x80)
+    {
+        for (i = 0; i + 3 < size; i += 4)
+        {
+            temp = rom[i]; rom[i] = rom[i + 3]; rom[i + 3] = temp;
+            temp = rom[i + 1]; rom[i + 1] = rom[i + 2]; rom[i + 2] = temp;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int pack(const char *inname, const char *outname, unsigned int chunksize, int level)
+{
+    unsigned char *rom, *out, *header, *dst;
+    unsigned int numchunks, chunk, offset, headersize;
+    uLong bound;
+    long romsize;
+    md5_state_t state;
+    FILE *outfile;
+    int ok;
+
+    rom = read_file(inname, &romsize);
+    if (rom == NULL)
+        return 2;
+    if (romsize < 0x1000 || romsize > 0x4000000 || !to_z64(rom, romsize))
+    {
+        fprintf(stderr, "Error: '%s' is not a ROM image\n", inname);
+        free(rom);
+        return 2;
+    }
+
+    numchunks = (unsigned int) ((romsize + chunksize - 1) / chunksize);
+    headersize = ROMCHUNKS_HEADER + (numchunks + 1) * 4;
+    bound = compressBound(chunksize);
+    header = (unsigned char *) calloc(1, headersize);
+    out = (unsigned char *) malloc(numchunks * bound);
+    if (header == NULL || out == NULL)
+    {
+        fprintf(stderr, "Error: out of memory\n");
+        free(rom);
+        free(header);
+        free(out);
+        return 2;
+    }
+
+    memcpy(header, ROMCHUNKS_MAGIC, 8);
+    put32(header + 8, ROMCHUNKS_VERSION);
+    put32(header + 12, chunksize);
+    put32(header + 16, (unsigned int) romsize);
+    put32(header + 20, numchunks);
+    md5_init(&state);
+    md5_append(&state, (const md5_byte_t *) rom, (int) romsize);
+    md5_finish(&state, header + 24);
+
+    /* a chunk that zlib can't make smaller is stored as it is, which the core tells by its size */
+    dst = out;
+    offset = headersize;
+    for (chunk = 0; chunk < numchunks; chunk++)
+    {
+        unsigned int start = chunk * chunksize;
+        unsigned int length = (romsize - start < chunksize) ? (unsigned int) (romsize - start) : chunksize;
+        uLongf packed = bound;
+
+        put32(header + ROMCHUNKS_HEADER + chunk * 4, offset);
+        if (compress2(dst, &packed, rom + start, length, level) != Z_OK || packed >= length)
+        {
+            memcpy(dst, rom + start, length);
+            packed = length;
+        }
+        dst += packed;
+        offset += (unsigned int) packed;
+    }
+    put32(header + ROMCHUNKS_HEADER + numchunks * 4, offset);
+
+    outfile = fopen(outname, "wb");
+    ok = (outfile != NULL &&
+          fwrite(header, 1, headersize, outfile) == headersize &&
+          fwrite(out, 1, dst - out, outfile) == (size_t) (dst - out));
+    if (outfile != NULL && fclose(outfile) != 0)
+        ok = 0;
+    if (ok)
+        printf("%s: %ld KB in %u chunks of %u KB, %u KB packed (%.1f%%)\n", outname, romsize >> 10, numchunks,
+               chunksize >> 10, offset >> 10, offset * 100.0 / romsize);
+    else
+        fprintf(stderr, "Error: can't write '%s'\n", outname);
+
+    free(rom);
+    free(header);
+    free(out);
+    return ok ? 0 : 2;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* bench */
+
+static void debug_callback(void *context, int level, const char *message)
+{
+    if (l_Verbose || level <= M64MSG_ERROR)
+        fprintf(stderr, "%s: %s\n", (const char *) context, message);
+}
+
+static void vi_callback(unsigned int vi)
+{
+    if (vi == 1)
+        l_FirstVITime = now();
+    if (vi >= l_StopVI)
+        l_CoreDoCommand(M64CMD_STOP, 0, NULL);
+}
+
+static int bench_rom(const char *romname, unsigned int vis)
+{
+    unsigned char *romdata;
+    long romsize;
+    double opentime, endtime;
+    int zero = 0, average = 0, longest = 0, misses = 0;
+
+    romdata = read_file(romname, &romsize);
+    if (romdata == NULL)
+        return 0;
+
+    l_StartTime = now();
+    l_FirstVITime = 0;
+    if (l_CoreDoCommand(M64CMD_ROM_OPEN, (int) romsize, romdata) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "Error: the core couldn't open '%s'\n", romname);
+        free(romdata);
+        return 0;
+    }
+    opentime = now();
+    free(romdata);
+
+    l_CoreDoCommand(M64CMD_CORE_STATE_SET, M64CORE_SPEED_LIMITER, &zero);
+    l_CoreDoCommand(M64CMD_SET_VI_CALLBACK, 0, vi_callback);
+    l_CoreDoCommand(M64CMD_EXECUTE, 0, NULL);
+    endtime = now();
+
+    l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_ROM_DMA_TIME_AVG, &average);
+    l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_ROM_DMA_TIME_MAX, &longest);
+    l_CoreDoCommand(M64CMD_CORE_STATE_QUERY, M64CORE_ROM_CHUNK_MISSES, &misses);
+    l_CoreDoCommand(M64CMD_SET_VI_CALLBACK, 0, NULL);
+    l_CoreDoCommand(M64CMD_ROM_CLOSE, 0, NULL);
+
+    if (l_FirstVITime == 0)
+    {
+        fprintf(stderr, "Error: '%s' stopped before the first VI\n", romname);
+        return 0;
+    }
+    printf("%-32s %8.1f %8.1f %8.1f", romname, (opentime - l_StartTime) * 1e3, (l_FirstVITime - l_StartTime) * 1e3,
+           (endtime - l_StartTime) * 1e3);
+    /* the core only times the DMAs of a chunked image */
+    if (longest == 0)
+        printf(" %10s %10s %7s\n", "-", "-", "-");
+    else
+        printf(" %10.2f %10.2f %7i\n", average / 1e3, longest / 1e3, misses);
+    return 1;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf)
+{
+    return remove(path);
+}
+
+static int bench(const char *corename, char **romnames, int numroms, unsigned int vis, const char *datapath,
+                 char **settings, int numsettings)
+{
+    void *lib;
+    ptr_CoreStartup fCoreStartup;
+    ptr_CoreShutdown fCoreShutdown;
+    ptr_ConfigOpenSection fConfigOpenSection;
+    ptr_ConfigSetParameter fConfigSetParameter;
+    char configdir[] = "/tmp/romchunk.XXXXXX";
+    m64p_handle section;
+    int i, status = 0;
+
+    lib = dlopen(corename, RTLD_NOW | RTLD_LOCAL);
+    if (lib == NULL)
+    {
+        fprintf(stderr, "Error: can't load '%s': %s\n", corename, dlerror());
+        return 2;
+    }
+    fCoreStartup = (ptr_CoreStartup) dlsym(lib, "CoreStartup");
+    fCoreShutdown = (ptr_CoreShutdown) dlsym(lib, "CoreShutdown");
+    fConfigOpenSection = (ptr_ConfigOpenSection) dlsym(lib, "ConfigOpenSection");
+    fConfigSetParameter = (ptr_ConfigSetParameter) dlsym(lib, "ConfigSetParameter");
+    l_CoreDoCommand = (ptr_CoreDoCommand) dlsym(lib, "CoreDoCommand");
+    if (fCoreStartup == NULL || fCoreShutdown == NULL || fConfigOpenSection == NULL || fConfigSetParameter == NULL ||
+        l_CoreDoCommand == NULL)
+    {
+        fprintf(stderr, "Error: '%s' is not a Mupen64Plus core library\n", corename);
+        dlclose(lib);
+        return 2;
+    }
+
+    /* a configuration of our own, so that the user's doesn't change the numbers */
+    if (mkdtemp(configdir) == NULL ||
+        (*fCoreStartup)(FRONTEND_API_VERSION, configdir, datapath, "Core", debug_callback, NULL, NULL) != M64ERR_SUCCESS)
+    {
+        fprintf(stderr, "Error: core startup failed\n");
+        dlclose(lib);
+        return 2;
+    }
+    for (i = 0; i < numsettings; i++)
+    {
+        char sectionname[64], param[64];
+        const char *open = strchr(settings[i], '['), *close = strchr(settings[i], ']');
+
+        memcpy(sectionname, settings[i], open - settings[i]);
+        sectionname[open - settings[i]] = 0;
+        memcpy(param, open + 1, close - open - 1);
+        param[close - open - 1] = 0;
+        if ((*fConfigOpenSection)(sectionname, &section) != M64ERR_SUCCESS ||
+            (*fConfigSetParameter)(section, param, M64TYPE_STRING, close + 2) != M64ERR_SUCCESS)
+        {
+            fprintf(stderr, "Error: can't set '%s'\n", settings[i]);
+            status = 2;
+        }
+    }
+
+    l_StopVI = vis;
+    printf("%-32s %8s %8s %8s %10s %10s %7s\n", "", "open ms", "boot ms", "run ms", "DMA avg us", "DMA max us",
+           "misses");
+    for (i = 0; i < numroms && status == 0; i++)
+        if (!bench_rom(romnames[i], vis))
+            status = 2;
+
+    (*fCoreShutdown)();
+    dlclose(lib);
+    nftw(configdir, remove_entry, 8, FTW_DEPTH | FTW_PHYS);
+    return status;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void usage(const char *program)
+{
+    printf("Usage: %s pack [options] <rom file> <output file>\n", program);
+    printf("  --chunk KB             chunk size, a multiple of 4 (default 64)\n");
+    printf("  --level N              zlib compression level, 1-9 (default 9)\n");
+    printf("Usage: %s bench [options] <core library> <rom file>...\n", program);
+    printf("  --vis N                run each ROM for N vertical interrupts (default 600)\n");
+    printf("  --data DIR             directory with mupen64plus.ini, for the ROM settings\n");
+    printf("  --set Section[Param]=V set a core configuration parameter\n");
+    printf("  --verbose              show the core's messages\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char **names, **settings;
+    const char *datapath = NULL;
+    unsigned int chunkkb = 64, vis = 600;
+    int level = 9, numnames = 0, numsettings = 0, arg, status;
+
+    if (argc < 2 || (strcmp(argv[1], "pack") != 0 && strcmp(argv[1], "bench") != 0))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    names = (char **) malloc(argc * sizeof(char *));
+    settings = (char **) malloc(argc * sizeof(char *));
+    for (arg = 2; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--chunk") == 0 && arg + 1 < argc)
+            chunkkb = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--level") == 0 && arg + 1 < argc)
+            level = atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--vis") == 0 && arg + 1 < argc)
+            vis = (unsigned int) atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--data") == 0 && arg + 1 < argc)
+            datapath = argv[++arg];
+        else if (strcmp(argv[arg], "--set") == 0 && arg + 1 < argc)
+        {
+            const char *open = strchr(argv[++arg], '['), *close = strchr(argv[arg], ']');
+            if (open == NULL || close == NULL || close < open || close[1] != '=' || open - argv[arg] >= 64 ||
+                close - open - 1 >= 64)
+            {
+                fprintf(stderr, "Error: invalid parameter setting '%s'\n", argv[arg]);
+                return 2;
+            }
+            settings[numsettings++] = argv[arg];
+        }
+        else if (strcmp(argv[arg], "--verbose") == 0)
+            l_Verbose = 1;
+        else
+            names[numnames++] = argv[arg];
+    }
+
+    if (strcmp(argv[1], "pack") == 0)
+    {
+        if (numnames != 2 || chunkkb == 0 || (chunkkb & 3) != 0 || chunkkb > 0x10000 || level < 1 || level > 9)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        status = pack(names[0], names[1], chunkkb << 10, level);
+    }
+    else
+    {
+        if (numnames < 2 || vis == 0)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        status = bench(names[0], names + 1, numnames - 1, vis, datapath, settings, numsettings);
+    }
+
+    free(names);
+    free(settings);
+    return status;
+}
@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - videothreadbench.c                                      *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* videothreadbench - measures what the video thread gains, and checks when it raises the DP interrupt
+ *
+ * Usage: videothreadbench [frames] [CPU us per frame] [video us per frame] [display lists per frame]
+ *
+ * Runs plugin/video_thread.c with a made-up game and a null video plugin which only spends time: every frame the game
+ * runs for half of its CPU time, sends its display lists, runs for the other half and then idles, taking the core's
+ * DP_INT events the way r4300/interupt.c does, until the DP interrupt of its last display list is raised, and then the
+ * screen is updated at the VI. It does that with the plugin called from the emulation thread and then with the video
+ * thread, and prints the frame rates. Each DP interrupt has to come after the plugin is done with its display list.
+ * With a single core on the host the video thread can't gain anything.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#define M64P_CORE_PROTOTYPES 1
+#include "api/m64p_types.h"
+#include "api/m64p_config.h"
+#include "api/callbacks.h"
+#include "api/vidext.h"
+#include "main/main.h"
+#include "memory/memory.h"
+#include "plugin/plugin.h"
+#include "plugin/video_thread.h"
+
+#define DP_POLL_US      20      /* 1000 cycles of a DP_INT event, at full speed */
+
+/* the core state plugin/video_thread.c uses */
+unsigned int SP_DMEM[0x1000/4*2];
+VI_register vi_register;
+DPC_register dpc_register;
+mips_register MI_register;
+gfx_plugin_functions gfx;
+m64p_handle g_CoreConfig = NULL;
+
+static int l_VideoThread;
+static GFX_INFO l_GfxInfo;
+static double l_ListTime, l_SwapTime;
+static unsigned int l_ListsDone;        /* by the plugin */
+
+EXPORT int CALL ConfigGetParamBool(m64p_handle ConfigSectionHandle, const char *ParamName)
+{
+    return l_VideoThread;
+}
+
+void VidExt_GL_MakeCurrent(int bCurrent)
+{
+}
+
+void DebugMessage(int level, const char *message, ...)
+{
+    va_list args;
+    if (level > M64MSG_WARNING)
+        return;
+    va_start(args, message);
+    vfprintf(stderr, message, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void spin(double seconds)
+{
+    double start = now();
+    while (now() - start < seconds)
+        ;
+}
+
+/* the null plugin: it only takes its time, and raises the DP interrupt at the end of the display list like the
+ * real ones do at the full sync */
+static void bench_ProcessDList(void)
+{
+    spin(l_ListTime);
+    l_ListsDone++;
+    *l_GfxInfo.MI_INTR_REG |= 0x20;
+}
+
+static void bench_UpdateScreen(void)
+{
+    spin(l_SwapTime);
+}
+
+static void bench_Nothing(void)
+{
+}
+
+static int bench_RomOpen(void)
+{
+    return 1;
+}
+
+/* returns the time of the run, or a negative number when a DP interrupt came too early */
+static double run(int frames, double cpu, int lists)
+{
+    unsigned int queued = 0, raised = 0, events = 0;
+    double start;
+    int frame, i, early = 0;
+
+    memset(&gfx, 0, sizeof(gfx));
+    gfx.processDList = bench_ProcessDList;
+    gfx.updateScreen = bench_UpdateScreen;
+    gfx.viStatusChanged = bench_Nothing;
+    gfx.viWidthChanged = bench_Nothing;
+    gfx.romClosed = bench_Nothing;
+    gfx.romOpen = bench_RomOpen;
+    l_ListsDone = 0;
+
+    /* what plugin_start_gfx() does */
+    memset(&l_GfxInfo, 0, sizeof(l_GfxInfo));
+    l_GfxInfo.DMEM = (unsigned char *) SP_DMEM;
+    l_GfxInfo.MI_INTR_REG = &MI_register.mi_intr_reg;
+    video_thread_gfx_info(&l_GfxInfo);
+    video_thread_start();
+
+    start = now();
+    for (frame = 0; frame < frames; frame++)
+    {
+        spin(cpu / 2);
+
+        /* what do_SP_Task() does for each display list */
+        for (i = 0; i < lists; i++)
+        {
+            SP_DMEM[0xFC0/4] = 1;
+            SP_DMEM[0xFC4/4] = frame * lists + i;
+            gfx.processDList();
+            queued++;
+            if (video_thread_dlist_queued() || (MI_register.mi_intr_reg & 0x20))
+                events++;
+            MI_register.mi_intr_reg &= ~0x21;
+        }
+
+        spin(cpu / 2);
+
+        /* the game waits for the RDP, the DP_INT events go off every 1000 cycles until the video thread is done */
+        while (events > 0)
+        {
+            if (!video_thread_dp_interrupt())
+            {
+                spin(DP_POLL_US / 1e6);
+                continue;
+            }
+            events--;
+            if (l_ListsDone <= raised)
+                early++;
+            raised++;
+        }
+
+        /* the VI */
+        gfx.updateScreen();
+    }
+    video_thread_sync();
+    start = now() - start;
+
+    video_thread_stop();
+    if (early || raised != queued)
+    {
+        printf("%d of %u DP interrupts raised before their display list was done, %u raised for %u display lists\n",
+               early, raised, raised, queued);
+        return -1;
+    }
+    return start;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 300;
+    double cpu = (argc > 2 ? atof(argv[2]) : 8000) / 1e6;
+    double video = (argc > 3 ? atof(argv[3]) : 8000) / 1e6;
+    int lists = argc > 4 ? atoi(argv[4]) : 2;
+    double times[2];
+
+    if (argc > 5 || frames <= 0 || cpu < 0 || video < 0 || lists <= 0)
+    {
+        fprintf(stderr, "Usage: videothreadbench [frames] [CPU us per frame] [video us per frame] "
+                        "[display lists per frame]\n");
+        return 1;
+    }
+    /* a tenth of the video time goes to the buffer swap */
+    l_ListTime = video * 0.9 / lists;
+    l_SwapTime = video * 0.1;
+
+    for (l_VideoThread = 0; l_VideoThread < 2; l_VideoThread++)
+    {
+        times[l_VideoThread] = run(frames, cpu, lists);
+        if (times[l_VideoThread] < 0)
+            return 1;
+    }
+
+    printf("%d frames, %.0f us CPU and %.0f us video per frame, %d display lists per frame\n",
+           frames, cpu * 1e6, video * 1e6, lists);
+    printf("without the video thread: %8.1f frames/s\n", frames / times[0]);
+    printf("with the video thread:    %8.1f frames/s (%+.0f%%)\n", frames / times[1], (times[0] / times[1] - 1) * 100);
+    return 0;
+}
@@ -57,45 +57,84 @@ public:
 
     void add(Key key, Element ele)
     {
-        int i = find(key);
-        if( i >= 0 )
+        // Binary search for the first key greater than or equal to the new one
+        int lo = 0;
+        int hi = curSize;
+        while( lo < hi )
         {
-            elements[i] = ele;
+            int mid = lo + (hi-lo)/2;
+            if( keys[mid] < key )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if( lo < curSize && keys[lo] == key )
+        {
+            elements[lo] = ele;
             return;
         }
 
         if( curSize == maxSize )
         {
             // Need to increase maxSize
-            Key *oldkeys = keys;
-            Element *oldelements = elements;
-            int oldmaxsize = maxSize;
-            maxSize *= 2;
-
-            keys = new Key[maxSize];
-            elements = new Element[maxSize];
-            std::memcpy(keys,oldkeys,oldmaxsize*sizeof(Key));
-            std::memcpy(elements,oldelements,oldmaxsize*sizeof(Element));
+            reserve(maxSize*2);
         }
 
-        for( i=0; i<curSize; i++ )
+        // Appending in key order (e.g. when loading a sorted index) needs no shifting
+        if( lo < curSize )
         {
-            if( keys[i] > key )
-            {
-                // Found the spot
-                break;
-            }
+            std::memmove(keys+lo+1, keys+lo, (curSize-lo)*sizeof(Key));
+            std::memmove(elements+lo+1, elements+lo, (curSize-lo)*sizeof(Element));
         }
 
-        for( int j=curSize; j>i; j-- )
+        keys[lo] = key;
+        elements[lo] = ele;
+        curSize++;
+    }
+
+    // Adds n elements sorted by key, none of them already in the list, by merging from the back in O(size()+n)
+    void merge(const Key *newkeys, const Element *newelements, int n)
+    {
+        if( curSize + n > maxSize )
+            reserve(curSize + n);
+
+        int i = curSize - 1;
+        int j = n - 1;
+        for( int k = curSize + n - 1; j >= 0; k-- )
         {
-            keys[j] = keys[j-1];
-            elements[j] = elements[j-1];
+            if( i >= 0 && newkeys[j] < keys[i] )
+            {
+                keys[k] = keys[i];
+                elements[k] = elements[i];
+                i--;
+            }
+            else
+            {
+                keys[k] = newkeys[j];
+                elements[k] = newelements[j];
+                j--;
+            }
         }
+        curSize += n;
+    }
 
-        keys[i] = key;
-        elements[i] = ele;
-        curSize++;
+    void reserve(int size)
+    {
+        if( size <= maxSize )
+            return;
+
+        Key *oldkeys = keys;
+        Element *oldelements = elements;
+
+        keys = new Key[size];
+        elements = new Element[size];
+        std::memcpy(keys,oldkeys,curSize*sizeof(Key));
+        std::memcpy(elements,oldelements,curSize*sizeof(Element));
+        maxSize = size;
+
+        delete [] oldkeys;
+        delete [] oldelements;
     }
 
     Element operator[](int index)
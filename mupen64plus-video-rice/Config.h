@@ -218,13 +218,16 @@ typedef struct {
     uint32  textureEnhancement;
     uint32  textureEnhancementControl;
     uint32  textureQuality;
+    uint32  textureCacheSize;
     uint32  anisotropicFiltering;
     uint32  multiSampling;
     BOOL    bTexRectOnly;
     BOOL    bSmallTextureOnly;
+    BOOL    bCacheEnhancedTextures;
     BOOL    bDumpTexturesToFiles;
     BOOL    bLoadHiResTextures;
     BOOL    bLoadHiResCRCOnly;
+    BOOL    bLoadHiResTexturesAsync;
 
     int     OpenglDepthBufferSetting;
     int     OpenglRenderSetting;
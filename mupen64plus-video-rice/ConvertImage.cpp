@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "Config.h"
 #include "ConvertImage.h"
+#include "ConvertImageRows.h"
 #include "RenderBase.h"
 
 ConvertFunction     gConvertFunctions_FullTMEM[ 8 ][ 4 ] = 
@@ -72,56 +73,18 @@ void ConvertRGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    uint32 nFiddle;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y&1) == 0)
-                nFiddle = 0x2;
-            else
-                nFiddle = 0x2 | 0x4;
-
-            // dwDst points to start of destination row
-            uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ nFiddle];
-
-                dwDst[x] = Convert555ToRGBA(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // dwDst points to start of destination row
-            uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x2 | 0x4 : 0x2;
 
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
+        // dwDst points to start of destination row
+        uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ 0x2];
+        // DWordOffset points to the current dword we're looking at
+        // (process 2 pixels at a time). May be a problem if we don't start on even pixel
+        uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                dwDst[x] = Convert555ToRGBA(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
+        ConvertRowRGBA16(pByteSrc, dwWordOffset, nFiddle, dwDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -167,61 +130,15 @@ void ConvertRGBA32(CTexture *pTexture, const TxtrInfo &tinfo)
     }
     else
     {
-        if (tinfo.bSwapped)
+        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
         {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                if ((y%2) == 0)
-                {
-                    uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-                    uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
+            // For odd lines of swapped textures, swap the dwords too
+            uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x8 : 0;
 
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-                        pDst[0] = pS[1];    // Blue
-                        pDst[1] = pS[2];    // Green
-                        pDst[2] = pS[3];    // Red
-                        pDst[3] = pS[0];    // Alpha
-                        pS+=4;
-                        pDst+=4;
-                    }
-                }
-                else
-                {
-                    uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-                    uint8 *pS = (uint8 *)pSrc;
-                    int n;
-
-                    n = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-                        *pDst++ = COLOR_RGBA(pS[(n+3)^0x8],
-                            pS[(n+2)^0x8],
-                            pS[(n+1)^0x8],
-                            pS[(n+0)^0x8]);
-
-                        n += 4;
-                    }
-                }
-            }
-        }
-        else
-        {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-                uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
+            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+            uint32 n = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
 
-                for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                {
-                    pDst[0] = pS[1];    // Blue
-                    pDst[1] = pS[2];    // Green
-                    pDst[2] = pS[3];    // Red
-                    pDst[3] = pS[0];    // Alpha
-                    pS+=4;
-                    pDst+=4;
-                }
-            }
+            ConvertRowRGBA32((uint8 *)pSrc, n, nFiddle, pDst, tinfo.WidthToLoad);
         }
     }
 
@@ -234,7 +151,6 @@ void ConvertRGBA32(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertIA4(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -245,88 +161,21 @@ void ConvertIA4(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
+    // two pixels a byte, an odd width but 1 converts the pixel after the last one too
+    uint32 nWidth = tinfo.WidthToLoad == 1 ? 1 : (tinfo.WidthToLoad+1) & ~1;
+    const uint32 *pTable = GetTexelTable(TEXEL_TABLE_IA4);
 
-
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // Do two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-                // Odd
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = OneToEight[(b & 0x01)     ];
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + (y * dInfo.lPitch);
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
+        // For odd lines, swap words too
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // Do two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                // Even
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-                // Odd
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = OneToEight[(b & 0x01)     ];
-
-                dwByteOffset++;
-            }
-        }
+        // This may not work if X is not even?
+        uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
+
+        ConvertRowTable4(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -338,7 +187,6 @@ void ConvertIA4(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertIA8(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -349,56 +197,19 @@ void ConvertIA8(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
+    const uint32 *pTable = GetTexelTable(TEXEL_TABLE_IA8);
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 I = FourToEight[(b & 0xf0)>>4];
-
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = FourToEight[(b & 0x0f)   ];
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        register const uint8* FourToEightArray = &FourToEight[0];
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
+        // For odd lines, swap words too
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        // Points to current byte
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                register uint8 b = pSrc[(dwByteOffset++) ^ 0x3];
-                uint8 I = *(FourToEightArray+(b>>4));
-
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = *(FourToEightArray+(b&0xF));
-            }
-        }
-    }   
+        ConvertRowTable8(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
+    }
     
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
@@ -409,7 +220,6 @@ void ConvertIA8(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertIA16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint16 * pSrc = (uint16*)(tinfo.pPhysicalAddress);
     uint8 * pByteSrc = (uint8 *)pSrc;
@@ -417,57 +227,18 @@ void ConvertIA16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            if ((y%2) == 0)
-                nFiddle = 0x2;
-            else
-                nFiddle = 0x4 | 0x2;
-
-            // Points to current word
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset^nFiddle];
-
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w & 0xFF);
-
-                dwWordOffset += 2;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // Points to current word
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset^0x2];
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x4 | 0x2 : 0x2;
 
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w & 0xFF);
+        // Points to current word
+        uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                dwWordOffset += 2;
-            }
-        }       
+        ConvertRowIA16(pByteSrc, dwWordOffset, nFiddle, pDst, tinfo.WidthToLoad);
     }
 
-
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
 }
@@ -478,7 +249,6 @@ void ConvertIA16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertI4(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -489,100 +259,32 @@ void ConvertI4(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
+    // two pixels a byte, an odd width but 1 converts the pixel after the last one too
+    uint32 nWidth = tinfo.WidthToLoad == 1 ? 1 : (tinfo.WidthToLoad+1) & ~1;
+    const uint32 *pTable = GetTexelTable(TEXEL_TABLE_I4);
+
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            // Might not work with non-even starting X
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
+        // Might not work with non-even starting X
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
 
-            // For odd lines, swap words too
+        // For odd lines, swap words too
+        uint32 nFiddle = 0x3;
+        if (tinfo.bSwapped)
+        {
             if( !conkerSwapHack || (y&4) == 0 )
-            {
-                if ((y%2) == 0)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
+                nFiddle = (y%2) == 0 ? 0x3 : 0x7;
             else
-            {
-                if ((y%2) == 1)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   // Other implementations seem to or in (b&0xF0)>>4
-                *pDst++ = FourToEight[(b & 0xF0)>>4]; // why?
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-                // Odd
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-
-                dwByteOffset++;
-            }
+                nFiddle = (y%2) == 1 ? 0x3 : 0x7;
         }
 
-        conkerSwapHack = false;
+        ConvertRowTable4(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
-    else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // Might not work with non-even starting X
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
 
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                // Even
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   // Other implementations seem to or in (b&0xF0)>>4
-                *pDst++ = FourToEight[(b & 0xF0)>>4]; // why?
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-                // Odd
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-
-                dwByteOffset++;
-            }
-        }
-    }
+    if (tinfo.bSwapped)
+        conkerSwapHack = false;
 
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
@@ -592,58 +294,25 @@ void ConvertI4(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertI8(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
+    // the bytes are swapped in the address space, not from the start of the texture
     long long pSrc = (long long) tinfo.pPhysicalAddress;
+    uint8 *pBase = (uint8*)(pSrc & ~15LL);
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^nFiddle);
-
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;        // Alpha not 255?
+    const uint32 *pTable = GetTexelTable(TEXEL_TABLE_I8);
 
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^0x3);
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;        // Alpha not 255?
-
-                dwByteOffset++;
-            }
-        }
+        // Alpha not 255?
+        ConvertRowTable8(pBase, (uint32)(pSrc & 15) + dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -685,104 +354,37 @@ void ConvertCI8( CTexture * p_texture, const TxtrInfo & tinfo )
 void ConvertCI4_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
+
+#ifdef DEBUGGER
+    if (((long long) pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
+#endif
+
     uint16 * pPal = (uint16 *)tinfo.PalAddress;
     bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
-    
+
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *pDst |= 0xFF000000;
-                }
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToRGBA(pPal[blo^1]);    // Remember palette is in different endian order!
-
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
+    // Remember palette is in different endian order!
+    uint32 pTable[16];
+    ConvertPaletteRGBA16(pPal, 16, bIgnoreAlpha, pTable);
+    // two pixels a byte, an odd width but 1 converts the pixel after the last one too
+    uint32 nWidth = tinfo.WidthToLoad == 1 ? 1 : (tinfo.WidthToLoad+1) & ~1;
 
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *pDst |= 0xFF000000;
-                }
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToRGBA(pPal[blo^1]);    // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
+        // the swapped lines have always been read from the left of the texture
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.bSwapped ? 0 : (tinfo.LeftToLoad / 2));
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable4(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
+
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
 }
@@ -791,7 +393,6 @@ void ConvertCI4_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI4_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -805,91 +406,23 @@ void ConvertCI4_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                    *pDst |= 0xFF000000;
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToRGBA(pPal[blo^1]);   // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
+    // Remember palette is in different endian order!
+    uint32 pTable[16];
+    ConvertPaletteIA16(pPal, 16, bIgnoreAlpha, pTable);
+    // two pixels a byte, an odd width but 1 converts the pixel after the last one too
+    uint32 nWidth = tinfo.WidthToLoad == 1 ? 1 : (tinfo.WidthToLoad+1) & ~1;
 
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                    *pDst |= 0xFF000000;
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
 
-                pDst[0] = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToRGBA(pPal[blo^1]);   // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
-
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable4(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
+
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
 }
@@ -899,7 +432,6 @@ void ConvertCI4_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI8_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -912,61 +444,24 @@ void ConvertCI8_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
 
     if (!pTexture->StartUpdate(&dInfo))
         return;
-    
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
 
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+    // Remember palette is in different endian order!
+    uint32 pTable[256];
+    ConvertPaletteRGBA16(pPal, 256, bIgnoreAlpha, pTable);
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                *pDst++ = Convert555ToRGBA(pPal[b^1]);  // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            int dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                *pDst++ = Convert555ToRGBA(pPal[b^1]);  // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable8(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
-
 }
 
 
@@ -974,7 +469,6 @@ void ConvertCI8_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI8_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
 
@@ -988,54 +482,19 @@ void ConvertCI8_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
+    // Remember palette is in different endian order!
+    uint32 pTable[256];
+    ConvertPaletteIA16(pPal, 256, bIgnoreAlpha, pTable);
 
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                *pDst++ = ConvertIA16ToRGBA(pPal[b^1]); // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                *pDst++ = ConvertIA16ToRGBA(pPal[b^1]); // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable8(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -1048,7 +507,7 @@ void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    uint32 x, y;
+    uint32 y;
     uint32 nFiddle;
 
     if( options.bUseFullTMEM )
@@ -1068,18 +527,8 @@ void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
             int dwWordOffset = tinfo.tileNo>=0? tile.dwLine*8*y : ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
             uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
 
-            for (x = 0; x < tinfo.WidthToLoad/2; x++)
-            {
-                int y0 = *(uint8*)&pByteSrc[(dwWordOffset+1)^nFiddle];
-                int y1 = *(uint8*)&pByteSrc[(dwWordOffset+3)^nFiddle];
-                int u0 = *(uint8*)&pByteSrc[(dwWordOffset  )^nFiddle];
-                int v0 = *(uint8*)&pByteSrc[(dwWordOffset+2)^nFiddle];
-
-                dwDst[x*2+0] = ConvertYUV16ToR8G8B8(y0,u0,v0);
-                dwDst[x*2+1] = ConvertYUV16ToR8G8B8(y1,u0,v0);
-
-                dwWordOffset += 4;
-            }
+            // U, Y0, V, Y1
+            ConvertRowYUV(pByteSrc, dwWordOffset, nFiddle, false, dwDst, tinfo.WidthToLoad);
         }
     }
     else
@@ -1103,18 +552,8 @@ void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
                 // (process 2 pixels at a time). May be a problem if we don't start on even pixel
                 uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                for (x = 0; x < tinfo.WidthToLoad/2; x++)
-                {
-                    int y0 = *(uint8*)&pByteSrc[(dwWordOffset+2)^nFiddle];
-                    int v0 = *(uint8*)&pByteSrc[(dwWordOffset+1)^nFiddle];
-                    int y1 = *(uint8*)&pByteSrc[(dwWordOffset  )^nFiddle];
-                    int u0 = *(uint8*)&pByteSrc[(dwWordOffset+3)^nFiddle];
-
-                    dwDst[x*2+0] = ConvertYUV16ToR8G8B8(y0,u0,v0);
-                    dwDst[x*2+1] = ConvertYUV16ToR8G8B8(y1,u0,v0);
-
-                    dwWordOffset += 4;
-                }
+                // Y1, V, Y0, U
+                ConvertRowYUV(pByteSrc, dwWordOffset, nFiddle, true, dwDst, tinfo.WidthToLoad);
             }
         }
         else
@@ -1125,19 +564,7 @@ void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
                 uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
                 uint32 dwByteOffset = y * 32;
 
-                for (x = 0; x < tinfo.WidthToLoad/2; x++)
-                {
-                    int y0 = *(uint8*)&pByteSrc[(dwByteOffset+2)];
-                    int v0 = *(uint8*)&pByteSrc[(dwByteOffset+1)];
-                    int y1 = *(uint8*)&pByteSrc[(dwByteOffset  )];
-                    int u0 = *(uint8*)&pByteSrc[(dwByteOffset+3)];
-
-                    dwDst[x*2+0] = ConvertYUV16ToR8G8B8(y0,u0,v0);
-                    dwDst[x*2+1] = ConvertYUV16ToR8G8B8(y1,u0,v0);
-
-                    // Increment word offset to point to the next two pixels
-                    dwByteOffset += 4;
-                }
+                ConvertRowYUV(pByteSrc, dwByteOffset, 0, true, dwDst, tinfo.WidthToLoad);
             }
         }
     }
@@ -1146,27 +573,6 @@ void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
     pTexture->SetOthersVariables();
 }
 
-uint32 ConvertYUV16ToR8G8B8(int Y, int U, int V)
-{
-    /*
-    int R = int(g_convc0 *(Y-16) + g_convc1 * V);
-    int G = int(g_convc0 *(Y-16) + g_convc2 * U - g_convc3 * V);
-    int B = int(g_convc0 *(Y-16) + g_convc4 * U);
-    */
-
-    Y += 80;
-    int R = int(Y + (1.370705f * (V-128)));
-    int G = int(Y - (0.698001f * (V-128)) - (0.337633f * (U-128)));
-    int B = int(Y + (1.732446f * (U-128)));
-
-    R = R < 0 ? 0 : (R>255 ? 255 : R);
-    G = G < 0 ? 0 : (G>255 ? 255 : G);
-    B = B < 0 ? 0 : (B>255 ? 255 : B);
-
-    return COLOR_RGBA(R, G, B, 0xFF);
-}
-
-
 // Used by Starfox intro
 void Convert4b(CTexture *pTexture, const TxtrInfo &tinfo)
 {
@@ -239,8 +239,37 @@ inline uint16 ConvertIA16ToR4G4B4A4(uint16 wIA)
 extern int g_convk0,g_convk1,g_convk2,g_convk3,g_convk4,g_convk5;
 extern float g_convc0,g_convc1,g_convc2,g_convc3,g_convc4,g_convc5;
 
-uint32 ConvertYUV16ToR8G8B8(int Y, int U, int V);
-uint16 ConvertYUV16ToR4G4B4(int Y, int U, int V);
+inline uint32 ConvertYUV16ToR8G8B8(int Y, int U, int V)
+{
+    /*
+    int R = int(g_convc0 *(Y-16) + g_convc1 * V);
+    int G = int(g_convc0 *(Y-16) + g_convc2 * U - g_convc3 * V);
+    int B = int(g_convc0 *(Y-16) + g_convc4 * U);
+    */
+
+    Y += 80;
+    int R = int(Y + (1.370705f * (V-128)));
+    int G = int(Y - (0.698001f * (V-128)) - (0.337633f * (U-128)));
+    int B = int(Y + (1.732446f * (U-128)));
+
+    R = R < 0 ? 0 : (R>255 ? 255 : R);
+    G = G < 0 ? 0 : (G>255 ? 255 : G);
+    B = B < 0 ? 0 : (B>255 ? 255 : B);
+
+    return COLOR_RGBA(R, G, B, 0xFF);
+}
+
+inline uint16 ConvertYUV16ToR4G4B4(int Y, int U, int V)
+{
+    uint32 A=1;
+    uint32 R1 = Y + g_convk0 * V;
+    uint32 G1 = Y + g_convk1 * U + g_convk2 * V;
+    uint32 B1 = Y + g_convk3 * U;
+    uint32 R = (R1 - g_convk4) * g_convk5 + R1;
+    uint32 G = (G1 - g_convk4) * g_convk5 + G1;
+    uint32 B = (B1 - g_convk4) * g_convk5 + B1;
+    return (uint16)R4G4B4A4_MAKE((R>>4), (G>>4), (B>>4), 0xF*A);
+}
 
 
 typedef void    ( * ConvertFunction )( CTexture * p_texture, const TxtrInfo & ti );
@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "Config.h"
 #include "ConvertImage.h"
+#include "ConvertImageRows.h"
 #include "RenderBase.h"
 
 // Still to be swapped:
@@ -67,8 +68,7 @@ extern bool conkerSwapHack;
 void ConvertRGBA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 x, y;
-    uint32 nFiddle;
+    uint32 y;
 
     // Copy of the base pointer
     uint16 * pSrc = (uint16*)(tinfo.pPhysicalAddress);
@@ -77,54 +77,18 @@ void ConvertRGBA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
+    for (y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x2;
-            else
-                nFiddle = 0x2 | 0x4;
-
-            // dwDst points to start of destination row
-            uint16 * wDst = (uint16 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ nFiddle];
-
-                wDst[x] = Convert555ToR4G4B4A4(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
-    }
-    else
-    {
-        for (y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // dwDst points to start of destination row
-            uint16 * wDst = (uint16 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x2 | 0x4 : 0x2;
 
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
+        // dwDst points to start of destination row
+        uint16 * wDst = (uint16 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
 
-            for (x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ 0x2];
+        // DWordOffset points to the current dword we're looking at
+        // (process 2 pixels at a time). May be a problem if we don't start on even pixel
+        uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                wDst[x] = Convert555ToR4G4B4A4(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
+        ConvertRowRGBA16_16(pByteSrc, dwWordOffset, nFiddle, wDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -165,60 +129,15 @@ void ConvertRGBA32_16(CTexture *pTexture, const TxtrInfo &tinfo)
     }
     else
     {
-        if (tinfo.bSwapped)
+        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
         {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                if ((y%2) == 0)
-                {
-                    uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-                    uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-
-                        *pDst++ = R4G4B4A4_MAKE((pS[3]>>4),  // Red
-                                                (pS[2]>>4),  // Green
-                                                (pS[1]>>4),  // Blue
-                                                (pS[0]>>4)); // Alpha
-                        pS+=4;
-                    }
-                }
-                else
-                {
-                    uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-                    uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-                    int n;
-
-                    n = 0;
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-                        *pDst++ = R4G4B4A4_MAKE((pS[(n^0x8) + 3]>>4),   // Red
-                                                (pS[(n^0x8) + 2]>>4),   // Green
-                                                (pS[(n^0x8) + 1]>>4),   // Blue
-                                                (pS[(n^0x8) + 0]>>4));  // Alpha
+            // For odd lines of swapped textures, swap the dwords too
+            uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x8 : 0;
 
-                        n += 4;
-                    }
-                }
-            }
-        }
-        else
-        {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-                uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
+            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+            uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
 
-                for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                {
-                    *pDst++ = R4G4B4A4_MAKE((pS[3]>>4),     // Red
-                                            (pS[2]>>4),     // Green
-                                            (pS[1]>>4),     // Blue
-                                            (pS[0]>>4));    // Alpha
-                    pS+=4;
-                }
-            }
+            ConvertRowRGBA32_16(pS, 0, nFiddle, pDst, tinfo.WidthToLoad);
         }
     }
 
@@ -232,78 +151,26 @@ void ConvertRGBA32_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertIA4_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+    // Do two pixels at a time
+    uint32 nWidth = (tinfo.WidthToLoad+1) & ~1;
+    const uint16 *pTable = GetTexelTable_16(TEXEL_TABLE_IA4);
 
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
-
-            // Do two pixels at a time
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                *pDst++ = R4G4B4A4_MAKE(ThreeToFour[(b & 0xE0) >> 5],
-                                        ThreeToFour[(b & 0xE0) >> 5],
-                                        ThreeToFour[(b & 0xE0) >> 5],
-                                        OneToFour[(b & 0x10) >> 4]);
-    
-                // Odd
-                *pDst++ = R4G4B4A4_MAKE(ThreeToFour[(b & 0x0E) >> 1],
-                                        ThreeToFour[(b & 0x0E) >> 1],
-                                        ThreeToFour[(b & 0x0E) >> 1],
-                                        OneToFour[(b & 0x01)]     );
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
+        // For odd lines, swap words too
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            // Do two pixels at a time
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        // This may not work if X is not even?
+        uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
 
-                // Even
-                *pDst++ = R4G4B4A4_MAKE(ThreeToFour[(b & 0xE0) >> 5],
-                                        ThreeToFour[(b & 0xE0) >> 5],
-                                        ThreeToFour[(b & 0xE0) >> 5],
-                                        OneToFour[(b & 0x10) >> 4]);
-    
-                // Odd
-                *pDst++ = R4G4B4A4_MAKE(ThreeToFour[(b & 0x0E) >> 1],
-                                        ThreeToFour[(b & 0x0E) >> 1],
-                                        ThreeToFour[(b & 0x0E) >> 1],
-                                        OneToFour[(b & 0x01)]     );
-
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable4_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
     
     pTexture->EndUpdate(&dInfo);
@@ -314,55 +181,23 @@ void ConvertIA4_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertIA8_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
+    const uint16 *pTable = GetTexelTable_16(TEXEL_TABLE_IA8);
 
-            uint16 *pDst = (uint16 *)((uint8*)dInfo.lpSurface + y * dInfo.lPitch);
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                *pDst++ = R4G4B4A4_MAKE( ((b&0xf0)>>4),((b&0xf0)>>4),((b&0xf0)>>4),(b&0x0f));
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        // For odd lines, swap words too
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
+        uint16 *pDst = (uint16 *)((uint8*)dInfo.lpSurface + y * dInfo.lPitch);
+        // Points to current byte
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                *pDst++ = R4G4B4A4_MAKE(((b&0xf0)>>4),((b&0xf0)>>4),((b&0xf0)>>4),(b&0x0f));
-
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable8_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
     
     pTexture->EndUpdate(&dInfo);
@@ -388,17 +223,7 @@ void ConvertIA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
         // Points to current word
         uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-        for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-        {
-            uint16 w = *(uint16 *)&pByteSrc[dwWordOffset^0x2];
-
-            uint8 i = (uint8)(w >> 12);
-            uint8 a = (uint8)(w & 0xFF);
-
-            *pDst++ = R4G4B4A4_MAKE(i, i, i, (a>>4));
-
-            dwWordOffset += 2;
-        }
+        ConvertRowIA16_16(pByteSrc, dwWordOffset, 0x2, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -419,6 +244,10 @@ void ConvertI4_16(CTexture *pTexture, const TxtrInfo &tinfo)
 
     if (tinfo.bSwapped)
     {
+        // two pixels at a time
+        uint32 nWidth = (tinfo.WidthToLoad+1) & ~1;
+        const uint16 *pTable = GetTexelTable_16(TEXEL_TABLE_I4);
+
         for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
         {
             uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
@@ -428,33 +257,11 @@ void ConvertI4_16(CTexture *pTexture, const TxtrInfo &tinfo)
 
             // For odd lines, swap words too
             if( !conkerSwapHack || (y&4) == 0 )
-            {
-                if ((y%2) == 0)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
+                nFiddle = (y%2) == 0 ? 0x3 : 0x7;
             else
-            {
-                if ((y%2) == 1)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                //*pDst++ = R4G4B4A4_MAKE(b>>4, b>>4, b>>4, b>>4);
-                *pDst++ = FourToSixteen[(b & 0xF0)>>4];
-                // Odd
-                //*pDst++ = R4G4B4A4_MAKE(b & 0x0f, b & 0x0f, b & 0x0f, b & 0x0f);
-                *pDst++ = FourToSixteen[b & 0x0f];
+                nFiddle = (y%2) == 1 ? 0x3 : 0x7;
 
-                dwByteOffset++;
-            }
+            ConvertRowTable4_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
         }
     }
     else
@@ -491,60 +298,26 @@ void ConvertI4_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertI8_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
+    // the bytes are swapped in the address space, not from the start of the texture
     long long pSrc = (long long) (tinfo.pPhysicalAddress);
+    uint8 *pBase = (uint8*)(pSrc & ~15LL);
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
+    const uint16 *pTable = GetTexelTable_16(TEXEL_TABLE_I8);
 
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^nFiddle);
-
-                *pDst++ = R4G4B4A4_MAKE(b>>4,
-                                        b>>4,
-                                        b>>4,
-                                        b>>4);
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^0x3);
-
-                *pDst++ = R4G4B4A4_MAKE(b>>4,
-                                        b>>4,
-                                        b>>4,
-                                        b>>4);
+        uint16 *pDst = (uint16*)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                dwByteOffset++;
-            }
-        }
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
+        ConvertRowTable8_16(pBase, (uint32)(pSrc & 15) + dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
+
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
 
@@ -555,66 +328,28 @@ void ConvertI8_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI4_RGBA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     uint16 * pPal = (uint16 *)tinfo.PalAddress;
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-
-            uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
+    // Remember palette is in different endian order!
+    uint16 pTable[16];
+    ConvertPaletteRGBA16_16(pPal, 16, pTable);
 
-                pDst[0] = Convert555ToR4G4B4A4(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToR4G4B4A4(pPal[blo^1]);    // Remember palette is in different endian order!
-                pDst+=2;
+    // two pixels at a time
+    uint32 nWidth = (tinfo.WidthToLoad+1) & ~1;
 
-                dwByteOffset++;
-            }
-        }   
-        
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
+        uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                pDst[0] = Convert555ToR4G4B4A4(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToR4G4B4A4(pPal[blo^1]);    // Remember palette is in different endian order!
-                pDst+=2;
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable4_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -655,62 +390,28 @@ void ConvertCI8_16( CTexture * p_texture, const TxtrInfo & tinfo )
 void ConvertCI4_IA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     uint16 * pPal = (uint16 *)tinfo.PalAddress;
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
+    // Remember palette is in different endian order!
+    uint16 pTable[16];
+    ConvertPaletteIA16_16(pPal, 16, pTable);
 
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
+    // two pixels at a time
+    uint32 nWidth = (tinfo.WidthToLoad+1) & ~1;
 
-                pDst[0] = ConvertIA16ToR4G4B4A4(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToR4G4B4A4(pPal[blo^1]);   // Remember palette is in different endian order!
-                pDst += 2;
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
+        uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                pDst[0] = ConvertIA16ToR4G4B4A4(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToR4G4B4A4(pPal[blo^1]);   // Remember palette is in different endian order!
-                pDst+=2;
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable4_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, nWidth);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -722,53 +423,25 @@ void ConvertCI4_IA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI8_RGBA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     uint16 * pPal = (uint16 *)tinfo.PalAddress;
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint16 *pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
+    // Remember palette is in different endian order!
+    uint16 pTable[256];
+    ConvertPaletteRGBA16_16(pPal, 256, pTable);
 
-                *pDst++ = Convert555ToR4G4B4A4(pPal[b^1]);  // Remember palette is in different endian order!
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                *pDst++ = Convert555ToR4G4B4A4(pPal[b^1]);  // Remember palette is in different endian order!
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable8_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -780,53 +453,25 @@ void ConvertCI8_RGBA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 void ConvertCI8_IA16_16(CTexture *pTexture, const TxtrInfo &tinfo)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
 
     uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
     uint16 * pPal = (uint16 *)tinfo.PalAddress;
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
+    // Remember palette is in different endian order!
+    uint16 pTable[256];
+    ConvertPaletteIA16_16(pPal, 256, pTable);
 
-            uint16 *pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                *pDst++ = ConvertIA16ToR4G4B4A4(pPal[b^1]); // Remember palette is in different endian order!
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint16 *pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        uint32 nFiddle = (tinfo.bSwapped && (y&1)) ? 0x7 : 0x3;
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+        uint16 * pDst = (uint16 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
 
-                *pDst++ = ConvertIA16ToR4G4B4A4(pPal[b^1]); // Remember palette is in different endian order!
+        uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
 
-                dwByteOffset++;
-            }
-        }
+        ConvertRowTable8_16(pSrc, dwByteOffset, nFiddle, pTable, pDst, tinfo.WidthToLoad);
     }
 
     pTexture->EndUpdate(&dInfo);
@@ -840,7 +485,7 @@ void ConvertYUV_16(CTexture *pTexture, const TxtrInfo &tinfo)
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    uint32 x, y;
+    uint32 y;
     uint32 nFiddle;
 
     if( options.bUseFullTMEM )
@@ -860,18 +505,8 @@ void ConvertYUV_16(CTexture *pTexture, const TxtrInfo &tinfo)
             int dwWordOffset = tinfo.tileNo>=0? tile.dwLine*8*y : ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
             uint16 * wDst = (uint16 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
 
-            for (x = 0; x < tinfo.WidthToLoad/2; x++)
-            {
-                int y0 = *(uint8*)&pByteSrc[(dwWordOffset+1)^nFiddle];
-                int y1 = *(uint8*)&pByteSrc[(dwWordOffset+3)^nFiddle];
-                int u0 = *(uint8*)&pByteSrc[(dwWordOffset  )^nFiddle];
-                int v0 = *(uint8*)&pByteSrc[(dwWordOffset+2)^nFiddle];
-
-                wDst[x*2+0] = ConvertYUV16ToR4G4B4(y0,u0,v0);
-                wDst[x*2+1] = ConvertYUV16ToR4G4B4(y1,u0,v0);
-
-                dwWordOffset += 4;
-            }
+            // U, Y0, V, Y1
+            ConvertRowYUV_16(pByteSrc, dwWordOffset, nFiddle, false, wDst, tinfo.WidthToLoad);
         }
     }
     else
@@ -897,18 +532,7 @@ void ConvertYUV_16(CTexture *pTexture, const TxtrInfo &tinfo)
                 // (process 2 pixels at a time). May be a problem if we don't start on even pixel
                 uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                for (x = 0; x < tinfo.WidthToLoad/2; x++)
-                {
-                    uint32 y0 = *(uint8*)&pByteSrc[(dwWordOffset+1)^nFiddle];
-                    uint32 y1 = *(uint8*)&pByteSrc[(dwWordOffset+3)^nFiddle];
-                    uint32 u0 = *(uint8*)&pByteSrc[(dwWordOffset  )^nFiddle];
-                    uint32 v0 = *(uint8*)&pByteSrc[(dwWordOffset+2)^nFiddle];
-
-                    wDst[x*2+0] = ConvertYUV16ToR4G4B4(y0,u0,v0);
-                    wDst[x*2+1] = ConvertYUV16ToR4G4B4(y1,u0,v0);
-
-                    dwWordOffset += 4;
-                }
+                ConvertRowYUV_16(pByteSrc, dwWordOffset, nFiddle, false, wDst, tinfo.WidthToLoad);
             }
         }
         else
@@ -922,18 +546,7 @@ void ConvertYUV_16(CTexture *pTexture, const TxtrInfo &tinfo)
                 // (process 2 pixels at a time). May be a problem if we don't start on even pixel
                 uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
 
-                for (x = 0; x < tinfo.WidthToLoad/2; x++)
-                {
-                    uint32 y0 = *(uint8*)&pByteSrc[(dwWordOffset+1)^3];
-                    uint32 y1 = *(uint8*)&pByteSrc[(dwWordOffset+3)^3];
-                    uint32 u0 = *(uint8*)&pByteSrc[(dwWordOffset  )^3];
-                    uint32 v0 = *(uint8*)&pByteSrc[(dwWordOffset+2)^3];
-
-                    wDst[x*2+0] = ConvertYUV16ToR4G4B4(y0,u0,v0);
-                    wDst[x*2+1] = ConvertYUV16ToR4G4B4(y1,u0,v0);
-
-                    dwWordOffset += 4;
-                }
+                ConvertRowYUV_16(pByteSrc, dwWordOffset, 0x3, false, wDst, tinfo.WidthToLoad);
             }
         }
     }
@@ -942,18 +555,6 @@ void ConvertYUV_16(CTexture *pTexture, const TxtrInfo &tinfo)
     pTexture->SetOthersVariables();
 }
 
-uint16 ConvertYUV16ToR4G4B4(int Y, int U, int V)
-{
-    uint32 A=1;
-    uint32 R1 = Y + g_convk0 * V;
-    uint32 G1 = Y + g_convk1 * U + g_convk2 * V;
-    uint32 B1 = Y + g_convk3 * U;
-    uint32 R = (R1 - g_convk4) * g_convk5 + R1;
-    uint32 G = (G1 - g_convk4) * g_convk5 + G1;
-    uint32 B = (B1 - g_convk4) * g_convk5 + B1;
-    return (uint16)R4G4B4A4_MAKE((R>>4), (G>>4), (B>>4), 0xF*A);
-}
-
 
 // Used by Starfox intro
 void Convert4b_16(CTexture *pTexture, const TxtrInfo &tinfo)
@@ -0,0 +1,1116 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && !defined(NO_ASM)
+// the SSE2 and SSSE3 kernels are built for those with the target attribute, whatever the rest of the plugin is built
+// for, and only called when cpuid says the CPU has them
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#define CONVERT_SSE2
+#define CONVERT_SSE2_FUNC   __attribute__((target("sse2")))
+#define CONVERT_SSSE3_FUNC  __attribute__((target("ssse3")))
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CONVERT_NEON
+#endif
+
+#include "ConvertImage.h"
+#include "ConvertImageRows.h"
+
+#define CONVERT_CHUNK   1024    // bytes of a row put in order at a time
+
+// bytes to count texels, in the byte order of the texture
+typedef void (*ConvertTexels)(const uint8 *bytes, void *dst, uint32 count);
+
+// 16 byte blocks, each byte moved to its index xor fiddle
+typedef void (*UnswizzleBlocks)(const uint8 *src, uint32 fiddle, uint8 *dst, uint32 blocks);
+
+// pairs of YUV texels
+typedef void (*ConvertTexelsYUV)(const uint8 *bytes, bool bReversed, void *dst, uint32 pairs);
+
+// count 4b texels through a 16 entry table
+typedef void (*ConvertTexels4)(const uint8 *bytes, const void *table, void *dst, uint32 count);
+
+/****
+ Scalar kernels, which the SIMD ones finish their rows with
+****/
+static void UnswizzleBlocks_C(const uint8 *src, uint32 fiddle, uint8 *dst, uint32 blocks)
+{
+    for( uint32 i=0; i<blocks*16; i++ )
+        dst[i] = src[i^fiddle];
+}
+
+static void ConvertTexelsRGBA16_C(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint32 *dst = (uint32*)pDst;
+    for( uint32 x=0; x<count; x++ )
+        dst[x] = Convert555ToRGBA(w[x]);
+}
+
+static void ConvertTexelsRGBA16_C_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    for( uint32 x=0; x<count; x++ )
+        dst[x] = Convert555ToR4G4B4A4(w[x]);
+}
+
+static void ConvertTexelsIA16_C(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint32 *dst = (uint32*)pDst;
+    for( uint32 x=0; x<count; x++ )
+        dst[x] = ConvertIA16ToRGBA(w[x]);
+}
+
+static void ConvertTexelsIA16_C_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    for( uint32 x=0; x<count; x++ )
+        dst[x] = ConvertIA16ToR4G4B4A4(w[x]);
+}
+
+// 32b texels, in memory R, G, B, A
+static void ConvertTexelsRGBA32_C(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint32 *dst = (uint32*)pDst;
+    for( uint32 x=0; x<count; x++ )
+    {
+        const uint8 *pS = bytes+x*4;
+        dst[x] = COLOR_RGBA(pS[3], pS[2], pS[1], pS[0]);
+    }
+}
+
+static void ConvertTexelsRGBA32_C_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint16 *dst = (uint16*)pDst;
+    for( uint32 x=0; x<count; x++ )
+    {
+        const uint8 *pS = bytes+x*4;
+        dst[x] = R4G4B4A4_MAKE((pS[3]>>4), (pS[2]>>4), (pS[1]>>4), (pS[0]>>4));
+    }
+}
+
+// 2 texels from 4 bytes U, Y0, V, Y1, or Y1, V, Y0, U when reversed
+static void ConvertTexelsYUV_C(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    uint32 *dst = (uint32*)pDst;
+    for( uint32 x=0; x<pairs; x++ )
+    {
+        const uint8 *p = bytes+x*4;
+        int u = p[bReversed ? 3 : 0], y0 = p[bReversed ? 2 : 1], v = p[bReversed ? 1 : 2], y1 = p[bReversed ? 0 : 3];
+        dst[x*2+0] = ConvertYUV16ToR8G8B8(y0, u, v);
+        dst[x*2+1] = ConvertYUV16ToR8G8B8(y1, u, v);
+    }
+}
+
+static void ConvertTexelsYUV_C_16(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    uint16 *dst = (uint16*)pDst;
+    for( uint32 x=0; x<pairs; x++ )
+    {
+        const uint8 *p = bytes+x*4;
+        int u = p[bReversed ? 3 : 0], y0 = p[bReversed ? 2 : 1], v = p[bReversed ? 1 : 2], y1 = p[bReversed ? 0 : 3];
+        dst[x*2+0] = ConvertYUV16ToR4G4B4(y0, u, v);
+        dst[x*2+1] = ConvertYUV16ToR4G4B4(y1, u, v);
+    }
+}
+
+// the high nibble of a byte first
+static void ConvertTexels4_C(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    const uint32 *table = (const uint32*)pTable;
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+2 <= count; x+=2 )
+    {
+        uint8 b = bytes[x/2];
+        dst[x] = table[b>>4];
+        dst[x+1] = table[b&0x0F];
+    }
+    if( x < count )
+        dst[x] = table[bytes[x/2]>>4];
+}
+
+static void ConvertTexels4_C_16(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    const uint16 *table = (const uint16*)pTable;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+    for( ; x+2 <= count; x+=2 )
+    {
+        uint8 b = bytes[x/2];
+        dst[x] = table[b>>4];
+        dst[x+1] = table[b&0x0F];
+    }
+    if( x < count )
+        dst[x] = table[bytes[x/2]>>4];
+}
+
+
+#if defined(CONVERT_SSE2)
+/****
+ SSE2 kernels
+****/
+// the 16 bytes at an index multiple of 16, each moved to its index xor fiddle
+static CONVERT_SSE2_FUNC inline __m128i UnswizzleBlock(__m128i x, uint32 fiddle)
+{
+    if( fiddle & 1 )
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    if( fiddle & 2 )
+    {
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2,3,0,1));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2,3,0,1));
+    }
+    if( fiddle & 4 )
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(2,3,0,1));
+    if( fiddle & 8 )
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(1,0,3,2));
+    return x;
+}
+
+static CONVERT_SSE2_FUNC void UnswizzleBlocks_SSE2(const uint8 *src, uint32 fiddle, uint8 *dst, uint32 blocks)
+{
+    for( uint32 i=0; i<blocks*16; i+=16 )
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+        _mm_storeu_si128((__m128i*)(dst+i), UnswizzleBlock(x, fiddle));
+    }
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsRGBA16_SSE2(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask8 = _mm_set1_epi16(0xFF);
+    const __m128i one = _mm_set1_epi16(1);
+    for( ; x+8 <= count; x+=8 )
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(w+x));
+        __m128i r = _mm_and_si128(_mm_srli_epi16(p, 11), mask5);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(p, 6), mask5);
+        __m128i b = _mm_and_si128(_mm_srli_epi16(p, 1), mask5);
+        __m128i a = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(p, one)), mask8);
+
+        // FiveToEight
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+        __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+        __m128i ra = _mm_or_si128(r, _mm_slli_epi16(a, 8));
+        _mm_storeu_si128((__m128i*)(dst+x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i*)(dst+x+4), _mm_unpackhi_epi16(bg, ra));
+    }
+    ConvertTexelsRGBA16_C(bytes+x*2, dst+x, count-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsRGBA16_SSE2_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    const __m128i maskR = _mm_set1_epi16(0x0F00);
+    const __m128i maskG = _mm_set1_epi16(0x00F0);
+    const __m128i maskB = _mm_set1_epi16(0x000F);
+    const __m128i maskA = _mm_set1_epi16((short)0xF000);
+    const __m128i one = _mm_set1_epi16(1);
+    for( ; x+8 <= count; x+=8 )
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(w+x));
+        __m128i c = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(p, 4), maskR),
+                                 _mm_or_si128(_mm_and_si128(_mm_srli_epi16(p, 3), maskG),
+                                              _mm_and_si128(_mm_srli_epi16(p, 2), maskB)));
+        c = _mm_or_si128(c, _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(p, one)), maskA));
+        _mm_storeu_si128((__m128i*)(dst+x), c);
+    }
+    ConvertTexelsRGBA16_C_16(bytes+x*2, dst+x, count-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsIA16_SSE2(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+
+    const __m128i maskHi = _mm_set1_epi16((short)0xFF00);
+    for( ; x+8 <= count; x+=8 )
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(w+x));
+        __m128i i = _mm_srli_epi16(p, 8);
+        __m128i ii = _mm_or_si128(i, _mm_and_si128(p, maskHi));
+        __m128i ia = _mm_or_si128(i, _mm_slli_epi16(p, 8));
+        _mm_storeu_si128((__m128i*)(dst+x), _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128((__m128i*)(dst+x+4), _mm_unpackhi_epi16(ii, ia));
+    }
+    ConvertTexelsIA16_C(bytes+x*2, dst+x, count-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsIA16_SSE2_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    const __m128i maskA = _mm_set1_epi16((short)0xF000);
+    const __m128i maskI = _mm_set1_epi16(0x000F);
+    const __m128i mul = _mm_set1_epi16(0x0111);
+    for( ; x+8 <= count; x+=8 )
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(w+x));
+        __m128i i = _mm_and_si128(_mm_srli_epi16(p, 12), maskI);
+        __m128i c = _mm_or_si128(_mm_mullo_epi16(i, mul), _mm_and_si128(_mm_slli_epi16(p, 8), maskA));
+        _mm_storeu_si128((__m128i*)(dst+x), c);
+    }
+    ConvertTexelsIA16_C_16(bytes+x*2, dst+x, count-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsRGBA32_SSE2(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= count; x+=4 )
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(bytes+x*4));
+        _mm_storeu_si128((__m128i*)(dst+x), _mm_or_si128(_mm_srli_epi32(p, 8), _mm_slli_epi32(p, 24)));
+    }
+    ConvertTexelsRGBA32_C(bytes+x*4, dst+x, count-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsRGBA32_SSE2_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    const __m128i maskR = _mm_set1_epi32(0x0F00);
+    const __m128i maskG = _mm_set1_epi32(0x00F0);
+    const __m128i maskB = _mm_set1_epi32(0x000F);
+    const __m128i maskA = _mm_set1_epi32(0xF000);
+    for( ; x+8 <= count; x+=8 )
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(bytes+x*4));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(bytes+x*4+16));
+        __m128i c0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 20), maskR),
+                                               _mm_and_si128(_mm_srli_epi32(p0, 16), maskG)),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 12), maskB),
+                                               _mm_and_si128(_mm_slli_epi32(p0, 8), maskA)));
+        __m128i c1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 20), maskR),
+                                               _mm_and_si128(_mm_srli_epi32(p1, 16), maskG)),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 12), maskB),
+                                               _mm_and_si128(_mm_slli_epi32(p1, 8), maskA)));
+        // sign extended, so that the signed saturation of the pack keeps the 16 bits as they are
+        c0 = _mm_srai_epi32(_mm_slli_epi32(c0, 16), 16);
+        c1 = _mm_srai_epi32(_mm_slli_epi32(c1, 16), 16);
+        _mm_storeu_si128((__m128i*)(dst+x), _mm_packs_epi32(c0, c1));
+    }
+    ConvertTexelsRGBA32_C_16(bytes+x*4, dst+x, count-x);
+}
+
+// Y, U and V of the 8 texels of 4 pairs, as 16b words
+static CONVERT_SSE2_FUNC inline void SplitYUV(__m128i q, bool bReversed, __m128i &y, __m128i &u, __m128i &v)
+{
+    __m128i lo = _mm_and_si128(q, _mm_set1_epi16(0xFF));
+    __m128i hi = _mm_srli_epi16(q, 8);
+    if( bReversed )
+    {
+        // words Y1 | V<<8, Y0 | U<<8
+        y = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(2,3,0,1)), _MM_SHUFFLE(2,3,0,1));
+        u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3,3,1,1)), _MM_SHUFFLE(3,3,1,1));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(2,2,0,0)), _MM_SHUFFLE(2,2,0,0));
+    }
+    else
+    {
+        // words U | Y0<<8, V | Y1<<8
+        y = hi;
+        u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(2,2,0,0)), _MM_SHUFFLE(2,2,0,0));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3,3,1,1)), _MM_SHUFFLE(3,3,1,1));
+    }
+}
+
+// ConvertYUV16ToR8G8B8 of 4 texels, the same float operations in the same order. The packs clamp the results to
+// 0-255 and leave the bytes B0-3, R0-3, G0-3, A0-3
+static CONVERT_SSE2_FUNC inline __m128i YUVToPlanarBRGA(__m128i y, __m128i u, __m128i v)
+{
+    __m128 Y = _mm_cvtepi32_ps(_mm_add_epi32(y, _mm_set1_epi32(80)));
+    __m128 U = _mm_cvtepi32_ps(_mm_sub_epi32(u, _mm_set1_epi32(128)));
+    __m128 V = _mm_cvtepi32_ps(_mm_sub_epi32(v, _mm_set1_epi32(128)));
+    __m128i R = _mm_cvttps_epi32(_mm_add_ps(Y, _mm_mul_ps(_mm_set1_ps(1.370705f), V)));
+    __m128i G = _mm_cvttps_epi32(_mm_sub_ps(_mm_sub_ps(Y, _mm_mul_ps(_mm_set1_ps(0.698001f), V)),
+                                            _mm_mul_ps(_mm_set1_ps(0.337633f), U)));
+    __m128i B = _mm_cvttps_epi32(_mm_add_ps(Y, _mm_mul_ps(_mm_set1_ps(1.732446f), U)));
+    return _mm_packus_epi16(_mm_packs_epi32(B, R), _mm_packs_epi32(G, _mm_set1_epi32(0xFF)));
+}
+
+// the low 32 bits of each product
+static CONVERT_SSE2_FUNC inline __m128i MulLo32(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+}
+
+// ConvertYUV16ToR4G4B4 of 4 texels from Y and U | V<<16, the same 32b arithmetic, pmaddwd doing k*U + k'*V. The
+// texels are sign extended from 16b, so that _mm_packs_epi32 keeps them as they are
+static CONVERT_SSE2_FUNC inline __m128i YUVToR4G4B4(__m128i y, __m128i uv)
+{
+    const __m128i k4 = _mm_set1_epi32(g_convk4);
+    const __m128i k5 = _mm_set1_epi32(g_convk5);
+    __m128i R1 = _mm_add_epi32(y, _mm_madd_epi16(uv, _mm_set1_epi32((uint32)(uint16)g_convk0 << 16)));
+    __m128i G1 = _mm_add_epi32(y, _mm_madd_epi16(uv, _mm_set1_epi32((uint16)g_convk1 | ((uint32)(uint16)g_convk2 << 16))));
+    __m128i B1 = _mm_add_epi32(y, _mm_madd_epi16(uv, _mm_set1_epi32((uint16)g_convk3)));
+    __m128i R = _mm_add_epi32(MulLo32(_mm_sub_epi32(R1, k4), k5), R1);
+    __m128i G = _mm_add_epi32(MulLo32(_mm_sub_epi32(G1, k4), k5), G1);
+    __m128i B = _mm_add_epi32(MulLo32(_mm_sub_epi32(B1, k4), k5), B1);
+    __m128i c = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(R, 4), 8), _mm_slli_epi32(_mm_srli_epi32(G, 4), 4)),
+                             _mm_or_si128(_mm_srli_epi32(B, 4), _mm_set1_epi32(0xF000)));
+    return _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
+}
+
+static CONVERT_SSE2_FUNC inline void StoreYUVToRGBA(__m128i y, __m128i u, __m128i v, uint32 *dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for( int h=0; h<2; h++ )
+    {
+        __m128i p = h ? YUVToPlanarBRGA(_mm_unpackhi_epi16(y, zero), _mm_unpackhi_epi16(u, zero), _mm_unpackhi_epi16(v, zero))
+                      : YUVToPlanarBRGA(_mm_unpacklo_epi16(y, zero), _mm_unpacklo_epi16(u, zero), _mm_unpacklo_epi16(v, zero));
+        __m128i t = _mm_unpacklo_epi8(p, _mm_srli_si128(p, 8));       // B G B G B G B G R A R A R A R A
+        _mm_storeu_si128((__m128i*)(dst+h*4), _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8)));
+    }
+}
+
+static CONVERT_SSE2_FUNC inline void StoreYUVToR4G4B4(__m128i y, __m128i u, __m128i v, uint16 *dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i c0 = YUVToR4G4B4(_mm_unpacklo_epi16(y, zero), _mm_unpacklo_epi16(u, v));
+    __m128i c1 = YUVToR4G4B4(_mm_unpackhi_epi16(y, zero), _mm_unpackhi_epi16(u, v));
+    _mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(c0, c1));
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsYUV_SSE2(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= pairs; x+=4 )
+    {
+        __m128i y, u, v;
+        SplitYUV(_mm_loadu_si128((const __m128i*)(bytes+x*4)), bReversed, y, u, v);
+        StoreYUVToRGBA(y, u, v, dst+x*2);
+    }
+    ConvertTexelsYUV_C(bytes+x*4, bReversed, dst+x*2, pairs-x);
+}
+
+static CONVERT_SSE2_FUNC void ConvertTexelsYUV_SSE2_16(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= pairs; x+=4 )
+    {
+        __m128i y, u, v;
+        SplitYUV(_mm_loadu_si128((const __m128i*)(bytes+x*4)), bReversed, y, u, v);
+        StoreYUVToR4G4B4(y, u, v, dst+x*2);
+    }
+    ConvertTexelsYUV_C_16(bytes+x*4, bReversed, dst+x*2, pairs-x);
+}
+
+
+/****
+ SSSE3 kernels: pshufb for the byte moves, the rest as SSE2
+****/
+// a pshufb mask for each fiddle, byte i of it i^fiddle
+static CONVERT_SSSE3_FUNC void UnswizzleBlocks_SSSE3(const uint8 *src, uint32 fiddle, uint8 *dst, uint32 blocks)
+{
+    const __m128i mask = _mm_xor_si128(_mm_setr_epi8(0,1,2,3, 4,5,6,7, 8,9,10,11, 12,13,14,15), _mm_set1_epi8((char)fiddle));
+    for( uint32 i=0; i<blocks*16; i+=16 )
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src+i));
+        _mm_storeu_si128((__m128i*)(dst+i), _mm_shuffle_epi8(x, mask));
+    }
+}
+
+// SplitYUV with a pshufb for each of Y, U and V, the bytes past 15 (-1) are zeros
+static CONVERT_SSSE3_FUNC inline void SplitYUV_SSSE3(__m128i q, bool bReversed, __m128i &y, __m128i &u, __m128i &v)
+{
+    if( bReversed )
+    {
+        y = _mm_shuffle_epi8(q, _mm_setr_epi8(2,-1,0,-1, 6,-1,4,-1, 10,-1,8,-1, 14,-1,12,-1));
+        u = _mm_shuffle_epi8(q, _mm_setr_epi8(3,-1,3,-1, 7,-1,7,-1, 11,-1,11,-1, 15,-1,15,-1));
+        v = _mm_shuffle_epi8(q, _mm_setr_epi8(1,-1,1,-1, 5,-1,5,-1, 9,-1,9,-1, 13,-1,13,-1));
+    }
+    else
+    {
+        y = _mm_shuffle_epi8(q, _mm_setr_epi8(1,-1,3,-1, 5,-1,7,-1, 9,-1,11,-1, 13,-1,15,-1));
+        u = _mm_shuffle_epi8(q, _mm_setr_epi8(0,-1,0,-1, 4,-1,4,-1, 8,-1,8,-1, 12,-1,12,-1));
+        v = _mm_shuffle_epi8(q, _mm_setr_epi8(2,-1,2,-1, 6,-1,6,-1, 10,-1,10,-1, 14,-1,14,-1));
+    }
+}
+
+static CONVERT_SSSE3_FUNC void ConvertTexelsYUV_SSSE3(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i interleave = _mm_setr_epi8(0,8,4,12, 1,9,5,13, 2,10,6,14, 3,11,7,15);
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= pairs; x+=4 )
+    {
+        __m128i y, u, v;
+        SplitYUV_SSSE3(_mm_loadu_si128((const __m128i*)(bytes+x*4)), bReversed, y, u, v);
+        __m128i p0 = YUVToPlanarBRGA(_mm_unpacklo_epi16(y, zero), _mm_unpacklo_epi16(u, zero), _mm_unpacklo_epi16(v, zero));
+        __m128i p1 = YUVToPlanarBRGA(_mm_unpackhi_epi16(y, zero), _mm_unpackhi_epi16(u, zero), _mm_unpackhi_epi16(v, zero));
+        _mm_storeu_si128((__m128i*)(dst+x*2), _mm_shuffle_epi8(p0, interleave));
+        _mm_storeu_si128((__m128i*)(dst+x*2+4), _mm_shuffle_epi8(p1, interleave));
+    }
+    ConvertTexelsYUV_C(bytes+x*4, bReversed, dst+x*2, pairs-x);
+}
+
+static CONVERT_SSSE3_FUNC void ConvertTexelsYUV_SSSE3_16(const uint8 *bytes, bool bReversed, void *pDst, uint32 pairs)
+{
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= pairs; x+=4 )
+    {
+        __m128i y, u, v;
+        SplitYUV_SSSE3(_mm_loadu_si128((const __m128i*)(bytes+x*4)), bReversed, y, u, v);
+        StoreYUVToR4G4B4(y, u, v, dst+x*2);
+    }
+    ConvertTexelsYUV_C_16(bytes+x*4, bReversed, dst+x*2, pairs-x);
+}
+
+// byte k of the 16 entries of a table, which pshufb looks up like NEON does with vtbl
+static CONVERT_SSSE3_FUNC inline __m128i TablePlane(const uint8 *table, uint32 size, uint32 k)
+{
+    uint8 plane[16];
+    for( uint32 i=0; i<16; i++ )
+        plane[i] = table[i*size+k];
+    return _mm_loadu_si128((const __m128i*)plane);
+}
+
+// the indices of the 32 texels of 16 bytes, the high nibble of a byte first
+static CONVERT_SSSE3_FUNC inline void SplitNibbles(__m128i b, __m128i &idx0, __m128i &idx1)
+{
+    const __m128i mask4 = _mm_set1_epi8(0x0F);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), mask4);
+    __m128i lo = _mm_and_si128(b, mask4);
+    idx0 = _mm_unpacklo_epi8(hi, lo);
+    idx1 = _mm_unpackhi_epi8(hi, lo);
+}
+
+static CONVERT_SSSE3_FUNC void ConvertTexels4_SSSE3(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    const uint8 *table = (const uint8*)pTable;
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+
+    __m128i planes[4];
+    for( uint32 k=0; k<4; k++ )
+        planes[k] = TablePlane(table, 4, k);
+
+    for( ; x+32 <= count; x+=32 )
+    {
+        __m128i idx[2];
+        SplitNibbles(_mm_loadu_si128((const __m128i*)(bytes+x/2)), idx[0], idx[1]);
+        for( int h=0; h<2; h++ )
+        {
+            __m128i b0 = _mm_shuffle_epi8(planes[0], idx[h]);
+            __m128i b1 = _mm_shuffle_epi8(planes[1], idx[h]);
+            __m128i b2 = _mm_shuffle_epi8(planes[2], idx[h]);
+            __m128i b3 = _mm_shuffle_epi8(planes[3], idx[h]);
+            __m128i lo01 = _mm_unpacklo_epi8(b0, b1), lo23 = _mm_unpacklo_epi8(b2, b3);
+            __m128i hi01 = _mm_unpackhi_epi8(b0, b1), hi23 = _mm_unpackhi_epi8(b2, b3);
+            uint32 *pDst = dst+x+h*16;
+            _mm_storeu_si128((__m128i*)(pDst+0), _mm_unpacklo_epi16(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(pDst+4), _mm_unpackhi_epi16(lo01, lo23));
+            _mm_storeu_si128((__m128i*)(pDst+8), _mm_unpacklo_epi16(hi01, hi23));
+            _mm_storeu_si128((__m128i*)(pDst+12), _mm_unpackhi_epi16(hi01, hi23));
+        }
+    }
+    ConvertTexels4_C(bytes+x/2, pTable, dst+x, count-x);
+}
+
+static CONVERT_SSSE3_FUNC void ConvertTexels4_SSSE3_16(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    const uint8 *table = (const uint8*)pTable;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    __m128i planes[2];
+    for( uint32 k=0; k<2; k++ )
+        planes[k] = TablePlane(table, 2, k);
+
+    for( ; x+32 <= count; x+=32 )
+    {
+        __m128i idx[2];
+        SplitNibbles(_mm_loadu_si128((const __m128i*)(bytes+x/2)), idx[0], idx[1]);
+        for( int h=0; h<2; h++ )
+        {
+            __m128i b0 = _mm_shuffle_epi8(planes[0], idx[h]);
+            __m128i b1 = _mm_shuffle_epi8(planes[1], idx[h]);
+            _mm_storeu_si128((__m128i*)(dst+x+h*16), _mm_unpacklo_epi8(b0, b1));
+            _mm_storeu_si128((__m128i*)(dst+x+h*16+8), _mm_unpackhi_epi8(b0, b1));
+        }
+    }
+    ConvertTexels4_C_16(bytes+x/2, pTable, dst+x, count-x);
+}
+#endif
+
+
+#if defined(CONVERT_NEON)
+/****
+ NEON kernels
+****/
+static void UnswizzleBlocks_NEON(const uint8 *src, uint32 fiddle, uint8 *dst, uint32 blocks)
+{
+    for( uint32 i=0; i<blocks*16; i+=16 )
+    {
+        uint8x16_t x = vld1q_u8(src+i);
+        if( fiddle & 1 )
+            x = vrev16q_u8(x);
+        if( fiddle & 2 )
+            x = vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(x)));
+        if( fiddle & 4 )
+            x = vreinterpretq_u8_u32(vrev64q_u32(vreinterpretq_u32_u8(x)));
+        if( fiddle & 8 )
+            x = vextq_u8(x, x, 8);
+        vst1q_u8(dst+i, x);
+    }
+}
+
+static void ConvertTexelsRGBA16_NEON(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t one = vdupq_n_u16(1);
+    for( ; x+8 <= count; x+=8 )
+    {
+        uint16x8_t p = vld1q_u16(w+x);
+        uint16x8_t r = vandq_u16(vshrq_n_u16(p, 11), mask5);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(p, 6), mask5);
+        uint16x8_t b = vandq_u16(vshrq_n_u16(p, 1), mask5);
+
+        uint8x8x4_t out;
+        out.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2)));
+        out.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g, 3), vshrq_n_u16(g, 2)));
+        out.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2)));
+        out.val[3] = vmovn_u16(vceqq_u16(vandq_u16(p, one), one));
+        vst4_u8((uint8*)(dst+x), out);
+    }
+    ConvertTexelsRGBA16_C(bytes+x*2, dst+x, count-x);
+}
+
+static void ConvertTexelsRGBA16_NEON_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    const uint16x8_t maskR = vdupq_n_u16(0x0F00);
+    const uint16x8_t maskG = vdupq_n_u16(0x00F0);
+    const uint16x8_t maskB = vdupq_n_u16(0x000F);
+    const uint16x8_t maskA = vdupq_n_u16(0xF000);
+    const uint16x8_t one = vdupq_n_u16(1);
+    for( ; x+8 <= count; x+=8 )
+    {
+        uint16x8_t p = vld1q_u16(w+x);
+        uint16x8_t c = vorrq_u16(vandq_u16(vshrq_n_u16(p, 4), maskR),
+                                 vorrq_u16(vandq_u16(vshrq_n_u16(p, 3), maskG),
+                                           vandq_u16(vshrq_n_u16(p, 2), maskB)));
+        c = vorrq_u16(c, vandq_u16(vceqq_u16(vandq_u16(p, one), one), maskA));
+        vst1q_u16(dst+x, c);
+    }
+    ConvertTexelsRGBA16_C_16(bytes+x*2, dst+x, count-x);
+}
+
+static void ConvertTexelsIA16_NEON(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+8 <= count; x+=8 )
+    {
+        // the low byte of a texel is A, the high one I
+        uint8x8x2_t ai = vld2_u8(bytes+x*2);
+        uint8x8x4_t out;
+        out.val[0] = ai.val[1];
+        out.val[1] = ai.val[1];
+        out.val[2] = ai.val[1];
+        out.val[3] = ai.val[0];
+        vst4_u8((uint8*)(dst+x), out);
+    }
+    ConvertTexelsIA16_C(bytes+x*2, dst+x, count-x);
+}
+
+static void ConvertTexelsIA16_NEON_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    const uint16 *w = (const uint16*)bytes;
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    const uint16x8_t maskA = vdupq_n_u16(0xF000);
+    for( ; x+8 <= count; x+=8 )
+    {
+        uint16x8_t p = vld1q_u16(w+x);
+        uint16x8_t i = vshrq_n_u16(p, 12);
+        uint16x8_t c = vorrq_u16(vmulq_n_u16(i, 0x0111), vandq_u16(vshlq_n_u16(p, 8), maskA));
+        vst1q_u16(dst+x, c);
+    }
+    ConvertTexelsIA16_C_16(bytes+x*2, dst+x, count-x);
+}
+
+static void ConvertTexelsRGBA32_NEON(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+    for( ; x+4 <= count; x+=4 )
+    {
+        uint32x4_t p = vreinterpretq_u32_u8(vld1q_u8(bytes+x*4));
+        vst1q_u32(dst+x, vorrq_u32(vshrq_n_u32(p, 8), vshlq_n_u32(p, 24)));
+    }
+    ConvertTexelsRGBA32_C(bytes+x*4, dst+x, count-x);
+}
+
+static void ConvertTexelsRGBA32_NEON_16(const uint8 *bytes, void *pDst, uint32 count)
+{
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+    for( ; x+8 <= count; x+=8 )
+    {
+        // bytes A, B, G, R once swapped
+        uint8x8x4_t p = vld4_u8(bytes+x*4);
+        uint8x8_t lo = vorr_u8(vand_u8(p.val[2], vdup_n_u8(0xF0)), vshr_n_u8(p.val[1], 4));
+        uint8x8_t hi = vorr_u8(vand_u8(p.val[0], vdup_n_u8(0xF0)), vshr_n_u8(p.val[3], 4));
+        uint8x8x2_t out;
+        out.val[0] = lo;
+        out.val[1] = hi;
+        vst2_u8((uint8*)(dst+x), out);
+    }
+    ConvertTexelsRGBA32_C_16(bytes+x*4, dst+x, count-x);
+}
+
+static void ConvertTexels4_NEON(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    uint32 *dst = (uint32*)pDst;
+    uint32 x = 0;
+
+    // the 4 bytes of the entries as 4 tables of 16 bytes
+    uint8x8x4_t t0 = vld4_u8((const uint8*)pTable);
+    uint8x8x4_t t1 = vld4_u8((const uint8*)pTable+32);
+    uint8x8x2_t planes[4];
+    for( int k=0; k<4; k++ )
+    {
+        planes[k].val[0] = t0.val[k];
+        planes[k].val[1] = t1.val[k];
+    }
+
+    for( ; x+16 <= count; x+=16 )
+    {
+        uint8x8_t b = vld1_u8(bytes+x/2);
+        uint8x8x2_t idx = vzip_u8(vshr_n_u8(b, 4), vand_u8(b, vdup_n_u8(0x0F)));
+        for( int h=0; h<2; h++ )
+        {
+            uint8x8x4_t out;
+            out.val[0] = vtbl2_u8(planes[0], idx.val[h]);
+            out.val[1] = vtbl2_u8(planes[1], idx.val[h]);
+            out.val[2] = vtbl2_u8(planes[2], idx.val[h]);
+            out.val[3] = vtbl2_u8(planes[3], idx.val[h]);
+            vst4_u8((uint8*)(dst+x+h*8), out);
+        }
+    }
+    ConvertTexels4_C(bytes+x/2, pTable, dst+x, count-x);
+}
+
+static void ConvertTexels4_NEON_16(const uint8 *bytes, const void *pTable, void *pDst, uint32 count)
+{
+    uint16 *dst = (uint16*)pDst;
+    uint32 x = 0;
+
+    uint8x8x2_t t0 = vld2_u8((const uint8*)pTable);
+    uint8x8x2_t t1 = vld2_u8((const uint8*)pTable+16);
+    uint8x8x2_t planes[2];
+    for( int k=0; k<2; k++ )
+    {
+        planes[k].val[0] = t0.val[k];
+        planes[k].val[1] = t1.val[k];
+    }
+
+    for( ; x+16 <= count; x+=16 )
+    {
+        uint8x8_t b = vld1_u8(bytes+x/2);
+        uint8x8x2_t idx = vzip_u8(vshr_n_u8(b, 4), vand_u8(b, vdup_n_u8(0x0F)));
+        for( int h=0; h<2; h++ )
+        {
+            uint8x8x2_t out;
+            out.val[0] = vtbl2_u8(planes[0], idx.val[h]);
+            out.val[1] = vtbl2_u8(planes[1], idx.val[h]);
+            vst2_u8((uint8*)(dst+x+h*8), out);
+        }
+    }
+    ConvertTexels4_C_16(bytes+x/2, pTable, dst+x, count-x);
+}
+#endif
+
+
+/****
+ The kernels of each SIMD level
+****/
+typedef struct
+{
+    ConvertSimd simd;
+    UnswizzleBlocks unswizzle;
+    ConvertTexels rgba16, rgba16_16, ia16, ia16_16, rgba32, rgba32_16;
+    ConvertTexelsYUV yuv, yuv_16;
+    ConvertTexels4 table4, table4_16;
+} ConvertKernels;
+
+// the levels the build has, lowest first
+static const ConvertKernels gConvertKernels[] =
+{
+    {
+        CONVERT_SIMD_NONE, UnswizzleBlocks_C,
+        ConvertTexelsRGBA16_C, ConvertTexelsRGBA16_C_16, ConvertTexelsIA16_C, ConvertTexelsIA16_C_16,
+        ConvertTexelsRGBA32_C, ConvertTexelsRGBA32_C_16,
+        ConvertTexelsYUV_C, ConvertTexelsYUV_C_16,
+        ConvertTexels4_C, ConvertTexels4_C_16,
+    },
+#if defined(CONVERT_SSE2)
+    {
+        CONVERT_SIMD_SSE2, UnswizzleBlocks_SSE2,
+        ConvertTexelsRGBA16_SSE2, ConvertTexelsRGBA16_SSE2_16, ConvertTexelsIA16_SSE2, ConvertTexelsIA16_SSE2_16,
+        ConvertTexelsRGBA32_SSE2, ConvertTexelsRGBA32_SSE2_16,
+        ConvertTexelsYUV_SSE2, ConvertTexelsYUV_SSE2_16,
+        ConvertTexels4_C, ConvertTexels4_C_16,
+    },
+    {
+        CONVERT_SIMD_SSSE3, UnswizzleBlocks_SSSE3,
+        ConvertTexelsRGBA16_SSE2, ConvertTexelsRGBA16_SSE2_16, ConvertTexelsIA16_SSE2, ConvertTexelsIA16_SSE2_16,
+        ConvertTexelsRGBA32_SSE2, ConvertTexelsRGBA32_SSE2_16,
+        ConvertTexelsYUV_SSSE3, ConvertTexelsYUV_SSSE3_16,
+        ConvertTexels4_SSSE3, ConvertTexels4_SSSE3_16,
+    },
+#elif defined(CONVERT_NEON)
+    {
+        CONVERT_SIMD_NEON, UnswizzleBlocks_NEON,
+        ConvertTexelsRGBA16_NEON, ConvertTexelsRGBA16_NEON_16, ConvertTexelsIA16_NEON, ConvertTexelsIA16_NEON_16,
+        ConvertTexelsRGBA32_NEON, ConvertTexelsRGBA32_NEON_16,
+        ConvertTexelsYUV_C, ConvertTexelsYUV_C_16,
+        ConvertTexels4_NEON, ConvertTexels4_NEON_16,
+    },
+#endif
+};
+
+#define NUM_CONVERT_KERNELS (sizeof(gConvertKernels)/sizeof(gConvertKernels[0]))
+
+static const ConvertKernels *gKernels = NULL;
+
+static bool CpuHasSimd(ConvertSimd simd)
+{
+#if defined(CONVERT_SSE2)
+    unsigned int eax, ebx, ecx, edx;
+    if( simd != CONVERT_SIMD_NONE && !__get_cpuid(1, &eax, &ebx, &ecx, &edx) )
+        return false;
+    if( simd == CONVERT_SIMD_SSE2 )
+        return (edx & bit_SSE2) != 0;
+    if( simd == CONVERT_SIMD_SSSE3 )
+        return (edx & bit_SSE2) != 0 && (ecx & bit_SSSE3) != 0;
+#endif
+    // NEON is only built for targets which have it
+    return true;
+}
+
+static const ConvertKernels &Kernels(void)
+{
+    if( gKernels == NULL )
+    {
+        gKernels = &gConvertKernels[0];
+        for( uint32 i=1; i<NUM_CONVERT_KERNELS; i++ )
+        {
+            if( CpuHasSimd(gConvertKernels[i].simd) )
+                gKernels = &gConvertKernels[i];
+        }
+    }
+    return *gKernels;
+}
+
+ConvertSimd GetConvertSimd(void)
+{
+    return Kernels().simd;
+}
+
+bool SetConvertSimd(ConvertSimd simd)
+{
+    for( uint32 i=0; i<NUM_CONVERT_KERNELS; i++ )
+    {
+        if( gConvertKernels[i].simd == simd && CpuHasSimd(simd) )
+        {
+            gKernels = &gConvertKernels[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/****
+ Rows
+****/
+void UnswizzleTexelBytes(const uint8 *src, uint32 offset, uint32 fiddle, uint8 *dst, uint32 count)
+{
+    uint32 i = 0;
+
+    if( fiddle == 0 )
+    {
+        memcpy(dst, src+offset, count);
+        return;
+    }
+
+    // up to the first index multiple of 16, the block the fiddle stays in
+    for( ; i<count && ((offset+i)&15) != 0; i++ )
+        dst[i] = src[(offset+i)^fiddle];
+
+    uint32 blocks = (count-i)/16;
+    Kernels().unswizzle(src+offset+i, fiddle, dst+i, blocks);
+    i += blocks*16;
+
+    for( ; i<count; i++ )
+        dst[i] = src[(offset+i)^fiddle];
+}
+
+static void ConvertRow16b(const uint8 *src, uint32 offset, uint32 fiddle, uint8 *dst, uint32 dstSize, uint32 count,
+                          ConvertTexels convert)
+{
+    uint32 chunk[CONVERT_CHUNK/4];     // aligned for the 16b and 32b texels
+    uint8 *bytes = (uint8*)chunk;
+
+    for( uint32 x=0; x<count; x+=CONVERT_CHUNK/2 )
+    {
+        uint32 n = count-x < CONVERT_CHUNK/2 ? count-x : CONVERT_CHUNK/2;
+        if( (offset|fiddle) & 1 )
+        {
+            // the texels are read as 16b words at (offset^fiddle), which are not the bytes in order unless both are even
+            for( uint32 k=0; k<n; k++ )
+                *(uint16*)(bytes+k*2) = *(const uint16*)&src[(offset+(x+k)*2)^fiddle];
+        }
+        else
+        {
+            UnswizzleTexelBytes(src, offset+x*2, fiddle, bytes, n*2);
+        }
+        convert(bytes, dst+x*dstSize, n);
+    }
+}
+
+void ConvertRowRGBA16(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count)
+{
+    ConvertRow16b(src, offset, fiddle, (uint8*)dst, 4, count, Kernels().rgba16);
+}
+
+void ConvertRowRGBA16_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count)
+{
+    ConvertRow16b(src, offset, fiddle, (uint8*)dst, 2, count, Kernels().rgba16_16);
+}
+
+void ConvertRowIA16(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count)
+{
+    ConvertRow16b(src, offset, fiddle, (uint8*)dst, 4, count, Kernels().ia16);
+}
+
+void ConvertRowIA16_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count)
+{
+    ConvertRow16b(src, offset, fiddle, (uint8*)dst, 2, count, Kernels().ia16_16);
+}
+
+static void ConvertRow32b(const uint8 *src, uint32 offset, uint32 fiddle, uint8 *dst, uint32 dstSize, uint32 count,
+                          ConvertTexels convert)
+{
+    uint32 chunk[CONVERT_CHUNK/4];
+    uint8 *bytes = (uint8*)chunk;
+
+    for( uint32 x=0; x<count; x+=CONVERT_CHUNK/4 )
+    {
+        uint32 n = count-x < CONVERT_CHUNK/4 ? count-x : CONVERT_CHUNK/4;
+        UnswizzleTexelBytes(src, offset+x*4, fiddle, bytes, n*4);
+        convert(bytes, dst+x*dstSize, n);
+    }
+}
+
+void ConvertRowRGBA32(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count)
+{
+    ConvertRow32b(src, offset, fiddle, (uint8*)dst, 4, count, Kernels().rgba32);
+}
+
+void ConvertRowRGBA32_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count)
+{
+    ConvertRow32b(src, offset, fiddle, (uint8*)dst, 2, count, Kernels().rgba32_16);
+}
+
+static void ConvertRowYUVb(const uint8 *src, uint32 offset, uint32 fiddle, bool bReversed, uint8 *dst, uint32 dstSize,
+                           uint32 count, ConvertTexelsYUV convert)
+{
+    uint32 pairs = count/2;
+
+    if( fiddle == 0 )
+    {
+        convert(src+offset, bReversed, dst, pairs);
+        return;
+    }
+
+    uint32 chunk[CONVERT_CHUNK/4];
+    uint8 *bytes = (uint8*)chunk;
+    for( uint32 x=0; x<pairs; x+=CONVERT_CHUNK/4 )
+    {
+        uint32 n = pairs-x < CONVERT_CHUNK/4 ? pairs-x : CONVERT_CHUNK/4;
+        UnswizzleTexelBytes(src, offset+x*4, fiddle, bytes, n*4);
+        convert(bytes, bReversed, dst+x*2*dstSize, n);
+    }
+}
+
+void ConvertRowYUV(const uint8 *src, uint32 offset, uint32 fiddle, bool bReversed, uint32 *dst, uint32 count)
+{
+    ConvertRowYUVb(src, offset, fiddle, bReversed, (uint8*)dst, 4, count, Kernels().yuv);
+}
+
+void ConvertRowYUV_16(const uint8 *src, uint32 offset, uint32 fiddle, bool bReversed, uint16 *dst, uint32 count)
+{
+    ConvertRowYUVb(src, offset, fiddle, bReversed, (uint8*)dst, 2, count, Kernels().yuv_16);
+}
+
+// 8b texels are looked up one at a time: a 256 entry table is too big for a shuffle
+void ConvertRowTable8(const uint8 *src, uint32 offset, uint32 fiddle, const uint32 *table, uint32 *dst, uint32 count)
+{
+    uint32 chunk[CONVERT_CHUNK/4];
+    uint8 *bytes = (uint8*)chunk;
+
+    for( uint32 x0=0; x0<count; x0+=CONVERT_CHUNK )
+    {
+        uint32 n = count-x0 < CONVERT_CHUNK ? count-x0 : CONVERT_CHUNK;
+        UnswizzleTexelBytes(src, offset+x0, fiddle, bytes, n);
+        for( uint32 x=0; x<n; x++ )
+            dst[x0+x] = table[bytes[x]];
+    }
+}
+
+void ConvertRowTable8_16(const uint8 *src, uint32 offset, uint32 fiddle, const uint16 *table, uint16 *dst, uint32 count)
+{
+    uint32 chunk[CONVERT_CHUNK/4];
+    uint8 *bytes = (uint8*)chunk;
+
+    for( uint32 x0=0; x0<count; x0+=CONVERT_CHUNK )
+    {
+        uint32 n = count-x0 < CONVERT_CHUNK ? count-x0 : CONVERT_CHUNK;
+        UnswizzleTexelBytes(src, offset+x0, fiddle, bytes, n);
+        for( uint32 x=0; x<n; x++ )
+            dst[x0+x] = table[bytes[x]];
+    }
+}
+
+static void ConvertRow4b(const uint8 *src, uint32 offset, uint32 fiddle, const void *table, uint8 *dst, uint32 dstSize,
+                         uint32 count, ConvertTexels4 convert)
+{
+    uint32 chunk[CONVERT_CHUNK/4];
+    uint8 *bytes = (uint8*)chunk;
+
+    for( uint32 x=0; x<count; x+=CONVERT_CHUNK*2 )
+    {
+        uint32 n = count-x < CONVERT_CHUNK*2 ? count-x : CONVERT_CHUNK*2;
+        UnswizzleTexelBytes(src, offset+x/2, fiddle, bytes, (n+1)/2);
+        convert(bytes, table, dst+x*dstSize, n);
+    }
+}
+
+void ConvertRowTable4(const uint8 *src, uint32 offset, uint32 fiddle, const uint32 *table, uint32 *dst, uint32 count)
+{
+    ConvertRow4b(src, offset, fiddle, table, (uint8*)dst, 4, count, Kernels().table4);
+}
+
+void ConvertRowTable4_16(const uint8 *src, uint32 offset, uint32 fiddle, const uint16 *table, uint16 *dst, uint32 count)
+{
+    ConvertRow4b(src, offset, fiddle, table, (uint8*)dst, 2, count, Kernels().table4_16);
+}
+
+
+/****
+ Tables
+****/
+static uint32 gTexelTables[4][256];
+static uint16 gTexelTables_16[4][256];
+static bool gTexelTablesBuilt = false;
+
+static void BuildTexelTables(void)
+{
+    for( uint32 v=0; v<256; v++ )
+    {
+        uint8 I = FourToEight[v>>4];
+        gTexelTables[TEXEL_TABLE_IA4][v] = ConvertIA4ToRGBA((uint8)v);
+        gTexelTables[TEXEL_TABLE_I4][v] = ConvertI4ToRGBA((uint8)v);
+        gTexelTables[TEXEL_TABLE_IA8][v] = COLOR_RGBA(I, I, I, FourToEight[v&0x0F]);
+        gTexelTables[TEXEL_TABLE_I8][v] = COLOR_RGBA(v, v, v, v);
+
+        gTexelTables_16[TEXEL_TABLE_IA4][v] = ConvertIA4ToR4G4B4A4((uint8)v);
+        gTexelTables_16[TEXEL_TABLE_I4][v] = ConvertI4ToR4G4B4A4((uint8)v);
+        gTexelTables_16[TEXEL_TABLE_IA8][v] = R4G4B4A4_MAKE((v>>4), (v>>4), (v>>4), (v&0x0F));
+        gTexelTables_16[TEXEL_TABLE_I8][v] = R4G4B4A4_MAKE((v>>4), (v>>4), (v>>4), (v>>4));
+    }
+    gTexelTablesBuilt = true;
+}
+
+const uint32 *GetTexelTable(TexelTable table)
+{
+    if( !gTexelTablesBuilt )
+        BuildTexelTables();
+    return gTexelTables[table];
+}
+
+const uint16 *GetTexelTable_16(TexelTable table)
+{
+    if( !gTexelTablesBuilt )
+        BuildTexelTables();
+    return gTexelTables_16[table];
+}
+
+void ConvertPaletteRGBA16(const uint16 *pPal, uint32 count, bool bIgnoreAlpha, uint32 *table)
+{
+    for( uint32 i=0; i<count; i++ )
+        table[i] = Convert555ToRGBA(pPal[i^1]) | (bIgnoreAlpha ? 0xFF000000 : 0);
+}
+
+void ConvertPaletteIA16(const uint16 *pPal, uint32 count, bool bIgnoreAlpha, uint32 *table)
+{
+    for( uint32 i=0; i<count; i++ )
+        table[i] = ConvertIA16ToRGBA(pPal[i^1]) | (bIgnoreAlpha ? 0xFF000000 : 0);
+}
+
+void ConvertPaletteRGBA16_16(const uint16 *pPal, uint32 count, uint16 *table)
+{
+    for( uint32 i=0; i<count; i++ )
+        table[i] = Convert555ToR4G4B4A4(pPal[i^1]);
+}
+
+void ConvertPaletteIA16_16(const uint16 *pPal, uint32 count, uint16 *table)
+{
+    for( uint32 i=0; i<count; i++ )
+        table[i] = ConvertIA16ToR4G4B4A4(pPal[i^1]);
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _CONVERT_IMAGE_ROWS_H_
+#define _CONVERT_IMAGE_ROWS_H_
+
+#include "typedefs.h"
+
+/****
+ Texture row conversion
+
+ The converters in ConvertImage.cpp and ConvertImage16.cpp read the texels of a row at (offset+i)^fiddle, the byte
+ order the N64 keeps them in (fiddle 3, 7 for odd lines of swapped textures, 2 and 6 for the 16b ones). The functions
+ here do the same for a whole row: the bytes are put in order 16 at a time, then the texels are converted with SIMD
+ arithmetic for the 16b, 32b and YUV formats, and through tables for the 4b and 8b ones. The kernels for this come from
+ one table for each SIMD level: SSE2, SSSE3 which puts the bytes in order, splits YUV and looks the 16 entry tables up
+ with pshufb, or NEON which does the table lookups with vtbl and has no YUV code. The SSE2 and SSSE3 ones are picked
+ with cpuid, so an x86 build without -msse2 uses them too. 8b texels are looked up one at a time whatever the level.
+ The output is the same as the per texel code, which tools/convertbench.cpp checks.
+
+ Tables hold a converted texel per value: ConvertImage.h conversions of the 4b and 8b intensity formats, or a palette
+ converted once for the texture instead of once per texel.
+****/
+
+// dst[i] = src[(offset+i)^fiddle], fiddle < 16
+void UnswizzleTexelBytes(const uint8 *src, uint32 offset, uint32 fiddle, uint8 *dst, uint32 count);
+
+// count texels from the byte at (offset^fiddle), 16b texels need an even offset and fiddle to be read with SIMD
+void ConvertRowRGBA16(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count);
+void ConvertRowRGBA16_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count);
+void ConvertRowIA16(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count);
+void ConvertRowIA16_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count);
+void ConvertRowRGBA32(const uint8 *src, uint32 offset, uint32 fiddle, uint32 *dst, uint32 count);
+void ConvertRowRGBA32_16(const uint8 *src, uint32 offset, uint32 fiddle, uint16 *dst, uint32 count);
+
+// count texels from the byte at (offset^fiddle), 2 at a time from 4 bytes U, Y0, V, Y1, or Y1, V, Y0, U when
+// reversed (an odd last texel is left alone)
+void ConvertRowYUV(const uint8 *src, uint32 offset, uint32 fiddle, bool bReversed, uint32 *dst, uint32 count);
+void ConvertRowYUV_16(const uint8 *src, uint32 offset, uint32 fiddle, bool bReversed, uint16 *dst, uint32 count);
+
+typedef enum {
+    CONVERT_SIMD_NONE,
+    CONVERT_SIMD_SSE2,
+    CONVERT_SIMD_SSSE3,
+    CONVERT_SIMD_NEON,
+} ConvertSimd;
+
+// what the rows are converted with: the best level the build has which cpuid finds the first time. The others the
+// build and the CPU have can be set, for tools/convertbench.cpp to check them all; false for the rest
+ConvertSimd GetConvertSimd(void);
+bool SetConvertSimd(ConvertSimd simd);
+
+// 8b texels through a 256 entry table
+void ConvertRowTable8(const uint8 *src, uint32 offset, uint32 fiddle, const uint32 *table, uint32 *dst, uint32 count);
+void ConvertRowTable8_16(const uint8 *src, uint32 offset, uint32 fiddle, const uint16 *table, uint16 *dst, uint32 count);
+
+// 4b texels through a 16 entry table, the high nibble of a byte first
+void ConvertRowTable4(const uint8 *src, uint32 offset, uint32 fiddle, const uint32 *table, uint32 *dst, uint32 count);
+void ConvertRowTable4_16(const uint8 *src, uint32 offset, uint32 fiddle, const uint16 *table, uint16 *dst, uint32 count);
+
+typedef enum {
+    TEXEL_TABLE_IA4,
+    TEXEL_TABLE_I4,
+    TEXEL_TABLE_IA8,
+    TEXEL_TABLE_I8,
+} TexelTable;
+
+const uint32 *GetTexelTable(TexelTable table);
+const uint16 *GetTexelTable_16(TexelTable table);
+
+// count palette entries, read the way the converters do (pPal[i^1])
+void ConvertPaletteRGBA16(const uint16 *pPal, uint32 count, bool bIgnoreAlpha, uint32 *table);
+void ConvertPaletteIA16(const uint16 *pPal, uint32 count, bool bIgnoreAlpha, uint32 *table);
+void ConvertPaletteRGBA16_16(const uint16 *pPal, uint32 count, uint16 *table);
+void ConvertPaletteIA16_16(const uint16 *pPal, uint32 count, uint16 *table);
+
+#endif
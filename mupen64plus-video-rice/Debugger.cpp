@@ -134,6 +134,7 @@ const char* thingsToDump[] = {
     "Frame Buffer in RDRAM",
     "BackBuffer",
     "TexBuffer #",
+    "Texture Cache Stats",
 };
 int numberOfThingsToDump = sizeof(thingsToDump)/sizeof(char*);
 
@@ -170,6 +171,7 @@ enum {
     DUMP_FRAME_BUFFER,
     DUMP_BACKBUFFER,
     DUMP_TEXBUFFER_AT,
+    DUMP_TEXTURE_CACHE_STATS,
 };
 
 //---------------------------------------------------------------------
@@ -536,6 +538,9 @@ void DumpInfo(int thingToDump)
     case DUMP_PROJECTION_MATRIX:
         DumpMatrix2(gRSP.projectionMtxs[gRSP.projectionMtxTop],"Projection Top Matrix");
         break;
+    case DUMP_TEXTURE_CACHE_STATS:
+        gTextureManager.DumpStatistics();
+        break;
     }
 }
 
@@ -24,9 +24,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ConvertImage.h"
 #include "DeviceBuilder.h"
 #include "FrameBuffer.h"
+#include "FrameBufferCopy.h"
 #include "UcodeDefs.h"
 #include "RSP_Parser.h"
 #include "Render.h"
+#include "TextureCRC.h"
 
 extern TMEMLoadMapInfo g_tmemLoadAddrMap[0x200];    // Totally 4KB TMEM;
 
@@ -79,6 +81,7 @@ void FrameBufferManager::CloseUp()
     {
         SAFE_DELETE(gRenderTextureInfos[i].pRenderTexture);
     }
+    StopFrameBufferCopyThreads();
 }
 
 void FrameBufferManager::Initialize()
@@ -530,10 +533,8 @@ void TexRectToN64FrameBuffer_16b(uint32 x0, uint32 y0, uint32 width, uint32 heig
         uint32* pSrc = (uint32*)((uint8*)srcInfo.lpSurface + y * srcInfo.lPitch);
         uint16* pN64Buffer = (uint16*)(g_pRDRAMu8+(n64CIaddr&(g_dwRamSize-1)))+(y+y0)*n64CIwidth;
 
-        for (uint32 x = 0; x < width; x++)
-        {
-            pN64Buffer[x+x0] = ConvertRGBATo555(pSrc[x]);
-        }
+        // same as ConvertRGBATo555(uint32) on each pixel
+        ConvertRowToRGBA5551(pSrc, pN64Buffer+x0, width, 0x80);
     }
 
     g_textures[dwTile].m_pCTexture->EndUpdate(&srcInfo);
@@ -545,20 +546,17 @@ void TexRectToN64FrameBuffer_16b(uint32 x0, uint32 y0, uint32 width, uint32 heig
 #define FAST_CRC_MIN_X_INC      2
 #define FAST_CRC_MAX_X_INC      7
 #define FAST_CRC_MAX_Y_INC      3
-extern uint32 dwAsmHeight;
-extern uint32 dwAsmPitch;
-extern uint32 dwAsmdwBytesPerLine;
 extern uint32 dwAsmCRC;
-extern uint8* pAsmStart;
 
-uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes )
+// If pMaxCI isn't NULL, the max CI of a 4b or 8b texture is found along with the full CRC, the sampled one leaves it alone
+uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes, int *pMaxCI )
 {
     dwAsmCRC = 0;
-    dwAsmdwBytesPerLine = ((width<<size)+1)/2;
+    uint32 dwBytesPerLine = ((width<<size)+1)/2;
 
-    if( currentRomOptions.bFastTexCRC && !options.bLoadHiResTextures && (height>=32 || (dwAsmdwBytesPerLine>>2)>=16))
+    if( currentRomOptions.bFastTexCRC && !options.bLoadHiResTextures && (height>=32 || (dwBytesPerLine>>2)>=16))
     {
-        uint32 realWidthInDWORD = dwAsmdwBytesPerLine>>2;
+        uint32 realWidthInDWORD = dwBytesPerLine>>2;
         uint32 xinc = realWidthInDWORD / FAST_CRC_CHECKING_INC_X;   
         if( xinc < FAST_CRC_MIN_X_INC )
         {
@@ -603,221 +601,10 @@ uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32
     }
     else
     {
-        try
-        {
-            dwAsmdwBytesPerLine = ((width<<size)+1)/2;
-
-            pAsmStart = (uint8*)(pPhysicalAddress);
-            pAsmStart += (top * pitchInBytes) + (((left<<size)+1)>>1);
-
-            dwAsmHeight = height - 1;
-            dwAsmPitch = pitchInBytes;
-
-#if defined(NO_ASM)
-            uint32 pitch = pitchInBytes>>2;
-            uint32* pStart = (uint32*)pPhysicalAddress;
-            pStart += (top * pitch) + (((left<<size)+1)>>3);
-
-            int y = dwAsmHeight;
-
-            while(y >= 0)
-            {
-                uint32 esi = 0;
-                int x = dwAsmdwBytesPerLine - 4;
-                while(x >= 0)
-                {
-                    esi = *(uint32*)(pAsmStart + x);
-                    esi ^= x;
-
-                    dwAsmCRC = (dwAsmCRC << 4) + ((dwAsmCRC >> 28) & 15);
-                    dwAsmCRC += esi;
-                    x-=4;
-                }
-                esi ^= y;
-                dwAsmCRC += esi;
-                pAsmStart += dwAsmPitch;
-                y--;
-            }
-
-#elif !defined(__GNUC__) // !defined(NO_ASM)
-            __asm 
-            {
-                push eax
-                push ebx
-                push ecx
-                push edx
-                push esi
-
-                mov ecx, pAsmStart;             // = pStart
-                mov edx, 0                      // The CRC
-                mov eax, dwAsmHeight            // = y
-l2:             mov ebx, dwAsmdwBytesPerLine    // = x
-                sub ebx, 4
-l1:             mov esi, [ecx+ebx]
-                xor esi, ebx
-                rol edx, 4
-                add edx, esi
-                sub ebx, 4
-                jge l1
-                xor esi, eax
-                add edx, esi
-                add ecx, dwAsmPitch
-                dec eax
-                jge l2
-
-                mov dwAsmCRC, edx
-
-                pop esi
-                pop edx
-                pop ecx
-                pop ebx
-                pop eax
-            }
-#elif defined(__x86_64__) // defined(__GNUC__) && !defined(NO_ASM)
-        asm volatile(" xorl          %k2,      %k2           \n"
-                     " movslq        %k4,      %q4           \n"
-                     "0:                                     \n"
-                     " movslq         %3,    %%rbx           \n"
-                     " sub            $4,    %%rbx           \n"
-                     "1:                                     \n"
-                     " movl (%0,%%rbx,1),    %%eax           \n"
-                     " xorl        %%ebx,    %%eax           \n"
-                     " roll           $4,      %k2           \n"
-                     " addl        %%eax,      %k2           \n"
-                     " sub            $4,    %%rbx           \n"
-                     " jge            1b                     \n"
-                     " xorl          %k1,    %%eax           \n"
-                     " addl        %%eax,      %k2           \n"
-                     " add           %q4,       %0           \n"
-                     " decl          %k1                     \n"
-                     " jge            0b                     \n"
-                     : "+r"(pAsmStart), "+r"(dwAsmHeight), "=&r"(dwAsmCRC)
-                     : "m"(dwAsmdwBytesPerLine), "r"(dwAsmPitch)
-                     : "%rbx", "%rax", "memory", "cc"
-                     );
-#elif !defined(__PIC__) // !defined(__x86_64__) && defined(__GNUC__) && !defined(NO_ASM)
-           asm volatile("pusha                        \n"
-                "mov    %[pAsmStart], %%ecx           \n" // = pStart
-                "mov    $0, %%edx                     \n" // The CRC
-                "mov    %[dwAsmHeight], %%eax         \n" // = y
-                "0:                                   \n" //l2:
-                "mov    %[dwAsmdwBytesPerLine], %%ebx \n" // = x
-                "sub    $4, %%ebx                     \n"
-                "1:                                   \n" //l1:
-                "mov    (%%ecx,%%ebx), %%esi          \n"
-                "xor %%ebx, %%esi                     \n"
-                "rol $4, %%edx                        \n"
-                "add %%esi, %%edx                     \n"
-                "sub    $4, %%ebx                     \n"
-                "jge 1b                               \n" //jge l1
-                "xor %%eax, %%esi                     \n"
-                "add %%esi, %%edx                     \n"
-                "add %[dwAsmPitch], %%ecx             \n"
-                "dec %%eax                            \n"
-                "jge 0b                               \n" //jge l2
-                
-                "mov    %%edx, %[dwAsmCRC]            \n"
-                "popa                                 \n"
-                : [pAsmStart]"+m"(pAsmStart), [dwAsmHeight]"+m"(dwAsmHeight), [dwAsmCRC]"=m"(dwAsmCRC)
-                : [dwAsmdwBytesPerLine]"m"(dwAsmdwBytesPerLine), [dwAsmPitch]"m"(dwAsmPitch)
-                : "memory", "cc"
-                );
-#else // defined(__PIC__) && !defined(__x86_64__) && defined(__GNUC__) && !defined(NO_ASM)
-           unsigned int saveEBX;
-           unsigned int saveEAX;
-           unsigned int saveECX;
-           unsigned int saveEDX;
-           unsigned int saveESI;
-           unsigned int asmdwBytesPerLine = dwAsmdwBytesPerLine;
-           unsigned int asmPitch = dwAsmPitch;
-           unsigned int asmHeight = dwAsmHeight;
-           unsigned int asmCRC;
-           asm volatile("mov    %%ebx, %2                  \n"
-                "mov    %%eax, %5                  \n"
-                "mov    %%ecx, %7                  \n"
-                "mov    %%edx, %8                  \n"
-                "mov    %%esi, %9                  \n"
-                "mov    %0, %%ecx                  \n" // = pStart
-                "mov    $0, %%edx                  \n" // The CRC
-                "mov    %1, %%eax                  \n" // = y
-                "0:                                \n" //l2:
-                "mov    %3, %%ebx                  \n" // = x
-                "sub    $4, %%ebx                  \n"
-                "1:                                \n" //l1:
-                "mov    (%%ecx,%%ebx), %%esi       \n"
-                "xor %%ebx, %%esi                  \n"
-                "rol $4, %%edx                     \n"
-                "add %%esi, %%edx                  \n"
-                "sub    $4, %%ebx                  \n"
-                "jge 1b                            \n" //jge l1
-                "xor %%eax, %%esi                  \n"
-                "add %%esi, %%edx                  \n"
-                "add %4, %%ecx                     \n"
-                "dec %%eax                         \n"
-                "jge 0b                            \n" //jge l2
-                
-                "mov    %2, %%ebx                  \n"
-                "mov    %%edx, %6                  \n"
-                "mov    %5, %%eax                  \n"
-                "mov    %7, %%ecx                  \n"
-                "mov    %8, %%edx                  \n"
-                "mov    %9, %%esi                  \n"
-                :
-                : "m"(pAsmStart), "m"(asmHeight), "m"(saveEBX), "m"(asmdwBytesPerLine), "m"(asmPitch), "m"(saveEAX), 
-                "m"(asmCRC), "m"(saveECX), "m"(saveEDX), "m"(saveESI)
-                : "memory", "cc"
-                );
-           dwAsmCRC = asmCRC;
-#endif
-        }
-        catch(...)
-        {
-            TRACE0("Exception in texture CRC calculation");
-        }
+        dwAsmCRC = CalculateTextureCRC(pPhysicalAddress, left, top, width, height, size, pitchInBytes, pMaxCI);
     }
     return dwAsmCRC;
 }
-unsigned char CalculateMaxCI(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes )
-{
-    uint32 x, y;
-    unsigned char *buf;
-    unsigned char val = 0;
-
-    if( TXT_SIZE_8b == size )
-    {
-        for( y = 0; y<height; y++ )
-        {
-            buf = (unsigned char*)pPhysicalAddress + left + pitchInBytes * (y+top);
-            for( x=0; x<width; x++ )
-            {
-                if( buf[x] > val )  val = buf[x];
-                if( val == 0xFF )
-                    return 0xFF;
-            }
-        }
-    }
-    else
-    {
-        unsigned char val1,val2;
-        left >>= 1;
-        width >>= 1;
-        for( y = 0; y<height; y++ )
-        {
-            buf = (unsigned char*)pPhysicalAddress + left + pitchInBytes * (y+top);
-            for( x=0; x<width; x++ )
-            {
-                val1 = buf[x]>>4;
-                val2 = buf[x]&0xF;
-                if( val1 > val )    val = val1;
-                if( val2 > val )    val = val2;
-                if( val == 0xF )
-                    return 0xF;
-            }
-        }
-    }
-
-    return val;
-}
 
 bool FrameBufferManager::FrameBufferInRDRAMCheckCRC()
 {
@@ -1882,47 +1669,25 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
         TXTRBUF_DUMP(DebuggerAppendMsg("Start at: 0x%X, from line %d to %d", startaddr-addr, startline, endline););
     }
 
-    int indexes[600];
-    {
-        float sx;
-        int sx0;
-        float ratio = bufWidth/(float)width;
-        for( uint32 j=0; j<width; j++ )
-        {
-            sx = j*ratio;
-            sx0 = int(sx+0.5);
-            indexes[j] = 4*sx0;
-        }
-    }
+    FrameBufferCopy copy;
+    copy.src = (uint8 *)buffer;
+    copy.srcPitch = bufPitch;
+    copy.srcWidth = bufWidth;
+    copy.srcHeight = bufHeight;
+    copy.dst = g_pRDRAMu8+addr;
+    copy.width = width;
+    copy.height = height;
+    copy.firstLine = startline;
+    copy.lastLine = endline;
+    copy.revTlut = NULL;
 
     if( siz == TXT_SIZE_16b )
     {
-        uint16 *frameBufferBase = (uint16*)(g_pRDRAMu8+addr);
-
         if( bufFmt==TEXTURE_FMT_A8R8G8B8 )
         {
-            int  sy0;
-            float ratio = bufHeight/(float)height;
-
-            for( uint32 i=startline; i<endline; i++ )
-            {
-                sy0 = int(i*ratio+0.5);
-
-                uint16 *pD = frameBufferBase + i * pitch;
-                uint8 *pS0 = (uint8 *)buffer + sy0 * bufPitch;
-
-                for( uint32 j=0; j<width; j++ )
-                {
-                    // Point
-                    uint8 r = pS0[indexes[j]+2];
-                    uint8 g = pS0[indexes[j]+1];
-                    uint8 b = pS0[indexes[j]+0];
-                    uint8 a = pS0[indexes[j]+3];
-
-                    // Liner
-                    *(pD+(j^1)) = ConvertRGBATo555( r, g, b, a);
-                }
-            }
+            copy.format = FB_COPY_RGBA5551;
+            copy.dstPitch = pitch;
+            CopyFrameBufferToN64(copy);
         }
         else
         {
@@ -1931,29 +1696,14 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
     }
     else if( siz == TXT_SIZE_8b && fmt == TXT_FMT_CI )
     {
-        uint8 *frameBufferBase = (uint8*)(g_pRDRAMu8+addr);
-
         if( bufFmt==TEXTURE_FMT_A8R8G8B8 )
         {
-            uint16 tempword;
             InitTlutReverseLookup();
 
-            for( uint32 i=startline; i<endline; i++ )
-            {
-                uint8 *pD = frameBufferBase + i * width;
-                uint8 *pS = (uint8 *)buffer + i*bufHeight/height * bufPitch;
-                for( uint32 j=0; j<width; j++ )
-                {
-                    int pos = 4*(j*bufWidth/width);
-                    tempword = ConvertRGBATo555((pS[pos+2]),        // Red
-                                                (pS[pos+1]),        // Green
-                                                (pS[pos+0]),        // Blue
-                                                (pS[pos+3]));       // Alpha
-                    
-                    //*pD = CIFindIndex(tempword);
-                    *(pD+(j^3)) = RevTlutTable[tempword];
-                }
-            }
+            copy.format = FB_COPY_CI8;
+            copy.dstPitch = width;
+            copy.revTlut = RevTlutTable;
+            CopyFrameBufferToN64(copy);
         }
         else
         {
@@ -1963,31 +1713,11 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
     }
     else if( siz == TXT_SIZE_8b && fmt == TXT_FMT_I )
     {
-        uint8 *frameBufferBase = (uint8*)(g_pRDRAMu8+addr);
-
         if( bufFmt==TEXTURE_FMT_A8R8G8B8 )
         {
-            int sy0;
-            float ratio = bufHeight/(float)height;
-
-            for( uint32 i=startline; i<endline; i++ )
-            {
-                sy0 = int(i*ratio+0.5);
-
-                uint8 *pD = frameBufferBase + i * width;
-                uint8 *pS0 = (uint8 *)buffer + sy0 * bufPitch;
-
-                for( uint32 j=0; j<width; j++ )
-                {
-                    // Point
-                    uint32 r = pS0[indexes[j]+2];
-                    uint32 g = pS0[indexes[j]+1];
-                    uint32 b = pS0[indexes[j]+0];
-
-                    // Liner
-                    *(pD+(j^3)) = (uint8)((r+b+g)/3);
-                }
-            }
+            copy.format = FB_COPY_I8;
+            copy.dstPitch = width;
+            CopyFrameBufferToN64(copy);
         }
         else
         {
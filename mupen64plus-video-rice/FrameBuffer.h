@@ -137,7 +137,7 @@ extern int numOfTxtBufInfos;
 extern RecentCIInfo *g_uRecentCIInfoPtrs[5];
 extern uint8 RevTlutTable[0x10000];
 
-extern uint32 CalculateRDRAMCRC(void *pAddr, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes );
+extern uint32 CalculateRDRAMCRC(void *pAddr, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes, int *pMaxCI = NULL );
 extern uint16 ConvertRGBATo555(uint8 r, uint8 g, uint8 b, uint8 a);
 extern uint16 ConvertRGBATo555(uint32 color32);
 extern void InitTlutReverseLookup(void);
@@ -0,0 +1,335 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include <string.h>
+
+#include <vector>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#if defined(__SSE2__) && !defined(NO_ASM)
+#include <emmintrin.h>
+#define FB_COPY_SSE2
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FB_COPY_NEON
+#endif
+
+#include "FrameBufferCopy.h"
+
+#define FRAME_BUFFER_COPY_THREADS   2
+#define FRAME_BUFFER_COPY_BANDS     8       // per copy, more than the threads so the load evens out
+#define FRAME_BUFFER_COPY_MIN_LINES 16      // fewer lines are copied by the calling thread alone
+#define FRAME_BUFFER_COPY_CHUNK     256     // pixels of a line gathered at a time
+
+/****
+ Conversion
+
+ Same as ConvertRGBATo555(r,g,b,a) in FrameBuffer.cpp, on whole A8R8G8B8 pixels: the 5 upper bits of each color
+ channel, and the alpha bit set when the alpha is alphaMin or more.
+****/
+static inline uint16 PackRGBA5551(uint32 p, uint32 alphaMin)
+{
+    return (uint16)(((p>>8)&0xF800) | ((p>>5)&0x07C0) | ((p>>2)&0x003E) | ((p>>24) >= alphaMin ? 1 : 0));
+}
+
+// swap = 1 stores the pixels the way the 16b N64 frame buffer holds them in RDRAM (pixel j at j^1)
+static void PackRowRGBA5551(const uint32 *src, uint16 *dst, uint32 count, uint32 alphaMin, uint32 swap)
+{
+    uint32 j = 0;
+
+#if defined(FB_COPY_SSE2)
+    const __m128i redMask = _mm_set1_epi32(0xF800);
+    const __m128i greenMask = _mm_set1_epi32(0x07C0);
+    const __m128i blueMask = _mm_set1_epi32(0x003E);
+    const __m128i alphaBit = _mm_set1_epi32(1);
+    const __m128i alphaRef = _mm_set1_epi32((int)alphaMin - 1);
+
+    for( ; j+8 <= count; j+=8 )
+    {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(src+j));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(src+j+4));
+
+        __m128i c0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 8), redMask),
+                                               _mm_and_si128(_mm_srli_epi32(p0, 5), greenMask)),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 2), blueMask),
+                                               _mm_and_si128(_mm_cmpgt_epi32(_mm_srli_epi32(p0, 24), alphaRef), alphaBit)));
+        __m128i c1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 8), redMask),
+                                               _mm_and_si128(_mm_srli_epi32(p1, 5), greenMask)),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 2), blueMask),
+                                               _mm_and_si128(_mm_cmpgt_epi32(_mm_srli_epi32(p1, 24), alphaRef), alphaBit)));
+
+        // sign extended, so that the signed saturation of the pack keeps the 16 bits as they are
+        c0 = _mm_srai_epi32(_mm_slli_epi32(c0, 16), 16);
+        c1 = _mm_srai_epi32(_mm_slli_epi32(c1, 16), 16);
+        __m128i c = _mm_packs_epi32(c0, c1);
+        if( swap )
+        {
+            c = _mm_shufflelo_epi16(c, _MM_SHUFFLE(2,3,0,1));
+            c = _mm_shufflehi_epi16(c, _MM_SHUFFLE(2,3,0,1));
+        }
+        _mm_storeu_si128((__m128i*)(dst+j), c);
+    }
+#elif defined(FB_COPY_NEON)
+    const uint32x4_t redMask = vdupq_n_u32(0xF800);
+    const uint32x4_t greenMask = vdupq_n_u32(0x07C0);
+    const uint32x4_t blueMask = vdupq_n_u32(0x003E);
+    const uint32x4_t alphaBit = vdupq_n_u32(1);
+    const uint32x4_t alphaRef = vdupq_n_u32(alphaMin);
+
+    for( ; j+8 <= count; j+=8 )
+    {
+        uint32x4_t p0 = vld1q_u32(src+j);
+        uint32x4_t p1 = vld1q_u32(src+j+4);
+
+        uint32x4_t c0 = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(p0, 8), redMask),
+                                            vandq_u32(vshrq_n_u32(p0, 5), greenMask)),
+                                  vorrq_u32(vandq_u32(vshrq_n_u32(p0, 2), blueMask),
+                                            vandq_u32(vcgeq_u32(vshrq_n_u32(p0, 24), alphaRef), alphaBit)));
+        uint32x4_t c1 = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(p1, 8), redMask),
+                                            vandq_u32(vshrq_n_u32(p1, 5), greenMask)),
+                                  vorrq_u32(vandq_u32(vshrq_n_u32(p1, 2), blueMask),
+                                            vandq_u32(vcgeq_u32(vshrq_n_u32(p1, 24), alphaRef), alphaBit)));
+
+        uint16x8_t c = vcombine_u16(vmovn_u32(c0), vmovn_u32(c1));
+        if( swap )
+            c = vrev32q_u16(c);
+        vst1q_u16(dst+j, c);
+    }
+#endif
+
+    for( ; j<count; j++ )
+        dst[j^swap] = PackRGBA5551(src[j], alphaMin);
+}
+
+void ConvertRowToRGBA5551(const uint32 *src, uint16 *dst, uint32 count, uint32 alphaMin)
+{
+    PackRowRGBA5551(src, dst, count, alphaMin, 0);
+}
+
+
+/****
+ Scaling
+
+ The source pixel of each N64 pixel is looked up the way the copy always did it, so the written frame buffer doesn't
+ change: rounded float ratios for the 16b and the I8 formats, truncated integer ratios for CI8. The indexes are
+ clamped to the source buffer, which they could pass by one pixel when scaling down.
+****/
+static inline uint32 ScaledIndex(FrameBufferCopyFormat format, uint32 i, uint32 srcSize, uint32 size)
+{
+    uint32 s;
+    if( format == FB_COPY_CI8 )
+    {
+        s = i*srcSize/size;
+    }
+    else
+    {
+        float ratio = srcSize/(float)size;
+        float f = i*ratio;
+        s = (uint32)int(f+0.5);
+    }
+    return s < srcSize ? s : srcSize-1;
+}
+
+static std::vector<uint32> gFrameBufferCopyColumns;
+
+static void CopyFrameBufferLines(const FrameBufferCopy &copy, const uint32 *columns, bool sameWidth,
+                                 uint32 firstLine, uint32 lastLine)
+{
+    uint32 line[FRAME_BUFFER_COPY_CHUNK];
+    uint16 packed[FRAME_BUFFER_COPY_CHUNK];
+
+    for( uint32 i=firstLine; i<lastLine; i++ )
+    {
+        const uint32 *pS = (const uint32*)(copy.src + ScaledIndex(copy.format, i, copy.srcHeight, copy.height) * copy.srcPitch);
+
+        for( uint32 j0=0; j0<copy.width; j0+=FRAME_BUFFER_COPY_CHUNK )
+        {
+            uint32 count = copy.width-j0 < FRAME_BUFFER_COPY_CHUNK ? copy.width-j0 : FRAME_BUFFER_COPY_CHUNK;
+
+            // Point
+            const uint32 *pixels = pS + j0;
+            if( !sameWidth )
+            {
+                for( uint32 j=0; j<count; j++ )
+                    line[j] = pS[columns[j0+j]];
+                pixels = line;
+            }
+
+            switch( copy.format )
+            {
+            case FB_COPY_RGBA5551:
+                PackRowRGBA5551(pixels, (uint16*)copy.dst + i*copy.dstPitch + j0, count, 0x20, 1);
+                break;
+            case FB_COPY_CI8:
+                {
+                    uint8 *pD = copy.dst + i*copy.dstPitch + j0;
+                    PackRowRGBA5551(pixels, packed, count, 0x20, 0);
+                    for( uint32 j=0; j<count; j++ )
+                        pD[j^3] = copy.revTlut[packed[j]];
+                }
+                break;
+            case FB_COPY_I8:
+                {
+                    uint8 *pD = copy.dst + i*copy.dstPitch + j0;
+                    for( uint32 j=0; j<count; j++ )
+                    {
+                        uint32 p = pixels[j];
+                        pD[j^3] = (uint8)((((p>>16)&0xFF) + ((p>>8)&0xFF) + (p&0xFF))/3);
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+/****
+ Copy threads
+
+ Each band writes its own N64 lines and only reads the rendered buffer, so the bands of a copy can be converted at the
+ same time. The thread calling CopyFrameBufferToN64() converts bands too and returns once all of them are done, like
+ the texture enhancement threads in TextureFilters.cpp.
+****/
+typedef struct {
+    const FrameBufferCopy *copy;
+    const uint32 *columns;
+    bool        sameWidth;
+    uint32      nextBand;
+    uint32      bandsDone;
+} FrameBufferCopyJob;
+
+static FrameBufferCopyJob  *gFrameBufferCopyJob = NULL;
+static SDL_mutex           *gFrameBufferCopyMutex = NULL;
+static SDL_cond            *gFrameBufferCopyCond = NULL;
+static SDL_cond            *gFrameBufferCopyDoneCond = NULL;
+static SDL_Thread          *gFrameBufferCopyThreads[FRAME_BUFFER_COPY_THREADS];
+static bool                 gFrameBufferCopyQuit = false;
+
+// Copies the bands nobody has taken yet, called with gFrameBufferCopyMutex locked
+static void CopyFrameBufferBands(FrameBufferCopyJob *job)
+{
+    const FrameBufferCopy &copy = *job->copy;
+    uint32 lines = copy.lastLine - copy.firstLine;
+
+    while( job->nextBand < FRAME_BUFFER_COPY_BANDS )
+    {
+        uint32 band = job->nextBand++;
+        SDL_UnlockMutex(gFrameBufferCopyMutex);
+
+        CopyFrameBufferLines(copy, job->columns, job->sameWidth,
+                             copy.firstLine + lines * band / FRAME_BUFFER_COPY_BANDS,
+                             copy.firstLine + lines * (band + 1) / FRAME_BUFFER_COPY_BANDS);
+
+        SDL_LockMutex(gFrameBufferCopyMutex);
+        if( ++job->bandsDone == FRAME_BUFFER_COPY_BANDS )
+            SDL_CondSignal(gFrameBufferCopyDoneCond);
+    }
+}
+
+static int FrameBufferCopyThread(void *)
+{
+    SDL_LockMutex(gFrameBufferCopyMutex);
+    while( !gFrameBufferCopyQuit )
+    {
+        if( gFrameBufferCopyJob && gFrameBufferCopyJob->nextBand < FRAME_BUFFER_COPY_BANDS )
+            CopyFrameBufferBands(gFrameBufferCopyJob);
+        else
+            SDL_CondWait(gFrameBufferCopyCond, gFrameBufferCopyMutex);
+    }
+    SDL_UnlockMutex(gFrameBufferCopyMutex);
+    return 0;
+}
+
+static void StartFrameBufferCopyThreads(void)
+{
+    if( gFrameBufferCopyMutex )
+        return;
+
+    gFrameBufferCopyMutex = SDL_CreateMutex();
+    gFrameBufferCopyCond = SDL_CreateCond();
+    gFrameBufferCopyDoneCond = SDL_CreateCond();
+    gFrameBufferCopyQuit = false;
+    for( int i=0; i<FRAME_BUFFER_COPY_THREADS; i++ )
+#if SDL_VERSION_ATLEAST(2,0,0)
+        gFrameBufferCopyThreads[i] = SDL_CreateThread(FrameBufferCopyThread, "FrameBufferCopy", NULL);
+#else
+        gFrameBufferCopyThreads[i] = SDL_CreateThread(FrameBufferCopyThread, NULL);
+#endif
+}
+
+void StopFrameBufferCopyThreads(void)
+{
+    if( gFrameBufferCopyMutex == NULL )
+        return;
+
+    SDL_LockMutex(gFrameBufferCopyMutex);
+    gFrameBufferCopyQuit = true;
+    SDL_CondBroadcast(gFrameBufferCopyCond);
+    SDL_UnlockMutex(gFrameBufferCopyMutex);
+    for( int i=0; i<FRAME_BUFFER_COPY_THREADS; i++ )
+    {
+        if( gFrameBufferCopyThreads[i] )
+            SDL_WaitThread(gFrameBufferCopyThreads[i], NULL);
+        gFrameBufferCopyThreads[i] = NULL;
+    }
+    SDL_DestroyCond(gFrameBufferCopyDoneCond);
+    SDL_DestroyCond(gFrameBufferCopyCond);
+    SDL_DestroyMutex(gFrameBufferCopyMutex);
+    gFrameBufferCopyDoneCond = NULL;
+    gFrameBufferCopyCond = NULL;
+    gFrameBufferCopyMutex = NULL;
+}
+
+void CopyFrameBufferToN64(const FrameBufferCopy &copy, bool threaded)
+{
+    if( copy.firstLine >= copy.lastLine || copy.width == 0 || copy.srcWidth == 0 || copy.srcHeight == 0 )
+        return;
+
+    // the column map only depends on the sizes, it is kept for the next copy
+    if( gFrameBufferCopyColumns.size() < copy.width )
+        gFrameBufferCopyColumns.resize(copy.width);
+    for( uint32 j=0; j<copy.width; j++ )
+        gFrameBufferCopyColumns[j] = ScaledIndex(copy.format, j, copy.srcWidth, copy.width);
+
+    FrameBufferCopyJob job;
+    job.copy = &copy;
+    job.columns = &gFrameBufferCopyColumns[0];
+    job.sameWidth = copy.srcWidth == copy.width;
+    job.nextBand = 0;
+    job.bandsDone = 0;
+
+    if( !threaded || copy.lastLine - copy.firstLine < FRAME_BUFFER_COPY_MIN_LINES )
+    {
+        CopyFrameBufferLines(copy, job.columns, job.sameWidth, copy.firstLine, copy.lastLine);
+        return;
+    }
+
+    StartFrameBufferCopyThreads();
+    SDL_LockMutex(gFrameBufferCopyMutex);
+    gFrameBufferCopyJob = &job;
+    SDL_CondBroadcast(gFrameBufferCopyCond);
+    CopyFrameBufferBands(&job);
+    while( job.bandsDone < FRAME_BUFFER_COPY_BANDS )
+        SDL_CondWait(gFrameBufferCopyDoneCond, gFrameBufferCopyMutex);
+    gFrameBufferCopyJob = NULL;
+    SDL_UnlockMutex(gFrameBufferCopyMutex);
+}
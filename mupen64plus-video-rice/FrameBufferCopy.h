@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _FRAME_BUFFER_COPY_H_
+#define _FRAME_BUFFER_COPY_H_
+
+#include "typedefs.h"
+
+/****
+ Frame buffer write-back
+
+ Copies a rendered A8R8G8B8 buffer into an N64 frame buffer in RDRAM, scaling it to the N64 size with point sampling
+ and converting it to the N64 format, in the byte order RDRAM holds it in. The lines are split in bands which worker
+ threads and the calling thread convert at the same time; the conversion itself has SSE2 and NEON versions.
+ Nothing here depends on the rest of the plugin, so tools/fbcopybench.cpp can time it without a GPU.
+****/
+
+typedef enum {
+    FB_COPY_RGBA5551,       // 16b RGBA, alpha set from 0x20 up
+    FB_COPY_CI8,            // 8b color indexed, through a reverse TLUT
+    FB_COPY_I8,             // 8b intensity
+} FrameBufferCopyFormat;
+
+typedef struct {
+    FrameBufferCopyFormat format;
+    const uint8 *src;       // A8R8G8B8, in memory B, G, R, A
+    uint32  srcPitch;       // bytes
+    uint32  srcWidth;
+    uint32  srcHeight;
+    uint8  *dst;            // the N64 frame buffer
+    uint32  dstPitch;       // pixels
+    uint32  width;          // N64 frame buffer size
+    uint32  height;
+    uint32  firstLine;      // N64 lines to write
+    uint32  lastLine;
+    const uint8 *revTlut;   // FB_COPY_CI8: RGBA5551 color -> TLUT index, 0x10000 entries
+} FrameBufferCopy;
+
+void CopyFrameBufferToN64(const FrameBufferCopy &copy, bool threaded=true);
+void StopFrameBufferCopyThreads(void);
+
+// count A8R8G8B8 pixels to RGBA5551, alpha set from alphaMin up, in host order
+void ConvertRowToRGBA5551(const uint32 *src, uint16 *dst, uint32 count, uint32 alphaMin);
+
+#endif
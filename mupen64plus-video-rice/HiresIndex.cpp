@@ -0,0 +1,688 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <map>
+
+#include "osal_files.h"
+#include "HiresIndex.h"
+#include "Video.h"
+
+#include "liblinux/BMGLibPNG.h"
+#include "liblinux/BMGDLL.h"
+#include "liblinux/pngrw.h"
+
+#define SURFFMT_P8 41
+
+static bool HasSuffix(const char *name, const char *suffix)
+{
+    size_t len = strlen(name), suffixlen = strlen(suffix);
+    return len >= suffixlen && strcasecmp(name + len - suffixlen, suffix) == 0;
+}
+
+int GetImageInfoFromFile(char* pSrcFile, IMAGE_INFO *pSrcInfo)
+{
+    unsigned char sig[8];
+    FILE *f;
+
+    f = fopen(pSrcFile, "rb");
+    if (f == NULL)
+    {
+      DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile() error: couldn't open file '%s'", pSrcFile);
+      return 1;
+    }
+    if (fread(sig, 1, 8, f) != 8)
+    {
+      DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile() error: couldn't read first 8 bytes of file '%s'", pSrcFile);
+      fclose(f);
+      return 1;
+    }
+    fclose(f);
+
+    if(sig[0] == 'B' && sig[1] == 'M') // BMP
+    {
+        struct BMGImageStruct img;
+        memset(&img, 0, sizeof(BMGImageStruct));
+        BMG_Error code = ReadBMP(pSrcFile, &img);
+        if( code == BMG_OK )
+        {
+            pSrcInfo->Width = img.width;
+            pSrcInfo->Height = img.height;
+            pSrcInfo->Depth = img.bits_per_pixel;
+            pSrcInfo->MipLevels = 1;
+            if(img.bits_per_pixel == 32)
+                pSrcInfo->Format = SURFFMT_A8R8G8B8;
+            else if(img.bits_per_pixel == 8)
+                pSrcInfo->Format = SURFFMT_P8;
+            // Resource and File Format ignored
+            FreeBMGImage(&img);
+            return 0;
+        }
+        DebugMessage(M64MSG_ERROR, "Couldn't read BMP file '%s'; error = %i", pSrcFile, code);
+        return 1;
+    }
+    else if(sig[0] == 137 && sig[1] == 'P' && sig[2] == 'N' && sig[3] == 'G' && sig[4] == '\r' && sig[5] == '\n' &&
+               sig[6] == 26 && sig[7] == '\n') // PNG
+    {
+        struct BMGImageStruct img;
+        memset(&img, 0, sizeof(BMGImageStruct));
+        BMG_Error code = ReadPNGInfo(pSrcFile, &img);
+        if( code == BMG_OK )
+        {
+            pSrcInfo->Width = img.width;
+            pSrcInfo->Height = img.height;
+            pSrcInfo->Depth = img.bits_per_pixel;
+            pSrcInfo->MipLevels = 1;
+            if(img.bits_per_pixel == 32)
+                pSrcInfo->Format = SURFFMT_A8R8G8B8;
+            else if(img.bits_per_pixel == 8)
+                pSrcInfo->Format = SURFFMT_P8;
+            // Resource and File Format ignored
+            FreeBMGImage(&img);
+            return 0;
+        }
+        DebugMessage(M64MSG_ERROR, "Couldn't read PNG file '%s'; error = %i", pSrcFile, code);
+        return 1;
+    }
+
+    DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile : unknown file format (%s)", pSrcFile);
+    return 1;
+}
+
+BOOL PathFileExists(char* pszPath)
+{
+    FILE *f;
+    f = fopen(pszPath, "rb");
+    if(f != NULL)
+    {
+        fclose(f);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static long long GetFileSize(const char *filename)
+{
+    struct stat st;
+    if (stat(filename, &st) != 0)
+        return -1;
+    return (long long) st.st_size;
+}
+
+static long long GetFileModTime(const char *filename)
+{
+    struct stat st;
+    if (stat(filename, &st) != 0)
+        return -1;
+    return (long long) st.st_mtime;
+}
+
+void FreeTxtrInfoNames(ExtTxtrInfo &info)
+{
+    delete [] info.foldername;
+    delete [] info.filename;
+    delete [] info.filename_a;
+}
+
+/********************************************************************************************************************
+ * Truncates the current list with information about hires textures and scans the hires folder for hires textures and
+ * creates a list with records of properties of the hires textures.
+ * parameter:
+ * foldername: the folder that should be scaned for valid hires textures.
+ * found: the records of the found hires textures are appended to this array, in the order they are found.
+ * folders: every scanned folder is appended to this array together with its modification time.
+ * extraCheck: ?
+ * bRecursive: flag that indicates if also subfolders should be scanned for hires textures
+ * bCacheTextures: flag that indicates if the identified hires textures should also be cached
+ * bMainFolder: indicates if the folder is the main folder that will be scanned. That way, texture counting does not
+ *              start at 1 each time a subfolder is accessed. (microdev: I know that is not important but it really
+ *              bugged me ;-))
+ * return:
+ * found: the records of the identified hires textures. Duplicates are only removed by SortScannedTextures().
+ ********************************************************************************************************************/
+void ScanTexturesFromFolder(char *foldername, const char *gameName, bool bCRCOnly, std::vector<ScannedTxtr> &found,
+                            std::vector<ScannedFolder> &folders, bool extraCheck, bool bRecursive)
+{
+    // check if folder actually exists
+    if (!osal_is_directory(foldername))
+        return;
+
+    folders.push_back(ScannedFolder(foldername, GetFileModTime(foldername)));
+
+    // the path of the texture
+    char texturefilename[PATH_MAX];
+    //
+    IMAGE_INFO  imgInfo;
+    //
+    IMAGE_INFO  imgInfo2;
+
+    void *dir;
+    dir = osal_search_dir_open(foldername);
+    const char *foundfilename;
+
+    int crc, palcrc32;
+    unsigned int fmt, siz;
+    char crcstr[16], crcstr2[16];
+
+    do
+    {
+        foundfilename = osal_search_dir_read_next(dir);
+
+        // The array is empty,  break the current operation
+        if (foundfilename == NULL)
+            break;
+        // The current file is a hidden one
+        if (foundfilename[0] == '.' )
+            // These files we don't need
+            continue;
+
+        // Get the folder name
+        strcpy(texturefilename, foldername);
+        // And append the file name
+        strcat(texturefilename, foundfilename);
+
+        // Check if the current file is a directory and if recursive scanning is enabled
+        if (osal_is_directory(texturefilename) && bRecursive )
+        {
+            // Add file-separator
+            strcat(texturefilename, OSAL_DIR_SEPARATOR_STR);
+            // Scan detected folder for hires textures (recursive call)
+            ScanTexturesFromFolder(texturefilename, gameName, bCRCOnly, found, folders, extraCheck, bRecursive);
+            continue;
+        }
+        // well, the current file is actually no file (probably a directory & recursive scanning is not enabled)
+        if( strstr(foundfilename,gameName) == 0 )
+            // go on with the next one
+            continue;
+
+        TextureType type = NO_TEXTURE;
+        bool bSeparatedAlpha = false;
+
+        // Detect the texture type by it's extention
+        // microdev: this is not the smartest way. Should be done by header analysis if possible
+        if( HasSuffix(foundfilename, "_ci.bmp") )
+        {
+            // Identify type
+            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0)
+            {
+                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
+                continue;
+            }
+
+            if( imgInfo.Format == SURFFMT_P8 )
+                // and store it to the record
+                type = COLOR_INDEXED_BMP;
+            else
+                // Type is not supported, go on with the next one
+                continue;
+        }
+        // Detect the texture type by its extention
+        else if( HasSuffix(foundfilename, "_ciByRGBA.png") )
+        {
+            // Identify type
+            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
+            {
+                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
+                continue;
+            }
+
+            if( imgInfo.Format == SURFFMT_A8R8G8B8 )
+                // and store it to the record
+                type = RGBA_PNG_FOR_CI;
+            else
+                // Type is not supported, go on with the next one
+                continue;
+        }
+        // Detect the texture type by its extention
+        else if( HasSuffix(foundfilename, "_allciByRGBA.png") )
+        {
+            // Identify type
+            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
+            {
+                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
+                continue;
+            }
+            if( imgInfo.Format == SURFFMT_A8R8G8B8 )
+                // and store it to the record
+                type = RGBA_PNG_FOR_ALL_CI;
+            else
+                // Type not supported, go on with next one
+                continue;
+        }
+        // Detect the texture type by its extention
+        else if( HasSuffix(foundfilename, "_rgb.png") )
+        {
+            // Identify type
+            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
+            {
+                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
+                continue;
+            }
+
+            // Store type to the record
+            type = RGB_PNG;
+
+            char filename2[PATH_MAX];
+            // Assemble the file name for the separate alpha channel file
+            strcpy(filename2,texturefilename);
+            strcpy(filename2+strlen(filename2)-8,"_a.png");
+            // Check if the file actually exists
+            if( PathFileExists(filename2) )
+            {
+                // Check if the file with this name is actually a texture (well an alpha channel one)
+                if( GetImageInfoFromFile(filename2, &imgInfo2) != 0 )
+                {
+                    // Nope, it isn't. => Go on with the next file
+                    DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", filename2);
+                    continue;
+                }
+                
+                // Yes it is a texture file. Check if the size of the alpha channel is the same as the one of the texture
+                if( extraCheck && (imgInfo2.Width != imgInfo.Width || imgInfo2.Height != imgInfo.Height) )
+                {
+                    // Nope, it isn't => go on with next file
+                    DebugMessage(M64MSG_WARNING, "RGB and alpha texture size mismatch: %s", filename2);
+                    continue;
+                }
+
+                bSeparatedAlpha = true;
+            }
+        }
+        // Detect the texture type by its extention
+        else if( HasSuffix(foundfilename, "_all.png") )
+        {
+            // Check if texture is of expected type
+            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
+            {
+                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
+                // Nope, continue with next file
+                continue;
+            }
+
+            // Indicate file type
+            type = RGB_WITH_ALPHA_TOGETHER_PNG;
+        }
+    
+        // If a known texture format has been detected...
+        if( type != NO_TEXTURE )
+        {
+        /*
+            Try to read image information here.
+
+            (CASTLEVANIA2)#(58E2333F)#(2)#(0)#(D7A5C6D9)_ciByRGBA.png
+            (------1-----)#(---2----)#(3)#(4)#(---5----)_ciByRGBA.png
+ 
+            1. Internal ROM name
+            2. The DRAM CRC
+            3. The image pixel size (8b=0, 16b=1, 24b=2, 32b=3)
+            4. The texture format (RGBA=0, YUV=1, CI=2, IA=3, I=4)
+            5. The palette CRC
+
+            <internal Rom name>#<DRAM CRC>#<24bit>#<RGBA>#<PAL CRC>_ciByRGBA.png
+            */
+
+            // Get the actual file name
+            strcpy(texturefilename, foundfilename);
+            // Place the pointer before the DRAM-CRC (first occurrence of '#')
+            char *ptr = strchr(texturefilename,'#');
+            // Terminate the string ('0' means end of string - or in this case begin of string)
+            *ptr++ = 0;
+            if( type == RGBA_PNG_FOR_CI )
+            {
+                // Extract the information from the file name; information is:
+                // <DRAM(or texture)-CRC><texture type><texture format><PAL(or palette)-CRC>
+                sscanf(ptr,"%8c#%d#%d#%8c", crcstr, &fmt, &siz,crcstr2);
+                // Terminate the ascii represntation of the palette crc
+                crcstr2[8] = 0;
+                // Transform the ascii presentation of the hex value to an unsigned integer
+                palcrc32 = strtoul(crcstr2,NULL,16);
+            }
+            else
+            {
+                // Extract the information from the file name - this file does not have a palette crc; information is:
+                // <DRAM(or texture)-CRC><texture type><texture format>
+                // o gosh, commenting source code is really boring - but necessary!! Thus do it! (and don't use drugs ;-))
+                sscanf(ptr,"%8c#%d#%d", crcstr, &fmt, &siz);
+                // Use dummy for palette crc - that way each texture can be handled in a heterogeneous way
+                palcrc32 = 0xFFFFFFFF;
+            }
+            // Terminate the ascii represntation of the texture crc
+            crcstr[8]=0;
+            // Transform the ascii presentation of the hex value to an unsigned integer
+            crc = strtoul(crcstr,NULL,16);
+
+            // Create a new entry
+            ScannedTxtr newtxtr;
+            ExtTxtrInfo &newinfo = newtxtr.info;
+            // Store the width
+            newinfo.width = imgInfo.Width;
+            // Store the height
+            newinfo.height = imgInfo.Height;
+            // Store the name of the folder it has been found in
+            newinfo.foldername = new char[strlen(foldername)+1];
+            strcpy(newinfo.foldername,foldername);
+            // store the filename
+            newinfo.filename = strdup(foundfilename);
+            newinfo.filename_a = NULL;
+            // Store the format
+            newinfo.fmt = fmt;
+            // Store the size (bit-size, not texture size)
+            newinfo.siz = siz;
+            // Store DRAM (texture) CRC
+            newinfo.crc32 = crc;
+            // Store PAL (palette) CRC (the actual one, or the dummy value ('FFFFFFFF'))
+            newinfo.pal_crc32 = palcrc32;
+            // Store the texture type
+            newinfo.type = type;
+            //Indicate if there is a separate alpha file that has to be loaded
+            newinfo.bSeparatedAlpha = bSeparatedAlpha;
+            newinfo.packIndex = -1;
+            strcpy(texturefilename, foldername);
+            strcat(texturefilename, foundfilename);
+            newtxtr.size = GetFileSize(texturefilename);
+            newtxtr.size_a = -1;
+            if (bSeparatedAlpha) {
+                char filename2[PATH_MAX];
+                strcpy(filename2, foundfilename);
+                strcpy(filename2+strlen(filename2)-8,"_a.png");
+                newinfo.filename_a = strdup(filename2);
+                strcpy(texturefilename+strlen(texturefilename)-8,"_a.png");
+                newtxtr.size_a = GetFileSize(texturefilename);
+            }
+            // Generate the key for the record describing the hires texture.
+            // This key is used to find it back in the list
+            // The key format is: <DRAM(texture)-CRC-8byte><PAL(palette)-CRC-6byte(2bytes have been truncated to have space for format and size)><format-1byte><size-1byte>
+            uint64 crc64 = newinfo.crc32;
+            crc64 <<= 32;
+            if (bCRCOnly)
+                crc64 |= newinfo.pal_crc32&0xFFFFFFFF;
+            else
+                crc64 |= (newinfo.pal_crc32&0xFFFFFF00)|(newinfo.fmt<<4)|newinfo.siz;
+            newtxtr.key = crc64;
+            found.push_back(newtxtr);
+        }
+    } while(foundfilename != NULL);
+
+    osal_search_dir_close(dir);
+}
+
+static bool CompareScannedTxtr(const ScannedTxtr &a, const ScannedTxtr &b)
+{
+    return a.key < b.key;
+}
+
+/********************************************************************************************************************
+ * Sorts the scanned textures by key and drops the duplicates, in O(n log n).
+ * A texture is skipped if one with the same CRCs and type was found before it, and when two textures end up with the
+ * same key the one found last wins, just like when they were added one by one to the sorted list.
+ ********************************************************************************************************************/
+void SortScannedTextures(std::vector<ScannedTxtr> &found)
+{
+    std::map<uint64,TextureType> seen;
+    std::vector<ScannedTxtr> kept;
+    kept.reserve(found.size());
+
+    for( size_t i=0; i<found.size(); i++ )
+    {
+        ExtTxtrInfo &info = found[i].info;
+        uint64 id = ((uint64)(uint32)info.crc32 << 32) | (uint32)info.pal_crc32;
+        std::map<uint64,TextureType>::iterator it = seen.find(id);
+        if( it != seen.end() && it->second == info.type )
+        {
+            FreeTxtrInfoNames(info);
+            continue;
+        }
+        if( it == seen.end() )
+            seen[id] = info.type;
+        kept.push_back(found[i]);
+    }
+
+    std::stable_sort(kept.begin(), kept.end(), CompareScannedTxtr);
+
+    found.clear();
+    for( size_t i=0; i<kept.size(); i++ )
+    {
+        if( i+1 < kept.size() && kept[i+1].key == kept[i].key )
+        {
+            FreeTxtrInfoNames(kept[i].info);
+            continue;
+        }
+        found.push_back(kept[i]);
+    }
+}
+
+void AddScannedTextures(std::vector<ScannedTxtr> &found, CSortedList<uint64,ExtTxtrInfo> &infos)
+{
+    // the array is sorted, so every add() is an append
+    infos.reserve(infos.size() + (int)found.size());
+    for( size_t i=0; i<found.size(); i++ )
+        infos.add(found[i].key, found[i].info);
+}
+
+
+// Index file: HiresIndexHeader, HiresIndexFolder[folderCount], HiresIndexEntry[entryCount] sorted by key, strings
+#define HIRES_INDEX_MAGIC   "RiceHIdx"
+#define HIRES_INDEX_VERSION 1
+#define HIRES_INDEX_NONE    0xFFFFFFFF
+
+typedef struct {
+    char         magic[8];
+    unsigned int version;
+    unsigned int crcOnly;       // bLoadHiResCRCOnly changes the keys
+    unsigned int folderCount;
+    unsigned int entryCount;
+    unsigned int stringsSize;
+    unsigned int reserved;
+} HiresIndexHeader;
+
+typedef struct {
+    long long    mtime;
+    unsigned int path;          // offset in the string table
+    unsigned int reserved;
+} HiresIndexFolder;
+
+typedef struct {
+    uint64       key;
+    long long    size;
+    long long    size_a;
+    unsigned int width;
+    unsigned int height;
+    int          fmt;
+    int          siz;
+    int          crc32;
+    int          pal_crc32;
+    unsigned int type;
+    unsigned int bSeparatedAlpha;
+    unsigned int folder;        // index in the folder table
+    unsigned int filename;      // offsets in the string table
+    unsigned int filename_a;
+    unsigned int reserved;
+} HiresIndexEntry;
+
+char *CopyIndexString(const char *strings, unsigned int offset)
+{
+    char *str = new char[strlen(strings + offset) + 1];
+    strcpy(str, strings + offset);
+    return str;
+}
+
+bool LoadHiresIndex(const char *indexname, const char *foldername, bool bCRCOnly, CSortedList<uint64,ExtTxtrInfo> &infos)
+{
+    FILE *f = fopen(indexname, "rb");
+    if (f == NULL)
+        return false;
+    fseek(f, 0L, SEEK_END);
+    long filelen = ftell(f);
+    fseek(f, 0L, SEEK_SET);
+    if (filelen < (long) sizeof(HiresIndexHeader))
+    {
+        fclose(f);
+        return false;
+    }
+    std::vector<char> data(filelen);
+    size_t nread = fread(&data[0], 1, filelen, f);
+    fclose(f);
+    if (nread != (size_t) filelen)
+        return false;
+
+    const HiresIndexHeader *header = (const HiresIndexHeader *) &data[0];
+    if (memcmp(header->magic, HIRES_INDEX_MAGIC, 8) != 0 || header->version != HIRES_INDEX_VERSION ||
+        header->crcOnly != (unsigned int) bCRCOnly || header->folderCount == 0 ||
+        (unsigned long long) filelen != sizeof(HiresIndexHeader) + header->folderCount * sizeof(HiresIndexFolder) +
+                                        (unsigned long long) header->entryCount * sizeof(HiresIndexEntry) + header->stringsSize ||
+        header->stringsSize == 0 || data[filelen-1] != 0)
+        return false;
+
+    const HiresIndexFolder *folders = (const HiresIndexFolder *) (header + 1);
+    const HiresIndexEntry *entries = (const HiresIndexEntry *) (folders + header->folderCount);
+    const char *strings = (const char *) (entries + header->entryCount);
+
+    // the pack has to be in the same place, and none of its folders may have changed
+    if (folders[0].path >= header->stringsSize || strcmp(strings + folders[0].path, foldername) != 0)
+        return false;
+    for (unsigned int i = 0; i < header->folderCount; i++)
+    {
+        if (folders[i].path >= header->stringsSize ||
+            GetFileModTime(strings + folders[i].path) != folders[i].mtime)
+            return false;
+    }
+
+    char path[PATH_MAX];
+    for (unsigned int i = 0; i < header->entryCount; i++)
+    {
+        const HiresIndexEntry &e = entries[i];
+        if (e.folder >= header->folderCount || e.filename >= header->stringsSize ||
+            (e.filename_a != HIRES_INDEX_NONE && e.filename_a >= header->stringsSize) ||
+            (i > 0 && entries[i-1].key >= e.key))
+            return false;
+        snprintf(path, PATH_MAX, "%s%s", strings + folders[e.folder].path, strings + e.filename);
+        if (GetFileSize(path) != e.size)
+            return false;
+        if (e.filename_a != HIRES_INDEX_NONE)
+        {
+            snprintf(path, PATH_MAX, "%s%s", strings + folders[e.folder].path, strings + e.filename_a);
+            if (GetFileSize(path) != e.size_a)
+                return false;
+        }
+    }
+
+    // the index is up to date: the entries are sorted, so they are simply appended to the list
+    infos.reserve(header->entryCount);
+    for (unsigned int i = 0; i < header->entryCount; i++)
+    {
+        const HiresIndexEntry &e = entries[i];
+        ExtTxtrInfo info;
+        info.width = e.width;
+        info.height = e.height;
+        info.fmt = e.fmt;
+        info.siz = e.siz;
+        info.crc32 = e.crc32;
+        info.pal_crc32 = e.pal_crc32;
+        info.type = (TextureType) e.type;
+        info.bSeparatedAlpha = e.bSeparatedAlpha != 0;
+        info.packIndex = -1;
+        info.foldername = CopyIndexString(strings, folders[e.folder].path);
+        info.filename = CopyIndexString(strings, e.filename);
+        info.filename_a = (e.filename_a != HIRES_INDEX_NONE) ? CopyIndexString(strings, e.filename_a) : NULL;
+        infos.add(e.key, info);
+    }
+
+    DebugMessage(M64MSG_INFO, "Loaded hi-res texture index '%s' (%u textures)", indexname, header->entryCount);
+    return true;
+}
+
+static unsigned int AddIndexString(std::vector<char> &strings, const char *str)
+{
+    unsigned int offset = (unsigned int) strings.size();
+    strings.insert(strings.end(), str, str + strlen(str) + 1);
+    return offset;
+}
+
+void SaveHiresIndex(const char *indexname, bool bCRCOnly, const std::vector<ScannedTxtr> &found,
+                    const std::vector<ScannedFolder> &folders)
+{
+    if (folders.empty())
+        return;
+
+    std::vector<char> strings;
+    std::vector<HiresIndexFolder> indexFolders(folders.size());
+    std::map<std::string,unsigned int> folderIdx;
+    for (size_t i = 0; i < folders.size(); i++)
+    {
+        memset(&indexFolders[i], 0, sizeof(HiresIndexFolder));
+        indexFolders[i].mtime = folders[i].second;
+        indexFolders[i].path = AddIndexString(strings, folders[i].first.c_str());
+        folderIdx[folders[i].first] = (unsigned int) i;
+    }
+
+    std::vector<HiresIndexEntry> entries(found.size());
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        const ExtTxtrInfo &info = found[i].info;
+        HiresIndexEntry &e = entries[i];
+        memset(&e, 0, sizeof(HiresIndexEntry));
+        e.key = found[i].key;
+        e.size = found[i].size;
+        e.size_a = found[i].size_a;
+        e.width = info.width;
+        e.height = info.height;
+        e.fmt = info.fmt;
+        e.siz = info.siz;
+        e.crc32 = info.crc32;
+        e.pal_crc32 = info.pal_crc32;
+        e.type = info.type;
+        e.bSeparatedAlpha = info.bSeparatedAlpha;
+        e.folder = folderIdx[info.foldername];
+        e.filename = AddIndexString(strings, info.filename);
+        e.filename_a = info.filename_a ? AddIndexString(strings, info.filename_a) : HIRES_INDEX_NONE;
+    }
+
+    HiresIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HIRES_INDEX_MAGIC, 8);
+    header.version = HIRES_INDEX_VERSION;
+    header.crcOnly = bCRCOnly;
+    header.folderCount = (unsigned int) indexFolders.size();
+    header.entryCount = (unsigned int) entries.size();
+    header.stringsSize = (unsigned int) strings.size();
+
+    FILE *f = fopen(indexname, "wb");
+    if (f == NULL)
+    {
+        DebugMessage(M64MSG_WARNING, "Couldn't write hi-res texture index '%s'", indexname);
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(&indexFolders[0], sizeof(HiresIndexFolder), indexFolders.size(), f) == indexFolders.size() &&
+              (entries.empty() || fwrite(&entries[0], sizeof(HiresIndexEntry), entries.size(), f) == entries.size()) &&
+              fwrite(&strings[0], 1, strings.size(), f) == strings.size();
+    fclose(f);
+    if (!ok)
+    {
+        DebugMessage(M64MSG_WARNING, "Couldn't write hi-res texture index '%s'", indexname);
+        remove(indexname);
+    }
+}
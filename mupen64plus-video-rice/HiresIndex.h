@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_INDEX_H_
+#define _HIRES_INDEX_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "typedefs.h"
+#include "CSortedList.h"
+
+/****
+ Hi-res texture scan and index
+
+ The hires_texture folder of a game is scanned for replacement images, whose CRCs, format and size are in their file
+ names. Scanning a big texture pack means opening every image to read its header, so the result of the scan is stored
+ in an index file in the user cache folder and reloaded with a single read on the next run. The index is thrown away
+ and rebuilt when the modification time of one of the scanned folders (files added, removed or renamed) or the size of
+ one of the image files (file replaced in place) has changed.
+
+ None of this needs a graphics context, so the hiresbench tool can run it on a synthetic pack.
+****/
+
+typedef enum _IMAGE_FILEFORMAT 
+{
+   XIFF_BMP = 0,
+     XIFF_JPG = 1,
+     XIFF_TGA = 2,
+     XIFF_PNG = 3,
+     XIFF_DDS = 4,
+     XIFF_PPM = 5,
+     XIFF_DIB = 6,
+     XIFF_HDR = 7,
+     XIFF_PFM = 8,
+     XIFF_FORCE_DWORD = 0x7fffffff
+} IMAGE_FILEFORMAT;
+
+typedef struct _IMAGE_INFO
+{
+   unsigned int Width;
+   unsigned int Height;
+   unsigned int Depth;
+   unsigned int MipLevels;
+   int          Format;  /* SURFFORMAT */
+   IMAGE_FILEFORMAT ImageFileFormat;
+} IMAGE_INFO;
+
+enum TextureType
+{
+    NO_TEXTURE,
+ RGB_PNG,
+ COLOR_INDEXED_BMP,
+ RGB_WITH_ALPHA_TOGETHER_PNG,
+ RGBA_PNG_FOR_CI,
+ RGBA_PNG_FOR_ALL_CI,
+};
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    int fmt;
+    int siz;
+    int crc32;
+    int pal_crc32;
+    char *foldername;
+    char *filename;
+    char *filename_a;
+    //char name[40];
+    TextureType type;
+    bool        bSeparatedAlpha;
+    int         packIndex;      // entry in gHiresPack, -1 for a texture file
+} ExtTxtrInfo;
+
+// A texture found while scanning a folder, before it is added to the sorted list
+typedef struct {
+    uint64      key;
+    ExtTxtrInfo info;
+    long long   size;       // file sizes, stored in the hires index to detect replaced files
+    long long   size_a;
+} ScannedTxtr;
+
+// A scanned folder and its modification time
+typedef std::pair<std::string, long long> ScannedFolder;
+
+int  GetImageInfoFromFile(char* pSrcFile, IMAGE_INFO *pSrcInfo);
+BOOL PathFileExists(char* pszPath);
+char *CopyIndexString(const char *strings, unsigned int offset);
+void FreeTxtrInfoNames(ExtTxtrInfo &info);
+
+// Appends the textures of gameName found in foldername (and its sub-folders if bRecursive) to found, in the order
+// they are found, and every scanned folder to folders. The keys include the palette CRC only if bCRCOnly.
+void ScanTexturesFromFolder(char *foldername, const char *gameName, bool bCRCOnly, std::vector<ScannedTxtr> &found,
+                            std::vector<ScannedFolder> &folders, bool extraCheck, bool bRecursive);
+void SortScannedTextures(std::vector<ScannedTxtr> &found);
+void AddScannedTextures(std::vector<ScannedTxtr> &found, CSortedList<uint64,ExtTxtrInfo> &infos);
+
+// The index of the scan of foldername. LoadHiresIndex() appends its textures to infos if it is up to date.
+bool LoadHiresIndex(const char *indexname, const char *foldername, bool bCRCOnly, CSortedList<uint64,ExtTxtrInfo> &infos);
+void SaveHiresIndex(const char *indexname, bool bCRCOnly, const std::vector<ScannedTxtr> &found,
+                    const std::vector<ScannedFolder> &folders);
+
+#endif
@@ -0,0 +1,262 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <zlib.h>
+
+#include "HiresPack.h"
+
+CHiresPack::CHiresPack() :
+    m_pData(NULL),
+    m_dwSize(0),
+    m_bMapped(false),
+    m_pHeader(NULL),
+    m_pEntries(NULL),
+    m_pStaging(NULL),
+    m_dwStagingSize(0)
+{
+}
+
+CHiresPack::~CHiresPack()
+{
+    Close();
+}
+
+/********************************************************************************************************************
+ * Maps the pack file in memory (reads it on systems without mmap) and checks its tables. The image data is checked
+ * against the file size too, so a truncated pack is refused here rather than crashing when an image is used.
+ ********************************************************************************************************************/
+bool CHiresPack::Open(const char *filename)
+{
+    Close();
+
+#if defined(WIN32)
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL)
+        return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(f);
+        return false;
+    }
+    unsigned char *data = new unsigned char[size];
+    if (fread(data, 1, size, f) != (size_t)size)
+    {
+        delete [] data;
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    m_pData = data;
+    m_dwSize = size;
+    m_bMapped = false;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+    m_pData = (const unsigned char *) data;
+    m_dwSize = st.st_size;
+    m_bMapped = true;
+#endif
+
+    m_pHeader = (const HiresPackHeader *) m_pData;
+    m_pEntries = (const HiresPackEntry *) (m_pData + sizeof(HiresPackHeader));
+
+    bool ok = m_dwSize >= sizeof(HiresPackHeader) &&
+              memcmp(m_pHeader->magic, HIRES_PACK_MAGIC, sizeof(m_pHeader->magic)) == 0 &&
+              m_pHeader->version == HIRES_PACK_VERSION &&
+              sizeof(HiresPackHeader) + (unsigned long long)m_pHeader->numEntries * sizeof(HiresPackEntry) <= m_dwSize &&
+              (unsigned long long)m_pHeader->stringsOffset + m_pHeader->stringsSize <= m_dwSize &&
+              m_pHeader->stringsSize > 0 && m_pData[m_pHeader->stringsOffset + m_pHeader->stringsSize - 1] == 0;
+
+    for (unsigned int i = 0; ok && i < m_pHeader->numEntries; i++)
+    {
+        const HiresPackEntry &e = m_pEntries[i];
+        ok = (e.channels == 3 || e.channels == 4) &&
+             (unsigned long long)e.width * e.height * e.channels == e.rawSize &&
+             e.offset + e.size <= m_dwSize && e.offset % HIRES_PACK_ALIGN == 0 &&
+             ((e.flags & HIRES_PACK_COMPRESSED) || e.size == e.rawSize) &&
+             e.name < m_pHeader->stringsSize;
+    }
+
+    if (!ok)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CHiresPack::Close(void)
+{
+    if (m_pData)
+    {
+#if defined(WIN32)
+        delete [] (unsigned char *) m_pData;
+#else
+        if (m_bMapped)
+            munmap((void *) m_pData, m_dwSize);
+#endif
+    }
+
+    if (m_pStaging)
+        delete [] m_pStaging;
+
+    m_pData = NULL;
+    m_dwSize = 0;
+    m_bMapped = false;
+    m_pHeader = NULL;
+    m_pEntries = NULL;
+    m_pStaging = NULL;
+    m_dwStagingSize = 0;
+}
+
+const char *CHiresPack::GetEntryName(int i) const
+{
+    return (const char *) m_pData + m_pHeader->stringsOffset + m_pEntries[i].name;
+}
+
+const unsigned char *CHiresPack::GetImage(int i)
+{
+    const HiresPackEntry &e = m_pEntries[i];
+
+    // stored as is: no copy at all
+    if (!(e.flags & HIRES_PACK_COMPRESSED))
+        return m_pData + e.offset;
+
+    if (m_dwStagingSize < e.rawSize)
+    {
+        if (m_pStaging)
+            delete [] m_pStaging;
+        m_pStaging = new unsigned char[e.rawSize];
+        m_dwStagingSize = e.rawSize;
+    }
+
+    uLongf rawSize = e.rawSize;
+    if (uncompress(m_pStaging, &rawSize, m_pData + e.offset, e.size) != Z_OK || rawSize != e.rawSize)
+        return NULL;
+
+    return m_pStaging;
+}
+
+/********************************************************************************************************************
+ * Writes a pack with the given images. The images are compressed when asked to and when that saves at least an
+ * eighth of their size, otherwise they are stored as is so they can be used without a copy.
+ ********************************************************************************************************************/
+bool WriteHiresPack(const char *filename, std::vector<HiresPackImage> &images, bool bCompress)
+{
+    HiresPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HIRES_PACK_MAGIC, sizeof(header.magic));
+    header.version = HIRES_PACK_VERSION;
+    header.numEntries = (unsigned int) images.size();
+    header.stringsOffset = sizeof(HiresPackHeader) + header.numEntries * sizeof(HiresPackEntry);
+
+    std::vector<char> strings;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        images[i].entry.name = (unsigned int) strings.size();
+        strings.insert(strings.end(), images[i].name.begin(), images[i].name.end());
+        strings.push_back(0);
+    }
+    if (strings.empty())
+        strings.push_back(0);
+    header.stringsSize = (unsigned int) strings.size();
+
+    // compress the images and lay them out
+    std::vector< std::vector<unsigned char> > data(images.size());
+    unsigned long long offset = header.stringsOffset + header.stringsSize;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        HiresPackEntry &e = images[i].entry;
+        const std::vector<unsigned char> &image = images[i].image;
+        e.rawSize = (unsigned int) image.size();
+        e.flags &= ~HIRES_PACK_COMPRESSED;
+
+        if (bCompress && !image.empty())
+        {
+            uLongf size = compressBound(image.size());
+            data[i].resize(size);
+            if (compress2(&data[i][0], &size, &image[0], image.size(), Z_BEST_COMPRESSION) == Z_OK &&
+                size < image.size() - image.size() / 8)
+            {
+                data[i].resize(size);
+                e.flags |= HIRES_PACK_COMPRESSED;
+            }
+        }
+        if (!(e.flags & HIRES_PACK_COMPRESSED))
+            data[i] = image;
+
+        offset = (offset + HIRES_PACK_ALIGN - 1) & ~(unsigned long long)(HIRES_PACK_ALIGN - 1);
+        e.offset = offset;
+        e.size = (unsigned int) data[i].size();
+        offset += e.size;
+    }
+
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL)
+        return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (size_t i = 0; ok && i < images.size(); i++)
+        ok = fwrite(&images[i].entry, sizeof(HiresPackEntry), 1, f) == 1;
+    ok = ok && fwrite(&strings[0], strings.size(), 1, f) == 1;
+
+    static const unsigned char padding[HIRES_PACK_ALIGN] = { 0 };
+    unsigned long long pos = header.stringsOffset + header.stringsSize;
+    for (size_t i = 0; ok && i < images.size(); i++)
+    {
+        const HiresPackEntry &e = images[i].entry;
+        if (e.offset > pos)
+            ok = fwrite(padding, (size_t)(e.offset - pos), 1, f) == 1;
+        if (ok && e.size > 0)
+            ok = fwrite(&data[i][0], e.size, 1, f) == 1;
+        pos = e.offset + e.size;
+    }
+
+    if (fclose(f) != 0)
+        ok = false;
+    if (!ok)
+        remove(filename);
+    return ok;
+}
@@ -0,0 +1,113 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_PACK_H_
+#define _HIRES_PACK_H_
+
+#include <string>
+#include <vector>
+
+/****
+ Hi-res texture pack
+
+ A texture pack holds the hi-res replacements of a game already decoded, so they don't have to be read from PNG files
+ while the game is running. It is built offline from a hires_texture folder by the hirespack tool and is looked for at
+ hires_texture/<ROM name>.htp.
+
+ File layout (native byte order):
+   HiresPackHeader
+   HiresPackEntry[numEntries]
+   string table (file names of the source images, for the log)
+   image data, every image starting on a HIRES_PACK_ALIGN boundary
+
+ An image is stored the way the PNG loader hands it over: rows bottom-up, 3 bytes per pixel (RGB) or 4 bytes per pixel
+ (RGBA). An uncompressed image is used straight from the mapped file, a compressed one (zlib) is inflated first.
+
+ The pack doesn't use any GPU resources, so it can be read and checked without a graphics context.
+****/
+
+#define HIRES_PACK_MAGIC        "RiceHTP"
+#define HIRES_PACK_VERSION      1
+#define HIRES_PACK_ALIGN        16
+
+#define HIRES_PACK_COMPRESSED   1       // HiresPackEntry::flags
+
+typedef struct {
+    char         magic[8];
+    unsigned int version;
+    unsigned int numEntries;
+    unsigned int stringsOffset;
+    unsigned int stringsSize;
+    unsigned int reserved[2];   // keeps the entries 8 byte aligned
+} HiresPackHeader;
+
+typedef struct {
+    int                crc32;
+    int                pal_crc32;
+    int                fmt;
+    int                siz;
+    unsigned int       type;        // TextureType of the replacement
+    unsigned int       width;
+    unsigned int       height;
+    unsigned int       channels;    // 3 (RGB) or 4 (RGBA)
+    unsigned int       name;        // offset in the string table
+    unsigned int       flags;
+    unsigned long long offset;      // image data, from the start of the file
+    unsigned int       size;        // stored size
+    unsigned int       rawSize;     // decoded size, width*height*channels
+} HiresPackEntry;
+
+class CHiresPack
+{
+public:
+    CHiresPack();
+    ~CHiresPack();
+
+    bool Open(const char *filename);
+    void Close(void);
+    bool IsOpen(void) const { return m_pData != 0; }
+
+    int GetNumEntries(void) const { return m_pHeader ? (int)m_pHeader->numEntries : 0; }
+    const HiresPackEntry &GetEntry(int i) const { return m_pEntries[i]; }
+    const char *GetEntryName(int i) const;
+
+    // Returns the decoded image of entry i, or NULL if it is damaged. The pointer either points into the mapped file
+    // or into a staging buffer which is reused by the next call.
+    const unsigned char *GetImage(int i);
+
+private:
+    const unsigned char  *m_pData;
+    unsigned long long    m_dwSize;
+    bool                  m_bMapped;
+    const HiresPackHeader *m_pHeader;
+    const HiresPackEntry *m_pEntries;
+    unsigned char        *m_pStaging;
+    unsigned int          m_dwStagingSize;
+};
+
+// Pack writer, used by the hirespack tool
+typedef struct {
+    HiresPackEntry              entry;
+    std::string                 name;
+    std::vector<unsigned char>  image;      // decoded image, rawSize bytes
+} HiresPackImage;
+
+bool WriteHiresPack(const char *filename, std::vector<HiresPackImage> &images, bool bCompress);
+
+#endif
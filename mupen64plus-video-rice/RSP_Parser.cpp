@@ -892,7 +892,13 @@ void DLParser_Process(OSTask * pTask)
                 gDlistStack[gDlistStackPointer].pc, pgfx->words.w0, pgfx->words.w1, (gRSP.ucode!=5&&gRSP.ucode!=10)?ucodeNames_GBI1[(pgfx->words.w0>>24)]:ucodeNames_GBI2[(pgfx->words.w0>>24)]);
 #endif
             gDlistStack[gDlistStackPointer].pc += 8;
+#ifdef PROFILE_GBI
+            DLParser_ProfileBegin(pgfx->words.w0 >>24);
+#endif
             currentUcodeMap[pgfx->words.w0 >>24](pgfx);
+#ifdef PROFILE_GBI
+            DLParser_ProfileEnd();
+#endif
 
             if ( gDlistStackPointer >= 0 && --gDlistStack[gDlistStackPointer].countdown < 0 )
             {
@@ -921,6 +927,76 @@ void DLParser_Process(OSTask * pTask)
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
 
+#ifdef PROFILE_GBI
+// Time spent in each display list command, by command byte and by the names of the GBI1 or GBI2 table the debugger
+// uses. Loading a display list only pushes it on the stack, so a command's time doesn't include the ones it calls.
+typedef struct {
+    uint32  count;
+    uint64  nanoseconds;
+} DLProfileEntry;
+
+static DLProfileEntry gDLProfile[2][256];
+static DLProfileEntry *gDLProfileCurrent = NULL;
+static uint64 gDLProfileStart;
+
+static inline uint64 DLParser_ProfileNanoseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void DLParser_ProfileBegin(uint32 cmd)
+{
+    gDLProfileCurrent = &gDLProfile[(gRSP.ucode!=5&&gRSP.ucode!=10) ? 0 : 1][cmd];
+    gDLProfileStart = DLParser_ProfileNanoseconds();
+}
+
+void DLParser_ProfileEnd()
+{
+    gDLProfileCurrent->count++;
+    gDLProfileCurrent->nanoseconds += DLParser_ProfileNanoseconds() - gDLProfileStart;
+}
+
+static int DLParser_ProfileCompare(const void *a, const void *b)
+{
+    uint64 ta = (*(const DLProfileEntry * const *)a)->nanoseconds, tb = (*(const DLProfileEntry * const *)b)->nanoseconds;
+    return (ta < tb) - (ta > tb);
+}
+
+// Prints the commands which took the most time first, and forgets them
+void DLParser_ProfilePrint(FILE *file)
+{
+    DLProfileEntry *entries[2*256];
+    uint64 total = 0;
+    int count = 0;
+
+    for( int table=0; table<2; table++ )
+    {
+        for( int cmd=0; cmd<256; cmd++ )
+        {
+            if( gDLProfile[table][cmd].count != 0 )
+            {
+                entries[count++] = &gDLProfile[table][cmd];
+                total += gDLProfile[table][cmd].nanoseconds;
+            }
+        }
+    }
+    qsort(entries, count, sizeof(entries[0]), DLParser_ProfileCompare);
+
+    fprintf(file, "Display list commands: %.3f ms\n", total / 1000000.0);
+    for( int i=0; i<count; i++ )
+    {
+        int table = entries[i] >= gDLProfile[1] ? 1 : 0;
+        int cmd = (int)(entries[i] - gDLProfile[table]);
+        fprintf(file, "  %02X %-24s x %8u = %10.3f ms (%5.2f%%) %8.2f us each\n", cmd,
+            table ? ucodeNames_GBI2[cmd] : ucodeNames_GBI1[cmd], entries[i]->count, entries[i]->nanoseconds / 1000000.0,
+            100.0 * entries[i]->nanoseconds / total, entries[i]->nanoseconds / 1000.0 / entries[i]->count);
+    }
+    memset(gDLProfile, 0, sizeof(gDLProfile));
+}
+#endif
+
 void RDP_NOIMPL_Real(const char* op, uint32 word0, uint32 word1) 
 {
 #ifdef DEBUGGER
@@ -1663,7 +1739,13 @@ void RDP_DLParser_Process(void)
     {
         Gfx *pgfx = (Gfx*)&g_pRDRAMu32[(gDlistStack[gDlistStackPointer].pc>>2)];
         gDlistStack[gDlistStackPointer].pc += 8;
+#ifdef PROFILE_GBI
+        DLParser_ProfileBegin(pgfx->words.w0 >>24);
+#endif
         currentUcodeMap[pgfx->words.w0 >>24](pgfx);
+#ifdef PROFILE_GBI
+        DLParser_ProfileEnd();
+#endif
     }
 
     CRender::g_pRender->EndRendering();
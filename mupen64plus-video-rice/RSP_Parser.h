@@ -597,6 +597,12 @@ void RDP_Cleanup();
 void DLParser_Process(OSTask * pTask);
 void RDP_DLParser_Process(void);
 
+#ifdef PROFILE_GBI
+void DLParser_ProfileBegin(uint32 cmd);
+void DLParser_ProfileEnd();
+void DLParser_ProfilePrint(FILE *file);
+#endif
+
 void PrepareTextures();
 void RDP_InitRenderState();
 void DisplayVertexInfo(uint32 dwAddr, uint32 dwV0, uint32 dwN);
@@ -0,0 +1,275 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#include <string.h>
+
+#if defined(__SSE2__) && !defined(NO_ASM)
+#include <emmintrin.h>
+#define CRC_SSE2
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CRC_NEON
+#endif
+
+#include "typedefs.h"
+#include "RSP_Parser.h"
+#include "TextureCRC.h"
+
+#define CRC_ROTATE(crc)     (((crc) << 4) + (((crc) >> 28) & 15))
+
+// lines don't have to start on a word
+static inline uint32 LoadWord(const uint8 *p)
+{
+    uint32 w;
+    memcpy(&w, p, 4);
+    return w;
+}
+
+/****
+ CRC of a line, words from x = bytesPerLine-4 down to 0
+****/
+static inline uint32 LineCRC(const uint8 *pLine, int bytesPerLine, uint32 y, uint32 crc)
+{
+    uint32 esi = 0;
+    int x = bytesPerLine - 4;
+
+#if !defined(NO_ASM)
+    // The x86 assembly hashed one word even when the line is shorter than that, keep its CRCs
+    if( x < 0 )
+    {
+        esi = LoadWord(pLine + x) ^ (uint32)x;
+        crc = CRC_ROTATE(crc) + esi;
+    }
+#endif
+
+    while( x >= 12 )
+    {
+        uint32 w0 = LoadWord(pLine + x) ^ x;
+        uint32 w1 = LoadWord(pLine + x - 4) ^ (x - 4);
+        uint32 w2 = LoadWord(pLine + x - 8) ^ (x - 8);
+        uint32 w3 = LoadWord(pLine + x - 12) ^ (x - 12);
+        crc = CRC_ROTATE(crc) + w0;
+        crc = CRC_ROTATE(crc) + w1;
+        crc = CRC_ROTATE(crc) + w2;
+        crc = CRC_ROTATE(crc) + w3;
+        esi = w3;
+        x -= 16;
+    }
+    while( x >= 0 )
+    {
+        esi = LoadWord(pLine + x) ^ x;
+        crc = CRC_ROTATE(crc) + esi;
+        x -= 4;
+    }
+
+    esi ^= y;
+    return crc + esi;
+}
+
+/****
+ Max color index of a line
+****/
+#if defined(CRC_SSE2)
+static inline uint8 MaxByte(__m128i m)
+{
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 2));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 1));
+    return (uint8)_mm_cvtsi128_si32(m);
+}
+#elif defined(CRC_NEON)
+static inline uint8 MaxByte(uint8x16_t m)
+{
+    uint8x8_t m8 = vmax_u8(vget_low_u8(m), vget_high_u8(m));
+    m8 = vpmax_u8(m8, m8);
+    m8 = vpmax_u8(m8, m8);
+    m8 = vpmax_u8(m8, m8);
+    return vget_lane_u8(m8, 0);
+}
+#endif
+
+// 8b indices, one per byte
+static uint8 LineMaxCI8(const uint8 *pLine, uint32 count, uint8 val)
+{
+    uint32 x = 0;
+
+#if defined(CRC_SSE2)
+    if( count >= 16 )
+    {
+        __m128i m = _mm_setzero_si128();
+        for( ; x+16 <= count; x+=16 )
+            m = _mm_max_epu8(m, _mm_loadu_si128((const __m128i*)(pLine + x)));
+        uint8 v = MaxByte(m);
+        if( v > val )   val = v;
+    }
+#elif defined(CRC_NEON)
+    if( count >= 16 )
+    {
+        uint8x16_t m = vdupq_n_u8(0);
+        for( ; x+16 <= count; x+=16 )
+            m = vmaxq_u8(m, vld1q_u8(pLine + x));
+        uint8 v = MaxByte(m);
+        if( v > val )   val = v;
+    }
+#endif
+
+    for( ; x<count; x++ )
+    {
+        if( pLine[x] > val )    val = pLine[x];
+    }
+    return val;
+}
+
+// 4b indices, two per byte: the high nibbles are the max byte >> 4, the low ones the max of byte & 0xF
+static uint8 LineMaxCI4(const uint8 *pLine, uint32 count, uint8 val)
+{
+    uint32 x = 0;
+
+#if defined(CRC_SSE2)
+    if( count >= 16 )
+    {
+        const __m128i lowMask = _mm_set1_epi8(0x0F);
+        __m128i hi = _mm_setzero_si128();
+        __m128i lo = _mm_setzero_si128();
+        for( ; x+16 <= count; x+=16 )
+        {
+            __m128i b = _mm_loadu_si128((const __m128i*)(pLine + x));
+            hi = _mm_max_epu8(hi, b);
+            lo = _mm_max_epu8(lo, _mm_and_si128(b, lowMask));
+        }
+        uint8 v1 = MaxByte(hi) >> 4;
+        uint8 v2 = MaxByte(lo);
+        if( v1 > val )  val = v1;
+        if( v2 > val )  val = v2;
+    }
+#elif defined(CRC_NEON)
+    if( count >= 16 )
+    {
+        const uint8x16_t lowMask = vdupq_n_u8(0x0F);
+        uint8x16_t hi = vdupq_n_u8(0);
+        uint8x16_t lo = vdupq_n_u8(0);
+        for( ; x+16 <= count; x+=16 )
+        {
+            uint8x16_t b = vld1q_u8(pLine + x);
+            hi = vmaxq_u8(hi, b);
+            lo = vmaxq_u8(lo, vandq_u8(b, lowMask));
+        }
+        uint8 v1 = MaxByte(hi) >> 4;
+        uint8 v2 = MaxByte(lo);
+        if( v1 > val )  val = v1;
+        if( v2 > val )  val = v2;
+    }
+#endif
+
+    for( ; x<count; x++ )
+    {
+        uint8 val1 = pLine[x]>>4;
+        uint8 val2 = pLine[x]&0xF;
+        if( val1 > val )    val = val1;
+        if( val2 > val )    val = val2;
+    }
+    return val;
+}
+
+/****
+ Texture CRC and max CI
+****/
+uint32 CalculateTextureCRC(const void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes, int *pMaxCI)
+{
+    int bytesPerLine = ((width<<size)+1)/2;
+    const uint8 *pStart = (const uint8*)pPhysicalAddress + (top * pitchInBytes) + (((left<<size)+1)>>1);
+
+    // The CI bytes of a line aren't always the CRC ones, a 4b line starting on an odd texel takes its first byte
+    const uint8 *pCI = NULL;
+    uint32 ciCount = 0;
+    uint8 ciLast = 0;
+    uint8 val = 0;
+    if( pMaxCI != NULL )
+    {
+        if( size == TXT_SIZE_8b )
+        {
+            pCI = (const uint8*)pPhysicalAddress + left + pitchInBytes * top;
+            ciCount = width;
+            ciLast = 0xFF;
+        }
+        else
+        {
+            pCI = (const uint8*)pPhysicalAddress + (left>>1) + pitchInBytes * top;
+            ciCount = width>>1;
+            ciLast = 0xF;
+        }
+    }
+
+    uint32 crc = 0;
+    uint32 y = height - 1;
+    uint32 lines = height;
+#if !defined(NO_ASM)
+    // the assembly did a line even for no height, y = -1
+    if( lines == 0 )
+        lines = 1;
+#endif
+
+    for( ; lines > 0; lines--, y-- )
+    {
+        crc = LineCRC(pStart, bytesPerLine, y, crc);
+        pStart += pitchInBytes;
+
+        if( pCI != NULL && val != ciLast && y < height )    // not the line the assembly did for no height
+        {
+            val = size == TXT_SIZE_8b ? LineMaxCI8(pCI, ciCount, val) : LineMaxCI4(pCI, ciCount, val);
+            pCI += pitchInBytes;
+        }
+    }
+
+    if( pMaxCI != NULL )
+        *pMaxCI = val;
+    return crc;
+}
+
+unsigned char CalculateMaxCI(const void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes)
+{
+    uint32 y;
+    const uint8 *buf;
+    uint8 val = 0;
+
+    if( TXT_SIZE_8b == size )
+    {
+        for( y = 0; y<height; y++ )
+        {
+            buf = (const uint8*)pPhysicalAddress + left + pitchInBytes * (y+top);
+            val = LineMaxCI8(buf, width, val);
+            if( val == 0xFF )
+                return 0xFF;
+        }
+    }
+    else
+    {
+        left >>= 1;
+        width >>= 1;
+        for( y = 0; y<height; y++ )
+        {
+            buf = (const uint8*)pPhysicalAddress + left + pitchInBytes * (y+top);
+            val = LineMaxCI4(buf, width, val);
+            if( val == 0xF )
+                return 0xF;
+        }
+    }
+
+    return val;
+}
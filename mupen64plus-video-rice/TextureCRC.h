@@ -0,0 +1,42 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifndef _TEXTURE_CRC_H_
+#define _TEXTURE_CRC_H_
+
+#include "typedefs.h"
+
+/****
+ Texture CRC
+
+ The CRC of a texture is what the texture cache compares to see if the texture changed in RDRAM, and what hi-res
+ texture packs are named after, so its value must never change. Each word of a line is hashed with a rotate and an
+ add, from the last word to the first. The carries of the adds make every step depend on the one before, so it can't
+ be split across SIMD lanes without giving another value. It stays one scalar chain, unrolled (one instruction per
+ word on ARM), and the SIMD goes to the max color index of CI textures, found on each line while it is in the cache.
+ tools/crcbench.cpp checks both against the old code.
+****/
+
+// the CRC of every texel of the rect, as CalculateRDRAMCRC computes it without bFastTexCRC
+// if pMaxCI isn't NULL, it gets the biggest 4b or 8b color index of the rect too, as CalculateMaxCI
+uint32 CalculateTextureCRC(const void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes, int *pMaxCI = NULL);
+
+// the biggest color index of a 4b or 8b texture, 0xF or 0xFF as soon as it is found
+unsigned char CalculateMaxCI(const void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes);
+
+#endif
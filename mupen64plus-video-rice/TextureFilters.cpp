@@ -25,12 +25,17 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ConvertImage.h"
 #include "DeviceBuilder.h"
 #include "TextureFilters.h"
+#include "HiresIndex.h"
+#include "HiresPack.h"
 #include "Render.h"
 #include "Video.h"
 
 #include "liblinux/BMGLibPNG.h"
 #include "liblinux/BMGDLL.h"
 
+#include <SDL.h>
+#include <SDL_thread.h>
+
 #ifdef min
 #undef min
 #endif
@@ -39,7 +44,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #endif
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <algorithm>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
 
 
 /************************************************************************/
@@ -47,7 +57,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 /************************************************************************/
 // Basic 2x R8G8B8A8 filter with interpolation
 
-void Texture2x_32( DrawInfo &srcInfo, DrawInfo &destInfo)
+static void Texture2x_32_rows( DrawInfo &srcInfo, DrawInfo &destInfo, uint32 firstRow, uint32 lastRow)
 {
     uint32 *pDst1, *pDst2;
     uint32 *pSrc, *pSrc2;
@@ -72,7 +82,7 @@ void Texture2x_32( DrawInfo &srcInfo, DrawInfo &destInfo)
     uint32 a4 = 0;
 
 
-    for (uint32 ySrc = 0; ySrc < nHeight; ySrc++)
+    for (uint32 ySrc = firstRow; ySrc < lastRow; ySrc++)
     {
         pSrc = (uint32*)(((uint8*)srcInfo.lpSurface)+ySrc*srcInfo.lPitch);
         pSrc2 = (uint32*)(((uint8*)srcInfo.lpSurface)+(ySrc+1)*srcInfo.lPitch);
@@ -155,8 +165,13 @@ void Texture2x_32( DrawInfo &srcInfo, DrawInfo &destInfo)
     }
 }
 
+void Texture2x_32( DrawInfo &srcInfo, DrawInfo &destInfo)
+{
+    Texture2x_32_rows(srcInfo, destInfo, 0, srcInfo.dwHeight);
+}
+
 // Basic 2x R4G4B4A4 filter with interpolation
-void Texture2x_16( DrawInfo &srcInfo, DrawInfo &destInfo )
+static void Texture2x_16_rows( DrawInfo &srcInfo, DrawInfo &destInfo, uint32 firstRow, uint32 lastRow )
 {
     uint16 *pDst1, *pDst2;
     uint16 *pSrc, *pSrc2;
@@ -180,7 +195,7 @@ void Texture2x_16( DrawInfo &srcInfo, DrawInfo &destInfo )
     uint16 r4 = 0;
     uint16 a4 = 0;
 
-    for (uint16 ySrc = 0; ySrc < nHeight; ySrc++)
+    for (uint32 ySrc = firstRow; ySrc < lastRow; ySrc++)
     {
         pSrc = (uint16*)(((uint8*)srcInfo.lpSurface)+ySrc*srcInfo.lPitch);
         pSrc2 = (uint16*)(((uint8*)srcInfo.lpSurface)+(ySrc+1)*srcInfo.lPitch);
@@ -262,18 +277,19 @@ void Texture2x_16( DrawInfo &srcInfo, DrawInfo &destInfo )
     }
 }
 
+void Texture2x_16( DrawInfo &srcInfo, DrawInfo &destInfo )
+{
+    Texture2x_16_rows(srcInfo, destInfo, 0, srcInfo.dwHeight);
+}
+
 /************************************************************************/
 /* Sharpen filters                                                      */
 /************************************************************************/
-void SharpenFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
+// The sharpen and smooth filters work in place: rows firstRow to lastRow of pdata are filtered from pcopy, a copy of
+// the whole texture made before the first band is filtered
+static void SharpenFilter_32_rows(uint32 *pdata, const uint32 *pcopy, uint32 width, uint32 height, uint32 pitch, uint32 filter,
+                                  uint32 firstRow, uint32 lastRow)
 {
-    uint32 len=height*pitch;
-    uint32 *pcopy = new uint32[len];
-
-    if( !pcopy )    return;
-
-    memcpy(pcopy, pdata, len<<2);
-
     uint32 mul1, mul2, mul3, shift4;
     switch( filter )
     {
@@ -293,11 +309,12 @@ void SharpenFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch,
     }
 
     uint32 x,y,z;
-    uint32 *src1, *src2, *src3, *dest;
+    const uint32 *src1, *src2, *src3;
+    uint32 *dest;
     uint32 val[4];
     uint32 t1,t2,t3,t4,t5,t6,t7,t8,t9;
 
-    for( y=1; y<height-1; y++)
+    for( y=std::max(firstRow,1U); y<std::min(lastRow,height-1); y++)
     {
         dest = pdata+y*pitch;
         src1 = pcopy+(y-1)*pitch;
@@ -325,20 +342,24 @@ void SharpenFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch,
             dest[x] = val[0]|(val[1]<<8)|(val[2]<<16)|(val[3]<<24);
         }
     }
-    delete [] pcopy;
 }
 
-void SharpenFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
+void SharpenFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
 {
-    //return;   // Sharpen does not make sense for 16 bits
-
     uint32 len=height*pitch;
-    uint16 *pcopy = new uint16[len];
+    uint32 *pcopy = new uint32[len];
 
     if( !pcopy )    return;
 
-    memcpy(pcopy, pdata, len<<1);
+    memcpy(pcopy, pdata, len<<2);
+
+    SharpenFilter_32_rows(pdata, pcopy, width, height, pitch, filter, 0, height);
+    delete [] pcopy;
+}
 
+static void SharpenFilter_16_rows(uint16 *pdata, const uint16 *pcopy, uint32 width, uint32 height, uint32 pitch, uint32 filter,
+                                  uint32 firstRow, uint32 lastRow)
+{
     uint16 mul1, mul2, mul3, shift4;
     switch( filter )
     {
@@ -358,11 +379,12 @@ void SharpenFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch,
     }
 
     uint32 x,y,z;
-    uint16 *src1, *src2, *src3, *dest;
+    const uint16 *src1, *src2, *src3;
+    uint16 *dest;
     uint16 val[4];
     uint16 t1,t2,t3,t4,t5,t6,t7,t8,t9;
 
-    for( y=1; y<height-1; y++)
+    for( y=std::max(firstRow,1U); y<std::min(lastRow,height-1); y++)
     {
         dest = pdata+y*pitch;
         src1 = pcopy+(y-1)*pitch;
@@ -392,21 +414,29 @@ void SharpenFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch,
             dest[x] = val[0]|(val[1]<<4)|(val[2]<<8)|(val[3]<<12);
         }
     }
-    delete [] pcopy;
 }
 
-/************************************************************************/
-/* Smooth filters                                                       */
-/************************************************************************/
-void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
+void SharpenFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
 {
+    //return;   // Sharpen does not make sense for 16 bits
+
     uint32 len=height*pitch;
-    uint32 *pcopy = new uint32[len];
+    uint16 *pcopy = new uint16[len];
 
     if( !pcopy )    return;
 
-    memcpy(pcopy, pdata, len<<2);
+    memcpy(pcopy, pdata, len<<1);
+
+    SharpenFilter_16_rows(pdata, pcopy, width, height, pitch, filter, 0, height);
+    delete [] pcopy;
+}
 
+/************************************************************************/
+/* Smooth filters                                                       */
+/************************************************************************/
+static void SmoothFilter_32_rows(uint32 *pdata, const uint32 *pcopy, uint32 width, uint32 height, uint32 pitch, uint32 filter,
+                                 uint32 firstRow, uint32 lastRow)
+{
     uint32 mul1, mul2, mul3, shift4;
     switch( filter )
     {
@@ -438,13 +468,15 @@ void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, u
     }
 
     uint32 x,y,z;
-    uint32 *src1, *src2, *src3, *dest;
+    const uint32 *src1, *src2, *src3;
+    uint32 *dest;
     uint32 val[4];
     uint32 t1,t2,t3,t4,t5,t6,t7,t8,t9;
 
     if( filter == TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_3 || filter == TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_4 )
     {
-        for( y=1; y<height-1; y+=2)
+        // only the odd rows are filtered
+        for( y=std::max(firstRow,1U)|1; y<std::min(lastRow,height-1); y+=2)
         {
             dest = pdata+y*pitch;
             src1 = pcopy+(y-1)*pitch;
@@ -465,7 +497,7 @@ void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, u
     }
     else
     {
-        for( y=0; y<height; y++)
+        for( y=firstRow; y<lastRow; y++)
         {
             dest = pdata+y*pitch;
             if( y>0 )
@@ -500,19 +532,24 @@ void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, u
             }
         }
     }
-    delete [] pcopy;
 }
 
-void SmoothFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
+void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
 {
     uint32 len=height*pitch;
-    uint16 *pcopy = new uint16[len];
+    uint32 *pcopy = new uint32[len];
 
-    if( !pcopy )
-        return;
+    if( !pcopy )    return;
 
-    memcpy(pcopy, pdata, len<<1);
+    memcpy(pcopy, pdata, len<<2);
 
+    SmoothFilter_32_rows(pdata, pcopy, width, height, pitch, filter, 0, height);
+    delete [] pcopy;
+}
+
+static void SmoothFilter_16_rows(uint16 *pdata, const uint16 *pcopy, uint32 width, uint32 height, uint32 pitch, uint32 filter,
+                                 uint32 firstRow, uint32 lastRow)
+{
     uint16 mul1, mul2, mul3, shift4;
     switch( filter )
     {
@@ -544,13 +581,15 @@ void SmoothFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, u
     }
 
     uint32 x,y,z;
-    uint16 *src1, *src2, *src3, *dest;
+    const uint16 *src1, *src2, *src3;
+    uint16 *dest;
     uint16 val[4];
     uint16 t1,t2,t3,t4,t5,t6,t7,t8,t9;
 
     if( filter == TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_3 || filter == TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_4 )
     {
-        for( y=1; y<height-1; y+=2)
+        // only the odd rows are filtered
+        for( y=std::max(firstRow,1U)|1; y<std::min(lastRow,height-1); y+=2)
         {
             dest = pdata+y*pitch;
             src1 = pcopy+(y-1)*pitch;
@@ -572,7 +611,7 @@ void SmoothFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, u
     }
     else
     {
-        for( y=0; y<height; y++)
+        for( y=firstRow; y<lastRow; y++)
         {
             dest = pdata+y*pitch;
             if( y>0 )
@@ -608,10 +647,431 @@ void SmoothFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, u
             }
         }
     }
+}
+
+void SmoothFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter)
+{
+    uint32 len=height*pitch;
+    uint16 *pcopy = new uint16[len];
+
+    if( !pcopy )
+        return;
+
+    memcpy(pcopy, pdata, len<<1);
+
+    SmoothFilter_16_rows(pdata, pcopy, width, height, pitch, filter, 0, height);
     delete [] pcopy;
 }
 
 
+/****
+ Texture enhancement threads
+
+ The filters work on bands of rows: a band reads the rows around it from the source texture (the smooth and sharpen
+ filters from a copy of the texture they filter in place) and writes only its own rows, so the bands of a texture can
+ be filtered at the same time. The thread running EnhanceTexture() filters bands too and returns once all of them are
+ done, so nothing changes for the caller.
+****/
+#define TEXTURE_FILTER_THREADS      2
+#define TEXTURE_FILTER_BANDS        8       // per texture, more than the threads so the load evens out
+#define TEXTURE_FILTER_MIN_ROWS     16      // fewer rows are filtered by the calling thread alone
+
+typedef enum {
+    TEXTURE_FILTER_SCALE,
+    TEXTURE_FILTER_SMOOTH,
+    TEXTURE_FILTER_SHARPEN,
+} TextureFilterStage;
+
+typedef struct {
+    TextureFilterStage stage;
+    uint32      filter;         // options.textureEnhancement or options.textureEnhancementControl
+    uint32      pixelSize;
+    DrawInfo   *srcInfo;        // scaling
+    DrawInfo   *destInfo;
+    void       *pdata;          // smoothing and sharpening, in place
+    void       *pcopy;
+    uint32      width;
+    uint32      height;
+    uint32      pitch;
+    uint32      rows;           // rows split in bands
+    uint32      nextBand;
+    uint32      bandsDone;
+} TextureFilterJob;
+
+static TextureFilterJob    *gTextureFilterJob = NULL;
+static SDL_mutex           *gTextureFilterMutex = NULL;
+static SDL_cond            *gTextureFilterCond = NULL;
+static SDL_cond            *gTextureFilterDoneCond = NULL;
+static SDL_Thread          *gTextureFilterThreads[TEXTURE_FILTER_THREADS];
+static bool                 gTextureFilterQuit = false;
+
+static void FilterTextureRows(const TextureFilterJob &job, uint32 firstRow, uint32 lastRow)
+{
+    if( job.stage == TEXTURE_FILTER_SMOOTH )
+    {
+        if( job.pixelSize == 4 )
+            SmoothFilter_32_rows((uint32*)job.pdata, (uint32*)job.pcopy, job.width, job.height, job.pitch, job.filter, firstRow, lastRow);
+        else
+            SmoothFilter_16_rows((uint16*)job.pdata, (uint16*)job.pcopy, job.width, job.height, job.pitch, job.filter, firstRow, lastRow);
+        return;
+    }
+    else if( job.stage == TEXTURE_FILTER_SHARPEN )
+    {
+        if( job.pixelSize == 4 )
+            SharpenFilter_32_rows((uint32*)job.pdata, (uint32*)job.pcopy, job.width, job.height, job.pitch, job.filter, firstRow, lastRow);
+        else
+            SharpenFilter_16_rows((uint16*)job.pdata, (uint16*)job.pcopy, job.width, job.height, job.pitch, job.filter, firstRow, lastRow);
+        return;
+    }
+
+    DrawInfo &srcInfo = *job.srcInfo;
+    DrawInfo &destInfo = *job.destInfo;
+    uint32 nWidth = srcInfo.dwCreatedWidth;
+    uint32 realwidth = srcInfo.dwWidth;
+    uint32 realheight = srcInfo.dwHeight;
+
+    switch( job.filter )
+    {
+    case TEXTURE_2XSAI_ENHANCEMENT:
+        if( job.pixelSize == 4 )
+            Super2xSaI_32_rows((uint32*)(srcInfo.lpSurface),(uint32*)(destInfo.lpSurface), nWidth, realheight, nWidth, firstRow, lastRow);
+        else
+            Super2xSaI_16_rows((uint16*)(srcInfo.lpSurface),(uint16*)(destInfo.lpSurface), nWidth, realheight, nWidth, firstRow, lastRow);
+        break;
+    case TEXTURE_HQ2X_ENHANCEMENT:
+        if( job.pixelSize == 4 )
+            hq2x_32_rows((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight, firstRow, lastRow);
+        else
+            hq2x_16_rows((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight, firstRow, lastRow);
+        break;
+    case TEXTURE_LQ2X_ENHANCEMENT:
+        if( job.pixelSize == 4 )
+            lq2x_32_rows((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight, firstRow, lastRow);
+        else
+            lq2x_16_rows((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight, firstRow, lastRow);
+        break;
+    case TEXTURE_HQ4X_ENHANCEMENT:
+        if( job.pixelSize == 4 )
+            hq4x_32_rows((uint8*)(srcInfo.lpSurface), (uint8*)(destInfo.lpSurface), realwidth, realheight, nWidth, destInfo.lPitch, firstRow, lastRow);
+        else
+            hq4x_16_rows((uint8*)(srcInfo.lpSurface), (uint8*)(destInfo.lpSurface), realwidth, realheight, nWidth, destInfo.lPitch, firstRow, lastRow);
+        break;
+    default:
+        if( job.pixelSize == 4 )
+            Texture2x_32_rows(srcInfo, destInfo, firstRow, lastRow);
+        else
+            Texture2x_16_rows(srcInfo, destInfo, firstRow, lastRow);
+        break;
+    }
+}
+
+// Filters the bands nobody has taken yet, called with gTextureFilterMutex locked
+static void FilterTextureBands(TextureFilterJob *job)
+{
+    while( job->nextBand < TEXTURE_FILTER_BANDS )
+    {
+        uint32 band = job->nextBand++;
+        SDL_UnlockMutex(gTextureFilterMutex);
+
+        FilterTextureRows(*job, job->rows * band / TEXTURE_FILTER_BANDS, job->rows * (band + 1) / TEXTURE_FILTER_BANDS);
+
+        SDL_LockMutex(gTextureFilterMutex);
+        if( ++job->bandsDone == TEXTURE_FILTER_BANDS )
+            SDL_CondSignal(gTextureFilterDoneCond);
+    }
+}
+
+static int TextureFilterThread(void *)
+{
+    SDL_LockMutex(gTextureFilterMutex);
+    while( !gTextureFilterQuit )
+    {
+        if( gTextureFilterJob && gTextureFilterJob->nextBand < TEXTURE_FILTER_BANDS )
+            FilterTextureBands(gTextureFilterJob);
+        else
+            SDL_CondWait(gTextureFilterCond, gTextureFilterMutex);
+    }
+    SDL_UnlockMutex(gTextureFilterMutex);
+    return 0;
+}
+
+static void StartTextureFilterThreads(void)
+{
+    if( gTextureFilterMutex )
+        return;
+
+    gTextureFilterMutex = SDL_CreateMutex();
+    gTextureFilterCond = SDL_CreateCond();
+    gTextureFilterDoneCond = SDL_CreateCond();
+    gTextureFilterQuit = false;
+    for( int i=0; i<TEXTURE_FILTER_THREADS; i++ )
+#if SDL_VERSION_ATLEAST(2,0,0)
+        gTextureFilterThreads[i] = SDL_CreateThread(TextureFilterThread, "TextureFilter", NULL);
+#else
+        gTextureFilterThreads[i] = SDL_CreateThread(TextureFilterThread, NULL);
+#endif
+}
+
+static void StopTextureFilterThreads(void)
+{
+    if( gTextureFilterMutex == NULL )
+        return;
+
+    SDL_LockMutex(gTextureFilterMutex);
+    gTextureFilterQuit = true;
+    SDL_CondBroadcast(gTextureFilterCond);
+    SDL_UnlockMutex(gTextureFilterMutex);
+    for( int i=0; i<TEXTURE_FILTER_THREADS; i++ )
+    {
+        if( gTextureFilterThreads[i] )
+            SDL_WaitThread(gTextureFilterThreads[i], NULL);
+        gTextureFilterThreads[i] = NULL;
+    }
+    SDL_DestroyCond(gTextureFilterDoneCond);
+    SDL_DestroyCond(gTextureFilterCond);
+    SDL_DestroyMutex(gTextureFilterMutex);
+    gTextureFilterDoneCond = NULL;
+    gTextureFilterCond = NULL;
+    gTextureFilterMutex = NULL;
+}
+
+static void RunTextureFilter(TextureFilterJob &job)
+{
+    job.nextBand = 0;
+    job.bandsDone = 0;
+
+    if( job.rows < TEXTURE_FILTER_MIN_ROWS )
+    {
+        FilterTextureRows(job, 0, job.rows);
+        return;
+    }
+
+    StartTextureFilterThreads();
+    SDL_LockMutex(gTextureFilterMutex);
+    gTextureFilterJob = &job;
+    SDL_CondBroadcast(gTextureFilterCond);
+    FilterTextureBands(&job);
+    while( job.bandsDone < TEXTURE_FILTER_BANDS )
+        SDL_CondWait(gTextureFilterDoneCond, gTextureFilterMutex);
+    gTextureFilterJob = NULL;
+    SDL_UnlockMutex(gTextureFilterMutex);
+}
+
+// Smooths or sharpens a whole texture in place, the copy the bands are filtered from is shared by all of them
+static void RunInPlaceTextureFilter(TextureFilterStage stage, void *pdata, uint32 pixelSize, uint32 width, uint32 height,
+                                    uint32 pitch, uint32 filter)
+{
+    uint32 len = height*pitch*pixelSize;
+    uint8 *pcopy = new uint8[len];
+    memcpy(pcopy, pdata, len);
+
+    TextureFilterJob job;
+    memset(&job, 0, sizeof(job));
+    job.stage = stage;
+    job.filter = filter;
+    job.pixelSize = pixelSize;
+    job.pdata = pdata;
+    job.pcopy = pcopy;
+    job.width = width;
+    job.height = height;
+    job.pitch = pitch;
+    job.rows = height;
+    RunTextureFilter(job);
+
+    delete [] pcopy;
+}
+
+/****
+ Enhanced texture cache
+
+ The same texture is often enhanced again and again: the texture cache drops its entries after a while, or all of
+ them when the game loads a new level. The enhanced images are kept here within ENHANCED_CACHE_MAX_BYTES, the least
+ recently used ones are dropped first. The key is made of the CRCs of the texture (the ones the texture cache uses
+ plus the one of the converted image, which also depends on clamping and TLUT format) and of the filter settings.
+
+ With CacheEnhancedTextures, the images are also saved in <user cache>/enhanced_texture/<game name>/ and are read
+ back from there in the following sessions.
+****/
+#define ENHANCED_CACHE_MAX_BYTES    (16*1024*1024)
+#define ENHANCED_CACHE_MAGIC        "RiceETx"
+#define ENHANCED_CACHE_VERSION      1
+
+typedef struct {
+    uint32  dwCRC;
+    uint32  dwPalCRC;
+    uint32  dwImageCRC;
+    uint32  width;              // created size of the source texture
+    uint32  height;
+    uint32  realWidth;
+    uint32  realHeight;
+    uint32  pixelSize;
+    uint32  enhancement;
+    uint32  enhancementControl;
+} EnhancedTextureKey;
+
+struct EnhancedTextureKeyLess
+{
+    bool operator()(const EnhancedTextureKey &a, const EnhancedTextureKey &b) const
+    {
+        return memcmp(&a, &b, sizeof(EnhancedTextureKey)) < 0;
+    }
+};
+
+typedef std::list<EnhancedTextureKey> EnhancedTextureLRU;     // most recently used first
+
+typedef struct {
+    std::vector<uint8>  image;  // rows of the enhanced texture, pitch bytes each
+    uint32              pitch;
+    EnhancedTextureLRU::iterator lru;   // its place in gEnhancedTextureLRU
+} EnhancedTexture;
+
+typedef struct {
+    char                magic[8];
+    unsigned int        version;
+    unsigned int        pitch;
+    unsigned int        size;
+    unsigned int        reserved;
+    EnhancedTextureKey  key;
+} EnhancedTextureFileHeader;
+
+typedef std::map<EnhancedTextureKey, EnhancedTexture, EnhancedTextureKeyLess> EnhancedTextureMap;
+
+static EnhancedTextureMap   gEnhancedTextures;
+static EnhancedTextureLRU   gEnhancedTextureLRU;
+static unsigned int         gEnhancedTextureBytes = 0;
+
+static void GetEnhancedTextureFilename(char *filename, const EnhancedTextureKey &key)
+{
+    strncpy(filename, ConfigGetUserCachePath(), PATH_MAX);
+    filename[PATH_MAX] = 0;
+    if (filename[strlen(filename) - 1] != OSAL_DIR_SEPARATOR_CHAR)
+        strcat(filename, OSAL_DIR_SEPARATOR_STR);
+    strcat(filename, "enhanced_texture" OSAL_DIR_SEPARATOR_STR);
+    strcat(filename, (const char*)g_curRomInfo.szGameName);
+    strcat(filename, OSAL_DIR_SEPARATOR_STR);
+    osal_mkdirp(filename, 0700);
+    sprintf(filename + strlen(filename), "%08X_%08X_%08X_%ux%u_%ux%u_%u_%u_%u.etx", key.dwCRC, key.dwPalCRC,
+            key.dwImageCRC, key.width, key.height, key.realWidth, key.realHeight, key.pixelSize, key.enhancement,
+            key.enhancementControl);
+}
+
+static void FreeEnhancedTextures(uint32 maxBytes)
+{
+    while( gEnhancedTextureBytes > maxBytes && !gEnhancedTextureLRU.empty() )
+    {
+        EnhancedTextureMap::iterator oldest = gEnhancedTextures.find(gEnhancedTextureLRU.back());
+        gEnhancedTextureBytes -= oldest->second.image.size();
+        gEnhancedTextures.erase(oldest);
+        gEnhancedTextureLRU.pop_back();
+    }
+}
+
+static EnhancedTexture *AddEnhancedTexture(const EnhancedTextureKey &key, const uint8 *image, uint32 pitch, uint32 size)
+{
+    if( size > ENHANCED_CACHE_MAX_BYTES/4 )
+        return NULL;
+
+    FreeEnhancedTextures(ENHANCED_CACHE_MAX_BYTES - size);
+
+    std::pair<EnhancedTextureMap::iterator, bool> inserted = gEnhancedTextures.insert(std::make_pair(key, EnhancedTexture()));
+    EnhancedTexture &tex = inserted.first->second;
+    if( inserted.second )
+    {
+        gEnhancedTextureLRU.push_front(key);
+        tex.lru = gEnhancedTextureLRU.begin();
+    }
+    else
+    {
+        gEnhancedTextureBytes -= tex.image.size();
+        gEnhancedTextureLRU.splice(gEnhancedTextureLRU.begin(), gEnhancedTextureLRU, tex.lru);
+    }
+    tex.image.assign(image, image + size);
+    tex.pitch = pitch;
+    gEnhancedTextureBytes += size;
+    return &tex;
+}
+
+static EnhancedTexture *LoadEnhancedTexture(const EnhancedTextureKey &key)
+{
+    char filename[PATH_MAX + 128];
+    GetEnhancedTextureFilename(filename, key);
+
+    FILE *f = fopen(filename, "rb");
+    if( f == NULL )
+        return NULL;
+
+    EnhancedTexture *tex = NULL;
+    EnhancedTextureFileHeader header;
+    if( fread(&header, sizeof(header), 1, f) == 1 &&
+        memcmp(header.magic, ENHANCED_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+        header.version == ENHANCED_CACHE_VERSION && memcmp(&header.key, &key, sizeof(key)) == 0 &&
+        header.size <= ENHANCED_CACHE_MAX_BYTES/4 && header.pitch > 0 && header.size % header.pitch == 0 )
+    {
+        std::vector<uint8> image(header.size);
+        if( header.size > 0 && fread(&image[0], header.size, 1, f) == 1 )
+            tex = AddEnhancedTexture(key, &image[0], header.pitch, header.size);
+    }
+    fclose(f);
+
+    if( tex == NULL )
+        DebugMessage(M64MSG_WARNING, "Enhanced texture cache file '%s' is damaged", filename);
+    return tex;
+}
+
+static void SaveEnhancedTexture(const EnhancedTextureKey &key, const EnhancedTexture &tex)
+{
+    char filename[PATH_MAX + 128];
+    GetEnhancedTextureFilename(filename, key);
+
+    EnhancedTextureFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ENHANCED_CACHE_MAGIC, sizeof(header.magic));
+    header.version = ENHANCED_CACHE_VERSION;
+    header.pitch = tex.pitch;
+    header.size = tex.image.size();
+    header.key = key;
+
+    FILE *f = fopen(filename, "wb");
+    if( f == NULL )
+        return;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(&tex.image[0], tex.image.size(), 1, f) == 1;
+    if( fclose(f) != 0 || !ok )
+    {
+        DebugMessage(M64MSG_WARNING, "Can not write enhanced texture cache file '%s'", filename);
+        remove(filename);
+    }
+}
+
+static EnhancedTexture *FindEnhancedTexture(const EnhancedTextureKey &key)
+{
+    EnhancedTextureMap::iterator it = gEnhancedTextures.find(key);
+    if( it != gEnhancedTextures.end() )
+    {
+        gEnhancedTextureLRU.splice(gEnhancedTextureLRU.begin(), gEnhancedTextureLRU, it->second.lru);
+        return &it->second;
+    }
+
+    if( options.bCacheEnhancedTextures )
+        return LoadEnhancedTexture(key);
+    return NULL;
+}
+
+static void CopyEnhancedTexture(const EnhancedTexture &tex, DrawInfo &destInfo, uint32 rows)
+{
+    uint32 len = std::min(tex.pitch, (uint32)destInfo.lPitch);
+    rows = std::min(rows, (uint32)(tex.image.size() / tex.pitch));
+    for( uint32 y=0; y<rows; y++ )
+        memcpy((uint8*)destInfo.lpSurface + y*destInfo.lPitch, &tex.image[y*tex.pitch], len);
+}
+
+static void CloseEnhancedTextures(void)
+{
+    StopTextureFilterThreads();
+    gEnhancedTextures.clear();
+    gEnhancedTextureLRU.clear();
+    gEnhancedTextureBytes = 0;
+}
+
 void EnhanceTexture(TxtrCacheEntry *pEntry)
 {
     if( pEntry->dwEnhancementFlag == options.textureEnhancement )
@@ -648,14 +1108,12 @@ void EnhanceTexture(TxtrCacheEntry *pEntry)
     uint32 realheight = srcInfo.dwHeight;
     uint32 nWidth = srcInfo.dwCreatedWidth;
     uint32 nHeight = srcInfo.dwCreatedHeight;
+    uint32 pixelSize = pEntry->pTexture->GetPixelSize();
     
     //Sharpen option is enabled, sharpen the texture
     if( options.textureEnhancement == TEXTURE_SHARPEN_ENHANCEMENT || options.textureEnhancement == TEXTURE_SHARPEN_MORE_ENHANCEMENT )
     {
-        if( pEntry->pTexture->GetPixelSize() == 4 )
-            SharpenFilter_32((uint32*)srcInfo.lpSurface, nWidth, nHeight, nWidth, options.textureEnhancement);
-        else
-            SharpenFilter_16((uint16*)srcInfo.lpSurface, nWidth, nHeight, nWidth, options.textureEnhancement);
+        RunInPlaceTextureFilter(TEXTURE_FILTER_SHARPEN, srcInfo.lpSurface, pixelSize, nWidth, nHeight, nWidth, options.textureEnhancement);
         pEntry->dwEnhancementFlag = options.textureEnhancement;
         //End the draw update
         pEntry->pTexture->EndUpdate(&srcInfo);
@@ -679,107 +1137,67 @@ void EnhanceTexture(TxtrCacheEntry *pEntry)
         }
     }
 
-
-    CTexture* pSurfaceHandler = NULL;
-    if( options.textureEnhancement == TEXTURE_HQ4X_ENHANCEMENT )
-    {
-        if( nWidth + nHeight > 1024/4 )
-        {
-            // Don't enhance for large textures
-            pEntry->pTexture->EndUpdate(&srcInfo);
-            SAFE_DELETE(pEntry->pEnhancedTexture);
-            pEntry->dwEnhancementFlag = TEXTURE_NO_ENHANCEMENT;
-            return;
-        }
-        pSurfaceHandler = CDeviceBuilder::GetBuilder()->CreateTexture(nWidth*4, nHeight*4);
-    }
-    else
+    uint32 scale = options.textureEnhancement == TEXTURE_HQ4X_ENHANCEMENT ? 4 : 2;
+    if( nWidth + nHeight > 1024/scale )
     {
-        if( nWidth + nHeight > 1024/2 )
-        {
-            // Don't enhance for large textures
-            pEntry->pTexture->EndUpdate(&srcInfo);
-            SAFE_DELETE(pEntry->pEnhancedTexture);
-            pEntry->dwEnhancementFlag = TEXTURE_NO_ENHANCEMENT;
-            return;
-        }
-        pSurfaceHandler = CDeviceBuilder::GetBuilder()->CreateTexture(nWidth*2, nHeight*2);
+        // Don't enhance for large textures
+        pEntry->pTexture->EndUpdate(&srcInfo);
+        SAFE_DELETE(pEntry->pEnhancedTexture);
+        pEntry->dwEnhancementFlag = TEXTURE_NO_ENHANCEMENT;
+        return;
     }
+    CTexture* pSurfaceHandler = CDeviceBuilder::GetBuilder()->CreateTexture(nWidth*scale, nHeight*scale);
+
     DrawInfo destInfo;
     if(pSurfaceHandler)
     {
         if(pSurfaceHandler->StartUpdate(&destInfo))
         {
-            if( options.textureEnhancement == TEXTURE_2XSAI_ENHANCEMENT )
-            {
-                if( pEntry->pTexture->GetPixelSize() == 4 )
-                    Super2xSaI_32((uint32*)(srcInfo.lpSurface),(uint32*)(destInfo.lpSurface), nWidth, realheight, nWidth);
-                else
-                    Super2xSaI_16((uint16*)(srcInfo.lpSurface),(uint16*)(destInfo.lpSurface), nWidth, realheight, nWidth);
-            }
-            else if( options.textureEnhancement == TEXTURE_HQ2X_ENHANCEMENT )
+            EnhancedTextureKey key;
+            memset(&key, 0, sizeof(key));
+            key.dwCRC = pEntry->dwCRC;
+            key.dwPalCRC = pEntry->dwPalCRC;
+            key.dwImageCRC = ComputeCRC32(0, (uint8*)srcInfo.lpSurface, srcInfo.lPitch*nHeight);
+            key.width = nWidth;
+            key.height = nHeight;
+            key.realWidth = realwidth;
+            key.realHeight = realheight;
+            key.pixelSize = pixelSize;
+            key.enhancement = options.textureEnhancement;
+            key.enhancementControl = options.textureEnhancementControl;
+
+            uint32 destRows = nHeight*scale;
+            EnhancedTexture *pCached = FindEnhancedTexture(key);
+            if( pCached )
             {
-                if( pEntry->pTexture->GetPixelSize() == 4 )
-                {
-                    hq2x_init(32);
-                    hq2x_32((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight);
-                }
-                else
-                {
-                    hq2x_init(16);
-                    hq2x_16((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight);
-                }
+                CopyEnhancedTexture(*pCached, destInfo, destRows);
             }
-            else if( options.textureEnhancement == TEXTURE_LQ2X_ENHANCEMENT )
-            {
-                if( pEntry->pTexture->GetPixelSize() == 4 )
-                {
-                    hq2x_init(32);
-                    lq2x_32((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight);
-                }
-                else
-                {
-                    hq2x_init(16);
-                    lq2x_16((uint8*)(srcInfo.lpSurface), srcInfo.lPitch, (uint8*)(destInfo.lpSurface), destInfo.lPitch, nWidth, realheight);
-                }
-            }
-            else if( options.textureEnhancement == TEXTURE_HQ4X_ENHANCEMENT )
+            else
             {
-                if( pEntry->pTexture->GetPixelSize() == 4 )
-                {
-                    hq4x_InitLUTs();
-                    hq4x_32((uint8*)(srcInfo.lpSurface), (uint8*)(destInfo.lpSurface), realwidth, realheight, nWidth, destInfo.lPitch);
-                }
-                else
-                {
+                if( options.textureEnhancement == TEXTURE_HQ2X_ENHANCEMENT || options.textureEnhancement == TEXTURE_LQ2X_ENHANCEMENT )
+                    hq2x_init(pixelSize*8);
+                else if( options.textureEnhancement == TEXTURE_HQ4X_ENHANCEMENT )
                     hq4x_InitLUTs();
-                    hq4x_16((uint8*)(srcInfo.lpSurface), (uint8*)(destInfo.lpSurface), realwidth, realheight, nWidth, destInfo.lPitch);
-                }
-            }
-            else 
-            {
-                if( pEntry->pTexture->GetPixelSize() == 4 )
-                    Texture2x_32( srcInfo, destInfo);
-                else
-                    Texture2x_16( srcInfo, destInfo);
-            }
 
-            if( options.textureEnhancementControl >= TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_1 )
-            {
-                if( options.textureEnhancement != TEXTURE_HQ4X_ENHANCEMENT )
-                {
-                    if( pEntry->pTexture->GetPixelSize() == 4 )
-                        SmoothFilter_32((uint32*)destInfo.lpSurface, realwidth<<1, realheight<<1, nWidth<<1, options.textureEnhancementControl);
-                    else
-                        SmoothFilter_16((uint16*)destInfo.lpSurface, realwidth<<1, realheight<<1, nWidth<<1, options.textureEnhancementControl);
-                }
-                else
+                TextureFilterJob job;
+                memset(&job, 0, sizeof(job));
+                job.stage = TEXTURE_FILTER_SCALE;
+                job.filter = options.textureEnhancement;
+                job.pixelSize = pixelSize;
+                job.srcInfo = &srcInfo;
+                job.destInfo = &destInfo;
+                job.rows = realheight;
+                RunTextureFilter(job);
+
+                if( options.textureEnhancementControl >= TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_1 )
                 {
-                    if( pEntry->pTexture->GetPixelSize() == 4 )
-                        SmoothFilter_32((uint32*)destInfo.lpSurface, realwidth<<2, realheight<<2, nWidth<<2, options.textureEnhancementControl);
-                    else
-                        SmoothFilter_16((uint16*)destInfo.lpSurface, realwidth<<2, realheight<<2, nWidth<<2, options.textureEnhancementControl);
+                    RunInPlaceTextureFilter(TEXTURE_FILTER_SMOOTH, destInfo.lpSurface, pixelSize, realwidth*scale,
+                                            realheight*scale, nWidth*scale, options.textureEnhancementControl);
                 }
+
+                pCached = AddEnhancedTexture(key, (uint8*)destInfo.lpSurface, destInfo.lPitch, destInfo.lPitch*destRows);
+                if( pCached && options.bCacheEnhancedTextures )
+                    SaveEnhancedTexture(key, *pCached);
             }
 
             pSurfaceHandler->EndUpdate(&destInfo);  
@@ -887,427 +1305,53 @@ void MirrorTexture(uint32 dwTile, TxtrCacheEntry *pEntry)
                         pSurfaceHandler->EndUpdate(&destInfo);
                     }
                 
-                    // FIXME: There should be a flag to tell that it is a mirrored texture handler
-                    // not the original texture handlers, so all texture coordinate should be divided by 2
-                    pSurfaceHandler->SetOthersVariables();
-                }
-
-                pEntry->pTexture->EndUpdate(&srcInfo);  
-                pEntry->dwEnhancementFlag = TEXTURE_MIRRORED;
-            }
-
-
-            pEntry->pEnhancedTexture = pSurfaceHandler;
-        }
-    }
-}
-/****
- All code bellow, CLEAN ME
-****/
-
-enum TextureType
-{
-    NO_TEXTURE,
- RGB_PNG,
- COLOR_INDEXED_BMP,
- RGB_WITH_ALPHA_TOGETHER_PNG,
- RGBA_PNG_FOR_CI,
- RGBA_PNG_FOR_ALL_CI,
-};
-typedef struct {
-    unsigned int width;
-    unsigned int height;
-    int fmt;
-    int siz;
-    int crc32;
-    int pal_crc32;
-    char *foldername;
-    char *filename;
-    char *filename_a;
-    //char name[40];
-    TextureType type;
-    bool        bSeparatedAlpha;
-} ExtTxtrInfo;
-
-CSortedList<uint64,ExtTxtrInfo> gTxtrDumpInfos;
-CSortedList<uint64,ExtTxtrInfo> gHiresTxtrInfos;
-
-extern char * right(const char * src, int nchars);
-
-#define SURFFMT_P8 41
-
-int GetImageInfoFromFile(char* pSrcFile, IMAGE_INFO *pSrcInfo)
-{
-    unsigned char sig[8];
-    FILE *f;
-
-    f = fopen(pSrcFile, "rb");
-    if (f == NULL)
-    {
-      DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile() error: couldn't open file '%s'", pSrcFile);
-      return 1;
-    }
-    if (fread(sig, 1, 8, f) != 8)
-    {
-      DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile() error: couldn't read first 8 bytes of file '%s'", pSrcFile);
-      fclose(f);
-      return 1;
-    }
-    fclose(f);
-
-    if(sig[0] == 'B' && sig[1] == 'M') // BMP
-    {
-        struct BMGImageStruct img;
-        memset(&img, 0, sizeof(BMGImageStruct));
-        BMG_Error code = ReadBMP(pSrcFile, &img);
-        if( code == BMG_OK )
-        {
-            pSrcInfo->Width = img.width;
-            pSrcInfo->Height = img.height;
-            pSrcInfo->Depth = img.bits_per_pixel;
-            pSrcInfo->MipLevels = 1;
-            if(img.bits_per_pixel == 32)
-                pSrcInfo->Format = SURFFMT_A8R8G8B8;
-            else if(img.bits_per_pixel == 8)
-                pSrcInfo->Format = SURFFMT_P8;
-            // Resource and File Format ignored
-            FreeBMGImage(&img);
-            return 0;
-        }
-        DebugMessage(M64MSG_ERROR, "Couldn't read BMP file '%s'; error = %i", pSrcFile, code);
-        return 1;
-    }
-    else if(sig[0] == 137 && sig[1] == 'P' && sig[2] == 'N' && sig[3] == 'G' && sig[4] == '\r' && sig[5] == '\n' &&
-               sig[6] == 26 && sig[7] == '\n') // PNG
-    {
-        struct BMGImageStruct img;
-        memset(&img, 0, sizeof(BMGImageStruct));
-        BMG_Error code = ReadPNGInfo(pSrcFile, &img);
-        if( code == BMG_OK )
-        {
-            pSrcInfo->Width = img.width;
-            pSrcInfo->Height = img.height;
-            pSrcInfo->Depth = img.bits_per_pixel;
-            pSrcInfo->MipLevels = 1;
-            if(img.bits_per_pixel == 32)
-                pSrcInfo->Format = SURFFMT_A8R8G8B8;
-            else if(img.bits_per_pixel == 8)
-                pSrcInfo->Format = SURFFMT_P8;
-            // Resource and File Format ignored
-            FreeBMGImage(&img);
-            return 0;
-        }
-        DebugMessage(M64MSG_ERROR, "Couldn't read PNG file '%s'; error = %i", pSrcFile, code);
-        return 1;
-    }
-
-    DebugMessage(M64MSG_ERROR, "GetImageInfoFromFile : unknown file format (%s)", pSrcFile);
-    return 1;
-}
-
-BOOL PathFileExists(char* pszPath)
-{
-    FILE *f;
-    f = fopen(pszPath, "rb");
-    if(f != NULL)
-    {
-        fclose(f);
-        return TRUE;
-    }
-    return FALSE;
-}
-
-/********************************************************************************************************************
- * Truncates the current list with information about hires textures and scans the hires folder for hires textures and
- * creates a list with records of properties of the hires textures.
- * parameter:
- * foldername: the folder that should be scaned for valid hires textures.
- * infos: a pointer that will point to the list containing the records with the infos about the found hires textures.
- *        In case of enabled caching, these records will also contain the actual textures.
- * extraCheck: ?
- * bRecursive: flag that indicates if also subfolders should be scanned for hires textures
- * bCacheTextures: flag that indicates if the identified hires textures should also be cached
- * bMainFolder: indicates if the folder is the main folder that will be scanned. That way, texture counting does not
- *              start at 1 each time a subfolder is accessed. (microdev: I know that is not important but it really
- *              bugged me ;-))
- * return:
- * infos: the list with the records of the identified hires textures. Be aware that these records also contains the
- *        actual textures if caching is enabled.
- ********************************************************************************************************************/
-void FindAllTexturesFromFolder(char *foldername, CSortedList<uint64,ExtTxtrInfo> &infos, bool extraCheck, bool bRecursive)
-{
-    // check if folder actually exists
-    if (!osal_is_directory(foldername))
-        return;
-
-    // the path of the texture
-    char texturefilename[PATH_MAX];
-    //
-    IMAGE_INFO  imgInfo;
-    //
-    IMAGE_INFO  imgInfo2;
-
-    void *dir;
-    dir = osal_search_dir_open(foldername);
-    const char *foundfilename;
-
-    int crc, palcrc32;
-    unsigned int fmt, siz;
-    char crcstr[16], crcstr2[16];
-
-    do
-    {
-        foundfilename = osal_search_dir_read_next(dir);
-
-        // The array is empty,  break the current operation
-        if (foundfilename == NULL)
-            break;
-        // The current file is a hidden one
-        if (foundfilename[0] == '.' )
-            // These files we don't need
-            continue;
-
-        // Get the folder name
-        strcpy(texturefilename, foldername);
-        // And append the file name
-        strcat(texturefilename, foundfilename);
-
-        // Check if the current file is a directory and if recursive scanning is enabled
-        if (osal_is_directory(texturefilename) && bRecursive )
-        {
-            // Add file-separator
-            strcat(texturefilename, OSAL_DIR_SEPARATOR_STR);
-            // Scan detected folder for hires textures (recursive call)
-            FindAllTexturesFromFolder(texturefilename, infos, extraCheck, bRecursive);
-            continue;
-        }
-        // well, the current file is actually no file (probably a directory & recursive scanning is not enabled)
-        if( strstr(foundfilename,(const char*)g_curRomInfo.szGameName) == 0 )
-            // go on with the next one
-            continue;
-
-        TextureType type = NO_TEXTURE;
-        bool bSeparatedAlpha = false;
-
-        // Detect the texture type by it's extention
-        // microdev: this is not the smartest way. Should be done by header analysis if possible
-        if( strcasecmp(right(foundfilename,7), "_ci.bmp") == 0 )
-        {
-            // Identify type
-            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0)
-            {
-                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
-                continue;
-            }
-
-            if( imgInfo.Format == SURFFMT_P8 )
-                // and store it to the record
-                type = COLOR_INDEXED_BMP;
-            else
-                // Type is not supported, go on with the next one
-                continue;
-        }
-        // Detect the texture type by its extention
-        else if( strcasecmp(right(foundfilename,13), "_ciByRGBA.png") == 0 )
-        {
-            // Identify type
-            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
-            {
-                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
-                continue;
-            }
-
-            if( imgInfo.Format == SURFFMT_A8R8G8B8 )
-                // and store it to the record
-                type = RGBA_PNG_FOR_CI;
-            else
-                // Type is not supported, go on with the next one
-                continue;
-        }
-        // Detect the texture type by its extention
-        else if( strcasecmp(right(foundfilename,16), "_allciByRGBA.png") == 0 )
-        {
-            // Identify type
-            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
-            {
-                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
-                continue;
-            }
-            if( imgInfo.Format == SURFFMT_A8R8G8B8 )
-                // and store it to the record
-                type = RGBA_PNG_FOR_ALL_CI;
-            else
-                // Type not supported, go on with next one
-                continue;
-        }
-        // Detect the texture type by its extention
-        else if( strcasecmp(right(foundfilename,8), "_rgb.png") == 0 )
-        {
-            // Identify type
-            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
-            {
-                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
-                continue;
-            }
-
-            // Store type to the record
-            type = RGB_PNG;
-
-            char filename2[PATH_MAX];
-            // Assemble the file name for the separate alpha channel file
-            strcpy(filename2,texturefilename);
-            strcpy(filename2+strlen(filename2)-8,"_a.png");
-            // Check if the file actually exists
-            if( PathFileExists(filename2) )
-            {
-                // Check if the file with this name is actually a texture (well an alpha channel one)
-                if( GetImageInfoFromFile(filename2, &imgInfo2) != 0 )
-                {
-                    // Nope, it isn't. => Go on with the next file
-                    DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", filename2);
-                    continue;
-                }
-                
-                // Yes it is a texture file. Check if the size of the alpha channel is the same as the one of the texture
-                if( extraCheck && (imgInfo2.Width != imgInfo.Width || imgInfo2.Height != imgInfo.Height) )
-                {
-                    // Nope, it isn't => go on with next file
-                    DebugMessage(M64MSG_WARNING, "RGB and alpha texture size mismatch: %s", filename2);
-                    continue;
-                }
-
-                bSeparatedAlpha = true;
-            }
-        }
-        // Detect the texture type by its extention
-        else if( strcasecmp(right(foundfilename,8), "_all.png") == 0 )
-        {
-            // Check if texture is of expected type
-            if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
-            {
-                DebugMessage(M64MSG_WARNING, "Cannot get image info for file: %s", foundfilename);
-                // Nope, continue with next file
-                continue;
-            }
-
-            // Indicate file type
-            type = RGB_WITH_ALPHA_TOGETHER_PNG;
-        }
-    
-        // If a known texture format has been detected...
-        if( type != NO_TEXTURE )
-        {
-        /*
-            Try to read image information here.
-
-            (CASTLEVANIA2)#(58E2333F)#(2)#(0)#(D7A5C6D9)_ciByRGBA.png
-            (------1-----)#(---2----)#(3)#(4)#(---5----)_ciByRGBA.png
- 
-            1. Internal ROM name
-            2. The DRAM CRC
-            3. The image pixel size (8b=0, 16b=1, 24b=2, 32b=3)
-            4. The texture format (RGBA=0, YUV=1, CI=2, IA=3, I=4)
-            5. The palette CRC
-
-            <internal Rom name>#<DRAM CRC>#<24bit>#<RGBA>#<PAL CRC>_ciByRGBA.png
-            */
-
-            // Get the actual file name
-            strcpy(texturefilename, foundfilename);
-            // Place the pointer before the DRAM-CRC (first occurrence of '#')
-            char *ptr = strchr(texturefilename,'#');
-            // Terminate the string ('0' means end of string - or in this case begin of string)
-            *ptr++ = 0;
-            if( type == RGBA_PNG_FOR_CI )
-            {
-                // Extract the information from the file name; information is:
-                // <DRAM(or texture)-CRC><texture type><texture format><PAL(or palette)-CRC>
-                sscanf(ptr,"%8c#%d#%d#%8c", crcstr, &fmt, &siz,crcstr2);
-                // Terminate the ascii represntation of the palette crc
-                crcstr2[8] = 0;
-                // Transform the ascii presentation of the hex value to an unsigned integer
-                palcrc32 = strtoul(crcstr2,NULL,16);
-            }
-            else
-            {
-                // Extract the information from the file name - this file does not have a palette crc; information is:
-                // <DRAM(or texture)-CRC><texture type><texture format>
-                // o gosh, commenting source code is really boring - but necessary!! Thus do it! (and don't use drugs ;-))
-                sscanf(ptr,"%8c#%d#%d", crcstr, &fmt, &siz);
-                // Use dummy for palette crc - that way each texture can be handled in a heterogeneous way
-                palcrc32 = 0xFFFFFFFF;
-            }
-            // Terminate the ascii represntation of the texture crc
-            crcstr[8]=0;
-            // Transform the ascii presentation of the hex value to an unsigned integer
-            crc = strtoul(crcstr,NULL,16);
-            // For the detection of an existing item
-
-            int foundIdx = -1;
-            for( int k=0; k<infos.size(); k++)
-            {
-                // Check if texture already exists in the list
-                // microdev: that's why I somehow love documenting code: that makes the implementation of a WIP folder check
-                // fucking easy :-)
-                if( infos[k].crc32 == crc && infos[k].pal_crc32 == palcrc32 )
-                {
-                    // Indeeed, the texture already exists
-                    // microdev: MAYBE ADD CODE TO MOVE IT TO A 'DUBLICATE' FOLDER TO EASE WORK OF RETEXTURERS
-                    foundIdx = k;
-                    break;
+                    // FIXME: There should be a flag to tell that it is a mirrored texture handler
+                    // not the original texture handlers, so all texture coordinate should be divided by 2
+                    pSurfaceHandler->SetOthersVariables();
                 }
-            }
 
-            if( foundIdx < 0 || type != infos[foundIdx].type)
-            {
-                // Create a new entry
-                ExtTxtrInfo newinfo;
-                // Store the width
-                newinfo.width = imgInfo.Width;
-                // Store the height
-                newinfo.height = imgInfo.Height;
-                // Store the name of the folder it has been found in
-                //strcpy(newinfo.name,g_curRomInfo.szGameName);
-                newinfo.foldername = new char[strlen(foldername)+1];
-                strcpy(newinfo.foldername,foldername);
-                // store the filename
-                newinfo.filename = strdup(foundfilename);
-                newinfo.filename_a = NULL;
-                // Store the format
-                newinfo.fmt = fmt;
-                // Store the size (bit-size, not texture size)
-                newinfo.siz = siz;
-                // Store DRAM (texture) CRC
-                newinfo.crc32 = crc;
-                // Store PAL (palette) CRC (the actual one, or the dummy value ('FFFFFFFF'))
-                newinfo.pal_crc32 = palcrc32;
-                // Store the texture type
-                newinfo.type = type;
-                //Indicate if there is a separate alpha file that has to be loaded
-                newinfo.bSeparatedAlpha = bSeparatedAlpha;
-                if (bSeparatedAlpha) {
-                    char filename2[PATH_MAX];
-                    strcpy(filename2, foundfilename);
-                    strcpy(filename2+strlen(filename2)-8,"_a.png");
-                    newinfo.filename_a = strdup(filename2);
-                }
-                // Generate the key for the record describing the hires texture.
-                // This key is used to find it back in the list
-                // The key format is: <DRAM(texture)-CRC-8byte><PAL(palette)-CRC-6byte(2bytes have been truncated to have space for format and size)><format-1byte><size-1byte>
-                uint64 crc64 = newinfo.crc32;
-                crc64 <<= 32;
-                if (options.bLoadHiResCRCOnly)
-                    crc64 |= newinfo.pal_crc32&0xFFFFFFFF;
-                else
-                    crc64 |= (newinfo.pal_crc32&0xFFFFFF00)|(newinfo.fmt<<4)|newinfo.siz;
-                // Add the new record to the list
-                infos.add(crc64,newinfo);
+                pEntry->pTexture->EndUpdate(&srcInfo);  
+                pEntry->dwEnhancementFlag = TEXTURE_MIRRORED;
             }
+
+
+            pEntry->pEnhancedTexture = pSurfaceHandler;
         }
-    } while(foundfilename != NULL);
+    }
+}
+/****
+ All code bellow, CLEAN ME
+****/
+
+CSortedList<uint64,ExtTxtrInfo> gTxtrDumpInfos;
+CSortedList<uint64,ExtTxtrInfo> gHiresTxtrInfos;
+static CHiresPack gHiresPack;
+
+static void StopHiresDecoding(void);
+
+void FindAllTexturesFromFolder(char *foldername, CSortedList<uint64,ExtTxtrInfo> &infos, bool extraCheck, bool bRecursive)
+{
+    std::vector<ScannedTxtr> found;
+    std::vector<ScannedFolder> folders;
 
-    osal_search_dir_close(dir);
+    ScanTexturesFromFolder(foldername, (const char*)g_curRomInfo.szGameName, options.bLoadHiResCRCOnly, found, folders,
+                           extraCheck, bRecursive);
+    SortScannedTextures(found);
+    AddScannedTextures(found, infos);
 }
+
+static void GetHiresIndexFilename(char *filename)
+{
+    strncpy(filename, ConfigGetUserCachePath(), PATH_MAX);
+    filename[PATH_MAX] = 0;
+    if (filename[strlen(filename) - 1] != OSAL_DIR_SEPARATOR_CHAR)
+        strcat(filename, OSAL_DIR_SEPARATOR_STR);
+    strcat(filename, "hires_index" OSAL_DIR_SEPARATOR_STR);
+    osal_mkdirp(filename, 0700);
+    strcat(filename, (const char*)g_curRomInfo.szGameName);
+    strcat(filename, ".idx");
+}
+
 /********************************************************************************************************************
  * Checks if a folder is actually existant. If not, it tries to create this folder
  * parameter:
@@ -1317,6 +1361,82 @@ void FindAllTexturesFromFolder(char *foldername, CSortedList<uint64,ExtTxtrInfo>
  *               false will be returned
  ********************************************************************************************************************/
 
+/********************************************************************************************************************
+ * Opens the texture pack of the rom, if there is one (see HiresPack.h)
+ ********************************************************************************************************************/
+static bool OpenHiresPack(const char *packname)
+{
+    if (!PathFileExists((char *) packname))
+        return false;
+
+    if (!gHiresPack.Open(packname))
+    {
+        DebugMessage(M64MSG_ERROR, "Invalid hi-res texture pack '%s'", packname);
+        return false;
+    }
+
+    DebugMessage(M64MSG_INFO, "Opened hi-res texture pack '%s' (%i textures)", packname, gHiresPack.GetNumEntries());
+    return true;
+}
+
+static void AddHiresPackTextures(CSortedList<uint64,ExtTxtrInfo> &infos)
+{
+    // the keys depend on options.bLoadHiResCRCOnly, so the entries are sorted here and merged into the list at once
+    std::vector<std::pair<uint64,int> > packed;
+    packed.reserve(gHiresPack.GetNumEntries());
+    for (int i = 0; i < gHiresPack.GetNumEntries(); i++)
+    {
+        const HiresPackEntry &e = gHiresPack.GetEntry(i);
+
+        uint64 crc64 = (uint32) e.crc32;
+        crc64 <<= 32;
+        if (options.bLoadHiResCRCOnly)
+            crc64 |= e.pal_crc32&0xFFFFFFFF;
+        else
+            crc64 |= (e.pal_crc32&0xFFFFFF00)|(e.fmt<<4)|e.siz;
+
+        // there is a texture file for it
+        if (infos.find(crc64) >= 0)
+            continue;
+
+        packed.push_back(std::make_pair(crc64, i));
+    }
+    std::sort(packed.begin(), packed.end());
+
+    std::vector<uint64> keys;
+    std::vector<ExtTxtrInfo> packInfos;
+    keys.reserve(packed.size());
+    packInfos.reserve(packed.size());
+    for (size_t n = 0; n < packed.size(); n++)
+    {
+        // the first entry of the pack with a key wins
+        if (n > 0 && packed[n].first == packed[n-1].first)
+            continue;
+
+        int i = packed[n].second;
+        const HiresPackEntry &e = gHiresPack.GetEntry(i);
+        ExtTxtrInfo info;
+        info.width = e.width;
+        info.height = e.height;
+        info.fmt = e.fmt;
+        info.siz = e.siz;
+        info.crc32 = e.crc32;
+        info.pal_crc32 = e.pal_crc32;
+        info.type = (TextureType) e.type;
+        info.bSeparatedAlpha = false;
+        info.packIndex = i;
+        // the pack has the full paths of the source images
+        info.foldername = CopyIndexString("", 0);
+        info.filename = CopyIndexString(gHiresPack.GetEntryName(i), 0);
+        info.filename_a = NULL;
+        keys.push_back(packed[n].first);
+        packInfos.push_back(info);
+    }
+
+    if (!keys.empty())
+        infos.merge(&keys[0], &packInfos[0], (int) keys.size());
+}
+
 bool CheckAndCreateFolder(const char* pathname)
 {
     // Check if provided folder already exists
@@ -1418,6 +1538,13 @@ void FindAllHiResTextures(void)
     // It does not exist? => Create it
     CheckAndCreateFolder(foldername);
 
+    // The texture pack of the rom, next to its sub-folder
+    char    packname[PATH_MAX + 64];
+    strcpy(packname, foldername);
+    strcat(packname, (const char*)g_curRomInfo.szGameName);
+    strcat(packname, ".htp");
+    bool bPack = OpenHiresPack(packname);
+
     // Add the path to a sub-folder corresponding to the rom name
     // HOOK IN: PACK SELECT
     strcat(foldername,(const char*)g_curRomInfo.szGameName);
@@ -1426,18 +1553,36 @@ void FindAllHiResTextures(void)
     gHiresTxtrInfos.clear();
     if (!osal_is_directory(foldername))
     {
-        DebugMessage(M64MSG_WARNING, "Couldn't open hi-res texture directory: %s", foldername);
-        return;
+        if (!bPack)
+            DebugMessage(M64MSG_WARNING, "Couldn't open hi-res texture directory: %s", foldername);
     }
     else
     {
-        // Find all hires textures and also cache them if configured to do so
-        FindAllTexturesFromFolder(foldername,gHiresTxtrInfos, true, true);
+        char indexname[PATH_MAX + 64];
+        GetHiresIndexFilename(indexname);
+        if (!LoadHiresIndex(indexname, foldername, options.bLoadHiResCRCOnly, gHiresTxtrInfos))
+        {
+            // Find all hires textures and remember them for the next run
+            std::vector<ScannedTxtr> found;
+            std::vector<ScannedFolder> folders;
+            ScanTexturesFromFolder(foldername, (const char*)g_curRomInfo.szGameName, options.bLoadHiResCRCOnly, found,
+                                   folders, true, true);
+            SortScannedTextures(found);
+            SaveHiresIndex(indexname, options.bLoadHiResCRCOnly, found, folders);
+            AddScannedTextures(found, gHiresTxtrInfos);
+        }
     }
+
+    // the texture files are added first so they take precedence over the pack, which makes it easy to try changes
+    if (bPack)
+        AddHiresPackTextures(gHiresTxtrInfos);
 }
 
 void CloseHiresTextures(void)
 {
+    StopHiresDecoding();
+    gHiresPack.Close();
+
     for( int i=0; i<gHiresTxtrInfos.size(); i++)
     {
         if( gHiresTxtrInfos[i].foldername )
@@ -1470,6 +1615,7 @@ void CloseExternalTextures(void)
 {
     CloseHiresTextures();
     CloseTextureDump();
+    CloseEnhancedTextures();
 }
 
 /********************************************************************************************************************
@@ -1730,6 +1876,7 @@ void DumpCachedTexture( TxtrCacheEntry &entry )
         newinfo.filename_a = NULL;
         newinfo.type = NO_TEXTURE;
         newinfo.bSeparatedAlpha = false;
+        newinfo.packIndex = -1;
 
         uint64 crc64 = newinfo.crc32;
         crc64 <<= 32;
@@ -1839,7 +1986,7 @@ bool LoadRGBBufferFromPNGFile(char *filename, unsigned char **pbuf, int &width,
     }
 }
 
-bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, unsigned char **pbuf, int &width, int &height)
+bool LoadRGBABufferFromColorIndexedFile(char *filename, const TxtrInfo &ti, const uint16 *pPal, unsigned char **pbuf, int &width, int &height)
 {
     BITMAPFILEHEADER fileHeader;
     BITMAPINFOHEADER infoHeader;
@@ -1852,6 +1999,7 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
             fread(&infoHeader, sizeof(BITMAPINFOHEADER), 1, f) != 1)
         {
             DebugMessage(M64MSG_ERROR, "Couldn't read BMP headers in file '%s'", filename);
+            fclose(f);
             return false;
         }
 
@@ -1869,17 +2017,17 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
         {
             DebugMessage(M64MSG_ERROR, "Couldn't read BMP palette in file '%s'", filename);
             delete [] pTable;
+            fclose(f);
             return false;
         }
 
         // Create the pallette table
-        uint16 * pPal = (uint16 *)entry.ti.PalAddress;
-        if( entry.ti.Size == TXT_SIZE_4b )
+        if( ti.Size == TXT_SIZE_4b )
         {
             // 4-bit table
             for( int i=0; i<16; i++ )
             {
-                pTable[i] = entry.ti.TLutFmt == TLUT_FMT_RGBA16 ? Convert555ToRGBA(pPal[i^1]) : ConvertIA16ToRGBA(pPal[i^1]);
+                pTable[i] = ti.TLutFmt == TLUT_FMT_RGBA16 ? Convert555ToRGBA(pPal[i^1]) : ConvertIA16ToRGBA(pPal[i^1]);
             }
         }
         else
@@ -1887,7 +2035,7 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
             // 8-bit table
             for( int i=0; i<256; i++ )
             {
-                pTable[i] = entry.ti.TLutFmt == TLUT_FMT_RGBA16 ? Convert555ToRGBA(pPal[i^1]) : ConvertIA16ToRGBA(pPal[i^1]);
+                pTable[i] = ti.TLutFmt == TLUT_FMT_RGBA16 ? Convert555ToRGBA(pPal[i^1]) : ConvertIA16ToRGBA(pPal[i^1]);
             }
         }
 
@@ -1913,7 +2061,7 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
                 {
                     for( int j=0; j<width; j++)
                     {
-                        if( entry.ti.Size == TXT_SIZE_4b )
+                        if( ti.Size == TXT_SIZE_4b )
                         {
                             // 4 bits
                             if( idx%2 )
@@ -1933,7 +2081,7 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
                             *pbuf2++ = pTable[colorIdxBuf[idx++]];
                         }
                     }
-                    if( entry.ti.Size == TXT_SIZE_4b )
+                    if( ti.Size == TXT_SIZE_4b )
                     {
                         if( idx%8 ) idx = (idx/8+1)*8;
                     }
@@ -1951,6 +2099,7 @@ bool LoadRGBABufferFromColorIndexedFile(char *filename, TxtrCacheEntry &entry, u
             }
 
             delete [] pTable;
+            fclose(f);
             return true;
         }
         else
@@ -2025,99 +2174,78 @@ bool LoadRGBBufferFromBMPFile(char *filename, unsigned char **pbuf, int &width,
  * return:
  * none
  *******************************************************/
-void LoadHiresTexture( TxtrCacheEntry &entry )
+/********************************************************************************************************************
+ * Reads and decodes the image file(s) of hires texture 'info'. Only uses its arguments, so it can be called from the
+ * decoding threads. pPal is a copy of the palette for color indexed BMPs.
+ ********************************************************************************************************************/
+static bool DecodeHiresTexture(const ExtTxtrInfo &info, const TxtrInfo &ti, const uint16 *pPal,
+                               unsigned char **buf_rgba, unsigned char **buf_a, int &width, int &height)
 {
-    // check if the external texture has already been loaded
-    if( entry.bExternalTxtrChecked )
-        return;
-    // there is already an enhanced texture (e.g. a filtered one)
-
-    if( entry.pEnhancedTexture )
-    {
-        // delete it from memory before loading the external one
-        SAFE_DELETE(entry.pEnhancedTexture);
-    }
-
-    int ciidx, scaleShift;
-    // search the index of the appropriate hires replacement texture
-    // in the list containing the infos of the external textures
-    // ciidx is not needed here (just needed for dumping)
-    int idx = CheckTextureInfos(gHiresTxtrInfos,entry,ciidx,scaleShift,false);
-    if( idx < 0 )
-    {
-        // there is no hires replacement => indicate that
-        entry.bExternalTxtrChecked = true;
-        return;
-    }
-
     // Load the bitmap file
     char filename_rgb[PATH_MAX];
     char filename_a[PATH_MAX];
 
-    strcpy(filename_rgb, gHiresTxtrInfos[idx].foldername);
-    strcat(filename_rgb, gHiresTxtrInfos[idx].filename);
+    strcpy(filename_rgb, info.foldername);
+    strcat(filename_rgb, info.filename);
 
-    if (gHiresTxtrInfos[idx].filename_a) {
-        strcpy(filename_a, gHiresTxtrInfos[idx].foldername);
-        strcat(filename_a, gHiresTxtrInfos[idx].filename_a);
+    if (info.filename_a) {
+        strcpy(filename_a, info.foldername);
+        strcat(filename_a, info.filename_a);
     } else {
         strcpy(filename_a, "");
     }
 
-    // Load BMP image to buffer_rbg
-    unsigned char *buf_rgba = NULL;
-    unsigned char *buf_a = NULL;
-    int width, height;
-
     bool bResRGBA=false, bResA=false;
-    bool bCI = ((gRDP.otherMode.text_tlut>=2 || entry.ti.Format == TXT_FMT_CI || entry.ti.Format == TXT_FMT_RGBA) && entry.ti.Size <= TXT_SIZE_8b );
+    *buf_rgba = NULL;
+    *buf_a = NULL;
 
-    switch( gHiresTxtrInfos[idx].type )
+    switch( info.type )
     {
         case RGB_PNG:
-            if( bCI )   
-                return;
-            else
-            {
-                bResRGBA = LoadRGBBufferFromPNGFile(filename_rgb, &buf_rgba, width, height);
-                if( bResRGBA && gHiresTxtrInfos[idx].bSeparatedAlpha )
-                    bResA = LoadRGBBufferFromPNGFile(filename_a, &buf_a, width, height);
-            }
+            bResRGBA = LoadRGBBufferFromPNGFile(filename_rgb, buf_rgba, width, height);
+            if( bResRGBA && info.bSeparatedAlpha )
+                bResA = LoadRGBBufferFromPNGFile(filename_a, buf_a, width, height);
             break;
         case COLOR_INDEXED_BMP:
-            if( bCI )   
-                bResRGBA = LoadRGBABufferFromColorIndexedFile(filename_rgb, entry, &buf_rgba, width, height);
-            else
-                return;
+            bResRGBA = LoadRGBABufferFromColorIndexedFile(filename_rgb, ti, pPal, buf_rgba, width, height);
             break;
         case RGBA_PNG_FOR_CI:
         case RGBA_PNG_FOR_ALL_CI:
-            if( bCI )   
-                bResRGBA = LoadRGBBufferFromPNGFile(filename_rgb, &buf_rgba, width, height, 32);
-            else
-                return;
-            break;
         case RGB_WITH_ALPHA_TOGETHER_PNG:
-            if( bCI )   
-                return;
-            else
-                bResRGBA = LoadRGBBufferFromPNGFile(filename_rgb, &buf_rgba, width, height, 32);
+            bResRGBA = LoadRGBBufferFromPNGFile(filename_rgb, buf_rgba, width, height, 32);
             break;
         default:
-            return;
+            return false;
     }
 
-    if( !bResRGBA || !buf_rgba )
+    if( !bResRGBA || !*buf_rgba )
     {
         DebugMessage(M64MSG_ERROR, "RGBBuffer creation failed for file '%s'.", filename_rgb);
-        return;
+        return false;
     }
     // check if the alpha channel has been loaded if the texture has a separate alpha channel
-    else if( gHiresTxtrInfos[idx].bSeparatedAlpha && !bResA )
+    else if( info.bSeparatedAlpha && !bResA )
     {
         DebugMessage(M64MSG_ERROR, "Alpha buffer creation failed for file '%s'.", filename_a);
-        delete [] buf_rgba;
-        return;
+        delete [] *buf_rgba;
+        *buf_rgba = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+/********************************************************************************************************************
+ * Creates the enhanced texture of 'entry' from the decoded hires image.
+ ********************************************************************************************************************/
+static void UploadHiresTexture(TxtrCacheEntry &entry, const ExtTxtrInfo &hiresInfo, int scaleShift,
+                               const unsigned char *buf_rgba, const unsigned char *buf_a, int width, int height)
+{
+    // there is already an enhanced texture (e.g. a filtered one)
+    if( entry.pEnhancedTexture )
+    {
+        // delete it from memory before loading the external one
+        SAFE_DELETE(entry.pEnhancedTexture);
     }
 
     // calculate the texture size magnification by comparing the N64 texture size and the hi-res texture size
@@ -2137,7 +2265,7 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
     if( entry.pEnhancedTexture && entry.pEnhancedTexture->StartUpdate(&info) )
     {
 
-        if( gHiresTxtrInfos[idx].type == RGB_PNG )
+        if( hiresInfo.type == RGB_PNG )
         {
             input_pitch_rgb *= 3;
             input_pitch_a *= 3;
@@ -2150,8 +2278,8 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
             // Update the texture by using the buffer
             for( int i=0; i<height; i++)
             {
-                unsigned char *pRGB = buf_rgba + (input_height_shift + i) * input_pitch_rgb;
-                unsigned char *pA = buf_a + (input_height_shift + i) * input_pitch_a;
+                const unsigned char *pRGB = buf_rgba + (input_height_shift + i) * input_pitch_rgb;
+                const unsigned char *pA = buf_a + (input_height_shift + i) * input_pitch_a;
                 unsigned char* pdst = (unsigned char*)info.lpSurface + (height - i - 1)*info.lPitch;
                 for( int j=0; j<width; j++)
                 {
@@ -2159,7 +2287,7 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
                     *pdst++ = *pRGB++;      // G
                     *pdst++ = *pRGB++;      // B
 
-                    if( gHiresTxtrInfos[idx].bSeparatedAlpha )
+                    if( hiresInfo.bSeparatedAlpha )
                     {
                         *pdst++ = *pA;
                         pA += 3;
@@ -2182,7 +2310,7 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
             // Update the texture by using the buffer
             for( int i=height-1; i>=0; i--)
             {
-                uint32 *pRGB = (uint32*)(buf_rgba + (input_height_shift + i) * input_pitch_rgb);
+                const uint32 *pRGB = (const uint32*)(buf_rgba + (input_height_shift + i) * input_pitch_rgb);
                 uint32 *pdst = (uint32*)((unsigned char*)info.lpSurface + (height - i - 1)*info.lPitch);
                 for( int j=0; j<width; j++)
                 {
@@ -2219,13 +2347,294 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
         entry.pEnhancedTexture->m_bIsEnhancedTexture = true;
         entry.dwEnhancementFlag = TEXTURE_EXTERNAL;
 
-        DebugMessage(M64MSG_VERBOSE, "Loaded hi-res texture: %s", filename_rgb);
+        DebugMessage(M64MSG_VERBOSE, "Loaded hi-res texture: %s%s", hiresInfo.foldername, hiresInfo.filename);
     }
     else
     {
         DebugMessage(M64MSG_ERROR, "New texture creation failed.");
         TRACE0("Cannot create a new texture");
     }
+}
+
+/****
+ Asynchronous hi-res texture decoding
+
+ Decoding a hi-res replacement takes tens of milliseconds, too long to be done on the render thread the first time a
+ texture shows up. When LoadHiResTexturesAsync is enabled, a texture which has a replacement is queued for decoding
+ on worker threads and keeps being drawn with its native (or filtered) version. On a later frame, once the image is
+ decoded, LoadHiresTexture() uploads it and the replacement is swapped in.
+****/
+#define HIRES_DECODE_THREADS        2
+#define HIRES_DECODE_MAX_JOBS       16                  // queued, decoding and decoded jobs
+#define HIRES_DECODE_MAX_BYTES      (64*1024*1024)      // decoded images waiting to be uploaded
+#define HIRES_DECODE_MAX_AGE        300                 // display lists after which an unclaimed image is dropped
+
+typedef struct {
+    TxtrCacheEntry *pEntry;     // identifies the requesting entry, never dereferenced by the decoding threads
+    uint32          dwCRC;
+    uint32          dwPalCRC;
+    int             idx;        // index of the replacement in gHiresTxtrInfos
+    TxtrInfo        ti;
+    uint16          pal[256];
+    uint32          dlistQueued;
+    bool            bStarted;
+    bool            bDone;
+    bool            bOK;
+    unsigned char  *buf_rgba;
+    unsigned char  *buf_a;
+    int             width;
+    int             height;
+    unsigned int    bytes;
+} HiresDecodeJob;
+
+static std::vector<HiresDecodeJob*> gHiresDecodeJobs;
+static std::vector<bool>    gHiresDecodeFailed;     // replacements which couldn't be decoded, by index
+static unsigned int         gHiresDecodeBytes = 0;
+static SDL_mutex           *gHiresDecodeMutex = NULL;
+static SDL_cond            *gHiresDecodeCond = NULL;
+static SDL_Thread          *gHiresDecodeThreads[HIRES_DECODE_THREADS];
+static bool                 gHiresDecodeQuit = false;
+
+static int HiresDecodeThread(void *)
+{
+    SDL_LockMutex(gHiresDecodeMutex);
+    while( !gHiresDecodeQuit )
+    {
+        HiresDecodeJob *job = NULL;
+        for( size_t i=0; i<gHiresDecodeJobs.size(); i++ )
+        {
+            if( !gHiresDecodeJobs[i]->bStarted )
+            {
+                job = gHiresDecodeJobs[i];
+                break;
+            }
+        }
+        if( job == NULL )
+        {
+            SDL_CondWait(gHiresDecodeCond, gHiresDecodeMutex);
+            continue;
+        }
+
+        job->bStarted = true;
+        ExtTxtrInfo info = gHiresTxtrInfos[job->idx];
+        SDL_UnlockMutex(gHiresDecodeMutex);
+
+        bool ok = DecodeHiresTexture(info, job->ti, job->pal, &job->buf_rgba, &job->buf_a, job->width, job->height);
+
+        SDL_LockMutex(gHiresDecodeMutex);
+        job->bOK = ok;
+        job->bDone = true;
+        if( ok )
+        {
+            job->bytes = job->width * job->height * (info.type == RGB_PNG ? 3 : 4) * (job->buf_a ? 2 : 1);
+            gHiresDecodeBytes += job->bytes;
+        }
+    }
+    SDL_UnlockMutex(gHiresDecodeMutex);
+    return 0;
+}
+
+static void FreeHiresDecodeJob(HiresDecodeJob *job)
+{
+    delete [] job->buf_rgba;
+    delete [] job->buf_a;
+    gHiresDecodeBytes -= job->bytes;
+    delete job;
+}
+
+static void StartHiresDecoding(void)
+{
+    if( gHiresDecodeMutex )
+        return;
+
+    gHiresDecodeMutex = SDL_CreateMutex();
+    gHiresDecodeCond = SDL_CreateCond();
+    gHiresDecodeQuit = false;
+    for( int i=0; i<HIRES_DECODE_THREADS; i++ )
+#if SDL_VERSION_ATLEAST(2,0,0)
+        gHiresDecodeThreads[i] = SDL_CreateThread(HiresDecodeThread, "HiresDecode", NULL);
+#else
+        gHiresDecodeThreads[i] = SDL_CreateThread(HiresDecodeThread, NULL);
+#endif
+}
+
+static void StopHiresDecoding(void)
+{
+    if( gHiresDecodeMutex )
+    {
+        SDL_LockMutex(gHiresDecodeMutex);
+        gHiresDecodeQuit = true;
+        SDL_CondBroadcast(gHiresDecodeCond);
+        SDL_UnlockMutex(gHiresDecodeMutex);
+        for( int i=0; i<HIRES_DECODE_THREADS; i++ )
+        {
+            if( gHiresDecodeThreads[i] )
+                SDL_WaitThread(gHiresDecodeThreads[i], NULL);
+            gHiresDecodeThreads[i] = NULL;
+        }
+        SDL_DestroyCond(gHiresDecodeCond);
+        SDL_DestroyMutex(gHiresDecodeMutex);
+        gHiresDecodeCond = NULL;
+        gHiresDecodeMutex = NULL;
+    }
+
+    for( size_t i=0; i<gHiresDecodeJobs.size(); i++ )
+        FreeHiresDecodeJob(gHiresDecodeJobs[i]);
+    gHiresDecodeJobs.clear();
+    gHiresDecodeFailed.clear();
+    gHiresDecodeBytes = 0;
+}
+
+/********************************************************************************************************************
+ * Asynchronous version of the decoding step: returns true with the decoded image once it is ready, false while it
+ * is still queued or decoding (or could not be queued yet, it will be on a later frame).
+ ********************************************************************************************************************/
+static bool GetDecodedHiresTexture(TxtrCacheEntry &entry, int idx, unsigned char **buf_rgba, unsigned char **buf_a,
+                                   int &width, int &height)
+{
+    StartHiresDecoding();
+    if( gHiresDecodeFailed.size() < (size_t) gHiresTxtrInfos.size() )
+        gHiresDecodeFailed.resize(gHiresTxtrInfos.size(), false);
+
+    // replacements which are known to be broken or missing are not read again
+    if( gHiresDecodeFailed[idx] )
+    {
+        entry.bExternalTxtrChecked = true;
+        return false;
+    }
+
+    SDL_LockMutex(gHiresDecodeMutex);
+
+    HiresDecodeJob *job = NULL;
+    for( size_t i=0; i<gHiresDecodeJobs.size(); )
+    {
+        HiresDecodeJob *curr = gHiresDecodeJobs[i];
+        if( curr->pEntry == &entry && curr->dwCRC == entry.dwCRC && curr->dwPalCRC == entry.dwPalCRC && curr->idx == idx )
+            job = curr;
+        else if( curr->bDone && status.gDlistCount - curr->dlistQueued > HIRES_DECODE_MAX_AGE )
+        {
+            // nobody came back for this one, the texture has probably been recycled
+            FreeHiresDecodeJob(curr);
+            gHiresDecodeJobs.erase(gHiresDecodeJobs.begin() + i);
+            continue;
+        }
+        i++;
+    }
+
+    if( job == NULL )
+    {
+        // keep the amount of work and memory in flight bounded, the request will be made again on the next frame
+        if( gHiresDecodeJobs.size() < HIRES_DECODE_MAX_JOBS && gHiresDecodeBytes < HIRES_DECODE_MAX_BYTES )
+        {
+            job = new HiresDecodeJob;
+            memset(job, 0, sizeof(HiresDecodeJob));
+            job->pEntry = &entry;
+            job->dwCRC = entry.dwCRC;
+            job->dwPalCRC = entry.dwPalCRC;
+            job->idx = idx;
+            job->ti = entry.ti;
+            if( gHiresTxtrInfos[idx].type == COLOR_INDEXED_BMP )
+                memcpy(job->pal, entry.ti.PalAddress, (entry.ti.Size == TXT_SIZE_4b ? 16 : 256) * sizeof(uint16));
+            job->dlistQueued = status.gDlistCount;
+            gHiresDecodeJobs.push_back(job);
+            SDL_CondSignal(gHiresDecodeCond);
+        }
+        SDL_UnlockMutex(gHiresDecodeMutex);
+        return false;
+    }
+
+    if( !job->bDone )
+    {
+        SDL_UnlockMutex(gHiresDecodeMutex);
+        return false;
+    }
+
+    gHiresDecodeJobs.erase(std::find(gHiresDecodeJobs.begin(), gHiresDecodeJobs.end(), job));
+    gHiresDecodeBytes -= job->bytes;
+    SDL_UnlockMutex(gHiresDecodeMutex);
+
+    bool ok = job->bOK;
+    *buf_rgba = job->buf_rgba;
+    *buf_a = job->buf_a;
+    width = job->width;
+    height = job->height;
+    delete job;
+
+    if( !ok )
+    {
+        gHiresDecodeFailed[idx] = true;
+        entry.bExternalTxtrChecked = true;
+    }
+    return ok;
+}
+
+void LoadHiresTexture( TxtrCacheEntry &entry )
+{
+    // check if the external texture has already been loaded
+    if( entry.bExternalTxtrChecked )
+        return;
+
+    int ciidx, scaleShift;
+    // search the index of the appropriate hires replacement texture
+    // in the list containing the infos of the external textures
+    // ciidx is not needed here (just needed for dumping)
+    int idx = CheckTextureInfos(gHiresTxtrInfos,entry,ciidx,scaleShift,false);
+    if( idx < 0 )
+    {
+        // there is no hires replacement => indicate that
+        entry.bExternalTxtrChecked = true;
+        return;
+    }
+
+    // the replacement has to match the texture being color indexed or not
+    bool bCI = ((gRDP.otherMode.text_tlut>=2 || entry.ti.Format == TXT_FMT_CI || entry.ti.Format == TXT_FMT_RGBA) && entry.ti.Size <= TXT_SIZE_8b );
+    switch( gHiresTxtrInfos[idx].type )
+    {
+        case RGB_PNG:
+        case RGB_WITH_ALPHA_TOGETHER_PNG:
+            if( bCI )
+                return;
+            break;
+        case COLOR_INDEXED_BMP:
+        case RGBA_PNG_FOR_CI:
+        case RGBA_PNG_FOR_ALL_CI:
+            if( !bCI )
+                return;
+            break;
+        default:
+            return;
+    }
+
+    if( gHiresTxtrInfos[idx].packIndex >= 0 )
+    {
+        // decoded in advance: used straight from the pack, or after inflating it
+        const unsigned char *image = gHiresPack.GetImage(gHiresTxtrInfos[idx].packIndex);
+        if( image == NULL )
+        {
+            DebugMessage(M64MSG_ERROR, "Hi-res texture pack image '%s' is damaged.", gHiresTxtrInfos[idx].filename);
+            entry.bExternalTxtrChecked = true;
+            return;
+        }
+        UploadHiresTexture(entry, gHiresTxtrInfos[idx], scaleShift, image, NULL,
+                           gHiresTxtrInfos[idx].width, gHiresTxtrInfos[idx].height);
+        return;
+    }
+
+    unsigned char *buf_rgba = NULL;
+    unsigned char *buf_a = NULL;
+    int width, height;
+
+    if( options.bLoadHiResTexturesAsync )
+    {
+        if( !GetDecodedHiresTexture(entry, idx, &buf_rgba, &buf_a, width, height) )
+            return;
+    }
+    else if( !DecodeHiresTexture(gHiresTxtrInfos[idx], entry.ti, (uint16 *)entry.ti.PalAddress, &buf_rgba, &buf_a, width, height) )
+    {
+        return;
+    }
+
+    UploadHiresTexture(entry, gHiresTxtrInfos[idx], scaleShift, buf_rgba, buf_a, width, height);
 
     if( buf_rgba )
     {
@@ -38,9 +38,13 @@ void Texture2x_Interp_16( DrawInfo &srcInfo, DrawInfo &destInfo);
 
 void Super2xSaI_32( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height, uint32 pitch);
 void Super2xSaI_16( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height, uint32 pitch);
+void Super2xSaI_32_rows( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height, uint32 pitch, uint32 firstRow, uint32 lastRow);
+void Super2xSaI_16_rows( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height, uint32 pitch, uint32 firstRow, uint32 lastRow);
 
 void hq4x_16( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL );
 void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL );
+void hq4x_16_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL, int firstRow, int lastRow );
+void hq4x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL, int firstRow, int lastRow );
 void hq4x_InitLUTs(void);
 
 void SmoothFilter_32(uint32 *pdata, uint32 width, uint32 height, uint32 pitch, uint32 filter=TEXTURE_ENHANCEMENT_WITH_SMOOTH_FILTER_1);
@@ -52,33 +56,13 @@ void SharpenFilter_16(uint16 *pdata, uint32 width, uint32 height, uint32 pitch,
 void hq2x_init(unsigned bits_per_pixel);
 void hq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 void hq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
+void hq2x_16_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow);
+void hq2x_32_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow);
 
 void lq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 void lq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
-
-typedef enum _IMAGE_FILEFORMAT 
-{
-   XIFF_BMP = 0,
-     XIFF_JPG = 1,
-     XIFF_TGA = 2,
-     XIFF_PNG = 3,
-     XIFF_DDS = 4,
-     XIFF_PPM = 5,
-     XIFF_DIB = 6,
-     XIFF_HDR = 7,
-     XIFF_PFM = 8,
-     XIFF_FORCE_DWORD = 0x7fffffff
-} IMAGE_FILEFORMAT;
-
-typedef struct _IMAGE_INFO
-{
-   unsigned int Width;
-   unsigned int Height;
-   unsigned int Depth;
-   unsigned int MipLevels;
-   int          Format;  /* SURFFORMAT */
-   IMAGE_FILEFORMAT ImageFileFormat;
-} IMAGE_INFO;
+void lq2x_16_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow);
+void lq2x_32_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow);
 
 #endif
 
@@ -157,7 +157,7 @@ static __inline uint16 SAI_Q_INTERPOLATE_16( uint16 A, uint16 B, uint16 C, uint1
 }
 
 
-void Super2xSaI_32( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height, uint32 pitch)
+void Super2xSaI_32_rows( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height, uint32 pitch, uint32 firstRow, uint32 lastRow)
 {
     uint32 destWidth = width << 1;
     //uint32 destHeight = height << 1;
@@ -172,7 +172,10 @@ void Super2xSaI_32( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height
     int row0, row1, row2, row3;
     int col0, col1, col2, col3;
 
-    for (uint16 y = 0; y < height; y++)
+    srcPtr += firstRow * pitch;
+    destPtr += firstRow * (pitch << 2);
+
+    for (uint32 y = firstRow; y < lastRow; y++)
     {
         if (y > 0)
         {
@@ -315,7 +318,7 @@ void Super2xSaI_32( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height
 }
 
 
-void Super2xSaI_16( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height, uint32 pitch)
+void Super2xSaI_16_rows( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height, uint32 pitch, uint32 firstRow, uint32 lastRow)
 {
     uint32 destWidth = width << 1;
     //uint32 destHeight = height << 1;
@@ -330,7 +333,10 @@ void Super2xSaI_16( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height
     int row0, row1, row2, row3;
     int col0, col1, col2, col3;
 
-    for (uint16 y = 0; y < height; y++)
+    srcPtr += firstRow * pitch;
+    destPtr += firstRow * (pitch << 2);
+
+    for (uint32 y = firstRow; y < lastRow; y++)
     {
         if (y > 0)
         {
@@ -472,3 +478,12 @@ void Super2xSaI_16( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height
     }
 }
 
+void Super2xSaI_32( uint32 *srcPtr, uint32 *destPtr, uint32 width, uint32 height, uint32 pitch)
+{
+    Super2xSaI_32_rows(srcPtr, destPtr, width, height, pitch, 0, height);
+}
+
+void Super2xSaI_16( uint16 *srcPtr, uint16 *destPtr, uint32 width, uint32 height, uint32 pitch)
+{
+    Super2xSaI_16_rows(srcPtr, destPtr, width, height, pitch, 0, height);
+}
@@ -21,6 +21,14 @@
 
 #include "typedefs.h"
 
+#if defined(__SSE2__) && !defined(NO_ASM)
+#include <emmintrin.h>
+#define HQ2X_SSE2
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HQ2X_NEON
+#endif
+
 /************************************************************************/
 /* hq2x filters                                                         */
 /************************************************************************/
@@ -260,6 +268,103 @@ static int hq2x_interp_32_diff(uint32 p1, uint32 p2)
     return 0;
 }
 
+/* Builds the mask of the neighbours c[0..3,5..8] which differ from the center c[4], 4 neighbours at a time.
+   Gives the same result as calling hq2x_interp_32_diff() for each of them. */
+static inline unsigned char hq2x_32_mask(const uint32 *c)
+{
+#if defined(HQ2X_SSE2)
+    const __m128i mask8 = _mm_set1_epi32(0xFF);
+    const __m128i maskEq = _mm_set1_epi32(0xF8F8F8);
+    const __m128i limY = _mm_set1_epi32(INTERP_Y_LIMIT), limYn = _mm_set1_epi32(-INTERP_Y_LIMIT);
+    const __m128i limU = _mm_set1_epi32(INTERP_U_LIMIT), limUn = _mm_set1_epi32(-INTERP_U_LIMIT);
+    const __m128i limV = _mm_set1_epi32(INTERP_V_LIMIT), limVn = _mm_set1_epi32(-INTERP_V_LIMIT);
+
+    __m128i center = _mm_set1_epi32(c[4]);
+    __m128i cb = _mm_and_si128(center, mask8);
+    __m128i cg = _mm_and_si128(_mm_srli_epi32(center, 8), mask8);
+    __m128i cr = _mm_and_si128(_mm_srli_epi32(center, 16), mask8);
+    __m128i ceq = _mm_and_si128(center, maskEq);
+
+    int mask = 0;
+    for (int half = 0; half < 2; half++)
+    {
+        __m128i n = half ? _mm_set_epi32(c[8], c[7], c[6], c[5]) : _mm_set_epi32(c[3], c[2], c[1], c[0]);
+        __m128i b = _mm_sub_epi32(_mm_and_si128(n, mask8), cb);
+        __m128i g = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(n, 8), mask8), cg);
+        __m128i r = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(n, 16), mask8), cr);
+
+        __m128i y = _mm_add_epi32(_mm_add_epi32(r, g), b);
+        __m128i u = _mm_sub_epi32(r, b);
+        __m128i v = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(g, g), r), b);
+
+        __m128i diff = _mm_or_si128(_mm_cmpgt_epi32(y, limY), _mm_cmplt_epi32(y, limYn));
+        diff = _mm_or_si128(diff, _mm_or_si128(_mm_cmpgt_epi32(u, limU), _mm_cmplt_epi32(u, limUn)));
+        diff = _mm_or_si128(diff, _mm_or_si128(_mm_cmpgt_epi32(v, limV), _mm_cmplt_epi32(v, limVn)));
+        diff = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(n, maskEq), ceq), diff);
+
+        mask |= _mm_movemask_ps(_mm_castsi128_ps(diff)) << (half * 4);
+    }
+    return (unsigned char)mask;
+#elif defined(HQ2X_NEON)
+    static const uint32 bits[2][4] = { { 1, 2, 4, 8 }, { 16, 32, 64, 128 } };
+    const uint32x4_t mask8 = vdupq_n_u32(0xFF);
+    const uint32x4_t maskEq = vdupq_n_u32(0xF8F8F8);
+    const int32x4_t limY = vdupq_n_s32(INTERP_Y_LIMIT);
+    const int32x4_t limU = vdupq_n_s32(INTERP_U_LIMIT);
+    const int32x4_t limV = vdupq_n_s32(INTERP_V_LIMIT);
+
+    uint32x4_t center = vdupq_n_u32(c[4]);
+    int32x4_t cb = vreinterpretq_s32_u32(vandq_u32(center, mask8));
+    int32x4_t cg = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(center, 8), mask8));
+    int32x4_t cr = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(center, 16), mask8));
+    uint32x4_t ceq = vandq_u32(center, maskEq);
+
+    uint32x4_t result = vdupq_n_u32(0);
+    for (int half = 0; half < 2; half++)
+    {
+        uint32x4_t n = vld1q_u32(half ? c + 5 : c);
+        int32x4_t b = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(n, mask8)), cb);
+        int32x4_t g = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(n, 8), mask8)), cg);
+        int32x4_t r = vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(n, 16), mask8)), cr);
+
+        int32x4_t y = vaddq_s32(vaddq_s32(r, g), b);
+        int32x4_t u = vsubq_s32(r, b);
+        int32x4_t v = vsubq_s32(vsubq_s32(vaddq_s32(g, g), r), b);
+
+        uint32x4_t diff = vcgtq_s32(vabsq_s32(y), limY);
+        diff = vorrq_u32(diff, vcgtq_s32(vabsq_s32(u), limU));
+        diff = vorrq_u32(diff, vcgtq_s32(vabsq_s32(v), limV));
+        diff = vbicq_u32(diff, vceqq_u32(vandq_u32(n, maskEq), ceq));
+
+        result = vorrq_u32(result, vandq_u32(diff, vld1q_u32(bits[half])));
+    }
+    uint32x2_t sum = vpadd_u32(vget_low_u32(result), vget_high_u32(result));
+    sum = vpadd_u32(sum, sum);
+    return (unsigned char)vget_lane_u32(sum, 0);
+#else
+    unsigned char mask = 0;
+
+    if (hq2x_interp_32_diff(c[0], c[4]))
+        mask |= 1 << 0;
+    if (hq2x_interp_32_diff(c[1], c[4]))
+        mask |= 1 << 1;
+    if (hq2x_interp_32_diff(c[2], c[4]))
+        mask |= 1 << 2;
+    if (hq2x_interp_32_diff(c[3], c[4]))
+        mask |= 1 << 3;
+    if (hq2x_interp_32_diff(c[5], c[4]))
+        mask |= 1 << 4;
+    if (hq2x_interp_32_diff(c[6], c[4]))
+        mask |= 1 << 5;
+    if (hq2x_interp_32_diff(c[7], c[4]))
+        mask |= 1 << 6;
+    if (hq2x_interp_32_diff(c[8], c[4]))
+        mask |= 1 << 7;
+
+    return mask;
+#endif
+}
+
 static void interp_set(unsigned bits_per_pixel)
 {
     interp_bits_per_pixel = bits_per_pixel;
@@ -409,24 +514,7 @@ static void hq2x_32_def(uint32* dst0, uint32* dst1, const uint32* src0, const ui
             c[8] = src2[0];
         }
 
-        mask = 0;
-
-        if (hq2x_interp_32_diff(c[0], c[4]))
-            mask |= 1 << 0;
-        if (hq2x_interp_32_diff(c[1], c[4]))
-            mask |= 1 << 1;
-        if (hq2x_interp_32_diff(c[2], c[4]))
-            mask |= 1 << 2;
-        if (hq2x_interp_32_diff(c[3], c[4]))
-            mask |= 1 << 3;
-        if (hq2x_interp_32_diff(c[5], c[4]))
-            mask |= 1 << 4;
-        if (hq2x_interp_32_diff(c[6], c[4]))
-            mask |= 1 << 5;
-        if (hq2x_interp_32_diff(c[7], c[4]))
-            mask |= 1 << 6;
-        if (hq2x_interp_32_diff(c[8], c[4]))
-            mask |= 1 << 7;
+        mask = hq2x_32_mask(c);
 
 #define P0 dst0[0]
 #define P1 dst0[1]
@@ -713,118 +801,86 @@ static void lq2x_32_def(uint32* dst0, uint32* dst1, const uint32* src0, const ui
     }
 }
 
-void hq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
-{
-    uint16 *dst0 = (uint16 *)dstPtr;
-    uint16 *dst1 = dst0 + (dstPitch >> 1);
-
-    uint16 *src0 = (uint16 *)srcPtr;
-    uint16 *src1 = src0 + (srcPitch >> 1);
-    uint16 *src2 = src1 + (srcPitch >> 1);
+/* The row functions filter the source rows [firstRow, lastRow) of an image of 'height' rows, so an image can be
+   split in bands which are filtered at the same time. Like it always did, lq2x uses the lq2x kernel for the first and
+   the last row only and the hq2x one in between. */
 
-    hq2x_16_def(dst0, dst1, src0, src0, src1, width);
-    if( height == 1 ) return;
-
-    int count = height;
-
-    count -= 2;
-    while(count>0) {
-        dst0 += dstPitch;
-        dst1 += dstPitch;
+void hq2x_16_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow)
+{
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        uint16 *src0 = (uint16 *)(srcPtr + (y > 0 ? y - 1 : 0) * srcPitch);
+        uint16 *src1 = (uint16 *)(srcPtr + y * srcPitch);
+        uint16 *src2 = (uint16 *)(srcPtr + (y < height - 1 ? y + 1 : y) * srcPitch);
+        uint16 *dst0 = (uint16 *)(dstPtr + y * 2 * dstPitch);
+        uint16 *dst1 = (uint16 *)(dstPtr + (y * 2 + 1) * dstPitch);
         hq2x_16_def(dst0, dst1, src0, src1, src2, width);
-        src0 = src1;
-        src1 = src2;
-        src2 += srcPitch >> 1;
-        --count;
     }
-    dst0 += dstPitch;
-    dst1 += dstPitch;
-    hq2x_16_def(dst0, dst1, src0, src1, src1, width);
 }
 
-void hq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void hq2x_32_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow)
 {
-    uint32 *dst0 = (uint32 *)dstPtr;
-    uint32 *dst1 = dst0 + (dstPitch >> 2);
-
-    uint32 *src0 = (uint32 *)srcPtr;
-    uint32 *src1 = src0 + (srcPitch >> 2);
-    uint32 *src2 = src1 + (srcPitch >> 2);
-    hq2x_32_def(dst0, dst1, src0, src0, src1, width);
-    if( height == 1 ) return;
-
-    int count = height;
-
-    count -= 2;
-    while(count>0) {
-        dst0 += dstPitch >> 1;
-        dst1 += dstPitch >> 1;
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        uint32 *src0 = (uint32 *)(srcPtr + (y > 0 ? y - 1 : 0) * srcPitch);
+        uint32 *src1 = (uint32 *)(srcPtr + y * srcPitch);
+        uint32 *src2 = (uint32 *)(srcPtr + (y < height - 1 ? y + 1 : y) * srcPitch);
+        uint32 *dst0 = (uint32 *)(dstPtr + y * 2 * dstPitch);
+        uint32 *dst1 = (uint32 *)(dstPtr + (y * 2 + 1) * dstPitch);
         hq2x_32_def(dst0, dst1, src0, src1, src2, width);
-        src0 = src1;
-        src1 = src2;
-        src2 += srcPitch >> 2;
-        --count;
     }
-    dst0 += dstPitch >> 1;
-    dst1 += dstPitch >> 1;
-    hq2x_32_def(dst0, dst1, src0, src1, src1, width);
 }
 
-void lq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void lq2x_16_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow)
 {
-    uint16 *dst0 = (uint16 *)dstPtr;
-    uint16 *dst1 = dst0 + (dstPitch >> 1);
-
-    uint16 *src0 = (uint16 *)srcPtr;
-    uint16 *src1 = src0 + (srcPitch >> 1);
-    uint16 *src2 = src1 + (srcPitch >> 1);
-
-    lq2x_16_def(dst0, dst1, src0, src0, src1, width);
-    if( height == 1 ) return;
-
-    int count = height;
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        uint16 *src0 = (uint16 *)(srcPtr + (y > 0 ? y - 1 : 0) * srcPitch);
+        uint16 *src1 = (uint16 *)(srcPtr + y * srcPitch);
+        uint16 *src2 = (uint16 *)(srcPtr + (y < height - 1 ? y + 1 : y) * srcPitch);
+        uint16 *dst0 = (uint16 *)(dstPtr + y * 2 * dstPitch);
+        uint16 *dst1 = (uint16 *)(dstPtr + (y * 2 + 1) * dstPitch);
+        if (y == 0 || y == height - 1)
+            lq2x_16_def(dst0, dst1, src0, src1, src2, width);
+        else
+            hq2x_16_def(dst0, dst1, src0, src1, src2, width);
+    }
+}
 
-    count -= 2;
-    while(count>0) {
-        dst0 += dstPitch;
-        dst1 += dstPitch;
-        hq2x_16_def(dst0, dst1, src0, src1, src2, width);
-        src0 = src1;
-        src1 = src2;
-        src2 += srcPitch >> 1;
-        --count;
+void lq2x_32_rows(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, int firstRow, int lastRow)
+{
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        uint32 *src0 = (uint32 *)(srcPtr + (y > 0 ? y - 1 : 0) * srcPitch);
+        uint32 *src1 = (uint32 *)(srcPtr + y * srcPitch);
+        uint32 *src2 = (uint32 *)(srcPtr + (y < height - 1 ? y + 1 : y) * srcPitch);
+        uint32 *dst0 = (uint32 *)(dstPtr + y * 2 * dstPitch);
+        uint32 *dst1 = (uint32 *)(dstPtr + (y * 2 + 1) * dstPitch);
+        if (y == 0 || y == height - 1)
+            lq2x_32_def(dst0, dst1, src0, src1, src2, width);
+        else
+            hq2x_32_def(dst0, dst1, src0, src1, src2, width);
     }
-    dst0 += dstPitch;
-    dst1 += dstPitch;
-    lq2x_16_def(dst0, dst1, src0, src1, src1, width);
 }
 
-void lq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+void hq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
 {
-    uint32 *dst0 = (uint32 *)dstPtr;
-    uint32 *dst1 = dst0 + (dstPitch >> 2);
+    hq2x_16_rows(srcPtr, srcPitch, dstPtr, dstPitch, width, height, 0, height);
+}
 
-    uint32 *src0 = (uint32 *)srcPtr;
-    uint32 *src1 = src0 + (srcPitch >> 2);
-    uint32 *src2 = src1 + (srcPitch >> 2);
-    lq2x_32_def(dst0, dst1, src0, src0, src1, width);
-    if( height == 1 ) return;
+void hq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+{
+    hq2x_32_rows(srcPtr, srcPitch, dstPtr, dstPitch, width, height, 0, height);
+}
 
-    int count = height;
+void lq2x_16(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+{
+    lq2x_16_rows(srcPtr, srcPitch, dstPtr, dstPitch, width, height, 0, height);
+}
 
-    count -= 2;
-    while(count>0) {
-        dst0 += dstPitch >> 1;
-        dst1 += dstPitch >> 1;
-        hq2x_32_def(dst0, dst1, src0, src1, src2, width);
-        src0 = src1;
-        src1 = src2;
-        src2 += srcPitch >> 2;
-        --count;
-    }
-    dst0 += dstPitch >> 1;
-    dst1 += dstPitch >> 1;
-    lq2x_32_def(dst0, dst1, src0, src1, src1, width);
+void lq2x_32(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height)
+{
+    lq2x_32_rows(srcPtr, srcPitch, dstPtr, dstPitch, width, height, 0, height);
 }
 
 void hq2x_init(unsigned bits_per_pixel)
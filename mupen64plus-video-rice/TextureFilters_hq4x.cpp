@@ -23,6 +23,14 @@
 
 #include "typedefs.h"
 
+#if defined(__SSE2__) && !defined(NO_ASM)
+#include <emmintrin.h>
+#define HQ4X_SSE2
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HQ4X_NEON
+#endif
+
 static int   RGBtoYUV[4096];
 //#define RGB32toYUV(val) (RGBtoYUV[((val&0x00FF0000)>>20)+((val&0x0000FF00)>>12)+((val&0x000000FF)>>4)])
 inline int RGB32toYUV(uint32 val)
@@ -44,7 +52,6 @@ inline int RGB32toYUV(uint32 val)
     return a + (Y<<16) + (u<<8) + v;
 }
 #define RGB16toYUV(val) (RGBtoYUV[(val&0x0FFF)])
-static int   YUV1, YUV2;
 const  int   Amask = 0xFF000000;
 const  int   Ymask = 0x00FF0000;
 const  int   Umask = 0x0000FF00;
@@ -295,8 +302,8 @@ inline void hq4x_Interp8_32(unsigned char * pc, uint32 p1, uint32 p2)
 
 inline bool Diff_16(uint16 w1, uint16 w2)
 {
-    YUV1 = RGB16toYUV(w1);
-    YUV2 = RGB16toYUV(w2);
+    int YUV1 = RGB16toYUV(w1);
+    int YUV2 = RGB16toYUV(w2);
     return ( ( abs((YUV1 & Amask) - (YUV2 & Amask)) > trA ) ||
         ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
         ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
@@ -304,15 +311,123 @@ inline bool Diff_16(uint16 w1, uint16 w2)
 }
 inline bool Diff_32(uint32 w1, uint32 w2)
 {
-    YUV1 = RGB32toYUV(w1);
-    YUV2 = RGB32toYUV(w2);
+    int YUV1 = RGB32toYUV(w1);
+    int YUV2 = RGB32toYUV(w2);
     return ( ( abs((YUV1 & Amask) - (YUV2 & Amask)) > trA ) ||
         ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
         ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
         ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) );
 }
 
-void hq4x_16( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL )
+// Builds the mask of the neighbours w[1..4,6..9] which differ from the center w[5], like the scalar loop in hq4x_16
+// does (a neighbour equal to the center never differs), 4 neighbours at a time where SIMD is available
+inline int Pattern_32(const uint32 *w)
+{
+#if defined(HQ4X_SSE2)
+    const __m128i mask8 = _mm_set1_epi32(0xFF);
+    const __m128i maskA = _mm_set1_epi32(Amask);
+    const __m128i minInt = _mm_set1_epi32(0x80000000);
+    const __m128i limA = _mm_set1_epi32(trA), limAn = _mm_set1_epi32(-trA);
+    const __m128i limY = _mm_set1_epi32(trY >> 16), limYn = _mm_set1_epi32(-(trY >> 16));
+    const __m128i limU = _mm_set1_epi32(trU >> 8), limUn = _mm_set1_epi32(-(trU >> 8));
+    const __m128i limV = _mm_set1_epi32(trV), limVn = _mm_set1_epi32(-trV);
+
+    __m128i yuv[2][4];      // A, Y, U, V of the center (as a whole vector) and of the neighbours
+    __m128i center = _mm_set1_epi32(w[5]);
+    int pattern = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        __m128i n = i == 0 ? center : _mm_loadu_si128((const __m128i *)(i == 1 ? w + 1 : w + 6));
+        __m128i r = _mm_and_si128(_mm_srli_epi32(n, 16), mask8);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(n, 8), mask8);
+        __m128i b = _mm_and_si128(n, mask8);
+        __m128i *p = yuv[i == 0 ? 0 : 1];
+        p[0] = _mm_and_si128(n, maskA);
+        p[1] = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, g), b), 2);
+        p[2] = _mm_srai_epi32(_mm_sub_epi32(r, b), 2);
+        p[3] = _mm_srai_epi32(_mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(g, g), r), b), 3);
+        if (i == 0)
+            continue;
+
+        __m128i d = _mm_sub_epi32(p[0], yuv[0][0]);
+        __m128i diff = _mm_or_si128(_mm_cmpgt_epi32(d, limA),
+                                    _mm_andnot_si128(_mm_cmpeq_epi32(d, minInt), _mm_cmplt_epi32(d, limAn)));
+        d = _mm_sub_epi32(p[1], yuv[0][1]);
+        diff = _mm_or_si128(diff, _mm_or_si128(_mm_cmpgt_epi32(d, limY), _mm_cmplt_epi32(d, limYn)));
+        d = _mm_sub_epi32(p[2], yuv[0][2]);
+        diff = _mm_or_si128(diff, _mm_or_si128(_mm_cmpgt_epi32(d, limU), _mm_cmplt_epi32(d, limUn)));
+        d = _mm_sub_epi32(p[3], yuv[0][3]);
+        diff = _mm_or_si128(diff, _mm_or_si128(_mm_cmpgt_epi32(d, limV), _mm_cmplt_epi32(d, limVn)));
+        diff = _mm_andnot_si128(_mm_cmpeq_epi32(n, center), diff);
+
+        pattern |= _mm_movemask_ps(_mm_castsi128_ps(diff)) << ((i - 1) * 4);
+    }
+    return pattern;
+#elif defined(HQ4X_NEON)
+    static const uint32 bits[2][4] = { { 1, 2, 4, 8 }, { 16, 32, 64, 128 } };
+    const uint32x4_t mask8 = vdupq_n_u32(0xFF);
+    const int32x4_t minInt = vdupq_n_s32(0x80000000);
+    const int32x4_t limA = vdupq_n_s32(trA);
+    const int32x4_t limY = vdupq_n_s32(trY >> 16);
+    const int32x4_t limU = vdupq_n_s32(trU >> 8);
+    const int32x4_t limV = vdupq_n_s32(trV);
+
+    int32x4_t yuv[2][4];
+    uint32x4_t center = vdupq_n_u32(w[5]);
+    uint32x4_t result = vdupq_n_u32(0);
+
+    for (int i = 0; i < 3; i++)
+    {
+        uint32x4_t n = i == 0 ? center : vld1q_u32(i == 1 ? w + 1 : w + 6);
+        int32x4_t r = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(n, 16), mask8));
+        int32x4_t g = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(n, 8), mask8));
+        int32x4_t b = vreinterpretq_s32_u32(vandq_u32(n, mask8));
+        int32x4_t *p = yuv[i == 0 ? 0 : 1];
+        p[0] = vreinterpretq_s32_u32(vandq_u32(n, vdupq_n_u32(0xFF000000)));
+        p[1] = vshrq_n_s32(vaddq_s32(vaddq_s32(r, g), b), 2);
+        p[2] = vshrq_n_s32(vsubq_s32(r, b), 2);
+        p[3] = vshrq_n_s32(vsubq_s32(vsubq_s32(vaddq_s32(g, g), r), b), 3);
+        if (i == 0)
+            continue;
+
+        int32x4_t d = vsubq_s32(p[0], yuv[0][0]);
+        uint32x4_t diff = vbicq_u32(vcgtq_s32(vabsq_s32(d), limA), vceqq_s32(d, minInt));
+        diff = vorrq_u32(diff, vcgtq_s32(vabdq_s32(p[1], yuv[0][1]), limY));
+        diff = vorrq_u32(diff, vcgtq_s32(vabdq_s32(p[2], yuv[0][2]), limU));
+        diff = vorrq_u32(diff, vcgtq_s32(vabdq_s32(p[3], yuv[0][3]), limV));
+        diff = vbicq_u32(diff, vceqq_u32(n, center));
+
+        result = vorrq_u32(result, vandq_u32(diff, vld1q_u32(bits[i - 1])));
+    }
+    uint32x2_t sum = vpadd_u32(vget_low_u32(result), vget_high_u32(result));
+    sum = vpadd_u32(sum, sum);
+    return (int)vget_lane_u32(sum, 0);
+#else
+    int pattern = 0;
+    int flag = 1;
+    int YUV1 = RGB32toYUV(w[5]);
+
+    for (int k=1; k<=9; k++)
+    {
+        if (k==5) continue;
+
+        if ( w[k] != w[5] )
+        {
+            int YUV2 = RGB32toYUV(w[k]);
+            if ( ( abs((YUV1 & Amask) - (YUV2 & Amask)) > trA ) ||
+                ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
+                ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
+                ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
+                pattern |= flag;
+        }
+        flag <<= 1;
+    }
+    return pattern;
+#endif
+}
+
+void hq4x_16_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL, int firstRow, int lastRow )
 {
 #define hq4x_Interp1 hq4x_Interp1_16
 #define hq4x_Interp2 hq4x_Interp2_16
@@ -343,7 +458,12 @@ void hq4x_16( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    int  YUV1, YUV2;
+
+    pIn += firstRow * SrcPPL * 2;
+    pOut += firstRow * (SrcPPL * 8 + BpL * 3);
+
+    for (j=firstRow; j<lastRow; j++)
     {
         if (j>0)      prevline = -SrcPPL*2; else prevline = 0;
         if (j<Yres-1) nextline =  SrcPPL*2; else nextline = 0;
@@ -430,7 +550,7 @@ void hq4x_16( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
 #undef hq4x_Interp8
 }
 
-void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL )
+void hq4x_32_rows( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL, int firstRow, int lastRow )
 {
 #define hq4x_Interp1 hq4x_Interp1_32
 #define hq4x_Interp2 hq4x_Interp2_32
@@ -461,7 +581,10 @@ void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    pIn += firstRow * SrcPPL * 4;
+    pOut += firstRow * (SrcPPL * 16 + BpL * 3);
+
+    for (j=firstRow; j<lastRow; j++)
     {
         if (j>0)      prevline = -SrcPPL*4; else prevline = 0;
         if (j<Yres-1) nextline =  SrcPPL*4; else nextline = 0;
@@ -498,26 +621,7 @@ void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
                 w[9] = w[8];
             }
 
-            int pattern = 0;
-            int flag = 1;
-
-            YUV1 = RGB32toYUV(w[5]);
-
-            for (k=1; k<=9; k++)
-            {
-                if (k==5) continue;
-
-                if ( w[k] != w[5] )
-                {
-                    YUV2 = RGB32toYUV(w[k]);
-                    if ( ( abs((YUV1 & Amask) - (YUV2 & Amask)) > trA ) ||
-                        ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-                        ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-                        ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-                        pattern |= flag;
-                }
-                flag <<= 1;
-            }
+            int pattern = Pattern_32(w);
 
             for (k=1; k<=9; k++)
                 c[k] = w[k];
@@ -549,6 +653,16 @@ void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
 #undef hq4x_Interp8
 }
 
+void hq4x_16( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL )
+{
+    hq4x_16_rows(pIn, pOut, Xres, Yres, SrcPPL, BpL, 0, Yres);
+}
+
+void hq4x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int SrcPPL, int BpL )
+{
+    hq4x_32_rows(pIn, pOut, Xres, Yres, SrcPPL, BpL, 0, Yres);
+}
+
 void hq4x_InitLUTs(void)
 {
     static bool done = false;
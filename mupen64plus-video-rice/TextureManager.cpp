@@ -25,73 +25,35 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "FrameBuffer.h"
 #include "RenderBase.h"
 #include "TextureManager.h"
+#include "TextureCRC.h"
 
 CTextureManager gTextureManager;
 
-unsigned int g_maxTextureMemUsage = (5*1024*1024);
-unsigned int g_amountToFree = (512*1024);
-bool g_bUseSetTextureMem = false;
+#define TEXTURE_HASH_INITIAL_SIZE   1024    // buckets, a power of 2, the table doubles when it gets more entries
 
 #ifdef __QNXNTO__
 using namespace std;
 #endif
 
-// Returns the first prime greater than or equal to nFirst
-inline int GetNextPrime(int nFirst)
-{
-    int nCurrent;
-
-    nCurrent = nFirst;
-
-    // Just make sure it's odd
-    if ((nCurrent % 2) == 0)
-        nCurrent++;
-
-    for (;;)
-    {
-        int nSqrtCurrent;
-        BOOL bIsComposite;
-
-        // nSqrtCurrent = nCurrent^0.5 + 1 (round up)
-        nSqrtCurrent = (int)sqrt((double)nCurrent) + 1;
-
-        bIsComposite = FALSE;
-        
-        // Test all odd numbers from 3..nSqrtCurrent
-        for (int i = 3; i <= nSqrtCurrent; i+=2)
-        {
-            if ((nCurrent % i) == 0)
-            {
-                bIsComposite = TRUE;
-                break;
-            }
-        }
-
-        if (!bIsComposite)
-        {           
-            return nCurrent;
-        }
-
-        // Select next odd candidate...
-        nCurrent += 2;
-    }
-}
-
-
-
 ///////////////////////////////////////////////////////////////////////
 //
 ///////////////////////////////////////////////////////////////////////
 CTextureManager::CTextureManager() :
-    m_pHead(NULL),
     m_pCacheTxtrList(NULL),
-    m_numOfCachedTxtrList(809)
+    m_numOfCachedTxtrList(TEXTURE_HASH_INITIAL_SIZE),
+    m_numOfCachedTxtr(0),
+    m_numOfRecycledTxtr(0)
 {
-    m_numOfCachedTxtrList = GetNextPrime(800);
-
     m_currentTextureMemUsage    = 0;
+    m_recycledTextureMemUsage   = 0;
     m_pYoungestTexture          = NULL;
     m_pOldestTexture            = NULL;
+    m_pYoungestRecycled         = NULL;
+    m_pOldestRecycled           = NULL;
+    for (uint32 i = 0; i < RECYCLED_TEXTURE_HASH_SIZE; i++)
+        m_pRecycledTxtrList[i] = NULL;
+    memset(&m_stats, 0, sizeof(m_stats));
+    memset(m_CRCMemo, 0, sizeof(m_CRCMemo));
 
     m_pCacheTxtrList = new TxtrCacheEntry *[m_numOfCachedTxtrList];
     SAFE_CHECK(m_pCacheTxtrList);
@@ -121,17 +83,7 @@ CTextureManager::~CTextureManager()
 bool CTextureManager::CleanUp()
 {
     RecycleAllTextures();
-
-    if (!g_bUseSetTextureMem)
-    {
-        while (m_pHead)
-        {
-            TxtrCacheEntry * pVictim = m_pHead;
-            m_pHead = pVictim->pNext;
-
-            delete pVictim;
-        }
-    }
+    FreeRecycledTextures(0);
 
     if( m_blackTextureEntry.pTexture )      delete m_blackTextureEntry.pTexture;    
     if( m_PrimColorTextureEntry.pTexture )  delete m_PrimColorTextureEntry.pTexture;
@@ -164,59 +116,26 @@ void CTextureManager::PurgeOldTextures()
     if (m_pCacheTxtrList == NULL)
         return;
     
-    if (g_bUseSetTextureMem)
-        return;
-
     static const uint32 dwFramesToKill = 5*30;          // 5 secs at 30 fps
     static const uint32 dwFramesToDelete = 30*30;       // 30 secs at 30 fps
     
-    for ( uint32 i = 0; i < m_numOfCachedTxtrList; i++ )
+    // The age list is sorted by last usage, so only the textures which are old enough are visited
+    TxtrCacheEntry * pEntry = m_pOldestTexture;
+    while (pEntry && status.gDlistCount - pEntry->FrameLastUsed > dwFramesToKill)
     {
-        TxtrCacheEntry * pEntry;
-        TxtrCacheEntry * pNext;
-        
-        pEntry = m_pCacheTxtrList[i];
-        while (pEntry)
+        TxtrCacheEntry * pNext = pEntry->pNextYoungest;
+        if (!TCacheEntryIsLoaded(pEntry))
         {
-            pNext = pEntry->pNext;
-            
-            if ( status.gDlistCount - pEntry->FrameLastUsed > dwFramesToKill && !TCacheEntryIsLoaded(pEntry))
-            {
-                RemoveTexture(pEntry);
-            }
-            pEntry = pNext;
+            RemoveTexture(pEntry);
+            m_stats.purges++;
         }
+        pEntry = pNext;
     }
     
-    
     // Remove any old textures that haven't been recycled in 1 minute or so
     // Normally these would be reused
-    TxtrCacheEntry * pPrev;
-    TxtrCacheEntry * pCurr;
-    TxtrCacheEntry * pNext;
-    
-    
-    pPrev = NULL;
-    pCurr = m_pHead;
-    
-    while (pCurr)
-    {
-        pNext = pCurr->pNext;
-        
-        if ( status.gDlistCount - pCurr->FrameLastUsed > dwFramesToDelete && !TCacheEntryIsLoaded(pCurr) )
-        {
-            if (pPrev != NULL) pPrev->pNext        = pCurr->pNext;
-            else               m_pHead = pCurr->pNext;
-            
-            delete pCurr;
-            pCurr = pNext;  
-        }
-        else
-        {
-            pPrev = pCurr;
-            pCurr = pNext;
-        }
-    }
+    while (m_pOldestRecycled && status.gDlistCount - m_pOldestRecycled->FrameLastUsed > dwFramesToDelete)
+        DeleteRecycledTexture(m_pOldestRecycled);
 }
 
 void CTextureManager::RecycleAllTextures()
@@ -224,9 +143,6 @@ void CTextureManager::RecycleAllTextures()
     if (m_pCacheTxtrList == NULL)
         return;
     
-    uint32 dwCount = 0;
-    uint32 dwTotalUses = 0;
-    
     m_pYoungestTexture          = NULL;
     m_pOldestTexture            = NULL;
 
@@ -237,40 +153,30 @@ void CTextureManager::RecycleAllTextures()
             TxtrCacheEntry *pTVictim = m_pCacheTxtrList[i];
             m_pCacheTxtrList[i] = pTVictim->pNext;
             
-            dwTotalUses += pTVictim->dwUses;
-            dwCount++;
-            if (g_bUseSetTextureMem)
-                delete pTVictim;
-            else
+            m_currentTextureMemUsage -= GetTextureMemUsage(pTVictim);
             RecycleTexture(pTVictim);
         }
     }
+    m_numOfCachedTxtr = 0;
+    memset(m_CRCMemo, 0, sizeof(m_CRCMemo));
 }
 
 void CTextureManager::RecheckHiresForAllTextures()
 {
-    if (m_pCacheTxtrList == NULL)
-        return;
-
-    for (uint32 i = 0; i < m_numOfCachedTxtrList; i++)
-    {
-        while (m_pCacheTxtrList[i])
-        {
-            TxtrCacheEntry *pTVictim = m_pCacheTxtrList[i];
-            m_pCacheTxtrList[i] = pTVictim->pNext;
-            pTVictim->bExternalTxtrChecked = false;
-
-        }
-    }
+    for (TxtrCacheEntry *pEntry = m_pOldestTexture; pEntry; pEntry = pEntry->pNextYoungest)
+        pEntry->bExternalTxtrChecked = false;
 }
 
+uint32 CTextureManager::GetTextureMemUsage(TxtrCacheEntry *pEntry)
+{
+    if (pEntry->pTexture == NULL)
+        return 0;
+    return pEntry->pTexture->m_dwCreatedTextureWidth * pEntry->pTexture->m_dwCreatedTextureHeight * pEntry->pTexture->GetPixelSize();
+}
 
-// Add to the recycle list
+// Add to the recycle pool, the entry must not be in the hash table nor in the age list any more
 void CTextureManager::RecycleTexture(TxtrCacheEntry *pEntry)
 {
-    if (g_bUseSetTextureMem)
-        return;
-
     if( CDeviceBuilder::GetGeneralDeviceType() == OGL_DEVICE )
     {
         // Fix me, why I can not reuse the texture in OpenGL,
@@ -286,80 +192,197 @@ void CTextureManager::RecycleTexture(TxtrCacheEntry *pEntry)
     }
     else
     {
-        // Add to the list
-        pEntry->pNext = m_pHead;
+        // Add to the list of its size, and to the young end of the recycled age list
         SAFE_DELETE(pEntry->pEnhancedTexture);
-        m_pHead = pEntry;
+        pEntry->FrameLastUsed = status.gDlistCount;
+        uint32 dwKey = RecycledHash(pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate);
+        pEntry->pNext = m_pRecycledTxtrList[dwKey];
+        m_pRecycledTxtrList[dwKey] = pEntry;
+
+        pEntry->pNextYoungest = NULL;
+        pEntry->pLastYoungest = m_pYoungestRecycled;
+        if (m_pYoungestRecycled)
+            m_pYoungestRecycled->pNextYoungest = pEntry;
+        else
+            m_pOldestRecycled = pEntry;
+        m_pYoungestRecycled = pEntry;
+
+        m_numOfRecycledTxtr++;
+        m_recycledTextureMemUsage += GetTextureMemUsage(pEntry);
     }
 }
 
+// Takes the recycled texture *ppEntry out of its size list and of the recycled age list
+TxtrCacheEntry * CTextureManager::UnlinkRecycledTexture(TxtrCacheEntry **ppEntry)
+{
+    TxtrCacheEntry *pEntry = *ppEntry;
+    *ppEntry = pEntry->pNext;
+    pEntry->pNext = NULL;
+
+    if (pEntry == m_pOldestRecycled)
+        m_pOldestRecycled = pEntry->pNextYoungest;
+    if (pEntry == m_pYoungestRecycled)
+        m_pYoungestRecycled = pEntry->pLastYoungest;
+    if (pEntry->pNextYoungest)
+        pEntry->pNextYoungest->pLastYoungest = pEntry->pLastYoungest;
+    if (pEntry->pLastYoungest)
+        pEntry->pLastYoungest->pNextYoungest = pEntry->pNextYoungest;
+    pEntry->pNextYoungest = NULL;
+    pEntry->pLastYoungest = NULL;
+
+    m_numOfRecycledTxtr--;
+    m_recycledTextureMemUsage -= GetTextureMemUsage(pEntry);
+    return pEntry;
+}
+
 // Search for a texture of the specified dimensions to recycle
 TxtrCacheEntry * CTextureManager::ReviveTexture( uint32 width, uint32 height )
 {
-    if (g_bUseSetTextureMem)
-        return NULL;
-
-    TxtrCacheEntry * pPrev;
-    TxtrCacheEntry * pCurr;
-    
-    pPrev = NULL;
-    pCurr = m_pHead;
-    
-    while (pCurr)
+    // the most recently recycled one of that size comes first
+    TxtrCacheEntry ** ppCurr = &m_pRecycledTxtrList[RecycledHash(width, height)];
+    while (*ppCurr)
     {
-        if (pCurr->ti.WidthToCreate == width &&
-            pCurr->ti.HeightToCreate == height)
-        {
-            // Remove from list
-            if (pPrev != NULL) pPrev->pNext        = pCurr->pNext;
-            else               m_pHead = pCurr->pNext;
-            
-            return pCurr;
-        }
-        
-        pPrev = pCurr;
-        pCurr = pCurr->pNext;
+        if ((*ppCurr)->ti.WidthToCreate == width && (*ppCurr)->ti.HeightToCreate == height)
+            return UnlinkRecycledTexture(ppCurr);
+        ppCurr = &(*ppCurr)->pNext;
     }
     
     return NULL;
 }
 
+void CTextureManager::DeleteRecycledTexture(TxtrCacheEntry *pEntry)
+{
+    TxtrCacheEntry ** ppCurr = &m_pRecycledTxtrList[RecycledHash(pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate)];
+    while (*ppCurr && *ppCurr != pEntry)
+        ppCurr = &(*ppCurr)->pNext;
+
+    if (*ppCurr)
+        delete UnlinkRecycledTexture(ppCurr);
+}
 
-uint32 CTextureManager::Hash(uint32 dwValue)
+// Deletes recycled textures, oldest first, until the whole cache uses less than dwMaxUsage bytes or there are none left
+void CTextureManager::FreeRecycledTextures(uint32 dwMaxUsage)
 {
-    // Divide by four, because most textures will be on a 4 byte boundry, so bottom four
-    // bits are null
-    return (dwValue>>2) % m_numOfCachedTxtrList;
+    while (m_pOldestRecycled && m_currentTextureMemUsage + m_recycledTextureMemUsage > dwMaxUsage)
+        DeleteRecycledTexture(m_pOldestRecycled);
 }
 
-void CTextureManager::MakeTextureYoungest(TxtrCacheEntry *pEntry)
+// Makes room for dwBytes more bytes of textures within the memory budget: the recycled textures go first, then the
+// least recently used ones, except those bound for the current primitive
+void CTextureManager::FreeTextureMem(uint32 dwBytes)
 {
-    if (!g_bUseSetTextureMem)
+    if (options.textureCacheSize == 0)
         return;
 
-    if (pEntry == m_pYoungestTexture)
-        return;
+    uint32 dwMaxUsage = options.textureCacheSize * 1024 * 1024;
+    dwMaxUsage = dwBytes < dwMaxUsage ? dwMaxUsage - dwBytes : 0;
 
-    // if its the oldest, then change the oldest pointer
-    if (pEntry == m_pOldestTexture)
-    {
-        m_pOldestTexture = pEntry->pNextYoungest;
-    }
+    FreeRecycledTextures(dwMaxUsage);
 
-    // if its a not a new texture, close the gap in the age list
-    // where pEntry use to reside
-    if (pEntry->pNextYoungest != NULL || pEntry->pLastYoungest != NULL)
+    TxtrCacheEntry *pEntry = m_pOldestTexture;
+    while (pEntry && m_currentTextureMemUsage > dwMaxUsage)
     {
-        if (pEntry->pNextYoungest != NULL)
+        TxtrCacheEntry *pNext = pEntry->pNextYoungest;
+        if (!TCacheEntryIsLoaded(pEntry))
         {
-            pEntry->pNextYoungest->pLastYoungest = pEntry->pLastYoungest;
+            RemoveFromHashTable(pEntry);
+            RemoveFromAgeList(pEntry);
+            m_currentTextureMemUsage -= GetTextureMemUsage(pEntry);
+            delete pEntry;
+            m_stats.evictions++;
         }
-        if (pEntry->pLastYoungest != NULL)
+        pEntry = pNext;
+    }
+}
+
+
+uint32 CTextureManager::Hash(const TxtrInfo &ti)
+{
+    // Mixes the fields compared by TxtrInfo::operator== which identify a texture, except WidthToLoad and HeightToLoad
+    // which GetTexture() changes while the entry is in the table. Textures are mostly on 4 byte boundaries, so the
+    // bottom two bits of the address are null.
+    uint32 h = ti.Address >> 2;
+    h = h * 31 + ti.WidthToCreate;
+    h = h * 31 + ti.HeightToCreate;
+    h = h * 31 + ((ti.Format << 4) | (ti.Size << 2) | ti.TLutFmt);
+    h = h * 31 + ti.Palette;
+    h = h * 31 + (uint32)(unsigned long)ti.PalAddress;
+    h = h * 31 + (uint32)ti.LeftToLoad;
+    h = h * 31 + (uint32)ti.TopToLoad;
+    h = h * 31 + ti.Pitch;
+    h = h * 31 + ((ti.maskS << 8) | (ti.maskT << 4) | (ti.mirrorS << 3) | (ti.mirrorT << 2) | (ti.clampS << 1) | ti.clampT);
+    h ^= h >> 16;
+    h *= 0x7FEB352D;
+    h ^= h >> 15;
+    return h & (m_numOfCachedTxtrList - 1);
+}
+
+TextureCRCMemo * CTextureManager::FindCRCMemo(const TxtrInfo &ti)
+{
+    uint32 h = (uint32)(unsigned long)ti.pPhysicalAddress >> 2;
+    h = h * 31 + (uint32)ti.LeftToLoad;
+    h = h * 31 + (uint32)ti.TopToLoad;
+    h = h * 31 + ti.WidthToLoad;
+    h = h * 31 + ti.HeightToLoad;
+    h = h * 31 + ((ti.Pitch << 2) | ti.Size);
+    h ^= h >> 16;
+    h *= 0x7FEB352D;
+    h ^= h >> 15;
+    return &m_CRCMemo[h & (TEXTURE_CRC_MEMO_SIZE-1)];
+}
+
+void CTextureManager::GrowHashTable()
+{
+    uint32 numOld = m_numOfCachedTxtrList;
+    TxtrCacheEntry **pOld = m_pCacheTxtrList;
+
+    m_numOfCachedTxtrList = numOld * 2;
+    m_pCacheTxtrList = new TxtrCacheEntry *[m_numOfCachedTxtrList];
+    SAFE_CHECK(m_pCacheTxtrList);
+    for (uint32 i = 0; i < m_numOfCachedTxtrList; i++)
+        m_pCacheTxtrList[i] = NULL;
+
+    for (uint32 i = 0; i < numOld; i++)
+    {
+        while (pOld[i])
         {
-            pEntry->pLastYoungest->pNextYoungest = pEntry->pNextYoungest;
+            TxtrCacheEntry *pEntry = pOld[i];
+            pOld[i] = pEntry->pNext;
+
+            uint32 dwKey = Hash(pEntry->ti);
+            pEntry->pNext = m_pCacheTxtrList[dwKey];
+            m_pCacheTxtrList[dwKey] = pEntry;
         }
     }
 
+    delete [] pOld;
+}
+
+void CTextureManager::RemoveFromAgeList(TxtrCacheEntry *pEntry)
+{
+    if (pEntry == m_pOldestTexture)
+        m_pOldestTexture = pEntry->pNextYoungest;
+    if (pEntry == m_pYoungestTexture)
+        m_pYoungestTexture = pEntry->pLastYoungest;
+
+    if (pEntry->pNextYoungest != NULL)
+        pEntry->pNextYoungest->pLastYoungest = pEntry->pLastYoungest;
+    if (pEntry->pLastYoungest != NULL)
+        pEntry->pLastYoungest->pNextYoungest = pEntry->pNextYoungest;
+
+    pEntry->pNextYoungest = NULL;
+    pEntry->pLastYoungest = NULL;
+}
+
+// Moves the texture to the young end of the age list, called whenever its FrameLastUsed is updated so the list stays
+// sorted by last usage
+void CTextureManager::MakeTextureYoungest(TxtrCacheEntry *pEntry)
+{
+    if (pEntry == m_pYoungestTexture)
+        return;
+
+    RemoveFromAgeList(pEntry);
+
     // this texture is now the youngest, so place it on the end of the list
     if (m_pYoungestTexture != NULL)
     {
@@ -379,16 +402,19 @@ void CTextureManager::MakeTextureYoungest(TxtrCacheEntry *pEntry)
 
 void CTextureManager::AddTexture(TxtrCacheEntry *pEntry)
 {   
-    uint32 dwKey = Hash(pEntry->ti.Address);
-    
     if (m_pCacheTxtrList == NULL)
         return;
     
-    //TxtrCacheEntry **p = &m_pCacheTxtrList[dwKey];
+    if (m_numOfCachedTxtr >= m_numOfCachedTxtrList)
+        GrowHashTable();
+
+    uint32 dwKey = Hash(pEntry->ti);
     
     // Add to head (not tail, for speed - new textures are more likely to be accessed next)
     pEntry->pNext = m_pCacheTxtrList[dwKey];
     m_pCacheTxtrList[dwKey] = pEntry;
+    m_numOfCachedTxtr++;
+    m_currentTextureMemUsage += GetTextureMemUsage(pEntry);
 
     // Move the texture to the top of the age list
     MakeTextureYoungest(pEntry);
@@ -404,13 +430,12 @@ TxtrCacheEntry * CTextureManager::GetTxtrCacheEntry(TxtrInfo * pti)
         return NULL;
     
     // See if it is already in the hash table
-    uint32 dwKey = Hash(pti->Address);
+    uint32 dwKey = Hash(*pti);
 
     for (pEntry = m_pCacheTxtrList[dwKey]; pEntry; pEntry = pEntry->pNext)
     {
         if ( pEntry->ti == *pti )
         {
-            MakeTextureYoungest(pEntry);
             return pEntry;
         }
     }
@@ -419,95 +444,50 @@ TxtrCacheEntry * CTextureManager::GetTxtrCacheEntry(TxtrInfo * pti)
 }
 
 
-
-void CTextureManager::RemoveTexture(TxtrCacheEntry * pEntry)
+void CTextureManager::RemoveFromHashTable(TxtrCacheEntry * pEntry)
 {
-    TxtrCacheEntry * pPrev;
-    TxtrCacheEntry * pCurr;
+    TxtrCacheEntry ** ppCurr = &m_pCacheTxtrList[Hash(pEntry->ti)];
     
-    if (m_pCacheTxtrList == NULL)
-        return;
-    
-    // See if it is already in the hash table
-    uint32 dwKey = Hash(pEntry->ti.Address);
-    
-    pPrev = NULL;
-    pCurr = m_pCacheTxtrList[dwKey];
-    
-    while (pCurr)
+    while (*ppCurr)
     {
-        // Check that the attributes match
-        if ( pCurr->ti == pEntry->ti )
+        if (*ppCurr == pEntry)
         {
-            if (pPrev != NULL) 
-                pPrev->pNext = pCurr->pNext;
-            else
-               m_pCacheTxtrList[dwKey] = pCurr->pNext;
-
-            if (g_bUseSetTextureMem)
-            {
-                // remove the texture from the age list
-                if (pEntry->pNextYoungest != NULL)
-                {
-                    pEntry->pNextYoungest->pLastYoungest = pEntry->pLastYoungest;
-                }
-                if (pEntry->pLastYoungest != NULL)
-                {
-                    pEntry->pLastYoungest->pNextYoungest = pEntry->pNextYoungest;
-                }
-
-                // decrease the mem usage counter
-                m_currentTextureMemUsage -= (pEntry->pTexture->m_dwWidth * pEntry->pTexture->m_dwHeight * 4);
-            
-                delete pEntry;
-            }
-            else
-            {
-                RecycleTexture(pEntry);
-            }
-
+            *ppCurr = pEntry->pNext;
+            m_numOfCachedTxtr--;
             break;
         }
-
-        pPrev = pCurr;
-        pCurr = pCurr->pNext;
+        ppCurr = &(*ppCurr)->pNext;
     }
+}
+
+void CTextureManager::RemoveTexture(TxtrCacheEntry * pEntry)
+{
+    if (m_pCacheTxtrList == NULL)
+        return;
     
+    RemoveFromHashTable(pEntry);
+    RemoveFromAgeList(pEntry);
+    m_currentTextureMemUsage -= GetTextureMemUsage(pEntry);
+    RecycleTexture(pEntry);
 }
     
-TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight)
+TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(TxtrInfo * pti)
 {
-    TxtrCacheEntry * pEntry = NULL;
-
-    if (g_bUseSetTextureMem)
-    {
-        uint32 widthToCreate = dwWidth;
-        uint32 heightToCreate = dwHeight;
-        unsigned int freeUpSize = (widthToCreate * heightToCreate * 4) + g_amountToFree;
-
-        // make sure there is enough room for the new texture by deleting old textures
-        while ((m_currentTextureMemUsage + freeUpSize) > g_maxTextureMemUsage && m_pOldestTexture != NULL)
-        {
-            TxtrCacheEntry *nextYoungest = m_pOldestTexture->pNextYoungest;
-
-            RemoveTexture(m_pOldestTexture);
-
-            m_pOldestTexture = nextYoungest;
+    uint32 dwWidth = pti->WidthToCreate;
+    uint32 dwHeight = pti->HeightToCreate;
 
-        //printf("Freeing Texture\n");
-        }
+    // Find a used texture
+    TxtrCacheEntry * pEntry = ReviveTexture(dwWidth, dwHeight);
 
-        m_currentTextureMemUsage += widthToCreate * heightToCreate * 4;
+    if (pEntry)
+    {
+        m_stats.revived++;
     }
     else
     {
-    // Find a used texture
-    pEntry = ReviveTexture(dwWidth, dwHeight);
-    }
+        // Couldn't find on - recreate! The size is a guess until the texture exists, 32 bits per pixel at most.
+        FreeTextureMem(dwWidth * dwHeight * 4);
 
-    if (pEntry == NULL || g_bUseSetTextureMem)
-    {
-        // Couldn't find on - recreate!
         pEntry = new TxtrCacheEntry;
         if (pEntry == NULL)
         {
@@ -528,8 +508,8 @@ TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWi
         }
     }
     
-    // Initialize
-    pEntry->ti.Address = dwAddr;
+    // Initialize, the whole identity is needed to place the entry in the hash table
+    pEntry->ti = *pti;
     pEntry->pNext = NULL;
     pEntry->pNextYoungest = NULL;
     pEntry->pLastYoungest = NULL;
@@ -547,15 +527,48 @@ TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWi
     return pEntry;  
 }
 
-// If already in table, return
-// Otherwise, create surfaces, and load texture into memory
-uint32 dwAsmHeight;
-uint32 dwAsmPitch;
-uint32 dwAsmdwBytesPerLine;
 uint32 dwAsmCRC;
-uint32 dwAsmCRC2;
-uint8* pAsmStart;
 
+// The CRC of the texture, in dwAsmCRC too, and its max CI in *pMaxCI when it was found in the same pass (it is left
+// alone otherwise). A rect of RDRAM is hashed once per display list, as long as the N64 doesn't render to RDRAM, which
+// is when GetTexture() trusts the CRC of an entry used again in the same display list.
+uint32 CTextureManager::CalculateCRC(TxtrInfo *pgti, int *pMaxCI)
+{
+    bool bMemoize = status.gDlistCount != 0 && !status.bN64FrameBufferIsUsed;
+    TextureCRCMemo *pMemo = FindCRCMemo(*pgti);
+
+    if( bMemoize && pMemo->dwDlistCount == status.gDlistCount && pMemo->pPhysicalAddress == pgti->pPhysicalAddress &&
+        pMemo->LeftToLoad == pgti->LeftToLoad && pMemo->TopToLoad == pgti->TopToLoad &&
+        pMemo->WidthToLoad == pgti->WidthToLoad && pMemo->HeightToLoad == pgti->HeightToLoad &&
+        pMemo->Size == pgti->Size && pMemo->Pitch == pgti->Pitch )
+    {
+        if( pMaxCI != NULL && pMemo->maxCI >= 0 )
+            *pMaxCI = pMemo->maxCI;
+        m_stats.crcReused++;
+        dwAsmCRC = pMemo->dwCRC;
+        return dwAsmCRC;
+    }
+
+    CalculateRDRAMCRC(pgti->pPhysicalAddress, pgti->LeftToLoad, pgti->TopToLoad, pgti->WidthToLoad, pgti->HeightToLoad, pgti->Size, pgti->Pitch, pMaxCI);
+
+    if( bMemoize )
+    {
+        pMemo->pPhysicalAddress = pgti->pPhysicalAddress;
+        pMemo->LeftToLoad = pgti->LeftToLoad;
+        pMemo->TopToLoad = pgti->TopToLoad;
+        pMemo->WidthToLoad = pgti->WidthToLoad;
+        pMemo->HeightToLoad = pgti->HeightToLoad;
+        pMemo->Size = pgti->Size;
+        pMemo->Pitch = pgti->Pitch;
+        pMemo->dwDlistCount = status.gDlistCount;
+        pMemo->dwCRC = dwAsmCRC;
+        pMemo->maxCI = pMaxCI != NULL ? *pMaxCI : -1;   // still -1 if it wasn't found
+    }
+    return dwAsmCRC;
+}
+
+// If already in table, return
+// Otherwise, create surfaces, and load texture into memory
 TxtrCacheEntry *g_lastTextureEntry=NULL;
 bool lastEntryModified = false;
 
@@ -615,6 +628,9 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
         }
     }
 
+    bool bCheckPalette = doCRCCheck && (pgti->Format == TXT_FMT_CI || (pgti->Format == TXT_FMT_RGBA && pgti->Size <= TXT_SIZE_8b ));
+    int crcMaxCI = -1;
+
     if (pEntry && pEntry->dwTimeLastUsed == status.gRDPTime && status.gDlistCount != 0 && !status.bN64FrameBufferIsUsed )       // This is not good, Palatte may changes
     {
         // We've already calculated a CRC this frame!
@@ -627,17 +643,20 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
             if( loadFromTextureBuffer )
                 dwAsmCRC = gRenderTextureInfos[txtBufIdxToLoadFrom].crcInRDRAM;
             else
-                CalculateRDRAMCRC(pgti->pPhysicalAddress, pgti->LeftToLoad, pgti->TopToLoad, pgti->WidthToLoad, pgti->HeightToLoad, pgti->Size, pgti->Pitch);
+                CalculateCRC(pgti, bCheckPalette ? &crcMaxCI : NULL);
         }
     }
 
     int maxCI = 0;
-    if ( doCRCCheck && (pgti->Format == TXT_FMT_CI || (pgti->Format == TXT_FMT_RGBA && pgti->Size <= TXT_SIZE_8b )))
+    if ( bCheckPalette )
     {
         //maxCI = pgti->Size == TXT_SIZE_8b ? 255 : 15;
-        extern unsigned char CalculateMaxCI(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes );
-
-        if( !pEntry || pEntry->dwCRC != dwAsmCRC || pEntry->maxCI < 0 )
+        if( crcMaxCI >= 0 )
+        {
+            // found with the CRC
+            maxCI = crcMaxCI;
+        }
+        else if( !pEntry || pEntry->dwCRC != dwAsmCRC || pEntry->maxCI < 0 )
         {
             maxCI = CalculateMaxCI(pgti->pPhysicalAddress, pgti->LeftToLoad, pgti->TopToLoad, pgti->WidthToLoad, pgti->HeightToLoad, pgti->Size, pgti->Pitch);
         }
@@ -683,6 +702,8 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
             pEntry->dwUses++;
             pEntry->dwTimeLastUsed = status.gRDPTime;
             pEntry->FrameLastUsed = status.gDlistCount;
+            MakeTextureYoungest(pEntry);
+            m_stats.hits++;
             LOG_TEXTURE(TRACE0("   Use current texture:\n"));
             pEntry->lastEntry = g_lastTextureEntry;
             g_lastTextureEntry = pEntry;
@@ -704,7 +725,7 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
     {
         // We need to create a new entry, and add it
         //  to the hash table.
-        pEntry = CreateNewCacheEntry(pgti->Address, pgti->WidthToCreate, pgti->HeightToCreate);
+        pEntry = CreateNewCacheEntry(pgti);
 
         if (pEntry == NULL)
         {
@@ -712,6 +733,14 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
             _VIDEO_DisplayTemporaryMessage("Fail to create new texture entry");
             return NULL;
         }
+        m_stats.misses++;
+    }
+    else
+    {
+        // The texture has changed in RDRAM, it is reloaded in the same entry
+        pEntry->FrameLastUsed = status.gDlistCount;
+        MakeTextureYoungest(pEntry);
+        m_stats.reloads++;
     }
 
     pEntry->ti = *pgti;
@@ -1311,44 +1340,29 @@ void CTextureManager::Mirror(void *array, uint32 width, uint32 mask, uint32 towi
 TxtrCacheEntry * CTextureManager::GetCachedTexture(uint32 tex)
 {
     uint32 size = 0;
-    for( uint32 i=0; i<m_numOfCachedTxtrList; i++ )
+    for (TxtrCacheEntry *pEntry = m_pYoungestTexture; pEntry; pEntry = pEntry->pLastYoungest)
     {
-        if( m_pCacheTxtrList[i] == NULL )
-            continue;
+        if( size == tex )
+            return pEntry;
         else
-        {
-            TxtrCacheEntry *pEntry;
-
-            for (pEntry = m_pCacheTxtrList[i]; pEntry; pEntry = pEntry->pNext)
-            {
-                if( size == tex )
-                    return pEntry;
-                else
-                    size++;
-            }
-        }
+            size++;
     }
     return NULL;
 }
 uint32 CTextureManager::GetNumOfCachedTexture()
 {
-    uint32 size = 0;
-    for( uint32 i=0; i<m_numOfCachedTxtrList; i++ )
-    {
-        if( m_pCacheTxtrList[i] == NULL )
-            continue;
-        else
-        {
-            TxtrCacheEntry *pEntry;
+    TRACE1("Totally %d texture cached", m_numOfCachedTxtr);
+    return m_numOfCachedTxtr;
+}
 
-            for (pEntry = m_pCacheTxtrList[i]; pEntry; pEntry = pEntry->pNext)
-            {
-                size++;
-            }
-        }
-    }
-    TRACE1("Totally %d texture cached", size);
-    return size;
+void CTextureManager::DumpStatistics()
+{
+    DebuggerAppendMsg("Texture cache: %d textures, %d KB, %d buckets, budget %d MB", m_numOfCachedTxtr,
+        m_currentTextureMemUsage/1024, m_numOfCachedTxtrList, options.textureCacheSize);
+    DebuggerAppendMsg("Recycled: %d textures, %d KB", m_numOfRecycledTxtr, m_recycledTextureMemUsage/1024);
+    DebuggerAppendMsg("Hits: %d, reloads: %d, misses: %d (%d revived)", m_stats.hits, m_stats.reloads,
+        m_stats.misses, m_stats.revived);
+    DebuggerAppendMsg("Evictions: %d, purges: %d, reused CRCs: %d", m_stats.evictions, m_stats.purges, m_stats.crcReused);
 }
 #endif
 
@@ -164,17 +164,60 @@ typedef struct TxtrCacheEntry
 } TxtrCacheEntry;
 
 
+typedef struct {
+    uint32  hits;           // cached texture used as is
+    uint32  reloads;        // cached entry reloaded, its texture changed in RDRAM
+    uint32  misses;         // new entries
+    uint32  revived;        // new entries reusing a recycled texture
+    uint32  evictions;      // entries deleted to stay within the memory budget
+    uint32  purges;         // entries recycled after some time without use
+    uint32  crcReused;      // CRCs taken from the ones computed earlier in the display list
+} TextureCacheStats;
+
+// The CRC of a rect of RDRAM, computed earlier in the display list
+typedef struct {
+    void   *pPhysicalAddress;
+    int     LeftToLoad;
+    int     TopToLoad;
+    uint32  WidthToLoad;
+    uint32  HeightToLoad;
+    uint32  Size;
+    uint32  Pitch;
+    uint32  dwDlistCount;   // status.gDlistCount when it was computed, 0 for none
+    uint32  dwCRC;
+    int     maxCI;          // -1 if it wasn't looked for
+} TextureCRCMemo;
+
+#define TEXTURE_CRC_MEMO_SIZE   64      // a power of 2
+
+#define RECYCLED_TEXTURE_HASH_SIZE  61
+
 //*****************************************************************************
 // Texture cache implementation
+//
+// The entries are in a hash table on their whole TxtrInfo identity, which grows with the number of entries, and in an
+// age list sorted by last usage (least recently used first). Unused textures are evicted from the old end of the age
+// list, after a while or when the textures use more than options.textureCacheSize MB. Recycled textures are kept by
+// size so a new entry of the same size can take one over.
+//
+// The CRCs computed in a display list are kept by rect of RDRAM, so the texture is hashed once even when it is loaded
+// as several tiles, palettes or formats.
 //*****************************************************************************
 class CTextureManager
 {
 protected:
-    TxtrCacheEntry * CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight);
+    TxtrCacheEntry * CreateNewCacheEntry(TxtrInfo * pti);
     void AddTexture(TxtrCacheEntry *pEntry);
     void RemoveTexture(TxtrCacheEntry * pEntry);
+    void RemoveFromHashTable(TxtrCacheEntry * pEntry);
+    void RemoveFromAgeList(TxtrCacheEntry * pEntry);
     void RecycleTexture(TxtrCacheEntry *pEntry);
     TxtrCacheEntry * ReviveTexture( uint32 width, uint32 height );
+    TxtrCacheEntry * UnlinkRecycledTexture(TxtrCacheEntry **ppEntry);
+    void DeleteRecycledTexture(TxtrCacheEntry *pEntry);
+    void FreeRecycledTextures(uint32 dwMaxUsage);
+    void FreeTextureMem(uint32 dwBytes);
+    uint32 GetTextureMemUsage(TxtrCacheEntry *pEntry);
     TxtrCacheEntry * GetTxtrCacheEntry(TxtrInfo * pti);
     
     void ConvertTexture(TxtrCacheEntry * pEntry, bool fromTMEM);
@@ -200,7 +243,11 @@ protected:
     void ExpandTexture(TxtrCacheEntry * pEntry, uint32 sizeOfLoad, uint32 sizeToCreate, uint32 sizeCreated,
         int arrayWidth, int flag, int mask, int mirror, int clamp, uint32 otherSize);
 
-    uint32 Hash(uint32 dwValue);
+    uint32 Hash(const TxtrInfo &ti);
+    uint32 RecycledHash(uint32 width, uint32 height) { return (width * 31 + height) % RECYCLED_TEXTURE_HASH_SIZE; }
+    void GrowHashTable();
+    TextureCRCMemo * FindCRCMemo(const TxtrInfo &ti);
+    uint32 CalculateCRC(TxtrInfo *pgti, int *pMaxCI);
     bool TCacheEntryIsLoaded(TxtrCacheEntry *pEntry);
 
     void updateColorTexture(CTexture *ptexture, uint32 color);
@@ -211,9 +258,13 @@ public:
     void Mirror(void *array, uint32 width, uint32 mask, uint32 towidth, uint32 arrayWidth, uint32 rows, int flag, int size );
     
 protected:
-    TxtrCacheEntry * m_pHead;
     TxtrCacheEntry ** m_pCacheTxtrList;
-    uint32 m_numOfCachedTxtrList;
+    uint32 m_numOfCachedTxtrList;       // buckets, a power of 2
+    uint32 m_numOfCachedTxtr;
+    TxtrCacheEntry * m_pRecycledTxtrList[RECYCLED_TEXTURE_HASH_SIZE];   // by size, chained by pNext
+    uint32 m_numOfRecycledTxtr;
+    TxtrCacheEntry *m_pYoungestRecycled;    // age list of the recycled textures
+    TxtrCacheEntry *m_pOldestRecycled;
 
     TxtrCacheEntry m_blackTextureEntry;
     TxtrCacheEntry m_PrimColorTextureEntry;
@@ -227,8 +278,11 @@ protected:
 
     void MakeTextureYoungest(TxtrCacheEntry *pEntry);
     unsigned int m_currentTextureMemUsage;
+    unsigned int m_recycledTextureMemUsage;
     TxtrCacheEntry *m_pYoungestTexture;
     TxtrCacheEntry *m_pOldestTexture;
+    TextureCacheStats m_stats;
+    TextureCRCMemo m_CRCMemo[TEXTURE_CRC_MEMO_SIZE];
 
 public:
     CTextureManager();
@@ -246,6 +300,7 @@ public:
 #ifdef DEBUGGER
     TxtrCacheEntry * GetCachedTexture(uint32 tex);
     uint32 GetNumOfCachedTexture();
+    void DumpStatistics();
 #endif
 };
 
@@ -721,6 +721,9 @@ EXPORT void CALL MoveScreen (int xpos, int ypos)
 EXPORT void CALL RomClosed(void)
 {
     TRACE0("To stop video");
+#ifdef PROFILE_GBI
+    DLParser_ProfilePrint(stdout);
+#endif
     Ini_StoreRomOptions(&g_curRomInfo);
     StopVideo();
     TRACE0("Video is stopped");
@@ -29,6 +29,7 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _BMG_LIBPNG_STANDALONE
 #include "BMGLibPNG.h"
 #else
@@ -513,6 +514,116 @@ BMGError ReadPNG( const char *filename,
     return BMG_OK;
 }
 
+/*
+ReadPNGInfo - Reads the header of a PNG file and stores the size and pixel
+    depth ReadPNG would give the image into BMGImageStruct
+
+Inputs:
+    filename    - the name of the file to be opened
+
+Outputs:
+    img         - the BMGImageStruct with width, height and bits_per_pixel
+                  set, and no image data
+
+Returns:
+    BMGError - if the file could not be read or a resource error occurred
+    BMG_OK   - if the header was read
+*/
+BMGError ReadPNGInfo( const char *filename,
+        struct BMGImageStruct * volatile img )
+{
+    jmp_buf             err_jmp;
+    int                 error;
+
+    FILE * volatile     file = NULL;
+    int                 BitDepth;
+    int                 BitsPerPixel;
+    int                 ColorType;
+    int                 ImageChannels;
+    int                 InterlaceType;
+    unsigned char       signature[8];
+    png_structp volatile png_ptr = NULL;
+    png_infop   volatile info_ptr = NULL;
+    png_bytep           trns = NULL;
+    int                 NumTrans = 0;
+    png_color_16p       TransColors = NULL;
+    png_color_16       *ImageBackground = NULL;
+    png_uint_32         Width, Height;
+
+    /* error handler */
+    error = setjmp( err_jmp );
+    if (error != 0)
+    {
+        if (info_ptr != NULL)
+            png_destroy_read_struct((png_structp *) &png_ptr, (png_infop *) &info_ptr, NULL);
+        else if (png_ptr != NULL)
+            png_destroy_read_struct((png_structp *) &png_ptr, NULL, NULL);
+        if (file)
+            fclose(file);
+        SetLastBMGError((BMGError) error);
+        return (BMGError) error;
+    }
+
+    if ( img == NULL )
+        longjmp ( err_jmp, (int)errInvalidBMGImage );
+
+    file = fopen( filename, "rb" );
+    if ( !file || fread( signature, 1, 8, file ) != 8)
+        longjmp ( err_jmp, (int)errFileOpen );
+
+    /* check the signature */
+    if ( png_sig_cmp( signature, 0, 8 ) != 0 )
+        longjmp( err_jmp, (int)errUnsupportedFileFormat );
+
+    png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, NULL, NULL );
+    if ( !png_ptr )
+        longjmp( err_jmp, (int)errMemoryAllocation );
+
+    info_ptr = png_create_info_struct( png_ptr );
+    if ( !info_ptr )
+        longjmp( err_jmp, (int)errMemoryAllocation );
+
+    error = setjmp( png_jmpbuf( png_ptr ) );
+    if ( error > 0 )
+        longjmp( err_jmp, error );
+
+    png_set_read_fn(png_ptr, (png_voidp) file, user_read_data);
+    png_set_sig_bytes( png_ptr, 8 );
+
+    /* read the chunks up to the image data only */
+    png_read_info( png_ptr, info_ptr );
+    png_get_IHDR( png_ptr, info_ptr, &Width, &Height, &BitDepth, &ColorType,
+        &InterlaceType, NULL, NULL);
+    ImageChannels = png_get_channels( png_ptr, info_ptr );
+
+    /* the same depth as ReadPNG gives the image */
+    if ( BitDepth == 2 )
+        BitDepth = 4;
+    if ( BitDepth == 16 )
+        BitDepth = 8;
+    BitsPerPixel = BitDepth *
+            ( ColorType & PNG_COLOR_MASK_ALPHA && !(ColorType & PNG_COLOR_MASK_COLOR)?
+            ImageChannels - 1 : ImageChannels );
+    if ( png_get_valid(png_ptr, info_ptr, PNG_INFO_bKGD) )
+        png_get_bKGD(png_ptr, info_ptr, &ImageBackground);
+    if ( png_get_valid( png_ptr, info_ptr, PNG_INFO_tRNS ) )
+        png_get_tRNS( png_ptr, info_ptr, &trns, &NumTrans, &TransColors );
+    if ( ColorType & PNG_COLOR_MASK_ALPHA && BitsPerPixel == 8 )
+        BitsPerPixel = 32;
+    else if ( ColorType & PNG_COLOR_MASK_PALETTE &&
+              ( NumTrans > 1 || ( NumTrans == 1 && ImageBackground == NULL && trns[0] != 0 ) ) )
+        BitsPerPixel = 32;
+
+    img->width = (unsigned int) Width;
+    img->height = (unsigned int) Height;
+    img->bits_per_pixel = (unsigned char) BitsPerPixel;
+
+    png_destroy_read_struct((png_structp *) &png_ptr, (png_infop *) &info_ptr, NULL);
+    fclose( file );
+
+    return BMG_OK;
+}
+
 /*
 WritePNG - writes the contents of a BMGImageStruct to a PNG file.
 
@@ -0,0 +1,105 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "bench.h"
+
+#define REPORTED_ERRORS     10
+
+static int gErrors = 0;
+
+bool BenchArgs(int argc, char **argv, int *values, int count)
+{
+    if( argc-1 > count )
+        return false;
+    for( int i=1; i<argc; i++ )
+    {
+        char *end;
+        long value = strtol(argv[i], &end, 10);
+        if( end == argv[i] || *end != '\0' || value <= 0 || value > 0x7FFFFFFF )
+            return false;
+        values[i-1] = (int)value;
+    }
+    return true;
+}
+
+int BenchUsage(const char *usage)
+{
+    fprintf(stderr, "Usage: %s\n", usage);
+    return 1;
+}
+
+static void Fail(const char *format, va_list args)
+{
+    if( gErrors++ < REPORTED_ERRORS )
+    {
+        vprintf(format, args);
+        putchar('\n');
+    }
+}
+
+void BenchFail(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    Fail(format, args);
+    va_end(args);
+}
+
+bool BenchCompare(const void *expected, const void *result, size_t size, const char *format, ...)
+{
+    if( memcmp(expected, result, size) == 0 )
+        return true;
+
+    va_list args;
+    va_start(args, format);
+    Fail(format, args);
+    va_end(args);
+    return false;
+}
+
+void BenchReport(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf(", %s\n\n", gErrors ? "FAILED" : "all the same");
+}
+
+int BenchErrors(void)
+{
+    return gErrors;
+}
+
+uint64 BenchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+double BenchUs(uint64 start, int iterations)
+{
+    return (BenchNow() - start) / 1000.0 / iterations;
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+/****
+ bench - what the checks and benchmarks in tools/ share
+
+ The numbers on the command line, a count of the checks against the reference code which prints the first ones that
+ fail, and a monotonic clock in ns for the timing. Each bench is tools/<name>.cpp built with this and the plugin code
+ it checks, by the bench rule of the Makefile.
+****/
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stddef.h>
+
+#include "typedefs.h"
+
+// the numbers on the command line into values, which hold the defaults of the missing ones; false if there are more
+// than count or one isn't a number above 0
+bool BenchArgs(int argc, char **argv, int *values, int count);
+
+// prints "Usage: <usage>", and returns the exit code for it
+int BenchUsage(const char *usage);
+
+// a check which failed: counted, and printed for the first 10
+void BenchFail(const char *format, ...);
+
+// BenchFail() when the size bytes of result aren't the expected ones, returns whether they are
+bool BenchCompare(const void *expected, const void *result, size_t size, const char *format, ...);
+
+// what was checked, then "all the same" or "FAILED"
+void BenchReport(const char *format, ...);
+
+// the checks which failed so far, 0 for the exit code when all passed
+int BenchErrors(void);
+
+// ns from CLOCK_MONOTONIC
+uint64 BenchNow(void);
+
+// us for each of iterations since start, a BenchNow() time
+double BenchUs(uint64 start, int iterations);
+
+#endif
@@ -0,0 +1,374 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ convertbench - checks and times the texture row conversion
+
+ Usage: convertbench [cases] [iterations]
+
+ Runs every row function of ConvertImageRows.cpp over random TMEM/RDRAM contents, random offsets, the fiddles the
+ converters use and random widths, and compares the output with the per texel code of ConvertImage.cpp and
+ ConvertImage16.cpp, including the bytes past the row which must be left alone, with random YUV conversion
+ constants. Every row is checked and timed with each of the scalar, SSE2, SSSE3 and NEON kernels the build and the CPU
+ have, then both are timed on 64x64 textures with swapped lines. Like fbcopybench it is built for the target, so the
+ NEON code is what gets checked there.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ConvertImage.h"
+#include "ConvertImageRows.h"
+#include "bench.h"
+
+#define SRC_SIZE    0x10000
+#define MAX_TEXELS  3000
+
+enum
+{
+    ROW_RGBA16, ROW_RGBA16_16, ROW_IA16, ROW_IA16_16, ROW_RGBA32, ROW_RGBA32_16,
+    ROW_IA4, ROW_IA4_16, ROW_I4, ROW_I4_16, ROW_IA8, ROW_IA8_16, ROW_I8, ROW_I8_16,
+    ROW_CI4_RGBA16, ROW_CI4_IA16, ROW_CI4_RGBA16_16, ROW_CI4_IA16_16,
+    ROW_CI8_RGBA16, ROW_CI8_IA16, ROW_CI8_RGBA16_16, ROW_CI8_IA16_16,
+    ROW_YUV, ROW_YUV_REVERSED, ROW_YUV_16,
+    NUM_ROWS
+};
+
+static const char *rowNames[NUM_ROWS] =
+{
+    "RGBA16", "RGBA16_16", "IA16", "IA16_16", "RGBA32", "RGBA32_16",
+    "IA4", "IA4_16", "I4", "I4_16", "IA8", "IA8_16", "I8", "I8_16",
+    "CI4_RGBA16", "CI4_IA16", "CI4_RGBA16_16", "CI4_IA16_16",
+    "CI8_RGBA16", "CI8_IA16", "CI8_RGBA16_16", "CI8_IA16_16",
+    "YUV", "YUV_REVERSED", "YUV_16",
+};
+
+static const char *simdNames[] = { "", " (SSE2)", " (SSSE3)", " (NEON)" };
+
+static uint16 *pPal;
+static bool bIgnoreAlpha;
+
+// set by the YUV conversion command, in RSP_Parser.cpp
+int g_convk0,g_convk1,g_convk2,g_convk3,g_convk4,g_convk5;
+
+// the inner loops of the converters, one texel at a time
+static void ReferenceRow(int row, const uint8 *pSrc, uint32 dwOffset, uint32 nFiddle, void *pDstRow, uint32 width)
+{
+    uint32 *pDst = (uint32*)pDstRow;
+    uint16 *wDst = (uint16*)pDstRow;
+
+    for (uint32 x = 0; x < width; x++)
+    {
+        uint8 b, bx, I;
+        uint16 w;
+        int Y0, Y1, U, V;
+        switch (row)
+        {
+        case ROW_RGBA16:
+            pDst[x] = Convert555ToRGBA(*(uint16 *)&pSrc[(dwOffset+x*2) ^ nFiddle]);
+            break;
+        case ROW_RGBA16_16:
+            wDst[x] = Convert555ToR4G4B4A4(*(uint16 *)&pSrc[(dwOffset+x*2) ^ nFiddle]);
+            break;
+        case ROW_IA16:
+            w = *(uint16 *)&pSrc[(dwOffset+x*2) ^ nFiddle];
+            ((uint8*)pDst)[x*4+0] = (uint8)(w >> 8);
+            ((uint8*)pDst)[x*4+1] = (uint8)(w >> 8);
+            ((uint8*)pDst)[x*4+2] = (uint8)(w >> 8);
+            ((uint8*)pDst)[x*4+3] = (uint8)(w & 0xFF);
+            break;
+        case ROW_IA16_16:
+            w = *(uint16 *)&pSrc[(dwOffset+x*2) ^ nFiddle];
+            wDst[x] = R4G4B4A4_MAKE((uint8)(w >> 12), (uint8)(w >> 12), (uint8)(w >> 12), ((uint8)(w & 0xFF) >> 4));
+            break;
+        case ROW_RGBA32:
+            pDst[x] = COLOR_RGBA(pSrc[(dwOffset+x*4+3)^nFiddle], pSrc[(dwOffset+x*4+2)^nFiddle],
+                                 pSrc[(dwOffset+x*4+1)^nFiddle], pSrc[(dwOffset+x*4+0)^nFiddle]);
+            break;
+        case ROW_RGBA32_16:
+            // ConvertRGBA32_16 indexes from the start of the row, (n^0x8) + 3
+            wDst[x] = R4G4B4A4_MAKE((pSrc[dwOffset+((x*4)^nFiddle)+3]>>4), (pSrc[dwOffset+((x*4)^nFiddle)+2]>>4),
+                                    (pSrc[dwOffset+((x*4)^nFiddle)+1]>>4), (pSrc[dwOffset+((x*4)^nFiddle)+0]>>4));
+            break;
+        case ROW_IA4:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            bx = (x&1) ? (b & 0x0F) : (b >> 4);
+            ((uint8*)pDst)[x*4+0] = ThreeToEight[(bx & 0x0E) >> 1];
+            ((uint8*)pDst)[x*4+1] = ThreeToEight[(bx & 0x0E) >> 1];
+            ((uint8*)pDst)[x*4+2] = ThreeToEight[(bx & 0x0E) >> 1];
+            ((uint8*)pDst)[x*4+3] = OneToEight[(bx & 0x01)];
+            break;
+        case ROW_IA4_16:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            bx = (x&1) ? (b & 0x0F) : (b >> 4);
+            wDst[x] = R4G4B4A4_MAKE(ThreeToFour[(bx & 0x0E) >> 1], ThreeToFour[(bx & 0x0E) >> 1],
+                                    ThreeToFour[(bx & 0x0E) >> 1], OneToFour[(bx & 0x01)]);
+            break;
+        case ROW_I4:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            bx = (x&1) ? (b & 0x0F) : (b >> 4);
+            memset((uint8*)pDst + x*4, FourToEight[bx], 4);
+            break;
+        case ROW_I4_16:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            wDst[x] = FourToSixteen[(x&1) ? (b & 0x0F) : (b >> 4)];
+            break;
+        case ROW_IA8:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            I = FourToEight[(b & 0xf0)>>4];
+            ((uint8*)pDst)[x*4+0] = I;
+            ((uint8*)pDst)[x*4+1] = I;
+            ((uint8*)pDst)[x*4+2] = I;
+            ((uint8*)pDst)[x*4+3] = FourToEight[(b & 0x0f)];
+            break;
+        case ROW_IA8_16:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            wDst[x] = R4G4B4A4_MAKE(((b&0xf0)>>4), ((b&0xf0)>>4), ((b&0xf0)>>4), (b&0x0f));
+            break;
+        case ROW_I8:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            memset((uint8*)pDst + x*4, b, 4);
+            break;
+        case ROW_I8_16:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            wDst[x] = R4G4B4A4_MAKE(b>>4, b>>4, b>>4, b>>4);
+            break;
+        case ROW_CI4_RGBA16:
+        case ROW_CI4_IA16:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            bx = (x&1) ? (b & 0x0F) : (b >> 4);
+            pDst[x] = row == ROW_CI4_RGBA16 ? Convert555ToRGBA(pPal[bx^1]) : ConvertIA16ToRGBA(pPal[bx^1]);
+            if( bIgnoreAlpha )
+                pDst[x] |= 0xFF000000;
+            break;
+        case ROW_CI4_RGBA16_16:
+        case ROW_CI4_IA16_16:
+            b = pSrc[(dwOffset + x/2) ^ nFiddle];
+            bx = (x&1) ? (b & 0x0F) : (b >> 4);
+            wDst[x] = row == ROW_CI4_RGBA16_16 ? Convert555ToR4G4B4A4(pPal[bx^1]) : ConvertIA16ToR4G4B4A4(pPal[bx^1]);
+            break;
+        case ROW_CI8_RGBA16:
+        case ROW_CI8_IA16:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            pDst[x] = row == ROW_CI8_RGBA16 ? Convert555ToRGBA(pPal[b^1]) : ConvertIA16ToRGBA(pPal[b^1]);
+            if( bIgnoreAlpha )
+                pDst[x] |= 0xFF000000;
+            break;
+        case ROW_CI8_RGBA16_16:
+        case ROW_CI8_IA16_16:
+            b = pSrc[(dwOffset + x) ^ nFiddle];
+            wDst[x] = row == ROW_CI8_RGBA16_16 ? Convert555ToR4G4B4A4(pPal[b^1]) : ConvertIA16ToR4G4B4A4(pPal[b^1]);
+            break;
+        case ROW_YUV:
+        case ROW_YUV_16:
+            // 2 texels at a time, an odd last one is left alone
+            if( (x&1) || x+1 == width )
+                break;
+            Y0 = pSrc[(dwOffset+x*2+1)^nFiddle];
+            Y1 = pSrc[(dwOffset+x*2+3)^nFiddle];
+            U = pSrc[(dwOffset+x*2  )^nFiddle];
+            V = pSrc[(dwOffset+x*2+2)^nFiddle];
+            if( row == ROW_YUV )
+            {
+                pDst[x+0] = ConvertYUV16ToR8G8B8(Y0,U,V);
+                pDst[x+1] = ConvertYUV16ToR8G8B8(Y1,U,V);
+            }
+            else
+            {
+                wDst[x+0] = ConvertYUV16ToR4G4B4(Y0,U,V);
+                wDst[x+1] = ConvertYUV16ToR4G4B4(Y1,U,V);
+            }
+            break;
+        case ROW_YUV_REVERSED:
+            // the swapped lines of ConvertYUV
+            if( (x&1) || x+1 == width )
+                break;
+            Y0 = pSrc[(dwOffset+x*2+2)^nFiddle];
+            V = pSrc[(dwOffset+x*2+1)^nFiddle];
+            Y1 = pSrc[(dwOffset+x*2  )^nFiddle];
+            U = pSrc[(dwOffset+x*2+3)^nFiddle];
+            pDst[x+0] = ConvertYUV16ToR8G8B8(Y0,U,V);
+            pDst[x+1] = ConvertYUV16ToR8G8B8(Y1,U,V);
+            break;
+        }
+    }
+}
+
+static uint32 table[256];
+static uint16 table16[256];
+
+// the tables a converter sets up once per texture
+static void PrepareTables(int row)
+{
+    switch (row)
+    {
+    case ROW_CI4_RGBA16:    ConvertPaletteRGBA16(pPal, 16, bIgnoreAlpha, table); break;
+    case ROW_CI4_IA16:      ConvertPaletteIA16(pPal, 16, bIgnoreAlpha, table); break;
+    case ROW_CI4_RGBA16_16: ConvertPaletteRGBA16_16(pPal, 16, table16); break;
+    case ROW_CI4_IA16_16:   ConvertPaletteIA16_16(pPal, 16, table16); break;
+    case ROW_CI8_RGBA16:    ConvertPaletteRGBA16(pPal, 256, bIgnoreAlpha, table); break;
+    case ROW_CI8_IA16:      ConvertPaletteIA16(pPal, 256, bIgnoreAlpha, table); break;
+    case ROW_CI8_RGBA16_16: ConvertPaletteRGBA16_16(pPal, 256, table16); break;
+    case ROW_CI8_IA16_16:   ConvertPaletteIA16_16(pPal, 256, table16); break;
+    case ROW_IA4:           memcpy(table, GetTexelTable(TEXEL_TABLE_IA4), sizeof(table)); break;
+    case ROW_I4:            memcpy(table, GetTexelTable(TEXEL_TABLE_I4), sizeof(table)); break;
+    case ROW_IA8:           memcpy(table, GetTexelTable(TEXEL_TABLE_IA8), sizeof(table)); break;
+    case ROW_I8:            memcpy(table, GetTexelTable(TEXEL_TABLE_I8), sizeof(table)); break;
+    case ROW_IA4_16:        memcpy(table16, GetTexelTable_16(TEXEL_TABLE_IA4), sizeof(table16)); break;
+    case ROW_I4_16:         memcpy(table16, GetTexelTable_16(TEXEL_TABLE_I4), sizeof(table16)); break;
+    case ROW_IA8_16:        memcpy(table16, GetTexelTable_16(TEXEL_TABLE_IA8), sizeof(table16)); break;
+    case ROW_I8_16:         memcpy(table16, GetTexelTable_16(TEXEL_TABLE_I8), sizeof(table16)); break;
+    }
+}
+
+// the same row through ConvertImageRows.cpp, the way the converters call it
+static void ConvertRow(int row, const uint8 *pSrc, uint32 dwOffset, uint32 nFiddle, void *pDst, uint32 width)
+{
+    switch (row)
+    {
+    case ROW_RGBA16:        ConvertRowRGBA16(pSrc, dwOffset, nFiddle, (uint32*)pDst, width); break;
+    case ROW_RGBA16_16:     ConvertRowRGBA16_16(pSrc, dwOffset, nFiddle, (uint16*)pDst, width); break;
+    case ROW_IA16:          ConvertRowIA16(pSrc, dwOffset, nFiddle, (uint32*)pDst, width); break;
+    case ROW_IA16_16:       ConvertRowIA16_16(pSrc, dwOffset, nFiddle, (uint16*)pDst, width); break;
+    case ROW_RGBA32:        ConvertRowRGBA32(pSrc, dwOffset, nFiddle, (uint32*)pDst, width); break;
+    case ROW_RGBA32_16:     ConvertRowRGBA32_16(pSrc+dwOffset, 0, nFiddle, (uint16*)pDst, width); break;
+    case ROW_IA4: case ROW_I4: case ROW_CI4_RGBA16: case ROW_CI4_IA16:
+        ConvertRowTable4(pSrc, dwOffset, nFiddle, table, (uint32*)pDst, width);
+        break;
+    case ROW_IA4_16: case ROW_I4_16: case ROW_CI4_RGBA16_16: case ROW_CI4_IA16_16:
+        ConvertRowTable4_16(pSrc, dwOffset, nFiddle, table16, (uint16*)pDst, width);
+        break;
+    case ROW_IA8: case ROW_I8: case ROW_CI8_RGBA16: case ROW_CI8_IA16:
+        ConvertRowTable8(pSrc, dwOffset, nFiddle, table, (uint32*)pDst, width);
+        break;
+    case ROW_IA8_16: case ROW_I8_16: case ROW_CI8_RGBA16_16: case ROW_CI8_IA16_16:
+        ConvertRowTable8_16(pSrc, dwOffset, nFiddle, table16, (uint16*)pDst, width);
+        break;
+    case ROW_YUV:           ConvertRowYUV(pSrc, dwOffset, nFiddle, false, (uint32*)pDst, width); break;
+    case ROW_YUV_REVERSED:  ConvertRowYUV(pSrc, dwOffset, nFiddle, true, (uint32*)pDst, width); break;
+    case ROW_YUV_16:        ConvertRowYUV_16(pSrc, dwOffset, nFiddle, false, (uint16*)pDst, width); break;
+    }
+}
+
+// the fiddle of an even or odd line of a swapped texture
+static uint32 SwappedFiddle(int row, uint32 y)
+{
+    switch (row)
+    {
+    case ROW_RGBA16: case ROW_RGBA16_16: case ROW_IA16: case ROW_IA16_16: case ROW_YUV_16:
+        return (y&1) ? 0x6 : 0x2;
+    case ROW_YUV:
+        return (y&1) ? 0x4 : 0x0;   // full TMEM
+    case ROW_RGBA32: case ROW_RGBA32_16:
+        return (y&1) ? 0x8 : 0x0;
+    }
+    return (y&1) ? 0x7 : 0x3;
+}
+
+static uint32 RandomFiddle(int row)
+{
+    // mostly the ones of swapped textures, and some others a 16 byte block can be shuffled with
+    static const uint32 others[] = { 0x0, 0x4, 0xC, 0x8 };
+    if( rand() % 4 )
+        return SwappedFiddle(row, rand());
+    if( row == ROW_RGBA32_16 )
+        return others[rand()%4];   // ConvertRGBA32_16 reads (n^fiddle)+3, the same bytes as long as the fiddle keeps n%4
+    return rand()%16;
+}
+
+int main(int argc, char **argv)
+{
+    int args[2] = { 2000, 5000 };
+    if( !BenchArgs(argc, argv, args, 2) )
+        return BenchUsage("convertbench [cases] [iterations]");
+    int cases = args[0], iterations = args[1];
+
+    std::vector<uint8> src(SRC_SIZE);
+    std::vector<uint16> pal(256);
+    std::vector<uint8> expected(MAX_TEXELS*4+64), result(MAX_TEXELS*4+64);
+    srand(1);
+    for( size_t i=0; i<src.size(); i++ )
+        src[i] = (uint8)(rand() >> 4);
+    for( size_t i=0; i<pal.size(); i++ )
+        pal[i] = (uint16)(rand() >> 4);
+    pPal = &pal[0];
+
+    // with each SIMD level the build and the CPU have
+    for( int row=0; row<NUM_ROWS; row++ )
+    for( int simd=CONVERT_SIMD_NONE; simd<=CONVERT_SIMD_NEON; simd++ )
+    {
+        if( !SetConvertSimd((ConvertSimd)simd) )
+            continue;
+        for( int c=0; c<cases; c++ )
+        {
+            uint32 width = (c & 3) == 0 ? 1 + rand()%16 : 1 + rand()%MAX_TEXELS;
+            uint32 offset = rand() % (SRC_SIZE - MAX_TEXELS*4 - 16);
+            uint32 fiddle = RandomFiddle(row);
+            bIgnoreAlpha = (c & 1) != 0;
+            int *k[] = { &g_convk0, &g_convk1, &g_convk2, &g_convk3, &g_convk4, &g_convk5 };
+            for( int i=0; i<6; i++ )
+                *k[i] = rand()%511 - 255;
+
+            PrepareTables(row);
+
+            memset(&expected[0], 0xCD, expected.size());
+            memset(&result[0], 0xCD, result.size());
+            ReferenceRow(row, &src[0], offset, fiddle, &expected[0], width);
+            ConvertRow(row, &src[0], offset, fiddle, &result[0], width);
+            BenchCompare(&expected[0], &result[0], expected.size(), "%s%s: %u texels from offset %u, fiddle %u differ",
+                         rowNames[row], simdNames[simd], width, offset, fiddle);
+        }
+    }
+    BenchReport("%d random rows of each format checked", cases);
+
+    printf("format                 per texel (us)  rows (us)   per 64x64 texture\n");
+    bIgnoreAlpha = false;
+    for( int row=0; row<NUM_ROWS; row++ )
+    for( int simd=CONVERT_SIMD_NONE; simd<=CONVERT_SIMD_NEON; simd++ )
+    {
+        double t[2];
+        char name[32];
+        if( !SetConvertSimd((ConvertSimd)simd) )
+            continue;
+        snprintf(name, sizeof(name), "%s%s", rowNames[row], simdNames[simd]);
+        for( int mode=0; mode<2; mode++ )
+        {
+            uint64 start = BenchNow();
+            for( int n=0; n<iterations; n++ )
+            {
+                if( mode == 1 )
+                    PrepareTables(row);
+                for( uint32 y=0; y<64; y++ )
+                {
+                    if( mode == 0 )
+                        ReferenceRow(row, &src[0], y*256, SwappedFiddle(row, y), &result[0], 64);
+                    else
+                        ConvertRow(row, &src[0], y*256, SwappedFiddle(row, y), &result[0], 64);
+                }
+            }
+            t[mode] = BenchUs(start, iterations);
+        }
+        printf("%-22s %14.2f  %9.2f\n", name, t[0], t[1]);
+    }
+
+    return BenchErrors() ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+/****
+ crcbench - checks and times the texture CRC and max CI
+
+ Usage: crcbench [cases] [iterations]
+
+ Runs CalculateTextureCRC and CalculateMaxCI of TextureCRC.cpp over random rects of random RDRAM contents, and
+ compares them with the loops they replace in FrameBuffer.cpp (the C code of the assembly in x86 builds), which hi-res
+ texture packs are named after. Then both are timed on 64x64 textures. Like fbcopybench it is built for the target.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "typedefs.h"
+#include "RSP_Parser.h"
+#include "TextureCRC.h"
+#include "bench.h"
+
+#define RAM_SIZE    0x40000
+
+// the CRC loop of CalculateRDRAMCRC without bFastTexCRC
+static uint32 ReferenceCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes)
+{
+    uint32 dwAsmCRC = 0;
+    uint32 dwAsmdwBytesPerLine = ((width<<size)+1)/2;
+
+    uint8 *pAsmStart = (uint8*)(pPhysicalAddress);
+    pAsmStart += (top * pitchInBytes) + (((left<<size)+1)>>1);
+
+    uint32 dwAsmHeight = height - 1;
+    uint32 dwAsmPitch = pitchInBytes;
+
+    int y = dwAsmHeight;
+
+#if defined(NO_ASM)
+    while(y >= 0)
+    {
+        uint32 esi = 0;
+        int x = dwAsmdwBytesPerLine - 4;
+        while(x >= 0)
+        {
+            esi = *(uint32*)(pAsmStart + x);
+            esi ^= x;
+
+            dwAsmCRC = (dwAsmCRC << 4) + ((dwAsmCRC >> 28) & 15);
+            dwAsmCRC += esi;
+            x-=4;
+        }
+        esi ^= y;
+        dwAsmCRC += esi;
+        pAsmStart += dwAsmPitch;
+        y--;
+    }
+#else
+    // the assembly tests at the end of its loops
+    do
+    {
+        uint32 esi = 0;
+        int x = dwAsmdwBytesPerLine - 4;
+        do
+        {
+            esi = *(uint32*)(pAsmStart + x);
+            esi ^= x;
+
+            dwAsmCRC = (dwAsmCRC << 4) + ((dwAsmCRC >> 28) & 15);
+            dwAsmCRC += esi;
+            x-=4;
+        } while(x >= 0);
+        esi ^= y;
+        dwAsmCRC += esi;
+        pAsmStart += dwAsmPitch;
+        y--;
+    } while(y >= 0);
+#endif
+
+    return dwAsmCRC;
+}
+
+// CalculateMaxCI of FrameBuffer.cpp
+static unsigned char ReferenceMaxCI(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes )
+{
+    uint32 x, y;
+    unsigned char *buf;
+    unsigned char val = 0;
+
+    if( TXT_SIZE_8b == size )
+    {
+        for( y = 0; y<height; y++ )
+        {
+            buf = (unsigned char*)pPhysicalAddress + left + pitchInBytes * (y+top);
+            for( x=0; x<width; x++ )
+            {
+                if( buf[x] > val )  val = buf[x];
+                if( val == 0xFF )
+                    return 0xFF;
+            }
+        }
+    }
+    else
+    {
+        unsigned char val1,val2;
+        left >>= 1;
+        width >>= 1;
+        for( y = 0; y<height; y++ )
+        {
+            buf = (unsigned char*)pPhysicalAddress + left + pitchInBytes * (y+top);
+            for( x=0; x<width; x++ )
+            {
+                val1 = buf[x]>>4;
+                val2 = buf[x]&0xF;
+                if( val1 > val )    val = val1;
+                if( val2 > val )    val = val2;
+                if( val == 0xF )
+                    return 0xF;
+            }
+        }
+    }
+
+    return val;
+}
+
+// RDRAM of random bytes, or of small indices so the max CI search doesn't stop early
+static void FillRAM(std::vector<uint8> &ram, uint8 mask)
+{
+    for( size_t i=0; i<ram.size(); i++ )
+        ram[i] = (uint8)(rand() >> 4) & mask;
+}
+
+int main(int argc, char **argv)
+{
+    int args[2] = { 20000, 20000 };
+    if( !BenchArgs(argc, argv, args, 2) )
+        return BenchUsage("crcbench [cases] [iterations]");
+    int cases = args[0], iterations = args[1];
+
+    std::vector<uint8> ram(RAM_SIZE);
+    srand(1);
+
+    for( int c=0; c<cases; c++ )
+    {
+        if( c % 1000 == 0 )
+            FillRAM(ram, (c/1000) & 1 ? 0x7E : 0xFF);
+
+        uint32 size = rand() % 4;
+        uint32 width = (c & 3) == 0 ? rand()%8 : 1 + rand()%256;
+        uint32 height = (c & 7) == 0 ? rand()%3 : 1 + rand()%64;
+        uint32 left = rand() % 64;
+        uint32 top = rand() % 16;
+        uint32 pitch = ((((left+width)<<size)+1)>>1) + rand()%64;
+        void *pStart = &ram[16 + rand()%64];     // the assembly reads a word before short lines
+
+        uint32 crc = ReferenceCRC(pStart, left, top, width, height, size, pitch);
+        int maxCI = -1;
+        uint32 result = CalculateTextureCRC(pStart, left, top, width, height, size, pitch, size <= TXT_SIZE_8b ? &maxCI : NULL);
+        if( result != crc )
+            BenchFail("CRC of %ux%u at %u,%u, size %u, pitch %u: %08X instead of %08X", width, height, left, top, size, pitch, result, crc);
+
+        if( size <= TXT_SIZE_8b )
+        {
+            unsigned char expected = ReferenceMaxCI(pStart, left, top, width, height, size, pitch);
+            unsigned char alone = CalculateMaxCI(pStart, left, top, width, height, size, pitch);
+            if( maxCI != expected || alone != expected )
+                BenchFail("max CI of %ux%u at %u,%u, size %u, pitch %u: %d and %d instead of %d", width, height, left, top, size, pitch,
+                    maxCI, alone, expected);
+        }
+    }
+    BenchReport("%d random rects checked", cases);
+
+    // indices under the max so the max CI goes through the whole texture
+    FillRAM(ram, 0x7E);
+    static const char *names[] = { "4b CI", "8b CI", "16b", "32b" };
+    printf("64x64 texture    CRC + max CI (us)   fused (us)\n");
+    for( uint32 size=0; size<4; size++ )
+    {
+        double t[2];
+        uint32 pitch = (64<<size)>>1;
+        for( int mode=0; mode<2; mode++ )
+        {
+            volatile uint32 sink = 0;
+            uint64 start = BenchNow();
+            for( int n=0; n<iterations; n++ )
+            {
+                uint8 *pStart = &ram[(n & 15) * 4096];
+                if( mode == 0 )
+                {
+                    sink += ReferenceCRC(pStart, 0, 0, 64, 64, size, pitch);
+                    if( size <= TXT_SIZE_8b )
+                        sink += ReferenceMaxCI(pStart, 0, 0, 64, 64, size, pitch);
+                }
+                else
+                {
+                    int maxCI = 0;
+                    sink += CalculateTextureCRC(pStart, 0, 0, 64, 64, size, pitch, size <= TXT_SIZE_8b ? &maxCI : NULL);
+                    sink += maxCI;
+                }
+            }
+            t[mode] = BenchUs(start, iterations);
+        }
+        printf("%-16s %17.2f   %10.2f\n", names[size], t[0], t[1]);
+    }
+
+    return BenchErrors() ? 1 : 0;
+}
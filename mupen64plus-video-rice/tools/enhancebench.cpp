@@ -0,0 +1,270 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ enhancebench - checks and times the texture enhancement filters
+
+ Usage: enhancebench [iterations]
+
+ Runs the scaling filters of TextureFilters_2xsai.cpp, TextureFilters_hq2x.cpp and TextureFilters_hq4x.cpp on
+ synthetic textures, once over the whole image on the calling thread and once split in bands over the calling thread
+ and the filter threads the way EnhanceTexture() does. Both have to give the same image, and lq2x has to give the hq2x
+ image except for its first and last rows. Then both are timed for the texture sizes EnhanceTexture() enhances.
+ Nothing needs a GPU, so like the other benches it is built for the target.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#include "typedefs.h"
+#include "TextureFilters.h"
+#include "bench.h"
+
+// as in TextureFilters.cpp
+#define FILTER_THREADS      2
+#define FILTER_BANDS        8
+#define ENHANCE_MAX_SIZE    1024        // width + height, divided by the scale
+
+enum { FILTER_2XSAI, FILTER_HQ2X, FILTER_LQ2X, FILTER_HQ4X, NUM_FILTERS };
+
+static const char *filterNames[NUM_FILTERS] = { "2xSaI", "hq2x", "lq2x", "hq4x" };
+static const uint32 filterScales[NUM_FILTERS] = { 2, 2, 2, 4 };
+
+typedef struct {
+    int     filter;
+    uint32  pixelSize;
+    uint8  *src;
+    uint8  *dst;
+    uint32  width;
+    uint32  height;
+    uint32  nextBand;
+    uint32  bandsDone;
+} FilterJob;
+
+static FilterJob   *gJob = NULL;
+static SDL_mutex   *gMutex;
+static SDL_cond    *gCond;
+static SDL_cond    *gDoneCond;
+static bool         gQuit = false;
+
+static void FilterRows(const FilterJob &job, uint32 firstRow, uint32 lastRow)
+{
+    uint32 w = job.width, h = job.height, size = job.pixelSize;
+    uint32 srcPitch = w*size, dstPitch = w*filterScales[job.filter]*size;
+
+    switch( job.filter )
+    {
+    case FILTER_2XSAI:
+        if( size == 4 )
+            Super2xSaI_32_rows((uint32*)job.src, (uint32*)job.dst, w, h, w, firstRow, lastRow);
+        else
+            Super2xSaI_16_rows((uint16*)job.src, (uint16*)job.dst, w, h, w, firstRow, lastRow);
+        break;
+    case FILTER_HQ2X:
+        if( size == 4 )
+            hq2x_32_rows(job.src, srcPitch, job.dst, dstPitch, w, h, firstRow, lastRow);
+        else
+            hq2x_16_rows(job.src, srcPitch, job.dst, dstPitch, w, h, firstRow, lastRow);
+        break;
+    case FILTER_LQ2X:
+        if( size == 4 )
+            lq2x_32_rows(job.src, srcPitch, job.dst, dstPitch, w, h, firstRow, lastRow);
+        else
+            lq2x_16_rows(job.src, srcPitch, job.dst, dstPitch, w, h, firstRow, lastRow);
+        break;
+    default:
+        if( size == 4 )
+            hq4x_32_rows(job.src, job.dst, w, h, w, dstPitch, firstRow, lastRow);
+        else
+            hq4x_16_rows(job.src, job.dst, w, h, w, dstPitch, firstRow, lastRow);
+        break;
+    }
+}
+
+// FilterTextureBands() of TextureFilters.cpp, called with gMutex locked
+static void FilterBands(FilterJob *job)
+{
+    while( job->nextBand < FILTER_BANDS )
+    {
+        uint32 band = job->nextBand++;
+        SDL_UnlockMutex(gMutex);
+
+        FilterRows(*job, job->height * band / FILTER_BANDS, job->height * (band + 1) / FILTER_BANDS);
+
+        SDL_LockMutex(gMutex);
+        if( ++job->bandsDone == FILTER_BANDS )
+            SDL_CondSignal(gDoneCond);
+    }
+}
+
+static int FilterThread(void *)
+{
+    SDL_LockMutex(gMutex);
+    while( !gQuit )
+    {
+        if( gJob && gJob->nextBand < FILTER_BANDS )
+            FilterBands(gJob);
+        else
+            SDL_CondWait(gCond, gMutex);
+    }
+    SDL_UnlockMutex(gMutex);
+    return 0;
+}
+
+static void RunFilter(FilterJob &job, bool bThreaded)
+{
+    job.nextBand = 0;
+    job.bandsDone = 0;
+    if( !bThreaded )
+    {
+        FilterRows(job, 0, job.height);
+        return;
+    }
+
+    SDL_LockMutex(gMutex);
+    gJob = &job;
+    SDL_CondBroadcast(gCond);
+    FilterBands(&job);
+    while( job.bandsDone < FILTER_BANDS )
+        SDL_CondWait(gDoneCond, gMutex);
+    gJob = NULL;
+    SDL_UnlockMutex(gMutex);
+}
+
+// blocks of a few colors, so the filters see edges and flat areas like in real textures
+static void FillTexture(std::vector<uint8> &tex, uint32 width, uint32 height, uint32 pixelSize)
+{
+    uint32 colors[6];
+    for( int i=0; i<6; i++ )
+        colors[i] = ((uint32)rand() << 16) ^ (uint32)rand();
+    for( uint32 y=0; y<height; y++ )
+    {
+        for( uint32 x=0; x<width; x++ )
+        {
+            uint32 c = colors[((x/3) * 7 + (y/2) * 3 + (rand() % 8 == 0)) % 6];
+            if( pixelSize == 4 )
+                ((uint32*)&tex[0])[y*width + x] = c;
+            else
+                ((uint16*)&tex[0])[y*width + x] = (uint16)c;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 400;
+    if( !BenchArgs(argc, argv, &iterations, 1) )
+        return BenchUsage("enhancebench [iterations]");
+    srand(1);
+
+    gMutex = SDL_CreateMutex();
+    gCond = SDL_CreateCond();
+    gDoneCond = SDL_CreateCond();
+    SDL_Thread *threads[FILTER_THREADS];
+    for( int i=0; i<FILTER_THREADS; i++ )
+#if SDL_VERSION_ATLEAST(2,0,0)
+        threads[i] = SDL_CreateThread(FilterThread, "TextureFilter", NULL);
+#else
+        threads[i] = SDL_CreateThread(FilterThread, NULL);
+#endif
+    hq4x_InitLUTs();
+
+    static const uint32 sizes[][2] = { {16, 16}, {32, 32}, {64, 32}, {64, 64}, {128, 64}, {128, 128}, {256, 256}, {37, 21} };
+    const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    // banded on the threads gives the same image as the whole image at once, and lq2x is hq2x inside
+    for( uint32 pixelSize=2; pixelSize<=4; pixelSize+=2 )
+    {
+        hq2x_init(pixelSize*8);
+        for( int s=0; s<numSizes; s++ )
+        {
+            uint32 w = sizes[s][0], h = sizes[s][1];
+            std::vector<uint8> src(w*h*pixelSize);
+            std::vector<uint8> whole(w*h*16*pixelSize), banded(w*h*16*pixelSize), hq2x(w*h*16*pixelSize);
+            FillTexture(src, w, h, pixelSize);
+            for( int f=0; f<NUM_FILTERS; f++ )
+            {
+                FilterJob job = { f, pixelSize, &src[0], &whole[0], w, h, 0, 0 };
+                memset(&whole[0], 0, whole.size());
+                RunFilter(job, false);
+                job.dst = &banded[0];
+                memset(&banded[0], 0xFF, banded.size());
+                RunFilter(job, true);
+                BenchCompare(&whole[0], &banded[0], w*h*filterScales[f]*filterScales[f]*pixelSize,
+                             "%s %ux%u, %u bytes per pixel: the bands differ from the whole image", filterNames[f], w, h, pixelSize);
+
+                if( f == FILTER_HQ2X )
+                    hq2x.swap(whole);
+                else if( f == FILTER_LQ2X && h > 2 )
+                {
+                    // source rows 1 to h-2 are output rows 2 to 2h-3
+                    uint32 rowBytes = w*2*pixelSize;
+                    BenchCompare(&hq2x[2*rowBytes], &whole[2*rowBytes], (2*h-4)*rowBytes,
+                                 "lq2x %ux%u, %u bytes per pixel: the middle rows aren't hq2x", w, h, pixelSize);
+                }
+            }
+        }
+    }
+    BenchReport("%d filters and sizes checked", NUM_FILTERS * numSizes * 2);
+
+    printf("32 bit texture   filter   whole (us)   %d bands, %d threads (us)\n", FILTER_BANDS, FILTER_THREADS + 1);
+    hq2x_init(32);
+    for( int s=0; s<numSizes-1; s++ )
+    {
+        uint32 w = sizes[s][0], h = sizes[s][1];
+        std::vector<uint8> src(w*h*4), dst(w*h*16*4);
+        FillTexture(src, w, h, 4);
+        int n = iterations * 4096 / (w*h);
+        if( n < 4 )
+            n = 4;
+        for( int f=0; f<NUM_FILTERS; f++ )
+        {
+            // EnhanceTexture() leaves bigger textures alone
+            if( w + h > ENHANCE_MAX_SIZE / filterScales[f] )
+                continue;
+            double t[2];
+            for( int threaded=0; threaded<2; threaded++ )
+            {
+                FilterJob job = { f, 4, &src[0], &dst[0], w, h, 0, 0 };
+                uint64 start = BenchNow();
+                for( int i=0; i<n; i++ )
+                    RunFilter(job, threaded != 0);
+                t[threaded] = BenchUs(start, n);
+            }
+            printf("%4ux%-11u %-8s %10.1f   %10.1f\n", w, h, filterNames[f], t[0], t[1]);
+        }
+    }
+
+    SDL_LockMutex(gMutex);
+    gQuit = true;
+    SDL_CondBroadcast(gCond);
+    SDL_UnlockMutex(gMutex);
+    for( int i=0; i<FILTER_THREADS; i++ )
+        SDL_WaitThread(threads[i], NULL);
+    SDL_DestroyCond(gDoneCond);
+    SDL_DestroyCond(gCond);
+    SDL_DestroyMutex(gMutex);
+    return BenchErrors() ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ fbcopybench - times the frame buffer write-back
+
+ Usage: fbcopybench [iterations]
+
+ Converts synthetic A8R8G8B8 buffers to the N64 frame buffer formats with the loops CopyBufferToRDRAM() used before
+ FrameBufferCopy.cpp, with the SIMD kernels on the calling thread alone, and with the copy threads, for the buffer
+ sizes the plugin sees most: the same size as the N64 frame buffer, and the window scaling it up. The outputs are
+ compared with the old loops and the times printed per copy. Nothing needs a GPU, so it runs on the device as it is.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "FrameBufferCopy.h"
+#include "bench.h"
+
+// the loops of CopyBufferToRDRAM() before FrameBufferCopy.cpp
+static uint16 ConvertRGBATo555(uint8 r, uint8 g, uint8 b, uint8 a)
+{
+    uint8 ar = a>=0x20?1:0;
+    return ((r>>3)<<11) | ((g>>3)<<6) | ((b>>3)<<1) | ar;
+}
+
+static void ReferenceCopy(const FrameBufferCopy &copy)
+{
+    std::vector<int> indexes(copy.width);
+    {
+        float ratio = copy.srcWidth/(float)copy.width;
+        for( uint32 j=0; j<copy.width; j++ )
+        {
+            float sx = j*ratio;
+            indexes[j] = 4*int(sx+0.5);
+        }
+    }
+
+    float ratio = copy.srcHeight/(float)copy.height;
+    for( uint32 i=copy.firstLine; i<copy.lastLine; i++ )
+    {
+        if( copy.format == FB_COPY_CI8 )
+        {
+            uint8 *pD = copy.dst + i * copy.dstPitch;
+            const uint8 *pS = copy.src + i*copy.srcHeight/copy.height * copy.srcPitch;
+            for( uint32 j=0; j<copy.width; j++ )
+            {
+                int pos = 4*(j*copy.srcWidth/copy.width);
+                *(pD+(j^3)) = copy.revTlut[ConvertRGBATo555(pS[pos+2], pS[pos+1], pS[pos+0], pS[pos+3])];
+            }
+            continue;
+        }
+
+        const uint8 *pS0 = copy.src + int(i*ratio+0.5) * copy.srcPitch;
+        for( uint32 j=0; j<copy.width; j++ )
+        {
+            const uint8 *p = pS0 + indexes[j];
+            if( copy.format == FB_COPY_RGBA5551 )
+                *((uint16*)copy.dst + i*copy.dstPitch + (j^1)) = ConvertRGBATo555(p[2], p[1], p[0], p[3]);
+            else
+                *(copy.dst + i*copy.dstPitch + (j^3)) = (uint8)((p[2]+p[0]+p[1])/3);
+        }
+    }
+}
+
+// ms for each copy
+static double Time(const FrameBufferCopy &copy, int mode, int iterations)
+{
+    uint64 start = BenchNow();
+    for( int n=0; n<iterations; n++ )
+    {
+        if( mode == 0 )
+            ReferenceCopy(copy);
+        else
+            CopyFrameBufferToN64(copy, mode == 2);
+    }
+    return BenchUs(start, iterations) / 1000.0;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct { uint32 width, height, srcWidth, srcHeight; } sizes[] = {
+        { 320, 240, 320, 240 },
+        { 320, 240, 640, 480 },
+        { 320, 240, 1024, 600 },
+        { 640, 480, 1024, 600 },
+    };
+    static const char *formats[] = { "RGBA5551", "CI8", "I8" };
+    int iterations = 200;
+    if( !BenchArgs(argc, argv, &iterations, 1) )
+        return BenchUsage("fbcopybench [iterations]");
+
+    std::vector<uint8> revTlut(0x10000);
+    for( uint32 i=0; i<0x10000; i++ )
+        revTlut[i] = (uint8)(i*2654435761u >> 24);
+
+    printf("format    N64 size    buffer      old (ms)  simd (ms)  threads (ms)\n");
+    for( uint32 s=0; s<sizeof(sizes)/sizeof(sizes[0]); s++ )
+    {
+        uint32 srcPitch = sizes[s].srcWidth*4;
+        std::vector<uint8> src(srcPitch*sizes[s].srcHeight);
+        srand(s+1);
+        for( size_t i=0; i<src.size(); i++ )
+            src[i] = (uint8)(rand() >> 4);
+
+        for( int f=FB_COPY_RGBA5551; f<=FB_COPY_I8; f++ )
+        {
+            FrameBufferCopy copy;
+            copy.format = (FrameBufferCopyFormat)f;
+            copy.src = &src[0];
+            copy.srcPitch = srcPitch;
+            copy.srcWidth = sizes[s].srcWidth;
+            copy.srcHeight = sizes[s].srcHeight;
+            copy.dstPitch = sizes[s].width;
+            copy.width = sizes[s].width;
+            copy.height = sizes[s].height;
+            copy.firstLine = 0;
+            copy.lastLine = sizes[s].height;
+            copy.revTlut = &revTlut[0];
+
+            uint32 len = copy.dstPitch*copy.height*(f == FB_COPY_RGBA5551 ? 2 : 1);
+            std::vector<uint8> expected(len), result(len);
+            copy.dst = &expected[0];
+            ReferenceCopy(copy);
+            double told = Time(copy, 0, iterations);
+
+            for( int mode=1; mode<=2; mode++ )
+            {
+                copy.dst = &result[0];
+                memset(copy.dst, 0, len);
+                CopyFrameBufferToN64(copy, mode == 2);
+                BenchCompare(&expected[0], &result[0], len, "%s %ux%u from %ux%u: %s copy differs from the old one",
+                             formats[f], copy.width, copy.height, copy.srcWidth, copy.srcHeight, mode == 2 ? "threaded" : "SIMD");
+            }
+            double tsimd = Time(copy, 1, iterations);
+            double tthreads = Time(copy, 2, iterations);
+
+            printf("%-9s %4ux%-4u   %4ux%-4u  %8.3f  %9.3f  %12.3f\n", formats[f], copy.width, copy.height,
+                   copy.srcWidth, copy.srcHeight, told, tsimd, tthreads);
+        }
+    }
+
+    StopFrameBufferCopyThreads();
+    return BenchErrors() ? 1 : 0;
+}
@@ -0,0 +1,270 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ hiresbench - checks and times the hi-res texture scan and its index
+
+ Usage: hiresbench [textures] [folders]
+
+ Builds a synthetic hires_texture/<game> folder of small PNG files in /tmp, named like the ones the plugin dumps (with
+ a few duplicates, separate alpha files and CI replacements), and runs HiresIndex.cpp on it the way
+ FindAllHiResTextures() does: the folder scan, sorting the result into the texture list, writing the index, and loading
+ the index on the next run. The list from the index is compared with the one from the scan, and a replaced file has to
+ make the index stale. Like the other benches it is built for the target, where the file system is the slow part.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <ftw.h>
+
+#include <string>
+#include <vector>
+
+#include "osal_files.h"
+#include "HiresIndex.h"
+#include "liblinux/BMGImage.h"
+#include "liblinux/pngrw.h"
+#include "bench.h"
+
+#define GAME_NAME   "HIRESBENCH"
+
+void DebugMessage(int level, const char *message, ...)
+{
+    if (level > M64MSG_WARNING)
+        return;
+    va_list args;
+    va_start(args, message);
+    vfprintf(stderr, message, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static int RemoveEntry(const char *path, const struct stat *sb, int flag, struct FTW *ftwbuf)
+{
+    return remove(path);
+}
+
+static void ClearList(CSortedList<uint64,ExtTxtrInfo> &infos)
+{
+    for (int i = 0; i < infos.size(); i++)
+    {
+        ExtTxtrInfo info = infos[i];
+        FreeTxtrInfoNames(info);
+    }
+    infos.clear();
+}
+
+static bool CopyFile(const std::vector<unsigned char> &data, const char *filename)
+{
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL)
+        return false;
+    bool ok = fwrite(&data[0], 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+static bool ReadFile(const char *filename, std::vector<unsigned char> &data)
+{
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL)
+        return false;
+    fseek(f, 0L, SEEK_END);
+    data.resize(ftell(f));
+    fseek(f, 0L, SEEK_SET);
+    bool ok = fread(&data[0], 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+// one 16x16 RGBA and one RGB image, written once and copied to every texture file
+static bool MakeImages(const char *dir, std::vector<unsigned char> &rgba, std::vector<unsigned char> &rgb)
+{
+    for (int channels = 3; channels <= 4; channels++)
+    {
+        struct BMGImageStruct img;
+        InitBMGImage(&img);
+        img.width = img.height = 16;
+        img.bits_per_pixel = channels * 8;
+        if (AllocateBMGImage(&img) != BMG_OK)
+            return false;
+        for (unsigned int i = 0; i < img.scan_width * img.height; i++)
+            img.bits[i] = (unsigned char) rand();
+
+        std::string filename = std::string(dir) + "template.png";
+        bool ok = WritePNG(filename.c_str(), img) == BMG_OK &&
+                  ReadFile(filename.c_str(), channels == 4 ? rgba : rgb);
+        FreeBMGImage(&img);
+        remove(filename.c_str());
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+static bool MakePack(const char *gamedir, int textures, int folders)
+{
+    std::vector<unsigned char> rgba, rgb;
+    if (!MakeImages(gamedir, rgba, rgb))
+        return false;
+
+    char filename[PATH_MAX + 64];
+    for (int i = 0; i < textures; i++)
+    {
+        // the dump folders of the plugin, and packs split by hand into many more
+        char folder[PATH_MAX];
+        snprintf(folder, PATH_MAX, "%sfolder%03d/", gamedir, i % folders);
+        if (i < folders)
+            osal_mkdirp(folder, 0700);
+
+        // every 64th is a duplicate of the one before, found in another folder
+        unsigned int crc = (i & 63) == 63 ? (unsigned int) (i - 1) * 0x9E3779B9U : (unsigned int) i * 0x9E3779B9U;
+        int fmt = i & 3, siz = (i >> 2) & 3;
+        bool ok;
+        switch (i % 5)
+        {
+        case 0:
+            snprintf(filename, sizeof(filename), "%s%s#%08X#%d#%d#%08X_ciByRGBA.png", folder, GAME_NAME, crc, fmt, siz,
+                     crc ^ 0x5A5A5A5A);
+            ok = CopyFile(rgba, filename);
+            break;
+        case 1:
+            snprintf(filename, sizeof(filename), "%s%s#%08X#%d#%d_rgb.png", folder, GAME_NAME, crc, fmt, siz);
+            ok = CopyFile(rgb, filename);
+            snprintf(filename, sizeof(filename), "%s%s#%08X#%d#%d_a.png", folder, GAME_NAME, crc, fmt, siz);
+            ok = ok && CopyFile(rgb, filename);
+            break;
+        default:
+            snprintf(filename, sizeof(filename), "%s%s#%08X#%d#%d_all.png", folder, GAME_NAME, crc, fmt, siz);
+            ok = CopyFile(rgba, filename);
+            break;
+        }
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+static bool SameLists(CSortedList<uint64,ExtTxtrInfo> &a, CSortedList<uint64,ExtTxtrInfo> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); i++)
+    {
+        ExtTxtrInfo x = a[i], y = b[i];
+        if (x.fmt != y.fmt || x.siz != y.siz || x.width != y.width || x.height != y.height || x.type != y.type ||
+            x.crc32 != y.crc32 || x.pal_crc32 != y.pal_crc32 || x.bSeparatedAlpha != y.bSeparatedAlpha ||
+            strcmp(x.foldername, y.foldername) != 0 || strcmp(x.filename, y.filename) != 0 ||
+            (x.filename_a == NULL) != (y.filename_a == NULL) || (x.filename_a && strcmp(x.filename_a, y.filename_a)))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int args[2] = { 20000, 20 };
+    if( !BenchArgs(argc, argv, args, 2) || args[1] > 1000 )
+        return BenchUsage("hiresbench [textures] [folders]");
+    int textures = args[0], folders = args[1];
+    srand(1);
+
+    char tempdir[] = "/tmp/hiresbench.XXXXXX";
+    if (mkdtemp(tempdir) == NULL)
+    {
+        fprintf(stderr, "Can't create a folder in /tmp\n");
+        return 1;
+    }
+    std::string gamedir = std::string(tempdir) + "/hires_texture/" GAME_NAME "/";
+    std::string indexname = std::string(tempdir) + "/" GAME_NAME ".idx";
+    osal_mkdirp(gamedir.c_str(), 0700);
+
+    uint64 start = BenchNow();
+    if (!MakePack(gamedir.c_str(), textures, folders))
+    {
+        fprintf(stderr, "Can't write the textures in %s\n", gamedir.c_str());
+        nftw(tempdir, RemoveEntry, 8, FTW_DEPTH | FTW_PHYS);
+        return 1;
+    }
+    printf("%d textures in %d folders written in %.0f ms\n\n", textures, folders, BenchUs(start, 1000));
+
+    std::vector<char> foldername(gamedir.begin(), gamedir.end());
+    foldername.push_back(0);
+    CSortedList<uint64,ExtTxtrInfo> scanned, loaded, onebyone;
+    std::vector<ScannedTxtr> found;
+    std::vector<ScannedFolder> scannedFolders;
+
+    // a cold run: scan, sort, write the index
+    start = BenchNow();
+    ScanTexturesFromFolder(&foldername[0], GAME_NAME, false, found, scannedFolders, true, true);
+    double scanTime = BenchUs(start, 1000);
+
+    // the list as it was built before the scan was sorted, for comparison
+    start = BenchNow();
+    for (size_t i = 0; i < found.size(); i++)
+        onebyone.add(found[i].key, found[i].info);
+    double oneByOneTime = BenchUs(start, 1000);
+    onebyone.clear();   // the names belong to found
+
+    start = BenchNow();
+    SortScannedTextures(found);
+    AddScannedTextures(found, scanned);
+    double sortTime = BenchUs(start, 1000);
+
+    start = BenchNow();
+    SaveHiresIndex(indexname.c_str(), false, found, scannedFolders);
+    double saveTime = BenchUs(start, 1000);
+
+    // the next run
+    start = BenchNow();
+    bool bLoaded = LoadHiresIndex(indexname.c_str(), &foldername[0], false, loaded);
+    double loadTime = BenchUs(start, 1000);
+
+    if (!bLoaded || !SameLists(scanned, loaded))
+        BenchFail("the index doesn't give the scanned textures");
+    ClearList(loaded);
+
+    // a file replaced by one of another size makes the index stale
+    ExtTxtrInfo middle = scanned[scanned.size() / 2];
+    std::string replaced = std::string(middle.foldername) + middle.filename;
+    FILE *f = fopen(replaced.c_str(), "ab");
+    if (f != NULL)
+    {
+        fputc(0, f);
+        fclose(f);
+    }
+    if (LoadHiresIndex(indexname.c_str(), &foldername[0], false, loaded))
+        BenchFail("the index was used after %s changed", replaced.c_str());
+    ClearList(loaded);
+    BenchReport("%d textures found, %d kept, index checked", textures, scanned.size());
+
+    printf("scan (us per texture)                    %8.2f\n", scanTime * 1000.0 / textures);
+    printf("add() one by one in scan order (ms)      %8.1f\n", oneByOneTime);
+    printf("sort and append (ms)                     %8.1f\n", sortTime);
+    printf("write the index (ms)                     %8.1f\n", saveTime);
+    printf("load the index (ms)                      %8.1f\n", loadTime);
+    printf("first run (ms)                           %8.1f\n", scanTime + sortTime + saveTime);
+
+    ClearList(scanned);
+    nftw(tempdir, RemoveEntry, 8, FTW_DEPTH | FTW_PHYS);
+    return BenchErrors() ? 1 : 0;
+}
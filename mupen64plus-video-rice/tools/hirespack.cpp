@@ -0,0 +1,335 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ hirespack - builds a hi-res texture pack
+
+ Usage: hirespack [-z] <hires texture folder> <pack file>
+        hirespack -t <pack file>
+
+ Reads the replacement textures of a game the same way the plugin does (same file name convention, same folder
+ recursion) and stores them decoded in a pack, see HiresPack.h. With -z the images are zlib compressed. Color indexed
+ BMPs (*_ci.bmp) are left out: they are converted with the palette in use when the texture is loaded, so they can't
+ be decoded in advance and have to stay loose files.
+
+ With -t the pack is opened and every image is decoded, which checks it without running the emulator.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "osal_files.h"
+#include "HiresPack.h"
+#include "liblinux/BMGImage.h"
+#include "liblinux/pngrw.h"
+
+// must match TextureType in TextureFilters.cpp
+enum
+{
+    NO_TEXTURE,
+    RGB_PNG,
+    COLOR_INDEXED_BMP,
+    RGB_WITH_ALPHA_TOGETHER_PNG,
+    RGBA_PNG_FOR_CI,
+    RGBA_PNG_FOR_ALL_CI,
+};
+
+static int numSkipped = 0;
+
+static bool EndsWith(const char *str, const char *suffix)
+{
+    size_t len = strlen(str), slen = strlen(suffix);
+    return len >= slen && strcasecmp(str + len - slen, suffix) == 0;
+}
+
+static bool FileExists(const char *filename)
+{
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL)
+        return false;
+    fclose(f);
+    return true;
+}
+
+/********************************************************************************************************************
+ * Decodes a PNG file into 'out' with 3 or 4 bytes per pixel, converting it exactly like LoadRGBBufferFromPNGFile()
+ * in the plugin does.
+ ********************************************************************************************************************/
+static bool LoadPNG(const char *filename, int bits_per_pixel, std::vector<unsigned char> &out, unsigned int &width,
+                    unsigned int &height, unsigned int *src_bits_per_pixel = NULL)
+{
+    struct BMGImageStruct img;
+    memset(&img, 0, sizeof(BMGImageStruct));
+    if (ReadPNG(filename, &img) != BMG_OK)
+    {
+        fprintf(stderr, "Error: can't read '%s'\n", filename);
+        return false;
+    }
+
+    int destBytePP = bits_per_pixel / 8;
+    unsigned int numPixels = img.width * img.height;
+    out.assign(numPixels * destBytePP, 0);
+    unsigned char *pSrc = img.bits;
+    unsigned char *pDst = &out[0];
+
+    bool ok = true;
+    if (img.bits_per_pixel == bits_per_pixel)
+    {
+        memcpy(pDst, pSrc, out.size());
+    }
+    else if (img.bits_per_pixel == 24 || img.bits_per_pixel == 32)
+    {
+        // add or drop the alpha byte, an added one is 0
+        int srcBytePP = img.bits_per_pixel / 8;
+        for (unsigned int i = 0; i < numPixels; i++, pSrc += srcBytePP, pDst += destBytePP)
+        {
+            pDst[0] = pSrc[0];
+            pDst[1] = pSrc[1];
+            pDst[2] = pSrc[2];
+        }
+    }
+    else if (img.bits_per_pixel == 8)
+    {
+        // palette lookup, alpha (if any) stays 0
+        for (unsigned int i = 0; i < numPixels; i++, pDst += destBytePP)
+        {
+            unsigned char *palcolor = img.palette + *pSrc++ * img.bytes_per_palette_entry;
+            pDst[0] = palcolor[2];
+            pDst[1] = palcolor[1];
+            pDst[2] = palcolor[0];
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Error: PNG file '%s' is %i bpp\n", filename, img.bits_per_pixel);
+        ok = false;
+    }
+
+    width = img.width;
+    height = img.height;
+    if (src_bits_per_pixel)
+        *src_bits_per_pixel = img.bits_per_pixel;
+    FreeBMGImage(&img);
+    return ok;
+}
+
+/********************************************************************************************************************
+ * Scans a folder like ScanTexturesFromFolder() in the plugin and decodes every replacement found.
+ ********************************************************************************************************************/
+static void ScanFolder(const std::string &foldername, std::vector<HiresPackImage> &images,
+                       std::map<std::string, bool> &seen)
+{
+    void *dir = osal_search_dir_open(foldername.c_str());
+    if (dir == NULL)
+        return;
+
+    const char *foundfilename;
+    while ((foundfilename = osal_search_dir_read_next(dir)) != NULL)
+    {
+        if (foundfilename[0] == '.')
+            continue;
+
+        std::string filename = foldername + foundfilename;
+        if (osal_is_directory(filename.c_str()))
+        {
+            ScanFolder(filename + OSAL_DIR_SEPARATOR_STR, images, seen);
+            continue;
+        }
+
+        const char *ptr = strchr(foundfilename, '#');
+        if (ptr == NULL)
+            continue;
+
+        unsigned int type = NO_TEXTURE;
+        if (EndsWith(foundfilename, "_ci.bmp"))
+        {
+            printf("Skipping color indexed texture '%s'\n", filename.c_str());
+            numSkipped++;
+            continue;
+        }
+        else if (EndsWith(foundfilename, "_ciByRGBA.png"))
+            type = RGBA_PNG_FOR_CI;
+        else if (EndsWith(foundfilename, "_allciByRGBA.png"))
+            type = RGBA_PNG_FOR_ALL_CI;
+        else if (EndsWith(foundfilename, "_rgb.png"))
+            type = RGB_PNG;
+        else if (EndsWith(foundfilename, "_all.png"))
+            type = RGB_WITH_ALPHA_TOGETHER_PNG;
+        else
+            continue;
+
+        char crcstr[16], crcstr2[16];
+        int fmt = 0, siz = 0;
+        unsigned int palcrc32 = 0xFFFFFFFF;
+        memset(crcstr, 0, sizeof(crcstr));
+        memset(crcstr2, 0, sizeof(crcstr2));
+        if (type == RGBA_PNG_FOR_CI)
+        {
+            if (sscanf(ptr + 1, "%8c#%d#%d#%8c", crcstr, &fmt, &siz, crcstr2) != 4)
+                continue;
+            palcrc32 = strtoul(crcstr2, NULL, 16);
+        }
+        else if (sscanf(ptr + 1, "%8c#%d#%d", crcstr, &fmt, &siz) != 3)
+            continue;
+        unsigned int crc32 = strtoul(crcstr, NULL, 16);
+
+        // the first of the textures with the same CRCs and type wins, as in the plugin
+        char id[64];
+        sprintf(id, "%08X-%08X-%u", crc32, palcrc32, type);
+        if (seen.find(id) != seen.end())
+            continue;
+
+        HiresPackImage image;
+        memset(&image.entry, 0, sizeof(HiresPackEntry));
+        unsigned int width, height, bpp;
+        if (type == RGB_PNG)
+        {
+            if (!LoadPNG(filename.c_str(), 24, image.image, width, height))
+                continue;
+            image.entry.channels = 3;
+
+            std::string filename_a = filename.substr(0, filename.size() - 8) + "_a.png";
+            std::vector<unsigned char> alpha;
+            unsigned int width_a, height_a;
+            if (FileExists(filename_a.c_str()))
+            {
+                if (!LoadPNG(filename_a.c_str(), 24, alpha, width_a, height_a))
+                    continue;
+                if (width_a != width || height_a != height)
+                {
+                    fprintf(stderr, "Warning: RGB and alpha texture size mismatch: %s\n", filename_a.c_str());
+                    continue;
+                }
+
+                // merge the separate alpha channel, it comes from the red component of the alpha image
+                std::vector<unsigned char> rgba(width * height * 4);
+                for (unsigned int i = 0; i < width * height; i++)
+                {
+                    rgba[i*4+0] = image.image[i*3+0];
+                    rgba[i*4+1] = image.image[i*3+1];
+                    rgba[i*4+2] = image.image[i*3+2];
+                    rgba[i*4+3] = alpha[i*3];
+                }
+                image.image.swap(rgba);
+                image.entry.channels = 4;
+                type = RGB_WITH_ALPHA_TOGETHER_PNG;
+            }
+        }
+        else
+        {
+            if (!LoadPNG(filename.c_str(), 32, image.image, width, height, &bpp))
+                continue;
+            if ((type == RGBA_PNG_FOR_CI || type == RGBA_PNG_FOR_ALL_CI) && bpp != 32)
+            {
+                fprintf(stderr, "Warning: '%s' has no alpha channel, skipped\n", filename.c_str());
+                continue;
+            }
+            image.entry.channels = 4;
+        }
+
+        seen[id] = true;
+        image.entry.crc32 = crc32;
+        image.entry.pal_crc32 = palcrc32;
+        image.entry.fmt = fmt;
+        image.entry.siz = siz;
+        image.entry.type = type;
+        image.entry.width = width;
+        image.entry.height = height;
+        image.name = filename;
+        images.push_back(image);
+    }
+
+    osal_search_dir_close(dir);
+}
+
+static int TestPack(const char *packname)
+{
+    CHiresPack pack;
+    if (!pack.Open(packname))
+    {
+        fprintf(stderr, "Error: '%s' is not a valid texture pack\n", packname);
+        return 1;
+    }
+
+    int errors = 0;
+    unsigned long long stored = 0, raw = 0;
+    for (int i = 0; i < pack.GetNumEntries(); i++)
+    {
+        const HiresPackEntry &e = pack.GetEntry(i);
+        if (pack.GetImage(i) == NULL)
+        {
+            fprintf(stderr, "Error: image %i (%s) is damaged\n", i, pack.GetEntryName(i));
+            errors++;
+        }
+        stored += e.size;
+        raw += e.rawSize;
+    }
+
+    printf("%i textures, %llu bytes stored, %llu bytes decoded, %i errors\n", pack.GetNumEntries(), stored, raw, errors);
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bool bCompress = false;
+    int arg = 1;
+
+    if (argc == 3 && strcmp(argv[1], "-t") == 0)
+        return TestPack(argv[2]);
+
+    if (arg < argc && strcmp(argv[arg], "-z") == 0)
+    {
+        bCompress = true;
+        arg++;
+    }
+    if (argc - arg != 2)
+    {
+        printf("Usage: %s [-z] <hires texture folder> <pack file>\n", argv[0]);
+        printf("       %s -t <pack file>\n", argv[0]);
+        return 1;
+    }
+
+    std::string foldername = argv[arg];
+    if (foldername.empty() || foldername[foldername.size() - 1] != OSAL_DIR_SEPARATOR_CHAR)
+        foldername += OSAL_DIR_SEPARATOR_STR;
+    if (!osal_is_directory(foldername.c_str()))
+    {
+        fprintf(stderr, "Error: '%s' is not a folder\n", foldername.c_str());
+        return 1;
+    }
+
+    std::vector<HiresPackImage> images;
+    std::map<std::string, bool> seen;
+    ScanFolder(foldername, images, seen);
+
+    if (!WriteHiresPack(argv[arg + 1], images, bCompress))
+    {
+        fprintf(stderr, "Error: can't write '%s'\n", argv[arg + 1]);
+        return 1;
+    }
+
+    printf("%i textures packed in '%s', %i color indexed textures left out\n", (int) images.size(), argv[arg + 1], numSkipped);
+    return 0;
+}
@@ -0,0 +1,383 @@
+/*
+Copyright (C) 2003 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+/****
+ texcachebench - checks and times the texture cache on a texture request trace
+
+ Usage: texcachebench [frames per level] [textures per level]
+
+ Replays a texture request trace shaped like a game through CTextureManager::GetTexture() of TextureManager.cpp: a HUD
+ drawn every frame, a camera panning over the textures of a level with a few of them animated in RDRAM, and level
+ changes which load other textures at the same addresses, the first level coming back at the end. The trace is made
+ once and replayed with several TextureCacheSize budgets, deleting the textures like the OpenGL device does and
+ recycling them like the others. Every texture returned has to hold what is in RDRAM at the time, and the textures may
+ never use more than the budget. The texture and device classes are small stand-ins kept in memory, so the time is the
+ cache and the CRCs, not the conversion.
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ConvertImage.h"
+#include "DeviceBuilder.h"
+#include "FrameBuffer.h"
+#include "RenderBase.h"
+#include "TextureCRC.h"
+#include "TextureManager.h"
+#include "Video.h"
+#include "bench.h"
+
+// the plugin state TextureManager.cpp reads
+PluginStatus            status;
+GlobalOptions           options;
+FrameBufferOptions      frameBufferOptions;
+GameSetting             g_curRomInfo;
+ALIGN(16,RDP_Options gRDP)
+RenderTexture           g_textures[MAX_TEXTURES];
+RenderTextureInfo       gRenderTextureInfos[20];
+RenderTextureInfo      *g_pRenderTextureInfo = NULL;
+FrameBufferManager     *g_pFrameBufferManager = NULL;
+
+static SupportedDeviceType gDeviceType = OGL_DEVICE;
+
+void _VIDEO_DisplayTemporaryMessage(const char *Message)
+{
+    fprintf(stderr, "%s\n", Message);
+}
+
+void DumpCachedTexture(TxtrCacheEntry &entry)
+{
+}
+
+// render textures are never looked for, frameBufferOptions is all off
+int FrameBufferManager::CheckAddrInBackBuffers(uint32 addr, uint32 memsize, bool copyToRDRAM)
+{
+    return -1;
+}
+
+int FrameBufferManager::CheckAddrInRenderTextures(uint32 addr, bool checkcrc)
+{
+    return -1;
+}
+
+void FrameBufferManager::LoadTextureFromRenderTexture(TxtrCacheEntry* pEntry, int infoIdx)
+{
+}
+
+class MemTexture : public CTexture
+{
+public:
+    // power of 2 and 32 bits per texel, like an OpenGL texture
+    MemTexture(uint32 dwWidth, uint32 dwHeight) : CTexture(dwWidth, dwHeight)
+    {
+        uint32 w;
+        for (w = 1; w < dwWidth; w <<= 1);
+        m_dwCreatedTextureWidth = w;
+        for (w = 1; w < dwHeight; w <<= 1);
+        m_dwCreatedTextureHeight = w;
+        m_pTexture = malloc(m_dwCreatedTextureWidth * m_dwCreatedTextureHeight * GetPixelSize());
+    }
+    ~MemTexture()
+    {
+        free(m_pTexture);
+    }
+
+    bool StartUpdate(DrawInfo *di)
+    {
+        di->dwWidth = (uint16)m_dwWidth;
+        di->dwHeight = (uint16)m_dwHeight;
+        di->dwCreatedWidth = (uint16)m_dwCreatedTextureWidth;
+        di->dwCreatedHeight = (uint16)m_dwCreatedTextureHeight;
+        di->lPitch = m_dwCreatedTextureWidth * GetPixelSize();
+        di->lpSurface = m_pTexture;
+        return true;
+    }
+    void EndUpdate(DrawInfo *di) {}
+};
+
+class MemDeviceBuilder : public CDeviceBuilder
+{
+public:
+    CGraphicsContext * CreateGraphicsContext(void) { return NULL; }
+    CRender * CreateRender(void) { return NULL; }
+    CTexture * CreateTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) { return new MemTexture(dwWidth, dwHeight); }
+    CColorCombiner * CreateColorCombiner(CRender *pRender) { return NULL; }
+    CBlender * CreateAlphaBlender(CRender *pRender) { return NULL; }
+};
+
+static MemDeviceBuilder gBuilder;
+
+CDeviceBuilder::CDeviceBuilder() {}
+CDeviceBuilder::~CDeviceBuilder() {}
+CDeviceBuilder* CDeviceBuilder::GetBuilder(void) { return &gBuilder; }
+SupportedDeviceType CDeviceBuilder::GetGeneralDeviceType(void) { return gDeviceType; }
+
+extern uint32 dwAsmCRC;
+
+// as in FrameBuffer.cpp, without bFastTexCRC
+uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes, int *pMaxCI)
+{
+    dwAsmCRC = CalculateTextureCRC(pPhysicalAddress, left, top, width, height, size, pitchInBytes, pMaxCI);
+    return dwAsmCRC;
+}
+
+// the conversion only copies the first texel from RDRAM, so the cached texture can be checked against RDRAM
+static void ConvertFirstTexel(CTexture *pTexture, const TxtrInfo &ti)
+{
+    DrawInfo dInfo;
+    if (!pTexture->StartUpdate(&dInfo))
+        return;
+    memcpy(dInfo.lpSurface, ti.pPhysicalAddress, 4);
+    pTexture->EndUpdate(&dInfo);
+}
+
+ConvertFunction gConvertFunctions_FullTMEM[ 8 ][ 4 ];
+ConvertFunction gConvertFunctions[ 8 ][ 4 ];
+ConvertFunction gConvertTlutFunctions[ 8 ][ 4 ];
+ConvertFunction gConvertFunctions_16[ 8 ][ 4 ];
+ConvertFunction gConvertFunctions_16_FullTMEM[ 8 ][ 4 ];
+ConvertFunction gConvertTlutFunctions_16[ 8 ][ 4 ];
+
+class BenchTextureManager : public CTextureManager
+{
+public:
+    const TextureCacheStats &Stats() { return m_stats; }
+    uint32 MemUsage() { return m_currentTextureMemUsage + m_recycledTextureMemUsage; }
+};
+
+#define RDRAM_SIZE      (8*1024*1024)
+#define LEVEL_BASE      0x200000        // the textures of every level are loaded there
+#define HUD_BASE        0x100000
+#define HUD_TEXTURES    16
+#define VISIBLE         120             // level textures in view
+#define ANIMATED        8               // level textures rewritten every other frame
+
+enum { EVENT_REQUEST, EVENT_WRITE, EVENT_FRAME };
+
+typedef struct {
+    int     kind;
+    uint32  texture;
+} TraceEvent;
+
+typedef struct {
+    uint32  address;
+    uint32  width;
+    uint32  height;
+    uint32  format;
+    uint32  size;
+} TraceTexture;
+
+static std::vector<uint8> rdram(RDRAM_SIZE);
+static uint16 palette[256];
+static std::vector<TraceTexture> textures;
+static std::vector<TraceEvent> trace;
+
+static void AddEvent(int kind, uint32 texture)
+{
+    TraceEvent event = { kind, texture };
+    trace.push_back(event);
+}
+
+// textures of a level, one after another from base, with the sizes and formats games mostly use
+static void AddTextures(uint32 base, int count)
+{
+    static const uint32 formats[][2] = {
+        { TXT_FMT_RGBA, TXT_SIZE_16b }, { TXT_FMT_RGBA, TXT_SIZE_16b }, { TXT_FMT_CI, TXT_SIZE_4b },
+        { TXT_FMT_CI, TXT_SIZE_8b }, { TXT_FMT_IA, TXT_SIZE_8b }, { TXT_FMT_I, TXT_SIZE_4b }, { TXT_FMT_RGBA, TXT_SIZE_32b } };
+    static const uint32 sizes[][2] = { { 32, 32 }, { 32, 32 }, { 32, 32 }, { 64, 32 }, { 16, 16 }, { 64, 64 }, { 32, 64 } };
+
+    for (int i = 0; i < count; i++)
+    {
+        TraceTexture tex;
+        int f = rand() % 7, s = rand() % 7;
+        tex.address = base;
+        tex.width = sizes[s][0];
+        tex.height = sizes[s][1];
+        tex.format = formats[f][0];
+        tex.size = formats[f][1];
+        textures.push_back(tex);
+        base += ((tex.width << tex.size) >> 1) * tex.height;
+    }
+}
+
+static void MakeTrace(int levels, int framesPerLevel, int texturesPerLevel)
+{
+    AddTextures(HUD_BASE, HUD_TEXTURES);
+    for (int level = 0; level < levels; level++)
+        AddTextures(LEVEL_BASE, texturesPerLevel);
+
+    for (int level = 0; level <= levels; level++)
+    {
+        // the first level again at the end
+        uint32 first = HUD_TEXTURES + (level % levels) * texturesPerLevel;
+        for (int i = 0; i < texturesPerLevel; i++)
+            AddEvent(EVENT_WRITE, first + i);
+
+        for (int frame = 0; frame < framesPerLevel; frame++)
+        {
+            AddEvent(EVENT_FRAME, 0);
+            if (frame & 1)
+                for (int i = 0; i < ANIMATED; i++)
+                    AddEvent(EVENT_WRITE, first + i);
+
+            // the camera pans over the whole level, the textures in view are loaded once or twice
+            int start = frame * (texturesPerLevel - VISIBLE) / framesPerLevel;
+            for (int i = 0; i < VISIBLE; i++)
+            {
+                uint32 texture = first + (i < ANIMATED ? i : start + i);
+                AddEvent(EVENT_REQUEST, texture);
+                if (i % 3 == 0)
+                    AddEvent(EVENT_REQUEST, texture);
+            }
+            for (int i = 0; i < HUD_TEXTURES; i++)
+                AddEvent(EVENT_REQUEST, i);
+        }
+    }
+}
+
+// The first word tells which version of the texture is in RDRAM, the rest is different for every texture. The CRC adds
+// the first word of a line twice, once xored with the line number, so small numbers could give the same CRC.
+static uint32 VersionWord(uint32 version)
+{
+    return version * 0x9E3779B9U;
+}
+
+static void WriteTexture(const TraceTexture &tex, uint32 version)
+{
+    uint32 bytes = ((tex.width << tex.size) >> 1) * tex.height;
+    uint32 *p = (uint32 *)&rdram[tex.address];
+    p[0] = VersionWord(version);
+    for (uint32 i = 1; i < bytes / 4; i++)
+        p[i] = (uint32)(&tex - &textures[0]) * 0x9E3779B9U + i;
+}
+
+static void SetTxtrInfo(TxtrInfo &ti, const TraceTexture &tex)
+{
+    ti = TxtrInfo();
+    ti.Address = tex.address;
+    ti.pPhysicalAddress = &rdram[tex.address];
+    ti.WidthToCreate = ti.WidthToLoad = tex.width;
+    ti.HeightToCreate = ti.HeightToLoad = tex.height;
+    ti.Format = tex.format;
+    ti.Size = tex.size;
+    ti.Pitch = (tex.width << tex.size) >> 1;
+    ti.PalAddress = (uchar *)palette;
+    ti.TLutFmt = TLUT_FMT_RGBA16;
+}
+
+// time in us
+static void Replay(uint32 cacheSize, SupportedDeviceType device, double &time, uint32 &peak, TextureCacheStats &stats)
+{
+    BenchTextureManager *pManager = new BenchTextureManager;
+    std::vector<TxtrInfo> infos(textures.size());
+    std::vector<uint32> versions(textures.size(), 0);
+
+    options.textureCacheSize = cacheSize;
+    gDeviceType = device;
+    status.gDlistCount = 0;
+    status.gRDPTime = 0;
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        SetTxtrInfo(infos[i], textures[i]);
+        if (i < HUD_TEXTURES)
+            WriteTexture(textures[i], 0);
+    }
+    peak = 0;
+
+    uint64 start = BenchNow();
+    for (size_t e = 0; e < trace.size(); e++)
+    {
+        const TraceEvent &event = trace[e];
+        switch (event.kind)
+        {
+        case EVENT_FRAME:
+            // as ProcessDList() does
+            status.gRDPTime += 33;
+            status.gDlistCount++;
+            pManager->PurgeOldTextures();
+            break;
+        case EVENT_WRITE:
+            WriteTexture(textures[event.texture], ++versions[event.texture]);
+            break;
+        default:
+            {
+                TxtrCacheEntry *pEntry = pManager->GetTexture(&infos[event.texture], false);
+                g_textures[0].pTextureEntry = pEntry;      // bound for the primitive, it can't be evicted
+
+                uint32 usage = pManager->MemUsage();
+                if (usage > peak)
+                    peak = usage;
+                if (pEntry == NULL || !(pEntry->ti == infos[event.texture]) ||
+                    *(uint32 *)pEntry->pTexture->GetTexture() != VersionWord(versions[event.texture]))
+                    BenchFail("texture %u in frame %u isn't what is in RDRAM", event.texture, status.gDlistCount);
+                if (cacheSize != 0 && usage > cacheSize * 1024 * 1024)
+                    BenchFail("%u bytes of textures in frame %u, more than %u MB", usage, status.gDlistCount, cacheSize);
+            }
+            break;
+        }
+    }
+    time = BenchUs(start, 1);
+
+    stats = pManager->Stats();
+    g_textures[0].pTextureEntry = NULL;
+    delete pManager;
+}
+
+int main(int argc, char **argv)
+{
+    int args[2] = { 900, 600 };
+    if (!BenchArgs(argc, argv, args, 2) || args[1] < VISIBLE || args[1] > 1500)
+        return BenchUsage("texcachebench [frames per level] [textures per level]");
+    int framesPerLevel = args[0], texturesPerLevel = args[1];
+    srand(1);
+
+    for (int f = 0; f < 8; f++)
+        for (int s = 0; s < 4; s++)
+            gConvertFunctions[f][s] = gConvertTlutFunctions[f][s] = ConvertFirstTexel;
+    for (int i = 0; i < 256; i++)
+        palette[i] = (uint16)(i * 0x0101);
+
+    MakeTrace(3, framesPerLevel, texturesPerLevel);
+    int requests = 0;
+    for (size_t e = 0; e < trace.size(); e++)
+        requests += trace[e].kind == EVENT_REQUEST;
+    printf("%d frames, %d textures, %d requests\n\n", 4 * framesPerLevel, (int)textures.size(), requests);
+
+    static const uint32 cacheSizes[] = { 0, 1, 2, 4, 16 };
+    printf("budget (MB)  textures    us/frame  ns/request     hits  reloads   misses  revived  evicted   purged   peak (KB)\n");
+    for (int recycle = 0; recycle < 2; recycle++)
+    {
+        for (size_t c = 0; c < sizeof(cacheSizes) / sizeof(cacheSizes[0]); c++)
+        {
+            double time;
+            uint32 peak;
+            TextureCacheStats stats;
+            Replay(cacheSizes[c], recycle ? DIRECTX_DEVICE : OGL_DEVICE, time, peak, stats);
+            printf("%11u  %-8s %11.1f %11.1f %8u %8u %8u %8u %8u %8u %11u\n", cacheSizes[c], recycle ? "recycled" : "deleted",
+                   time / (4 * framesPerLevel), time * 1000.0 / requests, stats.hits, stats.reloads, stats.misses,
+                   stats.revived, stats.evictions, stats.purges, peak / 1024);
+        }
+    }
+    BenchReport("\n%d requests of each budget checked", requests);
+
+    return BenchErrors() ? 1 : 0;
+}
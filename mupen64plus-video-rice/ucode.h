@@ -168,7 +168,7 @@ UcodeFunc(RDP_TriShadeZ);
 UcodeFunc(RDP_TriShadeTxtr);
 UcodeFunc(RDP_TriShadeTxtrZ);
 
-#ifdef DEBUGGER
+#if defined(DEBUGGER) || defined(PROFILE_GBI)
 const char* ucodeNames_GBI1[256] =
 {
     "RSP_SPNOOP",    "RSP_MTX",     "Reserved0", "RSP_MOVEMEM",